@@ -0,0 +1,888 @@
+#ifndef CMSIS_OS2_EXT_H_
+#define CMSIS_OS2_EXT_H_
+
+/*
+ * CMSIS-RTOS2 extensions shared by the uC/OS-II and uC/OS-III wrappers.
+ *
+ * These calls are not part of the Arm CMSIS-RTOS2 specification. Each
+ * feature is compiled in only when the matching UCOS2_xxx_EN / UCOS3_xxx_EN
+ * option is set for the port; otherwise the functions still link and return
+ * osError (or 0 for counters) so portable code can probe for support.
+ */
+
+#include <stdint.h>
+
+#include "cmsis_os2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//  ==== Thread Attribute Extensions ====
+
+// Extra osThreadAttr_t::attr_bits, placed above the CMSIS zone and safety class fields.
+#define osThreadStackInit_Pos   24U                               ///< stack initialization mode position
+#define osThreadStackInit_Msk   (3UL << osThreadStackInit_Pos)    ///< stack initialization mode mask
+#define osThreadStackClear      (0UL << osThreadStackInit_Pos)    ///< zero the whole stack at creation (default)
+#define osThreadStackPaint      (1UL << osThreadStackInit_Pos)    ///< zero only the watermark region at the far end of the stack
+#define osThreadStackNoInit     (2UL << osThreadStackInit_Pos)    ///< leave the stack untouched (no watermark)
+#define osThreadNoFpu           (1UL << 26U)                      ///< thread never uses the FPU: no FP context save/restore
+#define osThreadMailbox         (1UL << 27U)                      ///< thread receives \ref osThreadMessagePut messages
+
+//  ==== CPU Usage ====
+
+/// Scale of the \ref osThreadCpuUsage_t::usage field (10000 = 100.00 %).
+#define osCpuUsageScale         10000U
+
+/// Per-thread CPU accounting collected by the context-switch hook.
+typedef struct {
+  uint64_t cycles;              ///< timestamp cycles consumed since creation
+  uint32_t switches;            ///< number of times the thread was switched in
+  uint32_t usage;               ///< load over the sliding window, in 1/100 %
+} osThreadCpuUsage_t;
+
+/// One entry of a system-wide CPU usage snapshot.
+typedef struct {
+  osThreadId_t       thread_id; ///< thread ID
+  const char        *name;      ///< thread name (may be NULL)
+  osThreadCpuUsage_t usage;     ///< accounting data
+} osThreadCpuUsageInfo_t;
+
+/// Load of the tasks that are not CMSIS threads over the same window.
+typedef struct {
+  uint64_t window_cycles;       ///< length of the sliding window in timestamp cycles
+  uint32_t idle_usage;          ///< idle task load, in 1/100 %
+  uint32_t kernel_usage;        ///< other kernel/application tasks (timer, stat, ...), in 1/100 %
+} osCpuUsageSummary_t;
+
+/// Get CPU usage of a thread.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadNew or \ref osThreadGetId.
+/// \param[out]    usage         accounting data of the thread.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osThreadGetCpuUsage (osThreadId_t thread_id, osThreadCpuUsage_t *usage);
+
+/// Take a consistent CPU usage snapshot of all CMSIS threads.
+/// \param[out]    info          array receiving one entry per thread.
+/// \param[in]     max_count     number of entries available in info.
+/// \param[out]    summary       idle/kernel load over the same window (may be NULL).
+/// \return number of entries stored in info.
+uint32_t osKernelGetCpuUsage (osThreadCpuUsageInfo_t *info, uint32_t max_count, osCpuUsageSummary_t *summary);
+
+//  ==== Stack Usage ====
+
+/// Get the lowest unused stack space recorded for a thread, without scanning.
+/// The record is refreshed by \ref osThreadGetStackSpace and, when enabled, by
+/// the background stack profiler.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadNew or \ref osThreadGetId.
+/// \return lowest remaining stack space in bytes seen so far.
+uint32_t osThreadGetStackWatermark (osThreadId_t thread_id);
+
+//  ==== Thread Local Storage ====
+
+/// Returned by \ref osThreadTlsAlloc when no slot is left.
+#define osThreadTlsInvalid      0xFFFFFFFFU
+
+/// Reserve a thread-local storage slot; the index is valid in every thread.
+/// \return slot index or \ref osThreadTlsInvalid.
+uint32_t osThreadTlsAlloc (void);
+
+/// Get the value of a thread-local storage slot of the running thread.
+/// \param[in]     slot          slot index obtained by \ref osThreadTlsAlloc.
+/// \return stored value, NULL if never set or the slot is invalid.
+void *osThreadTlsGet (uint32_t slot);
+
+/// Set the value of a thread-local storage slot of the running thread.
+/// \param[in]     slot          slot index obtained by \ref osThreadTlsAlloc.
+/// \param[in]     value         value to store.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osThreadTlsSet (uint32_t slot, void *value);
+
+//  ==== Trace Recorder ====
+
+/// One binary trace record (16 bytes).
+typedef struct {
+  uint32_t timestamp;           ///< free-running timestamp (UCOSx_TS_GET)
+  uint32_t object;              ///< object/thread ID (low 32 bits), meaning depends on event
+  uint32_t arg;                 ///< event argument
+  uint16_t event;               ///< event code (osTraceEvent...)
+  uint16_t context;             ///< interrupt nesting level when recorded (0 = thread)
+} osTraceRecord_t;
+
+// Event codes (osTraceRecord_t::event).
+#define osTraceEventApiEnter    0x0000U   ///< + \ref osTraceApi_t; object = first ID argument, arg = main value argument
+#define osTraceEventApiExit     0x0100U   ///< + \ref osTraceApi_t; object = ID (created object for ...New), arg = return value
+#define osTraceEventSwitch      0x0200U   ///< object = incoming thread, arg = outgoing thread
+#define osTraceEventBlock       0x0201U   ///< running thread leaves the ready state; object = awaited object, arg = osTraceBlock...
+#define osTraceEventWakeup      0x0202U   ///< object = signaled object, arg = first waiter (0 if unknown); the wait may not be satisfied
+#define osTraceEventIsrEnter    0x0203U   ///< arg = interrupt number
+#define osTraceEventIsrExit     0x0204U   ///< arg = interrupt number
+#define osTraceEventTick        0x0205U   ///< kernel tick; arg = tick count
+#define osTraceEventName        0x0206U   ///< object = ID, arg = next 4 name characters (little endian, NUL padded)
+#define osTraceEventUser        0x0300U   ///< + user code 0..255, see \ref osTraceUser
+
+// Block reasons (osTraceEventBlock arg).
+#define osTraceBlockPend        1U        ///< waiting for an object
+#define osTraceBlockDelay       2U        ///< osDelay / osDelayUntil
+#define osTraceBlockSuspend     3U        ///< suspended
+
+/// Traced API calls (low byte of osTraceEventApiEnter / osTraceEventApiExit).
+typedef enum {
+  osTraceApiKernelInitialize = 1,        ///< event code 0 is never recorded
+  osTraceApiKernelStart,
+  osTraceApiKernelLock,
+  osTraceApiKernelUnlock,
+  osTraceApiKernelRestoreLock,
+  osTraceApiThreadNew,
+  osTraceApiThreadSetPriority,
+  osTraceApiThreadYield,
+  osTraceApiThreadExit,
+  osTraceApiThreadTerminate,
+  osTraceApiThreadSuspend,
+  osTraceApiThreadResume,
+  osTraceApiThreadDetach,
+  osTraceApiThreadJoin,
+  osTraceApiDelay,
+  osTraceApiDelayUntil,
+  osTraceApiMutexNew,
+  osTraceApiMutexAcquire,
+  osTraceApiMutexRelease,
+  osTraceApiMutexDelete,
+  osTraceApiSemaphoreNew,
+  osTraceApiSemaphoreAcquire,
+  osTraceApiSemaphoreRelease,
+  osTraceApiSemaphoreDelete,
+  osTraceApiTimerNew,
+  osTraceApiTimerStart,
+  osTraceApiTimerStop,
+  osTraceApiTimerDelete,
+  osTraceApiEventFlagsNew,
+  osTraceApiEventFlagsSet,
+  osTraceApiEventFlagsClear,
+  osTraceApiEventFlagsWait,
+  osTraceApiEventFlagsDelete,
+  osTraceApiMessageQueueNew,
+  osTraceApiMessageQueuePut,
+  osTraceApiMessageQueueGet,
+  osTraceApiMessageQueueReset,
+  osTraceApiMessageQueueDelete,
+  osTraceApiMemoryPoolNew,
+  osTraceApiMemoryPoolAlloc,             ///< arg = timeout; exit arg = block address (0 on failure)
+  osTraceApiMemoryPoolFree,              ///< arg = block address
+  osTraceApiMemoryPoolGetCount,          ///< exit arg = blocks in use
+  osTraceApiMemoryPoolDelete,
+  osTraceApiCount
+} osTraceApi_t;
+
+/// Resume recording (recording is on from reset).
+void osTraceStart (void);
+
+/// Pause recording; records already in the buffer are kept.
+void osTraceStop (void);
+
+/// Move the oldest unread records out of the trace buffer.
+/// \param[out]    records       array receiving the records, oldest first.
+/// \param[in]     max_count     number of entries available in records.
+/// \return number of records stored in records.
+uint32_t osTraceRead (osTraceRecord_t *records, uint32_t max_count);
+
+/// Get the number of records overwritten before they were read.
+/// \return dropped record count since reset.
+uint32_t osTraceGetDropped (void);
+
+/// Record interrupt entry; call first thing in an instrumented ISR.
+/// \param[in]     irq           interrupt number.
+void osTraceIsrEnter (uint32_t irq);
+
+/// Record interrupt exit; call last thing in an instrumented ISR.
+/// \param[in]     irq           interrupt number.
+void osTraceIsrExit (uint32_t irq);
+
+/// Record an application event.
+/// \param[in]     code          user event code 0..255.
+/// \param[in]     object        object the event refers to (may be NULL).
+/// \param[in]     arg           event argument.
+void osTraceUser (uint32_t code, const void *object, uint32_t arg);
+
+//  ==== Tick Profiler ====
+
+/// One tick profiler sample (16 bytes).
+typedef struct {
+  uint32_t tick;                ///< kernel tick count
+  uint32_t thread;              ///< running thread ID (low 32 bits); TCB address for tasks outside the wrapper
+  uint32_t pc;                  ///< interrupted program counter, 0 unless the port supplies it
+  uint16_t flags;               ///< osProfilerSample... flags
+  uint16_t context;             ///< interrupt nesting level below the tick interrupt (0 = thread)
+} osProfilerSample_t;
+
+// Sample flags (osProfilerSample_t::flags).
+#define osProfilerSampleIdle    0x0001U   ///< the idle task was running
+#define osProfilerSampleKernel  0x0002U   ///< a task outside the wrapper (timer, statistics, ...) was running
+
+/// Resume sampling (sampling is on from reset).
+void osProfilerStart (void);
+
+/// Pause sampling; samples already in the buffer are kept.
+void osProfilerStop (void);
+
+/// Move the oldest unread samples out of the sample buffer.
+/// \param[out]    samples       array receiving the samples, oldest first.
+/// \param[in]     max_count     number of entries available in samples.
+/// \return number of samples stored in samples.
+uint32_t osProfilerRead (osProfilerSample_t *samples, uint32_t max_count);
+
+/// Get the number of samples overwritten before they were read.
+/// \return dropped sample count since reset.
+uint32_t osProfilerGetDropped (void);
+
+//  ==== Priority Inversion ====
+
+/// Priority inversions seen on one object. An inversion is a blocking wait by a
+/// thread on a mutex or binary semaphore held by a thread of lower base
+/// priority: the mutex owner, or the last thread that acquired the binary
+/// semaphore. It lasts from the start of the wait to its end. Counting
+/// semaphores and message queues have no holder and record nothing.
+typedef struct {
+  uint32_t     count;           ///< number of inversions
+  uint32_t     inherited;       ///< inversions during which the holder ran at an inherited priority
+  uint64_t     total_cycles;    ///< summed wait time in timestamp cycles (UCOSx_TS_GET)
+  uint32_t     worst_cycles;    ///< longest wait in timestamp cycles
+  uint32_t     worst_inherited; ///< 1 if priority inheritance applied during the longest wait
+  osThreadId_t worst_waiter;    ///< waiting thread of the longest wait
+  osThreadId_t worst_holder;    ///< lower priority thread of the longest wait
+} osInversionStats_t;
+
+/// Get the priority inversions recorded on a mutex.
+/// \param[in]     mutex_id      mutex ID obtained by \ref osMutexNew.
+/// \param[out]    stats         inversion statistics.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osMutexGetInversionStats (osMutexId_t mutex_id, osInversionStats_t *stats);
+
+/// Get the priority inversions recorded on a binary semaphore.
+/// \param[in]     semaphore_id  semaphore ID obtained by \ref osSemaphoreNew.
+/// \param[out]    stats         inversion statistics.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osSemaphoreGetInversionStats (osSemaphoreId_t semaphore_id, osInversionStats_t *stats);
+
+//  ==== Wait Statistics ====
+
+// What a thread waited for (osThreadWaitStat_t::kind).
+#define osWaitKindDelay         0U        ///< osDelay / osDelayUntil; object is NULL
+#define osWaitKindMutex         1U        ///< osMutexAcquire
+#define osWaitKindSemaphore     2U        ///< osSemaphoreAcquire
+#define osWaitKindEventFlags    3U        ///< osEventFlagsWait
+#define osWaitKindMessageQueue  4U        ///< osMessageQueuePut / osMessageQueueGet
+#define osWaitKindThreadJoin    5U        ///< osThreadJoin; object is the joined thread
+#define osWaitKindMemoryPool    6U        ///< osMemoryPoolAlloc
+#define osWaitKindObjectSet     7U        ///< osObjectWaitAny; object is the osObjectWaitSet_t
+#define osWaitKindThreadMessage 8U        ///< osThreadMessageGet; object is NULL
+#define osWaitKindPool          9U        ///< osPoolWaitAll; object is the pool
+#define osWaitKindOther         0xFFU     ///< waits that did not fit in the table; object is NULL
+
+/// Time a thread spent in blocking calls on one object.
+typedef struct {
+  const void *object;           ///< object ID waited on
+  uint32_t    kind;             ///< osWaitKind...
+  uint32_t    count;            ///< number of calls with a non-zero timeout
+  uint64_t    cycles;           ///< summed time in the call, in timestamp cycles (UCOSx_TS_GET)
+  uint32_t    max_cycles;       ///< longest single call
+} osThreadWaitStat_t;
+
+/// Take a snapshot of the blocking time of a thread, one entry per object in
+/// order of first use.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadNew or \ref osThreadGetId.
+/// \param[out]    stats         array receiving the entries.
+/// \param[in]     max_count     number of entries available in stats.
+/// \return number of entries stored in stats.
+uint32_t osThreadGetWaitStats (osThreadId_t thread_id, osThreadWaitStat_t *stats, uint32_t max_count);
+
+//  ==== Slab Allocator ====
+
+/// Slab allocator ID: a set of block-size classes, each backed by a memory pool.
+typedef void *osSlabId_t;
+
+// Slab attributes (osSlabAttr_t::attr_bits).
+#define osSlabOverflow          0x00000001U ///< serve a request from a larger class when its own class is empty
+
+/// One block-size class; the fields are passed to \ref osMemoryPoolNew.
+typedef struct {
+  uint32_t    block_size;       ///< largest request served by the class, in bytes
+  uint32_t    block_count;      ///< number of blocks
+  void       *cb_mem;           ///< memory pool control block
+  uint32_t    cb_size;          ///< size of cb_mem
+  void       *mp_mem;           ///< block storage
+  uint32_t    mp_size;          ///< size of mp_mem
+} osSlabClassAttr_t;
+
+/// Slab attributes.
+typedef struct {
+  const char              *name;        ///< name of the slab
+  uint32_t                 attr_bits;   ///< osSlabOverflow
+  void                    *cb_mem;      ///< slab control block (required)
+  uint32_t                 cb_size;     ///< size of cb_mem
+  const osSlabClassAttr_t *classes;     ///< classes in increasing block_size order
+  uint32_t                 class_count; ///< number of classes
+} osSlabAttr_t;
+
+/// Use of one class. Counters are not reset.
+typedef struct {
+  uint32_t    block_size;       ///< block size after pool rounding
+  uint32_t    capacity;         ///< number of blocks
+  uint32_t    used;             ///< blocks currently allocated
+  uint32_t    peak;             ///< highest used seen after an allocation
+  uint32_t    allocs;           ///< allocations served by this class
+  uint32_t    overflows;        ///< requests for this class served by a larger class
+  uint32_t    failures;         ///< requests for this class that returned NULL
+} osSlabStats_t;
+
+/// Create a slab allocator and its class pools.
+/// \param[in]     attr          slab attributes; cb_mem and at least one class are required.
+/// \return slab ID for reference by other functions or NULL in case of error.
+osSlabId_t osSlabNew (const osSlabAttr_t *attr);
+
+/// Allocate a block from the smallest class that fits size. With
+/// osSlabOverflow larger classes are tried without waiting before the call
+/// blocks on its own class.
+/// \param[in]     slab_id       slab ID obtained by \ref osSlabNew.
+/// \param[in]     size          requested size in bytes.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return address of the allocated block or NULL in case of no memory.
+void *osSlabAlloc (osSlabId_t slab_id, uint32_t size, uint32_t timeout);
+
+/// Return a block to the class it was allocated from.
+/// \param[in]     slab_id       slab ID obtained by \ref osSlabNew.
+/// \param[in]     block         address of a block returned by \ref osSlabAlloc.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osSlabFree (osSlabId_t slab_id, void *block);
+
+/// Get the number of classes of a slab.
+/// \param[in]     slab_id       slab ID obtained by \ref osSlabNew.
+/// \return number of classes or 0 in case of an error.
+uint32_t osSlabGetClassCount (osSlabId_t slab_id);
+
+/// Get the use of one class.
+/// \param[in]     slab_id       slab ID obtained by \ref osSlabNew.
+/// \param[in]     index         class index, in the order of osSlabAttr_t::classes.
+/// \param[out]    stats         class statistics.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osSlabGetStats (osSlabId_t slab_id, uint32_t index, osSlabStats_t *stats);
+
+/// Delete a slab allocator and its class pools.
+/// \param[in]     slab_id       slab ID obtained by \ref osSlabNew.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osSlabDelete (osSlabId_t slab_id);
+
+//  ==== Buffer Descriptors ====
+
+/// Reference-counted buffer: this header sits at the start of a memory pool
+/// block and the payload follows it. The same buffer can be posted to several
+/// pointer-sized message queues and returns to its pool when the last
+/// reference is released.
+typedef struct {
+  osMemoryPoolId_t pool;        ///< pool the block returns to
+  uint32_t         refs;        ///< references held; changed only by the osBuffer functions
+  uint32_t         capacity;    ///< payload size in bytes
+  uint32_t         length;      ///< payload bytes in use, set by the producer
+} osBuffer_t;
+
+/// Payload of a buffer.
+#define osBufferData(buf)       ((void *)((osBuffer_t *)(buf) + 1))
+
+/// Memory pool block size that holds a payload of n bytes.
+#define osBufferBlockSize(n)    ((uint32_t)sizeof(osBuffer_t) + (uint32_t)(n))
+
+/// Allocate a buffer holding one reference.
+/// \param[in]     mp_id         memory pool ID obtained by \ref osMemoryPoolNew.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return buffer or NULL in case of no memory or a block too small for the header.
+osBuffer_t *osBufferAlloc (osMemoryPoolId_t mp_id, uint32_t timeout);
+
+/// Add references to a buffer that is still held.
+/// \param[in]     buf           buffer obtained by \ref osBufferAlloc.
+/// \param[in]     count         number of references to add.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osBufferRetain (osBuffer_t *buf, uint32_t count);
+
+/// Drop one reference; the last one returns the block to its pool.
+/// \param[in]     buf           buffer obtained by \ref osBufferAlloc or \ref osBufferGet.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osBufferRelease (osBuffer_t *buf);
+
+/// Post a buffer to a pointer-sized message queue. The queue entry holds its
+/// own reference, so the caller keeps the reference it had.
+/// \param[in]     mq_id         message queue ID obtained by \ref osMessageQueueNew (msg_size == sizeof(void *)).
+/// \param[in]     buf           buffer obtained by \ref osBufferAlloc.
+/// \param[in]     msg_prio      message priority.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osBufferPut (osMessageQueueId_t mq_id, osBuffer_t *buf, uint8_t msg_prio, uint32_t timeout);
+
+/// Take a buffer from a message queue; the caller owns the reference of the
+/// queue entry and releases it with \ref osBufferRelease.
+/// \param[in]     mq_id         message queue ID obtained by \ref osMessageQueueNew.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return buffer or NULL in case of no message.
+osBuffer_t *osBufferGet (osMessageQueueId_t mq_id, uint32_t timeout);
+
+//  ==== Topic Bus ====
+
+/// Topic ID: a list of subscribers that each publish reaches.
+typedef void *osTopicId_t;
+
+// Topic attributes (osTopicAttr_t::attr_bits).
+#define osTopicBuffers          0x00000001U ///< messages are osBuffer_t pointers, published with \ref osTopicPublishBuffer
+
+// Queue subscriber policy when its queue is full.
+#define osTopicDropNewest       0U        ///< drop the message being published
+#define osTopicDropOldest       1U        ///< discard the oldest queued message to make room
+
+/// Topic attributes.
+typedef struct {
+  const char *name;             ///< name of the topic
+  uint32_t    attr_bits;        ///< osTopicBuffers
+  void       *cb_mem;           ///< topic control block (required)
+  uint32_t    cb_size;          ///< size of cb_mem
+} osTopicAttr_t;
+
+/// Create a topic.
+/// \param[in]     attr          topic attributes.
+/// \return topic ID for reference by other functions or NULL in case of error.
+osTopicId_t osTopicNew (const osTopicAttr_t *attr);
+
+/// Subscribe a pointer-sized message queue to a topic.
+/// \param[in]     topic_id      topic ID obtained by \ref osTopicNew.
+/// \param[in]     mq_id         message queue ID obtained by \ref osMessageQueueNew (msg_size == sizeof(void *)).
+/// \param[in]     policy        osTopicDropNewest or osTopicDropOldest.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osTopicSubscribe (osTopicId_t topic_id, osMessageQueueId_t mq_id, uint32_t policy);
+
+/// Subscribe event flags to a topic; each publish sets flags.
+/// \param[in]     topic_id      topic ID obtained by \ref osTopicNew.
+/// \param[in]     ef_id         event flags ID obtained by \ref osEventFlagsNew.
+/// \param[in]     flags         flags to set (non-zero).
+/// \return status code that indicates the execution status of the function.
+osStatus_t osTopicSubscribeFlags (osTopicId_t topic_id, osEventFlagsId_t ef_id, uint32_t flags);
+
+/// Remove a subscriber.
+/// \param[in]     topic_id      topic ID obtained by \ref osTopicNew.
+/// \param[in]     subscriber    message queue or event flags ID that was subscribed.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osTopicUnsubscribe (osTopicId_t topic_id, void *subscriber);
+
+/// Publish a pointer-sized message to every subscriber without waiting.
+/// \param[in]     topic_id      topic ID obtained by \ref osTopicNew.
+/// \param[in]     msg           message value.
+/// \return number of subscribers that received the message.
+uint32_t osTopicPublish (osTopicId_t topic_id, void *msg);
+
+/// Publish a shared buffer: every queue subscriber receives the same buffer
+/// holding its own reference. The caller keeps its reference.
+/// \param[in]     topic_id      topic ID obtained by \ref osTopicNew (osTopicBuffers).
+/// \param[in]     buf           buffer obtained by \ref osBufferAlloc.
+/// \return number of subscribers that received the buffer.
+uint32_t osTopicPublishBuffer (osTopicId_t topic_id, osBuffer_t *buf);
+
+/// Get the number of messages a subscriber has dropped.
+/// \param[in]     topic_id      topic ID obtained by \ref osTopicNew.
+/// \param[in]     subscriber    message queue ID that was subscribed.
+/// \return number of messages the subscriber lost (dropped, or discarded by osTopicDropOldest).
+uint32_t osTopicGetDropped (osTopicId_t topic_id, void *subscriber);
+
+/// Delete a topic. Messages already queued stay in the subscriber queues.
+/// \param[in]     topic_id      topic ID obtained by \ref osTopicNew.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osTopicDelete (osTopicId_t topic_id);
+
+//  ==== Wait on Multiple Objects ====
+
+/// One object watched by \ref osObjectWaitAny.
+typedef struct {
+  void       *object;           ///< semaphore, message queue or event flags ID
+  uint32_t    flags;            ///< event flags: flags to wait for (ignored for other objects)
+  uint32_t    options;          ///< event flags: osFlagsWaitAny or osFlagsWaitAll
+} osObjectWait_t;
+
+// Order in which ready objects are reported (osObjectWaitSet_t::policy).
+#define osObjectWaitPriority    0U        ///< lowest ready index first
+#define osObjectWaitRoundRobin  1U        ///< first ready index after the one reported last
+
+/// Set of objects waited on together.
+typedef struct {
+  osObjectWait_t *objects;      ///< watched objects
+  uint32_t        count;        ///< number of entries in objects (at most UCOSx_WAIT_ANY_MAX)
+  uint32_t        policy;       ///< osObjectWaitPriority or osObjectWaitRoundRobin
+  uint32_t        cursor;       ///< index reported last (kept by osObjectWaitAny)
+} osObjectWaitSet_t;
+
+/// Wait until one object of a set is ready: a semaphore has tokens, a
+/// message queue holds a message or event flags match. Nothing is consumed;
+/// the caller takes the object with a zero timeout, which may still fail if
+/// another thread got there first.
+/// \param[in,out] set           object set.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return index of a ready object in set->objects, or osErrorResource (none
+///         ready with timeout 0), osErrorTimeout or osErrorParameter.
+int32_t osObjectWaitAny (osObjectWaitSet_t *set, uint32_t timeout);
+
+//  ==== Thread Mailbox ====
+
+/// Send a pointer message to a thread created with osThreadMailbox, without waiting.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadNew.
+/// \param[in]     msg           message value.
+/// \return status code that indicates the execution status of the function
+///         (osErrorResource when the mailbox is full).
+osStatus_t osThreadMessagePut (osThreadId_t thread_id, void *msg);
+
+/// Receive a message from the mailbox of the calling thread.
+/// \param[out]    msg           message value.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osThreadMessageGet (void **msg, uint32_t timeout);
+
+/// Get the number of messages waiting in a thread mailbox.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadNew.
+/// \return number of queued messages.
+uint32_t osThreadMessageGetCount (osThreadId_t thread_id);
+
+//  ==== Work Queue ====
+
+/// Work queue ID: worker threads that run work items submitted from ISRs or threads.
+typedef void *osWorkQueueId_t;
+
+/// Work item function, run by a worker thread.
+typedef void (*osWorkFunc_t) (void *argument);
+
+/// Work item, allocated by the caller and reused for every submission. The
+/// queue owns next, pending and submitted; func and argument must not change
+/// while the item is pending.
+typedef struct osWork_s {
+  struct osWork_s *next;        ///< link in the work queue
+  osWorkFunc_t     func;        ///< function to run
+  void            *argument;    ///< argument passed to func
+  uint32_t         pending;     ///< non-zero from submission until a worker takes the item
+  uint32_t         submitted;   ///< submission timestamp (UCOSx_TS_GET)
+} osWork_t;
+
+/// Static initializer of a work item.
+#define osWorkInitializer(func, argument)  { NULL, (func), (argument), 0U, 0U }
+
+/// Work queue attributes.
+typedef struct {
+  const char  *name;            ///< name of the queue and its worker threads
+  osPriority_t priority;        ///< worker priority; osPriorityNone selects UCOSx_WORKQ_PRIORITY
+  uint32_t     workers;         ///< number of worker threads (1 to UCOSx_WORKQ_WORKERS; 0 selects 1)
+  void        *cb_mem;          ///< work queue control block, including the workers (required)
+  uint32_t     cb_size;         ///< size of cb_mem
+  void        *stack_mem;       ///< stack memory shared evenly by the workers (required)
+  uint32_t     stack_size;      ///< size of stack_mem
+} osWorkQueueAttr_t;
+
+/// Work queue counters. Counters are not reset.
+typedef struct {
+  uint32_t    submitted;        ///< submissions that queued an item
+  uint32_t    coalesced;        ///< submissions of an item that was already pending
+  uint32_t    executed;         ///< items taken by a worker
+  uint32_t    max_latency;      ///< longest time from submission to a worker taking the item, in timestamp cycles
+  uint64_t    total_latency;    ///< summed latency of the executed items
+} osWorkQueueStats_t;
+
+/// Create a work queue and start its worker threads.
+/// \param[in]     attr          work queue attributes.
+/// \return work queue ID for reference by other functions or NULL in case of error.
+osWorkQueueId_t osWorkQueueNew (const osWorkQueueAttr_t *attr);
+
+/// Initialize a work item at run time (see \ref osWorkInitializer).
+/// \param[out]    work          work item.
+/// \param[in]     func          function to run.
+/// \param[in]     argument      argument passed to func.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osWorkInit (osWork_t *work, osWorkFunc_t func, void *argument);
+
+/// Queue a work item without waiting; may be called from ISRs. Submitting an
+/// item that is still pending does nothing and returns osOK, so the item
+/// runs once. An item may be submitted again from its own function.
+/// \param[in]     wq_id         work queue ID obtained by \ref osWorkQueueNew.
+/// \param[in]     work          work item.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osWorkSubmit (osWorkQueueId_t wq_id, osWork_t *work);
+
+/// Get the counters of a work queue.
+/// \param[in]     wq_id         work queue ID obtained by \ref osWorkQueueNew.
+/// \param[out]    stats         work queue counters.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osWorkQueueGetStats (osWorkQueueId_t wq_id, osWorkQueueStats_t *stats);
+
+/// Delete a work queue and terminate its workers. Items still queued are
+/// dropped and may be submitted elsewhere; call it while no item is running.
+/// \param[in]     wq_id         work queue ID obtained by \ref osWorkQueueNew.
+/// \return status code that indicates the execution status of the function;
+///         osErrorResource when called from one of the queue's workers.
+osStatus_t osWorkQueueDelete (osWorkQueueId_t wq_id);
+
+//  ==== Thread Pool ====
+
+/// Thread pool ID: worker threads with per-worker job deques and work stealing.
+typedef void *osPoolId_t;
+
+/// Job function, run by a pool worker.
+typedef void (*osPoolFunc_t) (void *argument);
+
+/// Thread pool attributes.
+typedef struct {
+  const char  *name;            ///< name of the pool and its worker threads
+  osPriority_t priority;        ///< worker priority; osPriorityNone selects osPriorityNormal
+  uint32_t     workers;         ///< number of worker threads (1 to UCOSx_POOL_WORKERS; 0 selects UCOSx_POOL_WORKERS)
+  void        *cb_mem;          ///< pool control block, including the workers and their deques (required)
+  uint32_t     cb_size;         ///< size of cb_mem
+  void        *stack_mem;       ///< stack memory shared evenly by the workers (required)
+  uint32_t     stack_size;      ///< size of stack_mem
+} osPoolAttr_t;
+
+/// Thread pool counters. Counters are not reset.
+typedef struct {
+  uint32_t    submitted;        ///< jobs accepted by \ref osPoolSubmit
+  uint32_t    executed;         ///< jobs finished
+  uint32_t    stolen;           ///< jobs run by a worker other than the one they were queued on
+  uint32_t    outstanding;      ///< jobs queued or running now
+} osPoolStats_t;
+
+/// Create a thread pool and start its workers.
+/// \param[in]     attr          thread pool attributes.
+/// \return thread pool ID for reference by other functions or NULL in case of error.
+osPoolId_t osPoolNew (const osPoolAttr_t *attr);
+
+/// Queue a job without waiting. A job submitted by a worker of the pool goes
+/// to that worker's deque; other threads spread jobs over the workers in turn.
+/// \param[in]     pool_id       thread pool ID obtained by \ref osPoolNew.
+/// \param[in]     func          job function.
+/// \param[in]     argument      argument passed to func.
+/// \return status code that indicates the execution status of the function
+///         (osErrorResource when every deque is full).
+osStatus_t osPoolSubmit (osPoolId_t pool_id, osPoolFunc_t func, void *argument);
+
+/// Wait until every submitted job has finished. Not callable from a worker of the pool.
+/// \param[in]     pool_id       thread pool ID obtained by \ref osPoolNew.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osPoolWaitAll (osPoolId_t pool_id, uint32_t timeout);
+
+/// Get the counters of a thread pool.
+/// \param[in]     pool_id       thread pool ID obtained by \ref osPoolNew.
+/// \param[out]    stats         thread pool counters.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osPoolGetStats (osPoolId_t pool_id, osPoolStats_t *stats);
+
+/// Delete a thread pool and terminate its workers. Queued jobs are dropped;
+/// call it while no job is running.
+/// \param[in]     pool_id       thread pool ID obtained by \ref osPoolNew.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osPoolDelete (osPoolId_t pool_id);
+
+//  ==== Coroutines ====
+
+/// Coroutine scheduler ID: one thread that runs many stackless coroutines.
+typedef void *osCoroSchedId_t;
+
+/// Resume state of a coroutine, the first member of its control block.
+typedef struct {
+  uint32_t    line;             ///< resume point, kept by the osCoro macros (0 before the first run)
+  osStatus_t  result;           ///< last wait: osOK (object ready), osErrorTimeout or osErrorParameter
+} osCoro_t;
+
+/// Coroutine function. It runs from its last resume point to the next
+/// osCoroYield, osCoroAwait or osCoroDelay, or to osCoroEnd, and returns one
+/// of the osCoro run states below. Locals are not kept across those points;
+/// keep state in the argument. An await cannot sit inside a switch statement.
+typedef uint32_t (*osCoroFunc_t) (osCoro_t *co, void *argument);
+
+// Run states returned by a coroutine function.
+#define osCoroReady             0U        ///< run again in the next pass
+#define osCoroBlocked           1U        ///< waiting as set by osCoroWaitFor
+#define osCoroExited            2U        ///< finished; the control block may be reused
+
+/// Start of a coroutine function body.
+#define osCoroBegin(co)         switch ((co)->line) { case 0U:
+
+/// End of a coroutine function body; the coroutine exits.
+#define osCoroEnd(co)           } (co)->line = 0U; return osCoroExited
+
+/// Let the other coroutines of the scheduler run.
+#define osCoroYield(co) \
+  do { (co)->line = (uint32_t)__LINE__; return osCoroReady; case __LINE__:; } while (0)
+
+/// Wait until a semaphore has tokens or a message queue holds a message
+/// (nothing is taken), or for timeout ticks; then (co)->result tells which.
+#define osCoroAwait(co, object, timeout) \
+  osCoroAwaitFlags((co), (object), 0U, 0U, (timeout))
+
+/// Wait until event flags match (see \ref osObjectWait_t), or for timeout ticks.
+#define osCoroAwaitFlags(co, object, flags, options, timeout) \
+  do { (void)osCoroWaitFor((co), (object), (flags), (options), (timeout)); \
+       (co)->line = (uint32_t)__LINE__; return osCoroBlocked; case __LINE__:; } while (0)
+
+/// Wait for ticks kernel ticks.
+#define osCoroDelay(co, ticks)  osCoroAwaitFlags((co), NULL, 0U, 0U, (ticks))
+
+/// Coroutine scheduler attributes.
+typedef struct {
+  const char  *name;            ///< name of the scheduler thread
+  osPriority_t priority;        ///< thread priority; osPriorityNone selects osPriorityNormal
+  void        *cb_mem;          ///< scheduler control block, including its thread (required)
+  uint32_t     cb_size;         ///< size of cb_mem
+  void        *stack_mem;       ///< stack memory of the scheduler thread (required)
+  uint32_t     stack_size;      ///< size of stack_mem
+} osCoroSchedAttr_t;
+
+/// Coroutine scheduler counters. Counters are not reset.
+typedef struct {
+  uint32_t    coroutines;       ///< coroutines added and not exited
+  uint32_t    resumed;          ///< coroutine function calls
+  uint32_t    wakeups;          ///< times the scheduler thread woke up after blocking
+} osCoroSchedStats_t;
+
+/// Create a coroutine scheduler and start its thread.
+/// \param[in]     attr          coroutine scheduler attributes.
+/// \return coroutine scheduler ID for reference by other functions or NULL in case of error.
+osCoroSchedId_t osCoroSchedNew (const osCoroSchedAttr_t *attr);
+
+/// Add a coroutine to a scheduler; it first runs in the next pass.
+/// \param[in]     sched_id      coroutine scheduler ID obtained by \ref osCoroSchedNew.
+/// \param[in]     func          coroutine function.
+/// \param[in]     argument      argument passed to func.
+/// \param[in]     cb_mem        coroutine control block, kept until the coroutine exits.
+/// \param[in]     cb_size       size of cb_mem.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osCoroNew (osCoroSchedId_t sched_id, osCoroFunc_t func, void *argument, void *cb_mem, uint32_t cb_size);
+
+/// Set what the calling coroutine waits for; used by osCoroAwait and osCoroDelay.
+/// \param[in]     co            calling coroutine.
+/// \param[in]     object        semaphore, message queue or event flags ID, or NULL for a delay.
+/// \param[in]     flags         event flags: flags to wait for (ignored for other objects).
+/// \param[in]     options       event flags: osFlagsWaitAny or osFlagsWaitAll.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osCoroWaitFor (osCoro_t *co, void *object, uint32_t flags, uint32_t options, uint32_t timeout);
+
+/// Get the counters of a coroutine scheduler.
+/// \param[in]     sched_id      coroutine scheduler ID obtained by \ref osCoroSchedNew.
+/// \param[out]    stats         coroutine scheduler counters.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osCoroSchedGetStats (osCoroSchedId_t sched_id, osCoroSchedStats_t *stats);
+
+/// Delete a coroutine scheduler and terminate its thread. Its coroutines are
+/// dropped. Not callable from a coroutine.
+/// \param[in]     sched_id      coroutine scheduler ID obtained by \ref osCoroSchedNew.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osCoroSchedDelete (osCoroSchedId_t sched_id);
+
+//  ==== Active Objects ====
+
+/// Active object ID: a thread with its own event queue that runs each event
+/// to completion in a handler.
+typedef void *osActiveId_t;
+
+/// Event posted by reference. A dynamic event is a buffer (\ref osBuffer_t)
+/// from a memory pool, and application fields may follow this header in the
+/// same block; a static event (buf.pool NULL) is never freed or counted.
+typedef struct {
+  osBuffer_t  buf;              ///< reference count and pool
+  uint32_t    signal;           ///< application signal
+} osEvent_t;
+
+/// Static initializer of an event that is not allocated from a pool.
+#define osEventStatic(signal)   { { NULL, 0U, 0U, 0U }, (signal) }
+
+/// Event handler, run in the active object's thread, one event at a time.
+typedef void (*osActiveHandler_t) (osActiveId_t ao_id, const osEvent_t *event, void *argument);
+
+/// Time event: posts its static event to an active object after a number of
+/// ticks, once or periodically. All time events are counted down by the
+/// kernel tick hook; none of them uses an osTimer.
+typedef struct osTimeEvent_s {
+  osEvent_t              event;     ///< event posted on expiry (static)
+  struct osTimeEvent_s  *next;      ///< link in the armed list
+  osActiveId_t           target;    ///< active object the event is posted to
+  uint32_t               ctr;       ///< ticks left while armed, 0 otherwise
+  uint32_t               interval;  ///< ticks reloaded after expiry, 0 for a one-shot
+  struct osTimeEvent_s  *due;       ///< link in the list of events expired in a tick
+} osTimeEvent_t;
+
+/// Static initializer of a time event.
+#define osTimeEventInitializer(signal, target)  { osEventStatic(signal), NULL, (target), 0U, 0U, NULL }
+
+/// Active object attributes.
+typedef struct {
+  const char  *name;            ///< name of the active object and its thread
+  osPriority_t priority;        ///< thread priority; osPriorityNone selects osPriorityNormal
+  void        *cb_mem;          ///< active object control block, including its thread and queue (required)
+  uint32_t     cb_size;         ///< size of cb_mem
+  void        *stack_mem;       ///< stack memory of the thread (required)
+  uint32_t     stack_size;      ///< size of stack_mem
+} osActiveAttr_t;
+
+/// Active object counters. Counters are not reset.
+typedef struct {
+  uint32_t    posted;           ///< events queued
+  uint32_t    dispatched;       ///< events handled
+  uint32_t    dropped;          ///< posts refused because the queue was full
+  uint32_t    max_queued;       ///< most events queued at once
+} osActiveStats_t;
+
+/// Allocate a dynamic event holding one reference (the caller's).
+/// \param[in]     mp_id         memory pool ID obtained by \ref osMemoryPoolNew.
+/// \param[in]     signal        application signal.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return event or NULL in case of no memory.
+osEvent_t *osEventNew (osMemoryPoolId_t mp_id, uint32_t signal, uint32_t timeout);
+
+/// Drop one reference to an event; the last one returns it to its pool.
+/// Static events are ignored.
+/// \param[in]     event         event obtained by \ref osEventNew.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osEventRelease (osEvent_t *event);
+
+/// Create an active object and start its thread.
+/// \param[in]     handler       event handler.
+/// \param[in]     argument      argument passed to handler.
+/// \param[in]     attr          active object attributes.
+/// \return active object ID for reference by other functions or NULL in case of error.
+osActiveId_t osActiveNew (osActiveHandler_t handler, void *argument, const osActiveAttr_t *attr);
+
+/// Post an event by reference without waiting; may be called from ISRs. The
+/// queue entry holds its own reference, so the caller keeps the one it had.
+/// \param[in]     ao_id         active object ID obtained by \ref osActiveNew.
+/// \param[in]     event         event to post.
+/// \return status code that indicates the execution status of the function
+///         (osErrorResource when the queue is full).
+osStatus_t osActivePost (osActiveId_t ao_id, osEvent_t *event);
+
+/// Start a time event; a time event that is already armed is restarted.
+/// \param[in]     te            time event with its target set.
+/// \param[in]     ticks         ticks until the first post (non-zero).
+/// \param[in]     interval      ticks between later posts, 0 for a one-shot.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osTimeEventArm (osTimeEvent_t *te, uint32_t ticks, uint32_t interval);
+
+/// Stop a time event. Its event may already be queued.
+/// \param[in]     te            time event.
+/// \return status code that indicates the execution status of the function
+///         (osErrorResource when it was not armed).
+osStatus_t osTimeEventDisarm (osTimeEvent_t *te);
+
+/// Get the counters of an active object.
+/// \param[in]     ao_id         active object ID obtained by \ref osActiveNew.
+/// \param[out]    stats         active object counters.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osActiveGetStats (osActiveId_t ao_id, osActiveStats_t *stats);
+
+/// Delete an active object and terminate its thread. Queued events are
+/// released, as is the event in progress if the handler was preempted or is
+/// blocked, and its time events are disarmed. Not callable from its handler.
+/// \param[in]     ao_id         active object ID obtained by \ref osActiveNew.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osActiveDelete (osActiveId_t ao_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMSIS_OS2_EXT_H_ */
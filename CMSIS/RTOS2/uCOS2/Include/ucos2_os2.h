@@ -10,6 +10,7 @@ extern "C" {
 #include <stdbool.h>
 
 #include "cmsis_os2.h"
+#include "cmsis_os2_ext.h"
 #include "ucos_ii.h"
 
 /*
@@ -115,6 +116,385 @@ extern "C" {
 #define UCOS2_THREAD_DEFAULT_STACK   512u
 #endif
 
+/* Words zeroed at the far end of the stack for osThreadStackPaint threads */
+#ifndef UCOS2_STACK_PAINT_WORDS
+#define UCOS2_STACK_PAINT_WORDS      64u
+#endif
+
+/* Create threads with OS_TASK_OPT_SAVE_FP unless they carry osThreadNoFpu */
+#ifndef UCOS2_THREAD_SAVE_FP
+#define UCOS2_THREAD_SAVE_FP         1u
+#endif
+
+/* Thread-local storage slots kept in os_ucos2_thread_t (0 disables TLS) */
+#ifndef UCOS2_TLS_SLOTS
+#define UCOS2_TLS_SLOTS                0u
+#endif
+
+/*
+ * Background stack profiler: a low priority CMSIS thread that walks every
+ * thread's stack watermark UCOS2_STACK_PROFILER_CHUNK_WORDS words at a time
+ * with the scheduler locked, sleeping UCOS2_STACK_PROFILER_PERIOD_TICKS
+ * between steps, so no single scan adds noticeable latency.
+ */
+#ifndef UCOS2_STACK_PROFILER_EN
+#define UCOS2_STACK_PROFILER_EN           0u
+#endif
+
+#ifndef UCOS2_STACK_PROFILER_CHUNK_WORDS
+#define UCOS2_STACK_PROFILER_CHUNK_WORDS  32u
+#endif
+
+#ifndef UCOS2_STACK_PROFILER_PERIOD_TICKS
+#define UCOS2_STACK_PROFILER_PERIOD_TICKS 10u
+#endif
+
+#ifndef UCOS2_STACK_PROFILER_PRIORITY
+#define UCOS2_STACK_PROFILER_PRIORITY     osPriorityIdle
+#endif
+
+#ifndef UCOS2_STACK_PROFILER_STACK
+#define UCOS2_STACK_PROFILER_STACK        512u
+#endif
+
+#if (UCOS2_STACK_PROFILER_EN > 0u) && (UCOS2_STACK_PROFILER_CHUNK_WORDS == 0u)
+#error "UCOS2_STACK_PROFILER_CHUNK_WORDS must be non-zero."
+#endif
+
+/*
+ * Lock-free fast paths. With UCOS2_LOCKFREE_EN the wrapper updates shared
+ * words from threads and ISRs with UCOS2_ATOMIC_CAS()/UCOS2_ATOMIC_ADD()
+ * instead of short critical sections: the memory pool free stack, slab
+ * statistics, buffer reference counts, work queue submission and active
+ * object queues. Cores without exclusive load/store (Armv6-M) default to 0,
+ * as GCC would turn the CAS into library calls newlib does not provide.
+ * UCOS2_MEMPOOL_LOCKFREE is the deprecated name of the same option.
+ *
+ * Memory pools (osMemoryPool*) keep their free blocks on a stack of 16-bit
+ * block indices linked through free_stack. Lock-free, the stack head carries
+ * an ABA tag, so alloc and free never disable interrupts and the kernel is
+ * entered only to block on or wake an empty pool.
+ */
+#ifndef UCOS2_LOCKFREE_EN
+#if defined(UCOS2_MEMPOOL_LOCKFREE)
+#define UCOS2_LOCKFREE_EN              UCOS2_MEMPOOL_LOCKFREE
+#elif defined(__ARM_ARCH_6M__) || (defined(__arm__) && !defined(__ARM_FEATURE_LDREX))
+#define UCOS2_LOCKFREE_EN              0u
+#else
+#define UCOS2_LOCKFREE_EN              1u
+#endif
+#endif
+
+#ifndef UCOS2_MEMPOOL_LOCKFREE
+#define UCOS2_MEMPOOL_LOCKFREE         UCOS2_LOCKFREE_EN
+#elif ((UCOS2_MEMPOOL_LOCKFREE > 0u) != (UCOS2_LOCKFREE_EN > 0u))
+#error "UCOS2_MEMPOOL_LOCKFREE is a deprecated alias of UCOS2_LOCKFREE_EN; set only UCOS2_LOCKFREE_EN."
+#endif
+
+#if (UCOS2_LOCKFREE_EN > 0u)
+#if defined(__GNUC__)
+#ifndef UCOS2_ATOMIC_CAS
+#define UCOS2_ATOMIC_CAS(p, expected, desired) \
+  __atomic_compare_exchange_n((p), (expected), (desired), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#endif
+#ifndef UCOS2_ATOMIC_ADD
+#define UCOS2_ATOMIC_ADD(p, v)           __atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+#endif
+#endif
+#if !defined(UCOS2_ATOMIC_CAS) || !defined(UCOS2_ATOMIC_ADD)
+#error "Define UCOS2_ATOMIC_CAS(p, expected, desired) and UCOS2_ATOMIC_ADD(p, v) for uint32_t, or set UCOS2_LOCKFREE_EN to 0."
+#endif
+#endif
+
+/*
+ * Slab allocator (osSlab*, cmsis_os2_ext.h): each block-size class is a
+ * memory pool on caller-provided storage. UCOS2_SLAB_CLASSES is the most
+ * classes one slab can have and sizes os_ucos2_slab_t.
+ */
+#ifndef UCOS2_SLAB_CLASSES
+#define UCOS2_SLAB_CLASSES             8u
+#endif
+
+#if (UCOS2_SLAB_CLASSES == 0u)
+#error "UCOS2_SLAB_CLASSES must be non-zero."
+#endif
+
+/*
+ * Topic bus (osTopic*, cmsis_os2_ext.h): subscribers of a topic live in one
+ * array of UCOS2_TOPIC_SUBSCRIBERS entries inside os_ucos2_topic_t.
+ */
+#ifndef UCOS2_TOPIC_SUBSCRIBERS
+#define UCOS2_TOPIC_SUBSCRIBERS        8u
+#endif
+
+#if (UCOS2_TOPIC_SUBSCRIBERS == 0u)
+#error "UCOS2_TOPIC_SUBSCRIBERS must be non-zero."
+#endif
+
+/*
+ * Per-thread CPU usage (cmsis_os2_ext.h). uC/OS-II has no hook pointers, so the
+ * application forwards App_TaskSwHook()/App_TimeTickHook() to
+ * osUcos2TaskSwHook()/osUcos2TimeTickHook() and supplies a free-running
+ * timestamp through UCOS2_TS_GET() (e.g. the DWT cycle counter in app_cfg.h).
+ */
+#ifndef UCOS2_CPU_USAGE_EN
+#define UCOS2_CPU_USAGE_EN             0u
+#endif
+
+#ifndef UCOS2_CPU_USAGE_WINDOW_TICKS
+#define UCOS2_CPU_USAGE_WINDOW_TICKS   1000u
+#endif
+
+#ifndef UCOS2_CPU_USAGE_SLOTS
+#define UCOS2_CPU_USAGE_SLOTS          4u
+#endif
+
+#define UCOS2_CPU_USAGE_RING           (UCOS2_CPU_USAGE_SLOTS + 1u)
+
+#if (UCOS2_CPU_USAGE_EN > 0u)
+#if (UCOS2_CPU_USAGE_SLOTS == 0u) || ((UCOS2_CPU_USAGE_WINDOW_TICKS % UCOS2_CPU_USAGE_SLOTS) != 0u)
+#error "UCOS2_CPU_USAGE_WINDOW_TICKS must be a non-zero multiple of UCOS2_CPU_USAGE_SLOTS."
+#endif
+#if (OS_TASK_SW_HOOK_EN < 1u) || (OS_TIME_TICK_HOOK_EN < 1u)
+#error "Enable OS_TASK_SW_HOOK_EN and OS_TIME_TICK_HOOK_EN for CPU usage accounting."
+#endif
+#ifndef UCOS2_TS_GET
+#error "Define UCOS2_TS_GET() (32-bit free-running timestamp) for CPU usage accounting."
+#endif
+#endif
+
+/*
+ * Binary trace recorder (cmsis_os2_ext.h): API calls, context switches,
+ * blocking and wakeups go into a ring of UCOS2_TRACE_EVENTS 16-byte records.
+ * Writers reserve a slot with UCOS2_TRACE_ATOMIC_INC() and never lock, so
+ * ISRs can record too; the oldest records are overwritten when the reader
+ * falls behind. Each slot also has a sequence word (4 more bytes) that
+ * marks it complete. Switch/Block records come from osUcos2TaskSwHook() and tick
+ * records from osUcos2TimeTickHook(), which the application must forward.
+ */
+#ifndef UCOS2_TRACE_EN
+#define UCOS2_TRACE_EN                 0u
+#endif
+
+#ifndef UCOS2_TRACE_EVENTS
+#define UCOS2_TRACE_EVENTS             512u
+#endif
+
+#if (UCOS2_TRACE_EN > 0u)
+#if (UCOS2_TRACE_EVENTS == 0u) || ((UCOS2_TRACE_EVENTS & (UCOS2_TRACE_EVENTS - 1u)) != 0u)
+#error "UCOS2_TRACE_EVENTS must be a power of two."
+#endif
+#if (OS_TASK_SW_HOOK_EN < 1u) || (OS_TIME_TICK_HOOK_EN < 1u)
+#error "Enable OS_TASK_SW_HOOK_EN and OS_TIME_TICK_HOOK_EN for the trace recorder."
+#endif
+#ifndef UCOS2_TS_GET
+#error "Define UCOS2_TS_GET() (32-bit free-running timestamp) for the trace recorder."
+#endif
+#ifndef UCOS2_TRACE_ATOMIC_INC
+#if defined(__GNUC__)
+#define UCOS2_TRACE_ATOMIC_INC(p)      __atomic_fetch_add((p), 1u, __ATOMIC_RELAXED)
+#else
+#error "Define UCOS2_TRACE_ATOMIC_INC(p) (atomic fetch-and-increment of a uint32_t) for this compiler."
+#endif
+#endif
+#endif
+
+/*
+ * Tick sampling profiler (cmsis_os2_ext.h): on every tick osUcos2TimeTickHook()
+ * stores the running task and, when UCOS2_PROFILER_PC() is defined, the
+ * program counter the tick interrupt preempted into a ring of
+ * UCOS2_PROFILER_SAMPLES 16-byte samples. The tick interrupt is the only
+ * writer, so a sample is a few stores with no lock; the oldest samples are
+ * overwritten when the reader falls behind.
+ */
+#ifndef UCOS2_PROFILER_EN
+#define UCOS2_PROFILER_EN              0u
+#endif
+
+#ifndef UCOS2_PROFILER_SAMPLES
+#define UCOS2_PROFILER_SAMPLES         1024u
+#endif
+
+#if (UCOS2_PROFILER_EN > 0u)
+#if (UCOS2_PROFILER_SAMPLES == 0u) || ((UCOS2_PROFILER_SAMPLES & (UCOS2_PROFILER_SAMPLES - 1u)) != 0u)
+#error "UCOS2_PROFILER_SAMPLES must be a power of two."
+#endif
+#if (OS_TIME_TICK_HOOK_EN < 1u)
+#error "Enable OS_TIME_TICK_HOOK_EN for the tick profiler."
+#endif
+/* Return the interrupted PC, e.g. the one stacked by the tick exception and
+ * saved by the SysTick handler; samples carry 0 when not defined. */
+#ifndef UCOS2_PROFILER_PC
+#define UCOS2_PROFILER_PC()            0u
+#endif
+#endif
+
+/*
+ * Priority inversion detector (cmsis_os2_ext.h): a thread that blocks on a
+ * mutex or binary semaphore held by a thread of lower priority adds the wait
+ * time to that object's statistics. The wrapper creates
+ * mutexes without a priority ceiling, so uC/OS-II never inherits and
+ * osInversionStats_t::inherited stays 0.
+ * UCOS2_INVERSION_HOOK(object, waiter, holder) runs in thread context when an
+ * inversion is detected, e.g. to log it or to break into the debugger.
+ */
+#ifndef UCOS2_INVERSION_EN
+#define UCOS2_INVERSION_EN             0u
+#endif
+
+#ifndef UCOS2_INVERSION_HOOK
+#define UCOS2_INVERSION_HOOK(object, waiter, holder) ((void)(object), (void)(waiter), (void)(holder))
+#endif
+
+#if (UCOS2_INVERSION_EN > 0u) && !defined(UCOS2_TS_GET)
+#error "Define UCOS2_TS_GET() (32-bit free-running timestamp) for the priority inversion detector."
+#endif
+
+/*
+ * Per-thread wait statistics (cmsis_os2_ext.h): every blocking call charges
+ * its duration to a table of UCOS2_WAIT_STATS_SLOTS entries in the thread,
+ * one per object; waits beyond the table share the last entry.
+ */
+#ifndef UCOS2_WAIT_STATS_EN
+#define UCOS2_WAIT_STATS_EN            0u
+#endif
+
+#ifndef UCOS2_WAIT_STATS_SLOTS
+#define UCOS2_WAIT_STATS_SLOTS         8u
+#endif
+
+#if (UCOS2_WAIT_STATS_EN > 0u)
+#if (UCOS2_WAIT_STATS_SLOTS < 2u)
+#error "UCOS2_WAIT_STATS_SLOTS must be at least 2."
+#endif
+#ifndef UCOS2_TS_GET
+#error "Define UCOS2_TS_GET() (32-bit free-running timestamp) for wait statistics."
+#endif
+#endif
+
+/*
+ * Waiting on several objects (osObjectWaitAny, cmsis_os2_ext.h): a waiter
+ * links one node per object into the semaphores, message queues and event
+ * flags it watches, and every post to such an object wakes the linked
+ * waiters. UCOS2_WAIT_ANY_MAX bounds the objects per call (nodes live on
+ * the caller's stack).
+ */
+#ifndef UCOS2_WAIT_ANY_EN
+#define UCOS2_WAIT_ANY_EN              0u
+#endif
+
+#ifndef UCOS2_WAIT_ANY_MAX
+#define UCOS2_WAIT_ANY_MAX             8u
+#endif
+
+#if (UCOS2_WAIT_ANY_EN > 0u) && (UCOS2_WAIT_ANY_MAX == 0u)
+#error "UCOS2_WAIT_ANY_MAX must be non-zero."
+#endif
+
+/*
+ * Thread mailboxes (osThreadMessagePut/Get, cmsis_os2_ext.h): uC/OS-II has
+ * no task message queue, so a thread created with osThreadMailbox gets an
+ * OS_Q over UCOS2_MAILBOX_DEPTH pointers kept in its control block (one event
+ * control block and one OS_Q from the OS_MAX_EVENTS / OS_MAX_QS pools).
+ */
+#ifndef UCOS2_MAILBOX_EN
+#define UCOS2_MAILBOX_EN               0u
+#endif
+
+#ifndef UCOS2_MAILBOX_DEPTH
+#define UCOS2_MAILBOX_DEPTH            8u
+#endif
+
+#if (UCOS2_MAILBOX_EN > 0u) && (UCOS2_MAILBOX_DEPTH == 0u)
+#error "UCOS2_MAILBOX_DEPTH must be non-zero."
+#endif
+
+/*
+ * Deferred work queues (osWorkQueue*, cmsis_os2_ext.h): ISRs submit
+ * preallocated work items and up to UCOS2_WORKQ_WORKERS wrapper-owned threads
+ * per queue run them at UCOS2_WORKQ_PRIORITY unless the queue attributes say
+ * otherwise. With UCOS2_LOCKFREE_EN submission pushes onto the queue with
+ * UCOS2_ATOMIC_CAS(), which must then also take pointer-sized words (the
+ * default builtin does), and never disables interrupts.
+ */
+#ifndef UCOS2_WORKQ_EN
+#define UCOS2_WORKQ_EN                 0u
+#endif
+
+#ifndef UCOS2_WORKQ_WORKERS
+#define UCOS2_WORKQ_WORKERS            2u
+#endif
+
+#ifndef UCOS2_WORKQ_PRIORITY
+#define UCOS2_WORKQ_PRIORITY           osPriorityHigh
+#endif
+
+#if (UCOS2_WORKQ_EN > 0u) && (UCOS2_WORKQ_WORKERS == 0u)
+#error "UCOS2_WORKQ_WORKERS must be non-zero."
+#endif
+#if (UCOS2_WORKQ_EN > 0u) && !defined(UCOS2_TS_GET)
+#error "Define UCOS2_TS_GET() (32-bit free-running timestamp) for work queue latency."
+#endif
+
+/*
+ * Thread pools (osPool*, cmsis_os2_ext.h): up to UCOS2_POOL_WORKERS worker
+ * threads per pool, each owning a deque of UCOS2_POOL_DEQUE jobs (a power of
+ * two). A worker runs its own newest job first and steals the oldest job
+ * of another worker when its deque is empty.
+ */
+#ifndef UCOS2_POOL_EN
+#define UCOS2_POOL_EN                  0u
+#endif
+
+#ifndef UCOS2_POOL_WORKERS
+#define UCOS2_POOL_WORKERS             4u
+#endif
+
+#ifndef UCOS2_POOL_DEQUE
+#define UCOS2_POOL_DEQUE               16u
+#endif
+
+#if (UCOS2_POOL_EN > 0u) && (UCOS2_POOL_WORKERS == 0u)
+#error "UCOS2_POOL_WORKERS must be non-zero."
+#endif
+#if (UCOS2_POOL_EN > 0u) && ((UCOS2_POOL_DEQUE == 0u) || ((UCOS2_POOL_DEQUE & (UCOS2_POOL_DEQUE - 1u)) != 0u))
+#error "UCOS2_POOL_DEQUE must be a power of two."
+#endif
+
+/*
+ * Stackless coroutines (osCoro*, cmsis_os2_ext.h): one scheduler thread runs
+ * any number of coroutines, each in a caller-provided control block of a few
+ * dozen bytes. A coroutine waiting on an object links an osObjectWaitAny
+ * node to it, so UCOS2_CORO_EN needs UCOS2_WAIT_ANY_EN.
+ */
+#ifndef UCOS2_CORO_EN
+#define UCOS2_CORO_EN                  0u
+#endif
+
+#if (UCOS2_CORO_EN > 0u) && (UCOS2_WAIT_ANY_EN == 0u)
+#error "UCOS2_CORO_EN requires UCOS2_WAIT_ANY_EN."
+#endif
+
+/*
+ * Active objects (osActive*, cmsis_os2_ext.h): each active object owns a
+ * thread and a queue of UCOS2_ACTIVE_QUEUE event pointers (a power of two) that
+ * threads and ISRs post to without waiting. With UCOS2_LOCKFREE_EN a post
+ * reserves its slot with UCOS2_ATOMIC_CAS() and never disables interrupts.
+ * Time events are counted down in
+ * osUcos2TimeTickHook(), so App_TimeTickHook() must call it.
+ */
+#ifndef UCOS2_ACTIVE_EN
+#define UCOS2_ACTIVE_EN                0u
+#endif
+
+#ifndef UCOS2_ACTIVE_QUEUE
+#define UCOS2_ACTIVE_QUEUE             16u
+#endif
+
+#if (UCOS2_ACTIVE_EN > 0u) && ((UCOS2_ACTIVE_QUEUE == 0u) || ((UCOS2_ACTIVE_QUEUE & (UCOS2_ACTIVE_QUEUE - 1u)) != 0u))
+#error "UCOS2_ACTIVE_QUEUE must be a power of two."
+#endif
+
 /*
  * Helper structure used to maintain intrusive lists of CMSIS objects. The wrapper
  * keeps lightweight tracking information to enable enumeration and cleanup.
@@ -133,7 +513,13 @@ typedef enum {
   osUcos2ObjectMutex,
   osUcos2ObjectSemaphore,
   osUcos2ObjectMemoryPool,
-  osUcos2ObjectMessageQueue
+  osUcos2ObjectMessageQueue,
+  osUcos2ObjectSlab,
+  osUcos2ObjectTopic,
+  osUcos2ObjectWorkQueue,
+  osUcos2ObjectPool,
+  osUcos2ObjectCoroSched,
+  osUcos2ObjectActive
 } os_ucos2_object_type_t;
 
 typedef struct os_ucos2_object {
@@ -154,6 +540,13 @@ typedef enum {
   osUcos2ThreadJoinable = 1u
 } os_ucos2_thread_mode_t;
 
+typedef struct os_ucos2_cpu_usage {
+  uint64_t cycles;
+  uint32_t switches;
+  uint32_t slot_epoch[UCOS2_CPU_USAGE_RING];
+  uint64_t slot_cycles[UCOS2_CPU_USAGE_RING];
+} os_ucos2_cpu_usage_t;
+
 typedef struct os_ucos2_thread {
   os_ucos2_object_t object;
   osThreadFunc_t    entry;
@@ -170,6 +563,31 @@ typedef struct os_ucos2_thread {
   uint8_t           owns_cb_mem;
   uint8_t           owns_stack_mem;
   uint8_t           reserved[1];
+  uint32_t          stack_free;   /* lowest free stack words seen */
+#if (UCOS2_TLS_SLOTS > 0u)
+  void             *tls[UCOS2_TLS_SLOTS];
+#endif
+#if (UCOS2_CPU_USAGE_EN > 0u)
+  os_ucos2_cpu_usage_t cpu;
+#endif
+#if (UCOS2_TRACE_EN > 0u)
+  uint32_t          trace_object; /* object of the last API call, for Block records */
+#endif
+#if (UCOS2_INVERSION_EN > 0u)
+  osInversionStats_t *inv_stats;  /* stats of the awaited object, NULL when not waiting */
+  struct os_ucos2_thread *inv_holder; /* lower priority thread holding it up */
+  uint32_t          inv_since;
+#endif
+#if (UCOS2_WAIT_STATS_EN > 0u)
+  osThreadWaitStat_t wait[UCOS2_WAIT_STATS_SLOTS];
+#endif
+#if (UCOS2_MAILBOX_EN > 0u)
+  OS_EVENT         *mailbox;      /* OS_Q of an osThreadMailbox thread, else NULL */
+  void             *mailbox_mem[UCOS2_MAILBOX_DEPTH];
+#endif
+#if (UCOS2_WAIT_ANY_EN > 0u)
+  OS_EVENT         *wait_any_sem; /* osObjectWaitAny wake, reset before each wait */
+#endif
 } os_ucos2_thread_t;
 
 typedef struct os_ucos2_timer {
@@ -181,10 +599,19 @@ typedef struct os_ucos2_timer {
   uint8_t           active;
 } os_ucos2_timer_t;
 
+typedef struct os_ucos2_wait_any_node {
+  struct os_ucos2_wait_any_node  *next;
+  struct os_ucos2_wait_any_node **pprev;
+  OS_EVENT                      *wake;
+} os_ucos2_wait_any_node_t;
+
 typedef struct os_ucos2_event_flags {
   os_ucos2_object_t object;
   OS_FLAG_GRP      *grp;
   uint8_t           owns_cb_mem;
+#if (UCOS2_WAIT_ANY_EN > 0u)
+  os_ucos2_wait_any_node_t *wait_any; /* osObjectWaitAny waiters */
+#endif
 } os_ucos2_event_flags_t;
 
 typedef struct os_ucos2_mutex {
@@ -194,6 +621,9 @@ typedef struct os_ucos2_mutex {
   uint8_t           owns_cb_mem;
   uint16_t          lock_count;
   os_ucos2_thread_t *owner;
+#if (UCOS2_INVERSION_EN > 0u)
+  osInversionStats_t inversion;
+#endif
 } os_ucos2_mutex_t;
 
 typedef struct os_ucos2_semaphore {
@@ -202,16 +632,25 @@ typedef struct os_ucos2_semaphore {
   uint32_t          max_count;
   uint32_t          initial_count;
   uint8_t           owns_cb_mem;
+#if (UCOS2_INVERSION_EN > 0u)
+  osInversionStats_t inversion;
+  os_ucos2_thread_t *holder;        /* last CMSIS thread to take a binary semaphore */
+#endif
+#if (UCOS2_WAIT_ANY_EN > 0u)
+  os_ucos2_wait_any_node_t *wait_any; /* osObjectWaitAny waiters */
+#endif
 } os_ucos2_semaphore_t;
 
 typedef struct os_ucos2_memory_pool {
   os_ucos2_object_t object;
   uint8_t          *pool_mem;
-  uint16_t         *free_stack;
+  uint16_t         *free_stack;     /* next free block index, per block */
   uint32_t          block_size;
   uint32_t          block_count;
-  uint32_t          free_top;
-  uint8_t           owns_memory;
+  uint32_t          free_top;       /* ABA tag << 16 | first free block index */
+  uint32_t          used;
+  uint32_t          waiters;        /* threads registered to block in osMemoryPoolAlloc */
+  OS_EVENT         *wait_sem;
 } os_ucos2_memory_pool_t;
 
 typedef struct os_ucos2_message_queue {
@@ -221,8 +660,141 @@ typedef struct os_ucos2_message_queue {
   void            **queue_storage;
   uint32_t          msg_size;
   uint32_t          msg_count;
+#if (UCOS2_WAIT_ANY_EN > 0u)
+  os_ucos2_wait_any_node_t *wait_any; /* osObjectWaitAny waiters */
+#endif
 } os_ucos2_message_queue_t;
 
+typedef struct os_ucos2_slab_class {
+  osMemoryPoolId_t  pool;
+  uint8_t          *base;           /* block address range, for osSlabFree */
+  uint8_t          *limit;
+  uint32_t          block_size;
+  uint32_t          peak;
+  uint32_t          allocs;
+  uint32_t          overflows;      /* requests of this class served by a larger one */
+  uint32_t          failures;
+} os_ucos2_slab_class_t;
+
+typedef struct os_ucos2_slab {
+  os_ucos2_object_t     object;
+  uint32_t              class_count;
+  os_ucos2_slab_class_t classes[UCOS2_SLAB_CLASSES];
+} os_ucos2_slab_t;
+
+typedef struct os_ucos2_topic_sub {
+  void             *target;         /* osMessageQueueId_t, or osEventFlagsId_t when flags != 0 */
+  uint32_t          flags;
+  uint32_t          policy;
+  uint32_t          dropped;
+} os_ucos2_topic_sub_t;
+
+typedef struct os_ucos2_topic {
+  os_ucos2_object_t     object;
+  uint32_t              count;
+  bool                  created;
+  os_ucos2_topic_sub_t  subs[UCOS2_TOPIC_SUBSCRIBERS];
+} os_ucos2_topic_t;
+
+#if (UCOS2_WORKQ_EN > 0u)
+typedef struct os_ucos2_work_queue {
+  os_ucos2_object_t object;
+  osWork_t         *incoming;       /* submissions, newest first */
+  osWork_t         *ready_head;     /* submissions in order, taken by the workers */
+  OS_EVENT         *wake;
+  uint32_t          worker_count;
+  uint32_t          submitted;
+  uint32_t          coalesced;
+  uint32_t          executed;
+  uint32_t          max_latency;
+  uint64_t          total_latency;
+  bool              created;
+  os_ucos2_thread_t workers[UCOS2_WORKQ_WORKERS];
+} os_ucos2_work_queue_t;
+#endif
+
+#if (UCOS2_POOL_EN > 0u)
+typedef struct os_ucos2_pool_job {
+  osPoolFunc_t      func;
+  void             *argument;
+} os_ucos2_pool_job_t;
+
+typedef struct os_ucos2_pool_worker {
+  os_ucos2_thread_t thread;         /* first, so the thread ID is the worker */
+  struct os_ucos2_pool *pool;
+  uint32_t          top;            /* oldest job, taken by thieves */
+  uint32_t          bottom;         /* next free slot, the owner's end */
+  os_ucos2_pool_job_t jobs[UCOS2_POOL_DEQUE];
+} os_ucos2_pool_worker_t;
+
+typedef struct os_ucos2_pool {
+  os_ucos2_object_t object;
+  OS_EVENT         *work_sem;
+  OS_FLAG_GRP      *done;           /* bit 0 set while no job is outstanding */
+  uint32_t          worker_count;
+  uint32_t          idle;           /* workers blocked on work_sem */
+  uint32_t          next;           /* deque for the next submission from outside */
+  uint32_t          outstanding;    /* jobs submitted and not finished */
+  uint32_t          submitted;
+  uint32_t          executed;
+  uint32_t          stolen;
+  bool              created;
+  os_ucos2_pool_worker_t workers[UCOS2_POOL_WORKERS];
+} os_ucos2_pool_t;
+#endif
+
+#if (UCOS2_CORO_EN > 0u)
+typedef struct os_ucos2_coro {
+  osCoro_t          co;             /* first, so osCoro_t * is the control block */
+  struct os_ucos2_coro *next;
+  struct os_ucos2_coro_sched *sched;
+  osCoroFunc_t      func;
+  void             *argument;
+  osObjectWait_t    wait;           /* object is NULL for a delay */
+  os_ucos2_wait_any_node_t node;
+  uint32_t          deadline;       /* tick count when timed */
+  uint8_t           state;          /* osCoroReady or osCoroBlocked */
+  bool              timed;
+} os_ucos2_coro_t;
+
+typedef struct os_ucos2_coro_sched {
+  os_ucos2_object_t object;
+  OS_EVENT         *wake;           /* posted by osCoroNew and by the awaited objects */
+  os_ucos2_coro_t  *incoming;       /* added by osCoroNew, newest first */
+  os_ucos2_coro_t  *head;           /* run by the scheduler thread */
+  uint32_t          coroutines;
+  uint32_t          resumed;
+  uint32_t          wakeups;
+  bool              created;
+  os_ucos2_thread_t thread;
+} os_ucos2_coro_sched_t;
+#endif
+
+#if (UCOS2_ACTIVE_EN > 0u)
+typedef struct os_ucos2_active_slot {
+  uint32_t          seq;            /* position + 1 once filled, position + depth once free */
+  osEvent_t        *event;
+} os_ucos2_active_slot_t;
+
+typedef struct os_ucos2_active {
+  os_ucos2_object_t object;
+  OS_EVENT         *wake;           /* posted when the thread waits for an event */
+  osActiveHandler_t handler;
+  void             *argument;
+  uint32_t          tail;           /* next position to reserve, producers */
+  uint32_t          head;           /* next position to dispatch, the thread */
+  uint32_t          waiting;        /* 1 while the thread is about to pend on wake */
+  osEvent_t        *current;        /* taken and not yet released, for osActiveDelete */
+  uint32_t          posted;
+  uint32_t          dispatched;
+  uint32_t          dropped;
+  uint32_t          max_queued;
+  bool              created;
+  os_ucos2_thread_t thread;
+  os_ucos2_active_slot_t slots[UCOS2_ACTIVE_QUEUE];
+} os_ucos2_active_t;
+#endif
+
 /*
  * Kernel bookkeeping structure.
  */
@@ -233,6 +805,40 @@ typedef struct os_ucos2_kernel {
   uint32_t        sys_timer_freq;
   bool            initialized;
   os_ucos2_list_t threads;
+#if (UCOS2_TLS_SLOTS > 0u)
+  uint32_t        tls_next;
+#endif
+#if (UCOS2_STACK_PROFILER_EN > 0u)
+  struct os_ucos2_thread *stk_prof_cursor;
+  uint32_t        stk_prof_pos;
+#endif
+#if (UCOS2_CPU_USAGE_EN > 0u)
+  os_ucos2_cpu_usage_t cpu_idle;
+  os_ucos2_cpu_usage_t cpu_kernel;
+  uint32_t        cpu_slot_len[UCOS2_CPU_USAGE_RING];
+  uint32_t        cpu_epoch;
+  uint32_t        cpu_slot_tick;
+  uint32_t        cpu_last_ts;
+  uint32_t        cpu_slot_ts;
+#endif
+#if (UCOS2_TRACE_EN > 0u)
+  osTraceRecord_t trace_buf[UCOS2_TRACE_EVENTS];
+  volatile uint32_t trace_seq[UCOS2_TRACE_EVENTS];  /* index + 1 of the record each slot holds */
+  uint32_t        trace_head;       /* next slot to reserve */
+  uint32_t        trace_tail;       /* next slot to read */
+  uint32_t        trace_dropped;
+  volatile bool   trace_paused;
+#endif
+#if (UCOS2_PROFILER_EN > 0u)
+  osProfilerSample_t prof_buf[UCOS2_PROFILER_SAMPLES];
+  uint32_t        prof_head;        /* samples taken */
+  uint32_t        prof_tail;        /* next sample to read */
+  uint32_t        prof_dropped;
+  volatile bool   prof_paused;
+#endif
+#if (UCOS2_ACTIVE_EN > 0u)
+  osTimeEvent_t  *time_events;      /* armed, counted down each tick */
+#endif
 } os_ucos2_kernel_t;
 
 extern os_ucos2_kernel_t os_ucos2_kernel;
@@ -250,6 +856,24 @@ os_ucos2_mutex_t *osUcos2MutexFromId(osMutexId_t mutex_id);
 os_ucos2_semaphore_t *osUcos2SemaphoreFromId(osSemaphoreId_t semaphore_id);
 os_ucos2_memory_pool_t *osUcos2MemoryPoolFromId(osMemoryPoolId_t mp_id);
 os_ucos2_message_queue_t *osUcos2MessageQueueFromId(osMessageQueueId_t mq_id);
+os_ucos2_slab_t *osUcos2SlabFromId(osSlabId_t slab_id);
+os_ucos2_topic_t *osUcos2TopicFromId(osTopicId_t topic_id);
+#if (UCOS2_WORKQ_EN > 0u)
+os_ucos2_work_queue_t *osUcos2WorkQueueFromId(osWorkQueueId_t wq_id);
+#endif
+#if (UCOS2_POOL_EN > 0u)
+os_ucos2_pool_t *osUcos2PoolFromId(osPoolId_t pool_id);
+#endif
+#if (UCOS2_CORO_EN > 0u)
+os_ucos2_coro_sched_t *osUcos2CoroSchedFromId(osCoroSchedId_t sched_id);
+#endif
+#if (UCOS2_ACTIVE_EN > 0u)
+os_ucos2_active_t *osUcos2ActiveFromId(osActiveId_t ao_id);
+#endif
+
+/* Call from App_TaskSwHook()/App_TimeTickHook(); no-ops unless a feature needs them. */
+void osUcos2TaskSwHook(void);
+void osUcos2TimeTickHook(void);
 
 #ifdef __cplusplus
 }
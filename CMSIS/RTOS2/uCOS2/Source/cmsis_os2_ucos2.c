@@ -23,6 +23,89 @@ static inline bool osUcos2IsrDisallowsWait(uint32_t timeout) {
   return osUcos2IrqContext() && (timeout != 0u);
 }
 
+#if (UCOS2_STACK_PROFILER_EN > 0u)
+static osStatus_t osUcos2StackProfilerStart(void);
+#endif
+#if (UCOS2_PROFILER_EN > 0u)
+static void osUcos2ProfilerSample(void);
+#endif
+#if (UCOS2_ACTIVE_EN > 0u)
+static void osUcos2TimeEventTick(void);
+#endif
+
+/* Trace points; the public API functions are thin wrappers around the
+ * osUcos2Xxx implementations so entry and exit are recorded in one place. */
+#if (UCOS2_TRACE_EN > 0u)
+static void osUcos2TraceEmit(uint32_t event, uint32_t object, uint32_t arg);
+static void osUcos2TraceApiEnter(uint32_t api, uint32_t object, uint32_t arg);
+static void osUcos2TraceName(uint32_t object, const char *name);
+static void osUcos2TraceWakeup(uint32_t object, const OS_EVENT *pevent);
+static void osUcos2TraceSwitch(const OS_TCB *from, const OS_TCB *to);
+
+#define UCOS2_TRACE_ID(object)                ((uint32_t)(uintptr_t)(object))
+#define UCOS2_TRACE_ENTER(api, object, arg)   osUcos2TraceApiEnter((uint32_t)(api), UCOS2_TRACE_ID(object), (uint32_t)(arg))
+#define UCOS2_TRACE_EXIT(api, object, result) osUcos2TraceEmit(osTraceEventApiExit | (uint32_t)(api), UCOS2_TRACE_ID(object), (uint32_t)(result))
+#define UCOS2_TRACE_NAME(object, name)        osUcos2TraceName(UCOS2_TRACE_ID(object), (name))
+#define UCOS2_TRACE_WAKEUP(object, pevent)    osUcos2TraceWakeup(UCOS2_TRACE_ID(object), (pevent))
+/* The flag wait list is not priority ordered: the waiter is left unknown. */
+#define UCOS2_TRACE_WAKEUP_FLAGS(object, grp) \
+  do { \
+    if ((grp)->OSFlagWaitList != NULL) { \
+      osUcos2TraceEmit(osTraceEventWakeup, UCOS2_TRACE_ID(object), 0u); \
+    } \
+  } while (0)
+#else
+#define UCOS2_TRACE_ENTER(api, object, arg)   ((void)0)
+#define UCOS2_TRACE_EXIT(api, object, result) ((void)0)
+#define UCOS2_TRACE_NAME(object, name)        ((void)0)
+#define UCOS2_TRACE_WAKEUP(object, pevent)    ((void)0)
+#define UCOS2_TRACE_WAKEUP_FLAGS(object, grp) ((void)0)
+#endif
+
+/* Inversion checks bracket each blocking pend on a mutex or binary semaphore;
+ * a binary semaphore remembers its last taker until the next release. */
+#if (UCOS2_INVERSION_EN > 0u)
+static void osUcos2InversionBegin(void *object, osInversionStats_t *stats, const OS_EVENT *mutex,
+                                  os_ucos2_thread_t *const *taker);
+static void osUcos2InversionEnd(INT8U err);
+static void osUcos2InversionTake(os_ucos2_semaphore_t *sem, INT8U err);
+static void osUcos2InversionGive(os_ucos2_semaphore_t *sem);
+
+#define UCOS2_INVERSION_BEGIN(object, stats, mutex, taker) \
+  osUcos2InversionBegin((object), (stats), (mutex), (taker))
+#define UCOS2_INVERSION_END(err)                     osUcos2InversionEnd(err)
+#define UCOS2_INVERSION_TAKE(sem, err)               osUcos2InversionTake((sem), (err))
+#define UCOS2_INVERSION_GIVE(sem)                    osUcos2InversionGive(sem)
+#else
+#define UCOS2_INVERSION_BEGIN(object, stats, mutex, taker) ((void)0)
+#define UCOS2_INVERSION_END(err)                     ((void)0)
+#define UCOS2_INVERSION_TAKE(sem, err)               ((void)0)
+#define UCOS2_INVERSION_GIVE(sem)                    ((void)0)
+#endif
+
+/* Wait statistics time the whole blocking call in the public wrapper. */
+#if (UCOS2_WAIT_STATS_EN > 0u)
+static void osUcos2WaitRecord(uint32_t kind, const void *object, uint32_t start);
+
+#define UCOS2_WAIT_BEGIN(start)         uint32_t start = UCOS2_TS_GET()
+#define UCOS2_WAIT_END(start, kind, object, timeout) \
+  do { if ((timeout) != 0u) { osUcos2WaitRecord((kind), (object), (start)); } } while (0)
+#else
+#define UCOS2_WAIT_BEGIN(start)         ((void)0)
+#define UCOS2_WAIT_END(start, kind, object, timeout) ((void)0)
+#endif
+
+/* osObjectWaitAny waiters are woken after each post to a watched object and
+ * detached when it is deleted. */
+#if (UCOS2_WAIT_ANY_EN > 0u)
+static void osUcos2WaitAnyNotify(os_ucos2_wait_any_node_t **head, bool detach);
+
+#define UCOS2_WAIT_ANY_NOTIFY(head, detach) \
+  do { if ((head) != NULL) { osUcos2WaitAnyNotify(&(head), (detach)); } } while (0)
+#else
+#define UCOS2_WAIT_ANY_NOTIFY(head, detach) ((void)0)
+#endif
+
 static void osUcos2ObjectInit(os_ucos2_object_t *object,
                               os_ucos2_object_type_t type,
                               const char *name,
@@ -147,11 +230,25 @@ os_ucos2_thread_t *osUcos2ThreadFromId(osThreadId_t thread_id) {
   return thread;
 }
 
+/* CMSIS threads pass themselves as pext, so most lookups avoid the list walk. */
+static inline os_ucos2_thread_t *osUcos2ThreadFromExt(const OS_TCB *ptcb) {
+  os_ucos2_thread_t *thread = (os_ucos2_thread_t *)ptcb->OSTCBExtPtr;
+  if ((thread != NULL) && (thread->object.type == osUcos2ObjectThread) && (thread->tcb == ptcb)) {
+    return thread;
+  }
+  return NULL;
+}
+
 os_ucos2_thread_t *osUcos2ThreadFromTcb(const OS_TCB *ptcb) {
   if (ptcb == NULL) {
     return NULL;
   }
 
+  os_ucos2_thread_t *found = osUcos2ThreadFromExt(ptcb);
+  if (found != NULL) {
+    return found;
+  }
+
   os_ucos2_object_t *cursor = os_ucos2_kernel.threads.head;
   while (cursor != NULL) {
     os_ucos2_thread_t *thread = (os_ucos2_thread_t *)cursor;
@@ -164,6 +261,23 @@ os_ucos2_thread_t *osUcos2ThreadFromTcb(const OS_TCB *ptcb) {
   return NULL;
 }
 
+#if (UCOS2_TRACE_EN > 0u)
+/* The thread a post on pevent readies: uC/OS-II readies the highest priority
+ * waiter, and its wait list is a bitmap, so search the CMSIS threads. Call
+ * with interrupts disabled. */
+static os_ucos2_thread_t *osUcos2EventWaiter(const OS_EVENT *pevent) {
+  os_ucos2_thread_t *waiter = NULL;
+  for (os_ucos2_object_t *cursor = os_ucos2_kernel.threads.head; cursor != NULL; cursor = cursor->next) {
+    os_ucos2_thread_t *thread = (os_ucos2_thread_t *)cursor;
+    if ((thread->tcb != NULL) && (thread->tcb->OSTCBEventPtr == pevent) &&
+        ((waiter == NULL) || (thread->tcb->OSTCBPrio < waiter->tcb->OSTCBPrio))) {
+      waiter = thread;
+    }
+  }
+  return waiter;
+}
+#endif
+
 static void osUcos2ObjectListInsert(os_ucos2_list_t *list, os_ucos2_object_t *object) {
   object->prev = list->tail;
   object->next = NULL;
@@ -207,6 +321,13 @@ void osUcos2ThreadListRemove(os_ucos2_thread_t *thread) {
     return;
   }
 
+#if (UCOS2_STACK_PROFILER_EN > 0u)
+  if (os_ucos2_kernel.stk_prof_cursor == thread) {
+    os_ucos2_kernel.stk_prof_cursor = (os_ucos2_thread_t *)thread->object.next;
+    os_ucos2_kernel.stk_prof_pos = 0u;
+  }
+#endif
+
   osUcos2ObjectListRemove(&os_ucos2_kernel.threads, &thread->object);
 }
 
@@ -270,6 +391,18 @@ static void osUcos2ThreadFreeResources(os_ucos2_thread_t *thread) {
     (void)OSSemDel(thread->join_sem, OS_DEL_ALWAYS, &err);
     thread->join_sem = NULL;
   }
+#if (UCOS2_MAILBOX_EN > 0u)
+  if (thread->mailbox != NULL) {
+    (void)OSQDel(thread->mailbox, OS_DEL_ALWAYS, &err);
+    thread->mailbox = NULL;
+  }
+#endif
+#if (UCOS2_WAIT_ANY_EN > 0u)
+  if (thread->wait_any_sem != NULL) {
+    (void)OSSemDel(thread->wait_any_sem, OS_DEL_ALWAYS, &err);
+    thread->wait_any_sem = NULL;
+  }
+#endif
 }
 
 void osUcos2ThreadCleanup(os_ucos2_thread_t *thread) {
@@ -278,6 +411,22 @@ void osUcos2ThreadCleanup(os_ucos2_thread_t *thread) {
   }
 
   osUcos2ThreadListRemove(thread);
+#if (UCOS2_MAILBOX_EN > 0u)
+  /* A joinable thread keeps its control block until joined; the mailbox
+   * goes with the task. */
+  if (thread->mailbox != NULL) {
+    INT8U err;
+    (void)OSQDel(thread->mailbox, OS_DEL_ALWAYS, &err);
+    thread->mailbox = NULL;
+  }
+#endif
+#if (UCOS2_WAIT_ANY_EN > 0u)
+  if (thread->wait_any_sem != NULL) {
+    INT8U err;
+    (void)OSSemDel(thread->wait_any_sem, OS_DEL_ALWAYS, &err);
+    thread->wait_any_sem = NULL;
+  }
+#endif
 
   if ((thread->mode == osUcos2ThreadJoinable) && (thread->join_sem != NULL)) {
     thread->tcb = NULL;
@@ -333,6 +482,43 @@ static INT8U osUcos2AllocatePriority(osPriority_t priority) {
   return OS_PRIO_SELF;
 }
 
+/*
+ * Stack initialization and FP context options selected by the extension
+ * attr_bits. Also seeds the watermark record for the chosen mode.
+ */
+static INT16U osUcos2ThreadOptions(os_ucos2_thread_t *thread, uint32_t stack_words) {
+  uint32_t bits = thread->object.attr_bits;
+  INT16U opt = OS_TASK_OPT_STK_CHK;
+
+  switch (bits & osThreadStackInit_Msk) {
+    case osThreadStackPaint: {
+      uint32_t paint = (stack_words < UCOS2_STACK_PAINT_WORDS) ? stack_words : UCOS2_STACK_PAINT_WORDS;
+#if OS_STK_GROWTH == 1u
+      memset(&thread->stack_mem[0], 0, paint * sizeof(OS_STK));
+#else
+      memset(&thread->stack_mem[stack_words - paint], 0, paint * sizeof(OS_STK));
+#endif
+      thread->stack_free = paint;
+      break;
+    }
+    case osThreadStackNoInit:
+      opt = OS_TASK_OPT_NONE;
+      thread->stack_free = 0u;
+      break;
+    default:
+      opt |= OS_TASK_OPT_STK_CLR;
+      break;
+  }
+
+#if (UCOS2_THREAD_SAVE_FP > 0u)
+  if ((bits & osThreadNoFpu) == 0u) {
+    opt |= OS_TASK_OPT_SAVE_FP;
+  }
+#endif
+
+  return opt;
+}
+
 static void osUcos2ThreadTrampoline(void *argument) {
   os_ucos2_thread_t *thread = (os_ucos2_thread_t *)argument;
 
@@ -340,6 +526,8 @@ static void osUcos2ThreadTrampoline(void *argument) {
     OSTaskDel(OS_PRIO_SELF);
   }
 
+  /* A higher priority thread starts before OSTaskCreateExt() returns. */
+  thread->tcb = OSTCBCur;
   thread->state = osThreadRunning;
   thread->entry(thread->argument);
 
@@ -348,7 +536,7 @@ static void osUcos2ThreadTrampoline(void *argument) {
 
 /* ==== Kernel Management ==== */
 
-osStatus_t osKernelInitialize(void) {
+static osStatus_t osUcos2KernelInitialize(void) {
   if (osUcos2IrqContext()) {
     return osErrorISR;
   }
@@ -364,6 +552,13 @@ osStatus_t osKernelInitialize(void) {
   return osOK;
 }
 
+osStatus_t osKernelInitialize(void) {
+  UCOS2_TRACE_ENTER(osTraceApiKernelInitialize, 0u, 0u);
+  osStatus_t status = osUcos2KernelInitialize();
+  UCOS2_TRACE_EXIT(osTraceApiKernelInitialize, 0u, status);
+  return status;
+}
+
 osStatus_t osKernelGetInfo(osVersion_t *version, char *id_buf, uint32_t id_size) {
   if (version != NULL) {
     version->api    = 0x02020000u;                   /* CMSIS-RTOS2 v2.2.0 */
@@ -391,7 +586,7 @@ osKernelState_t osKernelGetState(void) {
   return os_ucos2_kernel.state;
 }
 
-osStatus_t osKernelStart(void) {
+static osStatus_t osUcos2KernelStart(void) {
   if (osUcos2IrqContext()) {
     return osErrorISR;
   }
@@ -400,12 +595,33 @@ osStatus_t osKernelStart(void) {
     return osError;
   }
 
+#if (UCOS2_CPU_USAGE_EN > 0u)
+  os_ucos2_kernel.cpu_epoch = 1u;
+  os_ucos2_kernel.cpu_slot_tick = 0u;
+  os_ucos2_kernel.cpu_last_ts = UCOS2_TS_GET();
+  os_ucos2_kernel.cpu_slot_ts = os_ucos2_kernel.cpu_last_ts;
+#endif
+
+#if (UCOS2_STACK_PROFILER_EN > 0u)
+  if (osUcos2StackProfilerStart() != osOK) {
+    return osError;
+  }
+#endif
+
   os_ucos2_kernel.state = osKernelRunning;
   OSStart();
   return osOK;
 }
 
-int32_t osKernelLock(void) {
+osStatus_t osKernelStart(void) {
+  UCOS2_TRACE_ENTER(osTraceApiKernelStart, 0u, 0u);
+  UCOS2_TRACE_NAME(OSTCBPrioTbl[OS_TASK_IDLE_PRIO], "idle");
+  osStatus_t status = osUcos2KernelStart();
+  UCOS2_TRACE_EXIT(osTraceApiKernelStart, 0u, status);
+  return status;
+}
+
+static int32_t osUcos2KernelLock(void) {
   if (osUcos2IrqContext()) {
     return (int32_t)osErrorISR;
   }
@@ -419,7 +635,14 @@ int32_t osKernelLock(void) {
   return previous;
 }
 
-int32_t osKernelUnlock(void) {
+int32_t osKernelLock(void) {
+  UCOS2_TRACE_ENTER(osTraceApiKernelLock, 0u, 0u);
+  int32_t result = osUcos2KernelLock();
+  UCOS2_TRACE_EXIT(osTraceApiKernelLock, 0u, result);
+  return result;
+}
+
+static int32_t osUcos2KernelUnlock(void) {
   if (osUcos2IrqContext()) {
     return (int32_t)osErrorISR;
   }
@@ -433,7 +656,14 @@ int32_t osKernelUnlock(void) {
   return previous;
 }
 
-int32_t osKernelRestoreLock(int32_t lock) {
+int32_t osKernelUnlock(void) {
+  UCOS2_TRACE_ENTER(osTraceApiKernelUnlock, 0u, 0u);
+  int32_t result = osUcos2KernelUnlock();
+  UCOS2_TRACE_EXIT(osTraceApiKernelUnlock, 0u, result);
+  return result;
+}
+
+static int32_t osUcos2KernelRestoreLock(int32_t lock) {
   if (osUcos2IrqContext()) {
     return (int32_t)osErrorISR;
   }
@@ -453,6 +683,13 @@ int32_t osKernelRestoreLock(int32_t lock) {
   return (OSLockNesting > 0u) ? 1 : 0;
 }
 
+int32_t osKernelRestoreLock(int32_t lock) {
+  UCOS2_TRACE_ENTER(osTraceApiKernelRestoreLock, 0u, lock);
+  int32_t result = osUcos2KernelRestoreLock(lock);
+  UCOS2_TRACE_EXIT(osTraceApiKernelRestoreLock, 0u, result);
+  return result;
+}
+
 uint32_t osKernelGetTickCount(void) {
   return OSTimeGet();
 }
@@ -471,7 +708,7 @@ uint32_t osKernelGetSysTimerFreq(void) {
 
 /* ==== Thread Management ==== */
 
-osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr) {
+static osThreadId_t osUcos2ThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr) {
   if ((func == NULL) || (attr == NULL) ||
       (attr->stack_mem == NULL) || (attr->stack_size == 0u)) {
     return NULL;
@@ -504,6 +741,7 @@ osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr
   thread->owns_stack_mem = 0u;
   thread->stack_mem = stack_mem;
   thread->stack_size = stack_words * sizeof(OS_STK);
+  thread->stack_free = stack_words;
   thread->entry = func;
   thread->argument = argument;
   thread->cmsis_prio = priority;
@@ -528,6 +766,26 @@ osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr
     return NULL;
   }
 
+#if (UCOS2_MAILBOX_EN > 0u)
+  thread->mailbox = NULL;
+  if ((thread->object.attr_bits & osThreadMailbox) != 0u) {
+    thread->mailbox = OSQCreate(thread->mailbox_mem, (INT16U)UCOS2_MAILBOX_DEPTH);
+    if (thread->mailbox == NULL) {
+      osUcos2ThreadFreeResources(thread);
+      return NULL;
+    }
+  }
+#endif
+
+#if (UCOS2_WAIT_ANY_EN > 0u)
+  thread->wait_any_sem = OSSemCreate(0u);
+  if (thread->wait_any_sem == NULL) {
+    osUcos2ThreadFreeResources(thread);
+    return NULL;
+  }
+#endif
+
+  INT16U opt = osUcos2ThreadOptions(thread, stack_words);
   osUcos2ThreadListInsert(thread);
 
 #if OS_STK_GROWTH == 1u
@@ -546,7 +804,7 @@ osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr
                         pbos,
                         stack_words,
                         thread,
-                        OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);
+                        opt);
   if (err != OS_ERR_NONE) {
     thread->mode = osUcos2ThreadDetached;
     osUcos2ThreadCleanup(thread);
@@ -558,6 +816,14 @@ osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr
   return (osThreadId_t)thread;
 }
 
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr) {
+  UCOS2_TRACE_ENTER(osTraceApiThreadNew, 0u, (uintptr_t)func);
+  osThreadId_t id = osUcos2ThreadNew(func, argument, attr);
+  UCOS2_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS2_TRACE_EXIT(osTraceApiThreadNew, id, 0u);
+  return id;
+}
+
 const char *osThreadGetName(osThreadId_t thread_id) {
   os_ucos2_thread_t *thread = (thread_id == NULL)
                               ? osUcos2ThreadFromTcb(OSTCBCur)
@@ -603,6 +869,59 @@ osThreadState_t osThreadGetState(osThreadId_t thread_id) {
   return osThreadReady;
 }
 
+/*
+ * OS_TASK_OPT_STK_CLR (or osThreadStackPaint) leaves unused words at zero.
+ * Return the index of the first used word in [from, limit), counting from the
+ * far end of the stack.
+ */
+static uint32_t osUcos2StackScan(const os_ucos2_thread_t *thread, uint32_t from, uint32_t limit) {
+  uint32_t words = thread->stack_size / (uint32_t)sizeof(OS_STK);
+  for (uint32_t i = from; i < limit; ++i) {
+#if OS_STK_GROWTH == 1u
+    (void)words;
+    if (thread->stack_mem[i] != (OS_STK)0) {
+#else
+    if (thread->stack_mem[words - 1u - i] != (OS_STK)0) {
+#endif
+      return i;
+    }
+  }
+  return limit;
+}
+
+uint32_t osThreadGetStackSize(osThreadId_t thread_id) {
+  os_ucos2_thread_t *thread = osUcos2ThreadFromId(thread_id);
+  if ((thread == NULL) || osUcos2IrqContext()) {
+    return 0u;
+  }
+
+  return thread->stack_size;
+}
+
+uint32_t osThreadGetStackSpace(osThreadId_t thread_id) {
+  os_ucos2_thread_t *thread = osUcos2ThreadFromId(thread_id);
+  if ((thread == NULL) || (thread->tcb == NULL) || osUcos2IrqContext()) {
+    return 0u;
+  }
+
+  /* Only the part still free at the last scan has to be inspected again. */
+  OSSchedLock();
+  thread->stack_free = osUcos2StackScan(thread, 0u, thread->stack_free);
+  uint32_t free_words = thread->stack_free;
+  OSSchedUnlock();
+
+  return free_words * (uint32_t)sizeof(OS_STK);
+}
+
+uint32_t osThreadGetStackWatermark(osThreadId_t thread_id) {
+  os_ucos2_thread_t *thread = osUcos2ThreadFromId(thread_id);
+  if (thread == NULL) {
+    return 0u;
+  }
+
+  return thread->stack_free * (uint32_t)sizeof(OS_STK);
+}
+
 osPriority_t osThreadGetPriority(osThreadId_t thread_id) {
   os_ucos2_thread_t *thread = osUcos2ThreadFromId(thread_id);
   if (thread == NULL) {
@@ -612,7 +931,7 @@ osPriority_t osThreadGetPriority(osThreadId_t thread_id) {
   return thread->cmsis_prio;
 }
 
-osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority) {
+static osStatus_t osUcos2ThreadSetPriority(osThreadId_t thread_id, osPriority_t priority) {
   os_ucos2_thread_t *thread = osUcos2ThreadFromId(thread_id);
   if (thread == NULL) {
     return osErrorParameter;
@@ -641,7 +960,14 @@ osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority) {
   return osOK;
 }
 
-osStatus_t osThreadYield(void) {
+osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority) {
+  UCOS2_TRACE_ENTER(osTraceApiThreadSetPriority, thread_id, priority);
+  osStatus_t status = osUcos2ThreadSetPriority(thread_id, priority);
+  UCOS2_TRACE_EXIT(osTraceApiThreadSetPriority, thread_id, status);
+  return status;
+}
+
+static osStatus_t osUcos2ThreadYield(void) {
   if (osUcos2IrqContext()) {
     return osErrorISR;
   }
@@ -655,7 +981,15 @@ osStatus_t osThreadYield(void) {
   return osOK;
 }
 
+osStatus_t osThreadYield(void) {
+  UCOS2_TRACE_ENTER(osTraceApiThreadYield, 0u, 0u);
+  osStatus_t status = osUcos2ThreadYield();
+  UCOS2_TRACE_EXIT(osTraceApiThreadYield, 0u, status);
+  return status;
+}
+
 __NO_RETURN void osThreadExit(void) {
+  UCOS2_TRACE_ENTER(osTraceApiThreadExit, 0u, 0u);
   if (osUcos2IrqContext()) {
     while (1) {
       /* no-op */
@@ -672,7 +1006,7 @@ __NO_RETURN void osThreadExit(void) {
   }
 }
 
-osStatus_t osThreadTerminate(osThreadId_t thread_id) {
+static osStatus_t osUcos2ThreadTerminate(osThreadId_t thread_id) {
   if (osUcos2IrqContext()) {
     return osErrorISR;
   }
@@ -695,7 +1029,14 @@ osStatus_t osThreadTerminate(osThreadId_t thread_id) {
   return osOK;
 }
 
-osStatus_t osThreadSuspend(osThreadId_t thread_id) {
+osStatus_t osThreadTerminate(osThreadId_t thread_id) {
+  UCOS2_TRACE_ENTER(osTraceApiThreadTerminate, thread_id, 0u);
+  osStatus_t status = osUcos2ThreadTerminate(thread_id);
+  UCOS2_TRACE_EXIT(osTraceApiThreadTerminate, thread_id, status);
+  return status;
+}
+
+static osStatus_t osUcos2ThreadSuspend(osThreadId_t thread_id) {
   if (osUcos2IrqContext()) {
     return osErrorISR;
   }
@@ -716,7 +1057,14 @@ osStatus_t osThreadSuspend(osThreadId_t thread_id) {
   return (err == OS_ERR_NONE) ? osOK : osErrorResource;
 }
 
-osStatus_t osThreadResume(osThreadId_t thread_id) {
+osStatus_t osThreadSuspend(osThreadId_t thread_id) {
+  UCOS2_TRACE_ENTER(osTraceApiThreadSuspend, thread_id, 0u);
+  osStatus_t status = osUcos2ThreadSuspend(thread_id);
+  UCOS2_TRACE_EXIT(osTraceApiThreadSuspend, thread_id, status);
+  return status;
+}
+
+static osStatus_t osUcos2ThreadResume(osThreadId_t thread_id) {
   if (osUcos2IrqContext()) {
     return osErrorISR;
   }
@@ -734,7 +1082,14 @@ osStatus_t osThreadResume(osThreadId_t thread_id) {
   return (err == OS_ERR_NONE) ? osOK : osErrorResource;
 }
 
-osStatus_t osThreadDetach(osThreadId_t thread_id) {
+osStatus_t osThreadResume(osThreadId_t thread_id) {
+  UCOS2_TRACE_ENTER(osTraceApiThreadResume, thread_id, 0u);
+  osStatus_t status = osUcos2ThreadResume(thread_id);
+  UCOS2_TRACE_EXIT(osTraceApiThreadResume, thread_id, status);
+  return status;
+}
+
+static osStatus_t osUcos2ThreadDetach(osThreadId_t thread_id) {
   if (osUcos2IrqContext()) {
     return osErrorISR;
   }
@@ -763,7 +1118,14 @@ osStatus_t osThreadDetach(osThreadId_t thread_id) {
   return osOK;
 }
 
-osStatus_t osThreadJoin(osThreadId_t thread_id) {
+osStatus_t osThreadDetach(osThreadId_t thread_id) {
+  UCOS2_TRACE_ENTER(osTraceApiThreadDetach, thread_id, 0u);
+  osStatus_t status = osUcos2ThreadDetach(thread_id);
+  UCOS2_TRACE_EXIT(osTraceApiThreadDetach, thread_id, status);
+  return status;
+}
+
+static osStatus_t osUcos2ThreadJoin(osThreadId_t thread_id) {
   if (osUcos2IrqContext()) {
     return osErrorISR;
   }
@@ -796,9 +1158,18 @@ osStatus_t osThreadJoin(osThreadId_t thread_id) {
   return osOK;
 }
 
+osStatus_t osThreadJoin(osThreadId_t thread_id) {
+  UCOS2_TRACE_ENTER(osTraceApiThreadJoin, thread_id, 0u);
+  UCOS2_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos2ThreadJoin(thread_id);
+  UCOS2_WAIT_END(wait_start, osWaitKindThreadJoin, thread_id, 1u);
+  UCOS2_TRACE_EXIT(osTraceApiThreadJoin, thread_id, status);
+  return status;
+}
+
 /* ==== Generic Wait ==== */
 
-osStatus_t osDelay(uint32_t ticks) {
+static osStatus_t osUcos2Delay(uint32_t ticks) {
   if (osUcos2IrqContext()) {
     return osErrorISR;
   }
@@ -816,7 +1187,16 @@ osStatus_t osDelay(uint32_t ticks) {
   return osOK;
 }
 
-osStatus_t osDelayUntil(uint32_t ticks) {
+osStatus_t osDelay(uint32_t ticks) {
+  UCOS2_TRACE_ENTER(osTraceApiDelay, 0u, ticks);
+  UCOS2_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos2Delay(ticks);
+  UCOS2_WAIT_END(wait_start, osWaitKindDelay, NULL, ticks);
+  UCOS2_TRACE_EXIT(osTraceApiDelay, 0u, status);
+  return status;
+}
+
+static osStatus_t osUcos2DelayUntil(uint32_t ticks) {
   if (osUcos2IrqContext()) {
     return osErrorISR;
   }
@@ -833,6 +1213,15 @@ osStatus_t osDelayUntil(uint32_t ticks) {
   return osDelay(ticks - now);
 }
 
+osStatus_t osDelayUntil(uint32_t ticks) {
+  UCOS2_TRACE_ENTER(osTraceApiDelayUntil, 0u, ticks);
+  UCOS2_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos2DelayUntil(ticks);
+  UCOS2_WAIT_END(wait_start, osWaitKindDelay, NULL, 1u);
+  UCOS2_TRACE_EXIT(osTraceApiDelayUntil, 0u, status);
+  return status;
+}
+
 /* ==== Thread Flags (Not Supported) ==== */
 
 uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags) {
@@ -877,7 +1266,7 @@ static osStatus_t osUcos2MutexError(INT8U err) {
   }
 }
 
-osMutexId_t osMutexNew(const osMutexAttr_t *attr) {
+static osMutexId_t osUcos2MutexNew(const osMutexAttr_t *attr) {
   if (osUcos2IrqContext()) {
     return NULL;
   }
@@ -905,12 +1294,20 @@ osMutexId_t osMutexNew(const osMutexAttr_t *attr) {
   return (osMutexId_t)mutex;
 }
 
+osMutexId_t osMutexNew(const osMutexAttr_t *attr) {
+  UCOS2_TRACE_ENTER(osTraceApiMutexNew, 0u, 0u);
+  osMutexId_t id = osUcos2MutexNew(attr);
+  UCOS2_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS2_TRACE_EXIT(osTraceApiMutexNew, id, 0u);
+  return id;
+}
+
 const char *osMutexGetName(osMutexId_t mutex_id) {
   os_ucos2_mutex_t *mutex = osUcos2MutexFromId(mutex_id);
   return (mutex != NULL) ? mutex->object.name : NULL;
 }
 
-osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
+static osStatus_t osUcos2MutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
   os_ucos2_mutex_t *mutex = osUcos2MutexFromId(mutex_id);
   if (mutex == NULL) {
     return osErrorParameter;
@@ -934,11 +1331,22 @@ osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
 
   INT32U pend_timeout = (timeout == osWaitForever) ? 0u : timeout;
   INT8U err;
+  UCOS2_INVERSION_BEGIN(mutex_id, &mutex->inversion, mutex->event, NULL);
   (void)OSMutexPend(mutex->event, pend_timeout, &err);
+  UCOS2_INVERSION_END(err);
   return osUcos2MutexError(err);
 }
 
-osStatus_t osMutexRelease(osMutexId_t mutex_id) {
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
+  UCOS2_TRACE_ENTER(osTraceApiMutexAcquire, mutex_id, timeout);
+  UCOS2_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos2MutexAcquire(mutex_id, timeout);
+  UCOS2_WAIT_END(wait_start, osWaitKindMutex, mutex_id, timeout);
+  UCOS2_TRACE_EXIT(osTraceApiMutexAcquire, mutex_id, status);
+  return status;
+}
+
+static osStatus_t osUcos2MutexRelease(osMutexId_t mutex_id) {
   os_ucos2_mutex_t *mutex = osUcos2MutexFromId(mutex_id);
   if (mutex == NULL) {
     return osErrorParameter;
@@ -948,10 +1356,18 @@ osStatus_t osMutexRelease(osMutexId_t mutex_id) {
     return osErrorISR;
   }
 
+  UCOS2_TRACE_WAKEUP(mutex_id, mutex->event);
   INT8U err = OSMutexPost(mutex->event);
   return osUcos2MutexError(err);
 }
 
+osStatus_t osMutexRelease(osMutexId_t mutex_id) {
+  UCOS2_TRACE_ENTER(osTraceApiMutexRelease, mutex_id, 0u);
+  osStatus_t status = osUcos2MutexRelease(mutex_id);
+  UCOS2_TRACE_EXIT(osTraceApiMutexRelease, mutex_id, status);
+  return status;
+}
+
 osThreadId_t osMutexGetOwner(osMutexId_t mutex_id) {
   os_ucos2_mutex_t *mutex = osUcos2MutexFromId(mutex_id);
   if ((mutex == NULL) || osUcos2IrqContext()) {
@@ -966,7 +1382,7 @@ osThreadId_t osMutexGetOwner(osMutexId_t mutex_id) {
   return (osThreadId_t)osUcos2ThreadFromTcb((OS_TCB *)event->OSEventPtr);
 }
 
-osStatus_t osMutexDelete(osMutexId_t mutex_id) {
+static osStatus_t osUcos2MutexDelete(osMutexId_t mutex_id) {
   os_ucos2_mutex_t *mutex = osUcos2MutexFromId(mutex_id);
   if (mutex == NULL) {
     return osErrorParameter;
@@ -982,6 +1398,13 @@ osStatus_t osMutexDelete(osMutexId_t mutex_id) {
   return osUcos2MutexError(err);
 }
 
+osStatus_t osMutexDelete(osMutexId_t mutex_id) {
+  UCOS2_TRACE_ENTER(osTraceApiMutexDelete, mutex_id, 0u);
+  osStatus_t status = osUcos2MutexDelete(mutex_id);
+  UCOS2_TRACE_EXIT(osTraceApiMutexDelete, mutex_id, status);
+  return status;
+}
+
 /* ==== Semaphore Management ==== */
 
 static osStatus_t osUcos2SemaphoreError(INT8U err) {
@@ -1001,9 +1424,9 @@ static osStatus_t osUcos2SemaphoreError(INT8U err) {
   }
 }
 
-osSemaphoreId_t osSemaphoreNew(uint32_t max_count,
-                               uint32_t initial_count,
-                               const osSemaphoreAttr_t *attr) {
+static osSemaphoreId_t osUcos2SemaphoreNew(uint32_t max_count,
+                                           uint32_t initial_count,
+                                           const osSemaphoreAttr_t *attr) {
   if (osUcos2IrqContext()) {
     return NULL;
   }
@@ -1030,12 +1453,22 @@ osSemaphoreId_t osSemaphoreNew(uint32_t max_count,
   return (osSemaphoreId_t)sem;
 }
 
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count,
+                               uint32_t initial_count,
+                               const osSemaphoreAttr_t *attr) {
+  UCOS2_TRACE_ENTER(osTraceApiSemaphoreNew, 0u, initial_count);
+  osSemaphoreId_t id = osUcos2SemaphoreNew(max_count, initial_count, attr);
+  UCOS2_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS2_TRACE_EXIT(osTraceApiSemaphoreNew, id, 0u);
+  return id;
+}
+
 const char *osSemaphoreGetName(osSemaphoreId_t semaphore_id) {
   os_ucos2_semaphore_t *sem = osUcos2SemaphoreFromId(semaphore_id);
   return (sem != NULL) ? sem->object.name : NULL;
 }
 
-osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
+static osStatus_t osUcos2SemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
   os_ucos2_semaphore_t *sem = osUcos2SemaphoreFromId(semaphore_id);
   if (sem == NULL) {
     return osErrorParameter;
@@ -1047,6 +1480,7 @@ osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
 
   if (timeout == 0u) {
     if (OSSemAccept(sem->event) > 0u) {
+      UCOS2_INVERSION_TAKE(sem, OS_ERR_NONE);
       return osOK;
     }
     return osErrorResource;
@@ -1054,20 +1488,44 @@ osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
 
   INT32U pend_timeout = (timeout == osWaitForever) ? 0u : timeout;
   INT8U err;
+  UCOS2_INVERSION_BEGIN(semaphore_id, &sem->inversion, NULL, &sem->holder);
   OSSemPend(sem->event, pend_timeout, &err);
+  UCOS2_INVERSION_END(err);
+  UCOS2_INVERSION_TAKE(sem, err);
   return osUcos2SemaphoreError(err);
 }
 
-osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id) {
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
+  UCOS2_TRACE_ENTER(osTraceApiSemaphoreAcquire, semaphore_id, timeout);
+  UCOS2_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos2SemaphoreAcquire(semaphore_id, timeout);
+  UCOS2_WAIT_END(wait_start, osWaitKindSemaphore, semaphore_id, timeout);
+  UCOS2_TRACE_EXIT(osTraceApiSemaphoreAcquire, semaphore_id, status);
+  return status;
+}
+
+static osStatus_t osUcos2SemaphoreRelease(osSemaphoreId_t semaphore_id) {
   os_ucos2_semaphore_t *sem = osUcos2SemaphoreFromId(semaphore_id);
   if (sem == NULL) {
     return osErrorParameter;
   }
 
+  UCOS2_TRACE_WAKEUP(semaphore_id, sem->event);
+  UCOS2_INVERSION_GIVE(sem);
   INT8U err = OSSemPost(sem->event);
+  if (err == OS_ERR_NONE) {
+    UCOS2_WAIT_ANY_NOTIFY(sem->wait_any, false);
+  }
   return osUcos2SemaphoreError(err);
 }
 
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id) {
+  UCOS2_TRACE_ENTER(osTraceApiSemaphoreRelease, semaphore_id, 0u);
+  osStatus_t status = osUcos2SemaphoreRelease(semaphore_id);
+  UCOS2_TRACE_EXIT(osTraceApiSemaphoreRelease, semaphore_id, status);
+  return status;
+}
+
 uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id) {
   os_ucos2_semaphore_t *sem = osUcos2SemaphoreFromId(semaphore_id);
   if (sem == NULL) {
@@ -1083,7 +1541,7 @@ uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id) {
   return (uint32_t)data.OSCnt;
 }
 
-osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id) {
+static osStatus_t osUcos2SemaphoreDelete(osSemaphoreId_t semaphore_id) {
   os_ucos2_semaphore_t *sem = osUcos2SemaphoreFromId(semaphore_id);
   if (sem == NULL) {
     return osErrorParameter;
@@ -1096,9 +1554,17 @@ osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id) {
   INT8U err;
   (void)OSSemDel(sem->event, OS_DEL_ALWAYS, &err);
   sem->event = NULL;
+  UCOS2_WAIT_ANY_NOTIFY(sem->wait_any, true);
   return osUcos2SemaphoreError(err);
 }
 
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id) {
+  UCOS2_TRACE_ENTER(osTraceApiSemaphoreDelete, semaphore_id, 0u);
+  osStatus_t status = osUcos2SemaphoreDelete(semaphore_id);
+  UCOS2_TRACE_EXIT(osTraceApiSemaphoreDelete, semaphore_id, status);
+  return status;
+}
+
 /* ==== Timer Management ==== */
 
 static void osUcos2TimerThunk(void *ptmr, void *parg) {
@@ -1128,10 +1594,10 @@ static osStatus_t osUcos2TimerDeleteInternal(os_ucos2_timer_t *timer) {
   return osOK;
 }
 
-osTimerId_t osTimerNew(osTimerFunc_t func,
-                       osTimerType_t type,
-                       void *argument,
-                       const osTimerAttr_t *attr) {
+static osTimerId_t osUcos2TimerNew(osTimerFunc_t func,
+                                   osTimerType_t type,
+                                   void *argument,
+                                   const osTimerAttr_t *attr) {
   if (osUcos2IrqContext()) {
     return NULL;
   }
@@ -1154,6 +1620,17 @@ osTimerId_t osTimerNew(osTimerFunc_t func,
   return (osTimerId_t)timer;
 }
 
+osTimerId_t osTimerNew(osTimerFunc_t func,
+                       osTimerType_t type,
+                       void *argument,
+                       const osTimerAttr_t *attr) {
+  UCOS2_TRACE_ENTER(osTraceApiTimerNew, 0u, type);
+  osTimerId_t id = osUcos2TimerNew(func, type, argument, attr);
+  UCOS2_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS2_TRACE_EXIT(osTraceApiTimerNew, id, 0u);
+  return id;
+}
+
 const char *osTimerGetName(osTimerId_t timer_id) {
   os_ucos2_timer_t *timer = osUcos2TimerFromId(timer_id);
   return (timer != NULL) ? timer->object.name : NULL;
@@ -1183,7 +1660,7 @@ static osStatus_t osUcos2TimerCreateInstance(os_ucos2_timer_t *timer, uint32_t t
   return osOK;
 }
 
-osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks) {
+static osStatus_t osUcos2TimerStart(osTimerId_t timer_id, uint32_t ticks) {
   os_ucos2_timer_t *timer = osUcos2TimerFromId(timer_id);
   if (timer == NULL) {
     return osErrorParameter;
@@ -1212,7 +1689,14 @@ osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks) {
   return osOK;
 }
 
-osStatus_t osTimerStop(osTimerId_t timer_id) {
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks) {
+  UCOS2_TRACE_ENTER(osTraceApiTimerStart, timer_id, ticks);
+  osStatus_t status = osUcos2TimerStart(timer_id, ticks);
+  UCOS2_TRACE_EXIT(osTraceApiTimerStart, timer_id, status);
+  return status;
+}
+
+static osStatus_t osUcos2TimerStop(osTimerId_t timer_id) {
   os_ucos2_timer_t *timer = osUcos2TimerFromId(timer_id);
   if ((timer == NULL) || (timer->ostmr == NULL)) {
     return osErrorResource;
@@ -1225,6 +1709,13 @@ osStatus_t osTimerStop(osTimerId_t timer_id) {
   return stat;
 }
 
+osStatus_t osTimerStop(osTimerId_t timer_id) {
+  UCOS2_TRACE_ENTER(osTraceApiTimerStop, timer_id, 0u);
+  osStatus_t status = osUcos2TimerStop(timer_id);
+  UCOS2_TRACE_EXIT(osTraceApiTimerStop, timer_id, status);
+  return status;
+}
+
 uint32_t osTimerIsRunning(osTimerId_t timer_id) {
   os_ucos2_timer_t *timer = osUcos2TimerFromId(timer_id);
   if ((timer == NULL) || (timer->ostmr == NULL) || osUcos2IrqContext()) {
@@ -1240,7 +1731,7 @@ uint32_t osTimerIsRunning(osTimerId_t timer_id) {
   return (state == OS_TMR_STATE_RUNNING) ? 1u : 0u;
 }
 
-osStatus_t osTimerDelete(osTimerId_t timer_id) {
+static osStatus_t osUcos2TimerDelete(osTimerId_t timer_id) {
   os_ucos2_timer_t *timer = osUcos2TimerFromId(timer_id);
   if (timer == NULL) {
     return osErrorParameter;
@@ -1253,9 +1744,16 @@ osStatus_t osTimerDelete(osTimerId_t timer_id) {
   return osUcos2TimerDeleteInternal(timer);
 }
 
+osStatus_t osTimerDelete(osTimerId_t timer_id) {
+  UCOS2_TRACE_ENTER(osTraceApiTimerDelete, timer_id, 0u);
+  osStatus_t status = osUcos2TimerDelete(timer_id);
+  UCOS2_TRACE_EXIT(osTraceApiTimerDelete, timer_id, status);
+  return status;
+}
+
 /* ==== Event Flags Management ==== */
 
-osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr) {
+static osEventFlagsId_t osUcos2EventFlagsNew(const osEventFlagsAttr_t *attr) {
   if (osUcos2IrqContext()) {
     return NULL;
   }
@@ -1280,23 +1778,42 @@ osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr) {
   return (osEventFlagsId_t)ef;
 }
 
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr) {
+  UCOS2_TRACE_ENTER(osTraceApiEventFlagsNew, 0u, 0u);
+  osEventFlagsId_t id = osUcos2EventFlagsNew(attr);
+  UCOS2_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS2_TRACE_EXIT(osTraceApiEventFlagsNew, id, 0u);
+  return id;
+}
+
 const char *osEventFlagsGetName(osEventFlagsId_t ef_id) {
   os_ucos2_event_flags_t *ef = osUcos2EventFlagsFromId(ef_id);
   return (ef != NULL) ? ef->object.name : NULL;
 }
 
-uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
+static uint32_t osUcos2EventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
   os_ucos2_event_flags_t *ef = osUcos2EventFlagsFromId(ef_id);
   if ((ef == NULL) || !osUcos2FlagsValid(flags)) {
     return osFlagsErrorParameter;
   }
 
   INT8U err;
+  UCOS2_TRACE_WAKEUP_FLAGS(ef_id, ef->grp);
   OS_FLAGS result = OSFlagPost(ef->grp, (OS_FLAGS)flags, OS_FLAG_SET, &err);
+  if (err == OS_ERR_NONE) {
+    UCOS2_WAIT_ANY_NOTIFY(ef->wait_any, false);
+  }
   return (err == OS_ERR_NONE) ? (uint32_t)result : osUcos2EventFlagsError(err);
 }
 
-uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
+  UCOS2_TRACE_ENTER(osTraceApiEventFlagsSet, ef_id, flags);
+  uint32_t result = osUcos2EventFlagsSet(ef_id, flags);
+  UCOS2_TRACE_EXIT(osTraceApiEventFlagsSet, ef_id, result);
+  return result;
+}
+
+static uint32_t osUcos2EventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
   os_ucos2_event_flags_t *ef = osUcos2EventFlagsFromId(ef_id);
   if ((ef == NULL) || !osUcos2FlagsValid(flags)) {
     return osFlagsErrorParameter;
@@ -1307,6 +1824,13 @@ uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
   return (err == OS_ERR_NONE) ? (uint32_t)result : osUcos2EventFlagsError(err);
 }
 
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
+  UCOS2_TRACE_ENTER(osTraceApiEventFlagsClear, ef_id, flags);
+  uint32_t result = osUcos2EventFlagsClear(ef_id, flags);
+  UCOS2_TRACE_EXIT(osTraceApiEventFlagsClear, ef_id, result);
+  return result;
+}
+
 uint32_t osEventFlagsGet(osEventFlagsId_t ef_id) {
   os_ucos2_event_flags_t *ef = osUcos2EventFlagsFromId(ef_id);
   if (ef == NULL) {
@@ -1318,10 +1842,10 @@ uint32_t osEventFlagsGet(osEventFlagsId_t ef_id) {
   return (err == OS_ERR_NONE) ? (uint32_t)flags : osUcos2EventFlagsError(err);
 }
 
-uint32_t osEventFlagsWait(osEventFlagsId_t ef_id,
-                          uint32_t flags,
-                          uint32_t options,
-                          uint32_t timeout) {
+static uint32_t osUcos2EventFlagsWait(osEventFlagsId_t ef_id,
+                                      uint32_t flags,
+                                      uint32_t options,
+                                      uint32_t timeout) {
   os_ucos2_event_flags_t *ef = osUcos2EventFlagsFromId(ef_id);
   if ((ef == NULL) || !osUcos2FlagsValid(flags) || !osUcos2FlagsOptionsValid(options)) {
     return osFlagsErrorParameter;
@@ -1345,7 +1869,19 @@ uint32_t osEventFlagsWait(osEventFlagsId_t ef_id,
   return (err == OS_ERR_NONE) ? (uint32_t)result : osUcos2EventFlagsError(err);
 }
 
-osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id,
+                          uint32_t flags,
+                          uint32_t options,
+                          uint32_t timeout) {
+  UCOS2_TRACE_ENTER(osTraceApiEventFlagsWait, ef_id, flags);
+  UCOS2_WAIT_BEGIN(wait_start);
+  uint32_t result = osUcos2EventFlagsWait(ef_id, flags, options, timeout);
+  UCOS2_WAIT_END(wait_start, osWaitKindEventFlags, ef_id, timeout);
+  UCOS2_TRACE_EXIT(osTraceApiEventFlagsWait, ef_id, result);
+  return result;
+}
+
+static osStatus_t osUcos2EventFlagsDelete(osEventFlagsId_t ef_id) {
   os_ucos2_event_flags_t *ef = osUcos2EventFlagsFromId(ef_id);
   if (ef == NULL) {
     return osErrorParameter;
@@ -1359,6 +1895,7 @@ osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
   (void)OSFlagDel(ef->grp, OS_DEL_ALWAYS, &err);
   if (err == OS_ERR_NONE) {
     ef->grp = NULL;
+    UCOS2_WAIT_ANY_NOTIFY(ef->wait_any, true);
     return osOK;
   }
 
@@ -1369,6 +1906,13 @@ osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
   return osErrorResource;
 }
 
+osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
+  UCOS2_TRACE_ENTER(osTraceApiEventFlagsDelete, ef_id, 0u);
+  osStatus_t status = osUcos2EventFlagsDelete(ef_id);
+  UCOS2_TRACE_EXIT(osTraceApiEventFlagsDelete, ef_id, status);
+  return status;
+}
+
 /* ==== Message Queue Management ==== */
 
 static osStatus_t osUcos2MessageQueueError(INT8U err) {
@@ -1388,9 +1932,9 @@ static osStatus_t osUcos2MessageQueueError(INT8U err) {
   }
 }
 
-osMessageQueueId_t osMessageQueueNew(uint32_t msg_count,
-                                     uint32_t msg_size,
-                                     const osMessageQueueAttr_t *attr) {
+static osMessageQueueId_t osUcos2MessageQueueNew(uint32_t msg_count,
+                                                 uint32_t msg_size,
+                                                 const osMessageQueueAttr_t *attr) {
   if (osUcos2IrqContext()) {
     return NULL;
   }
@@ -1429,15 +1973,25 @@ osMessageQueueId_t osMessageQueueNew(uint32_t msg_count,
   return (osMessageQueueId_t)mq;
 }
 
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count,
+                                     uint32_t msg_size,
+                                     const osMessageQueueAttr_t *attr) {
+  UCOS2_TRACE_ENTER(osTraceApiMessageQueueNew, 0u, msg_count);
+  osMessageQueueId_t id = osUcos2MessageQueueNew(msg_count, msg_size, attr);
+  UCOS2_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS2_TRACE_EXIT(osTraceApiMessageQueueNew, id, 0u);
+  return id;
+}
+
 const char *osMessageQueueGetName(osMessageQueueId_t mq_id) {
   os_ucos2_message_queue_t *mq = osUcos2MessageQueueFromId(mq_id);
   return (mq != NULL) ? mq->object.name : NULL;
 }
 
-osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id,
-                             const void *msg_ptr,
-                             uint8_t msg_prio,
-                             uint32_t timeout) {
+static osStatus_t osUcos2MessageQueuePut(osMessageQueueId_t mq_id,
+                                         const void *msg_ptr,
+                                         uint8_t msg_prio,
+                                         uint32_t timeout) {
   (void)msg_prio;
   os_ucos2_message_queue_t *mq = osUcos2MessageQueueFromId(mq_id);
   if ((mq == NULL) || (msg_ptr == NULL)) {
@@ -1455,12 +2009,14 @@ osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id,
       return osErrorResource;
     }
 
+    UCOS2_TRACE_WAKEUP(mq_id, mq->queue_event);
     INT8U err = OSQPost(mq->queue_event, message);
     if (err != OS_ERR_NONE) {
       (void)OSSemPost(mq->space_sem);
       return osUcos2MessageQueueError(err);
     }
 
+    UCOS2_WAIT_ANY_NOTIFY(mq->wait_any, false);
     return osOK;
   }
 
@@ -1472,19 +2028,33 @@ osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id,
     return osUcos2MessageQueueError(err);
   }
 
+  UCOS2_TRACE_WAKEUP(mq_id, mq->queue_event);
   err = OSQPost(mq->queue_event, message);
   if (err != OS_ERR_NONE) {
     (void)OSSemPost(mq->space_sem);
     return osUcos2MessageQueueError(err);
   }
 
+  UCOS2_WAIT_ANY_NOTIFY(mq->wait_any, false);
   return osOK;
 }
 
-osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id,
-                             void *msg_ptr,
-                             uint8_t *msg_prio,
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id,
+                             const void *msg_ptr,
+                             uint8_t msg_prio,
                              uint32_t timeout) {
+  UCOS2_TRACE_ENTER(osTraceApiMessageQueuePut, mq_id, timeout);
+  UCOS2_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos2MessageQueuePut(mq_id, msg_ptr, msg_prio, timeout);
+  UCOS2_WAIT_END(wait_start, osWaitKindMessageQueue, mq_id, timeout);
+  UCOS2_TRACE_EXIT(osTraceApiMessageQueuePut, mq_id, status);
+  return status;
+}
+
+static osStatus_t osUcos2MessageQueueGet(osMessageQueueId_t mq_id,
+                                         void *msg_ptr,
+                                         uint8_t *msg_prio,
+                                         uint32_t timeout) {
   (void)msg_prio;
   os_ucos2_message_queue_t *mq = osUcos2MessageQueueFromId(mq_id);
   if ((mq == NULL) || (msg_ptr == NULL)) {
@@ -1502,6 +2072,7 @@ osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id,
     if (err != OS_ERR_NONE) {
       return osUcos2MessageQueueError(err);
     }
+    UCOS2_TRACE_WAKEUP(mq_id, mq->space_sem);
     err = OSSemPost(mq->space_sem);
     if (err != OS_ERR_NONE) {
       return osUcos2SemaphoreError(err);
@@ -1517,6 +2088,7 @@ osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id,
     return osUcos2MessageQueueError(err);
   }
 
+  UCOS2_TRACE_WAKEUP(mq_id, mq->space_sem);
   err = OSSemPost(mq->space_sem);
   if (err != OS_ERR_NONE) {
     return osUcos2SemaphoreError(err);
@@ -1526,6 +2098,18 @@ osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id,
   return osOK;
 }
 
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id,
+                             void *msg_ptr,
+                             uint8_t *msg_prio,
+                             uint32_t timeout) {
+  UCOS2_TRACE_ENTER(osTraceApiMessageQueueGet, mq_id, timeout);
+  UCOS2_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos2MessageQueueGet(mq_id, msg_ptr, msg_prio, timeout);
+  UCOS2_WAIT_END(wait_start, osWaitKindMessageQueue, mq_id, timeout);
+  UCOS2_TRACE_EXIT(osTraceApiMessageQueueGet, mq_id, status);
+  return status;
+}
+
 uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id) {
   os_ucos2_message_queue_t *mq = osUcos2MessageQueueFromId(mq_id);
   return (mq != NULL) ? mq->msg_count : 0u;
@@ -1566,7 +2150,7 @@ uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id) {
   return (uint32_t)data.OSCnt;
 }
 
-osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id) {
+static osStatus_t osUcos2MessageQueueReset(osMessageQueueId_t mq_id) {
   os_ucos2_message_queue_t *mq = osUcos2MessageQueueFromId(mq_id);
   if (mq == NULL) {
     return osErrorParameter;
@@ -1582,7 +2166,14 @@ osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id) {
   return (err == OS_ERR_NONE) ? osOK : osErrorResource;
 }
 
-osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id) {
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id) {
+  UCOS2_TRACE_ENTER(osTraceApiMessageQueueReset, mq_id, 0u);
+  osStatus_t status = osUcos2MessageQueueReset(mq_id);
+  UCOS2_TRACE_EXIT(osTraceApiMessageQueueReset, mq_id, status);
+  return status;
+}
+
+static osStatus_t osUcos2MessageQueueDelete(osMessageQueueId_t mq_id) {
   os_ucos2_message_queue_t *mq = osUcos2MessageQueueFromId(mq_id);
   if (mq == NULL) {
     return osErrorParameter;
@@ -1598,8 +2189,3247 @@ osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id) {
     return osUcos2MessageQueueError(err);
   }
   mq->queue_event = NULL;
+  UCOS2_WAIT_ANY_NOTIFY(mq->wait_any, true);
 
   (void)OSSemDel(mq->space_sem, OS_DEL_ALWAYS, &err);
   mq->space_sem = NULL;
   return osUcos2MessageQueueError(err);
 }
+
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id) {
+  UCOS2_TRACE_ENTER(osTraceApiMessageQueueDelete, mq_id, 0u);
+  osStatus_t status = osUcos2MessageQueueDelete(mq_id);
+  UCOS2_TRACE_EXIT(osTraceApiMessageQueueDelete, mq_id, status);
+  return status;
+}
+
+/* ==== Memory Pool Management ==== */
+
+#define UCOS2_POOL_NIL                 0xFFFFu
+#define UCOS2_POOL_BUSY                0xFFFEu   /* free_stack entry of an allocated block */
+
+os_ucos2_memory_pool_t *osUcos2MemoryPoolFromId(osMemoryPoolId_t mp_id) {
+  if (mp_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos2_memory_pool_t *mp = (os_ucos2_memory_pool_t *)mp_id;
+  return (mp->object.type == osUcos2ObjectMemoryPool) ? mp : NULL;
+}
+
+#if (UCOS2_LOCKFREE_EN > 0u)
+/* Treiber stack: the tag in the upper half of free_top changes on every
+ * update, so a pop that read a stale next index fails its compare-and-swap
+ * instead of corrupting the list (ABA). */
+static uint32_t osUcos2PoolPop(os_ucos2_memory_pool_t *mp) {
+  uint32_t head = *(volatile uint32_t *)&mp->free_top;
+  uint32_t index;
+  do {
+    index = head & 0xFFFFu;
+    if (index == UCOS2_POOL_NIL) {
+      return UCOS2_POOL_NIL;
+    }
+    uint32_t next = ((volatile uint16_t *)mp->free_stack)[index];
+    uint32_t desired = ((head + 0x10000u) & 0xFFFF0000u) | next;
+    if (UCOS2_ATOMIC_CAS(&mp->free_top, &head, desired)) {
+      break;
+    }
+  } while (true);
+  ((volatile uint16_t *)mp->free_stack)[index] = UCOS2_POOL_BUSY;
+  (void)UCOS2_ATOMIC_ADD(&mp->used, 1u);
+  return index;
+}
+
+/* Refuses a block that is not marked allocated, or any block once used has
+ * dropped to zero, so a double free cannot link an index twice. used is
+ * claimed before the push; two contexts freeing the same block at the same
+ * time can still both pass the mark check. */
+static bool osUcos2PoolPush(os_ucos2_memory_pool_t *mp, uint32_t index) {
+  volatile uint16_t *entry = &((volatile uint16_t *)mp->free_stack)[index];
+  uint32_t used = *(volatile uint32_t *)&mp->used;
+  do {
+    if ((used == 0u) || (*entry != UCOS2_POOL_BUSY)) {
+      return false;
+    }
+  } while (!UCOS2_ATOMIC_CAS(&mp->used, &used, used - 1u));
+
+  uint32_t head = *(volatile uint32_t *)&mp->free_top;
+  do {
+    *entry = (uint16_t)(head & 0xFFFFu);
+  } while (!UCOS2_ATOMIC_CAS(&mp->free_top, &head, ((head + 0x10000u) & 0xFFFF0000u) | index));
+  return true;
+}
+
+/* A read-modify-write, so the check is ordered after the push before it. */
+static uint32_t osUcos2PoolWaiters(os_ucos2_memory_pool_t *mp, uint32_t delta) {
+  return UCOS2_ATOMIC_ADD(&mp->waiters, delta) + delta;
+}
+#else
+static uint32_t osUcos2PoolPop(os_ucos2_memory_pool_t *mp) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  uint32_t index = mp->free_top & 0xFFFFu;
+  if (index != UCOS2_POOL_NIL) {
+    mp->free_top = mp->free_stack[index];
+    mp->free_stack[index] = UCOS2_POOL_BUSY;
+    mp->used++;
+  }
+  OS_EXIT_CRITICAL();
+  return index;
+}
+
+/* Refuses a block that is not marked allocated (double free). */
+static bool osUcos2PoolPush(os_ucos2_memory_pool_t *mp, uint32_t index) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  bool busy = (mp->used != 0u) && (mp->free_stack[index] == UCOS2_POOL_BUSY);
+  if (busy) {
+    mp->free_stack[index] = (uint16_t)mp->free_top;
+    mp->free_top = index;
+    mp->used--;
+  }
+  OS_EXIT_CRITICAL();
+  return busy;
+}
+
+static uint32_t osUcos2PoolWaiters(os_ucos2_memory_pool_t *mp, uint32_t delta) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  mp->waiters += delta;
+  uint32_t waiters = mp->waiters;
+  OS_EXIT_CRITICAL();
+  return waiters;
+}
+#endif
+
+static osMemoryPoolId_t osUcos2MemoryPoolNew(uint32_t block_count,
+                                             uint32_t block_size,
+                                             const osMemoryPoolAttr_t *attr) {
+  if (osUcos2IrqContext()) {
+    return NULL;
+  }
+
+  if ((block_count == 0u) ||
+      (block_count >= UCOS2_POOL_BUSY) ||
+      (block_size == 0u) ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos2_memory_pool_t))) {
+    return NULL;
+  }
+
+  /* Like message queues, pools are fully static: blocks live in mp_mem and
+   * the free list in the cb_size bytes after the control block. */
+  const uint32_t stride = (block_size + (uint32_t)sizeof(void *) - 1u) & ~((uint32_t)sizeof(void *) - 1u);
+  if ((attr->mp_mem == NULL) ||
+      (((uintptr_t)attr->mp_mem & (sizeof(void *) - 1u)) != 0u) ||
+      (attr->mp_size < (block_count * stride))) {
+    return NULL;
+  }
+
+  os_ucos2_memory_pool_t *mp = (os_ucos2_memory_pool_t *)attr->cb_mem;
+  uint8_t *cb_base = (uint8_t *)mp;
+  uint8_t *stack_aligned = cb_base + ((sizeof(*mp) + sizeof(uint16_t) - 1u) & ~(sizeof(uint16_t) - 1u));
+  size_t used = (size_t)(stack_aligned - cb_base);
+  if ((attr->cb_size < used) || (((attr->cb_size - used) / sizeof(uint16_t)) < block_count)) {
+    return NULL;
+  }
+
+  memset(mp, 0, sizeof(*mp));
+  osUcos2ObjectInit(&mp->object, osUcos2ObjectMemoryPool, attr->name, attr->attr_bits);
+  mp->pool_mem = (uint8_t *)attr->mp_mem;
+  mp->free_stack = (uint16_t *)stack_aligned;
+  mp->block_size = stride;
+  mp->block_count = block_count;
+  for (uint32_t i = 0u; i < block_count; ++i) {
+    mp->free_stack[i] = (uint16_t)(((i + 1u) < block_count) ? (i + 1u) : UCOS2_POOL_NIL);
+  }
+  mp->free_top = 0u;
+
+  mp->wait_sem = OSSemCreate(0u);
+  if (mp->wait_sem == NULL) {
+    return NULL;
+  }
+  return (osMemoryPoolId_t)mp;
+}
+
+osMemoryPoolId_t osMemoryPoolNew(uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t *attr) {
+  UCOS2_TRACE_ENTER(osTraceApiMemoryPoolNew, 0u, block_count);
+  osMemoryPoolId_t id = osUcos2MemoryPoolNew(block_count, block_size, attr);
+  UCOS2_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS2_TRACE_EXIT(osTraceApiMemoryPoolNew, id, 0u);
+  return id;
+}
+
+const char *osMemoryPoolGetName(osMemoryPoolId_t mp_id) {
+  os_ucos2_memory_pool_t *mp = osUcos2MemoryPoolFromId(mp_id);
+  return (mp != NULL) ? mp->object.name : NULL;
+}
+
+static void *osUcos2MemoryPoolTake(os_ucos2_memory_pool_t *mp) {
+  uint32_t index = osUcos2PoolPop(mp);
+  return (index != UCOS2_POOL_NIL) ? (void *)(mp->pool_mem + (index * mp->block_size)) : NULL;
+}
+
+/* Register as a waiter before the last attempt: a free either sees the
+ * registration and posts wait_sem, or pushes before the attempt and the
+ * attempt finds the block. Stale posts only cause another attempt. */
+static void *osUcos2MemoryPoolWait(os_ucos2_memory_pool_t *mp, uint32_t timeout) {
+  const uint32_t start = osKernelGetTickCount();
+  for (;;) {
+    INT32U pend_timeout = 0u;
+    if (timeout != osWaitForever) {
+      uint32_t elapsed = osKernelGetTickCount() - start;
+      if (elapsed >= timeout) {
+        return NULL;
+      }
+      pend_timeout = (INT32U)(timeout - elapsed);
+    }
+
+    (void)osUcos2PoolWaiters(mp, 1u);
+    void *block = osUcos2MemoryPoolTake(mp);
+    INT8U err = OS_ERR_NONE;
+    if (block == NULL) {
+      OSSemPend(mp->wait_sem, pend_timeout, &err);
+    }
+    (void)osUcos2PoolWaiters(mp, (uint32_t)-1);
+    if (block != NULL) {
+      return block;
+    }
+    if (err != OS_ERR_NONE) {
+      return (err == OS_ERR_TIMEOUT) ? osUcos2MemoryPoolTake(mp) : NULL;
+    }
+  }
+}
+
+static void *osUcos2MemoryPoolAlloc(osMemoryPoolId_t mp_id, uint32_t timeout) {
+  os_ucos2_memory_pool_t *mp = osUcos2MemoryPoolFromId(mp_id);
+  if ((mp == NULL) || (mp->wait_sem == NULL) || osUcos2IsrDisallowsWait(timeout)) {
+    return NULL;
+  }
+
+  void *block = osUcos2MemoryPoolTake(mp);
+  if ((block != NULL) || (timeout == 0u)) {
+    return block;
+  }
+  return osUcos2MemoryPoolWait(mp, timeout);
+}
+
+void *osMemoryPoolAlloc(osMemoryPoolId_t mp_id, uint32_t timeout) {
+  UCOS2_TRACE_ENTER(osTraceApiMemoryPoolAlloc, mp_id, timeout);
+  UCOS2_WAIT_BEGIN(wait_start);
+  void *block = osUcos2MemoryPoolAlloc(mp_id, timeout);
+  UCOS2_WAIT_END(wait_start, osWaitKindMemoryPool, mp_id, timeout);
+  UCOS2_TRACE_EXIT(osTraceApiMemoryPoolAlloc, mp_id, UCOS2_TRACE_ID(block));
+  return block;
+}
+
+static osStatus_t osUcos2MemoryPoolFree(osMemoryPoolId_t mp_id, void *block) {
+  os_ucos2_memory_pool_t *mp = osUcos2MemoryPoolFromId(mp_id);
+  if ((mp == NULL) || (mp->wait_sem == NULL) || (block == NULL)) {
+    return osErrorParameter;
+  }
+
+  uintptr_t offset = (uintptr_t)block - (uintptr_t)mp->pool_mem;
+  if (((uintptr_t)block < (uintptr_t)mp->pool_mem) ||
+      (offset >= ((uintptr_t)mp->block_count * mp->block_size)) ||
+      ((offset % mp->block_size) != 0u)) {
+    return osErrorParameter;
+  }
+
+  if (!osUcos2PoolPush(mp, (uint32_t)(offset / mp->block_size))) {
+    return osErrorResource;
+  }
+  if (osUcos2PoolWaiters(mp, 0u) != 0u) {
+    (void)OSSemPost(mp->wait_sem);
+  }
+  return osOK;
+}
+
+osStatus_t osMemoryPoolFree(osMemoryPoolId_t mp_id, void *block) {
+  UCOS2_TRACE_ENTER(osTraceApiMemoryPoolFree, mp_id, UCOS2_TRACE_ID(block));
+  osStatus_t status = osUcos2MemoryPoolFree(mp_id, block);
+  UCOS2_TRACE_EXIT(osTraceApiMemoryPoolFree, mp_id, status);
+  return status;
+}
+
+uint32_t osMemoryPoolGetCapacity(osMemoryPoolId_t mp_id) {
+  os_ucos2_memory_pool_t *mp = osUcos2MemoryPoolFromId(mp_id);
+  return ((mp != NULL) && (mp->wait_sem != NULL)) ? mp->block_count : 0u;
+}
+
+uint32_t osMemoryPoolGetBlockSize(osMemoryPoolId_t mp_id) {
+  os_ucos2_memory_pool_t *mp = osUcos2MemoryPoolFromId(mp_id);
+  return ((mp != NULL) && (mp->wait_sem != NULL)) ? mp->block_size : 0u;
+}
+
+static uint32_t osUcos2MemoryPoolGetCount(osMemoryPoolId_t mp_id) {
+  os_ucos2_memory_pool_t *mp = osUcos2MemoryPoolFromId(mp_id);
+  if ((mp == NULL) || (mp->wait_sem == NULL)) {
+    return 0u;
+  }
+  uint32_t used = *(volatile uint32_t *)&mp->used;
+  return (used <= mp->block_count) ? used : mp->block_count;
+}
+
+uint32_t osMemoryPoolGetCount(osMemoryPoolId_t mp_id) {
+  UCOS2_TRACE_ENTER(osTraceApiMemoryPoolGetCount, mp_id, 0u);
+  uint32_t count = osUcos2MemoryPoolGetCount(mp_id);
+  UCOS2_TRACE_EXIT(osTraceApiMemoryPoolGetCount, mp_id, count);
+  return count;
+}
+
+uint32_t osMemoryPoolGetSpace(osMemoryPoolId_t mp_id) {
+  os_ucos2_memory_pool_t *mp = osUcos2MemoryPoolFromId(mp_id);
+  if ((mp == NULL) || (mp->wait_sem == NULL)) {
+    return 0u;
+  }
+  return mp->block_count - osUcos2MemoryPoolGetCount(mp_id);
+}
+
+static osStatus_t osUcos2MemoryPoolDelete(osMemoryPoolId_t mp_id) {
+  os_ucos2_memory_pool_t *mp = osUcos2MemoryPoolFromId(mp_id);
+  if ((mp == NULL) || (mp->wait_sem == NULL)) {
+    return osErrorParameter;
+  }
+
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+  INT8U err;
+  OS_EVENT *wait_sem = mp->wait_sem;
+  mp->wait_sem = NULL;
+  (void)OSSemDel(wait_sem, OS_DEL_ALWAYS, &err);
+  return (err == OS_ERR_NONE) ? osOK : osError;
+}
+
+osStatus_t osMemoryPoolDelete(osMemoryPoolId_t mp_id) {
+  UCOS2_TRACE_ENTER(osTraceApiMemoryPoolDelete, mp_id, 0u);
+  osStatus_t status = osUcos2MemoryPoolDelete(mp_id);
+  UCOS2_TRACE_EXIT(osTraceApiMemoryPoolDelete, mp_id, status);
+  return status;
+}
+
+/* ==== CPU Usage ==== */
+
+#if (UCOS2_CPU_USAGE_EN > 0u)
+static os_ucos2_cpu_usage_t *osUcos2CpuUsageOf(const OS_TCB *ptcb) {
+  if (ptcb == OSTCBPrioTbl[OS_TASK_IDLE_PRIO]) {
+    return &os_ucos2_kernel.cpu_idle;
+  }
+
+  os_ucos2_thread_t *thread = osUcos2ThreadFromExt(ptcb);
+  return (thread != NULL) ? &thread->cpu : &os_ucos2_kernel.cpu_kernel;
+}
+
+static void osUcos2CpuCharge(os_ucos2_cpu_usage_t *cpu, uint32_t cycles) {
+  uint32_t epoch = os_ucos2_kernel.cpu_epoch;
+  uint32_t slot = epoch % UCOS2_CPU_USAGE_RING;
+
+  /* Slots are reset lazily: a stale epoch tag means the slot belongs to an
+   * older window and is reused for the current one. */
+  if (cpu->slot_epoch[slot] != epoch) {
+    cpu->slot_epoch[slot] = epoch;
+    cpu->slot_cycles[slot] = 0u;
+  }
+  cpu->slot_cycles[slot] += cycles;
+  cpu->cycles += cycles;
+}
+
+/* Sum of the UCOS2_CPU_USAGE_SLOTS slots completed before epoch; cpu NULL
+ * sums the slot lengths. Caller holds the critical section. */
+static uint64_t osUcos2CpuWindow(const os_ucos2_cpu_usage_t *cpu, uint32_t epoch) {
+  uint64_t total = 0u;
+  for (uint32_t back = 1u; back <= UCOS2_CPU_USAGE_SLOTS; ++back) {
+    uint32_t past = epoch - back;
+    if (past == 0u) {
+      break;
+    }
+    uint32_t slot = past % UCOS2_CPU_USAGE_RING;
+    if (cpu == NULL) {
+      total += os_ucos2_kernel.cpu_slot_len[slot];
+    } else if (cpu->slot_epoch[slot] == past) {
+      total += cpu->slot_cycles[slot];
+    }
+  }
+  return total;
+}
+
+static uint32_t osUcos2CpuLoad(uint64_t busy, uint64_t window) {
+  if (window == 0u) {
+    return 0u;
+  }
+  uint64_t load = (busy * osCpuUsageScale) / window;
+  return (load > osCpuUsageScale) ? osCpuUsageScale : (uint32_t)load;
+}
+
+/* Raw counters of one thread (or the idle/kernel account), copied in a
+ * critical section of their own; busy is its share of the window ending at
+ * epoch. The division is left to the caller, with interrupts enabled. */
+typedef struct os_ucos2_cpu_sample {
+  uint64_t cycles;
+  uint64_t busy;
+  uint32_t switches;
+} os_ucos2_cpu_sample_t;
+
+static void osUcos2CpuSample(const OS_TCB *ptcb,
+                            const os_ucos2_cpu_usage_t *cpu,
+                            uint32_t epoch,
+                            os_ucos2_cpu_sample_t *sample) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  sample->cycles = cpu->cycles;
+  if ((ptcb != NULL) && (ptcb == OSTCBCur) && osUcos2SchedulerStarted()) {
+    sample->cycles += (uint32_t)(UCOS2_TS_GET() - os_ucos2_kernel.cpu_last_ts);
+  }
+  sample->switches = cpu->switches;
+  sample->busy = osUcos2CpuWindow(cpu, epoch);
+  OS_EXIT_CRITICAL();
+}
+
+static void osUcos2CpuUsageFrom(const os_ucos2_cpu_sample_t *sample, uint64_t window, osThreadCpuUsage_t *usage) {
+  usage->cycles = sample->cycles;
+  usage->switches = sample->switches;
+  usage->usage = osUcos2CpuLoad(sample->busy, window);
+}
+
+/* Epoch of the slot being filled and the length of the window before it. */
+static uint32_t osUcos2CpuEpoch(uint64_t *window) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  uint32_t epoch = os_ucos2_kernel.cpu_epoch;
+  *window = osUcos2CpuWindow(NULL, epoch);
+  OS_EXIT_CRITICAL();
+  return epoch;
+}
+#endif
+
+void osUcos2TaskSwHook(void) {
+#if (UCOS2_CPU_USAGE_EN > 0u)
+  /* Called from OSTaskSwHook() with interrupts disabled: OSTCBCur is the
+   * outgoing task, OSTCBHighRdy the incoming one. */
+  uint32_t now = UCOS2_TS_GET();
+  osUcos2CpuCharge(osUcos2CpuUsageOf(OSTCBCur), now - os_ucos2_kernel.cpu_last_ts);
+  os_ucos2_kernel.cpu_last_ts = now;
+  osUcos2CpuUsageOf(OSTCBHighRdy)->switches++;
+#endif
+#if (UCOS2_TRACE_EN > 0u)
+  osUcos2TraceSwitch(OSTCBCur, OSTCBHighRdy);
+#endif
+}
+
+void osUcos2TimeTickHook(void) {
+#if (UCOS2_CPU_USAGE_EN > 0u)
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  if (++os_ucos2_kernel.cpu_slot_tick >= (UCOS2_CPU_USAGE_WINDOW_TICKS / UCOS2_CPU_USAGE_SLOTS)) {
+    uint32_t now = UCOS2_TS_GET();
+    uint32_t slot = os_ucos2_kernel.cpu_epoch % UCOS2_CPU_USAGE_RING;
+
+    osUcos2CpuCharge(osUcos2CpuUsageOf(OSTCBCur), now - os_ucos2_kernel.cpu_last_ts);
+    os_ucos2_kernel.cpu_last_ts = now;
+    os_ucos2_kernel.cpu_slot_len[slot] = now - os_ucos2_kernel.cpu_slot_ts;
+    os_ucos2_kernel.cpu_slot_ts = now;
+    os_ucos2_kernel.cpu_slot_tick = 0u;
+    os_ucos2_kernel.cpu_epoch++;
+  }
+  OS_EXIT_CRITICAL();
+#endif
+#if (UCOS2_TRACE_EN > 0u)
+  osUcos2TraceEmit(osTraceEventTick, 0u, (uint32_t)OSTime);
+#endif
+#if (UCOS2_PROFILER_EN > 0u)
+  osUcos2ProfilerSample();
+#endif
+#if (UCOS2_ACTIVE_EN > 0u)
+  osUcos2TimeEventTick();
+#endif
+}
+
+osStatus_t osThreadGetCpuUsage(osThreadId_t thread_id, osThreadCpuUsage_t *usage) {
+#if (UCOS2_CPU_USAGE_EN > 0u)
+  os_ucos2_thread_t *thread = osUcos2ThreadFromId(thread_id);
+  if ((thread == NULL) || (usage == NULL)) {
+    return osErrorParameter;
+  }
+
+  uint64_t window;
+  uint32_t epoch = osUcos2CpuEpoch(&window);
+  os_ucos2_cpu_sample_t sample;
+  osUcos2CpuSample(thread->tcb, &thread->cpu, epoch, &sample);
+  osUcos2CpuUsageFrom(&sample, window, usage);
+  return osOK;
+#else
+  (void)thread_id;
+  (void)usage;
+  return osError;
+#endif
+}
+
+uint32_t osKernelGetCpuUsage(osThreadCpuUsageInfo_t *info, uint32_t max_count, osCpuUsageSummary_t *summary) {
+#if (UCOS2_CPU_USAGE_EN > 0u)
+  if ((info == NULL) && (max_count != 0u)) {
+    return 0u;
+  }
+
+  /* The scheduler lock keeps the thread list still while interrupts stay
+   * enabled; each thread's counters are copied in a short critical section.
+   * Loads are over the window before the epoch read here, even if a slot
+   * completes during the walk. */
+  uint32_t count = 0u;
+  int32_t lock = osUcos2KernelLock();
+  uint64_t window;
+  uint32_t epoch = osUcos2CpuEpoch(&window);
+  os_ucos2_object_t *cursor = os_ucos2_kernel.threads.head;
+  while ((cursor != NULL) && (count < max_count)) {
+    os_ucos2_thread_t *thread = (os_ucos2_thread_t *)cursor;
+    os_ucos2_cpu_sample_t sample;
+    osUcos2CpuSample(thread->tcb, &thread->cpu, epoch, &sample);
+    info[count].thread_id = (osThreadId_t)thread;
+    info[count].name = thread->object.name;
+    osUcos2CpuUsageFrom(&sample, window, &info[count].usage);
+    count++;
+    cursor = cursor->next;
+  }
+  if (lock >= 0) {
+    (void)osUcos2KernelRestoreLock(lock);
+  }
+  if (summary != NULL) {
+    os_ucos2_cpu_sample_t idle;
+    os_ucos2_cpu_sample_t kernel;
+    osUcos2CpuSample(NULL, &os_ucos2_kernel.cpu_idle, epoch, &idle);
+    osUcos2CpuSample(NULL, &os_ucos2_kernel.cpu_kernel, epoch, &kernel);
+    summary->window_cycles = window;
+    summary->idle_usage = osUcos2CpuLoad(idle.busy, window);
+    summary->kernel_usage = osUcos2CpuLoad(kernel.busy, window);
+  }
+  return count;
+#else
+  (void)info;
+  (void)max_count;
+  (void)summary;
+  return 0u;
+#endif
+}
+
+/* ==== Stack Profiler ==== */
+
+#if (UCOS2_STACK_PROFILER_EN > 0u)
+static os_ucos2_thread_t os_ucos2_stk_prof_cb;
+static OS_STK os_ucos2_stk_prof_stack[(UCOS2_STACK_PROFILER_STACK + sizeof(OS_STK) - 1u) / sizeof(OS_STK)];
+
+/* Inspect at most one chunk of the current thread, then move to the next. */
+static void osUcos2StackProfilerStep(void) {
+  os_ucos2_thread_t *thread = os_ucos2_kernel.stk_prof_cursor;
+  if (thread == NULL) {
+    thread = (os_ucos2_thread_t *)os_ucos2_kernel.threads.head;
+    os_ucos2_kernel.stk_prof_cursor = thread;
+    os_ucos2_kernel.stk_prof_pos = 0u;
+    if (thread == NULL) {
+      return;
+    }
+  }
+
+  uint32_t pos = os_ucos2_kernel.stk_prof_pos;
+  uint32_t limit = pos + UCOS2_STACK_PROFILER_CHUNK_WORDS;
+  if (limit > thread->stack_free) {
+    limit = thread->stack_free;
+  }
+
+  uint32_t used = osUcos2StackScan(thread, pos, limit);
+  if ((used < limit) || (limit == thread->stack_free)) {
+    thread->stack_free = used;
+    os_ucos2_kernel.stk_prof_cursor = (os_ucos2_thread_t *)thread->object.next;
+    os_ucos2_kernel.stk_prof_pos = 0u;
+  } else {
+    os_ucos2_kernel.stk_prof_pos = limit;
+  }
+}
+
+static void osUcos2StackProfilerThread(void *argument) {
+  (void)argument;
+
+  for (;;) {
+    OSSchedLock();
+    osUcos2StackProfilerStep();
+    OSSchedUnlock();
+    OSTimeDly(UCOS2_STACK_PROFILER_PERIOD_TICKS);
+  }
+}
+
+static osStatus_t osUcos2StackProfilerStart(void) {
+  const osThreadAttr_t attr = {
+    .name       = "cmsis.stkprof",
+    .cb_mem     = &os_ucos2_stk_prof_cb,
+    .cb_size    = sizeof(os_ucos2_stk_prof_cb),
+    .stack_mem  = os_ucos2_stk_prof_stack,
+    .stack_size = sizeof(os_ucos2_stk_prof_stack),
+    .priority   = UCOS2_STACK_PROFILER_PRIORITY,
+  };
+
+  return (osThreadNew(osUcos2StackProfilerThread, NULL, &attr) != NULL) ? osOK : osError;
+}
+#endif
+
+/* ==== Thread Local Storage ==== */
+
+uint32_t osThreadTlsAlloc(void) {
+#if (UCOS2_TLS_SLOTS > 0u)
+  if (osUcos2IrqContext()) {
+    return osThreadTlsInvalid;
+  }
+
+  uint32_t slot = osThreadTlsInvalid;
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  if (os_ucos2_kernel.tls_next < UCOS2_TLS_SLOTS) {
+    slot = os_ucos2_kernel.tls_next++;
+  }
+  OS_EXIT_CRITICAL();
+  return slot;
+#else
+  return osThreadTlsInvalid;
+#endif
+}
+
+/* Slot access resolves the running thread through OSTCBExtPtr: no list walk,
+ * no critical section. Tasks that are not CMSIS threads have no slots. */
+void *osThreadTlsGet(uint32_t slot) {
+#if (UCOS2_TLS_SLOTS > 0u)
+  if ((slot >= UCOS2_TLS_SLOTS) || osUcos2IrqContext() || (OSTCBCur == NULL)) {
+    return NULL;
+  }
+
+  os_ucos2_thread_t *thread = osUcos2ThreadFromExt(OSTCBCur);
+  return (thread != NULL) ? thread->tls[slot] : NULL;
+#else
+  (void)slot;
+  return NULL;
+#endif
+}
+
+osStatus_t osThreadTlsSet(uint32_t slot, void *value) {
+#if (UCOS2_TLS_SLOTS > 0u)
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+  if ((slot >= UCOS2_TLS_SLOTS) || (OSTCBCur == NULL)) {
+    return osErrorParameter;
+  }
+
+  os_ucos2_thread_t *thread = osUcos2ThreadFromExt(OSTCBCur);
+  if (thread == NULL) {
+    return osErrorResource;
+  }
+
+  thread->tls[slot] = value;
+  return osOK;
+#else
+  (void)slot;
+  (void)value;
+  return osError;
+#endif
+}
+
+/* ==== Trace Recorder ==== */
+
+#if (UCOS2_TRACE_EN > 0u)
+/* CMSIS threads are named by their ID, other tasks (idle, timer, ...) by TCB. */
+static uint32_t osUcos2TraceTaskId(const OS_TCB *ptcb) {
+  os_ucos2_thread_t *thread = osUcos2ThreadFromExt(ptcb);
+  return (thread != NULL) ? UCOS2_TRACE_ID(thread) : UCOS2_TRACE_ID(ptcb);
+}
+
+/* Lock-free writer: reserve a slot, fill it, then publish it by storing its
+ * index + 1 in the slot's sequence word. Until then the word still holds an
+ * earlier lap's value, so osTraceRead neither copies a half-written record
+ * nor takes a stale one for it after an overflow. */
+static void osUcos2TraceEmit(uint32_t event, uint32_t object, uint32_t arg) {
+  if (os_ucos2_kernel.trace_paused) {
+    return;
+  }
+
+  uint32_t index = UCOS2_TRACE_ATOMIC_INC(&os_ucos2_kernel.trace_head);
+  volatile osTraceRecord_t *record = &os_ucos2_kernel.trace_buf[index & (UCOS2_TRACE_EVENTS - 1u)];
+  record->timestamp = UCOS2_TS_GET();
+  record->object = object;
+  record->arg = arg;
+  record->context = (uint16_t)OSIntNesting;
+  record->event = (uint16_t)event;
+  os_ucos2_kernel.trace_seq[index & (UCOS2_TRACE_EVENTS - 1u)] = index + 1u;
+}
+
+static void osUcos2TraceApiEnter(uint32_t api, uint32_t object, uint32_t arg) {
+  if (!osUcos2IrqContext() && (OSTCBCur != NULL)) {
+    os_ucos2_thread_t *thread = osUcos2ThreadFromExt(OSTCBCur);
+    if (thread != NULL) {
+      thread->trace_object = object;
+    }
+  }
+  osUcos2TraceEmit(osTraceEventApiEnter | api, object, arg);
+}
+
+/* Four characters per record; the record holding the terminator ends the name. */
+static void osUcos2TraceName(uint32_t object, const char *name) {
+  if ((object == 0u) || (name == NULL)) {
+    return;
+  }
+
+  for (;;) {
+    uint32_t chunk = 0u;
+    uint32_t i = 0u;
+    for (; (i < 4u) && (name[i] != '\0'); ++i) {
+      chunk |= (uint32_t)(uint8_t)name[i] << (8u * i);
+    }
+    osUcos2TraceEmit(osTraceEventName, object, chunk);
+    if (i < 4u) {
+      return;
+    }
+    name += 4;
+  }
+}
+
+/* A post readies the highest-priority waiter. Found through the CMSIS thread
+ * list rather than the event wait table, so tasks outside the wrapper are not
+ * reported. */
+static void osUcos2TraceWakeup(uint32_t object, const OS_EVENT *pevent) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  const os_ucos2_thread_t *waiter = osUcos2EventWaiter(pevent);
+  OS_EXIT_CRITICAL();
+  if (waiter != NULL) {
+    osUcos2TraceEmit(osTraceEventWakeup, object, UCOS2_TRACE_ID(waiter));
+  }
+}
+
+/* Called from the task switch hook with interrupts disabled. */
+static void osUcos2TraceSwitch(const OS_TCB *from, const OS_TCB *to) {
+  if (from != NULL) {
+    uint32_t reason = 0u;
+    if ((from->OSTCBStat & OS_STAT_SUSPEND) != 0u) {
+      reason = osTraceBlockSuspend;
+    } else if ((from->OSTCBStat & OS_STAT_PEND_ANY) != 0u) {
+      reason = osTraceBlockPend;
+    } else if (from->OSTCBDly != 0u) {
+      reason = osTraceBlockDelay;
+    }
+    if (reason != 0u) {
+      os_ucos2_thread_t *thread = osUcos2ThreadFromExt(from);
+      osUcos2TraceEmit(osTraceEventBlock, (thread != NULL) ? thread->trace_object : 0u, reason);
+    }
+  }
+  osUcos2TraceEmit(osTraceEventSwitch, osUcos2TraceTaskId(to), (from != NULL) ? osUcos2TraceTaskId(from) : 0u);
+}
+#endif
+
+void osTraceStart(void) {
+#if (UCOS2_TRACE_EN > 0u)
+  os_ucos2_kernel.trace_paused = false;
+#endif
+}
+
+void osTraceStop(void) {
+#if (UCOS2_TRACE_EN > 0u)
+  os_ucos2_kernel.trace_paused = true;
+#endif
+}
+
+/* Single reader. Each record is moved out under a short critical section so
+ * a large read does not hold interrupts off. */
+uint32_t osTraceRead(osTraceRecord_t *records, uint32_t max_count) {
+#if (UCOS2_TRACE_EN > 0u)
+  if (records == NULL) {
+    return 0u;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  uint32_t count = 0u;
+  while (count < max_count) {
+    OS_ENTER_CRITICAL();
+    uint32_t head = os_ucos2_kernel.trace_head;
+    uint32_t tail = os_ucos2_kernel.trace_tail;
+    if ((head - tail) > UCOS2_TRACE_EVENTS) {
+      os_ucos2_kernel.trace_dropped += (head - tail) - UCOS2_TRACE_EVENTS;
+      tail = head - UCOS2_TRACE_EVENTS;
+    }
+    volatile osTraceRecord_t *slot = &os_ucos2_kernel.trace_buf[tail & (UCOS2_TRACE_EVENTS - 1u)];
+    if ((tail == head) || (os_ucos2_kernel.trace_seq[tail & (UCOS2_TRACE_EVENTS - 1u)] != (tail + 1u))) {
+      os_ucos2_kernel.trace_tail = tail;
+      OS_EXIT_CRITICAL();
+      break;
+    }
+    records[count].timestamp = slot->timestamp;
+    records[count].object = slot->object;
+    records[count].arg = slot->arg;
+    records[count].event = slot->event;
+    records[count].context = slot->context;
+    os_ucos2_kernel.trace_tail = tail + 1u;
+    OS_EXIT_CRITICAL();
+    count++;
+  }
+  return count;
+#else
+  (void)records;
+  (void)max_count;
+  return 0u;
+#endif
+}
+
+uint32_t osTraceGetDropped(void) {
+#if (UCOS2_TRACE_EN > 0u)
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  uint32_t pending = os_ucos2_kernel.trace_head - os_ucos2_kernel.trace_tail;
+  uint32_t dropped = os_ucos2_kernel.trace_dropped;
+  if (pending > UCOS2_TRACE_EVENTS) {
+    dropped += pending - UCOS2_TRACE_EVENTS;
+  }
+  OS_EXIT_CRITICAL();
+  return dropped;
+#else
+  return 0u;
+#endif
+}
+
+void osTraceIsrEnter(uint32_t irq) {
+#if (UCOS2_TRACE_EN > 0u)
+  osUcos2TraceEmit(osTraceEventIsrEnter, 0u, irq);
+#else
+  (void)irq;
+#endif
+}
+
+void osTraceIsrExit(uint32_t irq) {
+#if (UCOS2_TRACE_EN > 0u)
+  osUcos2TraceEmit(osTraceEventIsrExit, 0u, irq);
+#else
+  (void)irq;
+#endif
+}
+
+void osTraceUser(uint32_t code, const void *object, uint32_t arg) {
+#if (UCOS2_TRACE_EN > 0u)
+  osUcos2TraceEmit(osTraceEventUser | (code & 0xFFu), UCOS2_TRACE_ID(object), arg);
+#else
+  (void)code;
+  (void)object;
+  (void)arg;
+#endif
+}
+
+/* ==== Tick Profiler ==== */
+
+#if (UCOS2_PROFILER_EN > 0u)
+/* Runs in the tick interrupt, the only writer. The reader copies each sample
+ * with interrupts disabled, so it never sees one half written. */
+static void osUcos2ProfilerSample(void) {
+  const OS_TCB *ptcb = OSTCBCur;
+  if (os_ucos2_kernel.prof_paused || (ptcb == NULL)) {
+    return;
+  }
+
+  const os_ucos2_thread_t *thread = osUcos2ThreadFromExt(ptcb);
+  osProfilerSample_t *sample = &os_ucos2_kernel.prof_buf[os_ucos2_kernel.prof_head & (UCOS2_PROFILER_SAMPLES - 1u)];
+  sample->tick = (uint32_t)OSTime;
+  sample->thread = (thread != NULL) ? (uint32_t)(uintptr_t)thread : (uint32_t)(uintptr_t)ptcb;
+  sample->pc = (uint32_t)(UCOS2_PROFILER_PC());
+  if (thread != NULL) {
+    sample->flags = 0u;
+  } else {
+    sample->flags = (ptcb == OSTCBPrioTbl[OS_TASK_IDLE_PRIO]) ? osProfilerSampleIdle : osProfilerSampleKernel;
+  }
+  sample->context = (OSIntNesting > 1u) ? (uint16_t)(OSIntNesting - 1u) : 0u;
+  os_ucos2_kernel.prof_head++;
+}
+#endif
+
+void osProfilerStart(void) {
+#if (UCOS2_PROFILER_EN > 0u)
+  os_ucos2_kernel.prof_paused = false;
+#endif
+}
+
+void osProfilerStop(void) {
+#if (UCOS2_PROFILER_EN > 0u)
+  os_ucos2_kernel.prof_paused = true;
+#endif
+}
+
+uint32_t osProfilerRead(osProfilerSample_t *samples, uint32_t max_count) {
+#if (UCOS2_PROFILER_EN > 0u)
+  if (samples == NULL) {
+    return 0u;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  uint32_t count = 0u;
+  while (count < max_count) {
+    OS_ENTER_CRITICAL();
+    uint32_t head = os_ucos2_kernel.prof_head;
+    uint32_t tail = os_ucos2_kernel.prof_tail;
+    if ((head - tail) > UCOS2_PROFILER_SAMPLES) {
+      os_ucos2_kernel.prof_dropped += (head - tail) - UCOS2_PROFILER_SAMPLES;
+      tail = head - UCOS2_PROFILER_SAMPLES;
+    }
+    if (tail == head) {
+      os_ucos2_kernel.prof_tail = tail;
+      OS_EXIT_CRITICAL();
+      break;
+    }
+    samples[count] = os_ucos2_kernel.prof_buf[tail & (UCOS2_PROFILER_SAMPLES - 1u)];
+    os_ucos2_kernel.prof_tail = tail + 1u;
+    OS_EXIT_CRITICAL();
+    count++;
+  }
+  return count;
+#else
+  (void)samples;
+  (void)max_count;
+  return 0u;
+#endif
+}
+
+uint32_t osProfilerGetDropped(void) {
+#if (UCOS2_PROFILER_EN > 0u)
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  uint32_t pending = os_ucos2_kernel.prof_head - os_ucos2_kernel.prof_tail;
+  uint32_t dropped = os_ucos2_kernel.prof_dropped;
+  if (pending > UCOS2_PROFILER_SAMPLES) {
+    dropped += pending - UCOS2_PROFILER_SAMPLES;
+  }
+  OS_EXIT_CRITICAL();
+  return dropped;
+#else
+  return 0u;
+#endif
+}
+
+/* ==== Priority Inversion ==== */
+
+#if (UCOS2_INVERSION_EN > 0u)
+/* Only CMSIS threads take part; ISRs and other tasks are never waiters or holders. */
+static os_ucos2_thread_t *osUcos2InversionSelf(void) {
+  if (osUcos2IrqContext() || (OSTCBCur == NULL)) {
+    return NULL;
+  }
+  return osUcos2ThreadFromExt(OSTCBCur);
+}
+
+/* Only an owner of lower priority turns the wait into an inversion: the
+ * mutex owner, or the last taker of a binary semaphore. The clock starts here
+ * and the waiter is left untracked otherwise. */
+static void osUcos2InversionBegin(void *object, osInversionStats_t *stats, const OS_EVENT *mutex,
+                                  os_ucos2_thread_t *const *taker) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  os_ucos2_thread_t *self = osUcos2InversionSelf();
+  if (self == NULL) {
+    return;
+  }
+
+  os_ucos2_thread_t *holder = NULL;
+  OS_ENTER_CRITICAL();
+  os_ucos2_thread_t *owner = NULL;
+  if ((mutex != NULL) && (mutex->OSEventPtr != NULL)) {
+    owner = osUcos2ThreadFromExt((const OS_TCB *)mutex->OSEventPtr);
+  } else if (taker != NULL) {
+    owner = *taker;
+  }
+  if ((owner != NULL) && (owner->ucos_prio > self->tcb->OSTCBPrio)) {
+    holder = owner;
+    self->inv_stats = stats;
+    self->inv_holder = holder;
+    self->inv_since = UCOS2_TS_GET();
+  }
+  OS_EXIT_CRITICAL();
+
+  if (holder != NULL) {
+    UCOS2_INVERSION_HOOK(object, (osThreadId_t)self, (osThreadId_t)holder);
+  }
+}
+
+/* A binary semaphore is taken as a lock: its last CMSIS taker holds it until
+ * the next release, from a thread or an ISR. Counting semaphores have no
+ * holder. */
+static void osUcos2InversionTake(os_ucos2_semaphore_t *sem, INT8U err) {
+  if ((err != OS_ERR_NONE) || (sem->max_count != 1u)) {
+    return;
+  }
+  os_ucos2_thread_t *self = osUcos2InversionSelf();
+  if (self != NULL) {
+    sem->holder = self;
+  }
+}
+
+static void osUcos2InversionGive(os_ucos2_semaphore_t *sem) {
+  sem->holder = NULL;
+}
+
+/* Deleting the object aborts the pend; its statistics are gone by then. */
+static void osUcos2InversionEnd(INT8U err) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  os_ucos2_thread_t *self = osUcos2InversionSelf();
+  if ((self == NULL) || (self->inv_stats == NULL)) {
+    return;
+  }
+
+  uint32_t now = UCOS2_TS_GET();
+  OS_ENTER_CRITICAL();
+  osInversionStats_t *stats = self->inv_stats;
+  os_ucos2_thread_t *holder = self->inv_holder;
+  self->inv_stats = NULL;
+  self->inv_holder = NULL;
+  if (err != OS_ERR_PEND_ABORT) {
+    uint32_t cycles = now - self->inv_since;
+    stats->count++;
+    stats->total_cycles += cycles;
+    if (cycles >= stats->worst_cycles) {
+      stats->worst_cycles = cycles;
+      stats->worst_waiter = (osThreadId_t)self;
+      stats->worst_holder = (osThreadId_t)holder;
+    }
+  }
+  OS_EXIT_CRITICAL();
+}
+
+static osStatus_t osUcos2InversionCopy(const osInversionStats_t *source, osInversionStats_t *stats) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  if (stats == NULL) {
+    return osErrorParameter;
+  }
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+  OS_ENTER_CRITICAL();
+  *stats = *source;
+  OS_EXIT_CRITICAL();
+  return osOK;
+}
+#endif
+
+osStatus_t osMutexGetInversionStats(osMutexId_t mutex_id, osInversionStats_t *stats) {
+#if (UCOS2_INVERSION_EN > 0u)
+  os_ucos2_mutex_t *mutex = osUcos2MutexFromId(mutex_id);
+  if (mutex == NULL) {
+    return osErrorParameter;
+  }
+  return osUcos2InversionCopy(&mutex->inversion, stats);
+#else
+  (void)mutex_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+osStatus_t osSemaphoreGetInversionStats(osSemaphoreId_t semaphore_id, osInversionStats_t *stats) {
+#if (UCOS2_INVERSION_EN > 0u)
+  os_ucos2_semaphore_t *sem = osUcos2SemaphoreFromId(semaphore_id);
+  if (sem == NULL) {
+    return osErrorParameter;
+  }
+  return osUcos2InversionCopy(&sem->inversion, stats);
+#else
+  (void)semaphore_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+/* ==== Wait Statistics ==== */
+
+#if (UCOS2_WAIT_STATS_EN > 0u)
+/* Entries are taken in order and never released, so the first free entry ends
+ * the search; the last entry collects whatever does not fit. */
+static void osUcos2WaitRecord(uint32_t kind, const void *object, uint32_t start) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  if (osUcos2IrqContext() || (OSTCBCur == NULL)) {
+    return;
+  }
+  os_ucos2_thread_t *self = osUcos2ThreadFromExt(OSTCBCur);
+  if (self == NULL) {
+    return;
+  }
+
+  uint32_t cycles = UCOS2_TS_GET() - start;
+  OS_ENTER_CRITICAL();
+  osThreadWaitStat_t *entry = NULL;
+  for (uint32_t i = 0u; i < UCOS2_WAIT_STATS_SLOTS; ++i) {
+    osThreadWaitStat_t *slot = &self->wait[i];
+    if (slot->count == 0u) {
+      slot->object = object;
+      slot->kind = kind;
+      entry = slot;
+      break;
+    }
+    if ((slot->object == object) && (slot->kind == kind)) {
+      entry = slot;
+      break;
+    }
+  }
+  if (entry == NULL) {
+    entry = &self->wait[UCOS2_WAIT_STATS_SLOTS - 1u];
+    entry->object = NULL;
+    entry->kind = osWaitKindOther;
+  }
+  entry->count++;
+  entry->cycles += cycles;
+  if (cycles > entry->max_cycles) {
+    entry->max_cycles = cycles;
+  }
+  OS_EXIT_CRITICAL();
+}
+#endif
+
+uint32_t osThreadGetWaitStats(osThreadId_t thread_id, osThreadWaitStat_t *stats, uint32_t max_count) {
+#if (UCOS2_WAIT_STATS_EN > 0u)
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  os_ucos2_thread_t *thread = osUcos2ThreadFromId(thread_id);
+  if ((thread == NULL) || (stats == NULL) || osUcos2IrqContext()) {
+    return 0u;
+  }
+
+  uint32_t count = 0u;
+  OS_ENTER_CRITICAL();
+  for (uint32_t i = 0u; (i < UCOS2_WAIT_STATS_SLOTS) && (count < max_count); ++i) {
+    if (thread->wait[i].count != 0u) {
+      stats[count++] = thread->wait[i];
+    }
+  }
+  OS_EXIT_CRITICAL();
+  return count;
+#else
+  (void)thread_id;
+  (void)stats;
+  (void)max_count;
+  return 0u;
+#endif
+}
+
+/* ==== Slab Allocator ==== */
+
+os_ucos2_slab_t *osUcos2SlabFromId(osSlabId_t slab_id) {
+  if (slab_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos2_slab_t *slab = (os_ucos2_slab_t *)slab_id;
+  return ((slab->object.type == osUcos2ObjectSlab) && (slab->class_count != 0u)) ? slab : NULL;
+}
+
+/* Statistics counters are bumped from threads and ISRs; they follow the
+ * UCOS2_LOCKFREE_EN choice between atomics and short critical sections. */
+static void osUcos2StatCount(uint32_t *counter, uint32_t *peak, uint32_t used) {
+#if (UCOS2_LOCKFREE_EN > 0u)
+  (void)UCOS2_ATOMIC_ADD(counter, 1u);
+  if (peak != NULL) {
+    uint32_t seen = *(volatile uint32_t *)peak;
+    while ((used > seen) && !UCOS2_ATOMIC_CAS(peak, &seen, used)) {
+    }
+  }
+#else
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  (*counter)++;
+  if ((peak != NULL) && (used > *peak)) {
+    *peak = used;
+  }
+  OS_EXIT_CRITICAL();
+#endif
+}
+
+osSlabId_t osSlabNew(const osSlabAttr_t *attr) {
+  if (osUcos2IrqContext() ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos2_slab_t)) ||
+      (attr->classes == NULL) ||
+      (attr->class_count == 0u) ||
+      (attr->class_count > UCOS2_SLAB_CLASSES)) {
+    return NULL;
+  }
+
+  /* Classes must grow so the first fit is also the tightest fit. */
+  for (uint32_t i = 1u; i < attr->class_count; ++i) {
+    if (attr->classes[i].block_size <= attr->classes[i - 1u].block_size) {
+      return NULL;
+    }
+  }
+
+  os_ucos2_slab_t *slab = (os_ucos2_slab_t *)attr->cb_mem;
+  memset(slab, 0, sizeof(*slab));
+  osUcos2ObjectInit(&slab->object, osUcos2ObjectSlab, attr->name, attr->attr_bits);
+
+  for (uint32_t i = 0u; i < attr->class_count; ++i) {
+    const osSlabClassAttr_t *class_attr = &attr->classes[i];
+    os_ucos2_slab_class_t *cls = &slab->classes[i];
+    const osMemoryPoolAttr_t pool_attr = {
+      .name    = attr->name,
+      .cb_mem  = class_attr->cb_mem,
+      .cb_size = class_attr->cb_size,
+      .mp_mem  = class_attr->mp_mem,
+      .mp_size = class_attr->mp_size,
+    };
+
+    cls->pool = osMemoryPoolNew(class_attr->block_count, class_attr->block_size, &pool_attr);
+    if (cls->pool == NULL) {
+      for (uint32_t j = 0u; j < i; ++j) {
+        (void)osMemoryPoolDelete(slab->classes[j].pool);
+      }
+      return NULL;
+    }
+
+    cls->block_size = class_attr->block_size;
+    cls->base = (uint8_t *)class_attr->mp_mem;
+    cls->limit = cls->base + (osMemoryPoolGetBlockSize(cls->pool) * class_attr->block_count);
+  }
+
+  slab->class_count = attr->class_count;
+  return (osSlabId_t)slab;
+}
+
+void *osSlabAlloc(osSlabId_t slab_id, uint32_t size, uint32_t timeout) {
+  os_ucos2_slab_t *slab = osUcos2SlabFromId(slab_id);
+  if ((slab == NULL) || (size == 0u) || osUcos2IsrDisallowsWait(timeout)) {
+    return NULL;
+  }
+
+  uint32_t fit = 0u;
+  while ((fit < slab->class_count) && (slab->classes[fit].block_size < size)) {
+    fit++;
+  }
+  if (fit == slab->class_count) {
+    return NULL;
+  }
+
+  os_ucos2_slab_class_t *cls = &slab->classes[fit];
+  void *block = osMemoryPoolAlloc(cls->pool, 0u);
+  os_ucos2_slab_class_t *from = cls;
+  if ((block == NULL) && ((slab->object.attr_bits & osSlabOverflow) != 0u)) {
+    for (uint32_t i = fit + 1u; (block == NULL) && (i < slab->class_count); ++i) {
+      from = &slab->classes[i];
+      block = osMemoryPoolAlloc(from->pool, 0u);
+    }
+    if (block != NULL) {
+      osUcos2StatCount(&cls->overflows, NULL, 0u);
+    }
+  }
+  if ((block == NULL) && (timeout != 0u)) {
+    from = cls;
+    block = osMemoryPoolAlloc(cls->pool, timeout);
+  }
+
+  if (block == NULL) {
+    osUcos2StatCount(&cls->failures, NULL, 0u);
+    return NULL;
+  }
+  osUcos2StatCount(&from->allocs, &from->peak, osMemoryPoolGetCount(from->pool));
+  return block;
+}
+
+osStatus_t osSlabFree(osSlabId_t slab_id, void *block) {
+  os_ucos2_slab_t *slab = osUcos2SlabFromId(slab_id);
+  if ((slab == NULL) || (block == NULL)) {
+    return osErrorParameter;
+  }
+
+  for (uint32_t i = 0u; i < slab->class_count; ++i) {
+    os_ucos2_slab_class_t *cls = &slab->classes[i];
+    if (((uint8_t *)block >= cls->base) && ((uint8_t *)block < cls->limit)) {
+      return osMemoryPoolFree(cls->pool, block);
+    }
+  }
+  return osErrorParameter;
+}
+
+uint32_t osSlabGetClassCount(osSlabId_t slab_id) {
+  os_ucos2_slab_t *slab = osUcos2SlabFromId(slab_id);
+  return (slab != NULL) ? slab->class_count : 0u;
+}
+
+osStatus_t osSlabGetStats(osSlabId_t slab_id, uint32_t index, osSlabStats_t *stats) {
+  os_ucos2_slab_t *slab = osUcos2SlabFromId(slab_id);
+  if ((slab == NULL) || (index >= slab->class_count) || (stats == NULL)) {
+    return osErrorParameter;
+  }
+
+  const os_ucos2_slab_class_t *cls = &slab->classes[index];
+  stats->block_size = osMemoryPoolGetBlockSize(cls->pool);
+  stats->capacity = osMemoryPoolGetCapacity(cls->pool);
+  stats->used = osMemoryPoolGetCount(cls->pool);
+  stats->peak = cls->peak;
+  stats->allocs = cls->allocs;
+  stats->overflows = cls->overflows;
+  stats->failures = cls->failures;
+  return osOK;
+}
+
+osStatus_t osSlabDelete(osSlabId_t slab_id) {
+  os_ucos2_slab_t *slab = osUcos2SlabFromId(slab_id);
+  if (slab == NULL) {
+    return osErrorParameter;
+  }
+
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+  osStatus_t status = osOK;
+  for (uint32_t i = 0u; i < slab->class_count; ++i) {
+    if (osMemoryPoolDelete(slab->classes[i].pool) != osOK) {
+      status = osError;
+    }
+  }
+  slab->class_count = 0u;
+  return status;
+}
+
+/* ==== Buffer Descriptors ==== */
+
+/* Adds delta (negative for a release) to the reference count. A count that
+ * is already zero belongs to a released buffer and is left alone, as is a
+ * retain that would wrap. */
+static bool osUcos2BufferAdjust(osBuffer_t *buf, uint32_t delta, uint32_t *refs) {
+#if (UCOS2_LOCKFREE_EN > 0u)
+  uint32_t seen = *(volatile uint32_t *)&buf->refs;
+  uint32_t next;
+  do {
+    next = seen + delta;
+    if ((seen == 0u) || (((int32_t)delta > 0) && (next < seen))) {
+      return false;
+    }
+  } while (!UCOS2_ATOMIC_CAS(&buf->refs, &seen, next));
+  *refs = next;
+  return true;
+#else
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  uint32_t next = buf->refs + delta;
+  bool ok = (buf->refs != 0u) && (((int32_t)delta < 0) || (next >= buf->refs));
+  if (ok) {
+    buf->refs = next;
+  }
+  OS_EXIT_CRITICAL();
+  *refs = next;
+  return ok;
+#endif
+}
+
+osBuffer_t *osBufferAlloc(osMemoryPoolId_t mp_id, uint32_t timeout) {
+  uint32_t block_size = osMemoryPoolGetBlockSize(mp_id);
+  if (block_size <= sizeof(osBuffer_t)) {
+    return NULL;
+  }
+
+  osBuffer_t *buf = (osBuffer_t *)osMemoryPoolAlloc(mp_id, timeout);
+  if (buf == NULL) {
+    return NULL;
+  }
+  buf->pool = mp_id;
+  buf->refs = 1u;
+  buf->capacity = block_size - (uint32_t)sizeof(osBuffer_t);
+  buf->length = 0u;
+  return buf;
+}
+
+osStatus_t osBufferRetain(osBuffer_t *buf, uint32_t count) {
+  uint32_t refs;
+  if ((buf == NULL) || (count == 0u) || (count > (uint32_t)INT32_MAX)) {
+    return osErrorParameter;
+  }
+  return osUcos2BufferAdjust(buf, count, &refs) ? osOK : osErrorResource;
+}
+
+osStatus_t osBufferRelease(osBuffer_t *buf) {
+  uint32_t refs;
+  if (buf == NULL) {
+    return osErrorParameter;
+  }
+  if (!osUcos2BufferAdjust(buf, (uint32_t)-1, &refs)) {
+    return osErrorResource;
+  }
+  return (refs == 0u) ? osMemoryPoolFree(buf->pool, buf) : osOK;
+}
+
+osStatus_t osBufferPut(osMessageQueueId_t mq_id, osBuffer_t *buf, uint8_t msg_prio, uint32_t timeout) {
+  os_ucos2_message_queue_t *mq = osUcos2MessageQueueFromId(mq_id);
+  if ((mq == NULL) || (mq->msg_size != sizeof(void *)) || (buf == NULL)) {
+    return osErrorParameter;
+  }
+
+  /* The queue entry's reference is taken first so a consumer that releases
+   * it immediately cannot free the block under the producer. */
+  osStatus_t status = osBufferRetain(buf, 1u);
+  if (status != osOK) {
+    return status;
+  }
+  status = osMessageQueuePut(mq_id, &buf, msg_prio, timeout);
+  if (status != osOK) {
+    (void)osBufferRelease(buf);
+  }
+  return status;
+}
+
+osBuffer_t *osBufferGet(osMessageQueueId_t mq_id, uint32_t timeout) {
+  osBuffer_t *buf = NULL;
+  if (osMessageQueueGet(mq_id, &buf, NULL, timeout) != osOK) {
+    return NULL;
+  }
+  return buf;
+}
+
+/* ==== Topic Bus ==== */
+
+os_ucos2_topic_t *osUcos2TopicFromId(osTopicId_t topic_id) {
+  if (topic_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos2_topic_t *topic = (os_ucos2_topic_t *)topic_id;
+  return ((topic->object.type == osUcos2ObjectTopic) && topic->created) ? topic : NULL;
+}
+
+osTopicId_t osTopicNew(const osTopicAttr_t *attr) {
+  if (osUcos2IrqContext() ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos2_topic_t))) {
+    return NULL;
+  }
+
+  os_ucos2_topic_t *topic = (os_ucos2_topic_t *)attr->cb_mem;
+  memset(topic, 0, sizeof(*topic));
+  osUcos2ObjectInit(&topic->object, osUcos2ObjectTopic, attr->name, attr->attr_bits);
+  topic->created = true;
+  return (osTopicId_t)topic;
+}
+
+/* The subscriber array only changes here, with interrupts disabled, so a
+ * publish (scheduler locked, or in an ISR) always sees a dense array. */
+static osStatus_t osUcos2TopicAdd(osTopicId_t topic_id, void *target, uint32_t flags, uint32_t policy) {
+  os_ucos2_topic_t *topic = osUcos2TopicFromId(topic_id);
+  if ((topic == NULL) || (target == NULL)) {
+    return osErrorParameter;
+  }
+
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+  osStatus_t status = osOK;
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  for (uint32_t i = 0u; i < topic->count; ++i) {
+    if (topic->subs[i].target == target) {
+      status = osErrorParameter;
+    }
+  }
+  if ((status == osOK) && (topic->count == UCOS2_TOPIC_SUBSCRIBERS)) {
+    status = osErrorResource;
+  }
+  if (status == osOK) {
+    os_ucos2_topic_sub_t *sub = &topic->subs[topic->count];
+    sub->target = target;
+    sub->flags = flags;
+    sub->policy = policy;
+    sub->dropped = 0u;
+    topic->count++;
+  }
+  OS_EXIT_CRITICAL();
+  return status;
+}
+
+osStatus_t osTopicSubscribe(osTopicId_t topic_id, osMessageQueueId_t mq_id, uint32_t policy) {
+  if ((osMessageQueueGetMsgSize(mq_id) != sizeof(void *)) ||
+      ((policy != osTopicDropNewest) && (policy != osTopicDropOldest))) {
+    return osErrorParameter;
+  }
+  return osUcos2TopicAdd(topic_id, mq_id, 0u, policy);
+}
+
+osStatus_t osTopicSubscribeFlags(osTopicId_t topic_id, osEventFlagsId_t ef_id, uint32_t flags) {
+  if ((osUcos2EventFlagsFromId(ef_id) == NULL) || !osUcos2FlagsValid(flags)) {
+    return osErrorParameter;
+  }
+  return osUcos2TopicAdd(topic_id, ef_id, flags, osTopicDropNewest);
+}
+
+osStatus_t osTopicUnsubscribe(osTopicId_t topic_id, void *subscriber) {
+  os_ucos2_topic_t *topic = osUcos2TopicFromId(topic_id);
+  if (topic == NULL) {
+    return osErrorParameter;
+  }
+
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+  osStatus_t status = osErrorResource;
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  for (uint32_t i = 0u; i < topic->count; ++i) {
+    if (topic->subs[i].target == subscriber) {
+      topic->count--;
+      topic->subs[i] = topic->subs[topic->count];
+      status = osOK;
+      break;
+    }
+  }
+  OS_EXIT_CRITICAL();
+  return status;
+}
+
+static osStatus_t osUcos2TopicPut(osMessageQueueId_t mq_id, void *msg, bool buffer) {
+  return buffer ? osBufferPut(mq_id, (osBuffer_t *)msg, 0u, 0u)
+                : osMessageQueuePut(mq_id, &msg, 0u, 0u);
+}
+
+/* Post to one queue without waiting. With osTopicDropOldest a full queue
+ * gives up its oldest message (releasing it on a buffer topic) once; if
+ * another producer takes the freed slot first, the retry fails and msg is
+ * lost instead. Either way one message is dropped and counted. */
+static bool osUcos2TopicPost(os_ucos2_topic_sub_t *sub, void *msg, bool buffer) {
+  osMessageQueueId_t mq_id = (osMessageQueueId_t)sub->target;
+  osStatus_t status = osUcos2TopicPut(mq_id, msg, buffer);
+  if (status == osOK) {
+    return true;
+  }
+
+  void *oldest = NULL;
+  if ((status == osErrorResource) &&
+      (sub->policy == osTopicDropOldest) &&
+      (osMessageQueueGet(mq_id, &oldest, NULL, 0u) == osOK)) {
+    if (buffer) {
+      (void)osBufferRelease((osBuffer_t *)oldest);
+    }
+    status = osUcos2TopicPut(mq_id, msg, buffer);
+  }
+  osUcos2StatCount(&sub->dropped, NULL, 0u);
+  return (status == osOK);
+}
+
+/* One pass over the subscriber array. Threads hold the scheduler lock for
+ * the pass, so woken subscribers run once, after the last post; an ISR is
+ * not preempted by threads anyway. */
+static uint32_t osUcos2TopicPublish(os_ucos2_topic_t *topic, void *msg, bool buffer) {
+  const bool isr = osUcos2IrqContext();
+  int32_t lock = isr ? 0 : osUcos2KernelLock();
+  uint32_t delivered = 0u;
+
+  for (uint32_t i = 0u; i < topic->count; ++i) {
+    os_ucos2_topic_sub_t *sub = &topic->subs[i];
+    if (sub->flags != 0u) {
+      if ((osEventFlagsSet((osEventFlagsId_t)sub->target, sub->flags) & osFlagsError) == 0u) {
+        delivered++;
+      }
+    } else if (osUcos2TopicPost(sub, msg, buffer)) {
+      delivered++;
+    }
+  }
+
+  if (!isr && (lock >= 0)) {
+    (void)osUcos2KernelRestoreLock(lock);
+  }
+  return delivered;
+}
+
+uint32_t osTopicPublish(osTopicId_t topic_id, void *msg) {
+  os_ucos2_topic_t *topic = osUcos2TopicFromId(topic_id);
+  if ((topic == NULL) || ((topic->object.attr_bits & osTopicBuffers) != 0u)) {
+    return 0u;
+  }
+  return osUcos2TopicPublish(topic, msg, false);
+}
+
+uint32_t osTopicPublishBuffer(osTopicId_t topic_id, osBuffer_t *buf) {
+  os_ucos2_topic_t *topic = osUcos2TopicFromId(topic_id);
+  if ((topic == NULL) || (buf == NULL) || ((topic->object.attr_bits & osTopicBuffers) == 0u)) {
+    return 0u;
+  }
+  return osUcos2TopicPublish(topic, buf, true);
+}
+
+uint32_t osTopicGetDropped(osTopicId_t topic_id, void *subscriber) {
+  os_ucos2_topic_t *topic = osUcos2TopicFromId(topic_id);
+  if (topic == NULL) {
+    return 0u;
+  }
+
+  uint32_t dropped = 0u;
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  for (uint32_t i = 0u; i < topic->count; ++i) {
+    if (topic->subs[i].target == subscriber) {
+      dropped = topic->subs[i].dropped;
+    }
+  }
+  OS_EXIT_CRITICAL();
+  return dropped;
+}
+
+osStatus_t osTopicDelete(osTopicId_t topic_id) {
+  os_ucos2_topic_t *topic = osUcos2TopicFromId(topic_id);
+  if (topic == NULL) {
+    return osErrorParameter;
+  }
+
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  topic->created = false;
+  topic->count = 0u;
+  OS_EXIT_CRITICAL();
+  return osOK;
+}
+
+/* ==== Wait Any ==== */
+
+#if (UCOS2_WAIT_ANY_EN > 0u)
+/* Waiter list of a live semaphore, message queue or event flags object. */
+static os_ucos2_wait_any_node_t **osUcos2WaitAnyHead(void *object) {
+  os_ucos2_semaphore_t *sem = osUcos2SemaphoreFromId(object);
+  if (sem != NULL) {
+    return (sem->event != NULL) ? &sem->wait_any : NULL;
+  }
+  os_ucos2_message_queue_t *mq = osUcos2MessageQueueFromId(object);
+  if (mq != NULL) {
+    return (mq->queue_event != NULL) ? &mq->wait_any : NULL;
+  }
+  os_ucos2_event_flags_t *ef = osUcos2EventFlagsFromId(object);
+  return ((ef != NULL) && (ef->grp != NULL)) ? &ef->wait_any : NULL;
+}
+
+/* An object deleted during the wait counts as ready, so the caller's take
+ * reports the error. */
+static bool osUcos2WaitAnyReady(const osObjectWait_t *entry) {
+  os_ucos2_semaphore_t *sem = osUcos2SemaphoreFromId(entry->object);
+  if (sem != NULL) {
+    return (sem->event == NULL) || (osSemaphoreGetCount(entry->object) > 0u);
+  }
+  os_ucos2_message_queue_t *mq = osUcos2MessageQueueFromId(entry->object);
+  if (mq != NULL) {
+    return (mq->queue_event == NULL) || (osMessageQueueGetCount(entry->object) > 0u);
+  }
+  os_ucos2_event_flags_t *ef = osUcos2EventFlagsFromId(entry->object);
+  if ((ef == NULL) || (ef->grp == NULL)) {
+    return true;
+  }
+  uint32_t current = osEventFlagsGet(entry->object) & entry->flags;
+  return ((entry->options & osFlagsWaitAll) != 0u) ? (current == entry->flags) : (current != 0u);
+}
+
+static int32_t osUcos2WaitAnyScan(osObjectWaitSet_t *set) {
+  uint32_t first = (set->policy == osObjectWaitRoundRobin) ? (set->cursor + 1u) : 0u;
+  for (uint32_t n = 0u; n < set->count; ++n) {
+    uint32_t i = (first + n) % set->count;
+    if (osUcos2WaitAnyReady(&set->objects[i])) {
+      set->cursor = i;
+      return (int32_t)i;
+    }
+  }
+  return (int32_t)osErrorResource;
+}
+
+/* Called after the post that made an object ready. Lists only change with
+ * interrupts disabled in the waiting thread, and a thread walks them with the
+ * scheduler locked, so a woken waiter cannot unlink its node mid-walk; an ISR
+ * is not preempted by threads anyway. On delete the list is detached first. */
+static void osUcos2WaitAnyNotify(os_ucos2_wait_any_node_t **head, bool detach) {
+  int32_t lock = osUcos2KernelLock();
+  os_ucos2_wait_any_node_t *node = *head;
+  if (detach) {
+#if OS_CRITICAL_METHOD == 3u
+    OS_CPU_SR cpu_sr = 0u;
+#endif
+    OS_ENTER_CRITICAL();
+    node = *head;
+    *head = NULL;
+    for (os_ucos2_wait_any_node_t *it = node; it != NULL; it = it->next) {
+      it->pprev = NULL;
+    }
+    OS_EXIT_CRITICAL();
+  }
+
+  while (node != NULL) {
+    os_ucos2_wait_any_node_t *next = node->next;
+    (void)OSSemPost(node->wake);
+    node = next;
+  }
+
+  if (lock >= 0) {
+    (void)osUcos2KernelRestoreLock(lock);
+  }
+}
+
+static void osUcos2WaitAnyLink(osObjectWaitSet_t *set, os_ucos2_wait_any_node_t *nodes, OS_EVENT *wake) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  for (uint32_t i = 0u; i < set->count; ++i) {
+    os_ucos2_wait_any_node_t **head = osUcos2WaitAnyHead(set->objects[i].object);
+    nodes[i].wake = wake;
+    nodes[i].pprev = head;
+    nodes[i].next = NULL;
+    if (head != NULL) {
+      nodes[i].next = *head;
+      if (*head != NULL) {
+        (*head)->pprev = &nodes[i].next;
+      }
+      *head = &nodes[i];
+    }
+  }
+  OS_EXIT_CRITICAL();
+}
+
+static void osUcos2WaitAnyUnlink(const osObjectWaitSet_t *set, os_ucos2_wait_any_node_t *nodes) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  for (uint32_t i = 0u; i < set->count; ++i) {
+    os_ucos2_wait_any_node_t *node = &nodes[i];
+    if (node->pprev != NULL) {
+      *node->pprev = node->next;
+      if (node->next != NULL) {
+        node->next->pprev = node->pprev;
+      }
+    }
+  }
+  OS_EXIT_CRITICAL();
+}
+
+static int32_t osUcos2ObjectWaitAny(osObjectWaitSet_t *set, uint32_t timeout) {
+  if ((set == NULL) || (set->objects == NULL) ||
+      (set->count == 0u) || (set->count > UCOS2_WAIT_ANY_MAX) ||
+      ((set->policy != osObjectWaitPriority) && (set->policy != osObjectWaitRoundRobin)) ||
+      osUcos2IsrDisallowsWait(timeout)) {
+    return (int32_t)osErrorParameter;
+  }
+  for (uint32_t i = 0u; i < set->count; ++i) {
+    const osObjectWait_t *entry = &set->objects[i];
+    if ((osUcos2WaitAnyHead(entry->object) == NULL) ||
+        ((osUcos2EventFlagsFromId(entry->object) != NULL) &&
+         (!osUcos2FlagsValid(entry->flags) || !osUcos2FlagsOptionsValid(entry->options)))) {
+      return (int32_t)osErrorParameter;
+    }
+  }
+
+  int32_t result = osUcos2WaitAnyScan(set);
+  if ((result >= 0) || (timeout == 0u)) {
+    return result;
+  }
+
+  /* CMSIS threads reuse their own wake semaphore; a post left over from the
+   * previous wait is cleared before the nodes are linked. Other tasks get a
+   * semaphore for this wait only. */
+  os_ucos2_thread_t *self = osUcos2ThreadFromTcb(OSTCBCur);
+  OS_EVENT *wake;
+  if ((self != NULL) && (self->wait_any_sem != NULL)) {
+    INT8U err;
+    wake = self->wait_any_sem;
+    OSSemSet(wake, 0u, &err);
+    if (err != OS_ERR_NONE) {
+      return (int32_t)osErrorResource;
+    }
+  } else {
+    wake = OSSemCreate(0u);
+    if (wake == NULL) {
+      return (int32_t)osErrorResource;
+    }
+  }
+
+  /* Link first, then look again: a post between the scan above and the link
+   * is seen by the second scan, any later one posts wake. */
+  os_ucos2_wait_any_node_t nodes[UCOS2_WAIT_ANY_MAX];
+  osUcos2WaitAnyLink(set, nodes, wake);
+  const uint32_t start = osKernelGetTickCount();
+  for (;;) {
+    result = osUcos2WaitAnyScan(set);
+    if (result >= 0) {
+      break;
+    }
+
+    INT32U pend_timeout = 0u;
+    if (timeout != osWaitForever) {
+      uint32_t elapsed = osKernelGetTickCount() - start;
+      if (elapsed >= timeout) {
+        result = (int32_t)osErrorTimeout;
+        break;
+      }
+      pend_timeout = (INT32U)(timeout - elapsed);
+    }
+
+    INT8U err;
+    OSSemPend(wake, pend_timeout, &err);
+    if ((err != OS_ERR_NONE) && (err != OS_ERR_TIMEOUT)) {
+      result = (int32_t)osErrorResource;
+      break;
+    }
+  }
+  osUcos2WaitAnyUnlink(set, nodes);
+  if ((self == NULL) || (wake != self->wait_any_sem)) {
+    INT8U err;
+    (void)OSSemDel(wake, OS_DEL_ALWAYS, &err);
+  }
+  return result;
+}
+#endif
+
+int32_t osObjectWaitAny(osObjectWaitSet_t *set, uint32_t timeout) {
+#if (UCOS2_WAIT_ANY_EN > 0u)
+  UCOS2_WAIT_BEGIN(wait_start);
+  int32_t result = osUcos2ObjectWaitAny(set, timeout);
+  UCOS2_WAIT_END(wait_start, osWaitKindObjectSet, set, timeout);
+  return result;
+#else
+  (void)set;
+  (void)timeout;
+  return (int32_t)osError;
+#endif
+}
+
+/* ==== Thread Mailbox ==== */
+
+#if (UCOS2_MAILBOX_EN > 0u)
+static os_ucos2_thread_t *osUcos2MailboxFromId(osThreadId_t thread_id) {
+  os_ucos2_thread_t *thread = osUcos2ThreadFromId(thread_id);
+  if ((thread == NULL) || (thread->tcb == NULL) || (thread->mailbox == NULL)) {
+    return NULL;
+  }
+  return thread;
+}
+
+/* The OS_Q lives in the receiver's control block and holds the pointers
+ * themselves, so a post needs no space semaphore or payload copy. */
+static osStatus_t osUcos2ThreadMessageGet(void **msg, uint32_t timeout) {
+  if (msg == NULL) {
+    return osErrorParameter;
+  }
+  *msg = NULL;
+
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+  os_ucos2_thread_t *self = (OSTCBCur != NULL) ? osUcos2ThreadFromExt(OSTCBCur) : NULL;
+  if ((self == NULL) || (self->mailbox == NULL)) {
+    return osErrorResource;
+  }
+
+  INT8U err;
+  void *message;
+  if (timeout == 0u) {
+    message = OSQAccept(self->mailbox, &err);
+  } else {
+    message = OSQPend(self->mailbox, (timeout == osWaitForever) ? 0u : timeout, &err);
+  }
+  switch (err) {
+    case OS_ERR_NONE:
+      *msg = message;
+      return osOK;
+    case OS_ERR_TIMEOUT:
+      return osErrorTimeout;
+    default:
+      return osErrorResource;
+  }
+}
+#endif
+
+osStatus_t osThreadMessagePut(osThreadId_t thread_id, void *msg) {
+#if (UCOS2_MAILBOX_EN > 0u)
+  os_ucos2_thread_t *thread = osUcos2MailboxFromId(thread_id);
+  if (thread == NULL) {
+    return osErrorParameter;
+  }
+  return (OSQPost(thread->mailbox, msg) == OS_ERR_NONE) ? osOK : osErrorResource;
+#else
+  (void)thread_id;
+  (void)msg;
+  return osError;
+#endif
+}
+
+osStatus_t osThreadMessageGet(void **msg, uint32_t timeout) {
+#if (UCOS2_MAILBOX_EN > 0u)
+  UCOS2_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos2ThreadMessageGet(msg, timeout);
+  UCOS2_WAIT_END(wait_start, osWaitKindThreadMessage, NULL, timeout);
+  return status;
+#else
+  (void)msg;
+  (void)timeout;
+  return osError;
+#endif
+}
+
+uint32_t osThreadMessageGetCount(osThreadId_t thread_id) {
+#if (UCOS2_MAILBOX_EN > 0u)
+  os_ucos2_thread_t *thread = osUcos2MailboxFromId(thread_id);
+  if (thread == NULL) {
+    return 0u;
+  }
+
+  OS_Q_DATA data;
+  return (OSQQuery(thread->mailbox, &data) == OS_ERR_NONE) ? (uint32_t)data.OSNMsgs : 0u;
+#else
+  (void)thread_id;
+  return 0u;
+#endif
+}
+
+/* ==== Work Queue ==== */
+
+#if (UCOS2_WORKQ_EN > 0u)
+os_ucos2_work_queue_t *osUcos2WorkQueueFromId(osWorkQueueId_t wq_id) {
+  if (wq_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos2_work_queue_t *wq = (os_ucos2_work_queue_t *)wq_id;
+  return ((wq->object.type == osUcos2ObjectWorkQueue) && wq->created) ? wq : NULL;
+}
+
+/* True when the caller is one of the queue's workers. */
+static bool osUcos2WorkQueueSelf(const os_ucos2_work_queue_t *wq) {
+  if (osUcos2IrqContext() || (OSTCBCur == NULL)) {
+    return false;
+  }
+
+  const os_ucos2_thread_t *self = osUcos2ThreadFromExt(OSTCBCur);
+  for (uint32_t i = 0u; i < wq->worker_count; ++i) {
+    if (self == &wq->workers[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Takes the oldest item. Submissions land on incoming newest first, so once
+ * the ready list runs dry the whole incoming list is detached and reversed
+ * onto it. Workers only contend with each other here, with interrupts
+ * disabled, which also keeps the swap of incoming atomic against ISRs. */
+static osWork_t *osUcos2WorkNext(os_ucos2_work_queue_t *wq, bool *more) {
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  if (wq->ready_head == NULL) {
+    osWork_t *work = wq->incoming;
+    wq->incoming = NULL;
+    while (work != NULL) {
+      osWork_t *next = work->next;
+      work->next = wq->ready_head;
+      wq->ready_head = work;
+      work = next;
+    }
+  }
+
+  osWork_t *work = wq->ready_head;
+  if (work != NULL) {
+    wq->ready_head = work->next;
+    work->next = NULL;
+    work->pending = 0u;
+
+    uint32_t latency = UCOS2_TS_GET() - work->submitted;
+    wq->executed++;
+    wq->total_latency += latency;
+    if (latency > wq->max_latency) {
+      wq->max_latency = latency;
+    }
+  }
+  *more = (wq->ready_head != NULL) || (wq->incoming != NULL);
+  OS_EXIT_CRITICAL();
+  return work;
+}
+
+/* A worker drains the queue before it pends again. The wake semaphore is
+ * posted when incoming goes from empty to non-empty, and by a worker that
+ * leaves items behind, so an idle sibling picks them up in parallel. */
+static void osUcos2WorkQueueThread(void *argument) {
+  os_ucos2_work_queue_t *wq = (os_ucos2_work_queue_t *)argument;
+
+  for (;;) {
+    INT8U err;
+    OSSemPend(wq->wake, 0u, &err);
+
+    bool more;
+    osWork_t *work;
+    while ((work = osUcos2WorkNext(wq, &more)) != NULL) {
+      if (more && (wq->worker_count > 1u)) {
+        (void)OSSemPost(wq->wake);
+      }
+      work->func(work->argument);
+    }
+  }
+}
+#endif
+
+osWorkQueueId_t osWorkQueueNew(const osWorkQueueAttr_t *attr) {
+#if (UCOS2_WORKQ_EN > 0u)
+  uint32_t count = ((attr != NULL) && (attr->workers != 0u)) ? attr->workers : 1u;
+  if (osUcos2IrqContext() ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos2_work_queue_t)) ||
+      (attr->stack_mem == NULL) ||
+      (count > UCOS2_WORKQ_WORKERS)) {
+    return NULL;
+  }
+
+  /* Each worker gets an equal, 8-byte aligned share of the stack memory. */
+  uint32_t share = (attr->stack_size / count) & ~7u;
+  if (share < (64u * sizeof(OS_STK))) {     /* osUcos2StackWords minimum */
+    return NULL;
+  }
+
+  os_ucos2_work_queue_t *wq = (os_ucos2_work_queue_t *)attr->cb_mem;
+  memset(wq, 0, sizeof(*wq));
+  osUcos2ObjectInit(&wq->object, osUcos2ObjectWorkQueue, attr->name, 0u);
+
+  wq->wake = OSSemCreate(0u);
+  if (wq->wake == NULL) {
+    return NULL;
+  }
+
+  osThreadAttr_t thread_attr = {
+    .name       = attr->name,
+    .cb_size    = sizeof(os_ucos2_thread_t),
+    .stack_size = share,
+    .priority   = (attr->priority != osPriorityNone) ? attr->priority : UCOS2_WORKQ_PRIORITY,
+  };
+  for (uint32_t i = 0u; i < count; ++i) {
+    thread_attr.cb_mem = &wq->workers[i];
+    thread_attr.stack_mem = (uint8_t *)attr->stack_mem + (i * share);
+    if (osThreadNew(osUcos2WorkQueueThread, wq, &thread_attr) == NULL) {
+      while (i-- > 0u) {
+        (void)osThreadTerminate((osThreadId_t)&wq->workers[i]);
+      }
+      INT8U err;
+      (void)OSSemDel(wq->wake, OS_DEL_ALWAYS, &err);
+      return NULL;
+    }
+  }
+
+  wq->worker_count = count;
+  wq->created = true;
+  return (osWorkQueueId_t)wq;
+#else
+  (void)attr;
+  return NULL;
+#endif
+}
+
+osStatus_t osWorkInit(osWork_t *work, osWorkFunc_t func, void *argument) {
+#if (UCOS2_WORKQ_EN > 0u)
+  if ((work == NULL) || (func == NULL)) {
+    return osErrorParameter;
+  }
+
+  memset(work, 0, sizeof(*work));
+  work->func = func;
+  work->argument = argument;
+  return osOK;
+#else
+  (void)work;
+  (void)func;
+  (void)argument;
+  return osError;
+#endif
+}
+
+osStatus_t osWorkSubmit(osWorkQueueId_t wq_id, osWork_t *work) {
+#if (UCOS2_WORKQ_EN > 0u)
+  os_ucos2_work_queue_t *wq = osUcos2WorkQueueFromId(wq_id);
+  if ((wq == NULL) || (work == NULL) || (work->func == NULL)) {
+    return osErrorParameter;
+  }
+
+  bool wake;
+#if (UCOS2_LOCKFREE_EN > 0u)
+  uint32_t idle = 0u;
+  if (!UCOS2_ATOMIC_CAS(&work->pending, &idle, 1u)) {
+    (void)UCOS2_ATOMIC_ADD(&wq->coalesced, 1u);
+    return osOK;
+  }
+  work->submitted = UCOS2_TS_GET();
+  osWork_t *head = *(osWork_t *volatile *)&wq->incoming;
+  do {
+    work->next = head;
+  } while (!UCOS2_ATOMIC_CAS(&wq->incoming, &head, work));
+  (void)UCOS2_ATOMIC_ADD(&wq->submitted, 1u);
+  wake = (head == NULL);
+#else
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  if (work->pending != 0u) {
+    wq->coalesced++;
+    OS_EXIT_CRITICAL();
+    return osOK;
+  }
+  work->pending = 1u;
+  work->submitted = UCOS2_TS_GET();
+  work->next = wq->incoming;
+  wake = (wq->incoming == NULL);
+  wq->incoming = work;
+  wq->submitted++;
+  OS_EXIT_CRITICAL();
+#endif
+
+  if (wake) {
+    (void)OSSemPost(wq->wake);
+  }
+  return osOK;
+#else
+  (void)wq_id;
+  (void)work;
+  return osError;
+#endif
+}
+
+osStatus_t osWorkQueueGetStats(osWorkQueueId_t wq_id, osWorkQueueStats_t *stats) {
+#if (UCOS2_WORKQ_EN > 0u)
+  os_ucos2_work_queue_t *wq = osUcos2WorkQueueFromId(wq_id);
+  if ((wq == NULL) || (stats == NULL)) {
+    return osErrorParameter;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  stats->submitted = wq->submitted;
+  stats->coalesced = wq->coalesced;
+  stats->executed = wq->executed;
+  stats->max_latency = wq->max_latency;
+  stats->total_latency = wq->total_latency;
+  OS_EXIT_CRITICAL();
+  return osOK;
+#else
+  (void)wq_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+osStatus_t osWorkQueueDelete(osWorkQueueId_t wq_id) {
+#if (UCOS2_WORKQ_EN > 0u)
+  os_ucos2_work_queue_t *wq = osUcos2WorkQueueFromId(wq_id);
+  if (wq == NULL) {
+    return osErrorParameter;
+  }
+
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+  /* A worker cannot terminate itself and its siblings from a work function. */
+  if (osUcos2WorkQueueSelf(wq)) {
+    return osErrorResource;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  wq->created = false;
+  OS_EXIT_CRITICAL();
+
+  for (uint32_t i = 0u; i < wq->worker_count; ++i) {
+    (void)osThreadTerminate((osThreadId_t)&wq->workers[i]);
+  }
+
+  /* Submissions are refused from here on; release what is still queued. */
+  OS_ENTER_CRITICAL();
+  osWork_t *lists[2] = { wq->ready_head, wq->incoming };
+  for (uint32_t i = 0u; i < 2u; ++i) {
+    for (osWork_t *work = lists[i]; work != NULL; ) {
+      osWork_t *next = work->next;
+      work->next = NULL;
+      work->pending = 0u;
+      work = next;
+    }
+  }
+  wq->ready_head = NULL;
+  wq->incoming = NULL;
+  OS_EXIT_CRITICAL();
+
+  INT8U err;
+  (void)OSSemDel(wq->wake, OS_DEL_ALWAYS, &err);
+  return osOK;
+#else
+  (void)wq_id;
+  return osError;
+#endif
+}
+
+/* ==== Thread Pool ==== */
+
+#if (UCOS2_POOL_EN > 0u)
+os_ucos2_pool_t *osUcos2PoolFromId(osPoolId_t pool_id) {
+  if (pool_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos2_pool_t *pool = (os_ucos2_pool_t *)pool_id;
+  return ((pool->object.type == osUcos2ObjectPool) && pool->created) ? pool : NULL;
+}
+
+/* The worker running the caller, or NULL for any other thread. */
+static os_ucos2_pool_worker_t *osUcos2PoolSelf(os_ucos2_pool_t *pool) {
+  if (osUcos2IrqContext() || (OSTCBCur == NULL)) {
+    return NULL;
+  }
+
+  os_ucos2_pool_worker_t *self = (os_ucos2_pool_worker_t *)osUcos2ThreadFromExt(OSTCBCur);
+  for (uint32_t i = 0u; i < pool->worker_count; ++i) {
+    if (self == &pool->workers[i]) {
+      return self;
+    }
+  }
+  return NULL;
+}
+
+/* Deque operations run with the scheduler locked: every caller is a thread,
+ * so this is enough to keep owners and thieves apart without masking
+ * interrupts. */
+static bool osUcos2PoolJobPush(os_ucos2_pool_worker_t *worker, osPoolFunc_t func, void *argument) {
+  if ((worker->bottom - worker->top) >= UCOS2_POOL_DEQUE) {
+    return false;
+  }
+  os_ucos2_pool_job_t *job = &worker->jobs[worker->bottom & (UCOS2_POOL_DEQUE - 1u)];
+  job->func = func;
+  job->argument = argument;
+  worker->bottom++;
+  return true;
+}
+
+/* Own deque newest first, for locality; then the oldest job of the next
+ * worker that has one, which is the largest piece of work left there. */
+static bool osUcos2PoolJobTake(os_ucos2_pool_t *pool, os_ucos2_pool_worker_t *self, os_ucos2_pool_job_t *job) {
+  if (self->bottom != self->top) {
+    self->bottom--;
+    *job = self->jobs[self->bottom & (UCOS2_POOL_DEQUE - 1u)];
+    return true;
+  }
+
+  uint32_t index = (uint32_t)(self - pool->workers);
+  for (uint32_t i = 1u; i < pool->worker_count; ++i) {
+    os_ucos2_pool_worker_t *victim = &pool->workers[(index + i) % pool->worker_count];
+    if (victim->bottom != victim->top) {
+      *job = victim->jobs[victim->top & (UCOS2_POOL_DEQUE - 1u)];
+      victim->top++;
+      pool->stolen++;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void osUcos2PoolThread(void *argument) {
+  os_ucos2_pool_worker_t *self = (os_ucos2_pool_worker_t *)argument;
+  os_ucos2_pool_t *pool = self->pool;
+
+  for (;;) {
+    INT8U err;
+    os_ucos2_pool_job_t job;
+    OSSchedLock();
+    bool found = osUcos2PoolJobTake(pool, self, &job);
+    if (!found) {
+      pool->idle++;
+    }
+    OSSchedUnlock();
+
+    if (!found) {
+      OSSemPend(pool->work_sem, 0u, &err);
+      continue;
+    }
+
+    job.func(job.argument);
+
+    OSSchedLock();
+    pool->executed++;
+    if (--pool->outstanding == 0u) {
+      (void)OSFlagPost(pool->done, (OS_FLAGS)1u, OS_FLAG_SET, &err);
+    }
+    OSSchedUnlock();
+  }
+}
+
+static osStatus_t osUcos2PoolWaitAll(os_ucos2_pool_t *pool, uint32_t timeout) {
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+  if (osUcos2PoolSelf(pool) != NULL) {
+    return osErrorResource;
+  }
+
+  INT8U err;
+  if (timeout == 0u) {
+    (void)OSFlagAccept(pool->done, (OS_FLAGS)1u, OS_FLAG_WAIT_SET_ANY, &err);
+  } else {
+    INT32U pend_timeout = (timeout == osWaitForever) ? 0u : timeout;
+    (void)OSFlagPend(pool->done, (OS_FLAGS)1u, OS_FLAG_WAIT_SET_ANY, pend_timeout, &err);
+  }
+  switch (err) {
+    case OS_ERR_NONE:
+      return osOK;
+    case OS_ERR_TIMEOUT:
+      return osErrorTimeout;
+    default:
+      return osErrorResource;
+  }
+}
+#endif
+
+osPoolId_t osPoolNew(const osPoolAttr_t *attr) {
+#if (UCOS2_POOL_EN > 0u)
+  uint32_t count = ((attr != NULL) && (attr->workers != 0u)) ? attr->workers : UCOS2_POOL_WORKERS;
+  if (osUcos2IrqContext() ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos2_pool_t)) ||
+      (attr->stack_mem == NULL) ||
+      (count > UCOS2_POOL_WORKERS)) {
+    return NULL;
+  }
+
+  uint32_t share = (attr->stack_size / count) & ~7u;
+  if (share < (64u * sizeof(OS_STK))) {     /* osUcos2StackWords minimum */
+    return NULL;
+  }
+
+  os_ucos2_pool_t *pool = (os_ucos2_pool_t *)attr->cb_mem;
+  memset(pool, 0, sizeof(*pool));
+  osUcos2ObjectInit(&pool->object, osUcos2ObjectPool, attr->name, 0u);
+
+  INT8U err;
+  pool->work_sem = OSSemCreate(0u);
+  if (pool->work_sem == NULL) {
+    return NULL;
+  }
+  pool->done = OSFlagCreate((OS_FLAGS)1u, &err);
+  if (pool->done == NULL) {
+    (void)OSSemDel(pool->work_sem, OS_DEL_ALWAYS, &err);
+    return NULL;
+  }
+
+  /* The workers start only after the pool is complete: they may outrank
+   * the caller. */
+  pool->worker_count = count;
+  pool->created = true;
+  osThreadAttr_t thread_attr = {
+    .name       = attr->name,
+    .cb_size    = sizeof(os_ucos2_thread_t),
+    .stack_size = share,
+    .priority   = attr->priority,
+  };
+  for (uint32_t i = 0u; i < count; ++i) {
+    pool->workers[i].pool = pool;
+    thread_attr.cb_mem = &pool->workers[i].thread;
+    thread_attr.stack_mem = (uint8_t *)attr->stack_mem + (i * share);
+    if (osThreadNew(osUcos2PoolThread, &pool->workers[i], &thread_attr) == NULL) {
+      pool->created = false;
+      while (i-- > 0u) {
+        (void)osThreadTerminate((osThreadId_t)&pool->workers[i].thread);
+      }
+      (void)OSFlagDel(pool->done, OS_DEL_ALWAYS, &err);
+      (void)OSSemDel(pool->work_sem, OS_DEL_ALWAYS, &err);
+      return NULL;
+    }
+  }
+  return (osPoolId_t)pool;
+#else
+  (void)attr;
+  return NULL;
+#endif
+}
+
+osStatus_t osPoolSubmit(osPoolId_t pool_id, osPoolFunc_t func, void *argument) {
+#if (UCOS2_POOL_EN > 0u)
+  os_ucos2_pool_t *pool = osUcos2PoolFromId(pool_id);
+  if ((pool == NULL) || (func == NULL)) {
+    return osErrorParameter;
+  }
+
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+  INT8U err;
+  os_ucos2_pool_worker_t *self = osUcos2PoolSelf(pool);
+  OSSchedLock();
+  bool queued = (self != NULL) && osUcos2PoolJobPush(self, func, argument);
+  for (uint32_t i = 0u; !queued && (i < pool->worker_count); ++i) {
+    os_ucos2_pool_worker_t *worker = &pool->workers[pool->next];
+    pool->next = (pool->next + 1u) % pool->worker_count;
+    queued = osUcos2PoolJobPush(worker, func, argument);
+  }
+  if (queued) {
+    pool->submitted++;
+    if (pool->outstanding++ == 0u) {
+      (void)OSFlagPost(pool->done, (OS_FLAGS)1u, OS_FLAG_CLR, &err);
+    }
+    if (pool->idle > 0u) {
+      pool->idle--;
+      (void)OSSemPost(pool->work_sem);
+    }
+  }
+  OSSchedUnlock();
+  return queued ? osOK : osErrorResource;
+#else
+  (void)pool_id;
+  (void)func;
+  (void)argument;
+  return osError;
+#endif
+}
+
+osStatus_t osPoolWaitAll(osPoolId_t pool_id, uint32_t timeout) {
+#if (UCOS2_POOL_EN > 0u)
+  os_ucos2_pool_t *pool = osUcos2PoolFromId(pool_id);
+  if (pool == NULL) {
+    return osErrorParameter;
+  }
+
+  UCOS2_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos2PoolWaitAll(pool, timeout);
+  UCOS2_WAIT_END(wait_start, osWaitKindPool, pool, timeout);
+  return status;
+#else
+  (void)pool_id;
+  (void)timeout;
+  return osError;
+#endif
+}
+
+osStatus_t osPoolGetStats(osPoolId_t pool_id, osPoolStats_t *stats) {
+#if (UCOS2_POOL_EN > 0u)
+  os_ucos2_pool_t *pool = osUcos2PoolFromId(pool_id);
+  if ((pool == NULL) || (stats == NULL)) {
+    return osErrorParameter;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  stats->submitted = pool->submitted;
+  stats->executed = pool->executed;
+  stats->stolen = pool->stolen;
+  stats->outstanding = pool->outstanding;
+  OS_EXIT_CRITICAL();
+  return osOK;
+#else
+  (void)pool_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+osStatus_t osPoolDelete(osPoolId_t pool_id) {
+#if (UCOS2_POOL_EN > 0u)
+  os_ucos2_pool_t *pool = osUcos2PoolFromId(pool_id);
+  if (pool == NULL) {
+    return osErrorParameter;
+  }
+
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+  if (osUcos2PoolSelf(pool) != NULL) {
+    return osErrorResource;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  pool->created = false;
+  OS_EXIT_CRITICAL();
+
+  for (uint32_t i = 0u; i < pool->worker_count; ++i) {
+    (void)osThreadTerminate((osThreadId_t)&pool->workers[i].thread);
+  }
+
+  /* Waiters in osPoolWaitAll return osErrorResource. */
+  INT8U err;
+  (void)OSFlagDel(pool->done, OS_DEL_ALWAYS, &err);
+  (void)OSSemDel(pool->work_sem, OS_DEL_ALWAYS, &err);
+  return osOK;
+#else
+  (void)pool_id;
+  return osError;
+#endif
+}
+
+/* ==== Coroutines ==== */
+
+#if (UCOS2_CORO_EN > 0u)
+os_ucos2_coro_sched_t *osUcos2CoroSchedFromId(osCoroSchedId_t sched_id) {
+  if (sched_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos2_coro_sched_t *sched = (os_ucos2_coro_sched_t *)sched_id;
+  return ((sched->object.type == osUcos2ObjectCoroSched) && sched->created) ? sched : NULL;
+}
+
+/* The awaited object's waiter list holds the coroutine's node while it is
+ * blocked; posts to the object then post the scheduler's wake semaphore. */
+static void osUcos2CoroLink(os_ucos2_coro_t *co) {
+  osObjectWaitSet_t set = { &co->wait, 1u, osObjectWaitPriority, 0u };
+  osUcos2WaitAnyLink(&set, &co->node, co->sched->wake);
+}
+
+/* Leaves pprev NULL, so unlinking again does nothing. */
+static void osUcos2CoroUnlink(os_ucos2_coro_t *co) {
+  osObjectWaitSet_t set = { &co->wait, 1u, osObjectWaitPriority, 0u };
+  osUcos2WaitAnyUnlink(&set, &co->node);
+  co->node.pprev = NULL;
+}
+
+/* A blocked coroutine resumes once its object is ready or its deadline has
+ * passed; *sleep is lowered to the ticks left otherwise. */
+static bool osUcos2CoroResumable(os_ucos2_coro_t *co, uint32_t now, uint32_t *sleep) {
+  if (co->state == osCoroReady) {
+    return true;
+  }
+
+  if ((co->wait.object != NULL) && osUcos2WaitAnyReady(&co->wait)) {
+    co->co.result = osOK;
+  } else if (co->timed && ((int32_t)(now - co->deadline) >= 0)) {
+    co->co.result = osErrorTimeout;
+  } else {
+    if (co->timed && ((co->deadline - now) < *sleep)) {
+      *sleep = co->deadline - now;
+    }
+    return false;
+  }
+
+  osUcos2CoroUnlink(co);
+  return true;
+}
+
+/* Each pass runs every coroutine that can make progress, in list order. The
+ * thread blocks only after a pass in which none could, so a post that
+ * arrives while a pass is running is seen by the next one. Posts that piled
+ * up while it was blocked are cleared on wake-up: the pass that follows
+ * checks every coroutine anyway. */
+static void osUcos2CoroThread(void *argument) {
+  os_ucos2_coro_sched_t *sched = (os_ucos2_coro_sched_t *)argument;
+
+  for (;;) {
+#if OS_CRITICAL_METHOD == 3u
+    OS_CPU_SR cpu_sr = 0u;
+#endif
+    OS_ENTER_CRITICAL();
+    os_ucos2_coro_t *incoming = sched->incoming;
+    sched->incoming = NULL;
+    OS_EXIT_CRITICAL();
+    while (incoming != NULL) {
+      os_ucos2_coro_t *co = incoming;
+      incoming = co->next;
+      co->next = sched->head;
+      sched->head = co;
+    }
+
+    const uint32_t now = osKernelGetTickCount();
+    uint32_t sleep = osWaitForever;
+    bool ran = false;
+    os_ucos2_coro_t **link = &sched->head;
+    while (*link != NULL) {
+      os_ucos2_coro_t *co = *link;
+      if (!osUcos2CoroResumable(co, now, &sleep)) {
+        link = &co->next;
+        continue;
+      }
+
+      ran = true;
+      co->state = osCoroReady;
+      sched->resumed++;
+      uint32_t state = co->func(&co->co, co->argument);
+      if (state == osCoroExited) {
+        *link = co->next;
+        OS_ENTER_CRITICAL();
+        sched->coroutines--;
+        OS_EXIT_CRITICAL();
+        continue;
+      }
+      if ((state == osCoroBlocked) && (co->state == osCoroBlocked) && (co->wait.object != NULL)) {
+        osUcos2CoroLink(co);
+      }
+      link = &co->next;
+    }
+
+    if (!ran) {
+      INT8U err;
+      OSSemPend(sched->wake, (sleep == osWaitForever) ? 0u : (INT32U)sleep, &err);
+      OSSemSet(sched->wake, 0u, &err);
+      sched->wakeups++;
+    }
+  }
+}
+#endif
+
+osCoroSchedId_t osCoroSchedNew(const osCoroSchedAttr_t *attr) {
+#if (UCOS2_CORO_EN > 0u)
+  if (osUcos2IrqContext() ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos2_coro_sched_t)) ||
+      (attr->stack_mem == NULL) ||
+      (attr->stack_size < (64u * sizeof(OS_STK)))) {     /* osUcos2StackWords minimum */
+    return NULL;
+  }
+
+  os_ucos2_coro_sched_t *sched = (os_ucos2_coro_sched_t *)attr->cb_mem;
+  memset(sched, 0, sizeof(*sched));
+  osUcos2ObjectInit(&sched->object, osUcos2ObjectCoroSched, attr->name, 0u);
+
+  INT8U err;
+  sched->wake = OSSemCreate(0u);
+  if (sched->wake == NULL) {
+    return NULL;
+  }
+
+  sched->created = true;
+  const osThreadAttr_t thread_attr = {
+    .name       = attr->name,
+    .cb_mem     = &sched->thread,
+    .cb_size    = sizeof(sched->thread),
+    .stack_mem  = attr->stack_mem,
+    .stack_size = attr->stack_size,
+    .priority   = (attr->priority != osPriorityNone) ? attr->priority : osPriorityNormal,
+  };
+  if (osThreadNew(osUcos2CoroThread, sched, &thread_attr) == NULL) {
+    sched->created = false;
+    (void)OSSemDel(sched->wake, OS_DEL_ALWAYS, &err);
+    return NULL;
+  }
+  return (osCoroSchedId_t)sched;
+#else
+  (void)attr;
+  return NULL;
+#endif
+}
+
+osStatus_t osCoroNew(osCoroSchedId_t sched_id, osCoroFunc_t func, void *argument, void *cb_mem, uint32_t cb_size) {
+#if (UCOS2_CORO_EN > 0u)
+  os_ucos2_coro_sched_t *sched = osUcos2CoroSchedFromId(sched_id);
+  if ((sched == NULL) || (func == NULL) || (cb_mem == NULL) || (cb_size < sizeof(os_ucos2_coro_t))) {
+    return osErrorParameter;
+  }
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+  os_ucos2_coro_t *co = (os_ucos2_coro_t *)cb_mem;
+  memset(co, 0, sizeof(*co));
+  co->sched = sched;
+  co->func = func;
+  co->argument = argument;
+  co->state = osCoroReady;
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  co->next = sched->incoming;
+  sched->incoming = co;
+  sched->coroutines++;
+  OS_EXIT_CRITICAL();
+
+  (void)OSSemPost(sched->wake);
+  return osOK;
+#else
+  (void)sched_id;
+  (void)func;
+  (void)argument;
+  (void)cb_mem;
+  (void)cb_size;
+  return osError;
+#endif
+}
+
+osStatus_t osCoroWaitFor(osCoro_t *co, void *object, uint32_t flags, uint32_t options, uint32_t timeout) {
+#if (UCOS2_CORO_EN > 0u)
+  if (co == NULL) {
+    return osErrorParameter;
+  }
+
+  /* A bad object resumes the coroutine in the next pass with the error. */
+  os_ucos2_coro_t *cb = (os_ucos2_coro_t *)co;
+  if ((object != NULL) &&
+      ((osUcos2WaitAnyHead(object) == NULL) ||
+       ((osUcos2EventFlagsFromId(object) != NULL) &&
+        (!osUcos2FlagsValid(flags) || !osUcos2FlagsOptionsValid(options))))) {
+    co->result = osErrorParameter;
+    cb->state = osCoroReady;
+    return osErrorParameter;
+  }
+
+  cb->wait.object = object;
+  cb->wait.flags = flags;
+  cb->wait.options = options;
+  cb->timed = (timeout != osWaitForever);
+  cb->deadline = osKernelGetTickCount() + timeout;
+  cb->state = osCoroBlocked;
+  return osOK;
+#else
+  (void)co;
+  (void)object;
+  (void)flags;
+  (void)options;
+  (void)timeout;
+  return osError;
+#endif
+}
+
+osStatus_t osCoroSchedGetStats(osCoroSchedId_t sched_id, osCoroSchedStats_t *stats) {
+#if (UCOS2_CORO_EN > 0u)
+  os_ucos2_coro_sched_t *sched = osUcos2CoroSchedFromId(sched_id);
+  if ((sched == NULL) || (stats == NULL)) {
+    return osErrorParameter;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  stats->coroutines = sched->coroutines;
+  stats->resumed = sched->resumed;
+  stats->wakeups = sched->wakeups;
+  OS_EXIT_CRITICAL();
+  return osOK;
+#else
+  (void)sched_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+osStatus_t osCoroSchedDelete(osCoroSchedId_t sched_id) {
+#if (UCOS2_CORO_EN > 0u)
+  os_ucos2_coro_sched_t *sched = osUcos2CoroSchedFromId(sched_id);
+  if (sched == NULL) {
+    return osErrorParameter;
+  }
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+  if (osThreadGetId() == (osThreadId_t)&sched->thread) {
+    return osErrorResource;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  sched->created = false;
+  OS_EXIT_CRITICAL();
+
+  (void)osThreadTerminate((osThreadId_t)&sched->thread);
+  for (os_ucos2_coro_t *co = sched->head; co != NULL; co = co->next) {
+    osUcos2CoroUnlink(co);
+  }
+  sched->head = NULL;
+  sched->incoming = NULL;
+  sched->coroutines = 0u;
+
+  INT8U err;
+  (void)OSSemDel(sched->wake, OS_DEL_ALWAYS, &err);
+  return osOK;
+#else
+  (void)sched_id;
+  return osError;
+#endif
+}
+
+/* ==== Active Objects ==== */
+
+#if (UCOS2_ACTIVE_EN > 0u)
+os_ucos2_active_t *osUcos2ActiveFromId(osActiveId_t ao_id) {
+  if (ao_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos2_active_t *ao = (os_ucos2_active_t *)ao_id;
+  return ((ao->object.type == osUcos2ObjectActive) && ao->created) ? ao : NULL;
+}
+
+static bool osUcos2ActiveFlag(uint32_t *flag, uint32_t from, uint32_t to) {
+#if (UCOS2_LOCKFREE_EN > 0u)
+  return UCOS2_ATOMIC_CAS(flag, &from, to);
+#else
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  bool ok = (*flag == from);
+  if (ok) {
+    *flag = to;
+  }
+  OS_EXIT_CRITICAL();
+  return ok;
+#endif
+}
+
+/* Bounded multi-producer queue: a producer owns a slot once it has moved
+ * tail past it, and publishes the event by advancing the slot's sequence.
+ * A slot still holding the event of the previous lap means the queue is
+ * full. *depth is the number of events queued after this one. */
+static bool osUcos2ActivePush(os_ucos2_active_t *ao, osEvent_t *event, uint32_t *depth) {
+#if (UCOS2_LOCKFREE_EN > 0u)
+  uint32_t pos = *(volatile uint32_t *)&ao->tail;
+  for (;;) {
+    os_ucos2_active_slot_t *slot = &ao->slots[pos & (UCOS2_ACTIVE_QUEUE - 1u)];
+    int32_t diff = (int32_t)(*(volatile uint32_t *)&slot->seq - pos);
+    if (diff < 0) {
+      return false;
+    }
+    if (diff > 0) {
+      pos = *(volatile uint32_t *)&ao->tail;
+    } else if (UCOS2_ATOMIC_CAS(&ao->tail, &pos, pos + 1u)) {
+      slot->event = event;
+      (void)UCOS2_ATOMIC_ADD(&slot->seq, 1u);
+      *depth = pos + 1u - *(volatile uint32_t *)&ao->head;
+      return true;
+    }
+  }
+#else
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  uint32_t pos = ao->tail;
+  os_ucos2_active_slot_t *slot = &ao->slots[pos & (UCOS2_ACTIVE_QUEUE - 1u)];
+  bool ok = (slot->seq == pos);
+  if (ok) {
+    slot->event = event;
+    slot->seq = pos + 1u;
+    ao->tail = pos + 1u;
+    *depth = ao->tail - ao->head;
+  }
+  OS_EXIT_CRITICAL();
+  return ok;
+#endif
+}
+
+/* Called by the active object's thread only, with the scheduler locked, and
+ * by osActiveDelete once the thread is gone. The taken event stays in
+ * current until the thread has released it. */
+static osEvent_t *osUcos2ActiveTake(os_ucos2_active_t *ao) {
+  os_ucos2_active_slot_t *slot = &ao->slots[ao->head & (UCOS2_ACTIVE_QUEUE - 1u)];
+  if (*(volatile uint32_t *)&slot->seq != (ao->head + 1u)) {
+    return NULL;
+  }
+
+  osEvent_t *event = slot->event;
+#if (UCOS2_LOCKFREE_EN > 0u)
+  (void)UCOS2_ATOMIC_ADD(&slot->seq, UCOS2_ACTIVE_QUEUE - 1u);
+#else
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  slot->seq += UCOS2_ACTIVE_QUEUE - 1u;
+  OS_EXIT_CRITICAL();
+#endif
+  ao->head++;
+  ao->current = event;
+  return event;
+}
+
+/* osActiveDelete runs in another thread, so with the scheduler locked it
+ * cannot terminate this one between taking an event and recording it, or
+ * between releasing it and clearing current. */
+static osEvent_t *osUcos2ActiveClaim(os_ucos2_active_t *ao) {
+  OSSchedLock();
+  osEvent_t *event = osUcos2ActiveTake(ao);
+  OSSchedUnlock();
+  return event;
+}
+
+static void osUcos2ActiveDone(os_ucos2_active_t *ao, osEvent_t *event) {
+  OSSchedLock();
+  ao->current = NULL;
+  if (event->buf.pool != NULL) {
+    (void)osBufferRelease(&event->buf);
+  }
+  OSSchedUnlock();
+}
+
+/* The thread raises waiting before its last look at the queue, and the
+ * producer that lowers it posts wake, so an event published between that
+ * look and the pend is not missed. A post left over from a look that did
+ * find an event costs one empty pass. */
+static osEvent_t *osUcos2ActiveNext(os_ucos2_active_t *ao) {
+  for (;;) {
+    osEvent_t *event = osUcos2ActiveClaim(ao);
+    if (event != NULL) {
+      return event;
+    }
+
+    (void)osUcos2ActiveFlag(&ao->waiting, 0u, 1u);
+    event = osUcos2ActiveClaim(ao);
+    if (event != NULL) {
+      (void)osUcos2ActiveFlag(&ao->waiting, 1u, 0u);
+      return event;
+    }
+
+    INT8U err;
+    OSSemPend(ao->wake, 0u, &err);
+  }
+}
+
+/* Each event runs to completion before the next one is taken; the queue's
+ * reference to a dynamic event is dropped after the handler returns. */
+static void osUcos2ActiveThread(void *argument) {
+  os_ucos2_active_t *ao = (os_ucos2_active_t *)argument;
+
+  for (;;) {
+    osEvent_t *event = osUcos2ActiveNext(ao);
+    ao->handler((osActiveId_t)ao, event, ao->argument);
+    ao->dispatched++;
+    osUcos2ActiveDone(ao, event);
+  }
+}
+
+/* Runs in the tick hook; a time event is armed while ctr is non-zero. The
+ * critical section only counts down, reloads or unlinks expired events and
+ * chains them through due; they are posted after it, with interrupts
+ * enabled, in list order. */
+static void osUcos2TimeEventTick(void) {
+  osTimeEvent_t *expired = NULL;
+  osTimeEvent_t **tail = &expired;
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  osTimeEvent_t **link = &os_ucos2_kernel.time_events;
+  while (*link != NULL) {
+    osTimeEvent_t *te = *link;
+    if (--te->ctr != 0u) {
+      link = &te->next;
+      continue;
+    }
+
+    if (te->interval != 0u) {
+      te->ctr = te->interval;
+      link = &te->next;
+    } else {
+      *link = te->next;
+      te->next = NULL;
+    }
+    te->due = NULL;
+    *tail = te;
+    tail = &te->due;
+  }
+  OS_EXIT_CRITICAL();
+
+  for (osTimeEvent_t *te = expired; te != NULL; te = te->due) {
+    (void)osActivePost(te->target, &te->event);
+  }
+}
+
+/* Unlinks the armed time events that match; target NULL matches all. */
+static uint32_t osUcos2TimeEventUnlink(const osTimeEvent_t *match, osActiveId_t target) {
+  uint32_t count = 0u;
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  osTimeEvent_t **link = &os_ucos2_kernel.time_events;
+  while (*link != NULL) {
+    osTimeEvent_t *te = *link;
+    if ((te == match) || ((match == NULL) && (te->target == target))) {
+      *link = te->next;
+      te->next = NULL;
+      te->ctr = 0u;
+      count++;
+    } else {
+      link = &te->next;
+    }
+  }
+  OS_EXIT_CRITICAL();
+  return count;
+}
+#endif
+
+osEvent_t *osEventNew(osMemoryPoolId_t mp_id, uint32_t signal, uint32_t timeout) {
+#if (UCOS2_ACTIVE_EN > 0u)
+  if (osMemoryPoolGetBlockSize(mp_id) < sizeof(osEvent_t)) {
+    return NULL;
+  }
+
+  osEvent_t *event = (osEvent_t *)osBufferAlloc(mp_id, timeout);
+  if (event != NULL) {
+    event->signal = signal;
+  }
+  return event;
+#else
+  (void)mp_id;
+  (void)signal;
+  (void)timeout;
+  return NULL;
+#endif
+}
+
+osStatus_t osEventRelease(osEvent_t *event) {
+#if (UCOS2_ACTIVE_EN > 0u)
+  if (event == NULL) {
+    return osErrorParameter;
+  }
+  return (event->buf.pool != NULL) ? osBufferRelease(&event->buf) : osOK;
+#else
+  (void)event;
+  return osError;
+#endif
+}
+
+osActiveId_t osActiveNew(osActiveHandler_t handler, void *argument, const osActiveAttr_t *attr) {
+#if (UCOS2_ACTIVE_EN > 0u)
+  if (osUcos2IrqContext() ||
+      (handler == NULL) ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos2_active_t)) ||
+      (attr->stack_mem == NULL) ||
+      (attr->stack_size < (64u * sizeof(OS_STK)))) {     /* osUcos2StackWords minimum */
+    return NULL;
+  }
+
+  os_ucos2_active_t *ao = (os_ucos2_active_t *)attr->cb_mem;
+  memset(ao, 0, sizeof(*ao));
+  osUcos2ObjectInit(&ao->object, osUcos2ObjectActive, attr->name, 0u);
+  ao->handler = handler;
+  ao->argument = argument;
+  for (uint32_t i = 0u; i < UCOS2_ACTIVE_QUEUE; ++i) {
+    ao->slots[i].seq = i;
+  }
+
+  INT8U err;
+  ao->wake = OSSemCreate(0u);
+  if (ao->wake == NULL) {
+    return NULL;
+  }
+
+  ao->created = true;
+  const osThreadAttr_t thread_attr = {
+    .name       = attr->name,
+    .cb_mem     = &ao->thread,
+    .cb_size    = sizeof(ao->thread),
+    .stack_mem  = attr->stack_mem,
+    .stack_size = attr->stack_size,
+    .priority   = (attr->priority != osPriorityNone) ? attr->priority : osPriorityNormal,
+  };
+  if (osThreadNew(osUcos2ActiveThread, ao, &thread_attr) == NULL) {
+    ao->created = false;
+    (void)OSSemDel(ao->wake, OS_DEL_ALWAYS, &err);
+    return NULL;
+  }
+  return (osActiveId_t)ao;
+#else
+  (void)handler;
+  (void)argument;
+  (void)attr;
+  return NULL;
+#endif
+}
+
+osStatus_t osActivePost(osActiveId_t ao_id, osEvent_t *event) {
+#if (UCOS2_ACTIVE_EN > 0u)
+  os_ucos2_active_t *ao = osUcos2ActiveFromId(ao_id);
+  if ((ao == NULL) || (event == NULL)) {
+    return osErrorParameter;
+  }
+
+  /* As with osBufferPut, the queue's reference is taken before the event
+   * becomes visible to the thread. */
+  const bool dynamic = (event->buf.pool != NULL);
+  if (dynamic && (osBufferRetain(&event->buf, 1u) != osOK)) {
+    return osErrorResource;
+  }
+
+  uint32_t depth;
+  if (!osUcos2ActivePush(ao, event, &depth)) {
+    osUcos2StatCount(&ao->dropped, NULL, 0u);
+    if (dynamic) {
+      (void)osBufferRelease(&event->buf);
+    }
+    return osErrorResource;
+  }
+  osUcos2StatCount(&ao->posted, &ao->max_queued, depth);
+
+  if (osUcos2ActiveFlag(&ao->waiting, 1u, 0u)) {
+    (void)OSSemPost(ao->wake);
+  }
+  return osOK;
+#else
+  (void)ao_id;
+  (void)event;
+  return osError;
+#endif
+}
+
+osStatus_t osTimeEventArm(osTimeEvent_t *te, uint32_t ticks, uint32_t interval) {
+#if (UCOS2_ACTIVE_EN > 0u)
+  if ((te == NULL) || (ticks == 0u) || (te->event.buf.pool != NULL) ||
+      (osUcos2ActiveFromId(te->target) == NULL)) {
+    return osErrorParameter;
+  }
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  if (te->ctr == 0u) {
+    te->next = os_ucos2_kernel.time_events;
+    os_ucos2_kernel.time_events = te;
+  }
+  te->ctr = ticks;
+  te->interval = interval;
+  OS_EXIT_CRITICAL();
+  return osOK;
+#else
+  (void)te;
+  (void)ticks;
+  (void)interval;
+  return osError;
+#endif
+}
+
+osStatus_t osTimeEventDisarm(osTimeEvent_t *te) {
+#if (UCOS2_ACTIVE_EN > 0u)
+  if (te == NULL) {
+    return osErrorParameter;
+  }
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+  return (osUcos2TimeEventUnlink(te, NULL) != 0u) ? osOK : osErrorResource;
+#else
+  (void)te;
+  return osError;
+#endif
+}
+
+osStatus_t osActiveGetStats(osActiveId_t ao_id, osActiveStats_t *stats) {
+#if (UCOS2_ACTIVE_EN > 0u)
+  os_ucos2_active_t *ao = osUcos2ActiveFromId(ao_id);
+  if ((ao == NULL) || (stats == NULL)) {
+    return osErrorParameter;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  stats->posted = ao->posted;
+  stats->dispatched = ao->dispatched;
+  stats->dropped = ao->dropped;
+  stats->max_queued = ao->max_queued;
+  OS_EXIT_CRITICAL();
+  return osOK;
+#else
+  (void)ao_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+osStatus_t osActiveDelete(osActiveId_t ao_id) {
+#if (UCOS2_ACTIVE_EN > 0u)
+  os_ucos2_active_t *ao = osUcos2ActiveFromId(ao_id);
+  if (ao == NULL) {
+    return osErrorParameter;
+  }
+  if (osUcos2IrqContext()) {
+    return osErrorISR;
+  }
+  if (osThreadGetId() == (osThreadId_t)&ao->thread) {
+    return osErrorResource;
+  }
+
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  ao->created = false;
+  OS_EXIT_CRITICAL();
+
+  (void)osThreadTerminate((osThreadId_t)&ao->thread);
+  (void)osUcos2TimeEventUnlink(NULL, ao_id);
+  if ((ao->current != NULL) && (ao->current->buf.pool != NULL)) {
+    (void)osBufferRelease(&ao->current->buf);
+  }
+  for (osEvent_t *event = osUcos2ActiveTake(ao); event != NULL; event = osUcos2ActiveTake(ao)) {
+    if (event->buf.pool != NULL) {
+      (void)osBufferRelease(&event->buf);
+    }
+  }
+
+  INT8U err;
+  (void)OSSemDel(ao->wake, OS_DEL_ALWAYS, &err);
+  return osOK;
+#else
+  (void)ao_id;
+  return osError;
+#endif
+}
@@ -10,6 +10,7 @@ extern "C" {
 #include <stdint.h>
 
 #include "cmsis_os2.h"
+#include "cmsis_os2_ext.h"
 #include "os.h"
 
 /*
@@ -60,6 +61,377 @@ extern "C" {
 #define UCOS3_THREAD_DEFAULT_STACK   512u
 #endif
 
+/* Words zeroed at the far end of the stack for osThreadStackPaint threads */
+#ifndef UCOS3_STACK_PAINT_WORDS
+#define UCOS3_STACK_PAINT_WORDS      64u
+#endif
+
+/* Create threads with OS_OPT_TASK_SAVE_FP unless they carry osThreadNoFpu */
+#ifndef UCOS3_THREAD_SAVE_FP
+#define UCOS3_THREAD_SAVE_FP         1u
+#endif
+
+/* Thread-local storage slots live in the kernel TLS table (OS_TCB.TLS_Tbl[]) */
+#if defined(OS_CFG_TLS_TBL_SIZE) && (OS_CFG_TLS_TBL_SIZE > 0u)
+#define UCOS3_TLS_SLOTS                OS_CFG_TLS_TBL_SIZE
+#else
+#define UCOS3_TLS_SLOTS                0u
+#endif
+
+/*
+ * Background stack profiler: a low priority CMSIS thread that walks every
+ * thread's stack watermark UCOS3_STACK_PROFILER_CHUNK_WORDS words at a time
+ * with the scheduler locked, sleeping UCOS3_STACK_PROFILER_PERIOD_TICKS
+ * between steps, so no single scan adds noticeable latency.
+ */
+#ifndef UCOS3_STACK_PROFILER_EN
+#define UCOS3_STACK_PROFILER_EN           0u
+#endif
+
+#ifndef UCOS3_STACK_PROFILER_CHUNK_WORDS
+#define UCOS3_STACK_PROFILER_CHUNK_WORDS  32u
+#endif
+
+#ifndef UCOS3_STACK_PROFILER_PERIOD_TICKS
+#define UCOS3_STACK_PROFILER_PERIOD_TICKS 10u
+#endif
+
+#ifndef UCOS3_STACK_PROFILER_PRIORITY
+#define UCOS3_STACK_PROFILER_PRIORITY     osPriorityIdle
+#endif
+
+#ifndef UCOS3_STACK_PROFILER_STACK
+#define UCOS3_STACK_PROFILER_STACK        512u
+#endif
+
+#if (UCOS3_STACK_PROFILER_EN > 0u) && (UCOS3_STACK_PROFILER_CHUNK_WORDS == 0u)
+#error "UCOS3_STACK_PROFILER_CHUNK_WORDS must be non-zero."
+#endif
+
+/*
+ * Lock-free fast paths. With UCOS3_LOCKFREE_EN the wrapper updates shared
+ * words from threads and ISRs with UCOS3_ATOMIC_CAS()/UCOS3_ATOMIC_ADD()
+ * instead of short critical sections: the memory pool free stack, slab
+ * statistics, buffer reference counts, work queue submission and active
+ * object queues. Cores without exclusive load/store (Armv6-M) default to 0,
+ * as GCC would turn the CAS into library calls newlib does not provide.
+ * UCOS3_MEMPOOL_LOCKFREE is the deprecated name of the same option.
+ *
+ * Memory pools (osMemoryPool*) keep their free blocks on a stack of 16-bit
+ * block indices linked through free_stack. Lock-free, the stack head carries
+ * an ABA tag, so alloc and free never disable interrupts and the kernel is
+ * entered only to block on or wake an empty pool.
+ */
+#ifndef UCOS3_LOCKFREE_EN
+#if defined(UCOS3_MEMPOOL_LOCKFREE)
+#define UCOS3_LOCKFREE_EN              UCOS3_MEMPOOL_LOCKFREE
+#elif defined(__ARM_ARCH_6M__) || (defined(__arm__) && !defined(__ARM_FEATURE_LDREX))
+#define UCOS3_LOCKFREE_EN              0u
+#else
+#define UCOS3_LOCKFREE_EN              1u
+#endif
+#endif
+
+#ifndef UCOS3_MEMPOOL_LOCKFREE
+#define UCOS3_MEMPOOL_LOCKFREE         UCOS3_LOCKFREE_EN
+#elif ((UCOS3_MEMPOOL_LOCKFREE > 0u) != (UCOS3_LOCKFREE_EN > 0u))
+#error "UCOS3_MEMPOOL_LOCKFREE is a deprecated alias of UCOS3_LOCKFREE_EN; set only UCOS3_LOCKFREE_EN."
+#endif
+
+#if (UCOS3_LOCKFREE_EN > 0u)
+#if defined(__GNUC__)
+#ifndef UCOS3_ATOMIC_CAS
+#define UCOS3_ATOMIC_CAS(p, expected, desired) \
+  __atomic_compare_exchange_n((p), (expected), (desired), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#endif
+#ifndef UCOS3_ATOMIC_ADD
+#define UCOS3_ATOMIC_ADD(p, v)           __atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+#endif
+#endif
+#if !defined(UCOS3_ATOMIC_CAS) || !defined(UCOS3_ATOMIC_ADD)
+#error "Define UCOS3_ATOMIC_CAS(p, expected, desired) and UCOS3_ATOMIC_ADD(p, v) for uint32_t, or set UCOS3_LOCKFREE_EN to 0."
+#endif
+#endif
+
+/*
+ * Slab allocator (osSlab*, cmsis_os2_ext.h): each block-size class is a
+ * memory pool on caller-provided storage. UCOS3_SLAB_CLASSES is the most
+ * classes one slab can have and sizes os_ucos3_slab_t.
+ */
+#ifndef UCOS3_SLAB_CLASSES
+#define UCOS3_SLAB_CLASSES             8u
+#endif
+
+#if (UCOS3_SLAB_CLASSES == 0u)
+#error "UCOS3_SLAB_CLASSES must be non-zero."
+#endif
+
+/*
+ * Topic bus (osTopic*, cmsis_os2_ext.h): subscribers of a topic live in one
+ * array of UCOS3_TOPIC_SUBSCRIBERS entries inside os_ucos3_topic_t.
+ */
+#ifndef UCOS3_TOPIC_SUBSCRIBERS
+#define UCOS3_TOPIC_SUBSCRIBERS        8u
+#endif
+
+#if (UCOS3_TOPIC_SUBSCRIBERS == 0u)
+#error "UCOS3_TOPIC_SUBSCRIBERS must be non-zero."
+#endif
+
+/*
+ * Per-thread CPU usage (cmsis_os2_ext.h). Cycles are charged from the task
+ * switch hook; the load is averaged over a sliding window of
+ * UCOS3_CPU_USAGE_WINDOW_TICKS split into UCOS3_CPU_USAGE_SLOTS slots.
+ */
+#ifndef UCOS3_CPU_USAGE_EN
+#define UCOS3_CPU_USAGE_EN             0u
+#endif
+
+#ifndef UCOS3_CPU_USAGE_WINDOW_TICKS
+#define UCOS3_CPU_USAGE_WINDOW_TICKS   1000u
+#endif
+
+#ifndef UCOS3_CPU_USAGE_SLOTS
+#define UCOS3_CPU_USAGE_SLOTS          4u
+#endif
+
+#define UCOS3_CPU_USAGE_RING           (UCOS3_CPU_USAGE_SLOTS + 1u)
+
+/*
+ * Binary trace recorder (cmsis_os2_ext.h): API calls, context switches,
+ * blocking and wakeups go into a ring of UCOS3_TRACE_EVENTS 16-byte records.
+ * Writers reserve a slot with UCOS3_TRACE_ATOMIC_INC() and never lock, so
+ * ISRs can record too; the oldest records are overwritten when the reader
+ * falls behind. Each slot also has a sequence word (4 more bytes) that
+ * marks it complete. With UCOS3_TRACE_EN == 0 the instrumentation compiles away.
+ */
+#ifndef UCOS3_TRACE_EN
+#define UCOS3_TRACE_EN                 0u
+#endif
+
+#ifndef UCOS3_TRACE_EVENTS
+#define UCOS3_TRACE_EVENTS             512u
+#endif
+
+#if (UCOS3_TRACE_EN > 0u)
+#if (UCOS3_TRACE_EVENTS == 0u) || ((UCOS3_TRACE_EVENTS & (UCOS3_TRACE_EVENTS - 1u)) != 0u)
+#error "UCOS3_TRACE_EVENTS must be a power of two."
+#endif
+#ifndef UCOS3_TRACE_ATOMIC_INC
+#if defined(__GNUC__)
+#define UCOS3_TRACE_ATOMIC_INC(p)      __atomic_fetch_add((p), 1u, __ATOMIC_RELAXED)
+#else
+#error "Define UCOS3_TRACE_ATOMIC_INC(p) (atomic fetch-and-increment of a uint32_t) for this compiler."
+#endif
+#endif
+#endif
+
+/*
+ * Tick sampling profiler (cmsis_os2_ext.h): on every tick the time tick hook
+ * stores the running task and, when UCOS3_PROFILER_PC() is defined, the
+ * program counter the tick interrupt preempted into a ring of
+ * UCOS3_PROFILER_SAMPLES 16-byte samples. The tick interrupt is the only
+ * writer, so a sample is a few stores with no lock; the oldest samples are
+ * overwritten when the reader falls behind.
+ */
+#ifndef UCOS3_PROFILER_EN
+#define UCOS3_PROFILER_EN              0u
+#endif
+
+#ifndef UCOS3_PROFILER_SAMPLES
+#define UCOS3_PROFILER_SAMPLES         1024u
+#endif
+
+#if (UCOS3_PROFILER_EN > 0u)
+#if (UCOS3_PROFILER_SAMPLES == 0u) || ((UCOS3_PROFILER_SAMPLES & (UCOS3_PROFILER_SAMPLES - 1u)) != 0u)
+#error "UCOS3_PROFILER_SAMPLES must be a power of two."
+#endif
+/* Return the interrupted PC, e.g. the one stacked by the tick exception and
+ * saved by the SysTick handler; samples carry 0 when not defined. */
+#ifndef UCOS3_PROFILER_PC
+#define UCOS3_PROFILER_PC()            0u
+#endif
+#endif
+
+/*
+ * Priority inversion detector (cmsis_os2_ext.h): a thread that blocks on a
+ * mutex or binary semaphore held by a thread of lower base priority adds the
+ * wait time to that object's statistics.
+ * UCOS3_INVERSION_HOOK(object, waiter, holder) runs in thread context when an
+ * inversion is detected, e.g. to log it or to break into the debugger.
+ */
+#ifndef UCOS3_INVERSION_EN
+#define UCOS3_INVERSION_EN             0u
+#endif
+
+#ifndef UCOS3_INVERSION_HOOK
+#define UCOS3_INVERSION_HOOK(object, waiter, holder) ((void)(object), (void)(waiter), (void)(holder))
+#endif
+
+/*
+ * Per-thread wait statistics (cmsis_os2_ext.h): every blocking call charges
+ * its duration to a table of UCOS3_WAIT_STATS_SLOTS entries in the thread,
+ * one per object; waits beyond the table share the last entry.
+ */
+#ifndef UCOS3_WAIT_STATS_EN
+#define UCOS3_WAIT_STATS_EN            0u
+#endif
+
+#ifndef UCOS3_WAIT_STATS_SLOTS
+#define UCOS3_WAIT_STATS_SLOTS         8u
+#endif
+
+#if (UCOS3_WAIT_STATS_EN > 0u) && (UCOS3_WAIT_STATS_SLOTS < 2u)
+#error "UCOS3_WAIT_STATS_SLOTS must be at least 2."
+#endif
+
+/*
+ * Waiting on several objects (osObjectWaitAny, cmsis_os2_ext.h): a waiter
+ * links one node per object into the semaphores, message queues and event
+ * flags it watches, and every post to such an object wakes the linked
+ * waiters. UCOS3_WAIT_ANY_MAX bounds the objects per call (nodes live on
+ * the caller's stack).
+ */
+#ifndef UCOS3_WAIT_ANY_EN
+#define UCOS3_WAIT_ANY_EN              0u
+#endif
+
+#ifndef UCOS3_WAIT_ANY_MAX
+#define UCOS3_WAIT_ANY_MAX             8u
+#endif
+
+#if (UCOS3_WAIT_ANY_EN > 0u) && (UCOS3_WAIT_ANY_MAX == 0u)
+#error "UCOS3_WAIT_ANY_MAX must be non-zero."
+#endif
+
+/*
+ * Thread mailboxes (osThreadMessagePut/Get, cmsis_os2_ext.h): a thread
+ * created with osThreadMailbox gets a uC/OS-III task message queue of
+ * UCOS3_MAILBOX_DEPTH pointer messages. The OS_MSG entries come from the
+ * shared OS_CFG_MSG_POOL_SIZE pool, so an empty mailbox costs no memory.
+ */
+#ifndef UCOS3_MAILBOX_EN
+#define UCOS3_MAILBOX_EN               0u
+#endif
+
+#ifndef UCOS3_MAILBOX_DEPTH
+#define UCOS3_MAILBOX_DEPTH            8u
+#endif
+
+#if (UCOS3_MAILBOX_EN > 0u) && (UCOS3_MAILBOX_DEPTH == 0u)
+#error "UCOS3_MAILBOX_DEPTH must be non-zero."
+#endif
+#if (UCOS3_MAILBOX_EN > 0u) && (OS_CFG_TASK_Q_EN == 0u)
+#error "Enable OS_CFG_TASK_Q_EN for thread mailboxes."
+#endif
+
+/*
+ * Deferred work queues (osWorkQueue*, cmsis_os2_ext.h): ISRs submit
+ * preallocated work items and up to UCOS3_WORKQ_WORKERS wrapper-owned threads
+ * per queue run them at UCOS3_WORKQ_PRIORITY unless the queue attributes say
+ * otherwise. With UCOS3_LOCKFREE_EN submission pushes onto the queue with
+ * UCOS3_ATOMIC_CAS(), which must then also take pointer-sized words (the
+ * default builtin does), and never disables interrupts.
+ */
+#ifndef UCOS3_WORKQ_EN
+#define UCOS3_WORKQ_EN                 0u
+#endif
+
+#ifndef UCOS3_WORKQ_WORKERS
+#define UCOS3_WORKQ_WORKERS            2u
+#endif
+
+#ifndef UCOS3_WORKQ_PRIORITY
+#define UCOS3_WORKQ_PRIORITY           osPriorityHigh
+#endif
+
+#if (UCOS3_WORKQ_EN > 0u) && (UCOS3_WORKQ_WORKERS == 0u)
+#error "UCOS3_WORKQ_WORKERS must be non-zero."
+#endif
+
+/*
+ * Thread pools (osPool*, cmsis_os2_ext.h): up to UCOS3_POOL_WORKERS worker
+ * threads per pool, each owning a deque of UCOS3_POOL_DEQUE jobs (a power of
+ * two). A worker runs its own newest job first and steals the oldest job
+ * of another worker when its deque is empty.
+ */
+#ifndef UCOS3_POOL_EN
+#define UCOS3_POOL_EN                  0u
+#endif
+
+#ifndef UCOS3_POOL_WORKERS
+#define UCOS3_POOL_WORKERS             4u
+#endif
+
+#ifndef UCOS3_POOL_DEQUE
+#define UCOS3_POOL_DEQUE               16u
+#endif
+
+#if (UCOS3_POOL_EN > 0u) && (UCOS3_POOL_WORKERS == 0u)
+#error "UCOS3_POOL_WORKERS must be non-zero."
+#endif
+#if (UCOS3_POOL_EN > 0u) && ((UCOS3_POOL_DEQUE == 0u) || ((UCOS3_POOL_DEQUE & (UCOS3_POOL_DEQUE - 1u)) != 0u))
+#error "UCOS3_POOL_DEQUE must be a power of two."
+#endif
+
+/*
+ * Stackless coroutines (osCoro*, cmsis_os2_ext.h): one scheduler thread runs
+ * any number of coroutines, each in a caller-provided control block of a few
+ * dozen bytes. A coroutine waiting on an object links an osObjectWaitAny
+ * node to it, so UCOS3_CORO_EN needs UCOS3_WAIT_ANY_EN.
+ */
+#ifndef UCOS3_CORO_EN
+#define UCOS3_CORO_EN                  0u
+#endif
+
+#if (UCOS3_CORO_EN > 0u) && (UCOS3_WAIT_ANY_EN == 0u)
+#error "UCOS3_CORO_EN requires UCOS3_WAIT_ANY_EN."
+#endif
+
+/*
+ * Active objects (osActive*, cmsis_os2_ext.h): each active object owns a
+ * thread and a queue of UCOS3_ACTIVE_QUEUE event pointers (a power of two) that
+ * threads and ISRs post to without waiting. With UCOS3_LOCKFREE_EN a post
+ * reserves its slot with UCOS3_ATOMIC_CAS() and never disables interrupts.
+ * Time events are counted down in the
+ * kernel tick hook.
+ */
+#ifndef UCOS3_ACTIVE_EN
+#define UCOS3_ACTIVE_EN                0u
+#endif
+
+#ifndef UCOS3_ACTIVE_QUEUE
+#define UCOS3_ACTIVE_QUEUE             16u
+#endif
+
+#if (UCOS3_ACTIVE_EN > 0u) && ((UCOS3_ACTIVE_QUEUE == 0u) || ((UCOS3_ACTIVE_QUEUE & (UCOS3_ACTIVE_QUEUE - 1u)) != 0u))
+#error "UCOS3_ACTIVE_QUEUE must be a power of two."
+#endif
+
+/* Wrapper features that need the OS_AppTaskSwHookPtr/OS_AppTimeTickHookPtr hooks */
+#define UCOS3_HOOKS_EN                 ((UCOS3_CPU_USAGE_EN) || (UCOS3_TRACE_EN) || (UCOS3_PROFILER_EN) || \
+                                        (UCOS3_ACTIVE_EN))
+
+#if (UCOS3_HOOKS_EN > 0u) && (OS_CFG_APP_HOOKS_EN == 0u)
+#error "Enable OS_CFG_APP_HOOKS_EN for the CMSIS wrapper kernel hooks."
+#endif
+
+#if (UCOS3_CPU_USAGE_EN > 0u)
+#if (UCOS3_CPU_USAGE_SLOTS == 0u) || ((UCOS3_CPU_USAGE_WINDOW_TICKS % UCOS3_CPU_USAGE_SLOTS) != 0u)
+#error "UCOS3_CPU_USAGE_WINDOW_TICKS must be a non-zero multiple of UCOS3_CPU_USAGE_SLOTS."
+#endif
+#endif
+
+#if (UCOS3_CPU_USAGE_EN > 0u) || (UCOS3_TRACE_EN > 0u) || (UCOS3_INVERSION_EN > 0u) || (UCOS3_WAIT_STATS_EN > 0u) || \
+    (UCOS3_WORKQ_EN > 0u)
+#ifndef UCOS3_TS_GET
+#if (OS_CFG_TS_EN == 0u)
+#error "Enable OS_CFG_TS_EN or define UCOS3_TS_GET() for CPU usage accounting, tracing and wait timing."
+#endif
+#define UCOS3_TS_GET()                 ((uint32_t)OS_TS_GET())
+#endif
+#endif
+
 #define UCOS3_PRIORITY_LOWEST_AVAILABLE  (OS_CFG_PRIO_MAX - 1u - UCOS3_PRIORITY_GUARD)
 #define UCOS3_PRIORITY_HIGHEST_AVAILABLE (UCOS3_PRIORITY_LOWEST_AVAILABLE - (UCOS3_PRIORITY_LEVELS - 1u))
 
@@ -74,7 +446,13 @@ typedef enum {
   osUcos3ObjectMutex,
   osUcos3ObjectSemaphore,
   osUcos3ObjectMemoryPool,
-  osUcos3ObjectMessageQueue
+  osUcos3ObjectMessageQueue,
+  osUcos3ObjectSlab,
+  osUcos3ObjectTopic,
+  osUcos3ObjectWorkQueue,
+  osUcos3ObjectPool,
+  osUcos3ObjectCoroSched,
+  osUcos3ObjectActive
 } os_ucos3_object_type_t;
 
 typedef struct os_ucos3_object {
@@ -95,6 +473,13 @@ typedef enum {
   osUcos3ThreadJoinable = 1u
 } os_ucos3_thread_mode_t;
 
+typedef struct os_ucos3_cpu_usage {
+  uint64_t cycles;
+  uint32_t switches;
+  uint32_t slot_epoch[UCOS3_CPU_USAGE_RING];
+  uint64_t slot_cycles[UCOS3_CPU_USAGE_RING];
+} os_ucos3_cpu_usage_t;
+
 typedef struct os_ucos3_thread {
   os_ucos3_object_t   object;
   osThreadFunc_t      entry;
@@ -109,6 +494,26 @@ typedef struct os_ucos3_thread {
   OS_SEM              join_sem;
   bool                join_sem_created;
   bool                started;
+  uint32_t            stack_free;   /* lowest free stack words seen */
+#if (UCOS3_WAIT_ANY_EN > 0u)
+  OS_SEM              wait_any_sem; /* osObjectWaitAny wake, reset before each wait */
+  bool                wait_any_sem_created;
+#endif
+#if (UCOS3_CPU_USAGE_EN > 0u)
+  os_ucos3_cpu_usage_t cpu;
+#endif
+#if (UCOS3_TRACE_EN > 0u)
+  uint32_t            trace_object; /* object of the last API call, for Block records */
+#endif
+#if (UCOS3_INVERSION_EN > 0u)
+  osInversionStats_t *inv_stats;    /* stats of the awaited object, NULL when not waiting */
+  struct os_ucos3_thread *inv_holder; /* lower priority thread holding it up */
+  uint32_t            inv_since;
+  bool                inv_inherited;
+#endif
+#if (UCOS3_WAIT_STATS_EN > 0u)
+  osThreadWaitStat_t  wait[UCOS3_WAIT_STATS_SLOTS];
+#endif
 } os_ucos3_thread_t;
 
 typedef struct os_ucos3_timer {
@@ -120,16 +525,28 @@ typedef struct os_ucos3_timer {
   bool              active;
 } os_ucos3_timer_t;
 
+typedef struct os_ucos3_wait_any_node {
+  struct os_ucos3_wait_any_node  *next;
+  struct os_ucos3_wait_any_node **pprev;
+  OS_SEM                        *wake;
+} os_ucos3_wait_any_node_t;
+
 typedef struct os_ucos3_event_flags {
   os_ucos3_object_t object;
   OS_FLAG_GRP       grp;
   bool              created;
+#if (UCOS3_WAIT_ANY_EN > 0u)
+  os_ucos3_wait_any_node_t *wait_any; /* osObjectWaitAny waiters */
+#endif
 } os_ucos3_event_flags_t;
 
 typedef struct os_ucos3_mutex {
   os_ucos3_object_t object;
   OS_MUTEX          mutex;
   bool              created;
+#if (UCOS3_INVERSION_EN > 0u)
+  osInversionStats_t inversion;
+#endif
 } os_ucos3_mutex_t;
 
 typedef struct os_ucos3_semaphore {
@@ -138,16 +555,26 @@ typedef struct os_ucos3_semaphore {
   OS_SEM_CTR        max_count;
   OS_SEM_CTR        initial_count;
   bool              created;
+#if (UCOS3_INVERSION_EN > 0u)
+  osInversionStats_t inversion;
+  OS_TCB           *holder;         /* last CMSIS thread to take a binary semaphore */
+#endif
+#if (UCOS3_WAIT_ANY_EN > 0u)
+  os_ucos3_wait_any_node_t *wait_any; /* osObjectWaitAny waiters */
+#endif
 } os_ucos3_semaphore_t;
 
 typedef struct os_ucos3_memory_pool {
   os_ucos3_object_t object;
   uint8_t          *pool_mem;
-  uint16_t         *free_stack;
+  uint16_t         *free_stack;     /* next free block index, per block */
   uint32_t          block_size;
   uint32_t          block_count;
-  uint32_t          free_top;
-  uint8_t           owns_memory;
+  uint32_t          free_top;       /* ABA tag << 16 | first free block index */
+  uint32_t          used;
+  uint32_t          waiters;        /* threads registered to block in osMemoryPoolAlloc */
+  OS_SEM            wait_sem;
+  bool              created;
 } os_ucos3_memory_pool_t;
 
 typedef struct os_ucos3_message_queue {
@@ -162,14 +589,178 @@ typedef struct os_ucos3_message_queue {
   uint32_t          msg_size;
   uint32_t          msg_count;
   bool              created;
+#if (UCOS3_WAIT_ANY_EN > 0u)
+  os_ucos3_wait_any_node_t *wait_any; /* osObjectWaitAny waiters */
+#endif
 } os_ucos3_message_queue_t;
 
+typedef struct os_ucos3_slab_class {
+  osMemoryPoolId_t  pool;
+  uint8_t          *base;           /* block address range, for osSlabFree */
+  uint8_t          *limit;
+  uint32_t          block_size;
+  uint32_t          peak;
+  uint32_t          allocs;
+  uint32_t          overflows;      /* requests of this class served by a larger one */
+  uint32_t          failures;
+} os_ucos3_slab_class_t;
+
+typedef struct os_ucos3_slab {
+  os_ucos3_object_t     object;
+  uint32_t              class_count;
+  os_ucos3_slab_class_t classes[UCOS3_SLAB_CLASSES];
+} os_ucos3_slab_t;
+
+typedef struct os_ucos3_topic_sub {
+  void             *target;         /* osMessageQueueId_t, or osEventFlagsId_t when flags != 0 */
+  uint32_t          flags;
+  uint32_t          policy;
+  uint32_t          dropped;
+} os_ucos3_topic_sub_t;
+
+typedef struct os_ucos3_topic {
+  os_ucos3_object_t     object;
+  uint32_t              count;
+  bool                  created;
+  os_ucos3_topic_sub_t  subs[UCOS3_TOPIC_SUBSCRIBERS];
+} os_ucos3_topic_t;
+
+#if (UCOS3_WORKQ_EN > 0u)
+typedef struct os_ucos3_work_queue {
+  os_ucos3_object_t object;
+  osWork_t         *incoming;       /* submissions, newest first */
+  osWork_t         *ready_head;     /* submissions in order, taken by the workers */
+  OS_SEM            wake;
+  uint32_t          worker_count;
+  uint32_t          submitted;
+  uint32_t          coalesced;
+  uint32_t          executed;
+  uint32_t          max_latency;
+  uint64_t          total_latency;
+  bool              created;
+  os_ucos3_thread_t workers[UCOS3_WORKQ_WORKERS];
+} os_ucos3_work_queue_t;
+#endif
+
+#if (UCOS3_POOL_EN > 0u)
+typedef struct os_ucos3_pool_job {
+  osPoolFunc_t      func;
+  void             *argument;
+} os_ucos3_pool_job_t;
+
+typedef struct os_ucos3_pool_worker {
+  os_ucos3_thread_t thread;         /* first, so the thread ID is the worker */
+  struct os_ucos3_pool *pool;
+  uint32_t          top;            /* oldest job, taken by thieves */
+  uint32_t          bottom;         /* next free slot, the owner's end */
+  os_ucos3_pool_job_t jobs[UCOS3_POOL_DEQUE];
+} os_ucos3_pool_worker_t;
+
+typedef struct os_ucos3_pool {
+  os_ucos3_object_t object;
+  OS_SEM            work_sem;
+  OS_FLAG_GRP       done;           /* bit 0 set while no job is outstanding */
+  uint32_t          worker_count;
+  uint32_t          idle;           /* workers blocked on work_sem */
+  uint32_t          next;           /* deque for the next submission from outside */
+  uint32_t          outstanding;    /* jobs submitted and not finished */
+  uint32_t          submitted;
+  uint32_t          executed;
+  uint32_t          stolen;
+  bool              created;
+  os_ucos3_pool_worker_t workers[UCOS3_POOL_WORKERS];
+} os_ucos3_pool_t;
+#endif
+
+#if (UCOS3_CORO_EN > 0u)
+typedef struct os_ucos3_coro {
+  osCoro_t          co;             /* first, so osCoro_t * is the control block */
+  struct os_ucos3_coro *next;
+  struct os_ucos3_coro_sched *sched;
+  osCoroFunc_t      func;
+  void             *argument;
+  osObjectWait_t    wait;           /* object is NULL for a delay */
+  os_ucos3_wait_any_node_t node;
+  uint32_t          deadline;       /* tick count when timed */
+  uint8_t           state;          /* osCoroReady or osCoroBlocked */
+  bool              timed;
+} os_ucos3_coro_t;
+
+typedef struct os_ucos3_coro_sched {
+  os_ucos3_object_t object;
+  OS_SEM            wake;           /* posted by osCoroNew and by the awaited objects */
+  os_ucos3_coro_t  *incoming;       /* added by osCoroNew, newest first */
+  os_ucos3_coro_t  *head;           /* run by the scheduler thread */
+  uint32_t          coroutines;
+  uint32_t          resumed;
+  uint32_t          wakeups;
+  bool              created;
+  os_ucos3_thread_t thread;
+} os_ucos3_coro_sched_t;
+#endif
+
+#if (UCOS3_ACTIVE_EN > 0u)
+typedef struct os_ucos3_active_slot {
+  uint32_t          seq;            /* position + 1 once filled, position + depth once free */
+  osEvent_t        *event;
+} os_ucos3_active_slot_t;
+
+typedef struct os_ucos3_active {
+  os_ucos3_object_t object;
+  OS_SEM            wake;           /* posted when the thread waits for an event */
+  osActiveHandler_t handler;
+  void             *argument;
+  uint32_t          tail;           /* next position to reserve, producers */
+  uint32_t          head;           /* next position to dispatch, the thread */
+  uint32_t          waiting;        /* 1 while the thread is about to pend on wake */
+  osEvent_t        *current;        /* taken and not yet released, for osActiveDelete */
+  uint32_t          posted;
+  uint32_t          dispatched;
+  uint32_t          dropped;
+  uint32_t          max_queued;
+  bool              created;
+  os_ucos3_thread_t thread;
+  os_ucos3_active_slot_t slots[UCOS3_ACTIVE_QUEUE];
+} os_ucos3_active_t;
+#endif
+
 typedef struct os_ucos3_kernel {
   osKernelState_t state;
   uint32_t        tick_freq;
   uint32_t        sys_timer_freq;
   bool            initialized;
   os_ucos3_list_t threads;
+#if (UCOS3_STACK_PROFILER_EN > 0u)
+  struct os_ucos3_thread *stk_prof_cursor;
+  uint32_t        stk_prof_pos;
+#endif
+#if (UCOS3_CPU_USAGE_EN > 0u)
+  os_ucos3_cpu_usage_t cpu_idle;
+  os_ucos3_cpu_usage_t cpu_kernel;
+  uint32_t        cpu_slot_len[UCOS3_CPU_USAGE_RING];
+  uint32_t        cpu_epoch;
+  uint32_t        cpu_slot_tick;
+  uint32_t        cpu_last_ts;
+  uint32_t        cpu_slot_ts;
+#endif
+#if (UCOS3_TRACE_EN > 0u)
+  osTraceRecord_t trace_buf[UCOS3_TRACE_EVENTS];
+  volatile uint32_t trace_seq[UCOS3_TRACE_EVENTS];  /* index + 1 of the record each slot holds */
+  uint32_t        trace_head;       /* next slot to reserve */
+  uint32_t        trace_tail;       /* next slot to read */
+  uint32_t        trace_dropped;
+  volatile bool   trace_paused;
+#endif
+#if (UCOS3_PROFILER_EN > 0u)
+  osProfilerSample_t prof_buf[UCOS3_PROFILER_SAMPLES];
+  uint32_t        prof_head;        /* samples taken */
+  uint32_t        prof_tail;        /* next sample to read */
+  uint32_t        prof_dropped;
+  volatile bool   prof_paused;
+#endif
+#if (UCOS3_ACTIVE_EN > 0u)
+  osTimeEvent_t  *time_events;      /* armed, counted down each tick */
+#endif
 } os_ucos3_kernel_t;
 
 extern os_ucos3_kernel_t os_ucos3_kernel;
@@ -185,7 +776,28 @@ void osUcos3ThreadJoinRelease(os_ucos3_thread_t *thread);
 os_ucos3_event_flags_t *osUcos3EventFlagsFromId(osEventFlagsId_t ef_id);
 os_ucos3_mutex_t *osUcos3MutexFromId(osMutexId_t mutex_id);
 os_ucos3_semaphore_t *osUcos3SemaphoreFromId(osSemaphoreId_t semaphore_id);
+os_ucos3_memory_pool_t *osUcos3MemoryPoolFromId(osMemoryPoolId_t mp_id);
 os_ucos3_message_queue_t *osUcos3MessageQueueFromId(osMessageQueueId_t mq_id);
+os_ucos3_slab_t *osUcos3SlabFromId(osSlabId_t slab_id);
+os_ucos3_topic_t *osUcos3TopicFromId(osTopicId_t topic_id);
+#if (UCOS3_WORKQ_EN > 0u)
+os_ucos3_work_queue_t *osUcos3WorkQueueFromId(osWorkQueueId_t wq_id);
+#endif
+#if (UCOS3_POOL_EN > 0u)
+os_ucos3_pool_t *osUcos3PoolFromId(osPoolId_t pool_id);
+#endif
+#if (UCOS3_CORO_EN > 0u)
+os_ucos3_coro_sched_t *osUcos3CoroSchedFromId(osCoroSchedId_t sched_id);
+#endif
+#if (UCOS3_ACTIVE_EN > 0u)
+os_ucos3_active_t *osUcos3ActiveFromId(osActiveId_t ao_id);
+#endif
+
+/* Installed into OS_AppTaskSwHookPtr/OS_AppTimeTickHookPtr by osKernelInitialize
+ * when UCOS3_HOOKS_EN is set. Applications that install their own hooks later
+ * must call these from them. */
+void osUcos3TaskSwHook(void);
+void osUcos3TimeTickHook(void);
 
 #ifdef __cplusplus
 }
@@ -27,6 +27,81 @@ static inline bool osUcos3IsrDisallowsWait(uint32_t timeout) {
 }
 
 static osStatus_t osUcos3DelayTicks(uint32_t ticks);
+#if (UCOS3_STACK_PROFILER_EN > 0u)
+static osStatus_t osUcos3StackProfilerStart(void);
+#endif
+#if (UCOS3_PROFILER_EN > 0u)
+static void osUcos3ProfilerSample(void);
+#endif
+#if (UCOS3_ACTIVE_EN > 0u)
+static void osUcos3TimeEventTick(void);
+#endif
+
+/* Trace points; the public API functions are thin wrappers around the
+ * osUcos3Xxx implementations so entry and exit are recorded in one place. */
+#if (UCOS3_TRACE_EN > 0u)
+static void osUcos3TraceEmit(uint32_t event, uint32_t object, uint32_t arg);
+static void osUcos3TraceApiEnter(uint32_t api, uint32_t object, uint32_t arg);
+static void osUcos3TraceName(uint32_t object, const char *name);
+static void osUcos3TraceWakeup(uint32_t object, const OS_PEND_LIST *list);
+static void osUcos3TraceSwitch(const OS_TCB *from, const OS_TCB *to);
+
+#define UCOS3_TRACE_ID(object)                ((uint32_t)(uintptr_t)(object))
+#define UCOS3_TRACE_ENTER(api, object, arg)   osUcos3TraceApiEnter((uint32_t)(api), UCOS3_TRACE_ID(object), (uint32_t)(arg))
+#define UCOS3_TRACE_EXIT(api, object, result) osUcos3TraceEmit(osTraceEventApiExit | (uint32_t)(api), UCOS3_TRACE_ID(object), (uint32_t)(result))
+#define UCOS3_TRACE_NAME(object, name)        osUcos3TraceName(UCOS3_TRACE_ID(object), (name))
+#define UCOS3_TRACE_WAKEUP(object, list)      osUcos3TraceWakeup(UCOS3_TRACE_ID(object), (list))
+#else
+#define UCOS3_TRACE_ENTER(api, object, arg)   ((void)0)
+#define UCOS3_TRACE_EXIT(api, object, result) ((void)0)
+#define UCOS3_TRACE_NAME(object, name)        ((void)0)
+#define UCOS3_TRACE_WAKEUP(object, list)      ((void)0)
+#endif
+
+/* Inversion checks bracket each blocking pend on a mutex or binary semaphore
+ * and precede each release that can ready a waiter; owner points at the
+ * mutex owner or at the semaphore's last taker. */
+#if (UCOS3_INVERSION_EN > 0u)
+static void osUcos3InversionBegin(void *object, osInversionStats_t *stats, OS_TCB *const *owner);
+static void osUcos3InversionSignal(osInversionStats_t *stats, const OS_PEND_LIST *list, OS_TCB **owner);
+static void osUcos3InversionEnd(OS_TCB *const *owner, OS_ERR err);
+static void osUcos3InversionTake(os_ucos3_semaphore_t *sem, OS_ERR err);
+
+#define UCOS3_INVERSION_BEGIN(object, stats, owner, timeout) \
+  do { if ((timeout) != 0u) { osUcos3InversionBegin((object), (stats), (owner)); } } while (0)
+#define UCOS3_INVERSION_SIGNAL(stats, list, owner) osUcos3InversionSignal((stats), (list), (owner))
+#define UCOS3_INVERSION_END(owner, err, timeout) \
+  do { if ((timeout) != 0u) { osUcos3InversionEnd((owner), (err)); } } while (0)
+#define UCOS3_INVERSION_TAKE(sem, err) osUcos3InversionTake((sem), (err))
+#else
+#define UCOS3_INVERSION_BEGIN(object, stats, owner, timeout) ((void)0)
+#define UCOS3_INVERSION_SIGNAL(stats, list, owner)  ((void)0)
+#define UCOS3_INVERSION_END(owner, err, timeout)    ((void)0)
+#define UCOS3_INVERSION_TAKE(sem, err)              ((void)0)
+#endif
+
+/* Wait statistics time the whole blocking call in the public wrapper. */
+#if (UCOS3_WAIT_STATS_EN > 0u)
+static void osUcos3WaitRecord(uint32_t kind, const void *object, uint32_t start);
+
+#define UCOS3_WAIT_BEGIN(start)         uint32_t start = UCOS3_TS_GET()
+#define UCOS3_WAIT_END(start, kind, object, timeout) \
+  do { if ((timeout) != 0u) { osUcos3WaitRecord((kind), (object), (start)); } } while (0)
+#else
+#define UCOS3_WAIT_BEGIN(start)         ((void)0)
+#define UCOS3_WAIT_END(start, kind, object, timeout) ((void)0)
+#endif
+
+/* osObjectWaitAny waiters are woken after each post to a watched object and
+ * detached when it is deleted. */
+#if (UCOS3_WAIT_ANY_EN > 0u)
+static void osUcos3WaitAnyNotify(os_ucos3_wait_any_node_t **head, bool detach);
+
+#define UCOS3_WAIT_ANY_NOTIFY(head, detach) \
+  do { if ((head) != NULL) { osUcos3WaitAnyNotify(&(head), (detach)); } } while (0)
+#else
+#define UCOS3_WAIT_ANY_NOTIFY(head, detach) ((void)0)
+#endif
 
 static void osUcos3ObjectInit(os_ucos3_object_t *object,
                               os_ucos3_object_type_t type,
@@ -162,11 +237,25 @@ os_ucos3_thread_t *osUcos3ThreadFromId(osThreadId_t thread_id) {
   return (thread->object.type == osUcos3ObjectThread) ? thread : NULL;
 }
 
+/* CMSIS threads pass themselves as p_ext, so most lookups avoid the list walk. */
+static inline os_ucos3_thread_t *osUcos3ThreadFromExt(const OS_TCB *ptcb) {
+  os_ucos3_thread_t *thread = (os_ucos3_thread_t *)ptcb->ExtPtr;
+  if ((thread != NULL) && (&thread->tcb == ptcb) && (thread->object.type == osUcos3ObjectThread)) {
+    return thread;
+  }
+  return NULL;
+}
+
 os_ucos3_thread_t *osUcos3ThreadFromTcb(const OS_TCB *ptcb) {
   if (ptcb == NULL) {
     return NULL;
   }
 
+  os_ucos3_thread_t *found = osUcos3ThreadFromExt(ptcb);
+  if (found != NULL) {
+    return found;
+  }
+
   os_ucos3_object_t *cursor = os_ucos3_kernel.threads.head;
   while (cursor != NULL) {
     os_ucos3_thread_t *thread = (os_ucos3_thread_t *)cursor;
@@ -267,6 +356,13 @@ void osUcos3ThreadListRemove(os_ucos3_thread_t *thread) {
     return;
   }
 
+#if (UCOS3_STACK_PROFILER_EN > 0u)
+  if (os_ucos3_kernel.stk_prof_cursor == thread) {
+    os_ucos3_kernel.stk_prof_cursor = (os_ucos3_thread_t *)thread->object.next;
+    os_ucos3_kernel.stk_prof_pos = 0u;
+  }
+#endif
+
   osUcos3ObjectListRemove(&os_ucos3_kernel.threads, &thread->object);
 }
 
@@ -280,13 +376,21 @@ void osUcos3ThreadJoinRelease(os_ucos3_thread_t *thread) {
 }
 
 static void osUcos3ThreadFreeResources(os_ucos3_thread_t *thread) {
-  if ((thread == NULL) || !thread->join_sem_created) {
+  if (thread == NULL) {
     return;
   }
 
   OS_ERR err;
-  (void)OSSemDel(&thread->join_sem, OS_OPT_DEL_ALWAYS, &err);
-  thread->join_sem_created = false;
+  if (thread->join_sem_created) {
+    (void)OSSemDel(&thread->join_sem, OS_OPT_DEL_ALWAYS, &err);
+    thread->join_sem_created = false;
+  }
+#if (UCOS3_WAIT_ANY_EN > 0u)
+  if (thread->wait_any_sem_created) {
+    (void)OSSemDel(&thread->wait_any_sem, OS_OPT_DEL_ALWAYS, &err);
+    thread->wait_any_sem_created = false;
+  }
+#endif
 }
 
 void osUcos3ThreadCleanup(os_ucos3_thread_t *thread) {
@@ -330,6 +434,43 @@ static CPU_STK_SIZE osUcos3StackWords(uint32_t stack_size_bytes) {
   return words;
 }
 
+/*
+ * Stack initialization and FP context options selected by the extension
+ * attr_bits. Also seeds the watermark record for the chosen mode.
+ */
+static OS_OPT osUcos3ThreadOptions(os_ucos3_thread_t *thread, CPU_STK_SIZE stack_words) {
+  uint32_t bits = thread->object.attr_bits;
+  OS_OPT opt = OS_OPT_TASK_STK_CHK;
+
+  switch (bits & osThreadStackInit_Msk) {
+    case osThreadStackPaint: {
+      CPU_STK_SIZE paint = (stack_words < UCOS3_STACK_PAINT_WORDS) ? stack_words : UCOS3_STACK_PAINT_WORDS;
+#if defined(CPU_CFG_STK_GROWTH) && (CPU_CFG_STK_GROWTH == CPU_STK_GROWTH_LO_TO_HI)
+      memset(&thread->stack_mem[stack_words - paint], 0, paint * sizeof(CPU_STK));
+#else
+      memset(&thread->stack_mem[0], 0, paint * sizeof(CPU_STK));
+#endif
+      thread->stack_free = (uint32_t)paint;
+      break;
+    }
+    case osThreadStackNoInit:
+      opt = OS_OPT_NONE;
+      thread->stack_free = 0u;
+      break;
+    default:
+      opt |= OS_OPT_TASK_STK_CLR;
+      break;
+  }
+
+#if (UCOS3_THREAD_SAVE_FP > 0u)
+  if ((bits & osThreadNoFpu) == 0u) {
+    opt |= OS_OPT_TASK_SAVE_FP;
+  }
+#endif
+
+  return opt;
+}
+
 static void osUcos3ThreadTrampoline(void *p_arg) {
   os_ucos3_thread_t *thread = (os_ucos3_thread_t *)p_arg;
   if (thread == NULL) {
@@ -345,7 +486,7 @@ static void osUcos3ThreadTrampoline(void *p_arg) {
 
 /* ==== Kernel Management ==== */
 
-osStatus_t osKernelInitialize(void) {
+static osStatus_t osUcos3KernelInitialize(void) {
   if (osUcos3IrqContext()) {
     return osErrorISR;
   }
@@ -360,6 +501,14 @@ osStatus_t osKernelInitialize(void) {
     return osError;
   }
 
+#if (UCOS3_HOOKS_EN > 0u)
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  OS_AppTaskSwHookPtr = osUcos3TaskSwHook;
+  OS_AppTimeTickHookPtr = osUcos3TimeTickHook;
+  CPU_CRITICAL_EXIT();
+#endif
+
   os_ucos3_kernel.initialized = true;
   os_ucos3_kernel.state = osKernelReady;
   os_ucos3_kernel.tick_freq = OS_CFG_TICK_RATE_HZ;
@@ -368,6 +517,13 @@ osStatus_t osKernelInitialize(void) {
   return osOK;
 }
 
+osStatus_t osKernelInitialize(void) {
+  UCOS3_TRACE_ENTER(osTraceApiKernelInitialize, 0u, 0u);
+  osStatus_t status = osUcos3KernelInitialize();
+  UCOS3_TRACE_EXIT(osTraceApiKernelInitialize, 0u, status);
+  return status;
+}
+
 osStatus_t osKernelGetInfo(osVersion_t *version, char *id_buf, uint32_t id_size) {
   if (version != NULL) {
     version->api    = 0x02020000u;
@@ -395,7 +551,7 @@ osKernelState_t osKernelGetState(void) {
   return os_ucos3_kernel.state;
 }
 
-osStatus_t osKernelStart(void) {
+static osStatus_t osUcos3KernelStart(void) {
   if (osUcos3IrqContext()) {
     return osErrorISR;
   }
@@ -404,13 +560,34 @@ osStatus_t osKernelStart(void) {
     return osError;
   }
 
+#if (UCOS3_CPU_USAGE_EN > 0u)
+  os_ucos3_kernel.cpu_epoch = 1u;
+  os_ucos3_kernel.cpu_slot_tick = 0u;
+  os_ucos3_kernel.cpu_last_ts = UCOS3_TS_GET();
+  os_ucos3_kernel.cpu_slot_ts = os_ucos3_kernel.cpu_last_ts;
+#endif
+
+#if (UCOS3_STACK_PROFILER_EN > 0u)
+  if (osUcos3StackProfilerStart() != osOK) {
+    return osError;
+  }
+#endif
+
   os_ucos3_kernel.state = osKernelRunning;
   OS_ERR err;
   OSStart(&err);
   return (err == OS_ERR_NONE) ? osOK : osError;
 }
 
-int32_t osKernelLock(void) {
+osStatus_t osKernelStart(void) {
+  UCOS3_TRACE_ENTER(osTraceApiKernelStart, 0u, 0u);
+  UCOS3_TRACE_NAME(&OSIdleTaskTCB, "idle");
+  osStatus_t status = osUcos3KernelStart();
+  UCOS3_TRACE_EXIT(osTraceApiKernelStart, 0u, status);
+  return status;
+}
+
+static int32_t osUcos3KernelLock(void) {
   if (osUcos3IrqContext()) {
     return (int32_t)osErrorISR;
   }
@@ -428,7 +605,14 @@ int32_t osKernelLock(void) {
   return previous;
 }
 
-int32_t osKernelUnlock(void) {
+int32_t osKernelLock(void) {
+  UCOS3_TRACE_ENTER(osTraceApiKernelLock, 0u, 0u);
+  int32_t result = osUcos3KernelLock();
+  UCOS3_TRACE_EXIT(osTraceApiKernelLock, 0u, result);
+  return result;
+}
+
+static int32_t osUcos3KernelUnlock(void) {
   if (osUcos3IrqContext()) {
     return (int32_t)osErrorISR;
   }
@@ -451,7 +635,14 @@ int32_t osKernelUnlock(void) {
   return previous;
 }
 
-int32_t osKernelRestoreLock(int32_t lock) {
+int32_t osKernelUnlock(void) {
+  UCOS3_TRACE_ENTER(osTraceApiKernelUnlock, 0u, 0u);
+  int32_t result = osUcos3KernelUnlock();
+  UCOS3_TRACE_EXIT(osTraceApiKernelUnlock, 0u, result);
+  return result;
+}
+
+static int32_t osUcos3KernelRestoreLock(int32_t lock) {
   if (osUcos3IrqContext()) {
     return (int32_t)osErrorISR;
   }
@@ -478,6 +669,13 @@ int32_t osKernelRestoreLock(int32_t lock) {
   return (OSSchedLockNestingCtr > 0u) ? 1 : 0;
 }
 
+int32_t osKernelRestoreLock(int32_t lock) {
+  UCOS3_TRACE_ENTER(osTraceApiKernelRestoreLock, 0u, lock);
+  int32_t result = osUcos3KernelRestoreLock(lock);
+  UCOS3_TRACE_EXIT(osTraceApiKernelRestoreLock, 0u, result);
+  return result;
+}
+
 uint32_t osKernelGetTickCount(void) {
   OS_ERR err;
   return (uint32_t)OSTimeGet(&err);
@@ -498,7 +696,7 @@ uint32_t osKernelGetSysTimerFreq(void) {
 
 /* ==== Thread Management ==== */
 
-osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr) {
+static osThreadId_t osUcos3ThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr) {
   if ((func == NULL) || (attr == NULL)) {
     return NULL;
   }
@@ -524,6 +722,7 @@ osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr
 
   CPU_STK_SIZE stack_words = osUcos3StackWords(attr->stack_size);
   thread->stack_size = (uint32_t)(stack_words * sizeof(CPU_STK));
+  thread->stack_free = (uint32_t)stack_words;
 
   thread->mode = ((thread->object.attr_bits & osThreadJoinable) != 0u)
                  ? osUcos3ThreadJoinable
@@ -541,6 +740,25 @@ osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr
     thread->join_sem_created = true;
   }
 
+#if (UCOS3_WAIT_ANY_EN > 0u)
+  {
+    OS_ERR err;
+    OSSemCreate(&thread->wait_any_sem, (CPU_CHAR *)"cmsis.waitany", (OS_SEM_CTR)0u, &err);
+    if (err != OS_ERR_NONE) {
+      osUcos3ThreadFreeResources(thread);
+      return NULL;
+    }
+    thread->wait_any_sem_created = true;
+  }
+#endif
+
+  OS_OPT opt = osUcos3ThreadOptions(thread, stack_words);
+  OS_MSG_QTY q_size = (OS_MSG_QTY)0u;
+#if (UCOS3_MAILBOX_EN > 0u)
+  if ((thread->object.attr_bits & osThreadMailbox) != 0u) {
+    q_size = (OS_MSG_QTY)UCOS3_MAILBOX_DEPTH;
+  }
+#endif
   osUcos3ThreadListInsert(thread);
 
   OS_ERR err;
@@ -552,10 +770,10 @@ osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr
                &thread->stack_mem[0],
                (CPU_STK_SIZE)(stack_words / 10u),
                stack_words,
-               (OS_MSG_QTY)0u,
+               q_size,
                (OS_TICK)0u,
-               NULL,
-               (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
+               thread,
+               opt,
                &err);
   if (err != OS_ERR_NONE) {
     osUcos3ThreadCleanup(thread);
@@ -568,6 +786,14 @@ osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr
   return (osThreadId_t)thread;
 }
 
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr) {
+  UCOS3_TRACE_ENTER(osTraceApiThreadNew, 0u, (uintptr_t)func);
+  osThreadId_t id = osUcos3ThreadNew(func, argument, attr);
+  UCOS3_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS3_TRACE_EXIT(osTraceApiThreadNew, id, 0u);
+  return id;
+}
+
 const char *osThreadGetName(osThreadId_t thread_id) {
   os_ucos3_thread_t *thread = (thread_id == NULL)
                               ? osUcos3ThreadFromTcb(OSTCBCurPtr)
@@ -618,6 +844,61 @@ osThreadState_t osThreadGetState(osThreadId_t thread_id) {
   return osUcos3ThreadStateFromTcb(thread);
 }
 
+/*
+ * OS_OPT_TASK_STK_CLR (or osThreadStackPaint) leaves unused words at zero.
+ * Return the index of the first used word in [from, limit), counting from the
+ * far end of the stack.
+ */
+static uint32_t osUcos3StackScan(const os_ucos3_thread_t *thread, uint32_t from, uint32_t limit) {
+  uint32_t words = thread->stack_size / (uint32_t)sizeof(CPU_STK);
+  for (uint32_t i = from; i < limit; ++i) {
+#if defined(CPU_CFG_STK_GROWTH) && (CPU_CFG_STK_GROWTH == CPU_STK_GROWTH_LO_TO_HI)
+    if (thread->stack_mem[words - 1u - i] != (CPU_STK)0) {
+#else
+    (void)words;
+    if (thread->stack_mem[i] != (CPU_STK)0) {
+#endif
+      return i;
+    }
+  }
+  return limit;
+}
+
+uint32_t osThreadGetStackSize(osThreadId_t thread_id) {
+  os_ucos3_thread_t *thread = osUcos3ThreadFromId(thread_id);
+  if ((thread == NULL) || osUcos3IrqContext()) {
+    return 0u;
+  }
+
+  return thread->stack_size;
+}
+
+uint32_t osThreadGetStackSpace(osThreadId_t thread_id) {
+  os_ucos3_thread_t *thread = osUcos3ThreadFromId(thread_id);
+  if ((thread == NULL) || !thread->started || osUcos3IrqContext()) {
+    return 0u;
+  }
+
+  /* Only the part still free at the last scan has to be inspected again. */
+  OS_ERR err;
+  OSSchedLock(&err);
+  thread->stack_free = osUcos3StackScan(thread, 0u, thread->stack_free);
+  uint32_t free_words = thread->stack_free;
+  OSSchedUnlock(&err);
+  (void)err;
+
+  return free_words * (uint32_t)sizeof(CPU_STK);
+}
+
+uint32_t osThreadGetStackWatermark(osThreadId_t thread_id) {
+  os_ucos3_thread_t *thread = osUcos3ThreadFromId(thread_id);
+  if (thread == NULL) {
+    return 0u;
+  }
+
+  return thread->stack_free * (uint32_t)sizeof(CPU_STK);
+}
+
 osPriority_t osThreadGetPriority(osThreadId_t thread_id) {
   os_ucos3_thread_t *thread = osUcos3ThreadFromId(thread_id);
   if (thread == NULL) {
@@ -627,7 +908,7 @@ osPriority_t osThreadGetPriority(osThreadId_t thread_id) {
   return thread->cmsis_prio;
 }
 
-osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority) {
+static osStatus_t osUcos3ThreadSetPriority(osThreadId_t thread_id, osPriority_t priority) {
   os_ucos3_thread_t *thread = osUcos3ThreadFromId(thread_id);
   if ((thread == NULL) || (priority == osPriorityNone)) {
     return osErrorParameter;
@@ -653,7 +934,14 @@ osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority) {
   return osOK;
 }
 
-osStatus_t osThreadYield(void) {
+osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority) {
+  UCOS3_TRACE_ENTER(osTraceApiThreadSetPriority, thread_id, priority);
+  osStatus_t status = osUcos3ThreadSetPriority(thread_id, priority);
+  UCOS3_TRACE_EXIT(osTraceApiThreadSetPriority, thread_id, status);
+  return status;
+}
+
+static osStatus_t osUcos3ThreadYield(void) {
   if (osUcos3IrqContext()) {
     return osErrorISR;
   }
@@ -666,7 +954,15 @@ osStatus_t osThreadYield(void) {
   return osUcos3DelayTicks(0u);
 }
 
+osStatus_t osThreadYield(void) {
+  UCOS3_TRACE_ENTER(osTraceApiThreadYield, 0u, 0u);
+  osStatus_t status = osUcos3ThreadYield();
+  UCOS3_TRACE_EXIT(osTraceApiThreadYield, 0u, status);
+  return status;
+}
+
 __NO_RETURN void osThreadExit(void) {
+  UCOS3_TRACE_ENTER(osTraceApiThreadExit, 0u, 0u);
   os_ucos3_thread_t *thread = osUcos3ThreadFromTcb(OSTCBCurPtr);
   if (thread == NULL) {
     OS_ERR err;
@@ -687,7 +983,7 @@ __NO_RETURN void osThreadExit(void) {
   }
 }
 
-osStatus_t osThreadTerminate(osThreadId_t thread_id) {
+static osStatus_t osUcos3ThreadTerminate(osThreadId_t thread_id) {
   if (osUcos3IrqContext()) {
     return osErrorISR;
   }
@@ -710,7 +1006,14 @@ osStatus_t osThreadTerminate(osThreadId_t thread_id) {
   return osOK;
 }
 
-osStatus_t osThreadSuspend(osThreadId_t thread_id) {
+osStatus_t osThreadTerminate(osThreadId_t thread_id) {
+  UCOS3_TRACE_ENTER(osTraceApiThreadTerminate, thread_id, 0u);
+  osStatus_t status = osUcos3ThreadTerminate(thread_id);
+  UCOS3_TRACE_EXIT(osTraceApiThreadTerminate, thread_id, status);
+  return status;
+}
+
+static osStatus_t osUcos3ThreadSuspend(osThreadId_t thread_id) {
   if (osUcos3IrqContext()) {
     return osErrorISR;
   }
@@ -727,7 +1030,14 @@ osStatus_t osThreadSuspend(osThreadId_t thread_id) {
   return (err == OS_ERR_NONE) ? osOK : osErrorResource;
 }
 
-osStatus_t osThreadResume(osThreadId_t thread_id) {
+osStatus_t osThreadSuspend(osThreadId_t thread_id) {
+  UCOS3_TRACE_ENTER(osTraceApiThreadSuspend, thread_id, 0u);
+  osStatus_t status = osUcos3ThreadSuspend(thread_id);
+  UCOS3_TRACE_EXIT(osTraceApiThreadSuspend, thread_id, status);
+  return status;
+}
+
+static osStatus_t osUcos3ThreadResume(osThreadId_t thread_id) {
   if (osUcos3IrqContext()) {
     return osErrorISR;
   }
@@ -742,7 +1052,14 @@ osStatus_t osThreadResume(osThreadId_t thread_id) {
   return (err == OS_ERR_NONE) ? osOK : osErrorResource;
 }
 
-osStatus_t osThreadDetach(osThreadId_t thread_id) {
+osStatus_t osThreadResume(osThreadId_t thread_id) {
+  UCOS3_TRACE_ENTER(osTraceApiThreadResume, thread_id, 0u);
+  osStatus_t status = osUcos3ThreadResume(thread_id);
+  UCOS3_TRACE_EXIT(osTraceApiThreadResume, thread_id, status);
+  return status;
+}
+
+static osStatus_t osUcos3ThreadDetach(osThreadId_t thread_id) {
   if (osUcos3IrqContext()) {
     return osErrorISR;
   }
@@ -767,7 +1084,14 @@ osStatus_t osThreadDetach(osThreadId_t thread_id) {
   return osOK;
 }
 
-osStatus_t osThreadJoin(osThreadId_t thread_id) {
+osStatus_t osThreadDetach(osThreadId_t thread_id) {
+  UCOS3_TRACE_ENTER(osTraceApiThreadDetach, thread_id, 0u);
+  osStatus_t status = osUcos3ThreadDetach(thread_id);
+  UCOS3_TRACE_EXIT(osTraceApiThreadDetach, thread_id, status);
+  return status;
+}
+
+static osStatus_t osUcos3ThreadJoin(osThreadId_t thread_id) {
   if (osUcos3IrqContext()) {
     return osErrorISR;
   }
@@ -799,6 +1123,15 @@ osStatus_t osThreadJoin(osThreadId_t thread_id) {
   return osOK;
 }
 
+osStatus_t osThreadJoin(osThreadId_t thread_id) {
+  UCOS3_TRACE_ENTER(osTraceApiThreadJoin, thread_id, 0u);
+  UCOS3_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos3ThreadJoin(thread_id);
+  UCOS3_WAIT_END(wait_start, osWaitKindThreadJoin, thread_id, 1u);
+  UCOS3_TRACE_EXIT(osTraceApiThreadJoin, thread_id, status);
+  return status;
+}
+
 /* ==== Generic Wait ==== */
 
 static osStatus_t osUcos3DelayTicks(uint32_t ticks) {
@@ -812,7 +1145,7 @@ static osStatus_t osUcos3DelayTicks(uint32_t ticks) {
   return (err == OS_ERR_NONE) ? osOK : osError;
 }
 
-osStatus_t osDelay(uint32_t ticks) {
+static osStatus_t osUcos3Delay(uint32_t ticks) {
   if (osUcos3IrqContext()) {
     return osErrorISR;
   }
@@ -824,7 +1157,16 @@ osStatus_t osDelay(uint32_t ticks) {
   return osUcos3DelayTicks(ticks);
 }
 
-osStatus_t osDelayUntil(uint32_t ticks) {
+osStatus_t osDelay(uint32_t ticks) {
+  UCOS3_TRACE_ENTER(osTraceApiDelay, 0u, ticks);
+  UCOS3_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos3Delay(ticks);
+  UCOS3_WAIT_END(wait_start, osWaitKindDelay, NULL, ticks);
+  UCOS3_TRACE_EXIT(osTraceApiDelay, 0u, status);
+  return status;
+}
+
+static osStatus_t osUcos3DelayUntil(uint32_t ticks) {
   if (osUcos3IrqContext()) {
     return osErrorISR;
   }
@@ -842,6 +1184,15 @@ osStatus_t osDelayUntil(uint32_t ticks) {
   return osUcos3DelayTicks(ticks - now);
 }
 
+osStatus_t osDelayUntil(uint32_t ticks) {
+  UCOS3_TRACE_ENTER(osTraceApiDelayUntil, 0u, ticks);
+  UCOS3_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos3DelayUntil(ticks);
+  UCOS3_WAIT_END(wait_start, osWaitKindDelay, NULL, 1u);
+  UCOS3_TRACE_EXIT(osTraceApiDelayUntil, 0u, status);
+  return status;
+}
+
 /* ==== Thread Flags (Not Supported) ==== */
 
 uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags) {
@@ -888,7 +1239,7 @@ static osStatus_t osUcos3MutexError(OS_ERR err) {
   }
 }
 
-osMutexId_t osMutexNew(const osMutexAttr_t *attr) {
+static osMutexId_t osUcos3MutexNew(const osMutexAttr_t *attr) {
   if (osUcos3IrqContext()) {
     return NULL;
   }
@@ -919,6 +1270,14 @@ osMutexId_t osMutexNew(const osMutexAttr_t *attr) {
   return (osMutexId_t)mutex;
 }
 
+osMutexId_t osMutexNew(const osMutexAttr_t *attr) {
+  UCOS3_TRACE_ENTER(osTraceApiMutexNew, 0u, 0u);
+  osMutexId_t id = osUcos3MutexNew(attr);
+  UCOS3_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS3_TRACE_EXIT(osTraceApiMutexNew, id, 0u);
+  return id;
+}
+
 const char *osMutexGetName(osMutexId_t mutex_id) {
   os_ucos3_mutex_t *mutex = osUcos3MutexFromId(mutex_id);
   return (mutex != NULL) ? mutex->object.name : NULL;
@@ -935,7 +1294,7 @@ static OS_OPT osUcos3PendOption(uint32_t timeout) {
   return (timeout == 0u) ? OS_OPT_PEND_NON_BLOCKING : OS_OPT_PEND_BLOCKING;
 }
 
-osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
+static osStatus_t osUcos3MutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
   os_ucos3_mutex_t *mutex = osUcos3MutexFromId(mutex_id);
   if ((mutex == NULL) || !mutex->created) {
     return osErrorParameter;
@@ -946,11 +1305,13 @@ osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
   }
 
   OS_ERR err;
+  UCOS3_INVERSION_BEGIN(mutex_id, &mutex->inversion, &mutex->mutex.OwnerTCBPtr, timeout);
   OSMutexPend(&mutex->mutex,
               osUcos3PendTimeout(timeout),
               osUcos3PendOption(timeout),
               NULL,
               &err);
+  UCOS3_INVERSION_END(&mutex->mutex.OwnerTCBPtr, err, timeout);
   if ((timeout == 0u) && (err == OS_ERR_PEND_WOULD_BLOCK)) {
     return osErrorResource;
   }
@@ -958,7 +1319,16 @@ osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
   return osUcos3MutexError(err);
 }
 
-osStatus_t osMutexRelease(osMutexId_t mutex_id) {
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout) {
+  UCOS3_TRACE_ENTER(osTraceApiMutexAcquire, mutex_id, timeout);
+  UCOS3_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos3MutexAcquire(mutex_id, timeout);
+  UCOS3_WAIT_END(wait_start, osWaitKindMutex, mutex_id, timeout);
+  UCOS3_TRACE_EXIT(osTraceApiMutexAcquire, mutex_id, status);
+  return status;
+}
+
+static osStatus_t osUcos3MutexRelease(osMutexId_t mutex_id) {
   os_ucos3_mutex_t *mutex = osUcos3MutexFromId(mutex_id);
   if ((mutex == NULL) || !mutex->created) {
     return osErrorParameter;
@@ -969,10 +1339,19 @@ osStatus_t osMutexRelease(osMutexId_t mutex_id) {
   }
 
   OS_ERR err;
+  UCOS3_TRACE_WAKEUP(mutex_id, &mutex->mutex.PendList);
+  UCOS3_INVERSION_SIGNAL(&mutex->inversion, &mutex->mutex.PendList, NULL);
   OSMutexPost(&mutex->mutex, OS_OPT_POST_NONE, &err);
   return osUcos3MutexError(err);
 }
 
+osStatus_t osMutexRelease(osMutexId_t mutex_id) {
+  UCOS3_TRACE_ENTER(osTraceApiMutexRelease, mutex_id, 0u);
+  osStatus_t status = osUcos3MutexRelease(mutex_id);
+  UCOS3_TRACE_EXIT(osTraceApiMutexRelease, mutex_id, status);
+  return status;
+}
+
 osThreadId_t osMutexGetOwner(osMutexId_t mutex_id) {
   os_ucos3_mutex_t *mutex = osUcos3MutexFromId(mutex_id);
   if ((mutex == NULL) || !mutex->created || osUcos3IrqContext()) {
@@ -986,7 +1365,7 @@ osThreadId_t osMutexGetOwner(osMutexId_t mutex_id) {
   return (osThreadId_t)osUcos3ThreadFromTcb(mutex->mutex.OwnerTCBPtr);
 }
 
-osStatus_t osMutexDelete(osMutexId_t mutex_id) {
+static osStatus_t osUcos3MutexDelete(osMutexId_t mutex_id) {
   os_ucos3_mutex_t *mutex = osUcos3MutexFromId(mutex_id);
   if ((mutex == NULL) || !mutex->created) {
     return osErrorParameter;
@@ -1002,6 +1381,13 @@ osStatus_t osMutexDelete(osMutexId_t mutex_id) {
   return osUcos3MutexError(err);
 }
 
+osStatus_t osMutexDelete(osMutexId_t mutex_id) {
+  UCOS3_TRACE_ENTER(osTraceApiMutexDelete, mutex_id, 0u);
+  osStatus_t status = osUcos3MutexDelete(mutex_id);
+  UCOS3_TRACE_EXIT(osTraceApiMutexDelete, mutex_id, status);
+  return status;
+}
+
 /* ==== Semaphore Management ==== */
 
 static osStatus_t osUcos3SemaphoreError(OS_ERR err) {
@@ -1023,9 +1409,9 @@ static osStatus_t osUcos3SemaphoreError(OS_ERR err) {
   }
 }
 
-osSemaphoreId_t osSemaphoreNew(uint32_t max_count,
-                               uint32_t initial_count,
-                               const osSemaphoreAttr_t *attr) {
+static osSemaphoreId_t osUcos3SemaphoreNew(uint32_t max_count,
+                                           uint32_t initial_count,
+                                           const osSemaphoreAttr_t *attr) {
   if (osUcos3IrqContext()) {
     return NULL;
   }
@@ -1057,12 +1443,22 @@ osSemaphoreId_t osSemaphoreNew(uint32_t max_count,
   return (osSemaphoreId_t)sem;
 }
 
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count,
+                               uint32_t initial_count,
+                               const osSemaphoreAttr_t *attr) {
+  UCOS3_TRACE_ENTER(osTraceApiSemaphoreNew, 0u, initial_count);
+  osSemaphoreId_t id = osUcos3SemaphoreNew(max_count, initial_count, attr);
+  UCOS3_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS3_TRACE_EXIT(osTraceApiSemaphoreNew, id, 0u);
+  return id;
+}
+
 const char *osSemaphoreGetName(osSemaphoreId_t semaphore_id) {
   os_ucos3_semaphore_t *sem = osUcos3SemaphoreFromId(semaphore_id);
   return (sem != NULL) ? sem->object.name : NULL;
 }
 
-osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
+static osStatus_t osUcos3SemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
   os_ucos3_semaphore_t *sem = osUcos3SemaphoreFromId(semaphore_id);
   if ((sem == NULL) || !sem->created) {
     return osErrorParameter;
@@ -1073,11 +1469,14 @@ osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
   }
 
   OS_ERR err;
+  UCOS3_INVERSION_BEGIN(semaphore_id, &sem->inversion, &sem->holder, timeout);
   OSSemPend(&sem->sem,
             osUcos3PendTimeout(timeout),
             osUcos3PendOption(timeout),
             NULL,
             &err);
+  UCOS3_INVERSION_END(&sem->holder, err, timeout);
+  UCOS3_INVERSION_TAKE(sem, err);
   if ((timeout == 0u) && (err == OS_ERR_PEND_WOULD_BLOCK)) {
     return osErrorResource;
   }
@@ -1085,17 +1484,38 @@ osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
   return osUcos3SemaphoreError(err);
 }
 
-osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id) {
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout) {
+  UCOS3_TRACE_ENTER(osTraceApiSemaphoreAcquire, semaphore_id, timeout);
+  UCOS3_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos3SemaphoreAcquire(semaphore_id, timeout);
+  UCOS3_WAIT_END(wait_start, osWaitKindSemaphore, semaphore_id, timeout);
+  UCOS3_TRACE_EXIT(osTraceApiSemaphoreAcquire, semaphore_id, status);
+  return status;
+}
+
+static osStatus_t osUcos3SemaphoreRelease(osSemaphoreId_t semaphore_id) {
   os_ucos3_semaphore_t *sem = osUcos3SemaphoreFromId(semaphore_id);
   if ((sem == NULL) || !sem->created) {
     return osErrorParameter;
   }
 
   OS_ERR err;
+  UCOS3_TRACE_WAKEUP(semaphore_id, &sem->sem.PendList);
+  UCOS3_INVERSION_SIGNAL(&sem->inversion, &sem->sem.PendList, &sem->holder);
   OSSemPost(&sem->sem, OS_OPT_POST_1, &err);
+  if (err == OS_ERR_NONE) {
+    UCOS3_WAIT_ANY_NOTIFY(sem->wait_any, false);
+  }
   return osUcos3SemaphoreError(err);
 }
 
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id) {
+  UCOS3_TRACE_ENTER(osTraceApiSemaphoreRelease, semaphore_id, 0u);
+  osStatus_t status = osUcos3SemaphoreRelease(semaphore_id);
+  UCOS3_TRACE_EXIT(osTraceApiSemaphoreRelease, semaphore_id, status);
+  return status;
+}
+
 uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id) {
   os_ucos3_semaphore_t *sem = osUcos3SemaphoreFromId(semaphore_id);
   if ((sem == NULL) || !sem->created) {
@@ -1106,7 +1526,7 @@ uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id) {
   return (uint32_t)sem->sem.Ctr;
 }
 
-osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id) {
+static osStatus_t osUcos3SemaphoreDelete(osSemaphoreId_t semaphore_id) {
   os_ucos3_semaphore_t *sem = osUcos3SemaphoreFromId(semaphore_id);
   if ((sem == NULL) || !sem->created) {
     return osErrorParameter;
@@ -1119,9 +1539,17 @@ osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id) {
   OS_ERR err;
   OSSemDel(&sem->sem, OS_OPT_DEL_ALWAYS, &err);
   sem->created = false;
+  UCOS3_WAIT_ANY_NOTIFY(sem->wait_any, true);
   return osUcos3SemaphoreError(err);
 }
 
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id) {
+  UCOS3_TRACE_ENTER(osTraceApiSemaphoreDelete, semaphore_id, 0u);
+  osStatus_t status = osUcos3SemaphoreDelete(semaphore_id);
+  UCOS3_TRACE_EXIT(osTraceApiSemaphoreDelete, semaphore_id, status);
+  return status;
+}
+
 /* ==== Timer Management ==== */
 
 static void osUcos3TimerThunk(void *p_tmr, void *p_arg) {
@@ -1137,10 +1565,10 @@ static void osUcos3TimerThunk(void *p_tmr, void *p_arg) {
   }
 }
 
-osTimerId_t osTimerNew(osTimerFunc_t func,
-                       osTimerType_t type,
-                       void *argument,
-                       const osTimerAttr_t *attr) {
+static osTimerId_t osUcos3TimerNew(osTimerFunc_t func,
+                                   osTimerType_t type,
+                                   void *argument,
+                                   const osTimerAttr_t *attr) {
   if (osUcos3IrqContext()) {
     return NULL;
   }
@@ -1177,6 +1605,17 @@ osTimerId_t osTimerNew(osTimerFunc_t func,
   return (osTimerId_t)timer;
 }
 
+osTimerId_t osTimerNew(osTimerFunc_t func,
+                       osTimerType_t type,
+                       void *argument,
+                       const osTimerAttr_t *attr) {
+  UCOS3_TRACE_ENTER(osTraceApiTimerNew, 0u, type);
+  osTimerId_t id = osUcos3TimerNew(func, type, argument, attr);
+  UCOS3_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS3_TRACE_EXIT(osTraceApiTimerNew, id, 0u);
+  return id;
+}
+
 const char *osTimerGetName(osTimerId_t timer_id) {
   os_ucos3_timer_t *timer = osUcos3TimerFromId(timer_id);
   return (timer != NULL) ? timer->object.name : NULL;
@@ -1197,7 +1636,7 @@ static osStatus_t osUcos3TimerConfigure(os_ucos3_timer_t *timer, uint32_t ticks)
   return (err == OS_ERR_NONE) ? osOK : osErrorResource;
 }
 
-osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks) {
+static osStatus_t osUcos3TimerStart(osTimerId_t timer_id, uint32_t ticks) {
   os_ucos3_timer_t *timer = osUcos3TimerFromId(timer_id);
   if (timer == NULL) {
     return osErrorParameter;
@@ -1222,7 +1661,14 @@ osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks) {
   return osOK;
 }
 
-osStatus_t osTimerStop(osTimerId_t timer_id) {
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks) {
+  UCOS3_TRACE_ENTER(osTraceApiTimerStart, timer_id, ticks);
+  osStatus_t status = osUcos3TimerStart(timer_id, ticks);
+  UCOS3_TRACE_EXIT(osTraceApiTimerStart, timer_id, status);
+  return status;
+}
+
+static osStatus_t osUcos3TimerStop(osTimerId_t timer_id) {
   os_ucos3_timer_t *timer = osUcos3TimerFromId(timer_id);
   if (timer == NULL) {
     return osErrorParameter;
@@ -1242,6 +1688,13 @@ osStatus_t osTimerStop(osTimerId_t timer_id) {
   return osOK;
 }
 
+osStatus_t osTimerStop(osTimerId_t timer_id) {
+  UCOS3_TRACE_ENTER(osTraceApiTimerStop, timer_id, 0u);
+  osStatus_t status = osUcos3TimerStop(timer_id);
+  UCOS3_TRACE_EXIT(osTraceApiTimerStop, timer_id, status);
+  return status;
+}
+
 uint32_t osTimerIsRunning(osTimerId_t timer_id) {
   os_ucos3_timer_t *timer = osUcos3TimerFromId(timer_id);
   if ((timer == NULL) || osUcos3IrqContext()) {
@@ -1257,7 +1710,7 @@ uint32_t osTimerIsRunning(osTimerId_t timer_id) {
   return (state == OS_TMR_STATE_RUNNING) ? 1u : 0u;
 }
 
-osStatus_t osTimerDelete(osTimerId_t timer_id) {
+static osStatus_t osUcos3TimerDelete(osTimerId_t timer_id) {
   os_ucos3_timer_t *timer = osUcos3TimerFromId(timer_id);
   if (timer == NULL) {
     return osErrorParameter;
@@ -1273,9 +1726,16 @@ osStatus_t osTimerDelete(osTimerId_t timer_id) {
   return (err == OS_ERR_NONE) ? osOK : osErrorResource;
 }
 
+osStatus_t osTimerDelete(osTimerId_t timer_id) {
+  UCOS3_TRACE_ENTER(osTraceApiTimerDelete, timer_id, 0u);
+  osStatus_t status = osUcos3TimerDelete(timer_id);
+  UCOS3_TRACE_EXIT(osTraceApiTimerDelete, timer_id, status);
+  return status;
+}
+
 /* ==== Event Flags Management ==== */
 
-osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr) {
+static osEventFlagsId_t osUcos3EventFlagsNew(const osEventFlagsAttr_t *attr) {
   if (osUcos3IrqContext()) {
     return NULL;
   }
@@ -1303,23 +1763,42 @@ osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr) {
   return (osEventFlagsId_t)ef;
 }
 
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr) {
+  UCOS3_TRACE_ENTER(osTraceApiEventFlagsNew, 0u, 0u);
+  osEventFlagsId_t id = osUcos3EventFlagsNew(attr);
+  UCOS3_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS3_TRACE_EXIT(osTraceApiEventFlagsNew, id, 0u);
+  return id;
+}
+
 const char *osEventFlagsGetName(osEventFlagsId_t ef_id) {
   os_ucos3_event_flags_t *ef = osUcos3EventFlagsFromId(ef_id);
   return (ef != NULL) ? ef->object.name : NULL;
 }
 
-uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
+static uint32_t osUcos3EventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
   os_ucos3_event_flags_t *ef = osUcos3EventFlagsFromId(ef_id);
   if ((ef == NULL) || !ef->created || !osUcos3FlagsValid(flags)) {
     return osFlagsErrorParameter;
   }
 
   OS_ERR err;
+  UCOS3_TRACE_WAKEUP(ef_id, &ef->grp.PendList);
   OS_FLAGS result = OSFlagPost(&ef->grp, (OS_FLAGS)flags, OS_OPT_POST_FLAG_SET, &err);
+  if (err == OS_ERR_NONE) {
+    UCOS3_WAIT_ANY_NOTIFY(ef->wait_any, false);
+  }
   return (err == OS_ERR_NONE) ? (uint32_t)result : osUcos3EventFlagsError(err);
 }
 
-uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags) {
+  UCOS3_TRACE_ENTER(osTraceApiEventFlagsSet, ef_id, flags);
+  uint32_t result = osUcos3EventFlagsSet(ef_id, flags);
+  UCOS3_TRACE_EXIT(osTraceApiEventFlagsSet, ef_id, result);
+  return result;
+}
+
+static uint32_t osUcos3EventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
   os_ucos3_event_flags_t *ef = osUcos3EventFlagsFromId(ef_id);
   if ((ef == NULL) || !ef->created || !osUcos3FlagsValid(flags)) {
     return osFlagsErrorParameter;
@@ -1330,6 +1809,13 @@ uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
   return (err == OS_ERR_NONE) ? (uint32_t)result : osUcos3EventFlagsError(err);
 }
 
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags) {
+  UCOS3_TRACE_ENTER(osTraceApiEventFlagsClear, ef_id, flags);
+  uint32_t result = osUcos3EventFlagsClear(ef_id, flags);
+  UCOS3_TRACE_EXIT(osTraceApiEventFlagsClear, ef_id, result);
+  return result;
+}
+
 uint32_t osEventFlagsGet(osEventFlagsId_t ef_id) {
   os_ucos3_event_flags_t *ef = osUcos3EventFlagsFromId(ef_id);
   if ((ef == NULL) || !ef->created) {
@@ -1340,10 +1826,10 @@ uint32_t osEventFlagsGet(osEventFlagsId_t ef_id) {
   return (uint32_t)ef->grp.Flags;
 }
 
-uint32_t osEventFlagsWait(osEventFlagsId_t ef_id,
-                          uint32_t flags,
-                          uint32_t options,
-                          uint32_t timeout) {
+static uint32_t osUcos3EventFlagsWait(osEventFlagsId_t ef_id,
+                                      uint32_t flags,
+                                      uint32_t options,
+                                      uint32_t timeout) {
   os_ucos3_event_flags_t *ef = osUcos3EventFlagsFromId(ef_id);
   if ((ef == NULL) || !ef->created ||
       !osUcos3FlagsValid(flags) ||
@@ -1365,7 +1851,19 @@ uint32_t osEventFlagsWait(osEventFlagsId_t ef_id,
   return (err == OS_ERR_NONE) ? (uint32_t)result : osUcos3EventFlagsError(err);
 }
 
-osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id,
+                          uint32_t flags,
+                          uint32_t options,
+                          uint32_t timeout) {
+  UCOS3_TRACE_ENTER(osTraceApiEventFlagsWait, ef_id, flags);
+  UCOS3_WAIT_BEGIN(wait_start);
+  uint32_t result = osUcos3EventFlagsWait(ef_id, flags, options, timeout);
+  UCOS3_WAIT_END(wait_start, osWaitKindEventFlags, ef_id, timeout);
+  UCOS3_TRACE_EXIT(osTraceApiEventFlagsWait, ef_id, result);
+  return result;
+}
+
+static osStatus_t osUcos3EventFlagsDelete(osEventFlagsId_t ef_id) {
   os_ucos3_event_flags_t *ef = osUcos3EventFlagsFromId(ef_id);
   if ((ef == NULL) || !ef->created) {
     return osErrorParameter;
@@ -1378,6 +1876,7 @@ osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
   OS_ERR err;
   OSFlagDel(&ef->grp, OS_OPT_DEL_ALWAYS, &err);
   ef->created = false;
+  UCOS3_WAIT_ANY_NOTIFY(ef->wait_any, true);
   if ((err == OS_ERR_OBJ_PTR_NULL) || (err == OS_ERR_OBJ_TYPE)) {
     return osErrorParameter;
   }
@@ -1385,6 +1884,13 @@ osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
   return (err == OS_ERR_NONE) ? osOK : osErrorResource;
 }
 
+osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id) {
+  UCOS3_TRACE_ENTER(osTraceApiEventFlagsDelete, ef_id, 0u);
+  osStatus_t status = osUcos3EventFlagsDelete(ef_id);
+  UCOS3_TRACE_EXIT(osTraceApiEventFlagsDelete, ef_id, status);
+  return status;
+}
+
 /* ==== Message Queue Management ==== */
 
 static osStatus_t osUcos3MessageQueueError(OS_ERR err) {
@@ -1414,9 +1920,9 @@ static inline void *osUcos3AlignPtr(void *ptr, size_t align) {
   return (void *)p;
 }
 
-osMessageQueueId_t osMessageQueueNew(uint32_t msg_count,
-                                     uint32_t msg_size,
-                                     const osMessageQueueAttr_t *attr) {
+static osMessageQueueId_t osUcos3MessageQueueNew(uint32_t msg_count,
+                                                 uint32_t msg_size,
+                                                 const osMessageQueueAttr_t *attr) {
   if (osUcos3IrqContext()) {
     return NULL;
   }
@@ -1488,15 +1994,25 @@ osMessageQueueId_t osMessageQueueNew(uint32_t msg_count,
   return (osMessageQueueId_t)mq;
 }
 
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count,
+                                     uint32_t msg_size,
+                                     const osMessageQueueAttr_t *attr) {
+  UCOS3_TRACE_ENTER(osTraceApiMessageQueueNew, 0u, msg_count);
+  osMessageQueueId_t id = osUcos3MessageQueueNew(msg_count, msg_size, attr);
+  UCOS3_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS3_TRACE_EXIT(osTraceApiMessageQueueNew, id, 0u);
+  return id;
+}
+
 const char *osMessageQueueGetName(osMessageQueueId_t mq_id) {
   os_ucos3_message_queue_t *mq = osUcos3MessageQueueFromId(mq_id);
   return (mq != NULL) ? mq->object.name : NULL;
 }
 
-osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id,
-                             const void *msg_ptr,
-                             uint8_t msg_prio,
-                             uint32_t timeout) {
+static osStatus_t osUcos3MessageQueuePut(osMessageQueueId_t mq_id,
+                                         const void *msg_ptr,
+                                         uint8_t msg_prio,
+                                         uint32_t timeout) {
   (void)msg_prio;
 
   os_ucos3_message_queue_t *mq = osUcos3MessageQueueFromId(mq_id);
@@ -1537,6 +2053,7 @@ osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id,
 
   memcpy(message, msg_ptr, mq->msg_size);
 
+  UCOS3_TRACE_WAKEUP(mq_id, &mq->queue.PendList);
   OSQPost(&mq->queue,
           message,
           (OS_MSG_SIZE)mq->msg_size,
@@ -1555,13 +2072,26 @@ osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id,
     return osUcos3MessageQueueError(err);
   }
 
+  UCOS3_WAIT_ANY_NOTIFY(mq->wait_any, false);
   return osOK;
 }
 
-osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id,
-                             void *msg_ptr,
-                             uint8_t *msg_prio,
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id,
+                             const void *msg_ptr,
+                             uint8_t msg_prio,
                              uint32_t timeout) {
+  UCOS3_TRACE_ENTER(osTraceApiMessageQueuePut, mq_id, timeout);
+  UCOS3_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos3MessageQueuePut(mq_id, msg_ptr, msg_prio, timeout);
+  UCOS3_WAIT_END(wait_start, osWaitKindMessageQueue, mq_id, timeout);
+  UCOS3_TRACE_EXIT(osTraceApiMessageQueuePut, mq_id, status);
+  return status;
+}
+
+static osStatus_t osUcos3MessageQueueGet(osMessageQueueId_t mq_id,
+                                         void *msg_ptr,
+                                         uint8_t *msg_prio,
+                                         uint32_t timeout) {
   if (msg_prio != NULL) {
     *msg_prio = 0u;
   }
@@ -1605,11 +2135,24 @@ osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id,
   }
   CPU_CRITICAL_EXIT();
 
+  UCOS3_TRACE_WAKEUP(mq_id, &mq->space_sem.PendList);
   (void)OSSemPost(&mq->space_sem, OS_OPT_POST_1, &err);
 
   return osOK;
 }
 
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id,
+                             void *msg_ptr,
+                             uint8_t *msg_prio,
+                             uint32_t timeout) {
+  UCOS3_TRACE_ENTER(osTraceApiMessageQueueGet, mq_id, timeout);
+  UCOS3_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos3MessageQueueGet(mq_id, msg_ptr, msg_prio, timeout);
+  UCOS3_WAIT_END(wait_start, osWaitKindMessageQueue, mq_id, timeout);
+  UCOS3_TRACE_EXIT(osTraceApiMessageQueueGet, mq_id, status);
+  return status;
+}
+
 uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id) {
   os_ucos3_message_queue_t *mq = osUcos3MessageQueueFromId(mq_id);
   return (mq != NULL) ? mq->msg_count : 0u;
@@ -1640,7 +2183,7 @@ uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id) {
   return (uint32_t)mq->space_sem.Ctr;
 }
 
-osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id) {
+static osStatus_t osUcos3MessageQueueReset(osMessageQueueId_t mq_id) {
   os_ucos3_message_queue_t *mq = osUcos3MessageQueueFromId(mq_id);
   if ((mq == NULL) || !mq->created) {
     return osErrorParameter;
@@ -1669,7 +2212,14 @@ osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id) {
   return (err == OS_ERR_NONE) ? osOK : osErrorResource;
 }
 
-osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id) {
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id) {
+  UCOS3_TRACE_ENTER(osTraceApiMessageQueueReset, mq_id, 0u);
+  osStatus_t status = osUcos3MessageQueueReset(mq_id);
+  UCOS3_TRACE_EXIT(osTraceApiMessageQueueReset, mq_id, status);
+  return status;
+}
+
+static osStatus_t osUcos3MessageQueueDelete(osMessageQueueId_t mq_id) {
   os_ucos3_message_queue_t *mq = osUcos3MessageQueueFromId(mq_id);
   if ((mq == NULL) || !mq->created) {
     return osErrorParameter;
@@ -1691,5 +2241,3172 @@ osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id) {
   }
 
   mq->created = false;
+  UCOS3_WAIT_ANY_NOTIFY(mq->wait_any, true);
+  return osOK;
+}
+
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id) {
+  UCOS3_TRACE_ENTER(osTraceApiMessageQueueDelete, mq_id, 0u);
+  osStatus_t status = osUcos3MessageQueueDelete(mq_id);
+  UCOS3_TRACE_EXIT(osTraceApiMessageQueueDelete, mq_id, status);
+  return status;
+}
+
+/* ==== Memory Pool Management ==== */
+
+#define UCOS3_POOL_NIL                 0xFFFFu
+#define UCOS3_POOL_BUSY                0xFFFEu   /* free_stack entry of an allocated block */
+
+os_ucos3_memory_pool_t *osUcos3MemoryPoolFromId(osMemoryPoolId_t mp_id) {
+  if (mp_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos3_memory_pool_t *mp = (os_ucos3_memory_pool_t *)mp_id;
+  return (mp->object.type == osUcos3ObjectMemoryPool) ? mp : NULL;
+}
+
+#if (UCOS3_LOCKFREE_EN > 0u)
+/* Treiber stack: the tag in the upper half of free_top changes on every
+ * update, so a pop that read a stale next index fails its compare-and-swap
+ * instead of corrupting the list (ABA). */
+static uint32_t osUcos3PoolPop(os_ucos3_memory_pool_t *mp) {
+  uint32_t head = *(volatile uint32_t *)&mp->free_top;
+  uint32_t index;
+  do {
+    index = head & 0xFFFFu;
+    if (index == UCOS3_POOL_NIL) {
+      return UCOS3_POOL_NIL;
+    }
+    uint32_t next = ((volatile uint16_t *)mp->free_stack)[index];
+    uint32_t desired = ((head + 0x10000u) & 0xFFFF0000u) | next;
+    if (UCOS3_ATOMIC_CAS(&mp->free_top, &head, desired)) {
+      break;
+    }
+  } while (true);
+  ((volatile uint16_t *)mp->free_stack)[index] = UCOS3_POOL_BUSY;
+  (void)UCOS3_ATOMIC_ADD(&mp->used, 1u);
+  return index;
+}
+
+/* Refuses a block that is not marked allocated, or any block once used has
+ * dropped to zero, so a double free cannot link an index twice. used is
+ * claimed before the push; two contexts freeing the same block at the same
+ * time can still both pass the mark check. */
+static bool osUcos3PoolPush(os_ucos3_memory_pool_t *mp, uint32_t index) {
+  volatile uint16_t *entry = &((volatile uint16_t *)mp->free_stack)[index];
+  uint32_t used = *(volatile uint32_t *)&mp->used;
+  do {
+    if ((used == 0u) || (*entry != UCOS3_POOL_BUSY)) {
+      return false;
+    }
+  } while (!UCOS3_ATOMIC_CAS(&mp->used, &used, used - 1u));
+
+  uint32_t head = *(volatile uint32_t *)&mp->free_top;
+  do {
+    *entry = (uint16_t)(head & 0xFFFFu);
+  } while (!UCOS3_ATOMIC_CAS(&mp->free_top, &head, ((head + 0x10000u) & 0xFFFF0000u) | index));
+  return true;
+}
+
+/* A read-modify-write, so the check is ordered after the push before it. */
+static uint32_t osUcos3PoolWaiters(os_ucos3_memory_pool_t *mp, uint32_t delta) {
+  return UCOS3_ATOMIC_ADD(&mp->waiters, delta) + delta;
+}
+#else
+static uint32_t osUcos3PoolPop(os_ucos3_memory_pool_t *mp) {
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  uint32_t index = mp->free_top & 0xFFFFu;
+  if (index != UCOS3_POOL_NIL) {
+    mp->free_top = mp->free_stack[index];
+    mp->free_stack[index] = UCOS3_POOL_BUSY;
+    mp->used++;
+  }
+  CPU_CRITICAL_EXIT();
+  return index;
+}
+
+/* Refuses a block that is not marked allocated (double free). */
+static bool osUcos3PoolPush(os_ucos3_memory_pool_t *mp, uint32_t index) {
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  bool busy = (mp->used != 0u) && (mp->free_stack[index] == UCOS3_POOL_BUSY);
+  if (busy) {
+    mp->free_stack[index] = (uint16_t)mp->free_top;
+    mp->free_top = index;
+    mp->used--;
+  }
+  CPU_CRITICAL_EXIT();
+  return busy;
+}
+
+static uint32_t osUcos3PoolWaiters(os_ucos3_memory_pool_t *mp, uint32_t delta) {
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  mp->waiters += delta;
+  uint32_t waiters = mp->waiters;
+  CPU_CRITICAL_EXIT();
+  return waiters;
+}
+#endif
+
+static osMemoryPoolId_t osUcos3MemoryPoolNew(uint32_t block_count,
+                                             uint32_t block_size,
+                                             const osMemoryPoolAttr_t *attr) {
+  if (osUcos3IrqContext()) {
+    return NULL;
+  }
+
+  if ((block_count == 0u) ||
+      (block_count >= UCOS3_POOL_BUSY) ||
+      (block_size == 0u) ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos3_memory_pool_t))) {
+    return NULL;
+  }
+
+  /* Like message queues, pools are fully static: blocks live in mp_mem and
+   * the free list in the cb_size bytes after the control block. */
+  const uint32_t stride = (block_size + (uint32_t)sizeof(void *) - 1u) & ~((uint32_t)sizeof(void *) - 1u);
+  if ((attr->mp_mem == NULL) ||
+      (((uintptr_t)attr->mp_mem & (sizeof(void *) - 1u)) != 0u) ||
+      (attr->mp_size < (block_count * stride))) {
+    return NULL;
+  }
+
+  os_ucos3_memory_pool_t *mp = (os_ucos3_memory_pool_t *)attr->cb_mem;
+  uint8_t *cb_base = (uint8_t *)mp;
+  void *stack_aligned = osUcos3AlignPtr(cb_base + sizeof(*mp), sizeof(uint16_t));
+  size_t used = (size_t)((uint8_t *)stack_aligned - cb_base);
+  if ((attr->cb_size < used) || (((attr->cb_size - used) / sizeof(uint16_t)) < block_count)) {
+    return NULL;
+  }
+
+  memset(mp, 0, sizeof(*mp));
+  osUcos3ObjectInit(&mp->object, osUcos3ObjectMemoryPool, attr->name, attr->attr_bits);
+  mp->pool_mem = (uint8_t *)attr->mp_mem;
+  mp->free_stack = (uint16_t *)stack_aligned;
+  mp->block_size = stride;
+  mp->block_count = block_count;
+  for (uint32_t i = 0u; i < block_count; ++i) {
+    mp->free_stack[i] = (uint16_t)(((i + 1u) < block_count) ? (i + 1u) : UCOS3_POOL_NIL);
+  }
+  mp->free_top = 0u;
+
+  OS_ERR err;
+  OSSemCreate(&mp->wait_sem,
+              (CPU_CHAR *)(attr->name != NULL ? attr->name : "cmsis.mp"),
+              (OS_SEM_CTR)0u,
+              &err);
+  if (err != OS_ERR_NONE) {
+    return NULL;
+  }
+
+  mp->created = true;
+  return (osMemoryPoolId_t)mp;
+}
+
+osMemoryPoolId_t osMemoryPoolNew(uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t *attr) {
+  UCOS3_TRACE_ENTER(osTraceApiMemoryPoolNew, 0u, block_count);
+  osMemoryPoolId_t id = osUcos3MemoryPoolNew(block_count, block_size, attr);
+  UCOS3_TRACE_NAME(id, (attr != NULL) ? attr->name : NULL);
+  UCOS3_TRACE_EXIT(osTraceApiMemoryPoolNew, id, 0u);
+  return id;
+}
+
+const char *osMemoryPoolGetName(osMemoryPoolId_t mp_id) {
+  os_ucos3_memory_pool_t *mp = osUcos3MemoryPoolFromId(mp_id);
+  return (mp != NULL) ? mp->object.name : NULL;
+}
+
+static void *osUcos3MemoryPoolTake(os_ucos3_memory_pool_t *mp) {
+  uint32_t index = osUcos3PoolPop(mp);
+  return (index != UCOS3_POOL_NIL) ? (void *)(mp->pool_mem + (index * mp->block_size)) : NULL;
+}
+
+/* Register as a waiter before the last attempt: a free either sees the
+ * registration and posts wait_sem, or pushes before the attempt and the
+ * attempt finds the block. Stale posts only cause another attempt. */
+static void *osUcos3MemoryPoolWait(os_ucos3_memory_pool_t *mp, uint32_t timeout) {
+  const uint32_t start = osKernelGetTickCount();
+  for (;;) {
+    OS_TICK pend_timeout = (OS_TICK)0u;
+    if (timeout != osWaitForever) {
+      uint32_t elapsed = osKernelGetTickCount() - start;
+      if (elapsed >= timeout) {
+        return NULL;
+      }
+      pend_timeout = (OS_TICK)(timeout - elapsed);
+    }
+
+    (void)osUcos3PoolWaiters(mp, 1u);
+    void *block = osUcos3MemoryPoolTake(mp);
+    OS_ERR err = OS_ERR_NONE;
+    if (block == NULL) {
+      OSSemPend(&mp->wait_sem, pend_timeout, OS_OPT_PEND_BLOCKING, NULL, &err);
+    }
+    (void)osUcos3PoolWaiters(mp, (uint32_t)-1);
+    if (block != NULL) {
+      return block;
+    }
+    if (err != OS_ERR_NONE) {
+      return (err == OS_ERR_TIMEOUT) ? osUcos3MemoryPoolTake(mp) : NULL;
+    }
+  }
+}
+
+static void *osUcos3MemoryPoolAlloc(osMemoryPoolId_t mp_id, uint32_t timeout) {
+  os_ucos3_memory_pool_t *mp = osUcos3MemoryPoolFromId(mp_id);
+  if ((mp == NULL) || !mp->created || osUcos3IsrDisallowsWait(timeout)) {
+    return NULL;
+  }
+
+  void *block = osUcos3MemoryPoolTake(mp);
+  if ((block != NULL) || (timeout == 0u)) {
+    return block;
+  }
+  return osUcos3MemoryPoolWait(mp, timeout);
+}
+
+void *osMemoryPoolAlloc(osMemoryPoolId_t mp_id, uint32_t timeout) {
+  UCOS3_TRACE_ENTER(osTraceApiMemoryPoolAlloc, mp_id, timeout);
+  UCOS3_WAIT_BEGIN(wait_start);
+  void *block = osUcos3MemoryPoolAlloc(mp_id, timeout);
+  UCOS3_WAIT_END(wait_start, osWaitKindMemoryPool, mp_id, timeout);
+  UCOS3_TRACE_EXIT(osTraceApiMemoryPoolAlloc, mp_id, UCOS3_TRACE_ID(block));
+  return block;
+}
+
+static osStatus_t osUcos3MemoryPoolFree(osMemoryPoolId_t mp_id, void *block) {
+  os_ucos3_memory_pool_t *mp = osUcos3MemoryPoolFromId(mp_id);
+  if ((mp == NULL) || !mp->created || (block == NULL)) {
+    return osErrorParameter;
+  }
+
+  uintptr_t offset = (uintptr_t)block - (uintptr_t)mp->pool_mem;
+  if (((uintptr_t)block < (uintptr_t)mp->pool_mem) ||
+      (offset >= ((uintptr_t)mp->block_count * mp->block_size)) ||
+      ((offset % mp->block_size) != 0u)) {
+    return osErrorParameter;
+  }
+
+  if (!osUcos3PoolPush(mp, (uint32_t)(offset / mp->block_size))) {
+    return osErrorResource;
+  }
+  if (osUcos3PoolWaiters(mp, 0u) != 0u) {
+    OS_ERR err;
+    OSSemPost(&mp->wait_sem, OS_OPT_POST_1, &err);
+  }
+  return osOK;
+}
+
+osStatus_t osMemoryPoolFree(osMemoryPoolId_t mp_id, void *block) {
+  UCOS3_TRACE_ENTER(osTraceApiMemoryPoolFree, mp_id, UCOS3_TRACE_ID(block));
+  osStatus_t status = osUcos3MemoryPoolFree(mp_id, block);
+  UCOS3_TRACE_EXIT(osTraceApiMemoryPoolFree, mp_id, status);
+  return status;
+}
+
+uint32_t osMemoryPoolGetCapacity(osMemoryPoolId_t mp_id) {
+  os_ucos3_memory_pool_t *mp = osUcos3MemoryPoolFromId(mp_id);
+  return ((mp != NULL) && mp->created) ? mp->block_count : 0u;
+}
+
+uint32_t osMemoryPoolGetBlockSize(osMemoryPoolId_t mp_id) {
+  os_ucos3_memory_pool_t *mp = osUcos3MemoryPoolFromId(mp_id);
+  return ((mp != NULL) && mp->created) ? mp->block_size : 0u;
+}
+
+static uint32_t osUcos3MemoryPoolGetCount(osMemoryPoolId_t mp_id) {
+  os_ucos3_memory_pool_t *mp = osUcos3MemoryPoolFromId(mp_id);
+  if ((mp == NULL) || !mp->created) {
+    return 0u;
+  }
+  uint32_t used = *(volatile uint32_t *)&mp->used;
+  return (used <= mp->block_count) ? used : mp->block_count;
+}
+
+uint32_t osMemoryPoolGetCount(osMemoryPoolId_t mp_id) {
+  UCOS3_TRACE_ENTER(osTraceApiMemoryPoolGetCount, mp_id, 0u);
+  uint32_t count = osUcos3MemoryPoolGetCount(mp_id);
+  UCOS3_TRACE_EXIT(osTraceApiMemoryPoolGetCount, mp_id, count);
+  return count;
+}
+
+uint32_t osMemoryPoolGetSpace(osMemoryPoolId_t mp_id) {
+  os_ucos3_memory_pool_t *mp = osUcos3MemoryPoolFromId(mp_id);
+  if ((mp == NULL) || !mp->created) {
+    return 0u;
+  }
+  return mp->block_count - osUcos3MemoryPoolGetCount(mp_id);
+}
+
+static osStatus_t osUcos3MemoryPoolDelete(osMemoryPoolId_t mp_id) {
+  os_ucos3_memory_pool_t *mp = osUcos3MemoryPoolFromId(mp_id);
+  if ((mp == NULL) || !mp->created) {
+    return osErrorParameter;
+  }
+
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  mp->created = false;
+  OS_ERR err;
+  OSSemDel(&mp->wait_sem, OS_OPT_DEL_ALWAYS, &err);
+  return (err == OS_ERR_NONE) ? osOK : osError;
+}
+
+osStatus_t osMemoryPoolDelete(osMemoryPoolId_t mp_id) {
+  UCOS3_TRACE_ENTER(osTraceApiMemoryPoolDelete, mp_id, 0u);
+  osStatus_t status = osUcos3MemoryPoolDelete(mp_id);
+  UCOS3_TRACE_EXIT(osTraceApiMemoryPoolDelete, mp_id, status);
+  return status;
+}
+
+/* ==== CPU Usage ==== */
+
+#if (UCOS3_CPU_USAGE_EN > 0u)
+static os_ucos3_cpu_usage_t *osUcos3CpuUsageOf(const OS_TCB *ptcb) {
+  if (ptcb == &OSIdleTaskTCB) {
+    return &os_ucos3_kernel.cpu_idle;
+  }
+
+  os_ucos3_thread_t *thread = osUcos3ThreadFromExt(ptcb);
+  return (thread != NULL) ? &thread->cpu : &os_ucos3_kernel.cpu_kernel;
+}
+
+static void osUcos3CpuCharge(os_ucos3_cpu_usage_t *cpu, uint32_t cycles) {
+  uint32_t epoch = os_ucos3_kernel.cpu_epoch;
+  uint32_t slot = epoch % UCOS3_CPU_USAGE_RING;
+
+  /* Slots are reset lazily: a stale epoch tag means the slot belongs to an
+   * older window and is reused for the current one. */
+  if (cpu->slot_epoch[slot] != epoch) {
+    cpu->slot_epoch[slot] = epoch;
+    cpu->slot_cycles[slot] = 0u;
+  }
+  cpu->slot_cycles[slot] += cycles;
+  cpu->cycles += cycles;
+}
+
+/* Sum of the UCOS3_CPU_USAGE_SLOTS slots completed before epoch; cpu NULL
+ * sums the slot lengths. Caller holds the critical section. */
+static uint64_t osUcos3CpuWindow(const os_ucos3_cpu_usage_t *cpu, uint32_t epoch) {
+  uint64_t total = 0u;
+  for (uint32_t back = 1u; back <= UCOS3_CPU_USAGE_SLOTS; ++back) {
+    uint32_t past = epoch - back;
+    if (past == 0u) {
+      break;
+    }
+    uint32_t slot = past % UCOS3_CPU_USAGE_RING;
+    if (cpu == NULL) {
+      total += os_ucos3_kernel.cpu_slot_len[slot];
+    } else if (cpu->slot_epoch[slot] == past) {
+      total += cpu->slot_cycles[slot];
+    }
+  }
+  return total;
+}
+
+static uint32_t osUcos3CpuLoad(uint64_t busy, uint64_t window) {
+  if (window == 0u) {
+    return 0u;
+  }
+  uint64_t load = (busy * osCpuUsageScale) / window;
+  return (load > osCpuUsageScale) ? osCpuUsageScale : (uint32_t)load;
+}
+
+/* Raw counters of one thread (or the idle/kernel account), copied in a
+ * critical section of their own; busy is its share of the window ending at
+ * epoch. The division is left to the caller, with interrupts enabled. */
+typedef struct os_ucos3_cpu_sample {
+  uint64_t cycles;
+  uint64_t busy;
+  uint32_t switches;
+} os_ucos3_cpu_sample_t;
+
+static void osUcos3CpuSample(const OS_TCB *ptcb,
+                            const os_ucos3_cpu_usage_t *cpu,
+                            uint32_t epoch,
+                            os_ucos3_cpu_sample_t *sample) {
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  sample->cycles = cpu->cycles;
+  if ((ptcb != NULL) && (ptcb == OSTCBCurPtr) && os_ucos3_kernel.state == osKernelRunning) {
+    sample->cycles += (uint32_t)(UCOS3_TS_GET() - os_ucos3_kernel.cpu_last_ts);
+  }
+  sample->switches = cpu->switches;
+  sample->busy = osUcos3CpuWindow(cpu, epoch);
+  CPU_CRITICAL_EXIT();
+}
+
+static void osUcos3CpuUsageFrom(const os_ucos3_cpu_sample_t *sample, uint64_t window, osThreadCpuUsage_t *usage) {
+  usage->cycles = sample->cycles;
+  usage->switches = sample->switches;
+  usage->usage = osUcos3CpuLoad(sample->busy, window);
+}
+
+/* Epoch of the slot being filled and the length of the window before it. */
+static uint32_t osUcos3CpuEpoch(uint64_t *window) {
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  uint32_t epoch = os_ucos3_kernel.cpu_epoch;
+  *window = osUcos3CpuWindow(NULL, epoch);
+  CPU_CRITICAL_EXIT();
+  return epoch;
+}
+#endif
+
+void osUcos3TaskSwHook(void) {
+#if (UCOS3_CPU_USAGE_EN > 0u)
+  /* Called by OSTaskSwHook with interrupts disabled: OSTCBCurPtr is the
+   * outgoing task, OSTCBHighRdyPtr the incoming one. */
+  uint32_t now = UCOS3_TS_GET();
+  osUcos3CpuCharge(osUcos3CpuUsageOf(OSTCBCurPtr), now - os_ucos3_kernel.cpu_last_ts);
+  os_ucos3_kernel.cpu_last_ts = now;
+  osUcos3CpuUsageOf(OSTCBHighRdyPtr)->switches++;
+#endif
+#if (UCOS3_TRACE_EN > 0u)
+  osUcos3TraceSwitch(OSTCBCurPtr, OSTCBHighRdyPtr);
+#endif
+}
+
+void osUcos3TimeTickHook(void) {
+#if (UCOS3_CPU_USAGE_EN > 0u)
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  if (++os_ucos3_kernel.cpu_slot_tick >= (UCOS3_CPU_USAGE_WINDOW_TICKS / UCOS3_CPU_USAGE_SLOTS)) {
+    uint32_t now = UCOS3_TS_GET();
+    uint32_t slot = os_ucos3_kernel.cpu_epoch % UCOS3_CPU_USAGE_RING;
+
+    osUcos3CpuCharge(osUcos3CpuUsageOf(OSTCBCurPtr), now - os_ucos3_kernel.cpu_last_ts);
+    os_ucos3_kernel.cpu_last_ts = now;
+    os_ucos3_kernel.cpu_slot_len[slot] = now - os_ucos3_kernel.cpu_slot_ts;
+    os_ucos3_kernel.cpu_slot_ts = now;
+    os_ucos3_kernel.cpu_slot_tick = 0u;
+    os_ucos3_kernel.cpu_epoch++;
+  }
+  CPU_CRITICAL_EXIT();
+#endif
+#if (UCOS3_TRACE_EN > 0u)
+  osUcos3TraceEmit(osTraceEventTick, 0u, (uint32_t)OSTickCtr);
+#endif
+#if (UCOS3_PROFILER_EN > 0u)
+  osUcos3ProfilerSample();
+#endif
+#if (UCOS3_ACTIVE_EN > 0u)
+  osUcos3TimeEventTick();
+#endif
+}
+
+osStatus_t osThreadGetCpuUsage(osThreadId_t thread_id, osThreadCpuUsage_t *usage) {
+#if (UCOS3_CPU_USAGE_EN > 0u)
+  os_ucos3_thread_t *thread = osUcos3ThreadFromId(thread_id);
+  if ((thread == NULL) || (usage == NULL)) {
+    return osErrorParameter;
+  }
+
+  uint64_t window;
+  uint32_t epoch = osUcos3CpuEpoch(&window);
+  os_ucos3_cpu_sample_t sample;
+  osUcos3CpuSample(&thread->tcb, &thread->cpu, epoch, &sample);
+  osUcos3CpuUsageFrom(&sample, window, usage);
+  return osOK;
+#else
+  (void)thread_id;
+  (void)usage;
+  return osError;
+#endif
+}
+
+uint32_t osKernelGetCpuUsage(osThreadCpuUsageInfo_t *info, uint32_t max_count, osCpuUsageSummary_t *summary) {
+#if (UCOS3_CPU_USAGE_EN > 0u)
+  if ((info == NULL) && (max_count != 0u)) {
+    return 0u;
+  }
+
+  /* The scheduler lock keeps the thread list still while interrupts stay
+   * enabled; each thread's counters are copied in a short critical section.
+   * Loads are over the window before the epoch read here, even if a slot
+   * completes during the walk. */
+  uint32_t count = 0u;
+  int32_t lock = osUcos3KernelLock();
+  uint64_t window;
+  uint32_t epoch = osUcos3CpuEpoch(&window);
+  os_ucos3_object_t *cursor = os_ucos3_kernel.threads.head;
+  while ((cursor != NULL) && (count < max_count)) {
+    os_ucos3_thread_t *thread = (os_ucos3_thread_t *)cursor;
+    os_ucos3_cpu_sample_t sample;
+    osUcos3CpuSample(&thread->tcb, &thread->cpu, epoch, &sample);
+    info[count].thread_id = (osThreadId_t)thread;
+    info[count].name = thread->object.name;
+    osUcos3CpuUsageFrom(&sample, window, &info[count].usage);
+    count++;
+    cursor = cursor->next;
+  }
+  if (lock >= 0) {
+    (void)osUcos3KernelRestoreLock(lock);
+  }
+  if (summary != NULL) {
+    os_ucos3_cpu_sample_t idle;
+    os_ucos3_cpu_sample_t kernel;
+    osUcos3CpuSample(NULL, &os_ucos3_kernel.cpu_idle, epoch, &idle);
+    osUcos3CpuSample(NULL, &os_ucos3_kernel.cpu_kernel, epoch, &kernel);
+    summary->window_cycles = window;
+    summary->idle_usage = osUcos3CpuLoad(idle.busy, window);
+    summary->kernel_usage = osUcos3CpuLoad(kernel.busy, window);
+  }
+  return count;
+#else
+  (void)info;
+  (void)max_count;
+  (void)summary;
+  return 0u;
+#endif
+}
+
+/* ==== Stack Profiler ==== */
+
+#if (UCOS3_STACK_PROFILER_EN > 0u)
+static os_ucos3_thread_t os_ucos3_stk_prof_cb;
+static CPU_STK os_ucos3_stk_prof_stack[(UCOS3_STACK_PROFILER_STACK + sizeof(CPU_STK) - 1u) / sizeof(CPU_STK)];
+
+/* Inspect at most one chunk of the current thread, then move to the next. */
+static void osUcos3StackProfilerStep(void) {
+  os_ucos3_thread_t *thread = os_ucos3_kernel.stk_prof_cursor;
+  if (thread == NULL) {
+    thread = (os_ucos3_thread_t *)os_ucos3_kernel.threads.head;
+    os_ucos3_kernel.stk_prof_cursor = thread;
+    os_ucos3_kernel.stk_prof_pos = 0u;
+    if (thread == NULL) {
+      return;
+    }
+  }
+
+  uint32_t pos = os_ucos3_kernel.stk_prof_pos;
+  uint32_t limit = pos + UCOS3_STACK_PROFILER_CHUNK_WORDS;
+  if (limit > thread->stack_free) {
+    limit = thread->stack_free;
+  }
+
+  uint32_t used = osUcos3StackScan(thread, pos, limit);
+  if ((used < limit) || (limit == thread->stack_free)) {
+    thread->stack_free = used;
+    os_ucos3_kernel.stk_prof_cursor = (os_ucos3_thread_t *)thread->object.next;
+    os_ucos3_kernel.stk_prof_pos = 0u;
+  } else {
+    os_ucos3_kernel.stk_prof_pos = limit;
+  }
+}
+
+static void osUcos3StackProfilerThread(void *argument) {
+  (void)argument;
+
+  for (;;) {
+    OS_ERR err;
+    OSSchedLock(&err);
+    osUcos3StackProfilerStep();
+    OSSchedUnlock(&err);
+    (void)osUcos3DelayTicks(UCOS3_STACK_PROFILER_PERIOD_TICKS);
+  }
+}
+
+static osStatus_t osUcos3StackProfilerStart(void) {
+  const osThreadAttr_t attr = {
+    .name       = "cmsis.stkprof",
+    .cb_mem     = &os_ucos3_stk_prof_cb,
+    .cb_size    = sizeof(os_ucos3_stk_prof_cb),
+    .stack_mem  = os_ucos3_stk_prof_stack,
+    .stack_size = sizeof(os_ucos3_stk_prof_stack),
+    .priority   = UCOS3_STACK_PROFILER_PRIORITY,
+  };
+
+  return (osThreadNew(osUcos3StackProfilerThread, NULL, &attr) != NULL) ? osOK : osError;
+}
+#endif
+
+/* ==== Thread Local Storage ==== */
+
+uint32_t osThreadTlsAlloc(void) {
+#if (UCOS3_TLS_SLOTS > 0u)
+  if (osUcos3IrqContext()) {
+    return osThreadTlsInvalid;
+  }
+
+  OS_ERR err;
+  OS_TLS_ID id = OS_TLS_GetID(&err);
+  return (err == OS_ERR_NONE) ? (uint32_t)id : osThreadTlsInvalid;
+#else
+  return osThreadTlsInvalid;
+#endif
+}
+
+/* Slot access touches only the running TCB: no lookup, no critical section. */
+void *osThreadTlsGet(uint32_t slot) {
+#if (UCOS3_TLS_SLOTS > 0u)
+  if ((slot >= UCOS3_TLS_SLOTS) || osUcos3IrqContext() || (OSTCBCurPtr == NULL)) {
+    return NULL;
+  }
+
+  return OSTCBCurPtr->TLS_Tbl[slot];
+#else
+  (void)slot;
+  return NULL;
+#endif
+}
+
+osStatus_t osThreadTlsSet(uint32_t slot, void *value) {
+#if (UCOS3_TLS_SLOTS > 0u)
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  if ((slot >= UCOS3_TLS_SLOTS) || (OSTCBCurPtr == NULL)) {
+    return osErrorParameter;
+  }
+
+  OSTCBCurPtr->TLS_Tbl[slot] = (OS_TLS)value;
   return osOK;
+#else
+  (void)slot;
+  (void)value;
+  return osError;
+#endif
+}
+
+/* ==== Trace Recorder ==== */
+
+#if (UCOS3_TRACE_EN > 0u)
+/* CMSIS threads are named by their ID, other tasks (idle, timer, ...) by TCB. */
+static uint32_t osUcos3TraceTaskId(const OS_TCB *ptcb) {
+  os_ucos3_thread_t *thread = osUcos3ThreadFromExt(ptcb);
+  return (thread != NULL) ? UCOS3_TRACE_ID(thread) : UCOS3_TRACE_ID(ptcb);
+}
+
+/* Lock-free writer: reserve a slot, fill it, then publish it by storing its
+ * index + 1 in the slot's sequence word. Until then the word still holds an
+ * earlier lap's value, so osTraceRead neither copies a half-written record
+ * nor takes a stale one for it after an overflow. */
+static void osUcos3TraceEmit(uint32_t event, uint32_t object, uint32_t arg) {
+  if (os_ucos3_kernel.trace_paused) {
+    return;
+  }
+
+  uint32_t index = UCOS3_TRACE_ATOMIC_INC(&os_ucos3_kernel.trace_head);
+  volatile osTraceRecord_t *record = &os_ucos3_kernel.trace_buf[index & (UCOS3_TRACE_EVENTS - 1u)];
+  record->timestamp = UCOS3_TS_GET();
+  record->object = object;
+  record->arg = arg;
+  record->context = (uint16_t)OSIntNestingCtr;
+  record->event = (uint16_t)event;
+  os_ucos3_kernel.trace_seq[index & (UCOS3_TRACE_EVENTS - 1u)] = index + 1u;
+}
+
+static void osUcos3TraceApiEnter(uint32_t api, uint32_t object, uint32_t arg) {
+  if (!osUcos3IrqContext() && (OSTCBCurPtr != NULL)) {
+    os_ucos3_thread_t *thread = osUcos3ThreadFromExt(OSTCBCurPtr);
+    if (thread != NULL) {
+      thread->trace_object = object;
+    }
+  }
+  osUcos3TraceEmit(osTraceEventApiEnter | api, object, arg);
+}
+
+/* Four characters per record; the record holding the terminator ends the name. */
+static void osUcos3TraceName(uint32_t object, const char *name) {
+  if ((object == 0u) || (name == NULL)) {
+    return;
+  }
+
+  for (;;) {
+    uint32_t chunk = 0u;
+    uint32_t i = 0u;
+    for (; (i < 4u) && (name[i] != '\0'); ++i) {
+      chunk |= (uint32_t)(uint8_t)name[i] << (8u * i);
+    }
+    osUcos3TraceEmit(osTraceEventName, object, chunk);
+    if (i < 4u) {
+      return;
+    }
+    name += 4;
+  }
+}
+
+/* The pend list is priority ordered: its head is the thread a post readies. */
+static void osUcos3TraceWakeup(uint32_t object, const OS_PEND_LIST *list) {
+  if (list->HeadPtr != NULL) {
+    osUcos3TraceEmit(osTraceEventWakeup, object, osUcos3TraceTaskId(list->HeadPtr));
+  }
+}
+
+/* Called from the task switch hook with interrupts disabled. */
+static void osUcos3TraceSwitch(const OS_TCB *from, const OS_TCB *to) {
+  if (from != NULL) {
+    uint32_t reason = 0u;
+    switch (from->TaskState) {
+      case OS_TASK_STATE_DLY:
+        reason = osTraceBlockDelay;
+        break;
+      case OS_TASK_STATE_PEND:
+      case OS_TASK_STATE_PEND_TIMEOUT:
+        reason = osTraceBlockPend;
+        break;
+      case OS_TASK_STATE_SUSPENDED:
+      case OS_TASK_STATE_DLY_SUSPENDED:
+      case OS_TASK_STATE_PEND_SUSPENDED:
+      case OS_TASK_STATE_PEND_TIMEOUT_SUSPENDED:
+        reason = osTraceBlockSuspend;
+        break;
+      default:
+        break;
+    }
+    if (reason != 0u) {
+      os_ucos3_thread_t *thread = osUcos3ThreadFromExt(from);
+      osUcos3TraceEmit(osTraceEventBlock, (thread != NULL) ? thread->trace_object : 0u, reason);
+    }
+  }
+  osUcos3TraceEmit(osTraceEventSwitch, osUcos3TraceTaskId(to), (from != NULL) ? osUcos3TraceTaskId(from) : 0u);
+}
+#endif
+
+void osTraceStart(void) {
+#if (UCOS3_TRACE_EN > 0u)
+  os_ucos3_kernel.trace_paused = false;
+#endif
+}
+
+void osTraceStop(void) {
+#if (UCOS3_TRACE_EN > 0u)
+  os_ucos3_kernel.trace_paused = true;
+#endif
+}
+
+/* Single reader. Each record is moved out under a short critical section so
+ * a large read does not hold interrupts off. */
+uint32_t osTraceRead(osTraceRecord_t *records, uint32_t max_count) {
+#if (UCOS3_TRACE_EN > 0u)
+  if (records == NULL) {
+    return 0u;
+  }
+
+  uint32_t count = 0u;
+  CPU_SR_ALLOC();
+  while (count < max_count) {
+    CPU_CRITICAL_ENTER();
+    uint32_t head = os_ucos3_kernel.trace_head;
+    uint32_t tail = os_ucos3_kernel.trace_tail;
+    if ((head - tail) > UCOS3_TRACE_EVENTS) {
+      os_ucos3_kernel.trace_dropped += (head - tail) - UCOS3_TRACE_EVENTS;
+      tail = head - UCOS3_TRACE_EVENTS;
+    }
+    volatile osTraceRecord_t *slot = &os_ucos3_kernel.trace_buf[tail & (UCOS3_TRACE_EVENTS - 1u)];
+    if ((tail == head) || (os_ucos3_kernel.trace_seq[tail & (UCOS3_TRACE_EVENTS - 1u)] != (tail + 1u))) {
+      os_ucos3_kernel.trace_tail = tail;
+      CPU_CRITICAL_EXIT();
+      break;
+    }
+    records[count].timestamp = slot->timestamp;
+    records[count].object = slot->object;
+    records[count].arg = slot->arg;
+    records[count].event = slot->event;
+    records[count].context = slot->context;
+    os_ucos3_kernel.trace_tail = tail + 1u;
+    CPU_CRITICAL_EXIT();
+    count++;
+  }
+  return count;
+#else
+  (void)records;
+  (void)max_count;
+  return 0u;
+#endif
+}
+
+uint32_t osTraceGetDropped(void) {
+#if (UCOS3_TRACE_EN > 0u)
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  uint32_t pending = os_ucos3_kernel.trace_head - os_ucos3_kernel.trace_tail;
+  uint32_t dropped = os_ucos3_kernel.trace_dropped;
+  if (pending > UCOS3_TRACE_EVENTS) {
+    dropped += pending - UCOS3_TRACE_EVENTS;
+  }
+  CPU_CRITICAL_EXIT();
+  return dropped;
+#else
+  return 0u;
+#endif
+}
+
+void osTraceIsrEnter(uint32_t irq) {
+#if (UCOS3_TRACE_EN > 0u)
+  osUcos3TraceEmit(osTraceEventIsrEnter, 0u, irq);
+#else
+  (void)irq;
+#endif
+}
+
+void osTraceIsrExit(uint32_t irq) {
+#if (UCOS3_TRACE_EN > 0u)
+  osUcos3TraceEmit(osTraceEventIsrExit, 0u, irq);
+#else
+  (void)irq;
+#endif
+}
+
+void osTraceUser(uint32_t code, const void *object, uint32_t arg) {
+#if (UCOS3_TRACE_EN > 0u)
+  osUcos3TraceEmit(osTraceEventUser | (code & 0xFFu), UCOS3_TRACE_ID(object), arg);
+#else
+  (void)code;
+  (void)object;
+  (void)arg;
+#endif
+}
+
+/* ==== Tick Profiler ==== */
+
+#if (UCOS3_PROFILER_EN > 0u)
+/* Runs in the tick interrupt, the only writer. The reader copies each sample
+ * with interrupts disabled, so it never sees one half written. */
+static void osUcos3ProfilerSample(void) {
+  const OS_TCB *ptcb = OSTCBCurPtr;
+  if (os_ucos3_kernel.prof_paused || (ptcb == NULL)) {
+    return;
+  }
+
+  const os_ucos3_thread_t *thread = osUcos3ThreadFromExt(ptcb);
+  osProfilerSample_t *sample = &os_ucos3_kernel.prof_buf[os_ucos3_kernel.prof_head & (UCOS3_PROFILER_SAMPLES - 1u)];
+  sample->tick = (uint32_t)OSTickCtr;
+  sample->thread = (thread != NULL) ? (uint32_t)(uintptr_t)thread : (uint32_t)(uintptr_t)ptcb;
+  sample->pc = (uint32_t)(UCOS3_PROFILER_PC());
+  if (thread != NULL) {
+    sample->flags = 0u;
+  } else {
+    sample->flags = (ptcb == &OSIdleTaskTCB) ? osProfilerSampleIdle : osProfilerSampleKernel;
+  }
+  sample->context = (OSIntNestingCtr > 1u) ? (uint16_t)(OSIntNestingCtr - 1u) : 0u;
+  os_ucos3_kernel.prof_head++;
+}
+#endif
+
+void osProfilerStart(void) {
+#if (UCOS3_PROFILER_EN > 0u)
+  os_ucos3_kernel.prof_paused = false;
+#endif
+}
+
+void osProfilerStop(void) {
+#if (UCOS3_PROFILER_EN > 0u)
+  os_ucos3_kernel.prof_paused = true;
+#endif
+}
+
+uint32_t osProfilerRead(osProfilerSample_t *samples, uint32_t max_count) {
+#if (UCOS3_PROFILER_EN > 0u)
+  if (samples == NULL) {
+    return 0u;
+  }
+
+  CPU_SR_ALLOC();
+  uint32_t count = 0u;
+  while (count < max_count) {
+    CPU_CRITICAL_ENTER();
+    uint32_t head = os_ucos3_kernel.prof_head;
+    uint32_t tail = os_ucos3_kernel.prof_tail;
+    if ((head - tail) > UCOS3_PROFILER_SAMPLES) {
+      os_ucos3_kernel.prof_dropped += (head - tail) - UCOS3_PROFILER_SAMPLES;
+      tail = head - UCOS3_PROFILER_SAMPLES;
+    }
+    if (tail == head) {
+      os_ucos3_kernel.prof_tail = tail;
+      CPU_CRITICAL_EXIT();
+      break;
+    }
+    samples[count] = os_ucos3_kernel.prof_buf[tail & (UCOS3_PROFILER_SAMPLES - 1u)];
+    os_ucos3_kernel.prof_tail = tail + 1u;
+    CPU_CRITICAL_EXIT();
+    count++;
+  }
+  return count;
+#else
+  (void)samples;
+  (void)max_count;
+  return 0u;
+#endif
+}
+
+uint32_t osProfilerGetDropped(void) {
+#if (UCOS3_PROFILER_EN > 0u)
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  uint32_t pending = os_ucos3_kernel.prof_head - os_ucos3_kernel.prof_tail;
+  uint32_t dropped = os_ucos3_kernel.prof_dropped;
+  if (pending > UCOS3_PROFILER_SAMPLES) {
+    dropped += pending - UCOS3_PROFILER_SAMPLES;
+  }
+  CPU_CRITICAL_EXIT();
+  return dropped;
+#else
+  return 0u;
+#endif
+}
+
+/* ==== Priority Inversion ==== */
+
+#if (UCOS3_INVERSION_EN > 0u)
+/* Only CMSIS threads take part; ISRs and other tasks are never waiters or holders. */
+static os_ucos3_thread_t *osUcos3InversionSelf(void) {
+  if (osUcos3IrqContext() || (OSTCBCurPtr == NULL)) {
+    return NULL;
+  }
+  return osUcos3ThreadFromExt(OSTCBCurPtr);
+}
+
+/* Only an owner of lower base priority turns the wait into an inversion: the
+ * clock starts here and the waiter is left untracked otherwise. */
+static void osUcos3InversionBegin(void *object, osInversionStats_t *stats, OS_TCB *const *owner) {
+  os_ucos3_thread_t *self = osUcos3InversionSelf();
+  if (self == NULL) {
+    return;
+  }
+
+  os_ucos3_thread_t *holder = NULL;
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  if ((*owner != NULL) && ((*owner)->BasePrio > self->tcb.Prio)) {
+    holder = osUcos3ThreadFromExt(*owner);
+  }
+  if (holder != NULL) {
+    self->inv_stats = stats;
+    self->inv_holder = holder;
+    self->inv_since = UCOS3_TS_GET();
+    self->inv_inherited = false;
+  }
+  CPU_CRITICAL_EXIT();
+
+  if (holder != NULL) {
+    UCOS3_INVERSION_HOOK(object, (osThreadId_t)self, (osThreadId_t)holder);
+  }
+}
+
+/* Called before the release, from threads and ISRs. The head of the pend list
+ * is the waiter the release readies; a boosted holder marks its wait as
+ * inherited. Releasing a binary semaphore forgets its taker. */
+static void osUcos3InversionSignal(osInversionStats_t *stats, const OS_PEND_LIST *list, OS_TCB **owner) {
+  os_ucos3_thread_t *self = osUcos3InversionSelf();
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  if (owner != NULL) {
+    *owner = NULL;
+  }
+  os_ucos3_thread_t *head = (list->HeadPtr != NULL) ? osUcos3ThreadFromExt(list->HeadPtr) : NULL;
+  if ((self != NULL) && (head != NULL) && (head->inv_stats == stats) && (head->inv_holder == self) &&
+      (self->tcb.Prio < self->tcb.BasePrio)) {
+    head->inv_inherited = true;
+  }
+  CPU_CRITICAL_EXIT();
+}
+
+/* A wait that timed out may have been boosted without a release. */
+static void osUcos3InversionEnd(OS_TCB *const *owner, OS_ERR err) {
+  os_ucos3_thread_t *self = osUcos3InversionSelf();
+  if ((self == NULL) || (self->inv_stats == NULL)) {
+    return;
+  }
+
+  uint32_t now = UCOS3_TS_GET();
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  osInversionStats_t *stats = self->inv_stats;
+  os_ucos3_thread_t *holder = self->inv_holder;
+  self->inv_stats = NULL;
+  self->inv_holder = NULL;
+  if (err != OS_ERR_OBJ_DEL) {
+    bool inherited = self->inv_inherited;
+    if (!inherited && (*owner == &holder->tcb)) {
+      inherited = (holder->tcb.Prio < holder->tcb.BasePrio);
+    }
+    uint32_t cycles = now - self->inv_since;
+    stats->count++;
+    stats->total_cycles += cycles;
+    if (inherited) {
+      stats->inherited++;
+    }
+    if (cycles >= stats->worst_cycles) {
+      stats->worst_cycles = cycles;
+      stats->worst_inherited = inherited ? 1u : 0u;
+      stats->worst_waiter = (osThreadId_t)self;
+      stats->worst_holder = (osThreadId_t)holder;
+    }
+  }
+  CPU_CRITICAL_EXIT();
+}
+
+/* A binary semaphore is taken as a lock: its last CMSIS taker holds it until
+ * the next release. Counting semaphores have no holder. */
+static void osUcos3InversionTake(os_ucos3_semaphore_t *sem, OS_ERR err) {
+  if ((err != OS_ERR_NONE) || (sem->max_count != 1u)) {
+    return;
+  }
+  os_ucos3_thread_t *self = osUcos3InversionSelf();
+  if (self != NULL) {
+    sem->holder = &self->tcb;
+  }
+}
+
+static osStatus_t osUcos3InversionCopy(const osInversionStats_t *source, osInversionStats_t *stats) {
+  if (stats == NULL) {
+    return osErrorParameter;
+  }
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  *stats = *source;
+  CPU_CRITICAL_EXIT();
+  return osOK;
+}
+#endif
+
+osStatus_t osMutexGetInversionStats(osMutexId_t mutex_id, osInversionStats_t *stats) {
+#if (UCOS3_INVERSION_EN > 0u)
+  os_ucos3_mutex_t *mutex = osUcos3MutexFromId(mutex_id);
+  if ((mutex == NULL) || !mutex->created) {
+    return osErrorParameter;
+  }
+  return osUcos3InversionCopy(&mutex->inversion, stats);
+#else
+  (void)mutex_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+osStatus_t osSemaphoreGetInversionStats(osSemaphoreId_t semaphore_id, osInversionStats_t *stats) {
+#if (UCOS3_INVERSION_EN > 0u)
+  os_ucos3_semaphore_t *sem = osUcos3SemaphoreFromId(semaphore_id);
+  if ((sem == NULL) || !sem->created) {
+    return osErrorParameter;
+  }
+  return osUcos3InversionCopy(&sem->inversion, stats);
+#else
+  (void)semaphore_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+/* ==== Wait Statistics ==== */
+
+#if (UCOS3_WAIT_STATS_EN > 0u)
+/* Entries are taken in order and never released, so the first free entry ends
+ * the search; the last entry collects whatever does not fit. */
+static void osUcos3WaitRecord(uint32_t kind, const void *object, uint32_t start) {
+  if (osUcos3IrqContext() || (OSTCBCurPtr == NULL)) {
+    return;
+  }
+  os_ucos3_thread_t *self = osUcos3ThreadFromExt(OSTCBCurPtr);
+  if (self == NULL) {
+    return;
+  }
+
+  uint32_t cycles = UCOS3_TS_GET() - start;
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  osThreadWaitStat_t *entry = NULL;
+  for (uint32_t i = 0u; i < UCOS3_WAIT_STATS_SLOTS; ++i) {
+    osThreadWaitStat_t *slot = &self->wait[i];
+    if (slot->count == 0u) {
+      slot->object = object;
+      slot->kind = kind;
+      entry = slot;
+      break;
+    }
+    if ((slot->object == object) && (slot->kind == kind)) {
+      entry = slot;
+      break;
+    }
+  }
+  if (entry == NULL) {
+    entry = &self->wait[UCOS3_WAIT_STATS_SLOTS - 1u];
+    entry->object = NULL;
+    entry->kind = osWaitKindOther;
+  }
+  entry->count++;
+  entry->cycles += cycles;
+  if (cycles > entry->max_cycles) {
+    entry->max_cycles = cycles;
+  }
+  CPU_CRITICAL_EXIT();
+}
+#endif
+
+uint32_t osThreadGetWaitStats(osThreadId_t thread_id, osThreadWaitStat_t *stats, uint32_t max_count) {
+#if (UCOS3_WAIT_STATS_EN > 0u)
+  os_ucos3_thread_t *thread = osUcos3ThreadFromId(thread_id);
+  if ((thread == NULL) || (stats == NULL) || osUcos3IrqContext()) {
+    return 0u;
+  }
+
+  uint32_t count = 0u;
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  for (uint32_t i = 0u; (i < UCOS3_WAIT_STATS_SLOTS) && (count < max_count); ++i) {
+    if (thread->wait[i].count != 0u) {
+      stats[count++] = thread->wait[i];
+    }
+  }
+  CPU_CRITICAL_EXIT();
+  return count;
+#else
+  (void)thread_id;
+  (void)stats;
+  (void)max_count;
+  return 0u;
+#endif
+}
+
+/* ==== Slab Allocator ==== */
+
+os_ucos3_slab_t *osUcos3SlabFromId(osSlabId_t slab_id) {
+  if (slab_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos3_slab_t *slab = (os_ucos3_slab_t *)slab_id;
+  return ((slab->object.type == osUcos3ObjectSlab) && (slab->class_count != 0u)) ? slab : NULL;
+}
+
+/* Statistics counters are bumped from threads and ISRs; they follow the
+ * UCOS3_LOCKFREE_EN choice between atomics and short critical sections. */
+static void osUcos3StatCount(uint32_t *counter, uint32_t *peak, uint32_t used) {
+#if (UCOS3_LOCKFREE_EN > 0u)
+  (void)UCOS3_ATOMIC_ADD(counter, 1u);
+  if (peak != NULL) {
+    uint32_t seen = *(volatile uint32_t *)peak;
+    while ((used > seen) && !UCOS3_ATOMIC_CAS(peak, &seen, used)) {
+    }
+  }
+#else
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  (*counter)++;
+  if ((peak != NULL) && (used > *peak)) {
+    *peak = used;
+  }
+  CPU_CRITICAL_EXIT();
+#endif
+}
+
+osSlabId_t osSlabNew(const osSlabAttr_t *attr) {
+  if (osUcos3IrqContext() ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos3_slab_t)) ||
+      (attr->classes == NULL) ||
+      (attr->class_count == 0u) ||
+      (attr->class_count > UCOS3_SLAB_CLASSES)) {
+    return NULL;
+  }
+
+  /* Classes must grow so the first fit is also the tightest fit. */
+  for (uint32_t i = 1u; i < attr->class_count; ++i) {
+    if (attr->classes[i].block_size <= attr->classes[i - 1u].block_size) {
+      return NULL;
+    }
+  }
+
+  os_ucos3_slab_t *slab = (os_ucos3_slab_t *)attr->cb_mem;
+  memset(slab, 0, sizeof(*slab));
+  osUcos3ObjectInit(&slab->object, osUcos3ObjectSlab, attr->name, attr->attr_bits);
+
+  for (uint32_t i = 0u; i < attr->class_count; ++i) {
+    const osSlabClassAttr_t *class_attr = &attr->classes[i];
+    os_ucos3_slab_class_t *cls = &slab->classes[i];
+    const osMemoryPoolAttr_t pool_attr = {
+      .name    = attr->name,
+      .cb_mem  = class_attr->cb_mem,
+      .cb_size = class_attr->cb_size,
+      .mp_mem  = class_attr->mp_mem,
+      .mp_size = class_attr->mp_size,
+    };
+
+    cls->pool = osMemoryPoolNew(class_attr->block_count, class_attr->block_size, &pool_attr);
+    if (cls->pool == NULL) {
+      for (uint32_t j = 0u; j < i; ++j) {
+        (void)osMemoryPoolDelete(slab->classes[j].pool);
+      }
+      return NULL;
+    }
+
+    cls->block_size = class_attr->block_size;
+    cls->base = (uint8_t *)class_attr->mp_mem;
+    cls->limit = cls->base + (osMemoryPoolGetBlockSize(cls->pool) * class_attr->block_count);
+  }
+
+  slab->class_count = attr->class_count;
+  return (osSlabId_t)slab;
+}
+
+void *osSlabAlloc(osSlabId_t slab_id, uint32_t size, uint32_t timeout) {
+  os_ucos3_slab_t *slab = osUcos3SlabFromId(slab_id);
+  if ((slab == NULL) || (size == 0u) || osUcos3IsrDisallowsWait(timeout)) {
+    return NULL;
+  }
+
+  uint32_t fit = 0u;
+  while ((fit < slab->class_count) && (slab->classes[fit].block_size < size)) {
+    fit++;
+  }
+  if (fit == slab->class_count) {
+    return NULL;
+  }
+
+  os_ucos3_slab_class_t *cls = &slab->classes[fit];
+  void *block = osMemoryPoolAlloc(cls->pool, 0u);
+  os_ucos3_slab_class_t *from = cls;
+  if ((block == NULL) && ((slab->object.attr_bits & osSlabOverflow) != 0u)) {
+    for (uint32_t i = fit + 1u; (block == NULL) && (i < slab->class_count); ++i) {
+      from = &slab->classes[i];
+      block = osMemoryPoolAlloc(from->pool, 0u);
+    }
+    if (block != NULL) {
+      osUcos3StatCount(&cls->overflows, NULL, 0u);
+    }
+  }
+  if ((block == NULL) && (timeout != 0u)) {
+    from = cls;
+    block = osMemoryPoolAlloc(cls->pool, timeout);
+  }
+
+  if (block == NULL) {
+    osUcos3StatCount(&cls->failures, NULL, 0u);
+    return NULL;
+  }
+  osUcos3StatCount(&from->allocs, &from->peak, osMemoryPoolGetCount(from->pool));
+  return block;
+}
+
+osStatus_t osSlabFree(osSlabId_t slab_id, void *block) {
+  os_ucos3_slab_t *slab = osUcos3SlabFromId(slab_id);
+  if ((slab == NULL) || (block == NULL)) {
+    return osErrorParameter;
+  }
+
+  for (uint32_t i = 0u; i < slab->class_count; ++i) {
+    os_ucos3_slab_class_t *cls = &slab->classes[i];
+    if (((uint8_t *)block >= cls->base) && ((uint8_t *)block < cls->limit)) {
+      return osMemoryPoolFree(cls->pool, block);
+    }
+  }
+  return osErrorParameter;
+}
+
+uint32_t osSlabGetClassCount(osSlabId_t slab_id) {
+  os_ucos3_slab_t *slab = osUcos3SlabFromId(slab_id);
+  return (slab != NULL) ? slab->class_count : 0u;
+}
+
+osStatus_t osSlabGetStats(osSlabId_t slab_id, uint32_t index, osSlabStats_t *stats) {
+  os_ucos3_slab_t *slab = osUcos3SlabFromId(slab_id);
+  if ((slab == NULL) || (index >= slab->class_count) || (stats == NULL)) {
+    return osErrorParameter;
+  }
+
+  const os_ucos3_slab_class_t *cls = &slab->classes[index];
+  stats->block_size = osMemoryPoolGetBlockSize(cls->pool);
+  stats->capacity = osMemoryPoolGetCapacity(cls->pool);
+  stats->used = osMemoryPoolGetCount(cls->pool);
+  stats->peak = cls->peak;
+  stats->allocs = cls->allocs;
+  stats->overflows = cls->overflows;
+  stats->failures = cls->failures;
+  return osOK;
+}
+
+osStatus_t osSlabDelete(osSlabId_t slab_id) {
+  os_ucos3_slab_t *slab = osUcos3SlabFromId(slab_id);
+  if (slab == NULL) {
+    return osErrorParameter;
+  }
+
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  osStatus_t status = osOK;
+  for (uint32_t i = 0u; i < slab->class_count; ++i) {
+    if (osMemoryPoolDelete(slab->classes[i].pool) != osOK) {
+      status = osError;
+    }
+  }
+  slab->class_count = 0u;
+  return status;
+}
+
+/* ==== Buffer Descriptors ==== */
+
+/* Adds delta (negative for a release) to the reference count. A count that
+ * is already zero belongs to a released buffer and is left alone, as is a
+ * retain that would wrap. */
+static bool osUcos3BufferAdjust(osBuffer_t *buf, uint32_t delta, uint32_t *refs) {
+#if (UCOS3_LOCKFREE_EN > 0u)
+  uint32_t seen = *(volatile uint32_t *)&buf->refs;
+  uint32_t next;
+  do {
+    next = seen + delta;
+    if ((seen == 0u) || (((int32_t)delta > 0) && (next < seen))) {
+      return false;
+    }
+  } while (!UCOS3_ATOMIC_CAS(&buf->refs, &seen, next));
+  *refs = next;
+  return true;
+#else
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  uint32_t next = buf->refs + delta;
+  bool ok = (buf->refs != 0u) && (((int32_t)delta < 0) || (next >= buf->refs));
+  if (ok) {
+    buf->refs = next;
+  }
+  CPU_CRITICAL_EXIT();
+  *refs = next;
+  return ok;
+#endif
+}
+
+osBuffer_t *osBufferAlloc(osMemoryPoolId_t mp_id, uint32_t timeout) {
+  uint32_t block_size = osMemoryPoolGetBlockSize(mp_id);
+  if (block_size <= sizeof(osBuffer_t)) {
+    return NULL;
+  }
+
+  osBuffer_t *buf = (osBuffer_t *)osMemoryPoolAlloc(mp_id, timeout);
+  if (buf == NULL) {
+    return NULL;
+  }
+  buf->pool = mp_id;
+  buf->refs = 1u;
+  buf->capacity = block_size - (uint32_t)sizeof(osBuffer_t);
+  buf->length = 0u;
+  return buf;
+}
+
+osStatus_t osBufferRetain(osBuffer_t *buf, uint32_t count) {
+  uint32_t refs;
+  if ((buf == NULL) || (count == 0u) || (count > (uint32_t)INT32_MAX)) {
+    return osErrorParameter;
+  }
+  return osUcos3BufferAdjust(buf, count, &refs) ? osOK : osErrorResource;
+}
+
+osStatus_t osBufferRelease(osBuffer_t *buf) {
+  uint32_t refs;
+  if (buf == NULL) {
+    return osErrorParameter;
+  }
+  if (!osUcos3BufferAdjust(buf, (uint32_t)-1, &refs)) {
+    return osErrorResource;
+  }
+  return (refs == 0u) ? osMemoryPoolFree(buf->pool, buf) : osOK;
+}
+
+osStatus_t osBufferPut(osMessageQueueId_t mq_id, osBuffer_t *buf, uint8_t msg_prio, uint32_t timeout) {
+  os_ucos3_message_queue_t *mq = osUcos3MessageQueueFromId(mq_id);
+  if ((mq == NULL) || (mq->msg_size != sizeof(void *)) || (buf == NULL)) {
+    return osErrorParameter;
+  }
+
+  /* The queue entry's reference is taken first so a consumer that releases
+   * it immediately cannot free the block under the producer. */
+  osStatus_t status = osBufferRetain(buf, 1u);
+  if (status != osOK) {
+    return status;
+  }
+  status = osMessageQueuePut(mq_id, &buf, msg_prio, timeout);
+  if (status != osOK) {
+    (void)osBufferRelease(buf);
+  }
+  return status;
+}
+
+osBuffer_t *osBufferGet(osMessageQueueId_t mq_id, uint32_t timeout) {
+  osBuffer_t *buf = NULL;
+  if (osMessageQueueGet(mq_id, &buf, NULL, timeout) != osOK) {
+    return NULL;
+  }
+  return buf;
+}
+
+/* ==== Topic Bus ==== */
+
+os_ucos3_topic_t *osUcos3TopicFromId(osTopicId_t topic_id) {
+  if (topic_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos3_topic_t *topic = (os_ucos3_topic_t *)topic_id;
+  return ((topic->object.type == osUcos3ObjectTopic) && topic->created) ? topic : NULL;
+}
+
+osTopicId_t osTopicNew(const osTopicAttr_t *attr) {
+  if (osUcos3IrqContext() ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos3_topic_t))) {
+    return NULL;
+  }
+
+  os_ucos3_topic_t *topic = (os_ucos3_topic_t *)attr->cb_mem;
+  memset(topic, 0, sizeof(*topic));
+  osUcos3ObjectInit(&topic->object, osUcos3ObjectTopic, attr->name, attr->attr_bits);
+  topic->created = true;
+  return (osTopicId_t)topic;
+}
+
+/* The subscriber array only changes here, with interrupts disabled, so a
+ * publish (scheduler locked, or in an ISR) always sees a dense array. */
+static osStatus_t osUcos3TopicAdd(osTopicId_t topic_id, void *target, uint32_t flags, uint32_t policy) {
+  os_ucos3_topic_t *topic = osUcos3TopicFromId(topic_id);
+  if ((topic == NULL) || (target == NULL)) {
+    return osErrorParameter;
+  }
+
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  osStatus_t status = osOK;
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  for (uint32_t i = 0u; i < topic->count; ++i) {
+    if (topic->subs[i].target == target) {
+      status = osErrorParameter;
+    }
+  }
+  if ((status == osOK) && (topic->count == UCOS3_TOPIC_SUBSCRIBERS)) {
+    status = osErrorResource;
+  }
+  if (status == osOK) {
+    os_ucos3_topic_sub_t *sub = &topic->subs[topic->count];
+    sub->target = target;
+    sub->flags = flags;
+    sub->policy = policy;
+    sub->dropped = 0u;
+    topic->count++;
+  }
+  CPU_CRITICAL_EXIT();
+  return status;
+}
+
+osStatus_t osTopicSubscribe(osTopicId_t topic_id, osMessageQueueId_t mq_id, uint32_t policy) {
+  if ((osMessageQueueGetMsgSize(mq_id) != sizeof(void *)) ||
+      ((policy != osTopicDropNewest) && (policy != osTopicDropOldest))) {
+    return osErrorParameter;
+  }
+  return osUcos3TopicAdd(topic_id, mq_id, 0u, policy);
+}
+
+osStatus_t osTopicSubscribeFlags(osTopicId_t topic_id, osEventFlagsId_t ef_id, uint32_t flags) {
+  if ((osUcos3EventFlagsFromId(ef_id) == NULL) || !osUcos3FlagsValid(flags)) {
+    return osErrorParameter;
+  }
+  return osUcos3TopicAdd(topic_id, ef_id, flags, osTopicDropNewest);
+}
+
+osStatus_t osTopicUnsubscribe(osTopicId_t topic_id, void *subscriber) {
+  os_ucos3_topic_t *topic = osUcos3TopicFromId(topic_id);
+  if (topic == NULL) {
+    return osErrorParameter;
+  }
+
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  osStatus_t status = osErrorResource;
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  for (uint32_t i = 0u; i < topic->count; ++i) {
+    if (topic->subs[i].target == subscriber) {
+      topic->count--;
+      topic->subs[i] = topic->subs[topic->count];
+      status = osOK;
+      break;
+    }
+  }
+  CPU_CRITICAL_EXIT();
+  return status;
+}
+
+static osStatus_t osUcos3TopicPut(osMessageQueueId_t mq_id, void *msg, bool buffer) {
+  return buffer ? osBufferPut(mq_id, (osBuffer_t *)msg, 0u, 0u)
+                : osMessageQueuePut(mq_id, &msg, 0u, 0u);
+}
+
+/* Post to one queue without waiting. With osTopicDropOldest a full queue
+ * gives up its oldest message (releasing it on a buffer topic) once; if
+ * another producer takes the freed slot first, the retry fails and msg is
+ * lost instead. Either way one message is dropped and counted. */
+static bool osUcos3TopicPost(os_ucos3_topic_sub_t *sub, void *msg, bool buffer) {
+  osMessageQueueId_t mq_id = (osMessageQueueId_t)sub->target;
+  osStatus_t status = osUcos3TopicPut(mq_id, msg, buffer);
+  if (status == osOK) {
+    return true;
+  }
+
+  void *oldest = NULL;
+  if ((status == osErrorResource) &&
+      (sub->policy == osTopicDropOldest) &&
+      (osMessageQueueGet(mq_id, &oldest, NULL, 0u) == osOK)) {
+    if (buffer) {
+      (void)osBufferRelease((osBuffer_t *)oldest);
+    }
+    status = osUcos3TopicPut(mq_id, msg, buffer);
+  }
+  osUcos3StatCount(&sub->dropped, NULL, 0u);
+  return (status == osOK);
+}
+
+/* One pass over the subscriber array. Threads hold the scheduler lock for
+ * the pass, so woken subscribers run once, after the last post; an ISR is
+ * not preempted by threads anyway. */
+static uint32_t osUcos3TopicPublish(os_ucos3_topic_t *topic, void *msg, bool buffer) {
+  const bool isr = osUcos3IrqContext();
+  int32_t lock = isr ? 0 : osUcos3KernelLock();
+  uint32_t delivered = 0u;
+
+  for (uint32_t i = 0u; i < topic->count; ++i) {
+    os_ucos3_topic_sub_t *sub = &topic->subs[i];
+    if (sub->flags != 0u) {
+      if ((osEventFlagsSet((osEventFlagsId_t)sub->target, sub->flags) & osFlagsError) == 0u) {
+        delivered++;
+      }
+    } else if (osUcos3TopicPost(sub, msg, buffer)) {
+      delivered++;
+    }
+  }
+
+  if (!isr && (lock >= 0)) {
+    (void)osUcos3KernelRestoreLock(lock);
+  }
+  return delivered;
+}
+
+uint32_t osTopicPublish(osTopicId_t topic_id, void *msg) {
+  os_ucos3_topic_t *topic = osUcos3TopicFromId(topic_id);
+  if ((topic == NULL) || ((topic->object.attr_bits & osTopicBuffers) != 0u)) {
+    return 0u;
+  }
+  return osUcos3TopicPublish(topic, msg, false);
+}
+
+uint32_t osTopicPublishBuffer(osTopicId_t topic_id, osBuffer_t *buf) {
+  os_ucos3_topic_t *topic = osUcos3TopicFromId(topic_id);
+  if ((topic == NULL) || (buf == NULL) || ((topic->object.attr_bits & osTopicBuffers) == 0u)) {
+    return 0u;
+  }
+  return osUcos3TopicPublish(topic, buf, true);
+}
+
+uint32_t osTopicGetDropped(osTopicId_t topic_id, void *subscriber) {
+  os_ucos3_topic_t *topic = osUcos3TopicFromId(topic_id);
+  if (topic == NULL) {
+    return 0u;
+  }
+
+  uint32_t dropped = 0u;
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  for (uint32_t i = 0u; i < topic->count; ++i) {
+    if (topic->subs[i].target == subscriber) {
+      dropped = topic->subs[i].dropped;
+    }
+  }
+  CPU_CRITICAL_EXIT();
+  return dropped;
+}
+
+osStatus_t osTopicDelete(osTopicId_t topic_id) {
+  os_ucos3_topic_t *topic = osUcos3TopicFromId(topic_id);
+  if (topic == NULL) {
+    return osErrorParameter;
+  }
+
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  topic->created = false;
+  topic->count = 0u;
+  CPU_CRITICAL_EXIT();
+  return osOK;
+}
+
+/* ==== Wait Any ==== */
+
+#if (UCOS3_WAIT_ANY_EN > 0u)
+/* Waiter list of a live semaphore, message queue or event flags object. */
+static os_ucos3_wait_any_node_t **osUcos3WaitAnyHead(void *object) {
+  os_ucos3_semaphore_t *sem = osUcos3SemaphoreFromId(object);
+  if (sem != NULL) {
+    return sem->created ? &sem->wait_any : NULL;
+  }
+  os_ucos3_message_queue_t *mq = osUcos3MessageQueueFromId(object);
+  if (mq != NULL) {
+    return mq->created ? &mq->wait_any : NULL;
+  }
+  os_ucos3_event_flags_t *ef = osUcos3EventFlagsFromId(object);
+  return ((ef != NULL) && ef->created) ? &ef->wait_any : NULL;
+}
+
+/* An object deleted during the wait counts as ready, so the caller's take
+ * reports the error. */
+static bool osUcos3WaitAnyReady(const osObjectWait_t *entry) {
+  os_ucos3_semaphore_t *sem = osUcos3SemaphoreFromId(entry->object);
+  if (sem != NULL) {
+    return !sem->created || (sem->sem.Ctr > 0u);
+  }
+  os_ucos3_message_queue_t *mq = osUcos3MessageQueueFromId(entry->object);
+  if (mq != NULL) {
+    return !mq->created || (mq->queue.MsgQ.NbrEntries > 0u);
+  }
+  os_ucos3_event_flags_t *ef = osUcos3EventFlagsFromId(entry->object);
+  if ((ef == NULL) || !ef->created) {
+    return true;
+  }
+  uint32_t current = (uint32_t)ef->grp.Flags & entry->flags;
+  return ((entry->options & osFlagsWaitAll) != 0u) ? (current == entry->flags) : (current != 0u);
+}
+
+static int32_t osUcos3WaitAnyScan(osObjectWaitSet_t *set) {
+  uint32_t first = (set->policy == osObjectWaitRoundRobin) ? (set->cursor + 1u) : 0u;
+  for (uint32_t n = 0u; n < set->count; ++n) {
+    uint32_t i = (first + n) % set->count;
+    if (osUcos3WaitAnyReady(&set->objects[i])) {
+      set->cursor = i;
+      return (int32_t)i;
+    }
+  }
+  return (int32_t)osErrorResource;
+}
+
+/* Called after the post that made an object ready. Lists only change with
+ * interrupts disabled in the waiting thread, and a thread walks them with the
+ * scheduler locked, so a woken waiter cannot unlink its node mid-walk; an ISR
+ * is not preempted by threads anyway. On delete the list is detached first. */
+static void osUcos3WaitAnyNotify(os_ucos3_wait_any_node_t **head, bool detach) {
+  int32_t lock = osUcos3KernelLock();
+  os_ucos3_wait_any_node_t *node = *head;
+  if (detach) {
+    CPU_SR_ALLOC();
+    CPU_CRITICAL_ENTER();
+    node = *head;
+    *head = NULL;
+    for (os_ucos3_wait_any_node_t *it = node; it != NULL; it = it->next) {
+      it->pprev = NULL;
+    }
+    CPU_CRITICAL_EXIT();
+  }
+
+  while (node != NULL) {
+    OS_ERR err;
+    os_ucos3_wait_any_node_t *next = node->next;
+    OSSemPost(node->wake, OS_OPT_POST_1, &err);
+    node = next;
+  }
+
+  if (lock >= 0) {
+    (void)osUcos3KernelRestoreLock(lock);
+  }
+}
+
+static void osUcos3WaitAnyLink(osObjectWaitSet_t *set, os_ucos3_wait_any_node_t *nodes, OS_SEM *wake) {
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  for (uint32_t i = 0u; i < set->count; ++i) {
+    os_ucos3_wait_any_node_t **head = osUcos3WaitAnyHead(set->objects[i].object);
+    nodes[i].wake = wake;
+    nodes[i].pprev = head;
+    nodes[i].next = NULL;
+    if (head != NULL) {
+      nodes[i].next = *head;
+      if (*head != NULL) {
+        (*head)->pprev = &nodes[i].next;
+      }
+      *head = &nodes[i];
+    }
+  }
+  CPU_CRITICAL_EXIT();
+}
+
+static void osUcos3WaitAnyUnlink(const osObjectWaitSet_t *set, os_ucos3_wait_any_node_t *nodes) {
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  for (uint32_t i = 0u; i < set->count; ++i) {
+    os_ucos3_wait_any_node_t *node = &nodes[i];
+    if (node->pprev != NULL) {
+      *node->pprev = node->next;
+      if (node->next != NULL) {
+        node->next->pprev = node->pprev;
+      }
+    }
+  }
+  CPU_CRITICAL_EXIT();
+}
+
+static int32_t osUcos3ObjectWaitAny(osObjectWaitSet_t *set, uint32_t timeout) {
+  if ((set == NULL) || (set->objects == NULL) ||
+      (set->count == 0u) || (set->count > UCOS3_WAIT_ANY_MAX) ||
+      ((set->policy != osObjectWaitPriority) && (set->policy != osObjectWaitRoundRobin)) ||
+      osUcos3IsrDisallowsWait(timeout)) {
+    return (int32_t)osErrorParameter;
+  }
+  for (uint32_t i = 0u; i < set->count; ++i) {
+    const osObjectWait_t *entry = &set->objects[i];
+    if ((osUcos3WaitAnyHead(entry->object) == NULL) ||
+        ((osUcos3EventFlagsFromId(entry->object) != NULL) &&
+         (!osUcos3FlagsValid(entry->flags) || !osUcos3FlagsOptionsValid(entry->options)))) {
+      return (int32_t)osErrorParameter;
+    }
+  }
+
+  int32_t result = osUcos3WaitAnyScan(set);
+  if ((result >= 0) || (timeout == 0u)) {
+    return result;
+  }
+
+  /* CMSIS threads reuse their own wake semaphore; a post left over from the
+   * previous wait is cleared before the nodes are linked. Other tasks get a
+   * semaphore for this wait only. */
+  os_ucos3_thread_t *self = osUcos3ThreadFromTcb(OSTCBCurPtr);
+  OS_SEM local;
+  OS_SEM *wake = &local;
+  OS_ERR err;
+  if ((self != NULL) && self->wait_any_sem_created) {
+    wake = &self->wait_any_sem;
+    OSSemSet(wake, (OS_SEM_CTR)0u, &err);
+  } else {
+    OSSemCreate(&local, (CPU_CHAR *)"cmsis.waitany", (OS_SEM_CTR)0u, &err);
+  }
+  if (err != OS_ERR_NONE) {
+    return (int32_t)osErrorResource;
+  }
+
+  /* Link first, then look again: a post between the scan above and the link
+   * is seen by the second scan, any later one posts wake. */
+  os_ucos3_wait_any_node_t nodes[UCOS3_WAIT_ANY_MAX];
+  osUcos3WaitAnyLink(set, nodes, wake);
+  const uint32_t start = osKernelGetTickCount();
+  for (;;) {
+    result = osUcos3WaitAnyScan(set);
+    if (result >= 0) {
+      break;
+    }
+
+    OS_TICK pend_timeout = (OS_TICK)0u;
+    if (timeout != osWaitForever) {
+      uint32_t elapsed = osKernelGetTickCount() - start;
+      if (elapsed >= timeout) {
+        result = (int32_t)osErrorTimeout;
+        break;
+      }
+      pend_timeout = (OS_TICK)(timeout - elapsed);
+    }
+
+    OSSemPend(wake, pend_timeout, OS_OPT_PEND_BLOCKING, NULL, &err);
+    if ((err != OS_ERR_NONE) && (err != OS_ERR_TIMEOUT)) {
+      result = (int32_t)osErrorResource;
+      break;
+    }
+  }
+  osUcos3WaitAnyUnlink(set, nodes);
+  if (wake == &local) {
+    OSSemDel(&local, OS_OPT_DEL_ALWAYS, &err);
+  }
+  return result;
+}
+#endif
+
+int32_t osObjectWaitAny(osObjectWaitSet_t *set, uint32_t timeout) {
+#if (UCOS3_WAIT_ANY_EN > 0u)
+  UCOS3_WAIT_BEGIN(wait_start);
+  int32_t result = osUcos3ObjectWaitAny(set, timeout);
+  UCOS3_WAIT_END(wait_start, osWaitKindObjectSet, set, timeout);
+  return result;
+#else
+  (void)set;
+  (void)timeout;
+  return (int32_t)osError;
+#endif
+}
+
+/* ==== Thread Mailbox ==== */
+
+#if (UCOS3_MAILBOX_EN > 0u)
+static os_ucos3_thread_t *osUcos3MailboxFromId(osThreadId_t thread_id) {
+  os_ucos3_thread_t *thread = osUcos3ThreadFromId(thread_id);
+  if ((thread == NULL) || !thread->started ||
+      ((thread->object.attr_bits & osThreadMailbox) == 0u)) {
+    return NULL;
+  }
+  return thread;
+}
+
+/* The receiver pends on its own task queue, so a post readies it directly
+ * without an OS_Q or a space semaphore in between. */
+static osStatus_t osUcos3ThreadMessageGet(void **msg, uint32_t timeout) {
+  if (msg == NULL) {
+    return osErrorParameter;
+  }
+  *msg = NULL;
+
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  os_ucos3_thread_t *self = (OSTCBCurPtr != NULL) ? osUcos3ThreadFromExt(OSTCBCurPtr) : NULL;
+  if ((self == NULL) || ((self->object.attr_bits & osThreadMailbox) == 0u)) {
+    return osErrorResource;
+  }
+
+  OS_ERR err;
+  OS_MSG_SIZE size;
+  void *message = OSTaskQPend(osUcos3PendTimeout(timeout),
+                              osUcos3PendOption(timeout),
+                              &size,
+                              NULL,
+                              &err);
+  switch (err) {
+    case OS_ERR_NONE:
+      *msg = message;
+      return osOK;
+    case OS_ERR_TIMEOUT:
+      return osErrorTimeout;
+    default:
+      return osErrorResource;
+  }
+}
+#endif
+
+osStatus_t osThreadMessagePut(osThreadId_t thread_id, void *msg) {
+#if (UCOS3_MAILBOX_EN > 0u)
+  os_ucos3_thread_t *thread = osUcos3MailboxFromId(thread_id);
+  if (thread == NULL) {
+    return osErrorParameter;
+  }
+
+  OS_ERR err;
+  OSTaskQPost(&thread->tcb, msg, (OS_MSG_SIZE)sizeof(void *), OS_OPT_POST_FIFO, &err);
+  return (err == OS_ERR_NONE) ? osOK : osErrorResource;
+#else
+  (void)thread_id;
+  (void)msg;
+  return osError;
+#endif
+}
+
+osStatus_t osThreadMessageGet(void **msg, uint32_t timeout) {
+#if (UCOS3_MAILBOX_EN > 0u)
+  UCOS3_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos3ThreadMessageGet(msg, timeout);
+  UCOS3_WAIT_END(wait_start, osWaitKindThreadMessage, NULL, timeout);
+  return status;
+#else
+  (void)msg;
+  (void)timeout;
+  return osError;
+#endif
+}
+
+uint32_t osThreadMessageGetCount(osThreadId_t thread_id) {
+#if (UCOS3_MAILBOX_EN > 0u)
+  os_ucos3_thread_t *thread = osUcos3MailboxFromId(thread_id);
+  return (thread != NULL) ? (uint32_t)thread->tcb.MsgQ.NbrEntries : 0u;
+#else
+  (void)thread_id;
+  return 0u;
+#endif
+}
+
+/* ==== Work Queue ==== */
+
+#if (UCOS3_WORKQ_EN > 0u)
+os_ucos3_work_queue_t *osUcos3WorkQueueFromId(osWorkQueueId_t wq_id) {
+  if (wq_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos3_work_queue_t *wq = (os_ucos3_work_queue_t *)wq_id;
+  return ((wq->object.type == osUcos3ObjectWorkQueue) && wq->created) ? wq : NULL;
+}
+
+/* True when the caller is one of the queue's workers. */
+static bool osUcos3WorkQueueSelf(const os_ucos3_work_queue_t *wq) {
+  if (osUcos3IrqContext() || (OSTCBCurPtr == NULL)) {
+    return false;
+  }
+
+  const os_ucos3_thread_t *self = osUcos3ThreadFromExt(OSTCBCurPtr);
+  for (uint32_t i = 0u; i < wq->worker_count; ++i) {
+    if (self == &wq->workers[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Takes the oldest item. Submissions land on incoming newest first, so once
+ * the ready list runs dry the whole incoming list is detached and reversed
+ * onto it. Workers only contend with each other here, with interrupts
+ * disabled, which also keeps the swap of incoming atomic against ISRs. */
+static osWork_t *osUcos3WorkNext(os_ucos3_work_queue_t *wq, bool *more) {
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  if (wq->ready_head == NULL) {
+    osWork_t *work = wq->incoming;
+    wq->incoming = NULL;
+    while (work != NULL) {
+      osWork_t *next = work->next;
+      work->next = wq->ready_head;
+      wq->ready_head = work;
+      work = next;
+    }
+  }
+
+  osWork_t *work = wq->ready_head;
+  if (work != NULL) {
+    wq->ready_head = work->next;
+    work->next = NULL;
+    work->pending = 0u;
+
+    uint32_t latency = UCOS3_TS_GET() - work->submitted;
+    wq->executed++;
+    wq->total_latency += latency;
+    if (latency > wq->max_latency) {
+      wq->max_latency = latency;
+    }
+  }
+  *more = (wq->ready_head != NULL) || (wq->incoming != NULL);
+  CPU_CRITICAL_EXIT();
+  return work;
+}
+
+/* A worker drains the queue before it pends again. The wake semaphore is
+ * posted when incoming goes from empty to non-empty, and by a worker that
+ * leaves items behind, so an idle sibling picks them up in parallel. */
+static void osUcos3WorkQueueThread(void *argument) {
+  os_ucos3_work_queue_t *wq = (os_ucos3_work_queue_t *)argument;
+
+  for (;;) {
+    OS_ERR err;
+    (void)OSSemPend(&wq->wake, 0u, OS_OPT_PEND_BLOCKING, NULL, &err);
+
+    bool more;
+    osWork_t *work;
+    while ((work = osUcos3WorkNext(wq, &more)) != NULL) {
+      if (more && (wq->worker_count > 1u)) {
+        (void)OSSemPost(&wq->wake, OS_OPT_POST_1, &err);
+      }
+      work->func(work->argument);
+    }
+  }
+}
+#endif
+
+osWorkQueueId_t osWorkQueueNew(const osWorkQueueAttr_t *attr) {
+#if (UCOS3_WORKQ_EN > 0u)
+  uint32_t count = ((attr != NULL) && (attr->workers != 0u)) ? attr->workers : 1u;
+  if (osUcos3IrqContext() ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos3_work_queue_t)) ||
+      (attr->stack_mem == NULL) ||
+      (count > UCOS3_WORKQ_WORKERS)) {
+    return NULL;
+  }
+
+  /* Each worker gets an equal, 8-byte aligned share of the stack memory. */
+  uint32_t share = (attr->stack_size / count) & ~7u;
+  if (share < (UCOS3_THREAD_MIN_STACK_WORDS * sizeof(CPU_STK))) {
+    return NULL;
+  }
+
+  os_ucos3_work_queue_t *wq = (os_ucos3_work_queue_t *)attr->cb_mem;
+  memset(wq, 0, sizeof(*wq));
+  osUcos3ObjectInit(&wq->object, osUcos3ObjectWorkQueue, attr->name, 0u);
+
+  OS_ERR err;
+  OSSemCreate(&wq->wake, (CPU_CHAR *)(attr->name != NULL ? attr->name : "cmsis.workq"), (OS_SEM_CTR)0u, &err);
+  if (err != OS_ERR_NONE) {
+    return NULL;
+  }
+
+  osThreadAttr_t thread_attr = {
+    .name       = attr->name,
+    .cb_size    = sizeof(os_ucos3_thread_t),
+    .stack_size = share,
+    .priority   = (attr->priority != osPriorityNone) ? attr->priority : UCOS3_WORKQ_PRIORITY,
+  };
+  for (uint32_t i = 0u; i < count; ++i) {
+    thread_attr.cb_mem = &wq->workers[i];
+    thread_attr.stack_mem = (uint8_t *)attr->stack_mem + (i * share);
+    if (osThreadNew(osUcos3WorkQueueThread, wq, &thread_attr) == NULL) {
+      while (i-- > 0u) {
+        (void)osThreadTerminate((osThreadId_t)&wq->workers[i]);
+      }
+      OSSemDel(&wq->wake, OS_OPT_DEL_ALWAYS, &err);
+      return NULL;
+    }
+  }
+
+  wq->worker_count = count;
+  wq->created = true;
+  return (osWorkQueueId_t)wq;
+#else
+  (void)attr;
+  return NULL;
+#endif
+}
+
+osStatus_t osWorkInit(osWork_t *work, osWorkFunc_t func, void *argument) {
+#if (UCOS3_WORKQ_EN > 0u)
+  if ((work == NULL) || (func == NULL)) {
+    return osErrorParameter;
+  }
+
+  memset(work, 0, sizeof(*work));
+  work->func = func;
+  work->argument = argument;
+  return osOK;
+#else
+  (void)work;
+  (void)func;
+  (void)argument;
+  return osError;
+#endif
+}
+
+osStatus_t osWorkSubmit(osWorkQueueId_t wq_id, osWork_t *work) {
+#if (UCOS3_WORKQ_EN > 0u)
+  os_ucos3_work_queue_t *wq = osUcos3WorkQueueFromId(wq_id);
+  if ((wq == NULL) || (work == NULL) || (work->func == NULL)) {
+    return osErrorParameter;
+  }
+
+  bool wake;
+#if (UCOS3_LOCKFREE_EN > 0u)
+  uint32_t idle = 0u;
+  if (!UCOS3_ATOMIC_CAS(&work->pending, &idle, 1u)) {
+    (void)UCOS3_ATOMIC_ADD(&wq->coalesced, 1u);
+    return osOK;
+  }
+  work->submitted = UCOS3_TS_GET();
+  osWork_t *head = *(osWork_t *volatile *)&wq->incoming;
+  do {
+    work->next = head;
+  } while (!UCOS3_ATOMIC_CAS(&wq->incoming, &head, work));
+  (void)UCOS3_ATOMIC_ADD(&wq->submitted, 1u);
+  wake = (head == NULL);
+#else
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  if (work->pending != 0u) {
+    wq->coalesced++;
+    CPU_CRITICAL_EXIT();
+    return osOK;
+  }
+  work->pending = 1u;
+  work->submitted = UCOS3_TS_GET();
+  work->next = wq->incoming;
+  wake = (wq->incoming == NULL);
+  wq->incoming = work;
+  wq->submitted++;
+  CPU_CRITICAL_EXIT();
+#endif
+
+  if (wake) {
+    OS_ERR err;
+    (void)OSSemPost(&wq->wake, OS_OPT_POST_1, &err);
+  }
+  return osOK;
+#else
+  (void)wq_id;
+  (void)work;
+  return osError;
+#endif
+}
+
+osStatus_t osWorkQueueGetStats(osWorkQueueId_t wq_id, osWorkQueueStats_t *stats) {
+#if (UCOS3_WORKQ_EN > 0u)
+  os_ucos3_work_queue_t *wq = osUcos3WorkQueueFromId(wq_id);
+  if ((wq == NULL) || (stats == NULL)) {
+    return osErrorParameter;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  stats->submitted = wq->submitted;
+  stats->coalesced = wq->coalesced;
+  stats->executed = wq->executed;
+  stats->max_latency = wq->max_latency;
+  stats->total_latency = wq->total_latency;
+  CPU_CRITICAL_EXIT();
+  return osOK;
+#else
+  (void)wq_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+osStatus_t osWorkQueueDelete(osWorkQueueId_t wq_id) {
+#if (UCOS3_WORKQ_EN > 0u)
+  os_ucos3_work_queue_t *wq = osUcos3WorkQueueFromId(wq_id);
+  if (wq == NULL) {
+    return osErrorParameter;
+  }
+
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+  /* A worker cannot terminate itself and its siblings from a work function. */
+  if (osUcos3WorkQueueSelf(wq)) {
+    return osErrorResource;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  wq->created = false;
+  CPU_CRITICAL_EXIT();
+
+  for (uint32_t i = 0u; i < wq->worker_count; ++i) {
+    (void)osThreadTerminate((osThreadId_t)&wq->workers[i]);
+  }
+
+  /* Submissions are refused from here on; release what is still queued. */
+  CPU_CRITICAL_ENTER();
+  osWork_t *lists[2] = { wq->ready_head, wq->incoming };
+  for (uint32_t i = 0u; i < 2u; ++i) {
+    for (osWork_t *work = lists[i]; work != NULL; ) {
+      osWork_t *next = work->next;
+      work->next = NULL;
+      work->pending = 0u;
+      work = next;
+    }
+  }
+  wq->ready_head = NULL;
+  wq->incoming = NULL;
+  CPU_CRITICAL_EXIT();
+
+  OS_ERR err;
+  OSSemDel(&wq->wake, OS_OPT_DEL_ALWAYS, &err);
+  return osOK;
+#else
+  (void)wq_id;
+  return osError;
+#endif
+}
+
+/* ==== Thread Pool ==== */
+
+#if (UCOS3_POOL_EN > 0u)
+os_ucos3_pool_t *osUcos3PoolFromId(osPoolId_t pool_id) {
+  if (pool_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos3_pool_t *pool = (os_ucos3_pool_t *)pool_id;
+  return ((pool->object.type == osUcos3ObjectPool) && pool->created) ? pool : NULL;
+}
+
+/* The worker running the caller, or NULL for any other thread. */
+static os_ucos3_pool_worker_t *osUcos3PoolSelf(os_ucos3_pool_t *pool) {
+  if (osUcos3IrqContext() || (OSTCBCurPtr == NULL)) {
+    return NULL;
+  }
+
+  os_ucos3_pool_worker_t *self = (os_ucos3_pool_worker_t *)osUcos3ThreadFromExt(OSTCBCurPtr);
+  for (uint32_t i = 0u; i < pool->worker_count; ++i) {
+    if (self == &pool->workers[i]) {
+      return self;
+    }
+  }
+  return NULL;
+}
+
+/* Deque operations run with the scheduler locked: every caller is a thread,
+ * so this is enough to keep owners and thieves apart without masking
+ * interrupts. */
+static bool osUcos3PoolJobPush(os_ucos3_pool_worker_t *worker, osPoolFunc_t func, void *argument) {
+  if ((worker->bottom - worker->top) >= UCOS3_POOL_DEQUE) {
+    return false;
+  }
+  os_ucos3_pool_job_t *job = &worker->jobs[worker->bottom & (UCOS3_POOL_DEQUE - 1u)];
+  job->func = func;
+  job->argument = argument;
+  worker->bottom++;
+  return true;
+}
+
+/* Own deque newest first, for locality; then the oldest job of the next
+ * worker that has one, which is the largest piece of work left there. */
+static bool osUcos3PoolJobTake(os_ucos3_pool_t *pool, os_ucos3_pool_worker_t *self, os_ucos3_pool_job_t *job) {
+  if (self->bottom != self->top) {
+    self->bottom--;
+    *job = self->jobs[self->bottom & (UCOS3_POOL_DEQUE - 1u)];
+    return true;
+  }
+
+  uint32_t index = (uint32_t)(self - pool->workers);
+  for (uint32_t i = 1u; i < pool->worker_count; ++i) {
+    os_ucos3_pool_worker_t *victim = &pool->workers[(index + i) % pool->worker_count];
+    if (victim->bottom != victim->top) {
+      *job = victim->jobs[victim->top & (UCOS3_POOL_DEQUE - 1u)];
+      victim->top++;
+      pool->stolen++;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void osUcos3PoolThread(void *argument) {
+  os_ucos3_pool_worker_t *self = (os_ucos3_pool_worker_t *)argument;
+  os_ucos3_pool_t *pool = self->pool;
+
+  for (;;) {
+    OS_ERR err;
+    os_ucos3_pool_job_t job;
+    OSSchedLock(&err);
+    bool found = osUcos3PoolJobTake(pool, self, &job);
+    if (!found) {
+      pool->idle++;
+    }
+    OSSchedUnlock(&err);
+
+    if (!found) {
+      (void)OSSemPend(&pool->work_sem, 0u, OS_OPT_PEND_BLOCKING, NULL, &err);
+      continue;
+    }
+
+    job.func(job.argument);
+
+    OSSchedLock(&err);
+    pool->executed++;
+    if (--pool->outstanding == 0u) {
+      (void)OSFlagPost(&pool->done, (OS_FLAGS)1u, OS_OPT_POST_FLAG_SET, &err);
+    }
+    OSSchedUnlock(&err);
+  }
+}
+
+static osStatus_t osUcos3PoolWaitAll(os_ucos3_pool_t *pool, uint32_t timeout) {
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+  if (osUcos3PoolSelf(pool) != NULL) {
+    return osErrorResource;
+  }
+
+  OS_ERR err;
+  (void)OSFlagPend(&pool->done, (OS_FLAGS)1u, osUcos3PendTimeout(timeout),
+                   OS_OPT_PEND_FLAG_SET_ANY | osUcos3PendOption(timeout), NULL, &err);
+  switch (err) {
+    case OS_ERR_NONE:
+      return osOK;
+    case OS_ERR_TIMEOUT:
+      return osErrorTimeout;
+    default:
+      return osErrorResource;
+  }
+}
+#endif
+
+osPoolId_t osPoolNew(const osPoolAttr_t *attr) {
+#if (UCOS3_POOL_EN > 0u)
+  uint32_t count = ((attr != NULL) && (attr->workers != 0u)) ? attr->workers : UCOS3_POOL_WORKERS;
+  if (osUcos3IrqContext() ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos3_pool_t)) ||
+      (attr->stack_mem == NULL) ||
+      (count > UCOS3_POOL_WORKERS)) {
+    return NULL;
+  }
+
+  uint32_t share = (attr->stack_size / count) & ~7u;
+  if (share < (UCOS3_THREAD_MIN_STACK_WORDS * sizeof(CPU_STK))) {
+    return NULL;
+  }
+
+  os_ucos3_pool_t *pool = (os_ucos3_pool_t *)attr->cb_mem;
+  memset(pool, 0, sizeof(*pool));
+  osUcos3ObjectInit(&pool->object, osUcos3ObjectPool, attr->name, 0u);
+  const char *name = (attr->name != NULL) ? attr->name : "cmsis.pool";
+
+  OS_ERR err;
+  OSSemCreate(&pool->work_sem, (CPU_CHAR *)name, (OS_SEM_CTR)0u, &err);
+  if (err != OS_ERR_NONE) {
+    return NULL;
+  }
+  OSFlagCreate(&pool->done, (CPU_CHAR *)name, (OS_FLAGS)1u, &err);
+  if (err != OS_ERR_NONE) {
+    OSSemDel(&pool->work_sem, OS_OPT_DEL_ALWAYS, &err);
+    return NULL;
+  }
+
+  /* The workers start only after the pool is complete: they may outrank
+   * the caller. */
+  pool->worker_count = count;
+  pool->created = true;
+  osThreadAttr_t thread_attr = {
+    .name       = attr->name,
+    .cb_size    = sizeof(os_ucos3_thread_t),
+    .stack_size = share,
+    .priority   = attr->priority,
+  };
+  for (uint32_t i = 0u; i < count; ++i) {
+    pool->workers[i].pool = pool;
+    thread_attr.cb_mem = &pool->workers[i].thread;
+    thread_attr.stack_mem = (uint8_t *)attr->stack_mem + (i * share);
+    if (osThreadNew(osUcos3PoolThread, &pool->workers[i], &thread_attr) == NULL) {
+      pool->created = false;
+      while (i-- > 0u) {
+        (void)osThreadTerminate((osThreadId_t)&pool->workers[i].thread);
+      }
+      OSFlagDel(&pool->done, OS_OPT_DEL_ALWAYS, &err);
+      OSSemDel(&pool->work_sem, OS_OPT_DEL_ALWAYS, &err);
+      return NULL;
+    }
+  }
+  return (osPoolId_t)pool;
+#else
+  (void)attr;
+  return NULL;
+#endif
+}
+
+osStatus_t osPoolSubmit(osPoolId_t pool_id, osPoolFunc_t func, void *argument) {
+#if (UCOS3_POOL_EN > 0u)
+  os_ucos3_pool_t *pool = osUcos3PoolFromId(pool_id);
+  if ((pool == NULL) || (func == NULL)) {
+    return osErrorParameter;
+  }
+
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  OS_ERR err;
+  os_ucos3_pool_worker_t *self = osUcos3PoolSelf(pool);
+  OSSchedLock(&err);
+  bool queued = (self != NULL) && osUcos3PoolJobPush(self, func, argument);
+  for (uint32_t i = 0u; !queued && (i < pool->worker_count); ++i) {
+    os_ucos3_pool_worker_t *worker = &pool->workers[pool->next];
+    pool->next = (pool->next + 1u) % pool->worker_count;
+    queued = osUcos3PoolJobPush(worker, func, argument);
+  }
+  if (queued) {
+    pool->submitted++;
+    if (pool->outstanding++ == 0u) {
+      (void)OSFlagPost(&pool->done, (OS_FLAGS)1u, OS_OPT_POST_FLAG_CLR, &err);
+    }
+    if (pool->idle > 0u) {
+      pool->idle--;
+      (void)OSSemPost(&pool->work_sem, OS_OPT_POST_1, &err);
+    }
+  }
+  OSSchedUnlock(&err);
+  return queued ? osOK : osErrorResource;
+#else
+  (void)pool_id;
+  (void)func;
+  (void)argument;
+  return osError;
+#endif
+}
+
+osStatus_t osPoolWaitAll(osPoolId_t pool_id, uint32_t timeout) {
+#if (UCOS3_POOL_EN > 0u)
+  os_ucos3_pool_t *pool = osUcos3PoolFromId(pool_id);
+  if (pool == NULL) {
+    return osErrorParameter;
+  }
+
+  UCOS3_WAIT_BEGIN(wait_start);
+  osStatus_t status = osUcos3PoolWaitAll(pool, timeout);
+  UCOS3_WAIT_END(wait_start, osWaitKindPool, pool, timeout);
+  return status;
+#else
+  (void)pool_id;
+  (void)timeout;
+  return osError;
+#endif
+}
+
+osStatus_t osPoolGetStats(osPoolId_t pool_id, osPoolStats_t *stats) {
+#if (UCOS3_POOL_EN > 0u)
+  os_ucos3_pool_t *pool = osUcos3PoolFromId(pool_id);
+  if ((pool == NULL) || (stats == NULL)) {
+    return osErrorParameter;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  stats->submitted = pool->submitted;
+  stats->executed = pool->executed;
+  stats->stolen = pool->stolen;
+  stats->outstanding = pool->outstanding;
+  CPU_CRITICAL_EXIT();
+  return osOK;
+#else
+  (void)pool_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+osStatus_t osPoolDelete(osPoolId_t pool_id) {
+#if (UCOS3_POOL_EN > 0u)
+  os_ucos3_pool_t *pool = osUcos3PoolFromId(pool_id);
+  if (pool == NULL) {
+    return osErrorParameter;
+  }
+
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+  if (osUcos3PoolSelf(pool) != NULL) {
+    return osErrorResource;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  pool->created = false;
+  CPU_CRITICAL_EXIT();
+
+  for (uint32_t i = 0u; i < pool->worker_count; ++i) {
+    (void)osThreadTerminate((osThreadId_t)&pool->workers[i].thread);
+  }
+
+  /* Waiters in osPoolWaitAll return osErrorResource. */
+  OS_ERR err;
+  OSFlagDel(&pool->done, OS_OPT_DEL_ALWAYS, &err);
+  OSSemDel(&pool->work_sem, OS_OPT_DEL_ALWAYS, &err);
+  return osOK;
+#else
+  (void)pool_id;
+  return osError;
+#endif
+}
+
+/* ==== Coroutines ==== */
+
+#if (UCOS3_CORO_EN > 0u)
+os_ucos3_coro_sched_t *osUcos3CoroSchedFromId(osCoroSchedId_t sched_id) {
+  if (sched_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos3_coro_sched_t *sched = (os_ucos3_coro_sched_t *)sched_id;
+  return ((sched->object.type == osUcos3ObjectCoroSched) && sched->created) ? sched : NULL;
+}
+
+/* The awaited object's waiter list holds the coroutine's node while it is
+ * blocked; posts to the object then post the scheduler's wake semaphore. */
+static void osUcos3CoroLink(os_ucos3_coro_t *co) {
+  osObjectWaitSet_t set = { &co->wait, 1u, osObjectWaitPriority, 0u };
+  osUcos3WaitAnyLink(&set, &co->node, &co->sched->wake);
+}
+
+/* Leaves pprev NULL, so unlinking again does nothing. */
+static void osUcos3CoroUnlink(os_ucos3_coro_t *co) {
+  osObjectWaitSet_t set = { &co->wait, 1u, osObjectWaitPriority, 0u };
+  osUcos3WaitAnyUnlink(&set, &co->node);
+  co->node.pprev = NULL;
+}
+
+/* A blocked coroutine resumes once its object is ready or its deadline has
+ * passed; *sleep is lowered to the ticks left otherwise. */
+static bool osUcos3CoroResumable(os_ucos3_coro_t *co, uint32_t now, uint32_t *sleep) {
+  if (co->state == osCoroReady) {
+    return true;
+  }
+
+  if ((co->wait.object != NULL) && osUcos3WaitAnyReady(&co->wait)) {
+    co->co.result = osOK;
+  } else if (co->timed && ((int32_t)(now - co->deadline) >= 0)) {
+    co->co.result = osErrorTimeout;
+  } else {
+    if (co->timed && ((co->deadline - now) < *sleep)) {
+      *sleep = co->deadline - now;
+    }
+    return false;
+  }
+
+  osUcos3CoroUnlink(co);
+  return true;
+}
+
+/* Each pass runs every coroutine that can make progress, in list order. The
+ * thread blocks only after a pass in which none could, so a post that
+ * arrives while a pass is running is seen by the next one. Posts that piled
+ * up while it was blocked are cleared on wake-up: the pass that follows
+ * checks every coroutine anyway. */
+static void osUcos3CoroThread(void *argument) {
+  os_ucos3_coro_sched_t *sched = (os_ucos3_coro_sched_t *)argument;
+
+  for (;;) {
+    CPU_SR_ALLOC();
+    CPU_CRITICAL_ENTER();
+    os_ucos3_coro_t *incoming = sched->incoming;
+    sched->incoming = NULL;
+    CPU_CRITICAL_EXIT();
+    while (incoming != NULL) {
+      os_ucos3_coro_t *co = incoming;
+      incoming = co->next;
+      co->next = sched->head;
+      sched->head = co;
+    }
+
+    const uint32_t now = osKernelGetTickCount();
+    uint32_t sleep = osWaitForever;
+    bool ran = false;
+    os_ucos3_coro_t **link = &sched->head;
+    while (*link != NULL) {
+      os_ucos3_coro_t *co = *link;
+      if (!osUcos3CoroResumable(co, now, &sleep)) {
+        link = &co->next;
+        continue;
+      }
+
+      ran = true;
+      co->state = osCoroReady;
+      sched->resumed++;
+      uint32_t state = co->func(&co->co, co->argument);
+      if (state == osCoroExited) {
+        *link = co->next;
+        CPU_CRITICAL_ENTER();
+        sched->coroutines--;
+        CPU_CRITICAL_EXIT();
+        continue;
+      }
+      if ((state == osCoroBlocked) && (co->state == osCoroBlocked) && (co->wait.object != NULL)) {
+        osUcos3CoroLink(co);
+      }
+      link = &co->next;
+    }
+
+    if (!ran) {
+      OS_ERR err;
+      OSSemPend(&sched->wake, (sleep == osWaitForever) ? (OS_TICK)0u : (OS_TICK)sleep,
+                OS_OPT_PEND_BLOCKING, NULL, &err);
+      OSSemSet(&sched->wake, (OS_SEM_CTR)0u, &err);
+      sched->wakeups++;
+    }
+  }
+}
+#endif
+
+osCoroSchedId_t osCoroSchedNew(const osCoroSchedAttr_t *attr) {
+#if (UCOS3_CORO_EN > 0u)
+  if (osUcos3IrqContext() ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos3_coro_sched_t)) ||
+      (attr->stack_mem == NULL) ||
+      (attr->stack_size < (UCOS3_THREAD_MIN_STACK_WORDS * sizeof(CPU_STK)))) {
+    return NULL;
+  }
+
+  os_ucos3_coro_sched_t *sched = (os_ucos3_coro_sched_t *)attr->cb_mem;
+  memset(sched, 0, sizeof(*sched));
+  osUcos3ObjectInit(&sched->object, osUcos3ObjectCoroSched, attr->name, 0u);
+
+  OS_ERR err;
+  OSSemCreate(&sched->wake, (CPU_CHAR *)(attr->name != NULL ? attr->name : "cmsis.coro"), (OS_SEM_CTR)0u, &err);
+  if (err != OS_ERR_NONE) {
+    return NULL;
+  }
+
+  sched->created = true;
+  const osThreadAttr_t thread_attr = {
+    .name       = attr->name,
+    .cb_mem     = &sched->thread,
+    .cb_size    = sizeof(sched->thread),
+    .stack_mem  = attr->stack_mem,
+    .stack_size = attr->stack_size,
+    .priority   = (attr->priority != osPriorityNone) ? attr->priority : osPriorityNormal,
+  };
+  if (osThreadNew(osUcos3CoroThread, sched, &thread_attr) == NULL) {
+    sched->created = false;
+    OSSemDel(&sched->wake, OS_OPT_DEL_ALWAYS, &err);
+    return NULL;
+  }
+  return (osCoroSchedId_t)sched;
+#else
+  (void)attr;
+  return NULL;
+#endif
+}
+
+osStatus_t osCoroNew(osCoroSchedId_t sched_id, osCoroFunc_t func, void *argument, void *cb_mem, uint32_t cb_size) {
+#if (UCOS3_CORO_EN > 0u)
+  os_ucos3_coro_sched_t *sched = osUcos3CoroSchedFromId(sched_id);
+  if ((sched == NULL) || (func == NULL) || (cb_mem == NULL) || (cb_size < sizeof(os_ucos3_coro_t))) {
+    return osErrorParameter;
+  }
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  os_ucos3_coro_t *co = (os_ucos3_coro_t *)cb_mem;
+  memset(co, 0, sizeof(*co));
+  co->sched = sched;
+  co->func = func;
+  co->argument = argument;
+  co->state = osCoroReady;
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  co->next = sched->incoming;
+  sched->incoming = co;
+  sched->coroutines++;
+  CPU_CRITICAL_EXIT();
+
+  OS_ERR err;
+  OSSemPost(&sched->wake, OS_OPT_POST_1, &err);
+  return osOK;
+#else
+  (void)sched_id;
+  (void)func;
+  (void)argument;
+  (void)cb_mem;
+  (void)cb_size;
+  return osError;
+#endif
+}
+
+osStatus_t osCoroWaitFor(osCoro_t *co, void *object, uint32_t flags, uint32_t options, uint32_t timeout) {
+#if (UCOS3_CORO_EN > 0u)
+  if (co == NULL) {
+    return osErrorParameter;
+  }
+
+  /* A bad object resumes the coroutine in the next pass with the error. */
+  os_ucos3_coro_t *cb = (os_ucos3_coro_t *)co;
+  if ((object != NULL) &&
+      ((osUcos3WaitAnyHead(object) == NULL) ||
+       ((osUcos3EventFlagsFromId(object) != NULL) &&
+        (!osUcos3FlagsValid(flags) || !osUcos3FlagsOptionsValid(options))))) {
+    co->result = osErrorParameter;
+    cb->state = osCoroReady;
+    return osErrorParameter;
+  }
+
+  cb->wait.object = object;
+  cb->wait.flags = flags;
+  cb->wait.options = options;
+  cb->timed = (timeout != osWaitForever);
+  cb->deadline = osKernelGetTickCount() + timeout;
+  cb->state = osCoroBlocked;
+  return osOK;
+#else
+  (void)co;
+  (void)object;
+  (void)flags;
+  (void)options;
+  (void)timeout;
+  return osError;
+#endif
+}
+
+osStatus_t osCoroSchedGetStats(osCoroSchedId_t sched_id, osCoroSchedStats_t *stats) {
+#if (UCOS3_CORO_EN > 0u)
+  os_ucos3_coro_sched_t *sched = osUcos3CoroSchedFromId(sched_id);
+  if ((sched == NULL) || (stats == NULL)) {
+    return osErrorParameter;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  stats->coroutines = sched->coroutines;
+  stats->resumed = sched->resumed;
+  stats->wakeups = sched->wakeups;
+  CPU_CRITICAL_EXIT();
+  return osOK;
+#else
+  (void)sched_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+osStatus_t osCoroSchedDelete(osCoroSchedId_t sched_id) {
+#if (UCOS3_CORO_EN > 0u)
+  os_ucos3_coro_sched_t *sched = osUcos3CoroSchedFromId(sched_id);
+  if (sched == NULL) {
+    return osErrorParameter;
+  }
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+  if (osThreadGetId() == (osThreadId_t)&sched->thread) {
+    return osErrorResource;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  sched->created = false;
+  CPU_CRITICAL_EXIT();
+
+  (void)osThreadTerminate((osThreadId_t)&sched->thread);
+  for (os_ucos3_coro_t *co = sched->head; co != NULL; co = co->next) {
+    osUcos3CoroUnlink(co);
+  }
+  sched->head = NULL;
+  sched->incoming = NULL;
+  sched->coroutines = 0u;
+
+  OS_ERR err;
+  OSSemDel(&sched->wake, OS_OPT_DEL_ALWAYS, &err);
+  return osOK;
+#else
+  (void)sched_id;
+  return osError;
+#endif
+}
+
+/* ==== Active Objects ==== */
+
+#if (UCOS3_ACTIVE_EN > 0u)
+os_ucos3_active_t *osUcos3ActiveFromId(osActiveId_t ao_id) {
+  if (ao_id == NULL) {
+    return NULL;
+  }
+
+  os_ucos3_active_t *ao = (os_ucos3_active_t *)ao_id;
+  return ((ao->object.type == osUcos3ObjectActive) && ao->created) ? ao : NULL;
+}
+
+static bool osUcos3ActiveFlag(uint32_t *flag, uint32_t from, uint32_t to) {
+#if (UCOS3_LOCKFREE_EN > 0u)
+  return UCOS3_ATOMIC_CAS(flag, &from, to);
+#else
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  bool ok = (*flag == from);
+  if (ok) {
+    *flag = to;
+  }
+  CPU_CRITICAL_EXIT();
+  return ok;
+#endif
+}
+
+/* Bounded multi-producer queue: a producer owns a slot once it has moved
+ * tail past it, and publishes the event by advancing the slot's sequence.
+ * A slot still holding the event of the previous lap means the queue is
+ * full. *depth is the number of events queued after this one. */
+static bool osUcos3ActivePush(os_ucos3_active_t *ao, osEvent_t *event, uint32_t *depth) {
+#if (UCOS3_LOCKFREE_EN > 0u)
+  uint32_t pos = *(volatile uint32_t *)&ao->tail;
+  for (;;) {
+    os_ucos3_active_slot_t *slot = &ao->slots[pos & (UCOS3_ACTIVE_QUEUE - 1u)];
+    int32_t diff = (int32_t)(*(volatile uint32_t *)&slot->seq - pos);
+    if (diff < 0) {
+      return false;
+    }
+    if (diff > 0) {
+      pos = *(volatile uint32_t *)&ao->tail;
+    } else if (UCOS3_ATOMIC_CAS(&ao->tail, &pos, pos + 1u)) {
+      slot->event = event;
+      (void)UCOS3_ATOMIC_ADD(&slot->seq, 1u);
+      *depth = pos + 1u - *(volatile uint32_t *)&ao->head;
+      return true;
+    }
+  }
+#else
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  uint32_t pos = ao->tail;
+  os_ucos3_active_slot_t *slot = &ao->slots[pos & (UCOS3_ACTIVE_QUEUE - 1u)];
+  bool ok = (slot->seq == pos);
+  if (ok) {
+    slot->event = event;
+    slot->seq = pos + 1u;
+    ao->tail = pos + 1u;
+    *depth = ao->tail - ao->head;
+  }
+  CPU_CRITICAL_EXIT();
+  return ok;
+#endif
+}
+
+/* Called by the active object's thread only, with the scheduler locked, and
+ * by osActiveDelete once the thread is gone. The taken event stays in
+ * current until the thread has released it. */
+static osEvent_t *osUcos3ActiveTake(os_ucos3_active_t *ao) {
+  os_ucos3_active_slot_t *slot = &ao->slots[ao->head & (UCOS3_ACTIVE_QUEUE - 1u)];
+  if (*(volatile uint32_t *)&slot->seq != (ao->head + 1u)) {
+    return NULL;
+  }
+
+  osEvent_t *event = slot->event;
+#if (UCOS3_LOCKFREE_EN > 0u)
+  (void)UCOS3_ATOMIC_ADD(&slot->seq, UCOS3_ACTIVE_QUEUE - 1u);
+#else
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  slot->seq += UCOS3_ACTIVE_QUEUE - 1u;
+  CPU_CRITICAL_EXIT();
+#endif
+  ao->head++;
+  ao->current = event;
+  return event;
+}
+
+/* osActiveDelete runs in another thread, so with the scheduler locked it
+ * cannot terminate this one between taking an event and recording it, or
+ * between releasing it and clearing current. */
+static osEvent_t *osUcos3ActiveClaim(os_ucos3_active_t *ao) {
+  OS_ERR err;
+  OSSchedLock(&err);
+  osEvent_t *event = osUcos3ActiveTake(ao);
+  OSSchedUnlock(&err);
+  (void)err;
+  return event;
+}
+
+static void osUcos3ActiveDone(os_ucos3_active_t *ao, osEvent_t *event) {
+  OS_ERR err;
+  OSSchedLock(&err);
+  ao->current = NULL;
+  if (event->buf.pool != NULL) {
+    (void)osBufferRelease(&event->buf);
+  }
+  OSSchedUnlock(&err);
+  (void)err;
+}
+
+/* The thread raises waiting before its last look at the queue, and the
+ * producer that lowers it posts wake, so an event published between that
+ * look and the pend is not missed. A post left over from a look that did
+ * find an event costs one empty pass. */
+static osEvent_t *osUcos3ActiveNext(os_ucos3_active_t *ao) {
+  for (;;) {
+    osEvent_t *event = osUcos3ActiveClaim(ao);
+    if (event != NULL) {
+      return event;
+    }
+
+    (void)osUcos3ActiveFlag(&ao->waiting, 0u, 1u);
+    event = osUcos3ActiveClaim(ao);
+    if (event != NULL) {
+      (void)osUcos3ActiveFlag(&ao->waiting, 1u, 0u);
+      return event;
+    }
+
+    OS_ERR err;
+    OSSemPend(&ao->wake, (OS_TICK)0u, OS_OPT_PEND_BLOCKING, NULL, &err);
+  }
+}
+
+/* Each event runs to completion before the next one is taken; the queue's
+ * reference to a dynamic event is dropped after the handler returns. */
+static void osUcos3ActiveThread(void *argument) {
+  os_ucos3_active_t *ao = (os_ucos3_active_t *)argument;
+
+  for (;;) {
+    osEvent_t *event = osUcos3ActiveNext(ao);
+    ao->handler((osActiveId_t)ao, event, ao->argument);
+    ao->dispatched++;
+    osUcos3ActiveDone(ao, event);
+  }
+}
+
+/* Runs in the tick hook; a time event is armed while ctr is non-zero. The
+ * critical section only counts down, reloads or unlinks expired events and
+ * chains them through due; they are posted after it, with interrupts
+ * enabled, in list order. */
+static void osUcos3TimeEventTick(void) {
+  osTimeEvent_t *expired = NULL;
+  osTimeEvent_t **tail = &expired;
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  osTimeEvent_t **link = &os_ucos3_kernel.time_events;
+  while (*link != NULL) {
+    osTimeEvent_t *te = *link;
+    if (--te->ctr != 0u) {
+      link = &te->next;
+      continue;
+    }
+
+    if (te->interval != 0u) {
+      te->ctr = te->interval;
+      link = &te->next;
+    } else {
+      *link = te->next;
+      te->next = NULL;
+    }
+    te->due = NULL;
+    *tail = te;
+    tail = &te->due;
+  }
+  CPU_CRITICAL_EXIT();
+
+  for (osTimeEvent_t *te = expired; te != NULL; te = te->due) {
+    (void)osActivePost(te->target, &te->event);
+  }
+}
+
+/* Unlinks the armed time events that match; target NULL matches all. */
+static uint32_t osUcos3TimeEventUnlink(const osTimeEvent_t *match, osActiveId_t target) {
+  uint32_t count = 0u;
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  osTimeEvent_t **link = &os_ucos3_kernel.time_events;
+  while (*link != NULL) {
+    osTimeEvent_t *te = *link;
+    if ((te == match) || ((match == NULL) && (te->target == target))) {
+      *link = te->next;
+      te->next = NULL;
+      te->ctr = 0u;
+      count++;
+    } else {
+      link = &te->next;
+    }
+  }
+  CPU_CRITICAL_EXIT();
+  return count;
+}
+#endif
+
+osEvent_t *osEventNew(osMemoryPoolId_t mp_id, uint32_t signal, uint32_t timeout) {
+#if (UCOS3_ACTIVE_EN > 0u)
+  if (osMemoryPoolGetBlockSize(mp_id) < sizeof(osEvent_t)) {
+    return NULL;
+  }
+
+  osEvent_t *event = (osEvent_t *)osBufferAlloc(mp_id, timeout);
+  if (event != NULL) {
+    event->signal = signal;
+  }
+  return event;
+#else
+  (void)mp_id;
+  (void)signal;
+  (void)timeout;
+  return NULL;
+#endif
+}
+
+osStatus_t osEventRelease(osEvent_t *event) {
+#if (UCOS3_ACTIVE_EN > 0u)
+  if (event == NULL) {
+    return osErrorParameter;
+  }
+  return (event->buf.pool != NULL) ? osBufferRelease(&event->buf) : osOK;
+#else
+  (void)event;
+  return osError;
+#endif
+}
+
+osActiveId_t osActiveNew(osActiveHandler_t handler, void *argument, const osActiveAttr_t *attr) {
+#if (UCOS3_ACTIVE_EN > 0u)
+  if (osUcos3IrqContext() ||
+      (handler == NULL) ||
+      (attr == NULL) ||
+      (attr->cb_mem == NULL) ||
+      (attr->cb_size < sizeof(os_ucos3_active_t)) ||
+      (attr->stack_mem == NULL) ||
+      (attr->stack_size < (UCOS3_THREAD_MIN_STACK_WORDS * sizeof(CPU_STK)))) {
+    return NULL;
+  }
+
+  os_ucos3_active_t *ao = (os_ucos3_active_t *)attr->cb_mem;
+  memset(ao, 0, sizeof(*ao));
+  osUcos3ObjectInit(&ao->object, osUcos3ObjectActive, attr->name, 0u);
+  ao->handler = handler;
+  ao->argument = argument;
+  for (uint32_t i = 0u; i < UCOS3_ACTIVE_QUEUE; ++i) {
+    ao->slots[i].seq = i;
+  }
+
+  OS_ERR err;
+  OSSemCreate(&ao->wake, (CPU_CHAR *)(attr->name != NULL ? attr->name : "cmsis.active"), (OS_SEM_CTR)0u, &err);
+  if (err != OS_ERR_NONE) {
+    return NULL;
+  }
+
+  ao->created = true;
+  const osThreadAttr_t thread_attr = {
+    .name       = attr->name,
+    .cb_mem     = &ao->thread,
+    .cb_size    = sizeof(ao->thread),
+    .stack_mem  = attr->stack_mem,
+    .stack_size = attr->stack_size,
+    .priority   = (attr->priority != osPriorityNone) ? attr->priority : osPriorityNormal,
+  };
+  if (osThreadNew(osUcos3ActiveThread, ao, &thread_attr) == NULL) {
+    ao->created = false;
+    OSSemDel(&ao->wake, OS_OPT_DEL_ALWAYS, &err);
+    return NULL;
+  }
+  return (osActiveId_t)ao;
+#else
+  (void)handler;
+  (void)argument;
+  (void)attr;
+  return NULL;
+#endif
+}
+
+osStatus_t osActivePost(osActiveId_t ao_id, osEvent_t *event) {
+#if (UCOS3_ACTIVE_EN > 0u)
+  os_ucos3_active_t *ao = osUcos3ActiveFromId(ao_id);
+  if ((ao == NULL) || (event == NULL)) {
+    return osErrorParameter;
+  }
+
+  /* As with osBufferPut, the queue's reference is taken before the event
+   * becomes visible to the thread. */
+  const bool dynamic = (event->buf.pool != NULL);
+  if (dynamic && (osBufferRetain(&event->buf, 1u) != osOK)) {
+    return osErrorResource;
+  }
+
+  uint32_t depth;
+  if (!osUcos3ActivePush(ao, event, &depth)) {
+    osUcos3StatCount(&ao->dropped, NULL, 0u);
+    if (dynamic) {
+      (void)osBufferRelease(&event->buf);
+    }
+    return osErrorResource;
+  }
+  osUcos3StatCount(&ao->posted, &ao->max_queued, depth);
+
+  if (osUcos3ActiveFlag(&ao->waiting, 1u, 0u)) {
+    OS_ERR err;
+    OSSemPost(&ao->wake, OS_OPT_POST_1, &err);
+  }
+  return osOK;
+#else
+  (void)ao_id;
+  (void)event;
+  return osError;
+#endif
+}
+
+osStatus_t osTimeEventArm(osTimeEvent_t *te, uint32_t ticks, uint32_t interval) {
+#if (UCOS3_ACTIVE_EN > 0u)
+  if ((te == NULL) || (ticks == 0u) || (te->event.buf.pool != NULL) ||
+      (osUcos3ActiveFromId(te->target) == NULL)) {
+    return osErrorParameter;
+  }
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  if (te->ctr == 0u) {
+    te->next = os_ucos3_kernel.time_events;
+    os_ucos3_kernel.time_events = te;
+  }
+  te->ctr = ticks;
+  te->interval = interval;
+  CPU_CRITICAL_EXIT();
+  return osOK;
+#else
+  (void)te;
+  (void)ticks;
+  (void)interval;
+  return osError;
+#endif
+}
+
+osStatus_t osTimeEventDisarm(osTimeEvent_t *te) {
+#if (UCOS3_ACTIVE_EN > 0u)
+  if (te == NULL) {
+    return osErrorParameter;
+  }
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+  return (osUcos3TimeEventUnlink(te, NULL) != 0u) ? osOK : osErrorResource;
+#else
+  (void)te;
+  return osError;
+#endif
+}
+
+osStatus_t osActiveGetStats(osActiveId_t ao_id, osActiveStats_t *stats) {
+#if (UCOS3_ACTIVE_EN > 0u)
+  os_ucos3_active_t *ao = osUcos3ActiveFromId(ao_id);
+  if ((ao == NULL) || (stats == NULL)) {
+    return osErrorParameter;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  stats->posted = ao->posted;
+  stats->dispatched = ao->dispatched;
+  stats->dropped = ao->dropped;
+  stats->max_queued = ao->max_queued;
+  CPU_CRITICAL_EXIT();
+  return osOK;
+#else
+  (void)ao_id;
+  (void)stats;
+  return osError;
+#endif
+}
+
+osStatus_t osActiveDelete(osActiveId_t ao_id) {
+#if (UCOS3_ACTIVE_EN > 0u)
+  os_ucos3_active_t *ao = osUcos3ActiveFromId(ao_id);
+  if (ao == NULL) {
+    return osErrorParameter;
+  }
+  if (osUcos3IrqContext()) {
+    return osErrorISR;
+  }
+  if (osThreadGetId() == (osThreadId_t)&ao->thread) {
+    return osErrorResource;
+  }
+
+  CPU_SR_ALLOC();
+  CPU_CRITICAL_ENTER();
+  ao->created = false;
+  CPU_CRITICAL_EXIT();
+
+  (void)osThreadTerminate((osThreadId_t)&ao->thread);
+  (void)osUcos3TimeEventUnlink(NULL, ao_id);
+  if ((ao->current != NULL) && (ao->current->buf.pool != NULL)) {
+    (void)osBufferRelease(&ao->current->buf);
+  }
+  for (osEvent_t *event = osUcos3ActiveTake(ao); event != NULL; event = osUcos3ActiveTake(ao)) {
+    if (event->buf.pool != NULL) {
+      (void)osBufferRelease(&event->buf);
+    }
+  }
+
+  OS_ERR err;
+  OSSemDel(&ao->wake, OS_OPT_DEL_ALWAYS, &err);
+  return osOK;
+#else
+  (void)ao_id;
+  return osError;
+#endif
 }
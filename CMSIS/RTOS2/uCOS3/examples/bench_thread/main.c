@@ -0,0 +1,172 @@
+#include "cmsis_os2.h"
+#include "cmsis_os2_ext.h"
+#include "ucos3_os2.h"
+
+/*
+ * 线程创建 / 上下文切换基准：
+ *  - 创建：以 4 KB 栈分别按 osThreadStackClear / Paint / NoInit 创建并删除线程；
+ *  - 切换：两个线程通过信号量乒乓，对比默认（保存 FP 上下文）与 osThreadNoFpu。
+ * 结果（平均每次操作的时间戳周期）保存在 bench_results[]，可用调试器查看，
+ * 或定义 BENCH_LOG(name, cycles) 输出。
+ */
+#ifndef BENCH_TS_GET
+#define BENCH_TS_GET()            ((uint32_t)OS_TS_GET())
+#endif
+
+#ifndef BENCH_LOG
+#define BENCH_LOG(name, cycles)   do { (void)(name); (void)(cycles); } while (0)
+#endif
+
+#define BENCH_ROUNDS              64u
+#define BENCH_STACK_BYTES         4096u
+
+typedef struct {
+  const char *name;
+  uint32_t    cycles;
+} bench_result_t;
+
+volatile bench_result_t bench_results[5];
+volatile uint32_t bench_done;
+
+/* 控制块与栈 */
+static os_ucos3_thread_t runner_cb;
+static os_ucos3_thread_t target_cb;
+static os_ucos3_thread_t ping_cb;
+static os_ucos3_thread_t pong_cb;
+static CPU_STK runner_stack[1024 / sizeof(CPU_STK)];
+static CPU_STK target_stack[BENCH_STACK_BYTES / sizeof(CPU_STK)];
+static CPU_STK ping_stack[512 / sizeof(CPU_STK)];
+static CPU_STK pong_stack[512 / sizeof(CPU_STK)];
+
+static os_ucos3_semaphore_t ping_sem_cb;
+static os_ucos3_semaphore_t pong_sem_cb;
+static os_ucos3_semaphore_t done_sem_cb;
+
+static osSemaphoreId_t ping_sem;
+static osSemaphoreId_t pong_sem;
+static osSemaphoreId_t done_sem;
+
+static void bench_record(uint32_t index, const char *name, uint32_t cycles) {
+  bench_results[index].name = name;
+  bench_results[index].cycles = cycles;
+  BENCH_LOG(name, cycles);
+}
+
+static void target_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    osThreadSuspend(osThreadGetId());
+  }
+}
+
+/* 被创建线程优先级低于 runner，不会在测量区间内运行 */
+static uint32_t bench_create(uint32_t attr_bits) {
+  uint32_t total = 0u;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    const osThreadAttr_t attr = {
+      .name       = "bench.target",
+      .attr_bits  = attr_bits,
+      .cb_mem     = &target_cb,
+      .cb_size    = sizeof(target_cb),
+      .stack_mem  = target_stack,
+      .stack_size = sizeof(target_stack),
+      .priority   = osPriorityLow,
+    };
+
+    uint32_t start = BENCH_TS_GET();
+    osThreadId_t id = osThreadNew(target_thread, NULL, &attr);
+    total += BENCH_TS_GET() - start;
+    (void)osThreadTerminate(id);
+  }
+  return total / BENCH_ROUNDS;
+}
+
+static void pong_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    osSemaphoreAcquire(pong_sem, osWaitForever);
+    osSemaphoreRelease(ping_sem);
+  }
+}
+
+/* 每轮两次切换：ping -> pong -> ping */
+static void ping_thread(void *argument) {
+  uint32_t index = (uint32_t)(uintptr_t)argument;
+  uint32_t start = BENCH_TS_GET();
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    osSemaphoreRelease(pong_sem);
+    osSemaphoreAcquire(ping_sem, osWaitForever);
+  }
+  bench_results[index].cycles = (BENCH_TS_GET() - start) / (2u * BENCH_ROUNDS);
+  osSemaphoreRelease(done_sem);
+}
+
+static void bench_switch(uint32_t index, const char *name, uint32_t attr_bits) {
+  const osThreadAttr_t pong_attr = {
+    .name       = "bench.pong",
+    .attr_bits  = attr_bits,
+    .cb_mem     = &pong_cb,
+    .cb_size    = sizeof(pong_cb),
+    .stack_mem  = pong_stack,
+    .stack_size = sizeof(pong_stack),
+    .priority   = osPriorityHigh,
+  };
+  const osThreadAttr_t ping_attr = {
+    .name       = "bench.ping",
+    .attr_bits  = attr_bits,
+    .cb_mem     = &ping_cb,
+    .cb_size    = sizeof(ping_cb),
+    .stack_mem  = ping_stack,
+    .stack_size = sizeof(ping_stack),
+    .priority   = osPriorityAboveNormal,
+  };
+
+  osThreadId_t pong = osThreadNew(pong_thread, NULL, &pong_attr);
+  osThreadId_t ping = osThreadNew(ping_thread, (void *)(uintptr_t)index, &ping_attr);
+  osSemaphoreAcquire(done_sem, osWaitForever);
+  (void)osThreadTerminate(ping);
+  (void)osThreadTerminate(pong);
+
+  bench_record(index, name, bench_results[index].cycles);
+}
+
+static void runner_thread(void *argument) {
+  (void)argument;
+
+  bench_record(0u, "create.clear", bench_create(osThreadStackClear));
+  bench_record(1u, "create.paint", bench_create(osThreadStackPaint));
+  bench_record(2u, "create.noinit", bench_create(osThreadStackNoInit));
+  bench_switch(3u, "switch.fpu", 0u);
+  bench_switch(4u, "switch.nofpu", osThreadNoFpu);
+
+  bench_done = 1u;
+  for (;;) {
+    osThreadSuspend(osThreadGetId());
+  }
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osSemaphoreAttr_t ping_sem_attr = { .name = "bench.ping", .cb_mem = &ping_sem_cb, .cb_size = sizeof(ping_sem_cb) };
+  const osSemaphoreAttr_t pong_sem_attr = { .name = "bench.pong", .cb_mem = &pong_sem_cb, .cb_size = sizeof(pong_sem_cb) };
+  const osSemaphoreAttr_t done_sem_attr = { .name = "bench.done", .cb_mem = &done_sem_cb, .cb_size = sizeof(done_sem_cb) };
+  ping_sem = osSemaphoreNew(1u, 0u, &ping_sem_attr);
+  pong_sem = osSemaphoreNew(1u, 0u, &pong_sem_attr);
+  done_sem = osSemaphoreNew(1u, 0u, &done_sem_attr);
+
+  const osThreadAttr_t runner_attr = {
+    .name       = "bench.runner",
+    .cb_mem     = &runner_cb,
+    .cb_size    = sizeof(runner_cb),
+    .stack_mem  = runner_stack,
+    .stack_size = sizeof(runner_stack),
+    .priority   = osPriorityNormal,
+  };
+  osThreadNew(runner_thread, NULL, &runner_attr);
+
+  osKernelStart();
+
+  for (;;) {
+  }
+}
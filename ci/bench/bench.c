@@ -0,0 +1,279 @@
+#include "bench.h"
+
+#include <stdlib.h>
+
+#if defined(BENCH_HOST)
+#include <semaphore.h>
+#include <time.h>
+
+#include "host_cpu.h"
+
+#define BENCH_HOST_IRQ  1u
+#endif
+
+static uint32_t bench_results;
+static uint32_t bench_failures;
+
+/* ==== Software interrupt ==== */
+
+static void (*bench_isr)(void);
+
+#if defined(BENCH_VSIM)
+static void bench_vsim_isr(void *arg) {
+  (void)arg;
+  bench_irq_handler();
+}
+#endif
+
+#if defined(BENCH_HOST)
+/* Device thread standing in for a one-shot timer: sleeps for the requested
+ * delay (nanoseconds, the host timestamp unit) and raises the interrupt. */
+static sem_t bench_host_request;
+static volatile uint32_t bench_host_delay;
+
+static void *bench_host_timer(void *arg) {
+  (void)arg;
+  for (;;) {
+    while (sem_wait(&bench_host_request) != 0) {
+    }
+    struct timespec delay = {
+      .tv_sec  = (time_t)(bench_host_delay / 1000000000u),
+      .tv_nsec = (long)(bench_host_delay % 1000000000u),
+    };
+    (void)nanosleep(&delay, NULL);
+    host_irq_trigger(BENCH_HOST_IRQ);
+  }
+  return NULL;
+}
+#endif
+
+void bench_irq_init(void (*isr)(void)) {
+  bench_isr = isr;
+#if defined(BENCH_HOST)
+  host_irq_set_handler(BENCH_HOST_IRQ, bench_irq_handler);
+  (void)sem_init(&bench_host_request, 0, 0u);
+  (void)host_device_thread(bench_host_timer, NULL);
+#endif
+}
+
+bool bench_irq_trigger(void) {
+  if (bench_isr == NULL) {
+    return false;
+  }
+#if defined(BENCH_VSIM)
+  return vsim_isr_after(0u, bench_vsim_isr, NULL);
+#elif defined(BENCH_HOST)
+  host_irq_trigger(BENCH_HOST_IRQ);
+  return true;
+#elif defined(BENCH_IRQ_TRIGGER)
+  BENCH_IRQ_TRIGGER();
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool bench_irq_schedule(uint32_t delay) {
+  if (bench_isr == NULL) {
+    return false;
+  }
+#if defined(BENCH_VSIM)
+  return vsim_isr_after(delay, bench_vsim_isr, NULL);
+#elif defined(BENCH_HOST)
+  bench_host_delay = delay;
+  return sem_post(&bench_host_request) == 0;
+#elif defined(BENCH_IRQ_SCHEDULE)
+  BENCH_IRQ_SCHEDULE(delay);
+  return true;
+#else
+  (void)delay;
+  return false;
+#endif
+}
+
+/* The simulator brackets injected ISRs itself; CMSIS-FreeRTOS needs no
+ * kernel notification. */
+void bench_irq_handler(void) {
+#if !defined(BENCH_VSIM) && defined(BENCH_UCOS3)
+  OSIntEnter();
+#elif !defined(BENCH_VSIM) && defined(BENCH_UCOS2)
+#if OS_CRITICAL_METHOD == 3u
+  OS_CPU_SR cpu_sr = 0u;
+#endif
+  OS_ENTER_CRITICAL();
+  OSIntEnter();
+  OS_EXIT_CRITICAL();
+#endif
+  if (bench_isr != NULL) {
+    bench_isr();
+  }
+#if !defined(BENCH_VSIM) && (defined(BENCH_UCOS3) || defined(BENCH_UCOS2))
+  OSIntExit();
+#endif
+}
+
+/* ==== Results ==== */
+
+void bench_stat_init(bench_stat_t *stat, const char *name) {
+  stat->name = name;
+  stat->count = 0u;
+  stat->min = UINT32_MAX;
+  stat->max = 0u;
+  stat->sum = 0u;
+}
+
+void bench_stat_add(bench_stat_t *stat, uint32_t value) {
+  stat->count++;
+  stat->sum += value;
+  if (value < stat->min) {
+    stat->min = value;
+  }
+  if (value > stat->max) {
+    stat->max = value;
+  }
+}
+
+/* Cost of the timestamp read itself, reported so readers can discount it. */
+static uint32_t bench_ts_overhead(void) {
+  uint32_t best = UINT32_MAX;
+  for (uint32_t i = 0u; i < 16u; ++i) {
+    uint32_t start = BENCH_TS_GET();
+    uint32_t delta = BENCH_TS_GET() - start;
+    if (delta < best) {
+      best = delta;
+    }
+  }
+  return best;
+}
+
+void bench_json_begin(const char *suite) {
+  osVersion_t version = { 0u, 0u };
+  char id[32] = "";
+  (void)osKernelGetInfo(&version, id, sizeof(id));
+
+  bench_results = 0u;
+  bench_failures = 0u;
+  BENCH_PRINTF("{\n");
+  BENCH_PRINTF("  \"suite\": \"%s\",\n", suite);
+  BENCH_PRINTF("  \"port\": \"%s\",\n", BENCH_PORT);
+  BENCH_PRINTF("  \"kernel\": \"%s\",\n", id);
+  BENCH_PRINTF("  \"kernel_version\": %lu,\n", (unsigned long)version.kernel);
+  BENCH_PRINTF("  \"ts_hz\": %lu,\n", (unsigned long)BENCH_TS_HZ);
+  BENCH_PRINTF("  \"tick_hz\": %lu,\n", (unsigned long)osKernelGetTickFreq());
+  BENCH_PRINTF("  \"ts_overhead\": %lu,\n", (unsigned long)bench_ts_overhead());
+  BENCH_PRINTF("  \"results\": [");
+}
+
+static void bench_json_next(void) {
+  BENCH_PRINTF("%s\n    ", (bench_results++ == 0u) ? "" : ",");
+}
+
+void bench_json_stat(const bench_stat_t *stat) {
+  bench_json_next();
+  if (stat->count == 0u) {
+    BENCH_PRINTF("{\"name\": \"%s\", \"count\": 0}", stat->name);
+    return;
+  }
+  BENCH_PRINTF("{\"name\": \"%s\", \"count\": %lu, \"min\": %lu, \"avg\": %lu, \"max\": %lu}",
+               stat->name, (unsigned long)stat->count, (unsigned long)stat->min,
+               (unsigned long)(stat->sum / stat->count), (unsigned long)stat->max);
+}
+
+void bench_json_skip(const char *name, const char *reason) {
+  bench_json_next();
+  BENCH_PRINTF("{\"name\": \"%s\", \"skipped\": \"%s\"}", name, reason);
+}
+
+static int bench_cmp_u32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted samples, per_mille in 0..1000. */
+static uint32_t bench_percentile(const uint32_t *sorted, uint32_t count, uint32_t per_mille) {
+  uint32_t rank = (uint32_t)((((uint64_t)count * per_mille) + 999u) / 1000u);
+  return sorted[(rank == 0u) ? 0u : (rank - 1u)];
+}
+
+void bench_json_hist(const char *name, uint32_t *samples, uint32_t count) {
+  bench_json_next();
+  if (count == 0u) {
+    BENCH_PRINTF("{\"name\": \"%s\", \"count\": 0}", name);
+    return;
+  }
+  qsort(samples, count, sizeof(samples[0]), bench_cmp_u32);
+  BENCH_PRINTF("{\"name\": \"%s\", \"count\": %lu, \"min\": %lu, \"p50\": %lu, \"p99\": %lu, \"p999\": %lu, \"max\": %lu",
+               name, (unsigned long)count, (unsigned long)samples[0],
+               (unsigned long)bench_percentile(samples, count, 500u),
+               (unsigned long)bench_percentile(samples, count, 990u),
+               (unsigned long)bench_percentile(samples, count, 999u),
+               (unsigned long)samples[count - 1u]);
+
+  /* Buckets [2^k, 2^(k+1)), listed as [lower bound, count]; 0 lands in the first. */
+  BENCH_PRINTF(", \"histogram\": [");
+  uint32_t i = 0u;
+  bool first = true;
+  while (i < count) {
+    uint32_t lower = 1u;
+    while ((lower <= (samples[i] / 2u)) && (lower < 0x80000000u)) {
+      lower *= 2u;
+    }
+    uint32_t upper = (lower < 0x80000000u) ? (lower * 2u) : UINT32_MAX;
+    uint32_t n = 0u;
+    while ((i < count) && ((samples[i] < upper) || (upper == UINT32_MAX))) {
+      n++;
+      i++;
+    }
+    BENCH_PRINTF("%s[%lu, %lu]", first ? "" : ", ", (unsigned long)((samples[i - n] == 0u) ? 0u : lower), (unsigned long)n);
+    first = false;
+  }
+  BENCH_PRINTF("]}");
+}
+
+void bench_json_rate(const char *name, uint64_t iterations, uint32_t ticks) {
+  uint64_t per_second = (ticks != 0u) ? ((iterations * osKernelGetTickFreq()) / ticks) : 0u;
+
+  bench_json_next();
+  BENCH_PRINTF("{\"name\": \"%s\", \"iterations\": %llu, \"ticks\": %lu, \"per_second\": %llu}",
+               name, (unsigned long long)iterations, (unsigned long)ticks, (unsigned long long)per_second);
+}
+
+/* Signed difference of two minimums (CMSIS minus native). */
+static long bench_min_delta(const bench_stat_t pair[2]) {
+  return (long)pair[0].min - (long)pair[1].min;
+}
+
+void bench_json_pair(const char *name, const bench_stat_t ts[2], const bench_stat_t *instr, uint32_t budget,
+                     uint32_t instr_budget) {
+  long delta = bench_min_delta(ts);
+
+  bench_json_next();
+  BENCH_PRINTF("{\"name\": \"%s\", \"count\": %lu, \"cmsis\": %lu, \"native\": %lu, \"delta\": %ld",
+               name, (unsigned long)ts[0].count, (unsigned long)ts[0].min, (unsigned long)ts[1].min, delta);
+  if (instr != NULL) {
+    BENCH_PRINTF(", \"cmsis_instr\": %lu, \"native_instr\": %lu, \"delta_instr\": %ld",
+                 (unsigned long)instr[0].min, (unsigned long)instr[1].min, bench_min_delta(instr));
+  }
+  if (budget != BENCH_NO_BUDGET) {
+    bool ok = (delta <= (long)budget);
+    BENCH_PRINTF(", \"budget\": %lu, \"within_budget\": %s", (unsigned long)budget, ok ? "true" : "false");
+    if (!ok) {
+      bench_failures++;
+    }
+  }
+  if ((instr != NULL) && (instr_budget != BENCH_NO_BUDGET)) {
+    bool ok = (bench_min_delta(instr) <= (long)instr_budget);
+    BENCH_PRINTF(", \"instr_budget\": %lu, \"within_instr_budget\": %s", (unsigned long)instr_budget,
+                 ok ? "true" : "false");
+    if (!ok) {
+      bench_failures++;
+    }
+  }
+  BENCH_PRINTF("}");
+}
+
+uint32_t bench_json_end(void) {
+  BENCH_PRINTF("\n  ],\n  \"failures\": %lu\n}\n", (unsigned long)bench_failures);
+  return bench_failures;
+}
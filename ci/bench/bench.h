@@ -0,0 +1,175 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/*
+ * Portable CMSIS-RTOS2 benchmark support shared by the suites in ci/bench.
+ *
+ * Select the port with -DBENCH_UCOS2, -DBENCH_UCOS3 or -DBENCH_FREERTOS
+ * (CMSIS-FreeRTOS). Timestamps come from BENCH_TS_GET() (defaults to
+ * UCOS2_TS_GET() / OS_TS_GET() / osKernelGetSysTimerCount()); define
+ * BENCH_TS_HZ to its frequency so results can be converted to time. Results
+ * are printed as one JSON document through BENCH_PRINTF.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "cmsis_os2.h"
+
+#if defined(BENCH_UCOS3)
+#include "ucos3_os2.h"
+#define BENCH_PORT                "ucos3"
+#define BENCH_CB(kind)            os_ucos3_##kind##_t
+#define BENCH_WORKQ               (UCOS3_WORKQ_EN > 0u)
+#define BENCH_POOL                (UCOS3_POOL_EN > 0u)
+#define BENCH_CORO                (UCOS3_CORO_EN > 0u)
+#define BENCH_ACTIVE              (UCOS3_ACTIVE_EN > 0u)
+typedef CPU_STK bench_stk_t;
+#ifndef BENCH_TS_GET
+#define BENCH_TS_GET()            ((uint32_t)OS_TS_GET())
+#endif
+#elif defined(BENCH_UCOS2)
+#include "ucos2_os2.h"
+#define BENCH_PORT                "ucos2"
+#define BENCH_CB(kind)            os_ucos2_##kind##_t
+#define BENCH_WORKQ               (UCOS2_WORKQ_EN > 0u)
+#define BENCH_POOL                (UCOS2_POOL_EN > 0u)
+#define BENCH_CORO                (UCOS2_CORO_EN > 0u)
+#define BENCH_ACTIVE              (UCOS2_ACTIVE_EN > 0u)
+typedef OS_STK bench_stk_t;
+#ifndef BENCH_TS_GET
+#ifndef UCOS2_TS_GET
+#error "Define UCOS2_TS_GET() or BENCH_TS_GET() (32-bit free-running timestamp)."
+#endif
+#define BENCH_TS_GET()            ((uint32_t)UCOS2_TS_GET())
+#endif
+#elif defined(BENCH_FREERTOS)
+#include "FreeRTOS.h"
+#include "freertos_mpool.h"
+#define BENCH_PORT                "freertos"
+#define BENCH_CB(kind)            bench_freertos_##kind##_t
+#define BENCH_WORKQ               0         /* osWorkQueue* is a uC/OS wrapper extension */
+#define BENCH_POOL                0         /* osPool* likewise */
+#define BENCH_CORO                0         /* osCoro* likewise */
+#define BENCH_ACTIVE              0         /* osActive* likewise */
+typedef StaticTask_t       bench_freertos_thread_t;
+typedef StaticSemaphore_t  bench_freertos_semaphore_t;
+typedef StaticSemaphore_t  bench_freertos_mutex_t;
+typedef StaticEventGroup_t bench_freertos_event_flags_t;
+typedef StaticTimer_t      bench_freertos_timer_t;
+typedef StaticQueue_t      bench_freertos_message_queue_t;
+typedef MemPool_t          bench_freertos_memory_pool_t;
+typedef StackType_t bench_stk_t;
+#ifndef BENCH_TS_GET
+#define BENCH_TS_GET()            osKernelGetSysTimerCount()
+#endif
+#ifndef BENCH_TS_HZ
+#define BENCH_TS_HZ               osKernelGetSysTimerFreq()
+#endif
+#else
+#error "Define BENCH_UCOS2, BENCH_UCOS3 or BENCH_FREERTOS."
+#endif
+
+/* Application work between kernel calls. The simulator only advances time
+ * for kernel services, so loops there charge the cycles explicitly. */
+#if defined(BENCH_VSIM)
+#include "vsim.h"
+#define BENCH_WORK(cycles)        vsim_consume(cycles)
+#else
+#define BENCH_WORK(cycles)        ((void)0)
+#endif
+
+/* Set to 0 for a port without osMemoryPool*. */
+#ifndef BENCH_MEMORY_POOL
+#define BENCH_MEMORY_POOL         1
+#endif
+
+#ifndef BENCH_TS_HZ
+#define BENCH_TS_HZ               0u        /* unknown: results stay in timestamp units */
+#endif
+
+#ifndef BENCH_PRINTF
+#define BENCH_PRINTF              printf
+#endif
+
+/* Optional retired-instruction counter (e.g. a PMU or the DWT counters);
+ * BENCH_INSTR_OK() reports whether it is usable at run time. */
+#ifdef BENCH_INSTR_GET
+int      bench_perf_ok(void);       /* Linux backend, bench_perf_linux.c */
+uint32_t bench_perf_instr(void);
+#ifndef BENCH_INSTR_OK
+#define BENCH_INSTR_OK()          1
+#endif
+#else
+#define BENCH_INSTR_GET()         0u
+#define BENCH_INSTR_OK()          0
+#endif
+
+/* Called once the JSON document is complete; status is non-zero when a
+ * result failed its budget. */
+#ifndef BENCH_EXIT
+#define BENCH_EXIT(status)        do { (void)(status); for (;;) { (void)osThreadSuspend(osThreadGetId()); } } while (0)
+#endif
+
+#ifndef BENCH_ROUNDS
+#define BENCH_ROUNDS              64u
+#endif
+
+#define BENCH_STACK(name, bytes)  static bench_stk_t name[(bytes) / sizeof(bench_stk_t)]
+
+/* Message queue control block: uC/OS-III keeps its free list behind the
+ * control block, so reserve one pointer per message (plus alignment). */
+#define BENCH_MQ_CB_SIZE(count)   (sizeof(BENCH_CB(message_queue)) + (((count) + 1u) * sizeof(void *)))
+#define BENCH_MQ_CB(name, count)  static void *name[(BENCH_MQ_CB_SIZE(count) + sizeof(void *) - 1u) / sizeof(void *)]
+
+/* Memory pool control block: both ports keep the 16-bit free list behind the
+ * control block, so reserve one index per block (plus alignment). */
+#define BENCH_MP_CB_SIZE(count)   (sizeof(BENCH_CB(memory_pool)) + (((count) + 1u) * sizeof(uint16_t)))
+#define BENCH_MP_CB(name, count)  static void *name[(BENCH_MP_CB_SIZE(count) + sizeof(void *) - 1u) / sizeof(void *)]
+
+/* Software interrupt for suites that measure ISR paths: bench_irq_trigger()
+ * raises an interrupt whose handler runs the isr given to bench_irq_init(),
+ * bench_irq_schedule() raises it delay timestamp units from now. ci/vsim
+ * (BENCH_VSIM) and ci/host-port (BENCH_HOST) work out of the box; on a board
+ * define BENCH_IRQ_TRIGGER() (e.g. NVIC_SetPendingIRQ) and/or
+ * BENCH_IRQ_SCHEDULE(delay) (e.g. a one-shot timer compare) and call
+ * bench_irq_handler() from that vector. Both return false when unsupported. */
+void bench_irq_init(void (*isr)(void));
+bool bench_irq_trigger(void);
+bool bench_irq_schedule(uint32_t delay);
+void bench_irq_handler(void);
+
+/* Running min/avg/max of one measurement, in timestamp units. */
+typedef struct bench_stat {
+  const char *name;
+  uint32_t    count;
+  uint32_t    min;
+  uint32_t    max;
+  uint64_t    sum;
+} bench_stat_t;
+
+void bench_stat_init(bench_stat_t *stat, const char *name);
+void bench_stat_add(bench_stat_t *stat, uint32_t value);
+
+/* JSON document: begin, any number of results, end. */
+void bench_json_begin(const char *suite);
+void bench_json_stat(const bench_stat_t *stat);
+void bench_json_skip(const char *name, const char *reason);
+/* Distribution result: sorts samples in place and prints min, p50, p99,
+ * p99.9, max and a power-of-two histogram. */
+void bench_json_hist(const char *name, uint32_t *samples, uint32_t count);
+/* Throughput result: iterations completed in ticks kernel ticks. */
+void bench_json_rate(const char *name, uint64_t iterations, uint32_t ticks);
+/* Paired result: the same operation through CMSIS and natively. The delta
+ * of the minimums is checked against budget, and the delta of the
+ * instruction minimums against instr_budget (BENCH_NO_BUDGET to skip
+ * either); instr may be NULL when no instruction counter is available, which
+ * also skips instr_budget. */
+#define BENCH_NO_BUDGET           UINT32_MAX
+void bench_json_pair(const char *name, const bench_stat_t ts[2], const bench_stat_t *instr, uint32_t budget,
+                     uint32_t instr_budget);
+/* Returns the number of results that exceeded their budget. */
+uint32_t bench_json_end(void);
+
+#endif /* BENCH_H_ */
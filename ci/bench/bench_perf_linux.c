@@ -0,0 +1,42 @@
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+/*
+ * Retired user-space instructions of the calling thread via perf_event_open.
+ * On the host port every task runs on the same host thread, so one counter
+ * covers them all. Unavailable counters (containers, perf_event_paranoid)
+ * make bench_perf_ok() return 0 and the results omit instruction counts.
+ */
+
+static int bench_perf_fd = -2;
+
+static void bench_perf_open(void) {
+  struct perf_event_attr attr;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  bench_perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+int bench_perf_ok(void) {
+  if (bench_perf_fd == -2) {
+    bench_perf_open();
+  }
+  return (bench_perf_fd >= 0) ? 1 : 0;
+}
+
+uint32_t bench_perf_instr(void) {
+  uint64_t count = 0u;
+  if ((bench_perf_ok() == 0) || (read(bench_perf_fd, &count, sizeof(count)) != (ssize_t)sizeof(count))) {
+    return 0u;
+  }
+  return (uint32_t)count;
+}
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+"""Print a Markdown table comparing ci/bench JSON results across ports.
+
+    ci/bench/compare.py _bench_build/tm-*.json
+
+Each column is one result file (usually one kernel); each row is one
+result name. Throughput results show per_second, distributions show
+p50/p99/max and other latency results avg, both in timestamp units (see
+ts_hz); paired results show the CMSIS-minus-native delta, and skipped
+results show "-".
+"""
+
+import json
+import sys
+
+
+def cell(result):
+    if result is None or "skipped" in result:
+        return "-"
+    if "p99" in result:
+        return "{}/{}/{}".format(result["p50"], result["p99"], result["max"])
+    for key in ("per_second", "delta", "avg"):
+        if key in result:
+            return str(result[key])
+    return str(result.get("count", "-"))
+
+
+def main(paths):
+    if not paths:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+
+    docs = []
+    for path in paths:
+        with open(path, encoding="utf-8") as f:
+            docs.append(json.load(f))
+
+    names = []
+    for doc in docs:
+        for result in doc["results"]:
+            if result["name"] not in names:
+                names.append(result["name"])
+
+    print("| {} | {} |".format(docs[0]["suite"], " | ".join(doc["port"] for doc in docs)))
+    print("| --- |" + " ---: |" * len(docs))
+    for name in names:
+        row = []
+        for doc in docs:
+            found = next((r for r in doc["results"] if r["name"] == name), None)
+            row.append(cell(found))
+        print("| {} | {} |".format(name, " | ".join(row)))
+    print()
+    print("ts_hz: " + ", ".join("{}={}".format(doc["port"], doc["ts_hz"]) for doc in docs))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
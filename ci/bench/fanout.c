@@ -0,0 +1,204 @@
+#include <string.h>
+
+#include "bench.h"
+
+/*
+ * Fan-out throughput: a producer sends every frame to FANOUT_CONSUMERS
+ * threads, each behind its own pointer-sized message queue, for
+ * BENCH_FANOUT_TICKS kernel ticks; the result is frames sent per second.
+ * fanout.copy copies the frame into a pool block per consumer and each
+ * consumer frees its copy. fanout.zerocopy fills one reference-counted
+ * buffer (osBuffer_t, cmsis_os2_ext.h), posts it to every queue and the
+ * last consumer's release returns it to the pool. ci/vsim does not time
+ * memcpy, so each copy charges FANOUT_COPY_CYCLES there.
+ */
+
+#ifndef BENCH_FANOUT_TICKS
+#define BENCH_FANOUT_TICKS  1000u
+#endif
+
+#define FANOUT_CONSUMERS    3u
+#define FANOUT_FRAME        1024u
+#define FANOUT_DEPTH        4u
+#define FANOUT_BLOCKS       ((FANOUT_CONSUMERS * FANOUT_DEPTH) + 1u)
+#define FANOUT_COPY_CYCLES  (FANOUT_FRAME / 4u)     /* one word per cycle */
+#define FANOUT_LOOP_CYCLES  20u
+
+#if defined(BENCH_FREERTOS)
+
+/* osBuffer_t is an extension of the uC/OS wrappers. */
+int main(void) {
+  bench_json_begin("fanout");
+  bench_json_skip("fanout.copy", "cmsis_os2_ext.h not available");
+  bench_json_skip("fanout.zerocopy", "cmsis_os2_ext.h not available");
+  BENCH_EXIT(bench_json_end());
+  return 0;
+}
+
+#else
+
+#include "cmsis_os2_ext.h"
+
+#define FANOUT_BLOCK_SIZE   osBufferBlockSize(FANOUT_FRAME)
+
+static BENCH_CB(thread) runner_cb;
+static BENCH_CB(thread) producer_cb;
+static BENCH_CB(thread) consumer_cb[FANOUT_CONSUMERS];
+BENCH_STACK(runner_stack, 2048u);
+BENCH_STACK(producer_stack, 1024u);
+static bench_stk_t consumer_stack[FANOUT_CONSUMERS][1024u / sizeof(bench_stk_t)];
+
+static void *mq_cb[FANOUT_CONSUMERS][(BENCH_MQ_CB_SIZE(FANOUT_DEPTH) + sizeof(void *) - 1u) / sizeof(void *)];
+static void *mq_storage[FANOUT_CONSUMERS][FANOUT_DEPTH];
+static osMessageQueueId_t mq[FANOUT_CONSUMERS];
+
+BENCH_MP_CB(pool_cb, FANOUT_BLOCKS);
+static uint64_t pool_storage[(FANOUT_BLOCKS * FANOUT_BLOCK_SIZE) / sizeof(uint64_t)];
+static osMemoryPoolId_t pool;
+
+static uint8_t frame[FANOUT_FRAME];
+static volatile bool zerocopy;
+static volatile bool stop;
+static volatile uint32_t frames;
+
+/* ==== Threads ==== */
+
+static void fanout_copy(void *dst) {
+  memcpy(dst, frame, FANOUT_FRAME);
+  BENCH_WORK(FANOUT_COPY_CYCLES);
+}
+
+static void producer_thread(void *argument) {
+  (void)argument;
+  while (!stop) {
+    if (zerocopy) {
+      osBuffer_t *buf = osBufferAlloc(pool, osWaitForever);
+      fanout_copy(osBufferData(buf));
+      buf->length = FANOUT_FRAME;
+      for (uint32_t i = 0u; i < FANOUT_CONSUMERS; ++i) {
+        (void)osBufferPut(mq[i], buf, 0u, osWaitForever);
+      }
+      (void)osBufferRelease(buf);
+    } else {
+      for (uint32_t i = 0u; i < FANOUT_CONSUMERS; ++i) {
+        void *copy = osMemoryPoolAlloc(pool, osWaitForever);
+        fanout_copy(copy);
+        (void)osMessageQueuePut(mq[i], &copy, 0u, osWaitForever);
+      }
+    }
+    frames++;
+    BENCH_WORK(FANOUT_LOOP_CYCLES);
+  }
+  for (;;) {
+    (void)osThreadSuspend(osThreadGetId());
+  }
+}
+
+static void consumer_thread(void *argument) {
+  osMessageQueueId_t queue = mq[(uint32_t)(uintptr_t)argument];
+  for (;;) {
+    if (zerocopy) {
+      osBuffer_t *buf = osBufferGet(queue, osWaitForever);
+      (void)osBufferRelease(buf);
+    } else {
+      void *copy = NULL;
+      (void)osMessageQueueGet(queue, &copy, NULL, osWaitForever);
+      (void)osMemoryPoolFree(pool, copy);
+    }
+    BENCH_WORK(FANOUT_LOOP_CYCLES);
+  }
+}
+
+/* ==== Runner ==== */
+
+static osThreadId_t fanout_spawn(BENCH_CB(thread) *cb, bench_stk_t *stack, uint32_t stack_size,
+                                 osThreadFunc_t func, void *argument, osPriority_t priority) {
+  const osThreadAttr_t attr = {
+    .name       = "fanout.worker",
+    .cb_mem     = cb,
+    .cb_size    = sizeof(*cb),
+    .stack_mem  = stack,
+    .stack_size = stack_size,
+    .priority   = priority,
+  };
+  return osThreadNew(func, argument, &attr);
+}
+
+/* Consumers outrank the producer, so each put hands the frame over at once.
+ * The producer finishes its frame and parks, and the consumers drain their
+ * queues, which puts every block back in the pool before the next run. */
+static void fanout_run(const char *name, bool use_buffers) {
+  osThreadId_t consumers[FANOUT_CONSUMERS];
+
+  zerocopy = use_buffers;
+  stop = false;
+  frames = 0u;
+  (void)osKernelLock();
+  for (uint32_t i = 0u; i < FANOUT_CONSUMERS; ++i) {
+    consumers[i] = fanout_spawn(&consumer_cb[i], consumer_stack[i], sizeof(consumer_stack[i]),
+                                consumer_thread, (void *)(uintptr_t)i, osPriorityAboveNormal);
+  }
+  osThreadId_t producer = fanout_spawn(&producer_cb, producer_stack, sizeof(producer_stack),
+                                       producer_thread, NULL, osPriorityNormal);
+  (void)osKernelUnlock();
+
+  (void)osDelay(BENCH_FANOUT_TICKS);
+  uint32_t sent = frames;
+  stop = true;
+  (void)osDelay(1u);
+  (void)osThreadTerminate(producer);
+  for (uint32_t i = 0u; i < FANOUT_CONSUMERS; ++i) {
+    (void)osThreadTerminate(consumers[i]);
+  }
+  bench_json_rate(name, sent, BENCH_FANOUT_TICKS);
+}
+
+static void runner_thread(void *argument) {
+  (void)argument;
+
+  bench_json_begin("fanout");
+  fanout_run("fanout.copy", false);
+  fanout_run("fanout.zerocopy", true);
+  BENCH_EXIT(bench_json_end());
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  for (uint32_t i = 0u; i < FANOUT_CONSUMERS; ++i) {
+    const osMessageQueueAttr_t mq_attr = {
+      .name    = "fanout.mq",
+      .cb_mem  = mq_cb[i],
+      .cb_size = sizeof(mq_cb[i]),
+      .mq_mem  = mq_storage[i],
+      .mq_size = sizeof(mq_storage[i]),
+    };
+    mq[i] = osMessageQueueNew(FANOUT_DEPTH, sizeof(void *), &mq_attr);
+  }
+
+  const osMemoryPoolAttr_t pool_attr = {
+    .name    = "fanout.pool",
+    .cb_mem  = pool_cb,
+    .cb_size = sizeof(pool_cb),
+    .mp_mem  = pool_storage,
+    .mp_size = sizeof(pool_storage),
+  };
+  pool = osMemoryPoolNew(FANOUT_BLOCKS, FANOUT_BLOCK_SIZE, &pool_attr);
+  memset(frame, 0x5A, sizeof(frame));
+
+  const osThreadAttr_t runner_attr = {
+    .name       = "fanout.runner",
+    .cb_mem     = &runner_cb,
+    .cb_size    = sizeof(runner_cb),
+    .stack_mem  = runner_stack,
+    .stack_size = sizeof(runner_stack),
+    .priority   = osPriorityRealtime,
+  };
+  osThreadNew(runner_thread, NULL, &runner_attr);
+
+  osKernelStart();
+  for (;;) {
+  }
+}
+
+#endif
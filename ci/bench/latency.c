@@ -0,0 +1,218 @@
+#include "bench.h"
+
+/*
+ * ISR-to-thread wakeup latency. A one-shot interrupt (bench_irq_schedule)
+ * fires every BENCH_LAT_PERIOD timestamp units plus a pseudo-random jitter;
+ * its handler stamps the ISR entry and signals a waiting thread through a
+ * semaphore, event flags or a message queue, and the thread stamps its
+ * resume point. Each primitive is measured with the CPU otherwise idle and
+ * with a low-priority load thread that keeps the scheduler locked part of
+ * the time. Results are distributions (min/p50/p99/p99.9/max + histogram)
+ * in timestamp units.
+ */
+
+#ifndef BENCH_LAT_SAMPLES
+#define BENCH_LAT_SAMPLES  1000u
+#endif
+
+#ifndef BENCH_LAT_PERIOD
+#define BENCH_LAT_PERIOD   10000u      /* timestamp units between interrupts */
+#endif
+
+#define LAT_LOAD_CYCLES    300u        /* vsim work per load step */
+
+typedef enum {
+  LAT_SEMAPHORE = 0,
+  LAT_FLAGS,
+  LAT_MQ,
+} lat_primitive_t;
+
+static const char *const lat_names[][2] = {
+  [LAT_SEMAPHORE] = { "latency.semaphore.idle", "latency.semaphore.busy" },
+  [LAT_FLAGS]     = { "latency.flags.idle",     "latency.flags.busy" },
+  [LAT_MQ]        = { "latency.mq.idle",        "latency.mq.busy" },
+};
+
+static BENCH_CB(thread) runner_cb;
+static BENCH_CB(thread) handler_cb;
+static BENCH_CB(thread) load_cb;
+BENCH_STACK(runner_stack, 2048u);
+BENCH_STACK(handler_stack, 1024u);
+BENCH_STACK(load_stack, 1024u);
+
+static BENCH_CB(semaphore)   sem_cb;
+static BENCH_CB(semaphore)   done_cb;
+static BENCH_CB(event_flags) flags_cb;
+BENCH_MQ_CB(mq_cb, 4u);
+static void *mq_storage[4];
+
+static osSemaphoreId_t    sem;
+static osSemaphoreId_t    done;
+static osEventFlagsId_t   flags;
+static osMessageQueueId_t mq;
+
+static volatile lat_primitive_t lat_primitive;
+static volatile uint32_t isr_ts;
+static volatile uint32_t expected_ts;
+static uint32_t lat_samples[BENCH_LAT_SAMPLES];
+static uint32_t entry_samples[BENCH_LAT_SAMPLES];
+static uint32_t lat_seed = 1u;
+
+/* ==== Interrupt ==== */
+
+static void lat_isr(void) {
+  isr_ts = BENCH_TS_GET();
+  switch (lat_primitive) {
+    case LAT_SEMAPHORE:
+      (void)osSemaphoreRelease(sem);
+      break;
+    case LAT_FLAGS:
+      (void)osEventFlagsSet(flags, 1u);
+      break;
+    case LAT_MQ: {
+      void *msg = &lat_seed;
+      (void)osMessageQueuePut(mq, &msg, 0u, 0u);
+      break;
+    }
+  }
+}
+
+/* Deterministic jitter in [0, BENCH_LAT_PERIOD / 2) so interrupts do not
+ * phase-lock with the tick or the load thread. */
+static uint32_t lat_next_delay(void) {
+  lat_seed = (lat_seed * 1103515245u) + 12345u;
+  return BENCH_LAT_PERIOD + ((lat_seed >> 8) % (BENCH_LAT_PERIOD / 2u));
+}
+
+static bool lat_arm(void) {
+  uint32_t delay = lat_next_delay();
+  expected_ts = BENCH_TS_GET() + delay;
+  return bench_irq_schedule(delay);
+}
+
+/* ==== Threads ==== */
+
+static void handler_thread(void *argument) {
+  (void)argument;
+  void *msg = NULL;
+
+  for (uint32_t i = 0u; i < BENCH_LAT_SAMPLES; ++i) {
+    (void)lat_arm();
+    switch (lat_primitive) {
+      case LAT_SEMAPHORE:
+        (void)osSemaphoreAcquire(sem, osWaitForever);
+        break;
+      case LAT_FLAGS:
+        (void)osEventFlagsWait(flags, 1u, osFlagsWaitAny, osWaitForever);
+        break;
+      case LAT_MQ:
+        (void)osMessageQueueGet(mq, &msg, NULL, osWaitForever);
+        break;
+    }
+    uint32_t resume = BENCH_TS_GET();
+    lat_samples[i] = resume - isr_ts;
+    entry_samples[i] = isr_ts - expected_ts;
+  }
+  (void)osSemaphoreRelease(done);
+  osThreadExit();
+}
+
+/* Background work with scheduler-locked windows that defer the wakeup. */
+static void load_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    BENCH_WORK(LAT_LOAD_CYCLES);
+    (void)osKernelLock();
+    BENCH_WORK(LAT_LOAD_CYCLES);
+    (void)osKernelUnlock();
+  }
+}
+
+static osThreadId_t lat_spawn(BENCH_CB(thread) *cb, bench_stk_t *stack, uint32_t stack_size,
+                              osThreadFunc_t func, osPriority_t priority) {
+  const osThreadAttr_t attr = {
+    .name       = "lat.worker",
+    .cb_mem     = cb,
+    .cb_size    = sizeof(*cb),
+    .stack_mem  = stack,
+    .stack_size = stack_size,
+    .priority   = priority,
+  };
+  return osThreadNew(func, NULL, &attr);
+}
+
+static void lat_measure(lat_primitive_t primitive, bool busy) {
+  osThreadId_t load = NULL;
+
+  lat_primitive = primitive;
+  if (busy) {
+    load = lat_spawn(&load_cb, load_stack, sizeof(load_stack), load_thread, osPriorityLow);
+  }
+  (void)lat_spawn(&handler_cb, handler_stack, sizeof(handler_stack), handler_thread, osPriorityRealtime);
+  (void)osSemaphoreAcquire(done, osWaitForever);
+  if (load != NULL) {
+    (void)osThreadTerminate(load);
+  }
+
+  bench_json_hist(lat_names[primitive][busy ? 1 : 0], lat_samples, BENCH_LAT_SAMPLES);
+  if (primitive == LAT_SEMAPHORE) {
+    bench_json_hist(busy ? "irq.entry.busy" : "irq.entry.idle", entry_samples, BENCH_LAT_SAMPLES);
+  }
+}
+
+/* ==== Runner ==== */
+
+static void runner_thread(void *argument) {
+  (void)argument;
+
+  bench_json_begin("latency");
+  if (!bench_irq_schedule(BENCH_LAT_PERIOD)) {
+    bench_json_skip("latency", "no schedulable interrupt");
+  } else {
+    (void)osSemaphoreAcquire(sem, osWaitForever);
+    for (uint32_t busy = 0u; busy < 2u; ++busy) {
+      lat_measure(LAT_SEMAPHORE, busy != 0u);
+      lat_measure(LAT_FLAGS, busy != 0u);
+      lat_measure(LAT_MQ, busy != 0u);
+    }
+  }
+  BENCH_EXIT(bench_json_end());
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osSemaphoreAttr_t sem_attr = { .name = "lat.sem", .cb_mem = &sem_cb, .cb_size = sizeof(sem_cb) };
+  sem = osSemaphoreNew(1u, 0u, &sem_attr);
+
+  const osSemaphoreAttr_t done_attr = { .name = "lat.done", .cb_mem = &done_cb, .cb_size = sizeof(done_cb) };
+  done = osSemaphoreNew(1u, 0u, &done_attr);
+
+  const osEventFlagsAttr_t flags_attr = { .name = "lat.flags", .cb_mem = &flags_cb, .cb_size = sizeof(flags_cb) };
+  flags = osEventFlagsNew(&flags_attr);
+
+  const osMessageQueueAttr_t mq_attr = {
+    .name    = "lat.mq",
+    .cb_mem  = mq_cb,
+    .cb_size = sizeof(mq_cb),
+    .mq_mem  = mq_storage,
+    .mq_size = sizeof(mq_storage),
+  };
+  mq = osMessageQueueNew(4u, sizeof(void *), &mq_attr);
+
+  bench_irq_init(lat_isr);
+
+  const osThreadAttr_t runner_attr = {
+    .name       = "lat.runner",
+    .cb_mem     = &runner_cb,
+    .cb_size    = sizeof(runner_cb),
+    .stack_mem  = runner_stack,
+    .stack_size = sizeof(runner_stack),
+    .priority   = osPriorityHigh,
+  };
+  osThreadNew(runner_thread, NULL, &runner_attr);
+
+  osKernelStart();
+  for (;;) {
+  }
+}
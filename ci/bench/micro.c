@@ -0,0 +1,681 @@
+#include <string.h>
+
+#include "bench.h"
+
+#if !defined(BENCH_FREERTOS)
+#include "cmsis_os2_ext.h"
+#endif
+
+/*
+ * Micro-benchmarks for every CMSIS-RTOS2 primitive the wrappers implement.
+ * Each measurement runs BENCH_ROUNDS times; results (timestamp units) are
+ * printed as JSON by bench.c. Helper threads run above the runner so the
+ * runner only resumes once a measurement has finished.
+ */
+
+#define MICRO_MQ_DEPTH       8u
+#define MICRO_MQ_MAX_SIZE    128u
+
+static BENCH_CB(thread) runner_cb;
+static BENCH_CB(thread) helper_cb[2];
+BENCH_STACK(runner_stack, 2048u);
+BENCH_STACK(helper_stack0, 1024u);
+BENCH_STACK(helper_stack1, 1024u);
+
+static BENCH_CB(semaphore) done_sem_cb;
+static BENCH_CB(semaphore) ping_sem_cb;
+static BENCH_CB(semaphore) pong_sem_cb;
+static BENCH_CB(mutex)     mutex_cb;
+static BENCH_CB(event_flags) flags_cb;
+static BENCH_CB(timer)     timer_cb;
+BENCH_MQ_CB(mq_cb, MICRO_MQ_DEPTH);
+static uint64_t mq_storage[(MICRO_MQ_DEPTH * MICRO_MQ_MAX_SIZE) / sizeof(uint64_t)];
+
+static osSemaphoreId_t done_sem;
+static osSemaphoreId_t ping_sem;
+static osSemaphoreId_t pong_sem;
+static osMutexId_t     mutex;
+static osEventFlagsId_t flags;
+static osMessageQueueId_t mq;
+static osTimerId_t     timer;
+
+/* Written by the signalling side, read by the woken thread. */
+static volatile uint32_t wake_start;
+static bench_stat_t stat_a;
+static bench_stat_t stat_b;
+
+/* ==== Helpers ==== */
+
+static osThreadId_t micro_spawn(uint32_t slot, osThreadFunc_t func, void *argument, osPriority_t priority,
+                                uint32_t attr_bits) {
+  const osThreadAttr_t attr = {
+    .name       = (slot == 0u) ? "bench.helper0" : "bench.helper1",
+    .attr_bits  = attr_bits,
+    .cb_mem     = &helper_cb[slot],
+    .cb_size    = sizeof(helper_cb[slot]),
+    .stack_mem  = (slot == 0u) ? helper_stack0 : helper_stack1,
+    .stack_size = (slot == 0u) ? sizeof(helper_stack0) : sizeof(helper_stack1),
+    .priority   = priority,
+  };
+  return osThreadNew(func, argument, &attr);
+}
+
+/* Start two helpers together and wait until both have finished. */
+static void micro_run2(osThreadFunc_t func0, void *arg0, osPriority_t prio0,
+                       osThreadFunc_t func1, void *arg1, osPriority_t prio1) {
+  (void)osKernelLock();
+  (void)micro_spawn(0u, func0, arg0, prio0, 0u);
+  (void)micro_spawn(1u, func1, arg1, prio1, 0u);
+  (void)osKernelUnlock();
+  (void)osSemaphoreAcquire(done_sem, osWaitForever);
+  (void)osSemaphoreAcquire(done_sem, osWaitForever);
+}
+
+static void micro_helper_done(void) {
+  (void)osSemaphoreRelease(done_sem);
+  osThreadExit();
+}
+
+static osSemaphoreId_t micro_sem(BENCH_CB(semaphore) *cb, const char *name, uint32_t max, uint32_t initial) {
+  const osSemaphoreAttr_t attr = { .name = name, .cb_mem = cb, .cb_size = sizeof(*cb) };
+  return osSemaphoreNew(max, initial, &attr);
+}
+
+/* ==== Threads ==== */
+
+static void target_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    (void)osThreadSuspend(osThreadGetId());
+  }
+}
+
+static void micro_thread_create(void) {
+  bench_stat_init(&stat_a, "thread.create");
+  bench_stat_init(&stat_b, "thread.delete");
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    uint32_t start = BENCH_TS_GET();
+    osThreadId_t id = micro_spawn(0u, target_thread, NULL, osPriorityLow, 0u);
+    uint32_t created = BENCH_TS_GET();
+    (void)osThreadTerminate(id);
+    uint32_t deleted = BENCH_TS_GET();
+    bench_stat_add(&stat_a, created - start);
+    bench_stat_add(&stat_b, deleted - created);
+  }
+  bench_json_stat(&stat_a);
+  bench_json_stat(&stat_b);
+}
+
+/* Both helpers share a priority; only helper 0 records. On uC/OS-II every
+ * thread owns a distinct native priority, so the yield does not switch. */
+static void yield_thread(void *argument) {
+  bench_stat_t *stat = (bench_stat_t *)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    uint32_t start = BENCH_TS_GET();
+    (void)osThreadYield();
+    if (stat != NULL) {
+      bench_stat_add(stat, BENCH_TS_GET() - start);
+    }
+  }
+  micro_helper_done();
+}
+
+static void micro_yield(void) {
+  bench_stat_init(&stat_a, "thread.yield");
+  micro_run2(yield_thread, &stat_a, osPriorityAboveNormal, yield_thread, NULL, osPriorityAboveNormal);
+  bench_json_stat(&stat_a);
+}
+
+/* ==== Semaphore ==== */
+
+static void pong_thread(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    (void)osSemaphoreAcquire(pong_sem, osWaitForever);
+    (void)osSemaphoreRelease(ping_sem);
+  }
+  micro_helper_done();
+}
+
+/* One round trip = two context switches and two release/acquire pairs. */
+static void ping_thread(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    uint32_t start = BENCH_TS_GET();
+    (void)osSemaphoreRelease(pong_sem);
+    (void)osSemaphoreAcquire(ping_sem, osWaitForever);
+    bench_stat_add(&stat_a, BENCH_TS_GET() - start);
+  }
+  micro_helper_done();
+}
+
+static void micro_semaphore(void) {
+  bench_stat_init(&stat_a, "semaphore.release_acquire");
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    uint32_t start = BENCH_TS_GET();
+    (void)osSemaphoreRelease(ping_sem);
+    (void)osSemaphoreAcquire(ping_sem, 0u);
+    bench_stat_add(&stat_a, BENCH_TS_GET() - start);
+  }
+  bench_json_stat(&stat_a);
+
+  bench_stat_init(&stat_a, "semaphore.pingpong");
+  micro_run2(ping_thread, NULL, osPriorityAboveNormal, pong_thread, NULL, osPriorityHigh);
+  bench_json_stat(&stat_a);
+}
+
+/* ==== Mutex ==== */
+
+static void mutex_high_thread(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    (void)osSemaphoreAcquire(ping_sem, osWaitForever);
+    uint32_t start = BENCH_TS_GET();
+    (void)osMutexAcquire(mutex, osWaitForever);
+    bench_stat_add(&stat_a, BENCH_TS_GET() - start);
+    (void)osMutexRelease(mutex);
+  }
+  micro_helper_done();
+}
+
+/* Holds the mutex while waking the high thread, then hands it over. */
+static void mutex_low_thread(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    (void)osMutexAcquire(mutex, osWaitForever);
+    (void)osSemaphoreRelease(ping_sem);
+    (void)osMutexRelease(mutex);
+  }
+  micro_helper_done();
+}
+
+static void micro_mutex(void) {
+  bench_stat_init(&stat_a, "mutex.uncontended");
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    uint32_t start = BENCH_TS_GET();
+    (void)osMutexAcquire(mutex, osWaitForever);
+    (void)osMutexRelease(mutex);
+    bench_stat_add(&stat_a, BENCH_TS_GET() - start);
+  }
+  bench_json_stat(&stat_a);
+
+  bench_stat_init(&stat_a, "mutex.contended");
+  micro_run2(mutex_high_thread, NULL, osPriorityHigh, mutex_low_thread, NULL, osPriorityAboveNormal);
+  bench_json_stat(&stat_a);
+}
+
+/* ==== Event Flags ==== */
+
+static void flags_wait_thread(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    (void)osEventFlagsWait(flags, 1u, osFlagsWaitAny, osWaitForever);
+    bench_stat_add(&stat_a, BENCH_TS_GET() - wake_start);
+  }
+  micro_helper_done();
+}
+
+static void flags_set_thread(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    wake_start = BENCH_TS_GET();
+    (void)osEventFlagsSet(flags, 1u);
+  }
+  micro_helper_done();
+}
+
+static void micro_event_flags(void) {
+  bench_stat_init(&stat_a, "flags.set_wait");
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    uint32_t start = BENCH_TS_GET();
+    (void)osEventFlagsSet(flags, 1u);
+    uint32_t result = osEventFlagsWait(flags, 1u, osFlagsWaitAny, 0u);
+    uint32_t delta = BENCH_TS_GET() - start;
+    if ((result & osFlagsError) != 0u) {
+      bench_json_skip("flags.set_wait", "wait failed");
+      break;
+    }
+    bench_stat_add(&stat_a, delta);
+  }
+  if (stat_a.count == BENCH_ROUNDS) {
+    bench_json_stat(&stat_a);
+  }
+  (void)osEventFlagsClear(flags, 1u);
+
+  bench_stat_init(&stat_a, "flags.wakeup");
+  micro_run2(flags_wait_thread, NULL, osPriorityHigh, flags_set_thread, NULL, osPriorityAboveNormal);
+  bench_json_stat(&stat_a);
+}
+
+/* ==== Message Queue ==== */
+
+static void mq_get_thread(void *argument) {
+  (void)argument;
+  uint64_t msg[MICRO_MQ_MAX_SIZE / sizeof(uint64_t)];
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    (void)osMessageQueueGet(mq, msg, NULL, osWaitForever);
+    bench_stat_add(&stat_a, BENCH_TS_GET() - wake_start);
+  }
+  micro_helper_done();
+}
+
+static void mq_put_thread(void *argument) {
+  (void)argument;
+  uint64_t msg[MICRO_MQ_MAX_SIZE / sizeof(uint64_t)];
+  memset(msg, 0x5a, sizeof(msg));
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    wake_start = BENCH_TS_GET();
+    (void)osMessageQueuePut(mq, msg, 0u, osWaitForever);
+  }
+  micro_helper_done();
+}
+
+static void micro_message_queue(uint32_t msg_size) {
+  char put_get[32];
+  char wakeup[32];
+  (void)snprintf(put_get, sizeof(put_get), "mq.put_get.%lu", (unsigned long)msg_size);
+  (void)snprintf(wakeup, sizeof(wakeup), "mq.wakeup.%lu", (unsigned long)msg_size);
+
+  const osMessageQueueAttr_t attr = {
+    .name    = "bench.mq",
+    .cb_mem  = mq_cb,
+    .cb_size = sizeof(mq_cb),
+    .mq_mem  = mq_storage,
+    .mq_size = MICRO_MQ_DEPTH * msg_size,
+  };
+  mq = osMessageQueueNew(MICRO_MQ_DEPTH, msg_size, &attr);
+  if (mq == NULL) {
+    bench_json_skip(put_get, "msg_size not supported");
+    bench_json_skip(wakeup, "msg_size not supported");
+    return;
+  }
+
+  uint64_t msg[MICRO_MQ_MAX_SIZE / sizeof(uint64_t)];
+  memset(msg, 0xa5, sizeof(msg));
+  bench_stat_init(&stat_a, put_get);
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    uint32_t start = BENCH_TS_GET();
+    (void)osMessageQueuePut(mq, msg, 0u, 0u);
+    (void)osMessageQueueGet(mq, msg, NULL, 0u);
+    bench_stat_add(&stat_a, BENCH_TS_GET() - start);
+  }
+  bench_json_stat(&stat_a);
+
+  bench_stat_init(&stat_a, wakeup);
+  micro_run2(mq_get_thread, NULL, osPriorityHigh, mq_put_thread, NULL, osPriorityAboveNormal);
+  bench_json_stat(&stat_a);
+
+  (void)osMessageQueueDelete(mq);
+}
+
+/* ==== Thread Mailbox ==== */
+
+#if !defined(BENCH_FREERTOS)
+static osThreadId_t mailbox_receiver;
+
+static void mailbox_get_thread(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    void *msg = NULL;
+    (void)osThreadMessageGet(&msg, osWaitForever);
+    bench_stat_add(&stat_a, BENCH_TS_GET() - wake_start);
+  }
+  micro_helper_done();
+}
+
+static void mailbox_put_thread(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    wake_start = BENCH_TS_GET();
+    (void)osThreadMessagePut(mailbox_receiver, NULL);
+  }
+  micro_helper_done();
+}
+#endif
+
+/* Same hand-off as mq.wakeup with pointer messages, straight into the
+ * receiver's mailbox (osThreadMessagePut, cmsis_os2_ext.h). */
+static void micro_mailbox(void) {
+#if defined(BENCH_FREERTOS)
+  bench_json_skip("mailbox.wakeup", "cmsis_os2_ext.h not available");
+#else
+  if (osThreadMessagePut(NULL, NULL) == osError) {
+    bench_json_skip("mailbox.wakeup", "thread mailboxes disabled");
+    return;
+  }
+
+  bench_stat_init(&stat_a, "mailbox.wakeup");
+  (void)osKernelLock();
+  mailbox_receiver = micro_spawn(0u, mailbox_get_thread, NULL, osPriorityHigh, osThreadMailbox);
+  (void)micro_spawn(1u, mailbox_put_thread, NULL, osPriorityAboveNormal, 0u);
+  (void)osKernelUnlock();
+  (void)osSemaphoreAcquire(done_sem, osWaitForever);
+  (void)osSemaphoreAcquire(done_sem, osWaitForever);
+  bench_json_stat(&stat_a);
+#endif
+}
+
+/* ==== Coroutines ==== */
+
+#if BENCH_CORO
+static uint64_t coro_sched_cb[(sizeof(BENCH_CB(coro_sched)) + sizeof(uint64_t) - 1u) / sizeof(uint64_t)];
+static BENCH_CB(coro) coro_cb;
+BENCH_STACK(coro_stack, 1024u);
+static uint32_t coro_round;
+
+static uint32_t coro_get(osCoro_t *co, void *argument) {
+  (void)argument;
+  osCoroBegin(co);
+  for (coro_round = 0u; coro_round < BENCH_ROUNDS; ++coro_round) {
+    void *msg = NULL;
+    osCoroAwait(co, mq, osWaitForever);
+    (void)osMessageQueueGet(mq, &msg, NULL, 0u);
+    bench_stat_add(&stat_a, BENCH_TS_GET() - wake_start);
+  }
+  (void)osSemaphoreRelease(done_sem);
+  osCoroEnd(co);
+}
+#endif
+
+/* Same hand-off as mq.wakeup with pointer messages, to a coroutine awaiting
+ * the queue (osCoroAwait, cmsis_os2_ext.h): the scheduler thread wakes, finds
+ * the queue ready and resumes the coroutine, which takes the message. */
+static void micro_coro(void) {
+#if BENCH_CORO
+  const osMessageQueueAttr_t attr = {
+    .name    = "bench.mq",
+    .cb_mem  = mq_cb,
+    .cb_size = sizeof(mq_cb),
+    .mq_mem  = mq_storage,
+    .mq_size = MICRO_MQ_DEPTH * sizeof(void *),
+  };
+  mq = osMessageQueueNew(MICRO_MQ_DEPTH, sizeof(void *), &attr);
+  const osCoroSchedAttr_t sched_attr = {
+    .name       = "bench.coro",
+    .priority   = osPriorityHigh,
+    .cb_mem     = coro_sched_cb,
+    .cb_size    = sizeof(coro_sched_cb),
+    .stack_mem  = coro_stack,
+    .stack_size = sizeof(coro_stack),
+  };
+  osCoroSchedId_t sched = osCoroSchedNew(&sched_attr);
+
+  bench_stat_init(&stat_a, "coro.wakeup");
+  (void)osKernelLock();
+  (void)osCoroNew(sched, coro_get, NULL, &coro_cb, sizeof(coro_cb));
+  (void)micro_spawn(1u, mq_put_thread, NULL, osPriorityAboveNormal, 0u);
+  (void)osKernelUnlock();
+  (void)osSemaphoreAcquire(done_sem, osWaitForever);
+  (void)osSemaphoreAcquire(done_sem, osWaitForever);
+  bench_json_stat(&stat_a);
+  (void)osCoroSchedDelete(sched);
+  (void)osMessageQueueDelete(mq);
+#else
+  bench_json_skip("coro.wakeup", "coroutines disabled");
+#endif
+}
+
+/* ==== Active Objects ==== */
+
+#if BENCH_ACTIVE
+static uint64_t active_cb[(sizeof(BENCH_CB(active)) + sizeof(uint64_t) - 1u) / sizeof(uint64_t)];
+BENCH_STACK(active_stack, 1024u);
+static osEvent_t active_event = osEventStatic(1u);
+static osActiveId_t active;
+static uint32_t active_round;
+
+static void active_handler(osActiveId_t ao_id, const osEvent_t *event, void *argument) {
+  (void)ao_id;
+  (void)event;
+  (void)argument;
+  bench_stat_add(&stat_a, BENCH_TS_GET() - wake_start);
+  if (++active_round == BENCH_ROUNDS) {
+    (void)osSemaphoreRelease(done_sem);
+  }
+}
+
+static void active_post_thread(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    wake_start = BENCH_TS_GET();
+    (void)osActivePost(active, &active_event);
+  }
+  micro_helper_done();
+}
+#endif
+
+/* Same hand-off as mq.wakeup with pointer messages, posted by reference to
+ * an active object (osActivePost, cmsis_os2_ext.h) whose thread runs the
+ * handler. */
+static void micro_active(void) {
+#if BENCH_ACTIVE
+  const osActiveAttr_t attr = {
+    .name       = "bench.active",
+    .priority   = osPriorityHigh,
+    .cb_mem     = active_cb,
+    .cb_size    = sizeof(active_cb),
+    .stack_mem  = active_stack,
+    .stack_size = sizeof(active_stack),
+  };
+  active = osActiveNew(active_handler, NULL, &attr);
+
+  bench_stat_init(&stat_a, "active.wakeup");
+  active_round = 0u;
+  (void)micro_spawn(1u, active_post_thread, NULL, osPriorityAboveNormal, 0u);
+  (void)osSemaphoreAcquire(done_sem, osWaitForever);
+  (void)osSemaphoreAcquire(done_sem, osWaitForever);
+  bench_json_stat(&stat_a);
+  (void)osActiveDelete(active);
+#else
+  bench_json_skip("active.wakeup", "active objects disabled");
+#endif
+}
+
+/* ==== Interrupt Hand-off ==== */
+
+/* An ISR passes a pointer to thread context: through a message queue to a
+ * blocked receiver, or as a work item (osWorkSubmit, cmsis_os2_ext.h) run by
+ * a work queue worker. Both receivers outrank the runner, and each round is
+ * timed from the ISR to the receiving code. */
+static void (*micro_isr_fn)(void);
+
+static void micro_isr(void) {
+  if (micro_isr_fn != NULL) {
+    micro_isr_fn();
+  }
+}
+
+static void isr_mq_put(void) {
+  void *msg = NULL;
+  wake_start = BENCH_TS_GET();
+  (void)osMessageQueuePut(mq, &msg, 0u, 0u);
+}
+
+static void isr_mq_get_thread(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    void *msg = NULL;
+    (void)osMessageQueueGet(mq, &msg, NULL, osWaitForever);
+    bench_stat_add(&stat_a, BENCH_TS_GET() - wake_start);
+    (void)osSemaphoreRelease(ping_sem);
+  }
+  micro_helper_done();
+}
+
+#if BENCH_WORKQ
+static uint64_t workq_cb[(sizeof(BENCH_CB(work_queue)) + sizeof(uint64_t) - 1u) / sizeof(uint64_t)];
+BENCH_STACK(workq_stack, 1024u);
+static osWorkQueueId_t workq;
+static osWork_t work_item;
+
+static void isr_work_submit(void) {
+  wake_start = BENCH_TS_GET();
+  (void)osWorkSubmit(workq, &work_item);
+}
+
+static void work_func(void *argument) {
+  (void)argument;
+  bench_stat_add(&stat_a, BENCH_TS_GET() - wake_start);
+  (void)osSemaphoreRelease(ping_sem);
+}
+#endif
+
+static void micro_isr_rounds(void (*isr)(void)) {
+  micro_isr_fn = isr;
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    (void)bench_irq_trigger();
+    (void)osSemaphoreAcquire(ping_sem, osWaitForever);
+  }
+  micro_isr_fn = NULL;
+}
+
+static void micro_isr_handoff(void) {
+  micro_isr_fn = NULL;
+  if (!bench_irq_trigger()) {
+    bench_json_skip("isr.mq.wakeup", "no software interrupt");
+    bench_json_skip("isr.work.wakeup", "no software interrupt");
+    return;
+  }
+
+  const osMessageQueueAttr_t attr = {
+    .name    = "bench.mq",
+    .cb_mem  = mq_cb,
+    .cb_size = sizeof(mq_cb),
+    .mq_mem  = mq_storage,
+    .mq_size = MICRO_MQ_DEPTH * sizeof(void *),
+  };
+  mq = osMessageQueueNew(MICRO_MQ_DEPTH, sizeof(void *), &attr);
+  bench_stat_init(&stat_a, "isr.mq.wakeup");
+  (void)micro_spawn(0u, isr_mq_get_thread, NULL, osPriorityHigh, 0u);
+  micro_isr_rounds(isr_mq_put);
+  (void)osSemaphoreAcquire(done_sem, osWaitForever);
+  bench_json_stat(&stat_a);
+  (void)osMessageQueueDelete(mq);
+
+#if BENCH_WORKQ
+  const osWorkQueueAttr_t wq_attr = {
+    .name       = "bench.workq",
+    .priority   = osPriorityHigh,
+    .workers    = 1u,
+    .cb_mem     = workq_cb,
+    .cb_size    = sizeof(workq_cb),
+    .stack_mem  = workq_stack,
+    .stack_size = sizeof(workq_stack),
+  };
+  workq = osWorkQueueNew(&wq_attr);
+  (void)osWorkInit(&work_item, work_func, NULL);
+  bench_stat_init(&stat_a, "isr.work.wakeup");
+  micro_isr_rounds(isr_work_submit);
+  bench_json_stat(&stat_a);
+  (void)osWorkQueueDelete(workq);
+#else
+  bench_json_skip("isr.work.wakeup", "work queues disabled");
+#endif
+}
+
+/* ==== Timer ==== */
+
+static uint32_t timer_last;
+static uint32_t timer_fired;
+
+/* Records the interval between expiries; stops after BENCH_ROUNDS intervals. */
+static void timer_callback(void *argument) {
+  (void)argument;
+  uint32_t now = BENCH_TS_GET();
+  if (timer_fired > 0u) {
+    uint32_t interval = now - timer_last;
+    bench_stat_add(&stat_a, interval);
+    if (BENCH_TS_HZ != 0u) {
+      uint32_t expected = BENCH_TS_HZ / osKernelGetTickFreq();
+      bench_stat_add(&stat_b, (interval > expected) ? (interval - expected) : (expected - interval));
+    }
+  }
+  timer_last = now;
+  if (timer_fired++ == BENCH_ROUNDS) {
+    (void)osSemaphoreRelease(done_sem);
+  }
+}
+
+static void micro_timer(void) {
+  bench_stat_init(&stat_a, "timer.start");
+  bench_stat_init(&stat_b, "timer.stop");
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    uint32_t start = BENCH_TS_GET();
+    (void)osTimerStart(timer, 100u);
+    uint32_t started = BENCH_TS_GET();
+    (void)osTimerStop(timer);
+    uint32_t stopped = BENCH_TS_GET();
+    bench_stat_add(&stat_a, started - start);
+    bench_stat_add(&stat_b, stopped - started);
+  }
+  bench_json_stat(&stat_a);
+  bench_json_stat(&stat_b);
+
+  /* Periodic 1-tick timer: interval between expiries and deviation from one tick. */
+  bench_stat_init(&stat_a, "timer.period");
+  bench_stat_init(&stat_b, "timer.jitter");
+  timer_fired = 0u;
+  (void)osTimerStart(timer, 1u);
+  (void)osSemaphoreAcquire(done_sem, osWaitForever);
+  (void)osTimerStop(timer);
+  bench_json_stat(&stat_a);
+  if (BENCH_TS_HZ != 0u) {
+    bench_json_stat(&stat_b);
+  } else {
+    bench_json_skip("timer.jitter", "BENCH_TS_HZ unknown");
+  }
+}
+
+/* ==== Runner ==== */
+
+static void runner_thread(void *argument) {
+  (void)argument;
+
+  bench_json_begin("micro");
+  micro_thread_create();
+  micro_yield();
+  micro_semaphore();
+  micro_mutex();
+  micro_event_flags();
+  micro_message_queue(sizeof(void *));
+  micro_message_queue(32u);
+  micro_message_queue(MICRO_MQ_MAX_SIZE);
+  micro_mailbox();
+  micro_coro();
+  micro_active();
+  micro_isr_handoff();
+  micro_timer();
+  BENCH_EXIT(bench_json_end());
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  done_sem = micro_sem(&done_sem_cb, "bench.done", 2u, 0u);
+  ping_sem = micro_sem(&ping_sem_cb, "bench.ping", 1u, 0u);
+  pong_sem = micro_sem(&pong_sem_cb, "bench.pong", 1u, 0u);
+
+  const osMutexAttr_t mutex_attr = { .name = "bench.mutex", .cb_mem = &mutex_cb, .cb_size = sizeof(mutex_cb) };
+  mutex = osMutexNew(&mutex_attr);
+
+  const osEventFlagsAttr_t flags_attr = { .name = "bench.flags", .cb_mem = &flags_cb, .cb_size = sizeof(flags_cb) };
+  flags = osEventFlagsNew(&flags_attr);
+
+  const osTimerAttr_t timer_attr = { .name = "bench.timer", .cb_mem = &timer_cb, .cb_size = sizeof(timer_cb) };
+  timer = osTimerNew(timer_callback, osTimerPeriodic, NULL, &timer_attr);
+
+  const osThreadAttr_t runner_attr = {
+    .name       = "bench.runner",
+    .cb_mem     = &runner_cb,
+    .cb_size    = sizeof(runner_cb),
+    .stack_mem  = runner_stack,
+    .stack_size = sizeof(runner_stack),
+    .priority   = osPriorityNormal,
+  };
+  osThreadNew(runner_thread, NULL, &runner_attr);
+  bench_irq_init(micro_isr);
+
+  osKernelStart();
+  for (;;) {
+  }
+}
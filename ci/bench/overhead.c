@@ -0,0 +1,302 @@
+#include "bench.h"
+
+/*
+ * Wrapper overhead: every CMSIS-RTOS2 operation is paired with its closest
+ * native uC/OS call sequence and both run back to back in the same round,
+ * on objects in the same state. Each result reports the minimum of both
+ * sides and their difference (plus retired instructions when
+ * BENCH_INSTR_GET() is available).
+ *
+ * Define BENCH_OVERHEAD_BUDGET to a header providing OVERHEAD_BUDGET_<OP>
+ * limits (timestamp units) and/or OVERHEAD_INSTR_BUDGET_<OP> limits (retired
+ * instructions, checked only while BENCH_INSTR_OK()); a pair whose delta
+ * exceeds either limit marks the run as failed.
+ */
+
+#if !defined(BENCH_UCOS2) && !defined(BENCH_UCOS3)
+#error "The overhead suite compares against native uC/OS-II / uC/OS-III calls."
+#endif
+
+#ifdef BENCH_OVERHEAD_BUDGET
+#include BENCH_OVERHEAD_BUDGET
+#endif
+
+#ifndef OVERHEAD_BUDGET_SEMAPHORE
+#define OVERHEAD_BUDGET_SEMAPHORE     BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_BUDGET_MUTEX
+#define OVERHEAD_BUDGET_MUTEX         BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_BUDGET_FLAGS
+#define OVERHEAD_BUDGET_FLAGS         BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_BUDGET_MQ
+#define OVERHEAD_BUDGET_MQ            BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_BUDGET_TICK
+#define OVERHEAD_BUDGET_TICK          BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_BUDGET_THREAD_ID
+#define OVERHEAD_BUDGET_THREAD_ID     BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_INSTR_BUDGET_SEMAPHORE
+#define OVERHEAD_INSTR_BUDGET_SEMAPHORE   BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_INSTR_BUDGET_MUTEX
+#define OVERHEAD_INSTR_BUDGET_MUTEX       BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_INSTR_BUDGET_FLAGS
+#define OVERHEAD_INSTR_BUDGET_FLAGS       BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_INSTR_BUDGET_MQ
+#define OVERHEAD_INSTR_BUDGET_MQ          BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_INSTR_BUDGET_TICK
+#define OVERHEAD_INSTR_BUDGET_TICK        BENCH_NO_BUDGET
+#endif
+#ifndef OVERHEAD_INSTR_BUDGET_THREAD_ID
+#define OVERHEAD_INSTR_BUDGET_THREAD_ID   BENCH_NO_BUDGET
+#endif
+
+#define OVERHEAD_MQ_DEPTH  8u
+
+static BENCH_CB(thread) runner_cb;
+BENCH_STACK(runner_stack, 2048u);
+
+static BENCH_CB(semaphore)   sem_cb;
+static BENCH_CB(mutex)       mutex_cb;
+static BENCH_CB(event_flags) flags_cb;
+BENCH_MQ_CB(mq_cb, OVERHEAD_MQ_DEPTH);
+static void *mq_storage[OVERHEAD_MQ_DEPTH];
+
+static osSemaphoreId_t    sem;
+static osMutexId_t        mutex;
+static osEventFlagsId_t   flags;
+static osMessageQueueId_t mq;
+
+/* Keeps results observable so the compiler cannot drop the calls. */
+static volatile uintptr_t sink;
+static uint32_t message;
+
+#if defined(BENCH_UCOS3)
+static OS_SEM      native_sem;
+static OS_MUTEX    native_mutex;
+static OS_FLAG_GRP native_flags;
+static OS_Q        native_q;
+#else
+static OS_EVENT    *native_sem;
+static OS_EVENT    *native_mutex;
+static OS_FLAG_GRP *native_flags;
+static OS_EVENT    *native_q;
+static void        *native_q_storage[OVERHEAD_MQ_DEPTH];
+#endif
+
+/* ==== Operations ==== */
+
+static void cmsis_semaphore(void) {
+  (void)osSemaphoreRelease(sem);
+  (void)osSemaphoreAcquire(sem, 0u);
+}
+
+static void native_semaphore(void) {
+#if defined(BENCH_UCOS3)
+  OS_ERR err;
+  (void)OSSemPost(&native_sem, OS_OPT_POST_1, &err);
+  (void)OSSemPend(&native_sem, 0u, OS_OPT_PEND_NON_BLOCKING, NULL, &err);
+#else
+  (void)OSSemPost(native_sem);
+  (void)OSSemAccept(native_sem);
+#endif
+}
+
+static void cmsis_mutex(void) {
+  (void)osMutexAcquire(mutex, osWaitForever);
+  (void)osMutexRelease(mutex);
+}
+
+static void native_mutex_op(void) {
+#if defined(BENCH_UCOS3)
+  OS_ERR err;
+  OSMutexPend(&native_mutex, 0u, OS_OPT_PEND_BLOCKING, NULL, &err);
+  OSMutexPost(&native_mutex, OS_OPT_POST_NONE, &err);
+#else
+  INT8U err;
+  OSMutexPend(native_mutex, 0u, &err);
+  (void)OSMutexPost(native_mutex);
+#endif
+}
+
+static void cmsis_flags(void) {
+  (void)osEventFlagsSet(flags, 1u);
+  sink = osEventFlagsWait(flags, 1u, osFlagsWaitAny, 0u);
+}
+
+static void native_flags_op(void) {
+#if defined(BENCH_UCOS3)
+  OS_ERR err;
+  (void)OSFlagPost(&native_flags, 1u, OS_OPT_POST_FLAG_SET, &err);
+  sink = OSFlagPend(&native_flags, 1u, 0u,
+                    OS_OPT_PEND_FLAG_SET_ANY | OS_OPT_PEND_FLAG_CONSUME | OS_OPT_PEND_NON_BLOCKING, NULL, &err);
+#else
+  INT8U err;
+  (void)OSFlagPost(native_flags, 1u, OS_FLAG_SET, &err);
+  sink = OSFlagAccept(native_flags, 1u, OS_FLAG_WAIT_SET_ANY | OS_FLAG_CONSUME, &err);
+#endif
+}
+
+static void cmsis_mq(void) {
+  void *msg = &message;
+  void *out = NULL;
+  (void)osMessageQueuePut(mq, &msg, 0u, 0u);
+  (void)osMessageQueueGet(mq, &out, NULL, 0u);
+  sink = (uintptr_t)out;
+}
+
+static void native_mq(void) {
+#if defined(BENCH_UCOS3)
+  OS_ERR err;
+  OS_MSG_SIZE size;
+  OSQPost(&native_q, &message, sizeof(void *), OS_OPT_POST_FIFO, &err);
+  sink = (uintptr_t)OSQPend(&native_q, 0u, OS_OPT_PEND_NON_BLOCKING, &size, NULL, &err);
+#else
+  INT8U err;
+  (void)OSQPost(native_q, &message);
+  sink = (uintptr_t)OSQAccept(native_q, &err);
+#endif
+}
+
+static void cmsis_tick(void) {
+  sink = osKernelGetTickCount();
+}
+
+static void native_tick(void) {
+#if defined(BENCH_UCOS3)
+  OS_ERR err;
+  sink = OSTimeGet(&err);
+#else
+  sink = OSTimeGet();
+#endif
+}
+
+static void cmsis_thread_id(void) {
+  sink = (uintptr_t)osThreadGetId();
+}
+
+static void native_thread_id(void) {
+#if defined(BENCH_UCOS3)
+  sink = (uintptr_t)OSTCBCurPtr;
+#else
+  sink = (uintptr_t)OSTCBCur;
+#endif
+}
+
+/* ==== Runner ==== */
+
+typedef struct overhead_pair {
+  const char *name;
+  void      (*op[2])(void);     /* [0] CMSIS, [1] native */
+  uint32_t    budget;
+  uint32_t    instr_budget;
+} overhead_pair_t;
+
+static const overhead_pair_t overhead_pairs[] = {
+  { "semaphore.release_acquire", { cmsis_semaphore, native_semaphore },
+    OVERHEAD_BUDGET_SEMAPHORE, OVERHEAD_INSTR_BUDGET_SEMAPHORE },
+  { "mutex.acquire_release",     { cmsis_mutex,     native_mutex_op  },
+    OVERHEAD_BUDGET_MUTEX,     OVERHEAD_INSTR_BUDGET_MUTEX },
+  { "flags.set_wait",            { cmsis_flags,     native_flags_op  },
+    OVERHEAD_BUDGET_FLAGS,     OVERHEAD_INSTR_BUDGET_FLAGS },
+  { "mq.put_get",                { cmsis_mq,        native_mq        },
+    OVERHEAD_BUDGET_MQ,        OVERHEAD_INSTR_BUDGET_MQ },
+  { "kernel.tick_count",         { cmsis_tick,      native_tick      },
+    OVERHEAD_BUDGET_TICK,      OVERHEAD_INSTR_BUDGET_TICK },
+  { "thread.get_id",             { cmsis_thread_id, native_thread_id },
+    OVERHEAD_BUDGET_THREAD_ID, OVERHEAD_INSTR_BUDGET_THREAD_ID },
+};
+
+static void overhead_measure(const overhead_pair_t *pair) {
+  bench_stat_t ts[2];
+  bench_stat_t instr[2];
+
+  for (uint32_t side = 0u; side < 2u; ++side) {
+    bench_stat_init(&ts[side], pair->name);
+    bench_stat_init(&instr[side], pair->name);
+    pair->op[side]();           /* warm up */
+  }
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    for (uint32_t side = 0u; side < 2u; ++side) {
+      uint32_t instr_start = BENCH_INSTR_GET();
+      uint32_t start = BENCH_TS_GET();
+      pair->op[side]();
+      uint32_t end = BENCH_TS_GET();
+      uint32_t instr_end = BENCH_INSTR_GET();
+      bench_stat_add(&ts[side], end - start);
+      bench_stat_add(&instr[side], instr_end - instr_start);
+    }
+  }
+  bench_json_pair(pair->name, ts, BENCH_INSTR_OK() ? instr : NULL, pair->budget, pair->instr_budget);
+}
+
+static void runner_thread(void *argument) {
+  (void)argument;
+
+  bench_json_begin("overhead");
+  for (uint32_t i = 0u; i < (sizeof(overhead_pairs) / sizeof(overhead_pairs[0])); ++i) {
+    overhead_measure(&overhead_pairs[i]);
+  }
+  BENCH_EXIT(bench_json_end());
+}
+
+static void overhead_native_init(void) {
+#if defined(BENCH_UCOS3)
+  OS_ERR err;
+  OSSemCreate(&native_sem, (CPU_CHAR *)"native.sem", 0u, &err);
+  OSMutexCreate(&native_mutex, (CPU_CHAR *)"native.mutex", &err);
+  OSFlagCreate(&native_flags, (CPU_CHAR *)"native.flags", 0u, &err);
+  OSQCreate(&native_q, (CPU_CHAR *)"native.q", OVERHEAD_MQ_DEPTH, &err);
+#else
+  INT8U err;
+  native_sem = OSSemCreate(0u);
+  native_mutex = OSMutexCreate(OS_PRIO_MUTEX_CEIL_DIS, &err);
+  native_flags = OSFlagCreate(0u, &err);
+  native_q = OSQCreate(native_q_storage, OVERHEAD_MQ_DEPTH);
+#endif
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osSemaphoreAttr_t sem_attr = { .name = "bench.sem", .cb_mem = &sem_cb, .cb_size = sizeof(sem_cb) };
+  sem = osSemaphoreNew(1u, 0u, &sem_attr);
+
+  const osMutexAttr_t mutex_attr = { .name = "bench.mutex", .cb_mem = &mutex_cb, .cb_size = sizeof(mutex_cb) };
+  mutex = osMutexNew(&mutex_attr);
+
+  const osEventFlagsAttr_t flags_attr = { .name = "bench.flags", .cb_mem = &flags_cb, .cb_size = sizeof(flags_cb) };
+  flags = osEventFlagsNew(&flags_attr);
+
+  const osMessageQueueAttr_t mq_attr = {
+    .name    = "bench.mq",
+    .cb_mem  = mq_cb,
+    .cb_size = sizeof(mq_cb),
+    .mq_mem  = mq_storage,
+    .mq_size = sizeof(mq_storage),
+  };
+  mq = osMessageQueueNew(OVERHEAD_MQ_DEPTH, sizeof(void *), &mq_attr);
+
+  overhead_native_init();
+
+  const osThreadAttr_t runner_attr = {
+    .name       = "bench.runner",
+    .cb_mem     = &runner_cb,
+    .cb_size    = sizeof(runner_cb),
+    .stack_mem  = runner_stack,
+    .stack_size = sizeof(runner_stack),
+    .priority   = osPriorityNormal,
+  };
+  osThreadNew(runner_thread, NULL, &runner_attr);
+
+  osKernelStart();
+  for (;;) {
+  }
+}
@@ -0,0 +1,19 @@
+#ifndef OVERHEAD_BUDGET_HOST_H_
+#define OVERHEAD_BUDGET_HOST_H_
+
+/*
+ * Overhead budget for ci/host-port (retired instructions, x86-64 at -O1).
+ * Host timestamps follow the host scheduler, so only the instruction delta
+ * is checked, and only when perf_event is available (bench_perf_ok()). The
+ * wrapper itself costs well under 100 instructions per pair; the message
+ * queue also pends and posts its space semaphore.
+ */
+
+#define OVERHEAD_INSTR_BUDGET_SEMAPHORE   120u
+#define OVERHEAD_INSTR_BUDGET_MUTEX       120u
+#define OVERHEAD_INSTR_BUDGET_FLAGS       160u
+#define OVERHEAD_INSTR_BUDGET_MQ          800u    /* space_sem pend + post */
+#define OVERHEAD_INSTR_BUDGET_TICK        16u
+#define OVERHEAD_INSTR_BUDGET_THREAD_ID   40u
+
+#endif /* OVERHEAD_BUDGET_HOST_H_ */
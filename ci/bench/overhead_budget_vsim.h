@@ -0,0 +1,17 @@
+#ifndef OVERHEAD_BUDGET_VSIM_H_
+#define OVERHEAD_BUDGET_VSIM_H_
+
+/*
+ * Overhead budget for ci/vsim (virtual cycles). The simulator charges per
+ * kernel service, so these limits count the extra uC/OS calls a wrapper
+ * makes: one service is 120 cycles.
+ */
+
+#define OVERHEAD_BUDGET_SEMAPHORE     0u
+#define OVERHEAD_BUDGET_MUTEX         0u
+#define OVERHEAD_BUDGET_FLAGS         0u
+#define OVERHEAD_BUDGET_MQ            240u    /* space_sem pend + post */
+#define OVERHEAD_BUDGET_TICK          0u
+#define OVERHEAD_BUDGET_THREAD_ID     0u
+
+#endif /* OVERHEAD_BUDGET_VSIM_H_ */
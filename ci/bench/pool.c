@@ -0,0 +1,156 @@
+#include "bench.h"
+
+/*
+ * Thread pool (osPool*, cmsis_os2_ext.h). Each job does POOL_JOB_CYCLES of
+ * work and then blocks for POOL_IO_TICKS, standing in for a driver
+ * transfer; one CPU cannot run compute faster on more threads, so the
+ * speedup of a pool comes from overlapping those waits. Every result is
+ * POOL_JOBS jobs per second:
+ *   pool.serial    the runner calls each job itself
+ *   pool.parallel  the runner submits the jobs and waits with osPoolWaitAll
+ *   pool.steal     one job submits the others from a worker, so they all land
+ *                  on that worker's deque and the idle workers steal them
+ * pool.dispatch is the cost per job of submit, hand-over and completion for
+ * empty jobs, a batch of POOL_BATCH at a time.
+ */
+
+#define POOL_JOBS         64u
+#define POOL_JOB_CYCLES   20000u      /* 0.2 tick on vsim */
+#define POOL_IO_TICKS     1u
+#define POOL_BATCH        16u
+
+#if defined(BENCH_FREERTOS) || !BENCH_POOL
+
+int main(void) {
+  osKernelInitialize();
+  bench_json_begin("pool");
+#if defined(BENCH_FREERTOS)
+  static const char reason[] = "cmsis_os2_ext.h not available";
+#else
+  static const char reason[] = "thread pool disabled";
+#endif
+  bench_json_skip("pool.serial", reason);
+  bench_json_skip("pool.parallel", reason);
+  bench_json_skip("pool.steal", reason);
+  bench_json_skip("pool.dispatch", reason);
+  BENCH_EXIT(bench_json_end());
+  return 0;
+}
+
+#else
+
+#include "cmsis_os2_ext.h"
+
+static BENCH_CB(thread) runner_cb;
+BENCH_STACK(runner_stack, 2048u);
+
+static uint64_t pool_cb[(sizeof(BENCH_CB(pool)) + sizeof(uint64_t) - 1u) / sizeof(uint64_t)];
+BENCH_STACK(pool_stack, 4096u);
+static osPoolId_t pool;
+
+/* ==== Jobs ==== */
+
+static void io_job(void *argument) {
+  (void)argument;
+  BENCH_WORK(POOL_JOB_CYCLES);
+  (void)osDelay(POOL_IO_TICKS);
+}
+
+static void fork_job(void *argument) {
+  (void)argument;
+  for (uint32_t i = 0u; i < POOL_JOBS; ++i) {
+    (void)osPoolSubmit(pool, io_job, NULL);
+  }
+}
+
+static void empty_job(void *argument) {
+  (void)argument;
+}
+
+/* ==== Runner ==== */
+
+static void pool_serial(void) {
+  (void)osDelay(1u);
+  uint32_t start = osKernelGetTickCount();
+  for (uint32_t i = 0u; i < POOL_JOBS; ++i) {
+    io_job(NULL);
+  }
+  bench_json_rate("pool.serial", POOL_JOBS, osKernelGetTickCount() - start);
+}
+
+static void pool_parallel(void) {
+  (void)osDelay(1u);
+  uint32_t start = osKernelGetTickCount();
+  for (uint32_t i = 0u; i < POOL_JOBS; ++i) {
+    (void)osPoolSubmit(pool, io_job, NULL);
+  }
+  (void)osPoolWaitAll(pool, osWaitForever);
+  bench_json_rate("pool.parallel", POOL_JOBS, osKernelGetTickCount() - start);
+}
+
+/* fork_job itself is not counted. */
+static void pool_steal(void) {
+  (void)osDelay(1u);
+  uint32_t start = osKernelGetTickCount();
+  (void)osPoolSubmit(pool, fork_job, NULL);
+  (void)osPoolWaitAll(pool, osWaitForever);
+  bench_json_rate("pool.steal", POOL_JOBS, osKernelGetTickCount() - start);
+}
+
+static void pool_dispatch(void) {
+  bench_stat_t stat;
+
+  bench_stat_init(&stat, "pool.dispatch");
+  for (uint32_t i = 0u; i < BENCH_ROUNDS; ++i) {
+    uint32_t start = BENCH_TS_GET();
+    for (uint32_t j = 0u; j < POOL_BATCH; ++j) {
+      (void)osPoolSubmit(pool, empty_job, NULL);
+    }
+    (void)osPoolWaitAll(pool, osWaitForever);
+    bench_stat_add(&stat, (BENCH_TS_GET() - start) / POOL_BATCH);
+  }
+  bench_json_stat(&stat);
+}
+
+static void runner_thread(void *argument) {
+  (void)argument;
+
+  bench_json_begin("pool");
+  pool_serial();
+  pool_parallel();
+  pool_steal();
+  pool_dispatch();
+  BENCH_EXIT(bench_json_end());
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  /* The runner outranks the workers, so it queues a whole batch before the
+   * first job starts. */
+  const osPoolAttr_t pool_attr = {
+    .name       = "bench.pool",
+    .priority   = osPriorityNormal,
+    .cb_mem     = pool_cb,
+    .cb_size    = sizeof(pool_cb),
+    .stack_mem  = pool_stack,
+    .stack_size = sizeof(pool_stack),
+  };
+  pool = osPoolNew(&pool_attr);
+
+  const osThreadAttr_t runner_attr = {
+    .name       = "pool.runner",
+    .cb_mem     = &runner_cb,
+    .cb_size    = sizeof(runner_cb),
+    .stack_mem  = runner_stack,
+    .stack_size = sizeof(runner_stack),
+    .priority   = osPriorityRealtime,
+  };
+  osThreadNew(runner_thread, NULL, &runner_attr);
+
+  osKernelStart();
+  for (;;) {
+  }
+}
+
+#endif
@@ -0,0 +1,135 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run a ci/bench suite for both ports and collect its JSON output.
+#
+#   ci/bench/run.sh [--host] [suite]        (suite defaults to micro)
+#
+# By default the suite runs on the virtual-time simulator (ci/vsim): results
+# are deterministic cycle counts from its cost model. --host runs the real
+# kernels on the POSIX host port instead (nanosecond timestamps; needs the
+# libs/uC-OS2 and libs/uC-OS3 submodules).
+#
+# Results are written to _bench_build/<suite>-<kernel>.json, with a
+# comparison table in _bench_build/<suite>.md. The overhead suite is
+# checked against overhead_budget_vsim.h on vsim (cycles) and against
+# overhead_budget_host.h on the host (instructions, when perf_event is
+# available); a result over budget fails the run.
+#
+# When the libs/CMSIS-FreeRTOS submodule is checked out, bench.c and tm.c are
+# also parsed with -DBENCH_FREERTOS against its headers (-fsyntax-only; that
+# port only runs on a board), so the FreeRTOS paths cannot rot unnoticed.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+BENCH_DIR="$ROOT_DIR/ci/bench"
+VSIM_DIR="$ROOT_DIR/ci/vsim"
+OUT_DIR=${OUT_DIR:-"$ROOT_DIR/_bench_build"}
+TIMEOUT=${TIMEOUT:-60}
+FREERTOS_DIR=${FREERTOS_DIR:-"$ROOT_DIR/libs/CMSIS-FreeRTOS"}
+
+TARGET=vsim
+if [[ "${1:-}" == "--host" ]]; then
+  TARGET=host
+  shift
+fi
+SUITE=${1:-micro}
+
+if [[ ! -f "$BENCH_DIR/$SUITE.c" ]]; then
+  echo "[bench] unknown suite '$SUITE'" >&2
+  exit 1
+fi
+
+CC=${CC:-gcc}
+CFLAGS=(
+  -std=gnu11 -O1 -g -Wall -Wextra -Werror
+  -D__STATIC_INLINE=static\ inline
+  -include stdlib.h
+  "-DBENCH_EXIT(status)=exit((int)(status))"
+)
+
+mkdir -p "$OUT_DIR"
+
+# 100 MHz virtual clock (VSIM_CYCLES_PER_TICK at 1 kHz).
+build_vsim() {
+  local kernel="$1" ver="$2"
+  "$CC" "${CFLAGS[@]}" -DBENCH_VSIM -DBENCH_UCOS$ver -DBENCH_TS_HZ=100000000u \
+    -DUCOS${ver}_MAILBOX_EN=1u -DUCOS${ver}_WORKQ_EN=1u -DUCOS${ver}_POOL_EN=1u \
+    -DUCOS${ver}_WAIT_ANY_EN=1u -DUCOS${ver}_CORO_EN=1u -DUCOS${ver}_ACTIVE_EN=1u \
+    -DBENCH_OVERHEAD_BUDGET='"overhead_budget_vsim.h"' \
+    -I"$VSIM_DIR/$kernel" \
+    -I"$VSIM_DIR" \
+    -I"$BENCH_DIR" \
+    -I"$ROOT_DIR/ci/compile-check/stubs/$kernel" \
+    -I"$ROOT_DIR/CMSIS/RTOS2/Include" \
+    -I"$ROOT_DIR/CMSIS/RTOS2/uCOS$ver/Include" \
+    "$VSIM_DIR/vsim.c" "$VSIM_DIR/vsim_os$ver.c" \
+    "$ROOT_DIR/CMSIS/RTOS2/uCOS$ver/Source/cmsis_os2_ucos$ver.c" \
+    "$BENCH_DIR/bench.c" "$BENCH_DIR/$SUITE.c" \
+    -o "$OUT_DIR/$SUITE-$kernel"
+  BIN="$OUT_DIR/$SUITE-$kernel"
+}
+
+# Nanosecond timestamps from host_ts_get(), instructions from perf_event.
+build_host() {
+  local kernel="$1" ver="$2"
+  OUT_DIR="$OUT_DIR/host" \
+  APP_NAME="bench-$SUITE" \
+  APP_SRCS="$BENCH_DIR/bench.c $BENCH_DIR/bench_perf_linux.c $BENCH_DIR/$SUITE.c" \
+  APP_CFLAGS="-I$BENCH_DIR -DBENCH_HOST -DBENCH_UCOS$ver -DBENCH_TS_HZ=1000000000u -DBENCH_LAT_PERIOD=200000u -include stdlib.h -DBENCH_EXIT(status)=exit((int)(status)) -DBENCH_INSTR_GET()=bench_perf_instr() -DBENCH_INSTR_OK()=bench_perf_ok() -DBENCH_OVERHEAD_BUDGET=\"overhead_budget_host.h\"" \
+    "$ROOT_DIR/ci/host-port/build.sh" "$kernel"
+  BIN="$OUT_DIR/host/$kernel/bench-$SUITE"
+}
+
+# Cortex-M port headers and ci/bench/freertos/FreeRTOSConfig.h; the kernel
+# headers are system headers so only warnings in the bench sources count.
+check_freertos() {
+  if [[ ! -f "$FREERTOS_DIR/Source/include/FreeRTOS.h" ]]; then
+    echo "[bench] $FREERTOS_DIR not checked out, skipping the BENCH_FREERTOS syntax check"
+    return 0
+  fi
+  echo "[bench] BENCH_FREERTOS syntax check"
+  "$CC" "${CFLAGS[@]}" -fsyntax-only -DBENCH_FREERTOS \
+    -I"$BENCH_DIR" \
+    -I"$BENCH_DIR/freertos" \
+    -I"$ROOT_DIR/CMSIS/RTOS2/Include" \
+    -isystem "$FREERTOS_DIR/Source/include" \
+    -isystem "$FREERTOS_DIR/Source/portable/GCC/ARM_CM3" \
+    -isystem "$FREERTOS_DIR/CMSIS/RTOS2/FreeRTOS/Include" \
+    "$BENCH_DIR/bench.c" "$BENCH_DIR/tm.c"
+}
+
+status=0
+check_freertos || status=1
+for kernel in ucos2 ucos3; do
+  ver=${kernel#ucos}
+  echo "[bench] $SUITE on $kernel ($TARGET)"
+  "build_$TARGET" "$kernel" "$ver"
+  out="$OUT_DIR/$SUITE-$kernel.json"
+  rc=0
+  timeout "$TIMEOUT" "$BIN" > "$out" || rc=$?
+  if [[ $rc -ne 0 ]]; then
+    # Suites exit with the number of results over budget; 124 is a timeout.
+    echo "[bench] $SUITE-$kernel failed (exit $rc), see $out" >&2
+    status=1
+    continue
+  fi
+  if command -v python3 >/dev/null 2>&1 && ! python3 -m json.tool "$out" >/dev/null; then
+    echo "[bench] $out is not valid JSON" >&2
+    status=1
+    continue
+  fi
+  echo "[bench] wrote $out"
+done
+
+# Results from other backends (e.g. a CMSIS-FreeRTOS board run saved as
+# <suite>-freertos.json) join the comparison when present.
+if command -v python3 >/dev/null 2>&1; then
+  results=()
+  for kernel in ucos2 ucos3 freertos; do
+    [[ -f "$OUT_DIR/$SUITE-$kernel.json" ]] && results+=("$OUT_DIR/$SUITE-$kernel.json")
+  done
+  echo
+  python3 "$BENCH_DIR/compare.py" "${results[@]}" | tee "$OUT_DIR/$SUITE.md"
+fi
+
+exit $status
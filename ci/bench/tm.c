@@ -0,0 +1,229 @@
+#include "bench.h"
+
+/*
+ * Thread-Metric style throughput workload. Each test runs its worker
+ * threads for BENCH_TM_TICKS kernel ticks while the runner sleeps at the
+ * highest priority, then reports how many iterations the workers
+ * completed. Only CMSIS-RTOS2 calls are used, so the same source measures
+ * the uC/OS-II, uC/OS-III and CMSIS-FreeRTOS backends.
+ */
+
+#ifndef BENCH_TM_TICKS
+#define BENCH_TM_TICKS     1000u
+#endif
+
+#define TM_WORKERS         5u
+#define TM_LOOP_CYCLES     20u    /* per-iteration work charged on ci/vsim */
+#define TM_MQ_DEPTH        8u
+#define TM_POOL_BLOCKS     8u
+#define TM_POOL_BLOCK_SIZE 128u
+
+static BENCH_CB(thread) runner_cb;
+static BENCH_CB(thread) worker_cb[TM_WORKERS];
+BENCH_STACK(runner_stack, 2048u);
+static bench_stk_t worker_stack[TM_WORKERS][1024u / sizeof(bench_stk_t)];
+
+static BENCH_CB(semaphore) sem_cb;
+BENCH_MQ_CB(mq_cb, TM_MQ_DEPTH);
+static void *mq_storage[TM_MQ_DEPTH];
+
+static osSemaphoreId_t    sem;
+static osMessageQueueId_t mq;
+static osThreadId_t       workers[TM_WORKERS];
+static volatile uint32_t  counter[TM_WORKERS];
+
+#if BENCH_MEMORY_POOL
+BENCH_MP_CB(pool_cb, TM_POOL_BLOCKS);
+static uint64_t pool_storage[(TM_POOL_BLOCKS * TM_POOL_BLOCK_SIZE) / sizeof(uint64_t)];
+static osMemoryPoolId_t pool;
+#endif
+
+/* ==== Helpers ==== */
+
+static osThreadId_t tm_spawn(uint32_t slot, osThreadFunc_t func, osPriority_t priority) {
+  const osThreadAttr_t attr = {
+    .name       = "tm.worker",
+    .cb_mem     = &worker_cb[slot],
+    .cb_size    = sizeof(worker_cb[slot]),
+    .stack_mem  = worker_stack[slot],
+    .stack_size = sizeof(worker_stack[slot]),
+    .priority   = priority,
+  };
+  return osThreadNew(func, (void *)(uintptr_t)slot, &attr);
+}
+
+/* Start count workers, let them run for BENCH_TM_TICKS and report the sum. */
+static void tm_run(const char *name, osThreadFunc_t func, uint32_t count, bool ascending) {
+  (void)osKernelLock();
+  for (uint32_t i = 0u; i < count; ++i) {
+    counter[i] = 0u;
+    osPriority_t priority = ascending ? (osPriority_t)(osPriorityAboveNormal + (int32_t)i) : osPriorityNormal;
+    workers[i] = tm_spawn(i, func, priority);
+  }
+  (void)osKernelUnlock();
+
+  (void)osDelay(BENCH_TM_TICKS);
+
+  uint64_t total = 0u;
+  (void)osKernelLock();
+  for (uint32_t i = 0u; i < count; ++i) {
+    total += counter[i];
+  }
+  (void)osKernelUnlock();
+  for (uint32_t i = 0u; i < count; ++i) {
+    (void)osThreadTerminate(workers[i]);
+  }
+  bench_json_rate(name, total, BENCH_TM_TICKS);
+}
+
+/* ==== Tests ==== */
+
+/* Equal-priority threads passing the CPU round robin. On uC/OS-II each
+ * thread owns a distinct native priority, so only the first one runs. */
+static void cooperative_thread(void *argument) {
+  uint32_t slot = (uint32_t)(uintptr_t)argument;
+  for (;;) {
+    counter[slot]++;
+    BENCH_WORK(TM_LOOP_CYCLES);
+    (void)osThreadYield();
+  }
+}
+
+/* Thread 0 (lowest) resumes thread 1, which resumes thread 2, ...; each
+ * resumed thread preempts its resumer and suspends itself again. */
+static void preemptive_thread(void *argument) {
+  uint32_t slot = (uint32_t)(uintptr_t)argument;
+  for (;;) {
+    counter[slot]++;
+    BENCH_WORK(TM_LOOP_CYCLES);
+    if ((slot + 1u) < TM_WORKERS) {
+      (void)osThreadResume(workers[slot + 1u]);
+    }
+    if (slot != 0u) {
+      (void)osThreadSuspend(osThreadGetId());
+    }
+  }
+}
+
+static void tm_isr(void) {
+  (void)osSemaphoreRelease(sem);
+}
+
+/* Raise a software interrupt whose handler releases the semaphore the
+ * thread then takes. */
+static void interrupt_thread(void *argument) {
+  uint32_t slot = (uint32_t)(uintptr_t)argument;
+  for (;;) {
+    if (!bench_irq_trigger()) {
+      break;
+    }
+    (void)osSemaphoreAcquire(sem, osWaitForever);
+    counter[slot]++;
+    BENCH_WORK(TM_LOOP_CYCLES);
+  }
+  for (;;) {
+    (void)osThreadSuspend(osThreadGetId());
+  }
+}
+
+/* Pointer-sized messages: the only size every backend supports. */
+static void message_thread(void *argument) {
+  uint32_t slot = (uint32_t)(uintptr_t)argument;
+  void *msg = &workers[slot];
+  void *out = NULL;
+  for (;;) {
+    (void)osMessageQueuePut(mq, &msg, 0u, osWaitForever);
+    (void)osMessageQueueGet(mq, &out, NULL, osWaitForever);
+    counter[slot]++;
+    BENCH_WORK(TM_LOOP_CYCLES);
+  }
+}
+
+static void sync_thread(void *argument) {
+  uint32_t slot = (uint32_t)(uintptr_t)argument;
+  for (;;) {
+    (void)osSemaphoreRelease(sem);
+    (void)osSemaphoreAcquire(sem, osWaitForever);
+    counter[slot]++;
+    BENCH_WORK(TM_LOOP_CYCLES);
+  }
+}
+
+#if BENCH_MEMORY_POOL
+static void memory_thread(void *argument) {
+  uint32_t slot = (uint32_t)(uintptr_t)argument;
+  for (;;) {
+    void *block = osMemoryPoolAlloc(pool, osWaitForever);
+    (void)osMemoryPoolFree(pool, block);
+    counter[slot]++;
+    BENCH_WORK(TM_LOOP_CYCLES);
+  }
+}
+#endif
+
+/* ==== Runner ==== */
+
+static void runner_thread(void *argument) {
+  (void)argument;
+
+  bench_json_begin("tm");
+  tm_run("tm.cooperative", cooperative_thread, TM_WORKERS, false);
+  tm_run("tm.preemptive", preemptive_thread, TM_WORKERS, true);
+  if (bench_irq_trigger()) {
+    (void)osSemaphoreAcquire(sem, osWaitForever);
+    tm_run("tm.interrupt", interrupt_thread, 1u, false);
+  } else {
+    bench_json_skip("tm.interrupt", "no software interrupt");
+  }
+  tm_run("tm.message", message_thread, 1u, false);
+  tm_run("tm.sync", sync_thread, 1u, false);
+#if BENCH_MEMORY_POOL
+  tm_run("tm.memory", memory_thread, 1u, false);
+#else
+  bench_json_skip("tm.memory", "BENCH_MEMORY_POOL is 0");
+#endif
+  BENCH_EXIT(bench_json_end());
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osSemaphoreAttr_t sem_attr = { .name = "tm.sem", .cb_mem = &sem_cb, .cb_size = sizeof(sem_cb) };
+  sem = osSemaphoreNew(1u, 0u, &sem_attr);
+
+  const osMessageQueueAttr_t mq_attr = {
+    .name    = "tm.mq",
+    .cb_mem  = mq_cb,
+    .cb_size = sizeof(mq_cb),
+    .mq_mem  = mq_storage,
+    .mq_size = sizeof(mq_storage),
+  };
+  mq = osMessageQueueNew(TM_MQ_DEPTH, sizeof(void *), &mq_attr);
+
+#if BENCH_MEMORY_POOL
+  const osMemoryPoolAttr_t pool_attr = {
+    .name    = "tm.pool",
+    .cb_mem  = pool_cb,
+    .cb_size = sizeof(pool_cb),
+    .mp_mem  = pool_storage,
+    .mp_size = sizeof(pool_storage),
+  };
+  pool = osMemoryPoolNew(TM_POOL_BLOCKS, TM_POOL_BLOCK_SIZE, &pool_attr);
+#endif
+
+  bench_irq_init(tm_isr);
+
+  const osThreadAttr_t runner_attr = {
+    .name       = "tm.runner",
+    .cb_mem     = &runner_cb,
+    .cb_size    = sizeof(runner_cb),
+    .stack_mem  = runner_stack,
+    .stack_size = sizeof(runner_stack),
+    .priority   = osPriorityRealtime,
+  };
+  osThreadNew(runner_thread, NULL, &runner_attr);
+
+  osKernelStart();
+  for (;;) {
+  }
+}
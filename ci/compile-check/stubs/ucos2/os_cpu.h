@@ -14,7 +14,10 @@ typedef uint32_t  OS_STK;
 
 typedef uint8_t   BOOLEAN;
 
-#define OS_ENTER_CRITICAL() do {} while (0)
-#define OS_EXIT_CRITICAL()  do {} while (0)
+typedef uint32_t  OS_CPU_SR;
+
+#define OS_CRITICAL_METHOD  3u
+#define OS_ENTER_CRITICAL() do { (void)cpu_sr; } while (0)
+#define OS_EXIT_CRITICAL()  do { (void)cpu_sr; } while (0)
 
 #endif /* OS_CPU_H */
@@ -0,0 +1,140 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build the CMSIS-RTOS2 wrappers and their examples against the real
+# uC/OS-II / uC/OS-III sources (git submodules) on the POSIX host port.
+#
+#   ci/host-port/build.sh [ucos2|ucos3|selftest|all]
+#
+# Binaries are written to _host_build/<kernel>/<example>. selftest builds and
+# runs selftest.c, which checks the host runtime without a kernel; "all" runs
+# it before building the kernels.
+#
+# APP_NAME/APP_SRCS additionally link an out-of-tree application (e.g. the
+# ci/bench suites) as _host_build/<kernel>/<APP_NAME>; APP_CFLAGS are added
+# to its compile flags.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+PORT_DIR="$ROOT_DIR/ci/host-port"
+OUT_DIR=${OUT_DIR:-"$ROOT_DIR/_host_build"}
+TARGET=${1:-all}
+
+CC=${CC:-gcc}
+CFLAGS=(
+  -std=gnu11 -O1 -g
+  -D__STATIC_INLINE=static\ inline
+)
+WRAPPER_CFLAGS=(-Wall -Wextra)
+LDFLAGS=(-pthread)
+EXAMPLES=(basic bench_thread)
+
+# Benchmarks print their results on the host.
+BENCH_CFLAGS=(
+  -include stdio.h
+  "-DBENCH_LOG(name,cycles)=printf(\"%-16s %10u ns\\n\", (name), (unsigned)(cycles))"
+)
+
+require_sources() {
+  local dir="$1"
+  if ! ls "$dir"/*.c >/dev/null 2>&1; then
+    echo "[host-port] $dir is empty: run 'git submodule update --init' first" >&2
+    exit 1
+  fi
+}
+
+# compile <out.o> <src> <flags...>
+compile() {
+  local obj="$1" src="$2"
+  shift 2
+  "$CC" "${CFLAGS[@]}" "$@" -c "$src" -o "$obj"
+}
+
+selftest() {
+  mkdir -p "$OUT_DIR"
+  echo "[host-port] runtime selftest"
+  "$CC" "${CFLAGS[@]}" "${WRAPPER_CFLAGS[@]}" -I"$PORT_DIR/common" \
+    "$PORT_DIR/common/host_cpu.c" "$PORT_DIR/selftest.c" "${LDFLAGS[@]}" -o "$OUT_DIR/selftest"
+  "$OUT_DIR/selftest"
+}
+
+build_kernel() {
+  local kernel="$1" ver src_dir wrapper
+  case "$kernel" in
+    ucos2) ver=2; src_dir="$ROOT_DIR/libs/uC-OS2/Source" ;;
+    ucos3) ver=3; src_dir="$ROOT_DIR/libs/uC-OS3/Source" ;;
+    *) echo "[host-port] unknown kernel '$kernel'" >&2; exit 1 ;;
+  esac
+  require_sources "$src_dir"
+
+  local obj_dir="$OUT_DIR/$kernel/obj"
+  mkdir -p "$obj_dir"
+
+  # Port headers first; the compile-check stubs only supply os_trace.h when
+  # the kernel sources do not ship one.
+  local inc=(
+    -I"$PORT_DIR/$kernel"
+    -I"$PORT_DIR/common"
+    -I"$src_dir"
+    -I"$ROOT_DIR/ci/compile-check/stubs/$kernel"
+    -I"$ROOT_DIR/CMSIS/RTOS2/Include"
+    -I"$ROOT_DIR/CMSIS/RTOS2/uCOS$ver/Include"
+  )
+
+  echo "[host-port] $kernel kernel"
+  local objs=()
+  local src
+  for src in "$src_dir"/*.c; do
+    case "$(basename "$src")" in
+      ucos_ii.c|*_r.c) continue ;;   # amalgamation and templates
+    esac
+    compile "$obj_dir/$(basename "${src%.c}").o" "$src" "${inc[@]}"
+    objs+=("$obj_dir/$(basename "${src%.c}").o")
+  done
+
+  echo "[host-port] $kernel port"
+  for src in "$PORT_DIR/common"/*.c "$PORT_DIR/$kernel"/*.c; do
+    compile "$obj_dir/port_$(basename "${src%.c}").o" "$src" "${WRAPPER_CFLAGS[@]}" "${inc[@]}"
+    objs+=("$obj_dir/port_$(basename "${src%.c}").o")
+  done
+
+  echo "[host-port] $kernel wrapper"
+  wrapper="$ROOT_DIR/CMSIS/RTOS2/uCOS$ver/Source/cmsis_os2_ucos$ver.c"
+  compile "$obj_dir/cmsis_os2_ucos$ver.o" "$wrapper" "${WRAPPER_CFLAGS[@]}" "${inc[@]}"
+  objs+=("$obj_dir/cmsis_os2_ucos$ver.o")
+
+  local example
+  for example in "${EXAMPLES[@]}"; do
+    echo "[host-port] $kernel example $example"
+    compile "$obj_dir/example_$example.o" "$ROOT_DIR/CMSIS/RTOS2/uCOS$ver/examples/$example/main.c" \
+      "${WRAPPER_CFLAGS[@]}" "${BENCH_CFLAGS[@]}" "${inc[@]}"
+    "$CC" "${objs[@]}" "$obj_dir/example_$example.o" "${LDFLAGS[@]}" -o "$OUT_DIR/$kernel/$example"
+  done
+
+  if [[ -n "${APP_NAME:-}" ]]; then
+    echo "[host-port] $kernel app $APP_NAME"
+    local app_objs=() app_flags
+    read -r -a app_flags <<< "${APP_CFLAGS:-}"
+    for src in ${APP_SRCS:-}; do
+      compile "$obj_dir/app_$(basename "${src%.c}").o" "$src" \
+        "${WRAPPER_CFLAGS[@]}" "${app_flags[@]}" "${inc[@]}"
+      app_objs+=("$obj_dir/app_$(basename "${src%.c}").o")
+    done
+    "$CC" "${objs[@]}" "${app_objs[@]}" "${LDFLAGS[@]}" -o "$OUT_DIR/$kernel/$APP_NAME"
+  fi
+}
+
+case "$TARGET" in
+  selftest)
+    selftest
+    ;;
+  all)
+    selftest
+    build_kernel ucos2
+    build_kernel ucos3
+    ;;
+  *)
+    build_kernel "$TARGET"
+    ;;
+esac
+
+echo "[host-port] OK: binaries in $OUT_DIR"
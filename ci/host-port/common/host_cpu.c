@@ -0,0 +1,255 @@
+#define _GNU_SOURCE
+
+#include "host_cpu.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+
+struct host_ctx {
+  ucontext_t  uc;
+  void       *stack;
+  void      (*entry)(void *arg);
+  void       *arg;
+  void      (*exit_fn)(void);
+  uint32_t    irq_state;        /* interrupt disable flag saved across switches */
+};
+
+static struct {
+  host_ctx_t          *current;
+  host_ctx_t          *zombie;  /* released while running, freed after the next switch */
+  ucontext_t           boot;    /* context of main() before the first task starts */
+  pthread_t            cpu;     /* thread that runs the kernel */
+  volatile sig_atomic_t disabled;
+  _Atomic uint32_t     pending;
+  host_isr_t           isr[HOST_IRQ_MAX];
+  int                  ready;
+} host;
+
+static void host_fatal(const char *what) {
+  fprintf(stderr, "host-port: %s: %s\n", what, strerror(errno));
+  abort();
+}
+
+/* Run pending ISRs with interrupts "disabled"; an ISR may switch context. */
+static void host_dispatch(void) {
+  for (;;) {
+    host.disabled = 1;
+    atomic_signal_fence(memory_order_seq_cst);
+    uint32_t pending = atomic_exchange(&host.pending, 0u);
+    if (pending == 0u) {
+      host.disabled = 0;
+      atomic_signal_fence(memory_order_seq_cst);
+      if (atomic_load(&host.pending) == 0u) {
+        return;
+      }
+      continue;
+    }
+    for (uint32_t irq = 0u; irq < HOST_IRQ_MAX; ++irq) {
+      if (((pending >> irq) & 1u) != 0u && host.isr[irq] != NULL) {
+        host.isr[irq]();
+      }
+    }
+  }
+}
+
+static void host_signal(int sig) {
+  int saved_errno = errno;
+  if (sig == SIGALRM) {
+    atomic_fetch_or(&host.pending, 1u << HOST_IRQ_TICK);
+  }
+  if (host.disabled == 0 && host.current != NULL) {
+    host_dispatch();
+  }
+  errno = saved_errno;
+}
+
+static void host_init(void) {
+  if (host.ready != 0) {
+    return;
+  }
+  host.cpu = pthread_self();
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = host_signal;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART;
+  if (sigaction(SIGALRM, &sa, NULL) != 0 || sigaction(SIGUSR1, &sa, NULL) != 0) {
+    host_fatal("sigaction");
+  }
+  host.ready = 1;
+}
+
+/* malloc()/free() are not reentrant: only called with emulated interrupts masked. */
+static void host_reap(void) {
+  if (host.zombie != NULL && host.zombie != host.current) {
+    free(host.zombie->stack);
+    free(host.zombie);
+    host.zombie = NULL;
+  }
+}
+
+static void host_trampoline(void) {
+  host_ctx_t *self = host.current;
+  uint32_t state = host_irq_disable();
+  host_reap();
+  host_irq_restore(state);
+  self->entry(self->arg);
+  if (self->exit_fn != NULL) {
+    self->exit_fn();
+  }
+  /* exit_fn deletes the task and never returns */
+  abort();
+}
+
+host_ctx_t *host_ctx_create(void (*entry)(void *arg), void *arg, void (*exit_fn)(void)) {
+  host_init();
+
+  uint32_t state = host_irq_disable();
+  host_ctx_t *ctx = calloc(1u, sizeof(*ctx));
+  if (ctx == NULL || (ctx->stack = malloc(HOST_TASK_STACK_SIZE)) == NULL) {
+    host_fatal("out of memory");
+  }
+  host_irq_restore(state);
+  if (getcontext(&ctx->uc) != 0) {
+    host_fatal("getcontext");
+  }
+  ctx->uc.uc_stack.ss_sp   = ctx->stack;
+  ctx->uc.uc_stack.ss_size = HOST_TASK_STACK_SIZE;
+  ctx->uc.uc_link          = NULL;
+  sigemptyset(&ctx->uc.uc_sigmask);
+  makecontext(&ctx->uc, host_trampoline, 0);
+
+  ctx->entry     = entry;
+  ctx->arg       = arg;
+  ctx->exit_fn   = exit_fn;
+  ctx->irq_state = 0u;          /* tasks start with interrupts enabled */
+  return ctx;
+}
+
+void host_ctx_release(host_ctx_t *ctx) {
+  if (ctx == NULL) {
+    return;
+  }
+  uint32_t state = host_irq_disable();
+  if (ctx == host.current) {
+    host.zombie = ctx;
+  } else {
+    free(ctx->stack);
+    free(ctx);
+  }
+  host_irq_restore(state);
+}
+
+void host_ctx_start(host_ctx_t *to) {
+  host_init();
+  host.disabled = 1;
+  host.current = to;
+  host.disabled = (sig_atomic_t)to->irq_state;
+  if (swapcontext(&host.boot, &to->uc) != 0) {
+    host_fatal("swapcontext");
+  }
+  /* never returns: main() is not a task */
+  abort();
+}
+
+void host_ctx_switch(host_ctx_t *from, host_ctx_t *to) {
+  if (from == to) {
+    return;
+  }
+  from->irq_state = (uint32_t)host.disabled;
+  host.current = to;
+  host.disabled = (sig_atomic_t)to->irq_state;
+  if (swapcontext(&from->uc, &to->uc) != 0) {
+    host_fatal("swapcontext");
+  }
+  host_reap();
+}
+
+uint32_t host_irq_disable(void) {
+  uint32_t state = (uint32_t)host.disabled;
+  host.disabled = 1;
+  atomic_signal_fence(memory_order_seq_cst);
+  return state;
+}
+
+void host_irq_restore(uint32_t state) {
+  atomic_signal_fence(memory_order_seq_cst);
+  host.disabled = (sig_atomic_t)state;
+  atomic_signal_fence(memory_order_seq_cst);
+  if (state == 0u && atomic_load(&host.pending) != 0u && host.current != NULL) {
+    host_dispatch();
+  }
+}
+
+void host_irq_set_handler(uint32_t irq, host_isr_t isr) {
+  if (irq < HOST_IRQ_MAX) {
+    host.isr[irq] = isr;
+  }
+}
+
+void host_irq_trigger(uint32_t irq) {
+  if (irq >= HOST_IRQ_MAX) {
+    return;
+  }
+  atomic_fetch_or(&host.pending, 1u << irq);
+  if (host.ready != 0 && !pthread_equal(pthread_self(), host.cpu)) {
+    (void)pthread_kill(host.cpu, SIGUSR1);
+  } else if (host.disabled == 0 && host.current != NULL) {
+    host_dispatch();
+  }
+}
+
+void host_tick_start(uint32_t tick_hz) {
+  host_init();
+
+  struct itimerval it;
+  uint32_t usec = (tick_hz != 0u) ? (1000000u / tick_hz) : 1000u;
+  it.it_interval.tv_sec  = (time_t)(usec / 1000000u);
+  it.it_interval.tv_usec = (suseconds_t)(usec % 1000000u);
+  it.it_value = it.it_interval;
+  if (setitimer(ITIMER_REAL, &it, NULL) != 0) {
+    host_fatal("setitimer");
+  }
+}
+
+int host_device_thread(void *(*fn)(void *arg), void *arg) {
+  host_init();
+
+  /* The new thread inherits the mask: it must never run the kernel's ISRs. */
+  sigset_t all;
+  sigset_t saved;
+  sigfillset(&all);
+  pthread_sigmask(SIG_BLOCK, &all, &saved);
+  pthread_t thread;
+  int err = pthread_create(&thread, NULL, fn, arg);
+  pthread_sigmask(SIG_SETMASK, &saved, NULL);
+  if (err == 0) {
+    (void)pthread_detach(thread);
+  }
+  return err;
+}
+
+void host_idle(void) {
+  sigset_t none;
+  sigemptyset(&none);
+  (void)sigsuspend(&none);
+}
+
+uint32_t host_ts_get(void) {
+  struct timespec ts;
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+uint32_t host_ts_freq(void) {
+  return 1000000000u;
+}
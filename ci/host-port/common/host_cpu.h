@@ -0,0 +1,59 @@
+#ifndef HOST_CPU_H
+#define HOST_CPU_H
+
+/*
+ * POSIX host runtime shared by the uC/OS-II and uC/OS-III host ports.
+ *
+ * Every task runs on its own ucontext with a host-allocated stack. Interrupts
+ * are modelled by a software "interrupt disable" flag: SIGALRM (tick) and
+ * SIGUSR1 (host_irq_trigger) only mark an IRQ pending while the flag is set,
+ * and the pending IRQs are dispatched on the next host_irq_restore(). ISR
+ * handlers run with the flag set, exactly like OS_ENTER_CRITICAL() regions,
+ * and may switch context through OSIntCtxSw().
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HOST_IRQ_TICK        0u     /* periodic tick, raised by SIGALRM */
+#define HOST_IRQ_MAX         32u
+
+#ifndef HOST_TASK_STACK_SIZE
+#define HOST_TASK_STACK_SIZE (256u * 1024u)   /* host stack per task */
+#endif
+
+typedef struct host_ctx host_ctx_t;
+
+typedef void (*host_isr_t)(void);
+
+/* Context management (used by OSTaskStkInit / OSCtxSw / OSTaskDelHook). */
+host_ctx_t *host_ctx_create(void (*entry)(void *arg), void *arg, void (*exit_fn)(void));
+void        host_ctx_release(host_ctx_t *ctx);
+void        host_ctx_start(host_ctx_t *to);
+void        host_ctx_switch(host_ctx_t *from, host_ctx_t *to);
+
+/* Interrupt emulation. */
+uint32_t    host_irq_disable(void);
+void        host_irq_restore(uint32_t state);
+void        host_irq_set_handler(uint32_t irq, host_isr_t isr);
+void        host_irq_trigger(uint32_t irq);      /* async-signal safe, any pthread */
+void        host_tick_start(uint32_t tick_hz);
+
+/* Start a "device" pthread (all signals blocked) that may call host_irq_trigger(). */
+int         host_device_thread(void *(*fn)(void *arg), void *arg);
+
+/* Idle task: sleep until the next signal instead of spinning. */
+void        host_idle(void);
+
+/* Free-running timestamp (CLOCK_MONOTONIC, truncated to 32 bits). */
+uint32_t    host_ts_get(void);
+uint32_t    host_ts_freq(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_CPU_H */
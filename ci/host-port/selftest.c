@@ -0,0 +1,148 @@
+/*
+ * Kernel-independent check of the host runtime (common/host_cpu.c): a round-robin
+ * "scheduler" switches tasks from the tick ISR (swapcontext inside the
+ * SIGALRM handler), from a device IRQ raised by another pthread (SIGUSR1)
+ * and voluntarily, and one task exits through its exit function. Every task
+ * checks that it runs with both signals unblocked and the emulated interrupt
+ * flag clear, so a signal mask saved inside a handler cannot leak into task
+ * code. Exits 0 on success.
+ */
+
+#define _GNU_SOURCE
+
+#include "host_cpu.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SELFTEST_TASKS      4u
+#define SELFTEST_TICK_HZ    1000u
+#define SELFTEST_TICKS      500u
+#define SELFTEST_IRQ_DEV    1u
+#define SELFTEST_EXIT_AFTER 20u       /* ticks task 3 runs before it exits */
+
+static host_ctx_t *tasks[SELFTEST_TASKS];
+static volatile int alive[SELFTEST_TASKS];
+static volatile uint32_t current;
+static volatile uint32_t ticks;
+static volatile uint32_t dev_irqs;
+static volatile uint32_t runs[SELFTEST_TASKS];
+static volatile uint32_t resumes[SELFTEST_TASKS];
+static volatile uint32_t bad_mask;
+static volatile uint32_t bad_flag;
+static volatile int stop;
+
+/* Called with emulated interrupts disabled, from task or ISR context. */
+static void selftest_switch(void) {
+  uint32_t from = current;
+  uint32_t next = from;
+  do {
+    next = (next + 1u) % SELFTEST_TASKS;
+  } while (alive[next] == 0);
+  if (next == from) {
+    return;
+  }
+  current = next;
+  host_ctx_switch(tasks[from], tasks[next]);
+}
+
+static void selftest_tick_isr(void) {
+  ticks++;
+  selftest_switch();
+}
+
+static void selftest_dev_isr(void) {
+  dev_irqs++;
+  if ((dev_irqs & 3u) == 0u) {
+    selftest_switch();
+  }
+}
+
+static void selftest_check(uint32_t id) {
+  sigset_t mask;
+  (void)pthread_sigmask(SIG_BLOCK, NULL, &mask);
+  if ((sigismember(&mask, SIGALRM) == 1) || (sigismember(&mask, SIGUSR1) == 1)) {
+    bad_mask++;
+  }
+  uint32_t state = host_irq_disable();
+  if (state != 0u) {
+    bad_flag++;
+  }
+  host_irq_restore(state);
+  resumes[id]++;
+}
+
+static void selftest_task(void *arg) {
+  uint32_t id = (uint32_t)(uintptr_t)arg;
+  uint32_t start = ticks;
+
+  while (stop == 0) {
+    selftest_check(id);
+    runs[id]++;
+    if ((id == 3u) && ((ticks - start) >= SELFTEST_EXIT_AFTER)) {
+      return;
+    }
+    if ((runs[id] % 4096u) == 0u) {
+      uint32_t state = host_irq_disable();
+      selftest_switch();
+      host_irq_restore(state);
+    }
+    if ((id == 0u) && (ticks >= SELFTEST_TICKS)) {
+      stop = 1;
+    }
+  }
+
+  if (id != 0u) {
+    for (;;) {
+      host_idle();
+    }
+  }
+
+  uint32_t ok = (bad_mask == 0u) && (bad_flag == 0u) && (dev_irqs > 0u) && (alive[3] == 0);
+  for (uint32_t i = 0u; i < SELFTEST_TASKS; ++i) {
+    ok = ok && (runs[i] > 0u) && (resumes[i] > 0u);
+  }
+  printf("[host-port] selftest: ticks %u, device irqs %u, runs %u/%u/%u/%u, bad mask %u, bad flag %u\n",
+         (unsigned)ticks, (unsigned)dev_irqs, (unsigned)runs[0], (unsigned)runs[1],
+         (unsigned)runs[2], (unsigned)runs[3], (unsigned)bad_mask, (unsigned)bad_flag);
+  fflush(stdout);
+  _exit(ok ? 0 : 1);
+}
+
+/* Task 3 returns into here and never comes back. */
+static void selftest_exit(void) {
+  (void)host_irq_disable();
+  alive[current] = 0;
+  host_ctx_release(tasks[current]);
+  selftest_switch();
+  abort();
+}
+
+static void *selftest_device(void *arg) {
+  (void)arg;
+  const struct timespec period = { 0, 700000 };
+  for (;;) {
+    (void)nanosleep(&period, NULL);
+    host_irq_trigger(SELFTEST_IRQ_DEV);
+  }
+  return NULL;
+}
+
+int main(void) {
+  for (uint32_t i = 0u; i < SELFTEST_TASKS; ++i) {
+    tasks[i] = host_ctx_create(selftest_task, (void *)(uintptr_t)i, selftest_exit);
+    alive[i] = 1;
+  }
+  host_irq_set_handler(HOST_IRQ_TICK, selftest_tick_isr);
+  host_irq_set_handler(SELFTEST_IRQ_DEV, selftest_dev_isr);
+  if (host_device_thread(selftest_device, NULL) != 0) {
+    return 1;
+  }
+  alarm(10u);   /* a hang fails the check */
+  host_tick_start(SELFTEST_TICK_HZ);
+  host_ctx_start(tasks[0]);
+  return 1;
+}
@@ -0,0 +1,13 @@
+#ifndef APP_CFG_H
+#define APP_CFG_H
+
+/* uC/OS-II application configuration for the POSIX host port. */
+
+#include "host_cpu.h"
+
+#define OS_TASK_TMR_PRIO        (OS_LOWEST_PRIO - 2u)
+
+/* Monotonic nanosecond timestamp for CPU usage and benchmarks. */
+#define UCOS2_TS_GET()          host_ts_get()
+
+#endif /* APP_CFG_H */
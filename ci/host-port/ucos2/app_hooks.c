@@ -0,0 +1,41 @@
+#include <ucos_ii.h>
+
+#include "ucos2_os2.h"
+
+/* Application hooks of the host port: forward to the CMSIS wrapper. */
+
+#if OS_APP_HOOKS_EN > 0u
+void App_TaskCreateHook(OS_TCB *ptcb) {
+  (void)ptcb;
+}
+
+void App_TaskDelHook(OS_TCB *ptcb) {
+  (void)ptcb;
+}
+
+void App_TaskIdleHook(void) {
+}
+
+void App_TaskReturnHook(OS_TCB *ptcb) {
+  (void)ptcb;
+}
+
+void App_TaskStatHook(void) {
+}
+
+#if OS_TASK_SW_HOOK_EN > 0u
+void App_TaskSwHook(void) {
+  osUcos2TaskSwHook();
+}
+#endif
+
+void App_TCBInitHook(OS_TCB *ptcb) {
+  (void)ptcb;
+}
+
+#if OS_TIME_TICK_HOOK_EN > 0u
+void App_TimeTickHook(void) {
+  osUcos2TimeTickHook();
+}
+#endif
+#endif
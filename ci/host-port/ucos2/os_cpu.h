@@ -0,0 +1,43 @@
+#ifndef OS_CPU_H
+#define OS_CPU_H
+
+/*
+ * uC/OS-II POSIX host port: tasks run on ucontext stacks managed by
+ * host_cpu.c, critical sections mask the emulated interrupts (tick and
+ * host_irq_trigger()) and OS_TASK_SW() switches contexts directly.
+ */
+
+#include <stdint.h>
+
+#include "host_cpu.h"
+
+typedef uint8_t    BOOLEAN;
+typedef uint8_t    INT8U;
+typedef int8_t     INT8S;
+typedef uint16_t   INT16U;
+typedef int16_t    INT16S;
+typedef uint32_t   INT32U;
+typedef int32_t    INT32S;
+typedef uint64_t   INT64U;
+typedef int64_t    INT64S;
+typedef float      FP32;
+typedef double     FP64;
+
+/* A stack word must hold the host context pointer stored by OSTaskStkInit(). */
+typedef uintptr_t  OS_STK;
+typedef uint32_t   OS_CPU_SR;
+
+#define OS_CRITICAL_METHOD   3u
+
+#define OS_ENTER_CRITICAL()  do { cpu_sr = host_irq_disable(); } while (0)
+#define OS_EXIT_CRITICAL()   do { host_irq_restore(cpu_sr); } while (0)
+
+#define OS_STK_GROWTH        1u
+
+#define OS_TASK_SW()         OSCtxSw()
+
+void OSCtxSw(void);
+void OSIntCtxSw(void);
+void OSStartHighRdy(void);
+
+#endif /* OS_CPU_H */
@@ -0,0 +1,123 @@
+#include <ucos_ii.h>
+
+#include "host_cpu.h"
+
+/* The task's host context lives in the top stack word written by OSTaskStkInit(). */
+#define OS_HOST_CTX(ptcb)   ((host_ctx_t *)(uintptr_t)*(ptcb)->OSTCBStkPtr)
+
+/* ==== Tick ==== */
+
+static void OSTickISR(void) {
+  OSIntEnter();
+  OSTimeTick();
+  OSIntExit();
+}
+
+/* ==== Context Switch ==== */
+
+void OSStartHighRdy(void) {
+#if OS_CPU_HOOKS_EN > 0u
+  OSTaskSwHook();
+#endif
+  OSRunning = OS_TRUE;
+  host_irq_set_handler(HOST_IRQ_TICK, OSTickISR);
+  host_tick_start(OS_TICKS_PER_SEC);
+  host_ctx_start(OS_HOST_CTX(OSTCBHighRdy));
+}
+
+void OSCtxSw(void) {
+  OS_TCB *from = OSTCBCur;
+
+#if OS_CPU_HOOKS_EN > 0u
+  OSTaskSwHook();
+#endif
+  OSTCBCur = OSTCBHighRdy;
+  OSPrioCur = OSPrioHighRdy;
+  host_ctx_switch(OS_HOST_CTX(from), OS_HOST_CTX(OSTCBHighRdy));
+}
+
+/* Called from OSIntExit() inside the emulated ISR: the preempted task resumes
+ * there once it is switched back in. */
+void OSIntCtxSw(void) {
+  OSCtxSw();
+}
+
+/* ==== Task Stack ==== */
+
+OS_STK *OSTaskStkInit(void (*task)(void *p_arg), void *p_arg, OS_STK *ptos, INT16U opt) {
+  (void)opt;
+  *ptos = (OS_STK)(uintptr_t)host_ctx_create(task, p_arg, OS_TaskReturn);
+  return ptos;
+}
+
+/* ==== Hooks ==== */
+
+#if OS_CPU_HOOKS_EN > 0u
+void OSInitHookBegin(void) {
+}
+
+void OSInitHookEnd(void) {
+}
+
+void OSTaskCreateHook(OS_TCB *ptcb) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskCreateHook(ptcb);
+#else
+  (void)ptcb;
+#endif
+}
+
+void OSTaskDelHook(OS_TCB *ptcb) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskDelHook(ptcb);
+#endif
+  host_ctx_release(OS_HOST_CTX(ptcb));
+}
+
+void OSTaskIdleHook(void) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskIdleHook();
+#endif
+  host_idle();
+}
+
+void OSTaskReturnHook(OS_TCB *ptcb) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskReturnHook(ptcb);
+#else
+  (void)ptcb;
+#endif
+}
+
+void OSTaskStatHook(void) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskStatHook();
+#endif
+}
+
+#if OS_TASK_SW_HOOK_EN > 0u
+void OSTaskSwHook(void) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskSwHook();
+#endif
+}
+#endif
+
+void OSTCBInitHook(OS_TCB *ptcb) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TCBInitHook(ptcb);
+#else
+  (void)ptcb;
+#endif
+}
+
+#if OS_TIME_TICK_HOOK_EN > 0u
+void OSTimeTickHook(void) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TimeTickHook();
+#endif
+}
+#endif
+#else
+#error "The host port needs OS_CPU_HOOKS_EN: OSTaskDelHook() frees the host context."
+#endif
@@ -0,0 +1,66 @@
+#ifndef CPU_H
+#define CPU_H
+
+/*
+ * uC/CPU port for the POSIX host: critical sections mask the interrupts
+ * emulated by host_cpu.c; stacks are host pointers, so CPU_STK is pointer
+ * sized to hold the context handle stored by OSTaskStkInit().
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cpu_def.h"
+#include "host_cpu.h"
+
+#define CPU_CFG_ADDR_SIZE               CPU_WORD_SIZE_64
+#define CPU_CFG_DATA_SIZE               CPU_WORD_SIZE_32
+#define CPU_CFG_DATA_SIZE_MAX           CPU_WORD_SIZE_64
+#define CPU_CFG_ENDIAN_TYPE             CPU_ENDIAN_TYPE_LITTLE
+#define CPU_CFG_STK_GROWTH              CPU_STK_GROWTH_HI_TO_LO
+#define CPU_CFG_STK_ALIGN_BYTES         (sizeof(CPU_STK))
+#define CPU_CFG_CRITICAL_METHOD         CPU_CRITICAL_METHOD_STATUS_LOCAL
+
+typedef void               CPU_VOID;
+typedef char               CPU_CHAR;
+typedef uint8_t            CPU_BOOLEAN;
+typedef uint8_t            CPU_INT08U;
+typedef int8_t             CPU_INT08S;
+typedef uint16_t           CPU_INT16U;
+typedef int16_t            CPU_INT16S;
+typedef uint32_t           CPU_INT32U;
+typedef int32_t            CPU_INT32S;
+typedef uint64_t           CPU_INT64U;
+typedef int64_t            CPU_INT64S;
+typedef float              CPU_FP32;
+typedef double             CPU_FP64;
+
+typedef volatile CPU_INT08U  CPU_REG08;
+typedef volatile CPU_INT16U  CPU_REG16;
+typedef volatile CPU_INT32U  CPU_REG32;
+typedef volatile CPU_INT64U  CPU_REG64;
+
+typedef void             (*CPU_FNCT_VOID)(void);
+typedef void             (*CPU_FNCT_PTR)(void *p_obj);
+
+typedef uintptr_t          CPU_ADDR;
+typedef CPU_INT32U         CPU_DATA;
+typedef CPU_DATA           CPU_ALIGN;
+typedef size_t             CPU_SIZE_T;
+
+typedef uintptr_t          CPU_STK;
+typedef CPU_ADDR           CPU_STK_SIZE;
+
+typedef CPU_INT32U         CPU_SR;
+
+#define CPU_SR_ALLOC()         CPU_SR cpu_sr = (CPU_SR)0
+#define CPU_INT_DIS()          do { cpu_sr = host_irq_disable(); } while (0)
+#define CPU_INT_EN()           do { host_irq_restore(cpu_sr); } while (0)
+#define CPU_CRITICAL_ENTER()   CPU_INT_DIS()
+#define CPU_CRITICAL_EXIT()    CPU_INT_EN()
+
+#define CPU_TYPE_CREATE(char_1, char_2, char_3, char_4) \
+  (((CPU_INT32U)((CPU_INT08U)(char_1)) << 24u) | ((CPU_INT32U)((CPU_INT08U)(char_2)) << 16u) | \
+   ((CPU_INT32U)((CPU_INT08U)(char_3)) <<  8u) |  (CPU_INT32U)((CPU_INT08U)(char_4)))
+
+#endif /* CPU_H */
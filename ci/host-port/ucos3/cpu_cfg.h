@@ -0,0 +1,16 @@
+#ifndef CPU_CFG_H
+#define CPU_CFG_H
+
+/* uC/CPU configuration for the POSIX host port. */
+
+#define CPU_CFG_NAME_EN                 DEF_DISABLED
+#define CPU_CFG_NAME_SIZE               16u
+
+#define CPU_CFG_TS_32_EN                DEF_ENABLED
+#define CPU_CFG_TS_64_EN                DEF_DISABLED
+#define CPU_CFG_TS_TMR_SIZE             CPU_WORD_SIZE_32
+
+#define CPU_CFG_LEAD_ZEROS_ASM_PRESENT
+#define CPU_CFG_TRAIL_ZEROS_ASM_PRESENT
+
+#endif /* CPU_CFG_H */
@@ -0,0 +1,42 @@
+#ifndef CPU_CORE_H
+#define CPU_CORE_H
+
+/* uC/CPU core services for the POSIX host port (see cpu_host.c). */
+
+#include <stdlib.h>
+
+#include "cpu.h"
+#include "lib_def.h"
+#include "cpu_cfg.h"
+
+#define CPU_CORE_VERSION                13103u
+
+#define CPU_CFG_TS_EN                   DEF_ENABLED
+#define CPU_CFG_TS_TMR_EN               DEF_ENABLED
+
+/* Fatal software exception: abort the host process. */
+#define CPU_SW_EXCEPTION(err_rtn_val)   do { abort(); } while (0)
+
+typedef CPU_INT32U  CPU_TS;
+typedef CPU_INT32U  CPU_TS32;
+typedef CPU_INT64U  CPU_TS64;
+typedef CPU_INT32U  CPU_TS_TMR;
+typedef CPU_INT32U  CPU_TS_TMR_FREQ;
+
+typedef enum cpu_err {
+  CPU_ERR_NONE             =    0u,
+  CPU_ERR_NULL_PTR         =   10u,
+  CPU_ERR_NAME_SIZE        = 1000u,
+  CPU_ERR_TS_FREQ_INVALID  = 2000u
+} CPU_ERR;
+
+void            CPU_Init(void);
+
+CPU_TS_TMR      CPU_TS_TmrRd(void);
+CPU_TS32        CPU_TS_Get32(void);
+CPU_TS_TMR_FREQ CPU_TS_TmrFreqGet(CPU_ERR *p_err);
+
+CPU_DATA        CPU_CntLeadZeros(CPU_DATA val);
+CPU_DATA        CPU_CntTrailZeros(CPU_DATA val);
+
+#endif /* CPU_CORE_H */
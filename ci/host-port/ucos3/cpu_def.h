@@ -0,0 +1,24 @@
+#ifndef CPU_DEF_H
+#define CPU_DEF_H
+
+/* uC/CPU definitions used by the POSIX host port. */
+
+#define CPU_WORD_SIZE_08                1u
+#define CPU_WORD_SIZE_16                2u
+#define CPU_WORD_SIZE_32                4u
+#define CPU_WORD_SIZE_64                8u
+
+#define CPU_ENDIAN_TYPE_NONE            0u
+#define CPU_ENDIAN_TYPE_BIG             1u
+#define CPU_ENDIAN_TYPE_LITTLE          2u
+
+#define CPU_STK_GROWTH_NONE             0u
+#define CPU_STK_GROWTH_LO_TO_HI         1u
+#define CPU_STK_GROWTH_HI_TO_LO         2u
+
+#define CPU_CRITICAL_METHOD_NONE        0u
+#define CPU_CRITICAL_METHOD_INT_DIS_EN  1u
+#define CPU_CRITICAL_METHOD_STATUS_STK  2u
+#define CPU_CRITICAL_METHOD_STATUS_LOCAL 3u
+
+#endif /* CPU_DEF_H */
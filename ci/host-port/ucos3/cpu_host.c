@@ -0,0 +1,29 @@
+#include <cpu_core.h>
+
+/* uC/CPU core services backed by the host runtime. */
+
+void CPU_Init(void) {
+}
+
+CPU_TS_TMR CPU_TS_TmrRd(void) {
+  return (CPU_TS_TMR)host_ts_get();
+}
+
+CPU_TS32 CPU_TS_Get32(void) {
+  return (CPU_TS32)host_ts_get();
+}
+
+CPU_TS_TMR_FREQ CPU_TS_TmrFreqGet(CPU_ERR *p_err) {
+  if (p_err != NULL) {
+    *p_err = CPU_ERR_NONE;
+  }
+  return (CPU_TS_TMR_FREQ)host_ts_freq();
+}
+
+CPU_DATA CPU_CntLeadZeros(CPU_DATA val) {
+  return (val == 0u) ? (CPU_DATA)DEF_INT_CPU_NBR_BITS : (CPU_DATA)__builtin_clz(val);
+}
+
+CPU_DATA CPU_CntTrailZeros(CPU_DATA val) {
+  return (val == 0u) ? (CPU_DATA)DEF_INT_CPU_NBR_BITS : (CPU_DATA)__builtin_ctz(val);
+}
@@ -0,0 +1,50 @@
+#ifndef LIB_DEF_H
+#define LIB_DEF_H
+
+/* Subset of uC/LIB lib_def.h used by the uC/OS-III kernel sources. */
+
+#ifndef DEF_ENABLED
+#define DEF_ENABLED          1u
+#endif
+#ifndef DEF_DISABLED
+#define DEF_DISABLED         0u
+#endif
+#ifndef DEF_TRUE
+#define DEF_TRUE             1u
+#endif
+#ifndef DEF_FALSE
+#define DEF_FALSE            0u
+#endif
+
+#define DEF_NO               0u
+#define DEF_YES              1u
+#define DEF_OFF              0u
+#define DEF_ON               1u
+#define DEF_CLR              0u
+#define DEF_SET              1u
+#define DEF_FAIL             0u
+#define DEF_OK               1u
+#define DEF_INVALID          0u
+#define DEF_VALID            1u
+
+#define DEF_NULL             ((void *)0)
+
+#define DEF_OCTET_NBR_BITS   8u
+#define DEF_INT_CPU_NBR_BITS (CPU_CFG_DATA_SIZE * DEF_OCTET_NBR_BITS)
+
+#define DEF_INT_08U_MAX_VAL  255u
+#define DEF_INT_16U_MAX_VAL  65535u
+#define DEF_INT_32U_MAX_VAL  4294967295u
+#define DEF_INT_64U_MAX_VAL  18446744073709551615u
+
+#define DEF_BIT(bit)                  (1u << (bit))
+#define DEF_BIT_SET(val, mask)        ((val) |=  (mask))
+#define DEF_BIT_CLR(val, mask)        ((val) &= ~(mask))
+#define DEF_BIT_IS_SET(val, mask)     ((((val) & (mask)) == (mask)) ? DEF_YES : DEF_NO)
+#define DEF_BIT_IS_CLR(val, mask)     ((((val) & (mask)) == 0u)     ? DEF_YES : DEF_NO)
+#define DEF_BIT_IS_SET_ANY(val, mask) ((((val) & (mask)) != 0u)     ? DEF_YES : DEF_NO)
+
+#define DEF_MIN(a, b)        (((a) < (b)) ? (a) : (b))
+#define DEF_MAX(a, b)        (((a) > (b)) ? (a) : (b))
+
+#endif /* LIB_DEF_H */
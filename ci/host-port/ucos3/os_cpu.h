@@ -0,0 +1,26 @@
+#ifndef OS_CPU_H
+#define OS_CPU_H
+
+/*
+ * uC/OS-III POSIX host port: tasks run on ucontext stacks managed by
+ * host_cpu.c and OS_TASK_SW() switches contexts directly.
+ */
+
+#include <cpu.h>
+#include <cpu_core.h>
+
+#include "host_cpu.h"
+
+#define OS_TASK_SW()         OSCtxSw()
+
+#if (CPU_CFG_TS_TMR_EN == DEF_ENABLED)
+#define OS_TS_GET()          ((CPU_TS)CPU_TS_TmrRd())
+#else
+#define OS_TS_GET()          ((CPU_TS)0u)
+#endif
+
+void OSCtxSw(void);
+void OSIntCtxSw(void);
+void OSStartHighRdy(void);
+
+#endif /* OS_CPU_H */
@@ -0,0 +1,149 @@
+#include <os.h>
+
+#include "host_cpu.h"
+
+/* The task's host context lives in the top stack word written by OSTaskStkInit(). */
+#define OS_HOST_CTX(p_tcb)  ((host_ctx_t *)(uintptr_t)*(p_tcb)->StkPtr)
+
+/* ==== Tick ==== */
+
+static void OSTickISR(void) {
+  CPU_SR_ALLOC();
+
+  CPU_CRITICAL_ENTER();
+  OSIntEnter();
+  CPU_CRITICAL_EXIT();
+
+  OSTimeTick();
+
+  OSIntExit();
+}
+
+/* ==== Context Switch ==== */
+
+void OSStartHighRdy(void) {
+  OSTaskSwHook();
+  host_irq_set_handler(HOST_IRQ_TICK, OSTickISR);
+  host_tick_start(OS_CFG_TICK_RATE_HZ);
+  host_ctx_start(OS_HOST_CTX(OSTCBHighRdyPtr));
+}
+
+void OSCtxSw(void) {
+  OS_TCB *p_from = OSTCBCurPtr;
+
+  OSTaskSwHook();
+  OSPrioCur   = OSPrioHighRdy;
+  OSTCBCurPtr = OSTCBHighRdyPtr;
+  host_ctx_switch(OS_HOST_CTX(p_from), OS_HOST_CTX(OSTCBHighRdyPtr));
+}
+
+/* Called from OSIntExit() inside the emulated ISR: the preempted task resumes
+ * there once it is switched back in. */
+void OSIntCtxSw(void) {
+  OSCtxSw();
+}
+
+/* ==== Task Stack ==== */
+
+CPU_STK *OSTaskStkInit(OS_TASK_PTR p_task, void *p_arg, CPU_STK *p_stk_base, CPU_STK *p_stk_limit,
+                       CPU_STK_SIZE stk_size, OS_OPT opt) {
+  CPU_STK *p_stk = &p_stk_base[stk_size - 1u];
+
+  (void)p_stk_limit;
+  (void)opt;
+  *p_stk = (CPU_STK)(uintptr_t)host_ctx_create(p_task, p_arg, OS_TaskReturn);
+  return p_stk;
+}
+
+/* ==== Hooks ==== */
+
+void OSIdleTaskHook(void) {
+#if OS_CFG_APP_HOOKS_EN > 0u
+  if (OS_AppIdleTaskHookPtr != (OS_APP_HOOK_VOID)0) {
+    (*OS_AppIdleTaskHookPtr)();
+  }
+#endif
+  host_idle();
+}
+
+void OSInitHook(void) {
+}
+
+#if (OS_CFG_TASK_STK_REDZONE_EN > 0u)
+void OSRedzoneHitHook(OS_TCB *p_tcb) {
+#if OS_CFG_APP_HOOKS_EN > 0u
+  if (OS_AppRedzoneHitHookPtr != (OS_APP_HOOK_TCB)0) {
+    (*OS_AppRedzoneHitHookPtr)(p_tcb);
+    return;
+  }
+#endif
+  (void)p_tcb;
+  CPU_SW_EXCEPTION(;);
+}
+#endif
+
+void OSStatTaskHook(void) {
+#if OS_CFG_APP_HOOKS_EN > 0u
+  if (OS_AppStatTaskHookPtr != (OS_APP_HOOK_VOID)0) {
+    (*OS_AppStatTaskHookPtr)();
+  }
+#endif
+}
+
+void OSTaskCreateHook(OS_TCB *p_tcb) {
+#if OS_CFG_APP_HOOKS_EN > 0u
+  if (OS_AppTaskCreateHookPtr != (OS_APP_HOOK_TCB)0) {
+    (*OS_AppTaskCreateHookPtr)(p_tcb);
+  }
+#else
+  (void)p_tcb;
+#endif
+}
+
+void OSTaskDelHook(OS_TCB *p_tcb) {
+#if OS_CFG_APP_HOOKS_EN > 0u
+  if (OS_AppTaskDelHookPtr != (OS_APP_HOOK_TCB)0) {
+    (*OS_AppTaskDelHookPtr)(p_tcb);
+  }
+#endif
+  host_ctx_release(OS_HOST_CTX(p_tcb));
+}
+
+void OSTaskReturnHook(OS_TCB *p_tcb) {
+#if OS_CFG_APP_HOOKS_EN > 0u
+  if (OS_AppTaskReturnHookPtr != (OS_APP_HOOK_TCB)0) {
+    (*OS_AppTaskReturnHookPtr)(p_tcb);
+  }
+#else
+  (void)p_tcb;
+#endif
+}
+
+void OSTaskSwHook(void) {
+#if OS_CFG_TASK_PROFILE_EN > 0u
+  CPU_TS ts;
+#endif
+
+#if OS_CFG_APP_HOOKS_EN > 0u
+  if (OS_AppTaskSwHookPtr != (OS_APP_HOOK_VOID)0) {
+    (*OS_AppTaskSwHookPtr)();
+  }
+#endif
+
+#if OS_CFG_TASK_PROFILE_EN > 0u
+  ts = OS_TS_GET();
+  if (OSTCBCurPtr != OSTCBHighRdyPtr) {
+    OSTCBCurPtr->CyclesDelta  = ts - OSTCBCurPtr->CyclesStart;
+    OSTCBCurPtr->CyclesTotal += (OS_CYCLES)OSTCBCurPtr->CyclesDelta;
+  }
+  OSTCBHighRdyPtr->CyclesStart = ts;
+#endif
+}
+
+void OSTimeTickHook(void) {
+#if OS_CFG_APP_HOOKS_EN > 0u
+  if (OS_AppTimeTickHookPtr != (OS_APP_HOOK_VOID)0) {
+    (*OS_AppTimeTickHookPtr)();
+  }
+#endif
+}
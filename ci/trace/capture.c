@@ -0,0 +1,207 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * Trace capture workload for the decoder. A producer feeds a consumer through
+ * a message queue of pointers (the only message size both ports accept) to
+ * jobs taken from a memory pool and returned by the consumer, the
+ * consumer and a worker contend for a mutex, the worker also holds the
+ * scheduler lock for a while, and a periodic interrupt wakes a handler thread
+ * through a semaphore. A low-priority drain thread streams the
+ * raw osTraceRecord_t records to stdout, the way a target would push them out
+ * over a UART; the runner stops the recording after CAPTURE_TICKS and flushes
+ * what is left.
+ */
+
+#ifndef CAPTURE_TICKS
+#define CAPTURE_TICKS   200u
+#endif
+
+#define CAPTURE_IRQ     17u
+#define CAPTURE_PERIOD  330000u      /* cycles between interrupts (3.3 ticks) */
+#define CAPTURE_CHUNK   32u
+
+#ifdef VSIM_UCOS2
+void App_TaskSwHook(void) {
+  osUcos2TaskSwHook();
+}
+
+void App_TimeTickHook(void) {
+  osUcos2TimeTickHook();
+}
+#endif
+
+static VSIM_CB(thread) runner_cb;
+static VSIM_CB(thread) producer_cb;
+static VSIM_CB(thread) consumer_cb;
+static VSIM_CB(thread) worker_cb;
+static VSIM_CB(thread) handler_cb;
+static VSIM_CB(thread) drain_cb;
+VSIM_STACK(runner_stack, 2048u);
+VSIM_STACK(producer_stack, 1024u);
+VSIM_STACK(consumer_stack, 1024u);
+VSIM_STACK(worker_stack, 1024u);
+VSIM_STACK(handler_stack, 1024u);
+VSIM_STACK(drain_stack, 2048u);
+
+static VSIM_CB(mutex)     mutex_cb;
+static VSIM_CB(semaphore) irq_sem_cb;
+VSIM_MQ_CB(mq_cb, 4u);
+static void *mq_storage[4];
+VSIM_MP_CB(pool_cb, 8u);
+static void *pool_storage[8];       /* pointer-aligned blocks of one uint32_t */
+
+static osMutexId_t        shared;
+static osSemaphoreId_t    irq_sem;
+static osMessageQueueId_t mq;
+static osMemoryPoolId_t   pool;
+
+/* ==== Interrupt ==== */
+
+static void capture_isr(void *arg) {
+  (void)arg;
+  osTraceIsrEnter(CAPTURE_IRQ);
+  vsim_charge(800u);             /* no event dispatch inside an ISR */
+  (void)osSemaphoreRelease(irq_sem);
+  osTraceIsrExit(CAPTURE_IRQ);
+  (void)vsim_isr_after(CAPTURE_PERIOD, capture_isr, NULL);
+}
+
+/* ==== Threads ==== */
+
+static void producer_thread(void *argument) {
+  (void)argument;
+  for (uint32_t seq = 0u;; ++seq) {
+    uint32_t *job = osMemoryPoolAlloc(pool, osWaitForever);
+    *job = seq;
+    vsim_consume(3000u);
+    (void)osMessageQueuePut(mq, &job, 0u, osWaitForever);
+    if ((seq % 4u) == 3u) {
+      osDelay(2u);
+    }
+  }
+}
+
+static void consumer_thread(void *argument) {
+  (void)argument;
+  uint32_t *job;
+  for (;;) {
+    if (osMessageQueueGet(mq, &job, NULL, 10u) != osOK) {
+      continue;
+    }
+    (void)osMutexAcquire(shared, osWaitForever);
+    vsim_consume(5000u);
+    (void)osMutexRelease(shared);
+    osTraceUser(1u, mq, *job);
+    (void)osMemoryPoolFree(pool, job);
+  }
+}
+
+static void worker_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    (void)osMutexAcquire(shared, osWaitForever);
+    vsim_consume(150000u);
+    (void)osMutexRelease(shared);
+
+    (void)osKernelLock();
+    vsim_consume(40000u);
+    (void)osKernelUnlock();
+    osDelay(3u);
+  }
+}
+
+static void handler_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    (void)osSemaphoreAcquire(irq_sem, osWaitForever);
+    vsim_consume(2000u);
+  }
+}
+
+static void capture_drain(void) {
+  osTraceRecord_t records[CAPTURE_CHUNK];
+  uint32_t count;
+  while ((count = osTraceRead(records, CAPTURE_CHUNK)) != 0u) {
+    (void)fwrite(records, sizeof(records[0]), count, stdout);
+  }
+}
+
+static void drain_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    capture_drain();
+    osDelay(5u);
+  }
+}
+
+static void runner_thread(void *argument) {
+  (void)argument;
+  (void)vsim_isr_after(CAPTURE_PERIOD, capture_isr, NULL);
+  osDelay(CAPTURE_TICKS);
+  osTraceStop();
+  capture_drain();
+  fflush(stdout);
+  fprintf(stderr, "[trace] " VSIM_PORT ": dropped %lu records\n", (unsigned long)osTraceGetDropped());
+  exit(osTraceGetDropped() == 0u ? 0 : 1);
+}
+
+/* ==== Setup ==== */
+
+static void capture_spawn(const char *name, VSIM_CB(thread) *cb, vsim_stk_t *stack, uint32_t stack_size,
+                          osThreadFunc_t func, osPriority_t priority) {
+  const osThreadAttr_t attr = {
+    .name       = name,
+    .cb_mem     = cb,
+    .cb_size    = sizeof(*cb),
+    .stack_mem  = stack,
+    .stack_size = stack_size,
+    .priority   = priority,
+  };
+  (void)osThreadNew(func, NULL, &attr);
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osMutexAttr_t mutex_attr = {
+    .name      = "shared",
+    .attr_bits = osMutexPrioInherit,
+    .cb_mem    = &mutex_cb,
+    .cb_size   = sizeof(mutex_cb),
+  };
+  shared = osMutexNew(&mutex_attr);
+
+  const osSemaphoreAttr_t sem_attr = { .name = "irq.sem", .cb_mem = &irq_sem_cb, .cb_size = sizeof(irq_sem_cb) };
+  irq_sem = osSemaphoreNew(8u, 0u, &sem_attr);
+
+  const osMessageQueueAttr_t mq_attr = {
+    .name    = "jobs",
+    .cb_mem  = mq_cb,
+    .cb_size = sizeof(mq_cb),
+    .mq_mem  = mq_storage,
+    .mq_size = sizeof(mq_storage),
+  };
+  mq = osMessageQueueNew(4u, sizeof(void *), &mq_attr);
+
+  const osMemoryPoolAttr_t pool_attr = {
+    .name    = "job.pool",
+    .cb_mem  = pool_cb,
+    .cb_size = sizeof(pool_cb),
+    .mp_mem  = pool_storage,
+    .mp_size = sizeof(pool_storage),
+  };
+  pool = osMemoryPoolNew(8u, sizeof(uint32_t), &pool_attr);
+
+  capture_spawn("runner", &runner_cb, runner_stack, sizeof(runner_stack), runner_thread, osPriorityRealtime);
+  capture_spawn("irq.handler", &handler_cb, handler_stack, sizeof(handler_stack), handler_thread, osPriorityHigh);
+  capture_spawn("consumer", &consumer_cb, consumer_stack, sizeof(consumer_stack), consumer_thread, osPriorityAboveNormal);
+  capture_spawn("producer", &producer_cb, producer_stack, sizeof(producer_stack), producer_thread, osPriorityNormal);
+  capture_spawn("worker", &worker_cb, worker_stack, sizeof(worker_stack), worker_thread, osPriorityBelowNormal);
+  capture_spawn("trace.drain", &drain_cb, drain_stack, sizeof(drain_stack), drain_thread, osPriorityLow);
+
+  osKernelStart();
+  return 0;
+}
@@ -0,0 +1,405 @@
+#!/usr/bin/env python3
+"""Decode a CMSIS-RTOS2 wrapper trace dump (osTraceRecord_t stream).
+
+    ci/trace/decode.py dump.bin [--ts-hz HZ] [--json out.json] [--top N]
+
+The dump is the concatenation of the 16-byte little-endian records returned
+by osTraceRead() (see cmsis_os2_ext.h), e.g. streamed over a UART or saved
+from a debugger. The decoder rebuilds the thread timeline from the Switch
+records, API call and blocking intervals per thread, interrupt activity and
+scheduler-lock / mutex hold sections, then
+
+  * writes Chrome trace-event JSON (--json), which chrome://tracing and
+    ui.perfetto.dev both open, and
+  * prints Markdown summary tables: per-thread CPU time, top blocked
+    objects, longest critical sections and interrupt load.
+
+Object and thread names come from the Name records written by the ...New
+calls; unnamed objects are shown by ID. Timestamps are converted with
+--ts-hz (default 1 MHz, i.e. one unit per microsecond).
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+RECORD = struct.Struct("<IIIHH")
+
+EVENT_API_ENTER = 0x0000
+EVENT_API_EXIT = 0x0100
+EVENT_SWITCH = 0x0200
+EVENT_BLOCK = 0x0201
+EVENT_WAKEUP = 0x0202
+EVENT_ISR_ENTER = 0x0203
+EVENT_ISR_EXIT = 0x0204
+EVENT_TICK = 0x0205
+EVENT_NAME = 0x0206
+EVENT_USER = 0x0300
+
+# osTraceApi_t, starting at 1; keep in sync with cmsis_os2_ext.h.
+API_NAMES = [
+    None,
+    "osKernelInitialize", "osKernelStart", "osKernelLock", "osKernelUnlock", "osKernelRestoreLock",
+    "osThreadNew", "osThreadSetPriority", "osThreadYield", "osThreadExit", "osThreadTerminate",
+    "osThreadSuspend", "osThreadResume", "osThreadDetach", "osThreadJoin",
+    "osDelay", "osDelayUntil",
+    "osMutexNew", "osMutexAcquire", "osMutexRelease", "osMutexDelete",
+    "osSemaphoreNew", "osSemaphoreAcquire", "osSemaphoreRelease", "osSemaphoreDelete",
+    "osTimerNew", "osTimerStart", "osTimerStop", "osTimerDelete",
+    "osEventFlagsNew", "osEventFlagsSet", "osEventFlagsClear", "osEventFlagsWait", "osEventFlagsDelete",
+    "osMessageQueueNew", "osMessageQueuePut", "osMessageQueueGet", "osMessageQueueReset",
+    "osMessageQueueDelete",
+    "osMemoryPoolNew", "osMemoryPoolAlloc", "osMemoryPoolFree", "osMemoryPoolGetCount", "osMemoryPoolDelete",
+]
+
+API = {name: code for code, name in enumerate(API_NAMES) if name}
+
+# Calls whose exit arg is not an osStatus_t.
+RESULTS = {"osEventFlagsWait": hex, "osMemoryPoolAlloc": hex, "osMemoryPoolGetCount": int}
+
+STATUS = {0: "osOK", -1: "osError", -2: "osErrorTimeout", -3: "osErrorResource",
+          -4: "osErrorParameter", -5: "osErrorNoMemory", -6: "osErrorISR"}
+
+BLOCK_REASONS = {1: "wait", 2: "delay", 3: "suspended"}
+
+PID = 1
+TID_CPU = 0
+TID_ISR = 1
+MAIN = "main"           # pseudo thread for calls made before osKernelStart
+
+
+def read_records(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    usable = len(data) - (len(data) % RECORD.size)
+    if usable != len(data):
+        print("warning: ignoring {} trailing bytes".format(len(data) - usable), file=sys.stderr)
+
+    records = []
+    epoch = 0
+    last = None
+    for offset in range(0, usable, RECORD.size):
+        ts, obj, arg, event, ctx = RECORD.unpack_from(data, offset)
+        if event == 0:
+            continue
+        # Unwrap the 32-bit timestamp; writers may be slightly out of order.
+        if last is not None and ts < last and (last - ts) > 0x80000000:
+            epoch += 1 << 32
+        elif last is not None and ts > last and (ts - last) > 0x80000000:
+            epoch -= 1 << 32
+        last = ts
+        records.append((epoch + ts, obj, arg, event, ctx))
+    records.sort(key=lambda r: r[0])
+    return records
+
+
+def collect_names(records):
+    names = {}
+    pending = {}
+    for _, obj, arg, event, _ in records:
+        if event != EVENT_NAME:
+            continue
+        chunk = pending.setdefault(obj, bytearray())
+        for shift in (0, 8, 16, 24):
+            byte = (arg >> shift) & 0xFF
+            if byte == 0:
+                names[obj] = chunk.decode("utf-8", "replace")
+                del pending[obj]
+                break
+            chunk.append(byte)
+    return names
+
+
+def signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+class Decoder:
+    def __init__(self, records, ts_hz):
+        self.records = records
+        self.ts_hz = ts_hz
+        self.names = collect_names(records)
+        self.events = []
+        self.tids = {}
+        self.t0 = records[0][0] if records else 0
+
+        self.cur = MAIN
+        self.run_start = None
+        self.stacks = {}            # track key -> open API calls
+        self.isr_stack = []
+        self.blocked = {}           # thread -> (ts, object, reason)
+
+        self.cpu = {}               # thread -> [running time, switches in]
+        self.waits = {}             # (reason, object) -> [count, total, max]
+        self.sections = {}          # (kind, thread) -> [count, total, max, start of max]
+        self.isr = {}               # irq -> [count, total, max]
+        self.lock_start = None
+        self.unlock_ts = None
+        self.mutex = {}             # object -> [depth, start, thread, release ts]
+        self.pools = {}             # object -> [allocs, failed, frees, in use, peak]
+
+    # ==== Helpers ====
+
+    def us(self, ts):
+        return (ts - self.t0) * 1e6 / self.ts_hz
+
+    def dur(self, ticks):
+        return ticks * 1e6 / self.ts_hz
+
+    def name(self, obj):
+        if obj == MAIN:
+            return MAIN
+        if obj == 0:
+            return "-"
+        return self.names.get(obj, "0x{:08x}".format(obj))
+
+    def tid(self, thread):
+        if thread not in self.tids:
+            self.tids[thread] = len(self.tids) + 2
+        return self.tids[thread]
+
+    def slice(self, tid, name, start, end, args=None, cat="api"):
+        event = {"ph": "X", "pid": PID, "tid": tid, "name": name, "cat": cat,
+                 "ts": self.us(start), "dur": max(self.us(end) - self.us(start), 0.0)}
+        if args:
+            event["args"] = args
+        self.events.append(event)
+
+    def instant(self, tid, name, ts, args=None):
+        event = {"ph": "i", "s": "t", "pid": PID, "tid": tid, "name": name, "ts": self.us(ts)}
+        if args:
+            event["args"] = args
+        self.events.append(event)
+
+    def track(self, ctx):
+        """API calls made from an ISR go to the interrupt track."""
+        if ctx > 0:
+            return TID_ISR, self.isr_stack
+        return self.tid(self.cur), self.stacks.setdefault(self.cur, [])
+
+    # ==== Record handlers ====
+
+    def on_switch(self, ts, incoming, outgoing):
+        if self.run_start is not None:
+            self.slice(TID_CPU, self.name(self.cur), self.run_start, ts, cat="sched")
+            self.cpu.setdefault(self.cur, [0, 0])[0] += ts - self.run_start
+        self.cur = incoming
+        self.run_start = ts
+        self.cpu.setdefault(incoming, [0, 0])[1] += 1
+        self.tid(incoming)
+
+        block = self.blocked.pop(incoming, None)
+        if block is not None:
+            start, obj, reason = block
+            label = BLOCK_REASONS.get(reason, "blocked")
+            title = "{} {}".format(label, self.name(obj)) if obj else label
+            self.slice(self.tid(incoming), title, start, ts, {"object": self.name(obj)}, cat="block")
+            # Delays and suspensions have no object; account them to the thread.
+            stat = self.waits.setdefault((label, obj or incoming), [0, 0, 0])
+            stat[0] += 1
+            stat[1] += ts - start
+            stat[2] = max(stat[2], ts - start)
+
+    def on_api_enter(self, ts, api, obj, arg, ctx):
+        _, stack = self.track(ctx)
+        stack.append((api, ts, obj, arg))
+        name = API_NAMES[api] if api < len(API_NAMES) else None
+        if name == "osKernelUnlock" and self.lock_start is not None:
+            self.unlock_ts = ts
+        elif name == "osKernelRestoreLock" and arg == 0 and self.lock_start is not None:
+            self.unlock_ts = ts
+        elif name == "osMutexRelease" and obj in self.mutex:
+            self.mutex[obj][3] = ts
+
+    def on_api_exit(self, ts, api, obj, result, ctx):
+        tid, stack = self.track(ctx)
+        for i in range(len(stack) - 1, -1, -1):
+            if stack[i][0] == api:
+                _, start, enter_obj, arg = stack.pop(i)
+                break
+        else:
+            return
+        name = API_NAMES[api] if api < len(API_NAMES) else "api{}".format(api)
+        status = signed(result)
+        convert = RESULTS.get(name)
+        args = {"object": self.name(obj or enter_obj), "arg": arg,
+                "result": convert(result) if convert else STATUS.get(status, result)}
+        self.slice(tid, name, start, ts, args)
+        self.sections_on_exit(name, ts, obj or enter_obj, arg, status)
+        self.pools_on_exit(name, obj or enter_obj, result)
+        if name == "osThreadTerminate" and status == 0:
+            self.stacks.pop(obj, None)
+            self.blocked.pop(obj, None)
+
+    def sections_on_exit(self, name, ts, obj, arg, status):
+        thread = self.name(self.cur)
+        if name == "osKernelLock" and status == 0 and self.lock_start is None:
+            self.lock_start = (ts, thread)
+        elif name == "osKernelRestoreLock" and arg == 1 and status == 0 and self.lock_start is None:
+            self.lock_start = (ts, thread)
+        elif name in ("osKernelUnlock", "osKernelRestoreLock") and self.unlock_ts is not None:
+            start, owner = self.lock_start
+            self.section("scheduler lock", owner, start, self.unlock_ts)
+            self.lock_start = None
+            self.unlock_ts = None
+        elif name == "osMutexAcquire" and status == 0:
+            hold = self.mutex.setdefault(obj, [0, ts, thread, None])
+            if hold[0] == 0:
+                hold[1], hold[2] = ts, thread
+            hold[0] += 1
+        elif name == "osMutexRelease" and status == 0 and obj in self.mutex:
+            hold = self.mutex[obj]
+            hold[0] -= 1
+            if hold[0] <= 0:
+                end = hold[3] if hold[3] is not None else ts
+                self.section("mutex " + self.name(obj), hold[2], hold[1], end)
+                del self.mutex[obj]
+
+    def pools_on_exit(self, name, obj, result):
+        """Blocks in use per pool, from the calls seen; osMemoryPoolGetCount resyncs."""
+        if not name.startswith("osMemoryPool") or name in ("osMemoryPoolNew", "osMemoryPoolDelete"):
+            return
+        pool = self.pools.setdefault(obj, [0, 0, 0, 0, 0])
+        if name == "osMemoryPoolAlloc":
+            if result == 0:
+                pool[1] += 1
+                return
+            pool[0] += 1
+            pool[3] += 1
+        elif name == "osMemoryPoolFree":
+            if result != 0:
+                return
+            pool[2] += 1
+            pool[3] = max(pool[3] - 1, 0)
+        else:
+            pool[3] = result
+        pool[4] = max(pool[4], pool[3])
+
+    def section(self, kind, thread, start, end):
+        stat = self.sections.setdefault((kind, thread), [0, 0, -1, 0])
+        stat[0] += 1
+        stat[1] += end - start
+        if end - start > stat[2]:
+            stat[2], stat[3] = end - start, start
+
+    def on_isr(self, ts, event, irq):
+        if event == EVENT_ISR_ENTER:
+            self.isr_stack.append(("irq", ts, irq, 0))
+            return
+        for i in range(len(self.isr_stack) - 1, -1, -1):
+            if self.isr_stack[i][0] == "irq" and self.isr_stack[i][2] == irq:
+                start = self.isr_stack.pop(i)[1]
+                break
+        else:
+            return
+        self.slice(TID_ISR, "irq {}".format(irq), start, ts, cat="isr")
+        stat = self.isr.setdefault(irq, [0, 0, 0])
+        stat[0] += 1
+        stat[1] += ts - start
+        stat[2] = max(stat[2], ts - start)
+
+    def run(self):
+        for ts, obj, arg, event, ctx in self.records:
+            kind = event & 0xFF00
+            if event == EVENT_SWITCH:
+                self.on_switch(ts, obj, arg)
+            elif event == EVENT_BLOCK:
+                self.blocked[self.cur] = (ts, obj, arg)
+            elif event == EVENT_WAKEUP:
+                tid, _ = self.track(ctx)
+                self.instant(tid, "wakeup " + self.name(obj), ts, {"waiter": self.name(arg)})
+            elif event in (EVENT_ISR_ENTER, EVENT_ISR_EXIT):
+                self.on_isr(ts, event, arg)
+            elif event == EVENT_TICK:
+                self.instant(TID_ISR, "tick", ts, {"count": arg})
+            elif event == EVENT_NAME:
+                continue
+            elif kind == EVENT_API_ENTER:
+                self.on_api_enter(ts, event & 0xFF, obj, arg, ctx)
+            elif kind == EVENT_API_EXIT:
+                self.on_api_exit(ts, event & 0xFF, obj, arg, ctx)
+            elif kind == EVENT_USER:
+                tid, _ = self.track(ctx)
+                self.instant(tid, "user {}".format(event & 0xFF), ts,
+                             {"object": self.name(obj), "arg": arg})
+        if self.records and self.run_start is not None:
+            end = self.records[-1][0]
+            self.slice(TID_CPU, self.name(self.cur), self.run_start, end, cat="sched")
+            self.cpu.setdefault(self.cur, [0, 0])[0] += end - self.run_start
+
+    # ==== Output ====
+
+    def chrome(self):
+        meta = [
+            {"ph": "M", "pid": PID, "name": "process_name", "args": {"name": "CMSIS-RTOS2"}},
+            {"ph": "M", "pid": PID, "tid": TID_CPU, "name": "thread_name", "args": {"name": "CPU"}},
+            {"ph": "M", "pid": PID, "tid": TID_ISR, "name": "thread_name", "args": {"name": "Interrupts"}},
+        ]
+        for thread, tid in self.tids.items():
+            meta.append({"ph": "M", "pid": PID, "tid": tid, "name": "thread_name",
+                         "args": {"name": self.name(thread)}})
+            meta.append({"ph": "M", "pid": PID, "tid": tid, "name": "thread_sort_index",
+                         "args": {"sort_index": tid}})
+        return {"traceEvents": meta + self.events, "displayTimeUnit": "ns"}
+
+    def summary(self, top):
+        span = (self.records[-1][0] - self.t0) if self.records else 0
+        out = ["# Trace summary", "",
+               "{} records, {:.1f} us".format(len(self.records), self.dur(span)), ""]
+
+        out += ["| thread | running (us) | share | switches in |", "| --- | ---: | ---: | ---: |"]
+        for thread, (running, switches) in sorted(self.cpu.items(), key=lambda kv: -kv[1][0]):
+            share = (100.0 * running / span) if span else 0.0
+            out.append("| {} | {:.1f} | {:.1f} % | {} |".format(self.name(thread), self.dur(running), share, switches))
+
+        out += ["", "## Top blocked objects", "",
+                "| object | kind | count | total (us) | max (us) |", "| --- | --- | ---: | ---: | ---: |"]
+        for (label, obj), (count, total, longest) in sorted(self.waits.items(), key=lambda kv: -kv[1][1])[:top]:
+            out.append("| {} | {} | {} | {:.1f} | {:.1f} |".format(
+                self.name(obj), label, count, self.dur(total), self.dur(longest)))
+
+        out += ["", "## Longest critical sections", "",
+                "| section | thread | count | max (us) | at (us) | total (us) |",
+                "| --- | --- | ---: | ---: | ---: | ---: |"]
+        for (kind, thread), (count, total, longest, start) in sorted(self.sections.items(),
+                                                                   key=lambda kv: -kv[1][2])[:top]:
+            out.append("| {} | {} | {} | {:.1f} | {:.1f} | {:.1f} |".format(
+                kind, thread, count, self.dur(longest), self.us(start), self.dur(total)))
+
+        out += ["", "## Memory pools", "",
+                "| pool | allocs | failed | frees | peak in use |", "| --- | ---: | ---: | ---: | ---: |"]
+        for obj, (allocs, failed, frees, _, peak) in sorted(self.pools.items(), key=lambda kv: -kv[1][4])[:top]:
+            out.append("| {} | {} | {} | {} | {} |".format(self.name(obj), allocs, failed, frees, peak))
+
+        out += ["", "## Interrupts", "",
+                "| irq | count | total (us) | max (us) |", "| --- | ---: | ---: | ---: |"]
+        for irq, (count, total, longest) in sorted(self.isr.items()):
+            out.append("| {} | {} | {:.1f} | {:.1f} |".format(irq, count, self.dur(total), self.dur(longest)))
+        return "\n".join(out)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("dump", help="binary osTraceRecord_t stream")
+    parser.add_argument("--ts-hz", type=float, default=1e6, help="timestamp frequency (default 1e6)")
+    parser.add_argument("--json", help="write Chrome trace-event JSON here")
+    parser.add_argument("--top", type=int, default=10, help="rows per summary table (default 10)")
+    args = parser.parse_args(argv)
+
+    records = read_records(args.dump)
+    if not records:
+        print("{}: no trace records".format(args.dump), file=sys.stderr)
+        return 1
+
+    decoder = Decoder(records, args.ts_hz)
+    decoder.run()
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump(decoder.chrome(), f)
+    print(decoder.summary(args.top))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
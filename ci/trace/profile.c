@@ -0,0 +1,159 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * Tick profiler workload. A sensor thread filters data on an interrupt that
+ * is not aligned with the tick (every 2.5 ticks) and a logger formats and
+ * checksums a record every 10 ticks; both run across tick boundaries, so the
+ * samples see them (work that starts on a tick and ends before the next one
+ * is invisible to a tick sampler). The simulator has no interrupted PC, so
+ * each function publishes its own address while it works and
+ * UCOSx_PROFILER_PC() returns it (profile_cfg.h; build with -no-pie so
+ * addresses fit in 32 bits and addr2line can resolve them). The runner prints
+ * the thread names and the samples in the text format read by
+ * ci/trace/profile.py, then stops after PROFILE_TICKS.
+ */
+
+#ifndef PROFILE_TICKS
+#define PROFILE_TICKS   2000u
+#endif
+
+#define PROFILE_CHUNK   64u
+#define PROFILE_THREADS 3u
+#define PROFILE_PERIOD  250000u      /* cycles between sensor interrupts */
+
+#ifdef VSIM_UCOS2
+void App_TimeTickHook(void) {
+  osUcos2TimeTickHook();
+}
+#endif
+
+volatile uint32_t profile_pc;
+
+static osThreadId_t profile_threads[PROFILE_THREADS];
+static uint32_t profile_thread_count;
+
+static VSIM_CB(thread) runner_cb;
+static VSIM_CB(thread) sensor_cb;
+static VSIM_CB(thread) logger_cb;
+VSIM_STACK(runner_stack, 2048u);
+
+static VSIM_CB(semaphore) data_ready_cb;
+static osSemaphoreId_t data_ready;
+VSIM_STACK(sensor_stack, 1024u);
+VSIM_STACK(logger_stack, 1024u);
+
+/* Preemption nests, so restoring the previous value hands the PC back to the
+ * thread that was interrupted. */
+static void profile_work(void (*fn)(void), uint64_t cycles) {
+  uint32_t outer = profile_pc;
+  profile_pc = (uint32_t)(uintptr_t)fn;
+  vsim_consume(cycles);
+  profile_pc = outer;
+}
+
+/* ==== Workload functions ==== */
+
+static __attribute__((noinline)) void sensor_filter(void) {
+  profile_work(sensor_filter, 60000u);         /* 24 % */
+}
+
+static __attribute__((noinline)) void logger_format(void) {
+  profile_work(logger_format, 150000u);        /* 15 % */
+}
+
+static __attribute__((noinline)) void logger_checksum(void) {
+  profile_work(logger_checksum, 50000u);       /* 5 % */
+}
+
+static void sensor_isr(void *arg) {
+  (void)arg;
+  (void)osSemaphoreRelease(data_ready);
+  (void)vsim_isr_after(PROFILE_PERIOD, sensor_isr, NULL);
+}
+
+/* ==== Threads ==== */
+
+static void sensor_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    (void)osSemaphoreAcquire(data_ready, osWaitForever);
+    sensor_filter();
+  }
+}
+
+static void logger_thread(void *argument) {
+  (void)argument;
+  uint32_t tick = osKernelGetTickCount();
+  for (;;) {
+    logger_format();
+    logger_checksum();
+    tick += 10u;
+    (void)osDelayUntil(tick);
+  }
+}
+
+static void profile_dump(void) {
+  osProfilerSample_t samples[PROFILE_CHUNK];
+  uint32_t count;
+  while ((count = osProfilerRead(samples, PROFILE_CHUNK)) != 0u) {
+    for (uint32_t i = 0u; i < count; ++i) {
+      printf("sample %lu %08lx %08lx %u %u\n", (unsigned long)samples[i].tick,
+             (unsigned long)samples[i].thread, (unsigned long)samples[i].pc,
+             (unsigned)samples[i].flags, (unsigned)samples[i].context);
+    }
+  }
+}
+
+static void runner_thread(void *argument) {
+  (void)argument;
+
+  for (uint32_t i = 0u; i < profile_thread_count; ++i) {
+    printf("thread %08lx %s\n", (unsigned long)(uint32_t)(uintptr_t)profile_threads[i],
+           osThreadGetName(profile_threads[i]));
+  }
+
+  (void)vsim_isr_after(PROFILE_PERIOD, sensor_isr, NULL);
+
+  /* Drain often enough that the ring never wraps. */
+  for (uint32_t elapsed = 0u; elapsed < PROFILE_TICKS; elapsed += 500u) {
+    osDelay(500u);
+    profile_dump();
+  }
+  osProfilerStop();
+  profile_dump();
+  fflush(stdout);
+  fprintf(stderr, "[profile] " VSIM_PORT ": dropped %lu samples\n", (unsigned long)osProfilerGetDropped());
+  exit(osProfilerGetDropped() == 0u ? 0 : 1);
+}
+
+/* ==== Setup ==== */
+
+static void profile_spawn(const char *name, VSIM_CB(thread) *cb, vsim_stk_t *stack, uint32_t stack_size,
+                          osThreadFunc_t func, osPriority_t priority) {
+  const osThreadAttr_t attr = {
+    .name       = name,
+    .cb_mem     = cb,
+    .cb_size    = sizeof(*cb),
+    .stack_mem  = stack,
+    .stack_size = stack_size,
+    .priority   = priority,
+  };
+  profile_threads[profile_thread_count++] = osThreadNew(func, NULL, &attr);
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osSemaphoreAttr_t sem_attr = { .name = "data.ready", .cb_mem = &data_ready_cb, .cb_size = sizeof(data_ready_cb) };
+  data_ready = osSemaphoreNew(4u, 0u, &sem_attr);
+
+  profile_spawn("runner", &runner_cb, runner_stack, sizeof(runner_stack), runner_thread, osPriorityRealtime);
+  profile_spawn("sensor", &sensor_cb, sensor_stack, sizeof(sensor_stack), sensor_thread, osPriorityNormal);
+  profile_spawn("logger", &logger_cb, logger_stack, sizeof(logger_stack), logger_thread, osPriorityLow);
+
+  osKernelStart();
+  return 0;
+}
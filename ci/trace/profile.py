@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Turn tick profiler samples into per-thread load and a flame graph.
+
+    ci/trace/profile.py dump.txt [--elf app.elf] [--addr2line TOOL]
+                        [--folded out.folded] [--svg out.svg] [--top N]
+
+The dump is the text an application prints from osProfilerRead() (see
+cmsis_os2_ext.h), one item per line:
+
+    thread <id-hex> <name>
+    sample <tick> <thread-hex> <pc-hex> <flags> <context>
+
+"thread" lines name CMSIS threads (e.g. from osThreadEnumerate); other
+lines are ignored. Samples taken while another interrupt was active
+(context > 0) are charged to "interrupt". With --elf, program counters are
+resolved to function names through addr2line (use --addr2line for a cross
+toolchain, e.g. arm-none-eabi-addr2line).
+
+The Markdown load table goes to stdout; --folded writes folded stacks
+(thread;function count) for flamegraph.pl or speedscope, and --svg writes a
+self-contained flame graph.
+"""
+
+import argparse
+import html
+import subprocess
+import sys
+import zlib
+
+SAMPLE_IDLE = 0x0001
+SAMPLE_KERNEL = 0x0002
+
+
+def read_dump(path):
+    names = {}
+    samples = []
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) >= 3 and fields[0] == "thread":
+                names[int(fields[1], 16)] = " ".join(fields[2:])
+            elif len(fields) == 6 and fields[0] == "sample":
+                samples.append((int(fields[1]), int(fields[2], 16), int(fields[3], 16),
+                                int(fields[4]), int(fields[5])))
+    return names, samples
+
+
+def symbolize(pcs, elf, tool):
+    """Map each PC to a function name; unresolved PCs stay hexadecimal."""
+    symbols = {pc: "0x{:08x}".format(pc) for pc in pcs}
+    if not elf or not pcs:
+        return symbols
+    ordered = sorted(pcs)
+    try:
+        out = subprocess.run([tool, "-f", "-e", elf] + ["0x{:x}".format(pc) for pc in ordered],
+                             check=True, capture_output=True, text=True).stdout.splitlines()
+    except (OSError, subprocess.CalledProcessError) as err:
+        print("warning: {} failed: {}".format(tool, err), file=sys.stderr)
+        return symbols
+    for pc, function in zip(ordered, out[0::2]):
+        if function and function != "??":
+            symbols[pc] = function
+    return symbols
+
+
+def thread_name(names, thread, flags, context):
+    if context > 0:
+        return "interrupt"
+    if flags & SAMPLE_IDLE:
+        return "idle"
+    if flags & SAMPLE_KERNEL:
+        return "kernel 0x{:08x}".format(thread)
+    return names.get(thread, "0x{:08x}".format(thread))
+
+
+def build_stacks(names, samples, symbols):
+    stacks = {}
+    for _, thread, pc, flags, context in samples:
+        frames = [thread_name(names, thread, flags, context)]
+        if pc != 0 and not flags & SAMPLE_IDLE:
+            frames.append(symbols[pc])
+        key = tuple(frames)
+        stacks[key] = stacks.get(key, 0) + 1
+    return stacks
+
+
+# ==== Output ====
+
+def summary(stacks, total, ticks, top):
+    threads = {}
+    functions = {}
+    for frames, count in stacks.items():
+        threads[frames[0]] = threads.get(frames[0], 0) + count
+        if len(frames) > 1:
+            functions[frames] = functions.get(frames, 0) + count
+
+    out = ["# Tick profile", "",
+           "{} samples over {} ticks".format(total, ticks), "",
+           "| thread | samples | load |", "| --- | ---: | ---: |"]
+    for name, count in sorted(threads.items(), key=lambda kv: -kv[1]):
+        out.append("| {} | {} | {:.1f} % |".format(name, count, 100.0 * count / total))
+
+    out += ["", "## Hot functions", "",
+            "| thread | function | samples | load |", "| --- | --- | ---: | ---: |"]
+    for frames, count in sorted(functions.items(), key=lambda kv: -kv[1])[:top]:
+        out.append("| {} | {} | {} | {:.1f} % |".format(frames[0], frames[-1], count, 100.0 * count / total))
+    return "\n".join(out)
+
+
+def folded(stacks):
+    return "".join("{} {}\n".format(";".join(frames), count) for frames, count in sorted(stacks.items()))
+
+
+def flame_svg(stacks, total, title):
+    width, row, pad = 1200, 18, 10
+    tree = {}
+    for frames, count in stacks.items():
+        node = tree
+        for frame in frames:
+            entry = node.setdefault(frame, [0, {}])
+            entry[0] += count
+            node = entry[1]
+
+    def depth(node):
+        return 1 + max((depth(child[1]) for child in node.values()), default=0)
+
+    levels = depth(tree) + 1
+    height = levels * row + 3 * pad
+    scale = (width - 2 * pad) / float(total)
+    rects = []
+
+    def emit(name, count, x, level):
+        y = height - pad - (level + 1) * row
+        w = count * scale
+        hue = zlib.crc32(name.encode()) % 60
+        label = html.escape(name)
+        tip = "{} ({} samples, {:.1f} %)".format(label, count, 100.0 * count / total)
+        text = label if w > 7 * len(name) else ""
+        rects.append('<g><title>{}</title><rect x="{:.1f}" y="{}" width="{:.1f}" height="{}" '
+                     'fill="hsl({},85%,60%)" rx="2"/><text x="{:.1f}" y="{}">{}</text></g>'.format(
+                         tip, x, y, max(w - 0.5, 0.1), row - 1, hue, x + 3, y + row - 5, text))
+
+    def walk(node, x, level):
+        for name, (count, children) in sorted(node.items()):
+            emit(name, count, x, level)
+            walk(children, x, level + 1)
+            x += count * scale
+
+    emit("all", total, pad, 0)
+    walk(tree, pad, 1)
+    return ('<svg xmlns="http://www.w3.org/2000/svg" width="{w}" height="{h}" font-family="monospace" '
+            'font-size="11">\n<text x="{p}" y="{t}" font-size="14">{title}</text>\n{body}\n</svg>\n').format(
+                w=width, h=height, p=pad, t=pad + 8, title=html.escape(title), body="\n".join(rects))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("dump", help="text dump of threads and samples")
+    parser.add_argument("--elf", help="image used to resolve program counters")
+    parser.add_argument("--addr2line", default="addr2line", help="addr2line tool (default addr2line)")
+    parser.add_argument("--folded", help="write folded stacks here")
+    parser.add_argument("--svg", help="write an SVG flame graph here")
+    parser.add_argument("--top", type=int, default=10, help="rows in the hot function table (default 10)")
+    args = parser.parse_args(argv)
+
+    names, samples = read_dump(args.dump)
+    if not samples:
+        print("{}: no samples".format(args.dump), file=sys.stderr)
+        return 1
+
+    symbols = symbolize({s[2] for s in samples if s[2] != 0}, args.elf, args.addr2line)
+    stacks = build_stacks(names, samples, symbols)
+    ticks = samples[-1][0] - samples[0][0] + 1
+
+    if args.folded:
+        with open(args.folded, "w", encoding="utf-8") as f:
+            f.write(folded(stacks))
+    if args.svg:
+        with open(args.svg, "w", encoding="utf-8") as f:
+            f.write(flame_svg(stacks, len(samples), "Tick profile: {} samples".format(len(samples))))
+    print(summary(stacks, len(samples), ticks, args.top))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,17 @@
+#ifndef PROFILE_CFG_H_
+#define PROFILE_CFG_H_
+
+/*
+ * Tick profiler PC source for profile.c, force-included into every
+ * translation unit; a target application would put the same lines in its
+ * app_cfg.h, returning the PC saved by the tick interrupt handler.
+ */
+
+#include <stdint.h>
+
+extern volatile uint32_t profile_pc;
+
+#define UCOS2_PROFILER_PC()   profile_pc
+#define UCOS3_PROFILER_PC()   profile_pc
+
+#endif /* PROFILE_CFG_H_ */
@@ -0,0 +1,106 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Capture traces and tick profiles on the simulator for both ports and decode
+# them.
+#
+#   ci/trace/run.sh [trace|profile]        (default: both)
+#
+# trace: capture.c is built with the trace recorder enabled. The raw record
+# stream is written to _trace_build/<kernel>.bin, the Chrome trace-event JSON
+# (open it in ui.perfetto.dev or chrome://tracing) to _trace_build/<kernel>.json
+# and the summary tables to _trace_build/<kernel>.md.
+#
+# profile: profile.c is built with the tick profiler enabled. The sample dump
+# is written to _trace_build/profile-<kernel>.txt, the per-thread load table
+# to profile-<kernel>.md, folded stacks to profile-<kernel>.folded and the
+# flame graph to profile-<kernel>.svg.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+TRACE_DIR="$ROOT_DIR/ci/trace"
+VSIM_DIR="$ROOT_DIR/ci/vsim"
+OUT_DIR=${OUT_DIR:-"$ROOT_DIR/_trace_build"}
+TRACE_EVENTS=${TRACE_EVENTS:-4096}
+TIMEOUT=${TIMEOUT:-60}
+
+CC=${CC:-gcc}
+CFLAGS=(
+  -std=c11 -Wall -Wextra -Werror -O1 -g
+  -D__STATIC_INLINE=static\ inline
+)
+
+MODES=("$@")
+if [[ ${#MODES[@]} -eq 0 ]]; then
+  MODES=(trace profile)
+fi
+
+# build <kernel> <source> <output> [extra flags...]
+build() {
+  local kernel="$1" src="$2" out="$3" ver="${1#ucos}"
+  shift 3
+  "$CC" "${CFLAGS[@]}" -DVSIM_UCOS"$ver" "$@" \
+    -I"$VSIM_DIR/$kernel" \
+    -I"$VSIM_DIR" \
+    -I"$VSIM_DIR/scenarios" \
+    -I"$ROOT_DIR/ci/compile-check/stubs/$kernel" \
+    -I"$ROOT_DIR/CMSIS/RTOS2/Include" \
+    -I"$ROOT_DIR/CMSIS/RTOS2/uCOS$ver/Include" \
+    "$VSIM_DIR/vsim.c" "$VSIM_DIR/vsim_os$ver.c" \
+    "$ROOT_DIR/CMSIS/RTOS2/uCOS$ver/Source/cmsis_os2_ucos$ver.c" \
+    "$TRACE_DIR/$src" \
+    -o "$out"
+}
+
+# run <name> <binary> <output>: non-zero exit when records were dropped; 124 is a timeout.
+run() {
+  local rc=0
+  timeout "$TIMEOUT" "$2" > "$3" || rc=$?
+  if [[ $rc -ne 0 ]]; then
+    echo "[trace] $1 failed (exit $rc)" >&2
+    status=1
+    return 1
+  fi
+}
+
+trace() {
+  local kernel="$1" ver="${1#ucos}"
+  echo "[trace] capture on $kernel"
+  build "$kernel" capture.c "$OUT_DIR/capture-$kernel" \
+    -DUCOS${ver}_TRACE_EN=1u -DUCOS${ver}_TRACE_EVENTS="${TRACE_EVENTS}u"
+  run "capture-$kernel" "$OUT_DIR/capture-$kernel" "$OUT_DIR/$kernel.bin" || return 0
+
+  # 100 MHz virtual clock (VSIM_CYCLES_PER_TICK at 1 kHz).
+  python3 "$TRACE_DIR/decode.py" "$OUT_DIR/$kernel.bin" --ts-hz 100000000 \
+    --json "$OUT_DIR/$kernel.json" > "$OUT_DIR/$kernel.md"
+  python3 -m json.tool "$OUT_DIR/$kernel.json" > /dev/null
+  echo "[trace] wrote $OUT_DIR/$kernel.json and $kernel.md"
+}
+
+# profile.c reports its own function addresses as the sampled PC (see
+# profile_cfg.h); -no-pie keeps them within 32 bits and resolvable by addr2line.
+profile() {
+  local kernel="$1" ver="${1#ucos}"
+  echo "[trace] profile on $kernel"
+  build "$kernel" profile.c "$OUT_DIR/profile-$kernel" -no-pie \
+    -DUCOS${ver}_PROFILER_EN=1u -include "$TRACE_DIR/profile_cfg.h"
+  run "profile-$kernel" "$OUT_DIR/profile-$kernel" "$OUT_DIR/profile-$kernel.txt" || return 0
+
+  python3 "$TRACE_DIR/profile.py" "$OUT_DIR/profile-$kernel.txt" --elf "$OUT_DIR/profile-$kernel" \
+    --folded "$OUT_DIR/profile-$kernel.folded" --svg "$OUT_DIR/profile-$kernel.svg" \
+    > "$OUT_DIR/profile-$kernel.md"
+  echo "[trace] wrote $OUT_DIR/profile-$kernel.md and profile-$kernel.svg"
+}
+
+mkdir -p "$OUT_DIR"
+status=0
+for mode in "${MODES[@]}"; do
+  if [[ "$mode" != trace && "$mode" != profile ]]; then
+    echo "[trace] unknown mode '$mode'" >&2
+    exit 1
+  fi
+  for kernel in ucos2 ucos3; do
+    "$mode" "$kernel"
+  done
+done
+
+exit $status
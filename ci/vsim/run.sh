@@ -0,0 +1,99 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build the simulator scenarios against both wrappers, run them in virtual
+# time and compare the traces with the golden files byte for byte.
+#
+#   ci/vsim/run.sh [--update] [scenario...]
+#
+# --update rewrites ci/vsim/golden/ instead of comparing. Each scenario is
+# also run twice to check that the simulation is deterministic.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+VSIM_DIR="$ROOT_DIR/ci/vsim"
+OUT_DIR=${OUT_DIR:-"$ROOT_DIR/_vsim_build"}
+HORIZON=${VSIM_HORIZON:-100}
+
+CC=${CC:-gcc}
+CFLAGS=(
+  -std=c11 -Wall -Wextra -Werror -O1 -g
+  -D__STATIC_INLINE=static\ inline
+)
+
+UPDATE=0
+if [[ "${1:-}" == "--update" ]]; then
+  UPDATE=1
+  shift
+fi
+
+SCENARIOS=("$@")
+if [[ ${#SCENARIOS[@]} -eq 0 ]]; then
+  for src in "$VSIM_DIR"/scenarios/*.c; do
+    SCENARIOS+=("$(basename "${src%.c}")")
+  done
+fi
+
+# Optional wrapper features a scenario needs, from a "vsim-features: NAME..."
+# line in its source; each NAME builds with UCOSx_NAME_EN=1u, NAME=VALUE with
+# UCOSx_NAME=VALUE, and VSIM_* simulator switches are defined as they are.
+features() {
+  sed -n 's/^.*vsim-features:[[:space:]]*//p' "$VSIM_DIR/scenarios/$1.c" | head -n 1
+}
+
+# build <kernel> <scenario>
+build() {
+  local kernel="$1" scenario="$2" ver="${1#ucos}" feature
+  local flags=()
+  for feature in $(features "$scenario"); do
+    case "$feature" in
+      VSIM_*) flags+=(-D"$feature") ;;
+      *=*)    flags+=(-DUCOS"$ver"_"$feature") ;;
+      *)      flags+=(-DUCOS"$ver"_"$feature"_EN=1u) ;;
+    esac
+  done
+  # Simulator headers first; os_trace.h comes from the compile-check stubs.
+  "$CC" "${CFLAGS[@]}" -DVSIM_UCOS"$ver" ${flags[@]+"${flags[@]}"} \
+    -I"$VSIM_DIR/$kernel" \
+    -I"$VSIM_DIR" \
+    -I"$VSIM_DIR/scenarios" \
+    -I"$ROOT_DIR/ci/compile-check/stubs/$kernel" \
+    -I"$ROOT_DIR/CMSIS/RTOS2/Include" \
+    -I"$ROOT_DIR/CMSIS/RTOS2/uCOS$ver/Include" \
+    "$VSIM_DIR/vsim.c" \
+    "$VSIM_DIR/vsim_os$ver.c" \
+    "$ROOT_DIR/CMSIS/RTOS2/uCOS$ver/Source/cmsis_os2_ucos$ver.c" \
+    "$VSIM_DIR/scenarios/$scenario.c" \
+    -o "$OUT_DIR/$scenario-$kernel"
+}
+
+mkdir -p "$OUT_DIR"
+failed=0
+for scenario in "${SCENARIOS[@]}"; do
+  for kernel in ucos2 ucos3; do
+    name="$scenario-$kernel"
+    build "$kernel" "$scenario"
+    VSIM_HORIZON="$HORIZON" VSIM_TRACE=1 "$OUT_DIR/$name" > "$OUT_DIR/$name.log"
+    VSIM_HORIZON="$HORIZON" VSIM_TRACE=1 "$OUT_DIR/$name" > "$OUT_DIR/$name.rerun.log"
+    if ! cmp -s "$OUT_DIR/$name.log" "$OUT_DIR/$name.rerun.log"; then
+      echo "[vsim] $name: two runs differ (non-deterministic)"
+      failed=1
+      continue
+    fi
+
+    golden="$VSIM_DIR/golden/$name.log"
+    if [[ $UPDATE -eq 1 ]]; then
+      cp "$OUT_DIR/$name.log" "$golden"
+      echo "[vsim] $name: golden updated"
+    elif [[ ! -f "$golden" ]]; then
+      echo "[vsim] $name: missing $golden (run with --update)"
+      failed=1
+    elif ! diff -u "$golden" "$OUT_DIR/$name.log"; then
+      echo "[vsim] $name: trace differs from golden"
+      failed=1
+    else
+      echo "[vsim] $name: OK"
+    fi
+  done
+done
+
+exit $failed
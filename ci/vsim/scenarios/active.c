@@ -0,0 +1,188 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * Active object and time events. Three time events are armed for the same
+ * object: a one-shot the handler re-arms once, and two periodic ones that
+ * expire together with it or with each other, so the handler sees the events
+ * of one tick in armed-list order (the list is pushed at its head). One
+ * periodic event is then disarmed, disarming the expired one-shot fails, and
+ * re-arming the other restarts its count. With the handler blocked, posts
+ * fill the queue and the next one is dropped. Dynamic events return to their
+ * pool once every reference is gone, including an event posted twice. Last,
+ * the object is deleted while its handler blocks on a dynamic event with
+ * another one queued: both go back to the pool and its time event is
+ * disarmed.
+ *
+ * vsim-features: ACTIVE
+ */
+
+#define SIG_BLOCK         10u        /* handler waits on the gate */
+#define SIG_FILL          11u
+#define SIG_DYNAMIC       12u
+
+#if defined(VSIM_UCOS3)
+#define ACTIVE_QUEUE      UCOS3_ACTIVE_QUEUE
+#else
+#define ACTIVE_QUEUE      UCOS2_ACTIVE_QUEUE
+void App_TimeTickHook(void) {
+  osUcos2TimeTickHook();
+}
+#endif
+
+#define EVENT_WORDS       ((sizeof(osEvent_t) + sizeof(void *) - 1u) / sizeof(void *))
+#define EVENT_BLOCKS      4u
+
+static VSIM_CB(thread) main_cb;
+VSIM_STACK(main_stack, 2048u);
+static VSIM_CB(active) ao_cb;
+VSIM_STACK(ao_stack, 2048u);
+
+static VSIM_CB(semaphore) gate_cb;
+VSIM_MP_CB(pool_cb, EVENT_BLOCKS);
+static void *pool_storage[EVENT_BLOCKS * EVENT_WORDS];
+
+static osActiveId_t     ao;
+static osSemaphoreId_t  gate;
+static osMemoryPoolId_t pool;
+static osTimeEvent_t    te[3];
+static uint32_t         rearmed;
+
+/* ==== Helpers ==== */
+
+static void active_stats(void) {
+  osActiveStats_t stats;
+  osStatus_t status = osActiveGetStats(ao, &stats);
+  VSIM_LOG("stats status=%d posted=%lu dispatched=%lu dropped=%lu max_queued=%lu", (int)status,
+           (unsigned long)stats.posted, (unsigned long)stats.dispatched, (unsigned long)stats.dropped,
+           (unsigned long)stats.max_queued);
+}
+
+static void pool_used(const char *what) {
+  VSIM_LOG("%s: pool used=%lu", what, (unsigned long)osMemoryPoolGetCount(pool));
+}
+
+/* ==== Handler ==== */
+
+static void active_handler(osActiveId_t id, const osEvent_t *event, void *argument) {
+  (void)id;
+  (void)argument;
+  unsigned long long tick = (unsigned long long)vsim_ticks();
+  VSIM_LOG("tick %llu signal %lu%s", tick, (unsigned long)event->signal,
+           (event->buf.pool != NULL) ? " dynamic" : "");
+
+  if ((event->signal == 0u) && (rearmed++ == 0u)) {
+    osStatus_t status = osTimeEventArm(&te[0], 2u, 0u);
+    VSIM_LOG("re-arm 0 status=%d", (int)status);
+  } else if (event->signal == SIG_BLOCK) {
+    (void)osSemaphoreAcquire(gate, osWaitForever);
+  }
+}
+
+/* ==== Threads ==== */
+
+static void main_thread(void *argument) {
+  (void)argument;
+  osStatus_t status;
+
+  /* One-shot 0 at tick 3, periodic 1 every 2 and 2 every 3 ticks. */
+  for (uint32_t i = 0u; i < 3u; ++i) {
+    const osTimeEvent_t init = osTimeEventInitializer(i, ao);
+    te[i] = init;
+  }
+  (void)osTimeEventArm(&te[0], 3u, 0u);
+  (void)osTimeEventArm(&te[1], 2u, 2u);
+  (void)osTimeEventArm(&te[2], 3u, 3u);
+  osDelay(8u);
+  status = osTimeEventDisarm(&te[1]);
+  VSIM_LOG("disarm 1 status=%d", (int)status);
+  status = osTimeEventDisarm(&te[0]);
+  VSIM_LOG("disarm 0 status=%d", (int)status);
+  status = osTimeEventArm(&te[2], 1u, 1u);
+  VSIM_LOG("re-arm 2 status=%d", (int)status);
+  osDelay(3u);
+  status = osTimeEventDisarm(&te[2]);
+  VSIM_LOG("disarm 2 status=%d", (int)status);
+  active_stats();
+
+  /* The handler blocks on the first event; the rest fill the queue. */
+  static osEvent_t block = osEventStatic(SIG_BLOCK);
+  static osEvent_t fill = osEventStatic(SIG_FILL);
+  (void)osActivePost(ao, &block);
+  for (uint32_t i = 0u; i <= ACTIVE_QUEUE; ++i) {
+    status = osActivePost(ao, &fill);
+    if (status != osOK) {
+      VSIM_LOG("post %lu of %lu status=%d", (unsigned long)(i + 1u), (unsigned long)ACTIVE_QUEUE + 1u,
+               (int)status);
+    }
+  }
+  (void)osSemaphoreRelease(gate);
+  active_stats();
+
+  /* The queue's references go after the handler, the sender's with osEventRelease. */
+  osEvent_t *event = osEventNew(pool, SIG_DYNAMIC, 0u);
+  (void)osActivePost(ao, event);
+  (void)osActivePost(ao, event);
+  pool_used("dynamic event handled twice");
+  status = osEventRelease(event);
+  VSIM_LOG("release status=%d", (int)status);
+  pool_used("sender released");
+
+  /* Delete with the handler blocked on one dynamic event and another queued. */
+  osEvent_t *blocked = osEventNew(pool, SIG_BLOCK, 0u);
+  osEvent_t *queued = osEventNew(pool, SIG_DYNAMIC, 0u);
+  (void)osActivePost(ao, blocked);
+  (void)osActivePost(ao, queued);
+  (void)osEventRelease(blocked);
+  (void)osEventRelease(queued);
+  (void)osTimeEventArm(&te[1], 5u, 5u);
+  pool_used("handler blocked");
+  status = osActiveDelete(ao);
+  VSIM_LOG("delete status=%d", (int)status);
+  pool_used("deleted");
+  status = osTimeEventDisarm(&te[1]);
+  VSIM_LOG("disarm 1 status=%d", (int)status);
+  exit(0);
+}
+
+/* ==== Setup ==== */
+
+int main(void) {
+  osKernelInitialize();
+
+  const osSemaphoreAttr_t gate_attr = { .name = "gate", .cb_mem = &gate_cb, .cb_size = sizeof(gate_cb) };
+  gate = osSemaphoreNew(1u, 0u, &gate_attr);
+  const osMemoryPoolAttr_t pool_attr = {
+    .name    = "events",
+    .cb_mem  = pool_cb,
+    .cb_size = sizeof(pool_cb),
+    .mp_mem  = pool_storage,
+    .mp_size = sizeof(pool_storage),
+  };
+  pool = osMemoryPoolNew(EVENT_BLOCKS, sizeof(osEvent_t), &pool_attr);
+
+  const osActiveAttr_t ao_attr = {
+    .name       = "ao",
+    .priority   = osPriorityHigh,
+    .cb_mem     = &ao_cb,
+    .cb_size    = sizeof(ao_cb),
+    .stack_mem  = ao_stack,
+    .stack_size = sizeof(ao_stack),
+  };
+  ao = osActiveNew(active_handler, NULL, &ao_attr);
+
+  const osThreadAttr_t main_attr = {
+    .name       = "main",
+    .cb_mem     = &main_cb,
+    .cb_size    = sizeof(main_cb),
+    .stack_mem  = main_stack,
+    .stack_size = sizeof(main_stack),
+    .priority   = osPriorityNormal,
+  };
+  osThreadNew(main_thread, NULL, &main_attr);
+
+  osKernelStart();
+  return 0;
+}
@@ -0,0 +1,140 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * CPU usage accounting over a 40-tick window of four slots. A busy thread
+ * works half of every tick and a light one a fifth of every other tick; the
+ * monitor samples them before the first slot completes (no window yet, every
+ * load zero) and again once the window is full, with an ISR firing during
+ * the walk, which now runs with interrupts enabled. The cycles, switches and
+ * loads of osKernelGetCpuUsage must match osThreadGetCpuUsage, and the loads
+ * add up with idle and kernel to at most 100 %.
+ *
+ * vsim-features: CPU_USAGE CPU_USAGE_WINDOW_TICKS=40u
+ */
+
+#define BUSY_WORK         50000u     /* cycles per tick */
+#define LIGHT_WORK        40000u     /* cycles per two ticks */
+#define SAMPLE_TICKS      45u        /* past the end of the first window */
+#define SAMPLE_IRQ_AT     200u       /* cycles into osKernelGetCpuUsage: during the walk */
+
+#ifdef VSIM_UCOS2
+void App_TaskSwHook(void) {
+  osUcos2TaskSwHook();
+}
+
+void App_TimeTickHook(void) {
+  osUcos2TimeTickHook();
+}
+#endif
+
+static VSIM_CB(thread) monitor_cb;
+static VSIM_CB(thread) busy_cb;
+static VSIM_CB(thread) light_cb;
+VSIM_STACK(monitor_stack, 2048u);
+VSIM_STACK(busy_stack, 1024u);
+VSIM_STACK(light_stack, 1024u);
+
+static osThreadId_t monitor;
+static osThreadId_t busy;
+static osThreadId_t light;
+
+/* ==== Helpers ==== */
+
+static const char *cpu_thread(osThreadId_t id) {
+  if (id == monitor) {
+    return "monitor";
+  }
+  return (id == busy) ? "busy" : ((id == light) ? "light" : "?");
+}
+
+static void cpu_sample(const char *what) {
+  osThreadCpuUsageInfo_t info[4];
+  osCpuUsageSummary_t summary;
+  unsigned long long tick = (unsigned long long)vsim_ticks();
+  uint32_t count = osKernelGetCpuUsage(info, 4u, &summary);
+  VSIM_LOG("%s at tick %llu: %lu threads window=%llu idle=%lu kernel=%lu", what, tick, (unsigned long)count,
+           (unsigned long long)summary.window_cycles, (unsigned long)summary.idle_usage,
+           (unsigned long)summary.kernel_usage);
+
+  uint32_t total = summary.idle_usage + summary.kernel_usage;
+  for (uint32_t i = 0u; i < count; ++i) {
+    const osThreadCpuUsage_t *usage = &info[i].usage;
+    VSIM_LOG("  %s cycles=%llu switches=%lu usage=%lu", cpu_thread(info[i].thread_id),
+             (unsigned long long)usage->cycles, (unsigned long)usage->switches, (unsigned long)usage->usage);
+    total += usage->usage;
+
+    /* The caller's own cycles keep running between the two reads. */
+    osThreadCpuUsage_t single;
+    osStatus_t status = osThreadGetCpuUsage(info[i].thread_id, &single);
+    if ((status != osOK) || (single.switches != usage->switches) || (single.usage != usage->usage) ||
+        ((info[i].thread_id != monitor) && (single.cycles != usage->cycles))) {
+      VSIM_LOG("  %s differs from osThreadGetCpuUsage status=%d", cpu_thread(info[i].thread_id), (int)status);
+    }
+  }
+  VSIM_LOG("  total=%lu%s", (unsigned long)total, (total > osCpuUsageScale) ? " over scale" : "");
+}
+
+/* ==== Interrupts ==== */
+
+static void sample_isr(void *arg) {
+  (void)arg;
+  VSIM_LOG("isr");
+}
+
+/* ==== Threads ==== */
+
+static void busy_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    vsim_consume(BUSY_WORK);
+    osDelay(1u);
+  }
+}
+
+static void light_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    vsim_consume(LIGHT_WORK);
+    osDelay(2u);
+  }
+}
+
+static void monitor_thread(void *argument) {
+  (void)argument;
+  osDelay(1u);
+  cpu_sample("first slot");
+
+  osDelay(SAMPLE_TICKS);
+  (void)vsim_isr_at(vsim_now() + SAMPLE_IRQ_AT, sample_isr, NULL);
+  cpu_sample("window");
+  exit(0);
+}
+
+/* ==== Setup ==== */
+
+static osThreadId_t cpu_spawn(const char *name, VSIM_CB(thread) *cb, vsim_stk_t *stack, uint32_t stack_size,
+                              osThreadFunc_t func, osPriority_t priority) {
+  const osThreadAttr_t attr = {
+    .name       = name,
+    .cb_mem     = cb,
+    .cb_size    = sizeof(*cb),
+    .stack_mem  = stack,
+    .stack_size = stack_size,
+    .priority   = priority,
+  };
+  return osThreadNew(func, NULL, &attr);
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  monitor = cpu_spawn("monitor", &monitor_cb, monitor_stack, sizeof(monitor_stack), monitor_thread, osPriorityHigh);
+  busy = cpu_spawn("busy", &busy_cb, busy_stack, sizeof(busy_stack), busy_thread, osPriorityNormal);
+  light = cpu_spawn("light", &light_cb, light_stack, sizeof(light_stack), light_thread, osPriorityBelowNormal);
+
+  osKernelStart();
+  return 0;
+}
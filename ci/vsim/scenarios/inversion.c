@@ -0,0 +1,142 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * Priority inversion statistics. A low priority thread holds a mutex through
+ * a long computation; a medium priority thread preempts it on the first
+ * tick, and on the second a high priority thread blocks on the mutex. On
+ * uC/OS-III the holder inherits the waiter's priority and finishes ahead of
+ * the medium thread (inherited=1); on uC/OS-II (no priority ceiling) the
+ * medium thread keeps running and the wait grows by the rest of its work.
+ * The high thread then waits on a counting semaphore the low thread
+ * releases, which is not an inversion and records nothing.
+ *
+ * vsim-features: INVERSION
+ */
+
+#define LOW_HOLD          250000u    /* cycles of work under the mutex */
+#define MEDIUM_WORK       150000u
+
+#ifdef VSIM_UCOS2
+void App_TimeTickHook(void) {
+}
+#endif
+
+static VSIM_CB(thread) high_cb;
+static VSIM_CB(thread) medium_cb;
+static VSIM_CB(thread) low_cb;
+VSIM_STACK(high_stack, 2048u);
+VSIM_STACK(medium_stack, 1024u);
+VSIM_STACK(low_stack, 1024u);
+
+static VSIM_CB(mutex)     mutex_cb;
+static VSIM_CB(semaphore) count_cb;
+
+static osMutexId_t     mutex;
+static osSemaphoreId_t count;
+static osThreadId_t    high;
+static osThreadId_t    low;
+
+/* ==== Helpers ==== */
+
+static const char *inversion_thread(osThreadId_t id) {
+  if (id == NULL) {
+    return "-";
+  }
+  return (id == high) ? "high" : ((id == low) ? "low" : "?");
+}
+
+static void inversion_log(const char *what, osStatus_t status, const osInversionStats_t *stats) {
+  VSIM_LOG("%s status=%d count=%lu inherited=%lu total=%llu worst=%lu worst_inherited=%lu waiter=%s holder=%s",
+           what, (int)status, (unsigned long)stats->count, (unsigned long)stats->inherited,
+           (unsigned long long)stats->total_cycles, (unsigned long)stats->worst_cycles,
+           (unsigned long)stats->worst_inherited, inversion_thread(stats->worst_waiter),
+           inversion_thread(stats->worst_holder));
+}
+
+/* ==== Threads ==== */
+
+static void low_thread(void *argument) {
+  (void)argument;
+  (void)osMutexAcquire(mutex, osWaitForever);
+  VSIM_LOG("low holds the mutex");
+  vsim_consume(LOW_HOLD);
+  VSIM_LOG("low releases the mutex");
+  (void)osMutexRelease(mutex);
+
+  osDelay(1u);
+  VSIM_LOG("low releases the counting semaphore");
+  (void)osSemaphoreRelease(count);
+  for (;;) {
+    osDelay(1000u);
+  }
+}
+
+static void medium_thread(void *argument) {
+  (void)argument;
+  osDelay(1u);
+  VSIM_LOG("medium runs");
+  vsim_consume(MEDIUM_WORK);
+  VSIM_LOG("medium done");
+  for (;;) {
+    osDelay(1000u);
+  }
+}
+
+static void high_thread(void *argument) {
+  (void)argument;
+  osInversionStats_t stats;
+  osStatus_t status;
+
+  osDelay(2u);
+  VSIM_LOG("high waits for the mutex");
+  (void)osMutexAcquire(mutex, osWaitForever);
+  VSIM_LOG("high holds the mutex");
+  (void)osMutexRelease(mutex);
+  status = osMutexGetInversionStats(mutex, &stats);
+  inversion_log("mutex", status, &stats);
+
+  VSIM_LOG("high waits for the counting semaphore");
+  (void)osSemaphoreAcquire(count, osWaitForever);
+  status = osSemaphoreGetInversionStats(count, &stats);
+  inversion_log("counting semaphore", status, &stats);
+  exit(0);
+}
+
+/* ==== Setup ==== */
+
+static osThreadId_t inversion_spawn(const char *name, VSIM_CB(thread) *cb, vsim_stk_t *stack, uint32_t stack_size,
+                                    osThreadFunc_t func, osPriority_t priority) {
+  const osThreadAttr_t attr = {
+    .name       = name,
+    .cb_mem     = cb,
+    .cb_size    = sizeof(*cb),
+    .stack_mem  = stack,
+    .stack_size = stack_size,
+    .priority   = priority,
+  };
+  return osThreadNew(func, NULL, &attr);
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osMutexAttr_t mutex_attr = {
+    .name      = "mutex",
+    .attr_bits = osMutexPrioInherit,
+    .cb_mem    = &mutex_cb,
+    .cb_size   = sizeof(mutex_cb),
+  };
+  mutex = osMutexNew(&mutex_attr);
+  const osSemaphoreAttr_t count_attr = { .name = "count", .cb_mem = &count_cb, .cb_size = sizeof(count_cb) };
+  count = osSemaphoreNew(2u, 0u, &count_attr);
+
+  high = inversion_spawn("high", &high_cb, high_stack, sizeof(high_stack), high_thread, osPriorityHigh);
+  (void)inversion_spawn("medium", &medium_cb, medium_stack, sizeof(medium_stack), medium_thread, osPriorityNormal);
+  low = inversion_spawn("low", &low_cb, low_stack, sizeof(low_stack), low_thread, osPriorityLow);
+
+  osKernelStart();
+  return 0;
+}
@@ -0,0 +1,123 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * Memory pool free stack. Freeing a block twice is refused with
+ * osErrorResource, both while other blocks are in use and once the pool is
+ * empty, and leaves the stack intact. With atomic points an ISR runs between
+ * the load of the stack head in a thread's osMemoryPoolAlloc and its
+ * compare-and-swap: it takes the head block and the one below, then returns
+ * the head block, so the head index is the same again but its next link is
+ * not (ABA). The thread's CAS must fail on the tag and retry, and every block
+ * must be handed out once. Blocks are logged by index.
+ *
+ * vsim-features: VSIM_ATOMIC_POINTS
+ */
+
+#define POOL_BLOCKS       4u
+#define POOL_RACE_AT      0u         /* cycles into osMemoryPoolAlloc: due at the CAS of the pop */
+
+#ifdef VSIM_UCOS2
+void App_TimeTickHook(void) {
+}
+#endif
+
+static VSIM_CB(thread) owner_cb;
+VSIM_STACK(owner_stack, 2048u);
+
+VSIM_MP_CB(pool_cb, POOL_BLOCKS);
+static void *pool_storage[POOL_BLOCKS * 2u];
+
+static osMemoryPoolId_t pool;
+
+/* ==== Helpers ==== */
+
+static long pool_index(const void *block) {
+  if (block == NULL) {
+    return -1;
+  }
+  return (long)(((const uint8_t *)block - (const uint8_t *)pool_storage) / (2u * sizeof(void *)));
+}
+
+static void *pool_alloc(const char *who) {
+  void *block = osMemoryPoolAlloc(pool, 0u);
+  VSIM_LOG("%s alloc -> %ld used=%lu", who, pool_index(block), (unsigned long)osMemoryPoolGetCount(pool));
+  return block;
+}
+
+static void pool_free(const char *who, void *block) {
+  osStatus_t status = osMemoryPoolFree(pool, block);
+  VSIM_LOG("%s free %ld status=%d used=%lu", who, pool_index(block), (int)status,
+           (unsigned long)osMemoryPoolGetCount(pool));
+}
+
+/* ==== Interrupts ==== */
+
+static void aba_isr(void *arg) {
+  (void)arg;
+  void *head = pool_alloc("isr");
+  (void)pool_alloc("isr");
+  pool_free("isr", head);
+}
+
+/* ==== Threads ==== */
+
+static void owner_thread(void *argument) {
+  (void)argument;
+
+  /* Double frees: one while another block is out, one with the pool empty. */
+  void *a = pool_alloc("thread");
+  void *b = pool_alloc("thread");
+  pool_free("thread", b);
+  pool_free("thread", b);
+  pool_free("thread", a);
+  pool_free("thread", a);
+
+  /* ABA under the thread's pop; the ISR keeps the second block. */
+  (void)vsim_isr_at(vsim_now() + POOL_RACE_AT, aba_isr, NULL);
+  void *held[POOL_BLOCKS];
+  uint32_t count = 0u;
+  while ((count < POOL_BLOCKS) && ((held[count] = pool_alloc("thread")) != NULL)) {
+    count++;
+  }
+  for (uint32_t i = 0u; i < count; ++i) {
+    for (uint32_t j = i + 1u; j < count; ++j) {
+      if (held[i] == held[j]) {
+        VSIM_LOG("block %ld handed out twice", pool_index(held[i]));
+      }
+    }
+  }
+  VSIM_LOG("thread holds %lu blocks, pool used=%lu", (unsigned long)count,
+           (unsigned long)osMemoryPoolGetCount(pool));
+  exit(0);
+}
+
+/* ==== Setup ==== */
+
+int main(void) {
+  osKernelInitialize();
+
+  const osMemoryPoolAttr_t pool_attr = {
+    .name    = "pool",
+    .cb_mem  = pool_cb,
+    .cb_size = sizeof(pool_cb),
+    .mp_mem  = pool_storage,
+    .mp_size = sizeof(pool_storage),
+  };
+  pool = osMemoryPoolNew(POOL_BLOCKS, 2u * sizeof(void *), &pool_attr);
+
+  const osThreadAttr_t owner_attr = {
+    .name       = "owner",
+    .cb_mem     = &owner_cb,
+    .cb_size    = sizeof(owner_cb),
+    .stack_mem  = owner_stack,
+    .stack_size = sizeof(owner_stack),
+    .priority   = osPriorityNormal,
+  };
+  osThreadNew(owner_thread, NULL, &owner_attr);
+
+  osKernelStart();
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include "vsim_app.h"
+
+/*
+ * Message queue paths: blocking puts from a producer thread, a consumer that
+ * periodically falls behind so the queue fills up, and ISR puts injected at
+ * fixed virtual timestamps (one of them lands while the queue is full).
+ */
+
+#define MSGQ_DEPTH      4u
+#define MSGQ_ISR_COUNT  4u
+
+typedef struct {
+  uint32_t value;
+  uint64_t stamp;
+} msgq_msg_t;
+
+static VSIM_CB(thread) producer_cb;
+static VSIM_CB(thread) consumer_cb;
+VSIM_STACK(producer_stack, 1024u);
+VSIM_STACK(consumer_stack, 1024u);
+
+VSIM_MQ_CB(mq_cb, MSGQ_DEPTH);
+static void *mq_storage[MSGQ_DEPTH];
+static osMessageQueueId_t mq;
+
+static msgq_msg_t thread_msgs[16];
+static msgq_msg_t isr_msgs[MSGQ_ISR_COUNT];
+
+/* Injection times in cycles (VSIM_CYCLES_PER_TICK = 100000). */
+static const uint64_t isr_at[MSGQ_ISR_COUNT] = { 250000u, 250001u, 1234567u, 2050000u };
+
+static void msgq_isr(void *arg) {
+  msgq_msg_t *msg = (msgq_msg_t *)arg;
+  msg->stamp = vsim_now();
+  osStatus_t status = osMessageQueuePut(mq, &msg, 0u, 0u);
+  VSIM_LOG("isr put v=%lu status=%d", (unsigned long)msg->value, (int)status);
+}
+
+static void producer_thread(void *argument) {
+  (void)argument;
+  uint32_t next = 0u;
+  for (;;) {
+    for (uint32_t i = 0u; i < 3u; ++i) {
+      msgq_msg_t *msg = &thread_msgs[next++ % 16u];
+      msg->value = next;
+      msg->stamp = vsim_now();
+      osStatus_t status;
+      uint64_t cost;
+      VSIM_COST(status = osMessageQueuePut(mq, &msg, 0u, osWaitForever), cost);
+      VSIM_LOG("put v=%lu status=%d cycles=%llu count=%lu", (unsigned long)msg->value, (int)status,
+               (unsigned long long)cost, (unsigned long)osMessageQueueGetCount(mq));
+    }
+    osDelay(7u);
+  }
+}
+
+static void consumer_thread(void *argument) {
+  (void)argument;
+  uint32_t received = 0u;
+  for (;;) {
+    msgq_msg_t *msg = NULL;
+    osStatus_t status = osMessageQueueGet(mq, &msg, NULL, 20u);
+    if (status != osOK) {
+      VSIM_LOG("get status=%d", (int)status);
+      continue;
+    }
+    VSIM_LOG("get v=%lu latency=%llu", (unsigned long)msg->value,
+             (unsigned long long)(vsim_now() - msg->stamp));
+    vsim_consume(5000u);
+    if ((++received % 5u) == 0u) {
+      osDelay(30u);
+    }
+  }
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osMessageQueueAttr_t mq_attr = {
+    .name    = "msgq",
+    .cb_mem  = mq_cb,
+    .cb_size = sizeof(mq_cb),
+    .mq_mem  = mq_storage,
+    .mq_size = sizeof(mq_storage),
+  };
+  mq = osMessageQueueNew(MSGQ_DEPTH, sizeof(void *), &mq_attr);
+
+  const osThreadAttr_t producer_attr = {
+    .name       = "producer",
+    .cb_mem     = &producer_cb,
+    .cb_size    = sizeof(producer_cb),
+    .stack_mem  = producer_stack,
+    .stack_size = sizeof(producer_stack),
+    .priority   = osPriorityNormal,
+  };
+  const osThreadAttr_t consumer_attr = {
+    .name       = "consumer",
+    .cb_mem     = &consumer_cb,
+    .cb_size    = sizeof(consumer_cb),
+    .stack_mem  = consumer_stack,
+    .stack_size = sizeof(consumer_stack),
+    .priority   = osPriorityAboveNormal,
+  };
+  osThreadNew(producer_thread, NULL, &producer_attr);
+  osThreadNew(consumer_thread, NULL, &consumer_attr);
+
+  for (uint32_t i = 0u; i < MSGQ_ISR_COUNT; ++i) {
+    isr_msgs[i].value = 1000u + i;
+    vsim_isr_at(isr_at[i], msgq_isr, &isr_msgs[i]);
+  }
+
+  osKernelStart();
+  return 0;
+}
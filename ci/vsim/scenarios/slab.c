@@ -0,0 +1,164 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * Slab allocator paths: requests land in the smallest class that fits, an
+ * empty class overflows into a larger one (osSlabOverflow), requests larger
+ * than every class and frees of foreign addresses fail, and a thread blocked
+ * on an empty class is woken by a free from an ISR. Blocks are logged as
+ * class:index so the trace does not depend on link addresses.
+ */
+
+#define SLAB_FREE_AT    250000u      /* cycles: the ISR frees the small block the waiter needs */
+
+#ifdef VSIM_UCOS2
+void App_TimeTickHook(void) {
+}
+#endif
+
+static VSIM_CB(thread) owner_cb;
+static VSIM_CB(thread) waiter_cb;
+VSIM_STACK(owner_stack, 2048u);
+VSIM_STACK(waiter_stack, 1024u);
+
+static VSIM_CB(slab) slab_cb;
+VSIM_MP_CB(small_cb, 2u);
+VSIM_MP_CB(medium_cb, 2u);
+VSIM_MP_CB(large_cb, 1u);
+static uint64_t small_storage[2u * 4u];
+static uint64_t medium_storage[2u * 8u];
+static uint64_t large_storage[1u * 16u];
+
+static osSlabId_t slab;
+static void      *held[4];
+
+/* ==== Helpers ==== */
+
+static void slab_where(const void *block, char *out, size_t size) {
+  static const struct { const char *name; const uint8_t *base; uint32_t bytes; uint32_t stride; } classes[] = {
+    { "small",  (const uint8_t *)small_storage,  sizeof(small_storage),  32u },
+    { "medium", (const uint8_t *)medium_storage, sizeof(medium_storage), 64u },
+    { "large",  (const uint8_t *)large_storage,  sizeof(large_storage),  128u },
+  };
+  const uint8_t *p = (const uint8_t *)block;
+  for (uint32_t i = 0u; i < 3u; ++i) {
+    if ((p >= classes[i].base) && (p < (classes[i].base + classes[i].bytes))) {
+      (void)snprintf(out, size, "%s:%lu", classes[i].name,
+                     (unsigned long)((uint32_t)(p - classes[i].base) / classes[i].stride));
+      return;
+    }
+  }
+  (void)snprintf(out, size, "%s", (block == NULL) ? "NULL" : "?");
+}
+
+static void *slab_alloc(uint32_t bytes, uint32_t timeout) {
+  char where[16];
+  void *block = osSlabAlloc(slab, bytes, timeout);
+  slab_where(block, where, sizeof(where));
+  VSIM_LOG("alloc %lu timeout=%lu -> %s", (unsigned long)bytes, (unsigned long)timeout, where);
+  return block;
+}
+
+static void slab_stats(void) {
+  for (uint32_t i = 0u; i < osSlabGetClassCount(slab); ++i) {
+    osSlabStats_t stats;
+    (void)osSlabGetStats(slab, i, &stats);
+    VSIM_LOG("class %lu size=%lu capacity=%lu used=%lu peak=%lu allocs=%lu overflows=%lu failures=%lu",
+             (unsigned long)i, (unsigned long)stats.block_size, (unsigned long)stats.capacity,
+             (unsigned long)stats.used, (unsigned long)stats.peak, (unsigned long)stats.allocs,
+             (unsigned long)stats.overflows, (unsigned long)stats.failures);
+  }
+}
+
+/* ==== Interrupts ==== */
+
+static void free_isr(void *arg) {
+  osStatus_t status = osSlabFree(slab, arg);
+  VSIM_LOG("isr free status=%d", (int)status);
+}
+
+/* ==== Threads ==== */
+
+static void waiter_thread(void *argument) {
+  (void)argument;
+  osDelay(1u);
+  uint64_t start = vsim_now();
+  void *block = slab_alloc(16u, 5u);
+  VSIM_LOG("waiter woke after %llu cycles", (unsigned long long)(vsim_now() - start));
+  (void)osSlabFree(slab, block);
+}
+
+static void owner_thread(void *argument) {
+  (void)argument;
+
+  /* Both small blocks, then overflow into medium; medium and large fill up. */
+  held[0] = slab_alloc(20u, 0u);
+  held[1] = slab_alloc(32u, 0u);
+  held[2] = slab_alloc(1u, 0u);
+  held[3] = slab_alloc(64u, 0u);
+  void *large = slab_alloc(100u, 0u);
+  (void)slab_alloc(8u, 0u);
+  (void)slab_alloc(200u, 0u);
+
+  VSIM_LOG("free misaligned status=%d", (int)osSlabFree(slab, (uint8_t *)held[0] + 1));
+  VSIM_LOG("free foreign status=%d", (int)osSlabFree(slab, &held[0]));
+
+  /* The waiter blocks on the small class until the ISR returns a block. */
+  (void)vsim_isr_at(SLAB_FREE_AT, free_isr, held[0]);
+  osDelay(4u);
+
+  VSIM_LOG("free overflowed status=%d", (int)osSlabFree(slab, held[2]));
+  (void)osSlabFree(slab, held[1]);
+  (void)osSlabFree(slab, held[3]);
+  (void)osSlabFree(slab, large);
+  slab_stats();
+
+  VSIM_LOG("delete status=%d", (int)osSlabDelete(slab));
+  (void)slab_alloc(8u, 0u);
+  exit(0);
+}
+
+/* ==== Setup ==== */
+
+int main(void) {
+  osKernelInitialize();
+
+  const osSlabClassAttr_t classes[] = {
+    { 32u,  2u, small_cb,  sizeof(small_cb),  small_storage,  sizeof(small_storage) },
+    { 64u,  2u, medium_cb, sizeof(medium_cb), medium_storage, sizeof(medium_storage) },
+    { 128u, 1u, large_cb,  sizeof(large_cb),  large_storage,  sizeof(large_storage) },
+  };
+  const osSlabAttr_t slab_attr = {
+    .name        = "slab",
+    .attr_bits   = osSlabOverflow,
+    .cb_mem      = &slab_cb,
+    .cb_size     = sizeof(slab_cb),
+    .classes     = classes,
+    .class_count = 3u,
+  };
+  slab = osSlabNew(&slab_attr);
+
+  const osThreadAttr_t owner_attr = {
+    .name       = "owner",
+    .cb_mem     = &owner_cb,
+    .cb_size    = sizeof(owner_cb),
+    .stack_mem  = owner_stack,
+    .stack_size = sizeof(owner_stack),
+    .priority   = osPriorityNormal,
+  };
+  const osThreadAttr_t waiter_attr = {
+    .name       = "waiter",
+    .cb_mem     = &waiter_cb,
+    .cb_size    = sizeof(waiter_cb),
+    .stack_mem  = waiter_stack,
+    .stack_size = sizeof(waiter_stack),
+    .priority   = osPriorityAboveNormal,
+  };
+  osThreadNew(owner_thread, NULL, &owner_attr);
+  osThreadNew(waiter_thread, NULL, &waiter_attr);
+
+  osKernelStart();
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include "vsim_app.h"
+
+/*
+ * Timer paths: a periodic timer restarted with a new period while running, a
+ * one-shot timer, osTimerStop, and osTimerStart attempted from an injected
+ * ISR (must be rejected). Callbacks log the tick they fire on.
+ */
+
+static VSIM_CB(thread) control_cb;
+VSIM_STACK(control_stack, 1024u);
+
+static VSIM_CB(timer) periodic_cb;
+static VSIM_CB(timer) oneshot_cb;
+static osTimerId_t periodic;
+static osTimerId_t oneshot;
+
+static void timer_callback(void *argument) {
+  VSIM_LOG("fire %s tick=%lu", (const char *)argument, (unsigned long)osKernelGetTickCount());
+}
+
+static void timer_isr(void *arg) {
+  (void)arg;
+  VSIM_LOG("isr start status=%d", (int)osTimerStart(oneshot, 2u));
+}
+
+static void timer_start(osTimerId_t timer, uint32_t ticks) {
+  osStatus_t status;
+  uint64_t cost;
+  VSIM_COST(status = osTimerStart(timer, ticks), cost);
+  VSIM_LOG("start %s ticks=%lu status=%d cycles=%llu", osTimerGetName(timer), (unsigned long)ticks,
+           (int)status, (unsigned long long)cost);
+}
+
+static void control_thread(void *argument) {
+  (void)argument;
+
+  timer_start(periodic, 5u);
+  osDelay(12u);
+  timer_start(periodic, 3u);
+  timer_start(oneshot, 7u);
+  osDelay(20u);
+
+  osStatus_t status;
+  uint64_t cost;
+  VSIM_COST(status = osTimerStop(periodic), cost);
+  VSIM_LOG("stop periodic status=%d cycles=%llu", (int)status, (unsigned long long)cost);
+  osDelay(5u);
+  VSIM_LOG("running periodic=%lu oneshot=%lu", (unsigned long)osTimerIsRunning(periodic),
+           (unsigned long)osTimerIsRunning(oneshot));
+
+  timer_start(oneshot, 1u);
+  timer_start(oneshot, 4u);
+  for (;;) {
+    osDelay(100u);
+  }
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osTimerAttr_t periodic_attr = { .name = "periodic", .cb_mem = &periodic_cb, .cb_size = sizeof(periodic_cb) };
+  const osTimerAttr_t oneshot_attr  = { .name = "oneshot",  .cb_mem = &oneshot_cb,  .cb_size = sizeof(oneshot_cb) };
+  periodic = osTimerNew(timer_callback, osTimerPeriodic, "periodic", &periodic_attr);
+  oneshot  = osTimerNew(timer_callback, osTimerOnce, "oneshot", &oneshot_attr);
+
+  const osThreadAttr_t control_attr = {
+    .name       = "control",
+    .cb_mem     = &control_cb,
+    .cb_size    = sizeof(control_cb),
+    .stack_mem  = control_stack,
+    .stack_size = sizeof(control_stack),
+    .priority   = osPriorityNormal,
+  };
+  osThreadNew(control_thread, NULL, &control_attr);
+
+  vsim_isr_at(1550000u, timer_isr, NULL);
+
+  osKernelStart();
+  return 0;
+}
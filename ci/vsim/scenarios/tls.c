@@ -0,0 +1,167 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * Thread-local storage. The first thread allocates slots until none is left
+ * and gets osThreadTlsInvalid. Two threads then store their own values in
+ * the same slots and read them back across context switches; a thread
+ * created afterwards starts with every slot NULL. An ISR gets NULL, cannot
+ * set a slot or allocate one, and a timer callback, which runs in a kernel
+ * task rather than a CMSIS thread, gets NULL as well. Slot indices past the
+ * table are rejected.
+ */
+
+#define TLS_SLOTS         4u         /* OS_CFG_TLS_TBL_SIZE / UCOS2_TLS_SLOTS */
+#define TLS_ROUNDS        3u
+#define TLS_IRQ_AFTER     1000u      /* cycles */
+
+#ifdef VSIM_UCOS2
+void App_TimeTickHook(void) {
+}
+#endif
+
+static VSIM_CB(thread) first_cb;
+static VSIM_CB(thread) second_cb;
+static VSIM_CB(thread) late_cb;
+VSIM_STACK(first_stack, 2048u);
+VSIM_STACK(second_stack, 1024u);
+VSIM_STACK(late_stack, 1024u);
+
+static VSIM_CB(timer) timer_cb;
+
+static osTimerId_t timer;
+static uint32_t    slots[TLS_SLOTS + 1u];
+static uint32_t    allocated;
+static int         first_value[2];
+static int         second_value[2];
+
+/* ==== Helpers ==== */
+
+/* Every allocated slot of the running thread, as the index of the value it holds. */
+static void tls_dump(const char *who, const int *values) {
+  for (uint32_t i = 0u; i < allocated; ++i) {
+    void *value = osThreadTlsGet(slots[i]);
+    const char *name = (value == NULL) ? "NULL" : ((value == &values[0]) ? "own[0]" :
+                       ((value == &values[1]) ? "own[1]" : "foreign"));
+    VSIM_LOG("%s slot %lu = %s", who, (unsigned long)slots[i], name);
+  }
+}
+
+/* ==== Interrupts ==== */
+
+static void tls_isr(void *arg) {
+  (void)arg;
+  void *value = osThreadTlsGet(slots[0]);
+  osStatus_t status = osThreadTlsSet(slots[0], &first_value[1]);
+  uint32_t slot = osThreadTlsAlloc();
+  VSIM_LOG("isr get=%s set status=%d alloc=%s", (value == NULL) ? "NULL" : "value", (int)status,
+           (slot == osThreadTlsInvalid) ? "invalid" : "slot");
+}
+
+static void tls_timer(void *argument) {
+  (void)argument;
+  void *value = osThreadTlsGet(slots[0]);
+  VSIM_LOG("timer callback get=%s", (value == NULL) ? "NULL" : "value");
+}
+
+/* ==== Threads ==== */
+
+static void second_thread(void *argument) {
+  (void)argument;
+  (void)osThreadTlsSet(slots[0], &second_value[0]);
+  (void)osThreadTlsSet(slots[1], &second_value[1]);
+  for (uint32_t round = 0u; round < TLS_ROUNDS; ++round) {
+    osDelay(1u);
+  }
+  tls_dump("second", second_value);
+  for (;;) {
+    osDelay(1000u);
+  }
+}
+
+static void late_thread(void *argument) {
+  (void)argument;
+  tls_dump("late", NULL);
+  for (;;) {
+    osDelay(1000u);
+  }
+}
+
+static void first_thread(void *argument) {
+  (void)argument;
+
+  /* One more allocation than the table holds. */
+  for (uint32_t i = 0u; i <= TLS_SLOTS; ++i) {
+    slots[i] = osThreadTlsAlloc();
+    if (slots[i] == osThreadTlsInvalid) {
+      VSIM_LOG("alloc %lu -> invalid", (unsigned long)(i + 1u));
+      break;
+    }
+    VSIM_LOG("alloc %lu -> slot %lu", (unsigned long)(i + 1u), (unsigned long)slots[i]);
+    allocated++;
+  }
+
+  /* Both threads use slots 0 and 1; switches must not mix them up. */
+  (void)osThreadTlsSet(slots[0], &first_value[0]);
+  (void)osThreadTlsSet(slots[1], &first_value[1]);
+  const osThreadAttr_t second_attr = {
+    .name       = "second",
+    .cb_mem     = &second_cb,
+    .cb_size    = sizeof(second_cb),
+    .stack_mem  = second_stack,
+    .stack_size = sizeof(second_stack),
+    .priority   = osPriorityNormal,
+  };
+  (void)osThreadNew(second_thread, NULL, &second_attr);
+  for (uint32_t round = 0u; round < TLS_ROUNDS; ++round) {
+    osDelay(1u);
+  }
+  tls_dump("first", first_value);
+
+  const osThreadAttr_t late_attr = {
+    .name       = "late",
+    .cb_mem     = &late_cb,
+    .cb_size    = sizeof(late_cb),
+    .stack_mem  = late_stack,
+    .stack_size = sizeof(late_stack),
+    .priority   = osPriorityHigh,
+  };
+  (void)osThreadNew(late_thread, NULL, &late_attr);
+
+  /* The ISR interrupts this thread, whose slots hold values. */
+  (void)vsim_isr_after(TLS_IRQ_AFTER, tls_isr, NULL);
+  vsim_consume(2u * TLS_IRQ_AFTER);
+  (void)osTimerStart(timer, 1u);
+  osDelay(2u);
+  tls_dump("first after isr", first_value);
+
+  void *value = osThreadTlsGet(TLS_SLOTS);
+  osStatus_t status = osThreadTlsSet(TLS_SLOTS, &first_value[0]);
+  VSIM_LOG("slot %lu get=%s set status=%d", (unsigned long)TLS_SLOTS, (value == NULL) ? "NULL" : "value",
+           (int)status);
+  exit(0);
+}
+
+/* ==== Setup ==== */
+
+int main(void) {
+  osKernelInitialize();
+
+  const osTimerAttr_t timer_attr = { .name = "timer", .cb_mem = &timer_cb, .cb_size = sizeof(timer_cb) };
+  timer = osTimerNew(tls_timer, osTimerOnce, NULL, &timer_attr);
+
+  const osThreadAttr_t first_attr = {
+    .name       = "first",
+    .cb_mem     = &first_cb,
+    .cb_size    = sizeof(first_cb),
+    .stack_mem  = first_stack,
+    .stack_size = sizeof(first_stack),
+    .priority   = osPriorityNormal,
+  };
+  (void)osThreadNew(first_thread, NULL, &first_attr);
+
+  osKernelStart();
+  return 0;
+}
@@ -0,0 +1,234 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * Topic bus paths: one topic fans out to a drained queue (drop newest), an
+ * undrained queue (drop oldest) and event flags, from a thread and from an
+ * ISR; subscribers woken by a publish run after the whole pass. A second
+ * topic has a single drop-oldest subscriber and an ISR that refills the slot
+ * the publish has just freed, so the retry fails: the publish must give up
+ * after one eviction and count one drop. A buffer topic checks that evicted
+ * buffers are released back to their pool.
+ */
+
+#define TOPIC_DEPTH       2u
+#define TOPIC_RACE_AT     540u       /* cycles into osTopicPublish: after the eviction, before the retry */
+
+#ifdef VSIM_UCOS2
+void App_TimeTickHook(void) {
+}
+#endif
+
+static VSIM_CB(thread) publisher_cb;
+static VSIM_CB(thread) reader_cb;
+static VSIM_CB(thread) flags_cb;
+VSIM_STACK(publisher_stack, 2048u);
+VSIM_STACK(reader_stack, 1024u);
+VSIM_STACK(flags_stack, 1024u);
+
+static VSIM_CB(topic) sensor_cb;
+static VSIM_CB(topic) race_cb;
+static VSIM_CB(topic) frames_cb;
+static VSIM_CB(event_flags) ef_cb;
+VSIM_MQ_CB(fast_cb, 4u);
+VSIM_MQ_CB(slow_cb, TOPIC_DEPTH);
+VSIM_MQ_CB(race_q_cb, TOPIC_DEPTH);
+VSIM_MQ_CB(left_cb, TOPIC_DEPTH);
+VSIM_MQ_CB(right_cb, TOPIC_DEPTH);
+static void *fast_storage[4];
+static void *slow_storage[TOPIC_DEPTH];
+static void *race_storage[TOPIC_DEPTH];
+static void *left_storage[TOPIC_DEPTH];
+static void *right_storage[TOPIC_DEPTH];
+VSIM_MP_CB(pool_cb, 4u);
+static uint64_t pool_storage[4u * 4u];
+
+static osTopicId_t        sensor;
+static osTopicId_t        race;
+static osTopicId_t        frames;
+static osEventFlagsId_t   ef;
+static osMessageQueueId_t fast;
+static osMessageQueueId_t slow;
+static osMessageQueueId_t race_q;
+static osMessageQueueId_t left;
+static osMessageQueueId_t right;
+static osMemoryPoolId_t   pool;
+
+/* ==== Helpers ==== */
+
+static osMessageQueueId_t topic_queue(const char *name, void *cb, uint32_t cb_size, void *storage,
+                                      uint32_t depth) {
+  const osMessageQueueAttr_t attr = {
+    .name    = name,
+    .cb_mem  = cb,
+    .cb_size = cb_size,
+    .mq_mem  = storage,
+    .mq_size = depth * (uint32_t)sizeof(void *),
+  };
+  return osMessageQueueNew(depth, sizeof(void *), &attr);
+}
+
+static void topic_dump(const char *name, osMessageQueueId_t mq) {
+  unsigned long values[4] = { 0u, 0u, 0u, 0u };
+  uint32_t count = 0u;
+  void *msg;
+  while ((count < 4u) && (osMessageQueueGet(mq, &msg, NULL, 0u) == osOK)) {
+    values[count++] = (unsigned long)(uintptr_t)msg;
+  }
+  VSIM_LOG("%s holds %lu: %lu %lu %lu %lu", name, (unsigned long)count,
+           values[0], values[1], values[2], values[3]);
+}
+
+/* ==== Interrupts ==== */
+
+static void publish_isr(void *arg) {
+  uint32_t delivered = osTopicPublish(sensor, arg);
+  VSIM_LOG("isr publish v=%lu delivered=%lu", (unsigned long)(uintptr_t)arg, (unsigned long)delivered);
+}
+
+static void refill_isr(void *arg) {
+  osStatus_t status = osMessageQueuePut(race_q, &arg, 0u, 0u);
+  VSIM_LOG("isr refill v=%lu status=%d", (unsigned long)(uintptr_t)arg, (int)status);
+}
+
+/* ==== Threads ==== */
+
+static void reader_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    void *msg;
+    if (osMessageQueueGet(fast, &msg, NULL, osWaitForever) == osOK) {
+      VSIM_LOG("reader got v=%lu", (unsigned long)(uintptr_t)msg);
+    }
+  }
+}
+
+static void flags_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    uint32_t flags = osEventFlagsWait(ef, 0x1u, osFlagsWaitAny, osWaitForever);
+    VSIM_LOG("flags got 0x%lx", (unsigned long)flags);
+  }
+}
+
+static void publisher_thread(void *argument) {
+  (void)argument;
+
+  /* Fan-out: slow (depth 2) overflows on the third publish and keeps the newest. */
+  for (uintptr_t v = 1u; v <= 4u; ++v) {
+    uint32_t delivered = osTopicPublish(sensor, (void *)v);
+    VSIM_LOG("publish v=%lu delivered=%lu", (unsigned long)v, (unsigned long)delivered);
+    osDelay(1u);
+  }
+  (void)vsim_isr_after(1000u, publish_isr, (void *)5u);
+  osDelay(1u);
+  VSIM_LOG("dropped fast=%lu slow=%lu", (unsigned long)osTopicGetDropped(sensor, fast),
+           (unsigned long)osTopicGetDropped(sensor, slow));
+  topic_dump("slow", slow);
+
+  /* Retry race: the ISR takes the slot freed by the eviction. */
+  for (uintptr_t v = 11u; v <= 12u; ++v) {
+    (void)osTopicPublish(race, (void *)v);
+  }
+  (void)vsim_isr_at(vsim_now() + TOPIC_RACE_AT, refill_isr, (void *)99u);
+  uint32_t delivered = osTopicPublish(race, (void *)13u);
+  VSIM_LOG("race publish v=13 delivered=%lu dropped=%lu", (unsigned long)delivered,
+           (unsigned long)osTopicGetDropped(race, race_q));
+  topic_dump("race", race_q);
+
+  /* Buffers: each queue holds a reference; evicted buffers go back to the pool. */
+  for (uint32_t i = 0u; i < 3u; ++i) {
+    osBuffer_t *buf = osBufferAlloc(pool, 0u);
+    *(uint32_t *)osBufferData(buf) = 100u + i;
+    delivered = osTopicPublishBuffer(frames, buf);
+    (void)osBufferRelease(buf);
+    VSIM_LOG("frame %lu delivered=%lu pool used=%lu", (unsigned long)(100u + i), (unsigned long)delivered,
+             (unsigned long)osMemoryPoolGetCount(pool));
+  }
+  osBuffer_t *buf;
+  while ((buf = osBufferGet(left, 0u)) != NULL) {
+    VSIM_LOG("left frame %lu", (unsigned long)*(uint32_t *)osBufferData(buf));
+    (void)osBufferRelease(buf);
+  }
+  while ((buf = osBufferGet(right, 0u)) != NULL) {
+    (void)osBufferRelease(buf);
+  }
+  VSIM_LOG("frames dropped left=%lu right=%lu pool used=%lu",
+           (unsigned long)osTopicGetDropped(frames, left), (unsigned long)osTopicGetDropped(frames, right),
+           (unsigned long)osMemoryPoolGetCount(pool));
+
+  /* Unsubscribed queues stop receiving; deleting leaves queued messages alone. */
+  osStatus_t status = osTopicUnsubscribe(sensor, slow);
+  VSIM_LOG("unsubscribe slow status=%d again=%d", (int)status, (int)osTopicUnsubscribe(sensor, slow));
+  delivered = osTopicPublish(sensor, (void *)6u);
+  VSIM_LOG("publish v=6 delivered=%lu slow count=%lu", (unsigned long)delivered,
+           (unsigned long)osMessageQueueGetCount(slow));
+  osDelay(1u);
+  VSIM_LOG("delete status=%d", (int)osTopicDelete(sensor));
+  exit(0);
+}
+
+/* ==== Setup ==== */
+
+static void topic_spawn(const char *name, VSIM_CB(thread) *cb, vsim_stk_t *stack, uint32_t stack_size,
+                        osThreadFunc_t func, osPriority_t priority) {
+  const osThreadAttr_t attr = {
+    .name       = name,
+    .cb_mem     = cb,
+    .cb_size    = sizeof(*cb),
+    .stack_mem  = stack,
+    .stack_size = stack_size,
+    .priority   = priority,
+  };
+  (void)osThreadNew(func, NULL, &attr);
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osTopicAttr_t sensor_attr = { .name = "sensor", .cb_mem = &sensor_cb, .cb_size = sizeof(sensor_cb) };
+  const osTopicAttr_t race_attr = { .name = "race", .cb_mem = &race_cb, .cb_size = sizeof(race_cb) };
+  const osTopicAttr_t frames_attr = {
+    .name      = "frames",
+    .attr_bits = osTopicBuffers,
+    .cb_mem    = &frames_cb,
+    .cb_size   = sizeof(frames_cb),
+  };
+  sensor = osTopicNew(&sensor_attr);
+  race = osTopicNew(&race_attr);
+  frames = osTopicNew(&frames_attr);
+
+  const osEventFlagsAttr_t ef_attr = { .name = "sensor.flags", .cb_mem = &ef_cb, .cb_size = sizeof(ef_cb) };
+  ef = osEventFlagsNew(&ef_attr);
+  fast = topic_queue("fast", fast_cb, sizeof(fast_cb), fast_storage, 4u);
+  slow = topic_queue("slow", slow_cb, sizeof(slow_cb), slow_storage, TOPIC_DEPTH);
+  race_q = topic_queue("race.q", race_q_cb, sizeof(race_q_cb), race_storage, TOPIC_DEPTH);
+  left = topic_queue("left", left_cb, sizeof(left_cb), left_storage, TOPIC_DEPTH);
+  right = topic_queue("right", right_cb, sizeof(right_cb), right_storage, TOPIC_DEPTH);
+
+  const osMemoryPoolAttr_t pool_attr = {
+    .name    = "frame.pool",
+    .cb_mem  = pool_cb,
+    .cb_size = sizeof(pool_cb),
+    .mp_mem  = pool_storage,
+    .mp_size = sizeof(pool_storage),
+  };
+  pool = osMemoryPoolNew(4u, osBufferBlockSize(sizeof(uint32_t)), &pool_attr);
+
+  (void)osTopicSubscribe(sensor, fast, osTopicDropNewest);
+  (void)osTopicSubscribe(sensor, slow, osTopicDropOldest);
+  (void)osTopicSubscribeFlags(sensor, ef, 0x1u);
+  (void)osTopicSubscribe(race, race_q, osTopicDropOldest);
+  (void)osTopicSubscribe(frames, left, osTopicDropOldest);
+  (void)osTopicSubscribe(frames, right, osTopicDropOldest);
+
+  topic_spawn("reader", &reader_cb, reader_stack, sizeof(reader_stack), reader_thread, osPriorityHigh);
+  topic_spawn("flags", &flags_cb, flags_stack, sizeof(flags_stack), flags_thread, osPriorityAboveNormal);
+  topic_spawn("publisher", &publisher_cb, publisher_stack, sizeof(publisher_stack), publisher_thread,
+              osPriorityNormal);
+
+  osKernelStart();
+  return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef VSIM_APP_H_
+#define VSIM_APP_H_
+
+/*
+ * Port-neutral helpers for simulator scenarios: the same source builds
+ * against the uC/OS-II and uC/OS-III wrappers, selected with -DVSIM_UCOS2 or
+ * -DVSIM_UCOS3. Every log line starts with the virtual cycle counter, so a
+ * scenario's output is its golden trace.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "cmsis_os2.h"
+#include "vsim.h"
+
+#if defined(VSIM_UCOS3)
+#include "ucos3_os2.h"
+#define VSIM_PORT                 "ucos3"
+#define VSIM_CB(kind)             os_ucos3_##kind##_t
+typedef CPU_STK vsim_stk_t;
+#elif defined(VSIM_UCOS2)
+#include "ucos2_os2.h"
+#define VSIM_PORT                 "ucos2"
+#define VSIM_CB(kind)             os_ucos2_##kind##_t
+typedef OS_STK vsim_stk_t;
+#else
+#error "Define VSIM_UCOS2 or VSIM_UCOS3."
+#endif
+
+#define VSIM_STACK(name, bytes)   static vsim_stk_t name[(bytes) / sizeof(vsim_stk_t)]
+
+/* Message queue control block: uC/OS-III keeps its free list behind the
+ * control block, so reserve one pointer per message (plus alignment). */
+#define VSIM_MQ_CB_SIZE(count)    (sizeof(VSIM_CB(message_queue)) + (((count) + 1u) * sizeof(void *)))
+#define VSIM_MQ_CB(name, count)   static void *name[(VSIM_MQ_CB_SIZE(count) + sizeof(void *) - 1u) / sizeof(void *)]
+
+/* Memory pool control block: both ports keep the 16-bit free list behind the
+ * control block, so reserve one index per block (plus alignment). */
+#define VSIM_MP_CB_SIZE(count)    (sizeof(VSIM_CB(memory_pool)) + (((count) + 1u) * sizeof(uint16_t)))
+#define VSIM_MP_CB(name, count)   static void *name[(VSIM_MP_CB_SIZE(count) + sizeof(void *) - 1u) / sizeof(void *)]
+
+#define VSIM_LOG(...)                                            \
+  do {                                                           \
+    printf("%10llu ", (unsigned long long)vsim_now());           \
+    printf(__VA_ARGS__);                                         \
+    putchar('\n');                                               \
+  } while (0)
+
+/* Virtual cycles spent in one call, measured on the calling thread. */
+#define VSIM_COST(call, out)                                     \
+  do {                                                           \
+    uint64_t vsim_cost_start_ = vsim_now();                      \
+    (call);                                                      \
+    (out) = vsim_now() - vsim_cost_start_;                       \
+  } while (0)
+
+#endif /* VSIM_APP_H_ */
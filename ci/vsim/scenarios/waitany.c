@@ -0,0 +1,177 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * osObjectWaitAny over a semaphore, a message queue and event flags, once per
+ * reporting policy: with every object ready the waiter takes them in policy
+ * order until none is left; an ISR releases the semaphore after the waiter
+ * has linked its nodes and scanned again but before it pends, which must
+ * wake it at once rather than after the timeout; an empty set times out; and
+ * deleting the queue while the waiter blocks reports it ready, so the take
+ * returns the error.
+ *
+ * vsim-features: WAIT_ANY
+ */
+
+#define WAITANY_RACE_AT   180u        /* cycles into osObjectWaitAny: after the second scan, before the pend */
+
+#ifdef VSIM_UCOS2
+void App_TimeTickHook(void) {
+}
+#endif
+
+static VSIM_CB(thread) waiter_cb;
+static VSIM_CB(thread) deleter_cb;
+VSIM_STACK(waiter_stack, 2048u);
+VSIM_STACK(deleter_stack, 1024u);
+
+static VSIM_CB(semaphore)   sem_cb;
+static VSIM_CB(semaphore)   go_cb;
+static VSIM_CB(event_flags) ef_cb;
+VSIM_MQ_CB(mq_cb, 4u);
+static void *mq_storage[4];
+
+static osSemaphoreId_t    sem;
+static osSemaphoreId_t    go;
+static osEventFlagsId_t   ef;
+static osMessageQueueId_t mq;
+static osStatus_t         deleted;
+
+static const char *const names[] = { "sem", "mq", "flags" };
+
+/* ==== Helpers ==== */
+
+static osMessageQueueId_t waitany_queue(void) {
+  const osMessageQueueAttr_t attr = {
+    .name    = "mq",
+    .cb_mem  = mq_cb,
+    .cb_size = sizeof(mq_cb),
+    .mq_mem  = mq_storage,
+    .mq_size = sizeof(mq_storage),
+  };
+  return osMessageQueueNew(4u, sizeof(void *), &attr);
+}
+
+/* Take the object osObjectWaitAny reported, with a zero timeout. */
+static int waitany_take(int32_t index) {
+  void *msg;
+  switch (index) {
+    case 0:
+      return (int)osSemaphoreAcquire(sem, 0u);
+    case 1:
+      return (int)osMessageQueueGet(mq, &msg, NULL, 0u);
+    case 2:
+      return ((int32_t)osEventFlagsWait(ef, 0x1u, osFlagsWaitAny, 0u) < 0) ? (int)osErrorResource : (int)osOK;
+    default:
+      return (int)osErrorParameter;
+  }
+}
+
+static void waitany_log(const char *what, int32_t index, uint64_t start) {
+  if (index >= 0) {
+    int status = waitany_take(index);
+    VSIM_LOG("%s -> %s take=%d after %llu cycles", what, names[index], status,
+             (unsigned long long)(vsim_now() - start));
+  } else {
+    VSIM_LOG("%s -> %d after %llu cycles", what, (int)index, (unsigned long long)(vsim_now() - start));
+  }
+}
+
+/* ==== Interrupts ==== */
+
+static void release_isr(void *arg) {
+  (void)arg;
+  osStatus_t status = osSemaphoreRelease(sem);
+  VSIM_LOG("isr release status=%d", (int)status);
+}
+
+/* ==== Threads ==== */
+
+static void deleter_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    (void)osSemaphoreAcquire(go, osWaitForever);
+    VSIM_LOG("delete mq");
+    deleted = osMessageQueueDelete(mq);
+  }
+}
+
+static void waiter_thread(void *argument) {
+  (void)argument;
+  static const struct { uint32_t policy; const char *name; } policies[] = {
+    { osObjectWaitPriority,   "priority" },
+    { osObjectWaitRoundRobin, "round-robin" },
+  };
+
+  for (uint32_t p = 0u; p < 2u; ++p) {
+    osObjectWait_t objects[3] = {
+      { .object = sem },
+      { .object = mq },
+      { .object = ef, .flags = 0x1u, .options = osFlagsWaitAny },
+    };
+    osObjectWaitSet_t set = { .objects = objects, .count = 3u, .policy = policies[p].policy };
+    VSIM_LOG("policy %s", policies[p].name);
+
+    /* Everything ready: the policy decides the order of the takes. */
+    (void)osSemaphoreRelease(sem);
+    (void)osSemaphoreRelease(sem);
+    for (uintptr_t v = 1u; v <= 2u; ++v) {
+      (void)osMessageQueuePut(mq, &v, 0u, 0u);
+    }
+    (void)osEventFlagsSet(ef, 0x1u);
+    for (uint32_t i = 0u; i < 6u; ++i) {
+      waitany_log("ready", osObjectWaitAny(&set, 0u), vsim_now());
+    }
+
+    /* Release between the link and the pend: the wake semaphore is posted. */
+    uint64_t start = vsim_now();
+    (void)vsim_isr_at(start + WAITANY_RACE_AT, release_isr, NULL);
+    waitany_log("race", osObjectWaitAny(&set, 5u), start);
+
+    start = vsim_now();
+    waitany_log("empty", osObjectWaitAny(&set, 2u), start);
+
+    /* The deleter runs once the waiter blocks; the deleted queue reads as ready. */
+    (void)osSemaphoreRelease(go);
+    start = vsim_now();
+    waitany_log("deleted", osObjectWaitAny(&set, 5u), start);
+    VSIM_LOG("delete status=%d", (int)deleted);
+    mq = waitany_queue();
+  }
+  exit(0);
+}
+
+/* ==== Setup ==== */
+
+static void waitany_spawn(const char *name, VSIM_CB(thread) *cb, vsim_stk_t *stack, uint32_t stack_size,
+                          osThreadFunc_t func, osPriority_t priority) {
+  const osThreadAttr_t attr = {
+    .name       = name,
+    .cb_mem     = cb,
+    .cb_size    = sizeof(*cb),
+    .stack_mem  = stack,
+    .stack_size = stack_size,
+    .priority   = priority,
+  };
+  (void)osThreadNew(func, NULL, &attr);
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osSemaphoreAttr_t sem_attr = { .name = "sem", .cb_mem = &sem_cb, .cb_size = sizeof(sem_cb) };
+  const osSemaphoreAttr_t go_attr = { .name = "go", .cb_mem = &go_cb, .cb_size = sizeof(go_cb) };
+  const osEventFlagsAttr_t ef_attr = { .name = "flags", .cb_mem = &ef_cb, .cb_size = sizeof(ef_cb) };
+  sem = osSemaphoreNew(4u, 0u, &sem_attr);
+  go = osSemaphoreNew(1u, 0u, &go_attr);
+  ef = osEventFlagsNew(&ef_attr);
+  mq = waitany_queue();
+
+  waitany_spawn("waiter", &waiter_cb, waiter_stack, sizeof(waiter_stack), waiter_thread, osPriorityAboveNormal);
+  waitany_spawn("deleter", &deleter_cb, deleter_stack, sizeof(deleter_stack), deleter_thread, osPriorityNormal);
+
+  osKernelStart();
+  return 0;
+}
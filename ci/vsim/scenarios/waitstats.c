@@ -0,0 +1,179 @@
+#include <stdlib.h>
+
+#include "vsim_app.h"
+#include "cmsis_os2_ext.h"
+
+/*
+ * Per-thread wait statistics: a worker blocks on a semaphore released by an
+ * ISR, a mutex held by a lower-priority thread, event flags, a message queue
+ * that times out and osDelay; zero-timeout calls are not counted. It then
+ * waits once on more objects than the table has entries, so the last entry
+ * collects the overflow as osWaitKindOther.
+ *
+ * vsim-features: WAIT_STATS
+ */
+
+#define WAIT_IRQ_PERIOD   230000u    /* cycles between semaphore releases */
+#define WAIT_EXTRA        (UCOS_WAIT_STATS_SLOTS)
+
+#if defined(VSIM_UCOS3)
+#define UCOS_WAIT_STATS_SLOTS UCOS3_WAIT_STATS_SLOTS
+#else
+#define UCOS_WAIT_STATS_SLOTS UCOS2_WAIT_STATS_SLOTS
+void App_TimeTickHook(void) {
+}
+#endif
+
+static VSIM_CB(thread) worker_cb;
+static VSIM_CB(thread) holder_cb;
+VSIM_STACK(worker_stack, 2048u);
+VSIM_STACK(holder_stack, 1024u);
+
+static VSIM_CB(semaphore)   irq_sem_cb;
+static VSIM_CB(semaphore)   extra_cb[WAIT_EXTRA];
+static VSIM_CB(mutex)       mutex_cb;
+static VSIM_CB(event_flags) ef_cb;
+VSIM_MQ_CB(mq_cb, 2u);
+static void *mq_storage[2];
+
+static osSemaphoreId_t    irq_sem;
+static osSemaphoreId_t    extra[WAIT_EXTRA];
+static osMutexId_t        mutex;
+static osEventFlagsId_t   ef;
+static osMessageQueueId_t mq;
+static osThreadId_t       worker;
+
+static const char *const kinds[] = {
+  "delay", "mutex", "semaphore", "event_flags", "message_queue", "join", "memory_pool", "object_set",
+  "thread_message", "pool",
+};
+
+/* ==== Helpers ==== */
+
+static const char *wait_object(const void *object) {
+  if (object == NULL) {
+    return "-";
+  }
+  if (object == irq_sem) {
+    return "irq.sem";
+  }
+  if (object == mutex) {
+    return "mutex";
+  }
+  if (object == ef) {
+    return "flags";
+  }
+  if (object == mq) {
+    return "mq";
+  }
+  for (uint32_t i = 0u; i < WAIT_EXTRA; ++i) {
+    if (object == extra[i]) {
+      return "extra";
+    }
+  }
+  return "?";
+}
+
+static void wait_dump(void) {
+  osThreadWaitStat_t stats[UCOS_WAIT_STATS_SLOTS];
+  uint32_t count = osThreadGetWaitStats(worker, stats, UCOS_WAIT_STATS_SLOTS);
+  for (uint32_t i = 0u; i < count; ++i) {
+    const char *kind = (stats[i].kind < (sizeof(kinds) / sizeof(kinds[0]))) ? kinds[stats[i].kind] : "other";
+    VSIM_LOG("wait %s %s count=%lu cycles=%llu max=%lu", kind, wait_object(stats[i].object),
+             (unsigned long)stats[i].count, (unsigned long long)stats[i].cycles,
+             (unsigned long)stats[i].max_cycles);
+  }
+}
+
+/* ==== Interrupts ==== */
+
+static void release_isr(void *arg) {
+  (void)arg;
+  (void)osSemaphoreRelease(irq_sem);
+  (void)vsim_isr_after(WAIT_IRQ_PERIOD, release_isr, NULL);
+}
+
+/* ==== Threads ==== */
+
+static void holder_thread(void *argument) {
+  (void)argument;
+  for (;;) {
+    (void)osMutexAcquire(mutex, osWaitForever);
+    vsim_consume(60000u);
+    (void)osEventFlagsSet(ef, 0x1u);
+    (void)osMutexRelease(mutex);
+    osDelay(2u);
+  }
+}
+
+static void worker_thread(void *argument) {
+  (void)argument;
+  for (uint32_t round = 0u; round < 3u; ++round) {
+    (void)osSemaphoreAcquire(irq_sem, osWaitForever);
+    (void)osMutexAcquire(mutex, osWaitForever);
+    (void)osMutexRelease(mutex);
+    (void)osEventFlagsWait(ef, 0x1u, osFlagsWaitAny, osWaitForever);
+    void *msg;
+    (void)osMessageQueueGet(mq, &msg, NULL, 1u);
+    (void)osMessageQueueGet(mq, &msg, NULL, 0u);    /* not counted */
+    osDelay(1u);
+  }
+  wait_dump();
+
+  /* More objects than entries: the table fills and the rest share the last one. */
+  for (uint32_t i = 0u; i < WAIT_EXTRA; ++i) {
+    (void)osSemaphoreAcquire(extra[i], 1u);
+  }
+  VSIM_LOG("after %lu more objects", (unsigned long)WAIT_EXTRA);
+  wait_dump();
+  exit(0);
+}
+
+/* ==== Setup ==== */
+
+static void wait_spawn(const char *name, VSIM_CB(thread) *cb, vsim_stk_t *stack, uint32_t stack_size,
+                       osThreadFunc_t func, osPriority_t priority, osThreadId_t *id) {
+  const osThreadAttr_t attr = {
+    .name       = name,
+    .cb_mem     = cb,
+    .cb_size    = sizeof(*cb),
+    .stack_mem  = stack,
+    .stack_size = stack_size,
+    .priority   = priority,
+  };
+  osThreadId_t thread = osThreadNew(func, NULL, &attr);
+  if (id != NULL) {
+    *id = thread;
+  }
+}
+
+int main(void) {
+  osKernelInitialize();
+
+  const osSemaphoreAttr_t sem_attr = { .name = "irq.sem", .cb_mem = &irq_sem_cb, .cb_size = sizeof(irq_sem_cb) };
+  irq_sem = osSemaphoreNew(4u, 0u, &sem_attr);
+  for (uint32_t i = 0u; i < WAIT_EXTRA; ++i) {
+    const osSemaphoreAttr_t extra_attr = { .name = "extra", .cb_mem = &extra_cb[i], .cb_size = sizeof(extra_cb[i]) };
+    extra[i] = osSemaphoreNew(1u, 0u, &extra_attr);
+  }
+  const osMutexAttr_t mutex_attr = { .name = "mutex", .cb_mem = &mutex_cb, .cb_size = sizeof(mutex_cb) };
+  mutex = osMutexNew(&mutex_attr);
+  const osEventFlagsAttr_t ef_attr = { .name = "flags", .cb_mem = &ef_cb, .cb_size = sizeof(ef_cb) };
+  ef = osEventFlagsNew(&ef_attr);
+  const osMessageQueueAttr_t mq_attr = {
+    .name    = "mq",
+    .cb_mem  = mq_cb,
+    .cb_size = sizeof(mq_cb),
+    .mq_mem  = mq_storage,
+    .mq_size = sizeof(mq_storage),
+  };
+  mq = osMessageQueueNew(2u, sizeof(void *), &mq_attr);
+
+  wait_spawn("worker", &worker_cb, worker_stack, sizeof(worker_stack), worker_thread, osPriorityAboveNormal,
+             &worker);
+  wait_spawn("holder", &holder_cb, holder_stack, sizeof(holder_stack), holder_thread, osPriorityNormal, NULL);
+  (void)vsim_isr_after(WAIT_IRQ_PERIOD, release_isr, NULL);
+
+  osKernelStart();
+  return 0;
+}
@@ -0,0 +1,14 @@
+#ifndef APP_CFG_H
+#define APP_CFG_H
+
+/* uC/OS-II application configuration used by the virtual-time simulator. */
+
+#define OS_TASK_TMR_PRIO        (OS_LOWEST_PRIO - 2u)
+
+/* Thread-local storage slots, as OS_CFG_TLS_TBL_SIZE on uC/OS-III. */
+#define UCOS2_TLS_SLOTS         4u
+
+/* Virtual cycle counter as the CPU usage / benchmark timestamp. */
+#define UCOS2_TS_GET()          ((uint32_t)vsim_now())
+
+#endif /* APP_CFG_H */
@@ -0,0 +1,43 @@
+#ifndef OS_CPU_H
+#define OS_CPU_H
+
+/*
+ * Virtual-time simulator port: critical sections mask simulated interrupts so
+ * injected ISRs and ticks are deferred until the matching OS_EXIT_CRITICAL().
+ */
+
+#include <stdint.h>
+
+#include "vsim.h"
+
+typedef uint8_t   BOOLEAN;
+typedef uint8_t   INT8U;
+typedef int8_t    INT8S;
+typedef uint16_t  INT16U;
+typedef int16_t   INT16S;
+typedef uint32_t  INT32U;
+typedef int32_t   INT32S;
+typedef uint64_t  INT64U;
+typedef float     FP32;
+typedef double    FP64;
+
+typedef uint32_t  OS_STK;
+typedef uint32_t  OS_CPU_SR;
+
+#define OS_CRITICAL_METHOD   3u
+
+#define OS_ENTER_CRITICAL()  do { cpu_sr = vsim_irq_disable(); } while (0)
+#define OS_EXIT_CRITICAL()   do { vsim_irq_restore(cpu_sr); } while (0)
+
+#define OS_STK_GROWTH        1u
+
+/* VSIM_ATOMIC_POINTS: every compare-and-swap of the wrapper's lock-free paths
+ * is an interrupt point, so a scenario can land an ISR between a load and the
+ * CAS that depends on it. */
+#ifdef VSIM_ATOMIC_POINTS
+#define UCOS2_ATOMIC_CAS(p, expected, desired) \
+  (vsim_atomic_point(),                        \
+   __atomic_compare_exchange_n((p), (expected), (desired), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+#endif
+
+#endif /* OS_CPU_H */
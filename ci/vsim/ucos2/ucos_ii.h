@@ -0,0 +1,408 @@
+#ifndef OS_uCOS_II_H
+#define OS_uCOS_II_H
+
+/*
+ * uC/OS-II v2.93 API surface implemented by the virtual-time simulator
+ * (ci/vsim/vsim_os2.c). Names, types, option values and error codes follow
+ * the real ucos_ii.h so the CMSIS-RTOS2 wrapper compiles unchanged; only the
+ * subset of services used by the wrapper and the extensions is provided.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "app_cfg.h"
+#include "os_cfg.h"
+#include "os_cpu.h"
+
+#define OS_VERSION                 29300u
+
+#define OS_FALSE                   0u
+#define OS_TRUE                    1u
+
+#define OS_PRIO_SELF               0xFFu
+#define OS_PRIO_MUTEX_CEIL_DIS     0xFFu
+#define OS_TCB_RESERVED            ((OS_TCB *)1)
+
+#define OS_TASK_IDLE_PRIO          (OS_LOWEST_PRIO)
+#define OS_TASK_IDLE_ID            65535u
+#define OS_TASK_TMR_ID             65533u
+
+#define OS_EVENT_TBL_SIZE          ((OS_LOWEST_PRIO) / 8u + 1u)
+
+/* ==== Task status (OSTCBStat) ==== */
+#define OS_STAT_RDY                0x00u
+#define OS_STAT_SEM                0x01u
+#define OS_STAT_MBOX               0x02u
+#define OS_STAT_Q                  0x04u
+#define OS_STAT_SUSPEND            0x08u
+#define OS_STAT_MUTEX              0x10u
+#define OS_STAT_FLAG               0x20u
+#define OS_STAT_MULTI              0x80u
+#define OS_STAT_PEND_ANY           (OS_STAT_SEM | OS_STAT_MBOX | OS_STAT_Q | OS_STAT_MUTEX | OS_STAT_FLAG)
+
+/* ==== Pend status (OSTCBStatPend) ==== */
+#define OS_STAT_PEND_OK            0u
+#define OS_STAT_PEND_TO            1u
+#define OS_STAT_PEND_ABORT         2u
+
+/* ==== Event types ==== */
+#define OS_EVENT_TYPE_UNUSED       0u
+#define OS_EVENT_TYPE_MBOX         1u
+#define OS_EVENT_TYPE_Q            2u
+#define OS_EVENT_TYPE_SEM          3u
+#define OS_EVENT_TYPE_MUTEX        4u
+#define OS_EVENT_TYPE_FLAG         5u
+#define OS_TMR_TYPE                100u
+
+/* ==== Options ==== */
+#define OS_DEL_NO_PEND             0u
+#define OS_DEL_ALWAYS              1u
+
+#define OS_FLAG_WAIT_CLR_ALL       0u
+#define OS_FLAG_WAIT_CLR_ANY       1u
+#define OS_FLAG_WAIT_SET_ALL       2u
+#define OS_FLAG_WAIT_SET_ANY       3u
+#define OS_FLAG_CONSUME            0x80u
+#define OS_FLAG_CLR                0u
+#define OS_FLAG_SET                1u
+
+#define OS_POST_OPT_NONE           0x00u
+#define OS_POST_OPT_BROADCAST      0x01u
+#define OS_POST_OPT_FRONT          0x02u
+#define OS_POST_OPT_NO_SCHED       0x04u
+
+#define OS_PEND_OPT_NONE           0u
+#define OS_PEND_OPT_BROADCAST      1u
+
+#define OS_TASK_OPT_NONE           0x0000u
+#define OS_TASK_OPT_STK_CHK        0x0001u
+#define OS_TASK_OPT_STK_CLR        0x0002u
+#define OS_TASK_OPT_SAVE_FP        0x0004u
+
+#define OS_TMR_OPT_NONE            0u
+#define OS_TMR_OPT_ONE_SHOT        1u
+#define OS_TMR_OPT_PERIODIC        2u
+#define OS_TMR_OPT_CALLBACK        3u
+#define OS_TMR_OPT_CALLBACK_ARG    4u
+
+#define OS_TMR_STATE_UNUSED        0u
+#define OS_TMR_STATE_STOPPED       1u
+#define OS_TMR_STATE_COMPLETED     2u
+#define OS_TMR_STATE_RUNNING       3u
+
+/* ==== Error codes ==== */
+#define OS_ERR_NONE                     0u
+#define OS_ERR_EVENT_TYPE               1u
+#define OS_ERR_PEND_ISR                 2u
+#define OS_ERR_POST_NULL_PTR            3u
+#define OS_ERR_PEVENT_NULL              4u
+#define OS_ERR_POST_ISR                 5u
+#define OS_ERR_QUERY_ISR                6u
+#define OS_ERR_INVALID_OPT              7u
+#define OS_ERR_ID_INVALID               8u
+#define OS_ERR_PDATA_NULL               9u
+#define OS_ERR_TIMEOUT                 10u
+#define OS_ERR_PEND_LOCKED             13u
+#define OS_ERR_PEND_ABORT              14u
+#define OS_ERR_DEL_ISR                 15u
+#define OS_ERR_CREATE_ISR              16u
+#define OS_ERR_Q_FULL                  30u
+#define OS_ERR_Q_EMPTY                 31u
+#define OS_ERR_PRIO_EXIST              40u
+#define OS_ERR_PRIO                    41u
+#define OS_ERR_PRIO_INVALID            42u
+#define OS_ERR_SCHED_LOCKED            50u
+#define OS_ERR_SEM_OVF                 51u
+#define OS_ERR_TASK_CREATE_ISR         60u
+#define OS_ERR_TASK_DEL                61u
+#define OS_ERR_TASK_DEL_IDLE           62u
+#define OS_ERR_TASK_DEL_REQ            63u
+#define OS_ERR_TASK_DEL_ISR            64u
+#define OS_ERR_TASK_NO_MORE_TCB        66u
+#define OS_ERR_TASK_NOT_EXIST          67u
+#define OS_ERR_TASK_NOT_SUSPENDED      68u
+#define OS_ERR_TASK_OPT                69u
+#define OS_ERR_TASK_RESUME_PRIO        70u
+#define OS_ERR_TASK_SUSPEND_IDLE       71u
+#define OS_ERR_TASK_SUSPEND_PRIO       72u
+#define OS_ERR_TASK_WAITING            73u
+#define OS_ERR_TIME_NOT_DLY            80u
+#define OS_ERR_MEM_INVALID_PART        90u
+#define OS_ERR_MEM_INVALID_BLKS        91u
+#define OS_ERR_MEM_INVALID_SIZE        92u
+#define OS_ERR_MEM_NO_FREE_BLKS        93u
+#define OS_ERR_MEM_FULL                94u
+#define OS_ERR_MEM_INVALID_PBLK        95u
+#define OS_ERR_MEM_INVALID_PMEM        96u
+#define OS_ERR_MEM_INVALID_PDATA       97u
+#define OS_ERR_MEM_INVALID_ADDR        98u
+#define OS_ERR_NOT_MUTEX_OWNER        100u
+#define OS_ERR_FLAG_INVALID_PGRP      110u
+#define OS_ERR_FLAG_WAIT_TYPE         111u
+#define OS_ERR_FLAG_NOT_RDY           112u
+#define OS_ERR_FLAG_INVALID_OPT       113u
+#define OS_ERR_FLAG_GRP_DEPLETED      114u
+#define OS_ERR_PCP_LOWER              120u
+#define OS_ERR_TMR_INVALID_DLY        130u
+#define OS_ERR_TMR_INVALID_PERIOD     131u
+#define OS_ERR_TMR_INVALID_OPT        132u
+#define OS_ERR_TMR_NON_AVAIL          134u
+#define OS_ERR_TMR_INACTIVE           135u
+#define OS_ERR_TMR_INVALID_TYPE       137u
+#define OS_ERR_TMR_INVALID            138u
+#define OS_ERR_TMR_ISR                139u
+#define OS_ERR_TMR_INVALID_STATE      141u
+#define OS_ERR_TMR_STOPPED            142u
+#define OS_ERR_TMR_NO_CALLBACK        143u
+
+/* ==== Types ==== */
+#if OS_FLAGS_NBITS == 8u
+typedef INT8U  OS_FLAGS;
+#elif OS_FLAGS_NBITS == 16u
+typedef INT16U OS_FLAGS;
+#else
+typedef INT32U OS_FLAGS;
+#endif
+
+typedef INT8U  OS_PRIO;
+
+typedef struct os_event {
+  INT8U    OSEventType;
+  void    *OSEventPtr;          /* queue control block or mutex owner TCB */
+  INT16U   OSEventCnt;
+  OS_PRIO  OSEventGrp;
+  OS_PRIO  OSEventTbl[OS_EVENT_TBL_SIZE];
+  INT8U   *OSEventName;
+} OS_EVENT;
+
+typedef struct os_flag_grp {
+  INT8U     OSFlagType;
+  void     *OSFlagWaitList;
+  OS_FLAGS  OSFlagFlags;
+  INT8U    *OSFlagName;
+} OS_FLAG_GRP;
+
+typedef struct os_mem {
+  void   *OSMemAddr;
+  void   *OSMemFreeList;
+  INT32U  OSMemBlkSize;
+  INT32U  OSMemNBlks;
+  INT32U  OSMemNFree;
+  INT8U  *OSMemName;
+} OS_MEM;
+
+typedef struct os_mem_data {
+  void   *OSAddr;
+  void   *OSFreeList;
+  INT32U  OSBlkSize;
+  INT32U  OSNBlks;
+  INT32U  OSNFree;
+  INT32U  OSNUsed;
+} OS_MEM_DATA;
+
+typedef struct os_q {
+  struct os_q  *OSQPtr;
+  void        **OSQStart;
+  void        **OSQEnd;
+  void        **OSQIn;
+  void        **OSQOut;
+  INT16U        OSQSize;
+  INT16U        OSQEntries;
+} OS_Q;
+
+typedef struct os_q_data {
+  void    *OSMsg;
+  INT16U   OSNMsgs;
+  INT16U   OSQSize;
+  OS_PRIO  OSEventTbl[OS_EVENT_TBL_SIZE];
+  OS_PRIO  OSEventGrp;
+} OS_Q_DATA;
+
+typedef struct os_sem_data {
+  INT16U   OSCnt;
+  OS_PRIO  OSEventTbl[OS_EVENT_TBL_SIZE];
+  OS_PRIO  OSEventGrp;
+} OS_SEM_DATA;
+
+typedef struct os_stk_data {
+  INT32U  OSFree;               /* bytes */
+  INT32U  OSUsed;               /* bytes */
+} OS_STK_DATA;
+
+typedef struct os_tcb {
+  OS_STK          *OSTCBStkPtr;
+  void            *OSTCBExtPtr;
+  OS_STK          *OSTCBStkBottom;
+  INT32U           OSTCBStkSize;
+  INT16U           OSTCBOpt;
+  INT16U           OSTCBId;
+
+  struct os_tcb   *OSTCBNext;
+  struct os_tcb   *OSTCBPrev;
+
+  OS_EVENT        *OSTCBEventPtr;
+  void            *OSTCBMsg;
+  OS_FLAG_GRP     *OSTCBFlagGrp;    /* sim: group pended on */
+  OS_FLAGS         OSTCBFlagsPend;  /* sim: flags pended on */
+  INT8U            OSTCBFlagWaitType;
+  OS_FLAGS         OSTCBFlagsRdy;
+
+  INT32U           OSTCBDly;
+  INT8U            OSTCBStat;
+  INT8U            OSTCBStatPend;
+  INT8U            OSTCBPrio;
+  INT8U            OSTCBDelReq;
+
+#if OS_TASK_PROFILE_EN > 0u
+  INT32U           OSTCBCtxSwCtr;
+  INT32U           OSTCBCyclesTot;
+  INT32U           OSTCBCyclesStart;
+  OS_STK          *OSTCBStkBase;
+  INT32U           OSTCBStkUsed;
+#endif
+
+#if OS_TASK_NAME_EN > 0u
+  INT8U           *OSTCBTaskName;
+#endif
+
+  /* Simulator-private */
+  void           (*SimEntry)(void *p_arg);
+  void            *SimArg;
+  void            *SimCtxPtr;
+} OS_TCB;
+
+typedef void (*OS_TMR_CALLBACK)(void *ptmr, void *parg);
+
+typedef struct os_tmr {
+  INT8U            OSTmrType;
+  OS_TMR_CALLBACK  OSTmrCallback;
+  void            *OSTmrCallbackArg;
+  void            *OSTmrNext;
+  void            *OSTmrPrev;
+  INT32U           OSTmrMatch;
+  INT32U           OSTmrDly;
+  INT32U           OSTmrPeriod;
+  INT8U           *OSTmrName;
+  INT8U            OSTmrOpt;
+  INT8U            OSTmrState;
+  INT32U           SimRemain;       /* sim: ticks to next expiry */
+  INT32U           SimExpired;      /* sim: expiries not yet dispatched */
+} OS_TMR;
+
+/* ==== Kernel variables ==== */
+extern INT32U   OSCtxSwCtr;
+extern INT32U   OSIdleCtr;
+extern INT8U    OSIntNesting;
+extern INT8U    OSLockNesting;
+extern INT8U    OSPrioCur;
+extern INT8U    OSPrioHighRdy;
+extern BOOLEAN  OSRunning;
+extern INT8U    OSTaskCtr;
+extern OS_TCB  *OSTCBCur;
+extern OS_TCB  *OSTCBHighRdy;
+extern OS_TCB  *OSTCBList;
+extern OS_TCB  *OSTCBPrioTbl[OS_LOWEST_PRIO + 1u];
+extern volatile INT32U OSTime;
+
+/* ==== Services ==== */
+void        OSInit(void);
+void        OSStart(void);
+void        OSIntEnter(void);
+void        OSIntExit(void);
+void        OSSchedLock(void);
+void        OSSchedUnlock(void);
+void        OS_Sched(void);
+INT16U      OSVersion(void);
+
+INT8U       OSTaskCreate(void (*task)(void *p_arg), void *p_arg, OS_STK *ptos, INT8U prio);
+INT8U       OSTaskCreateExt(void   (*task)(void *p_arg),
+                            void    *p_arg,
+                            OS_STK  *ptos,
+                            INT8U    prio,
+                            INT16U   id,
+                            OS_STK  *pbos,
+                            INT32U   stk_size,
+                            void    *pext,
+                            INT16U   opt);
+INT8U       OSTaskDel(INT8U prio);
+INT8U       OSTaskSuspend(INT8U prio);
+INT8U       OSTaskResume(INT8U prio);
+INT8U       OSTaskChangePrio(INT8U oldprio, INT8U newprio);
+INT8U       OSTaskStkChk(INT8U prio, OS_STK_DATA *p_stk_data);
+void        OSTaskNameSet(INT8U prio, INT8U *pname, INT8U *perr);
+
+void        OSTimeDly(INT32U ticks);
+INT8U       OSTimeDlyResume(INT8U prio);
+INT32U      OSTimeGet(void);
+void        OSTimeTick(void);
+
+OS_EVENT   *OSSemCreate(INT16U cnt);
+OS_EVENT   *OSSemDel(OS_EVENT *pevent, INT8U opt, INT8U *perr);
+INT16U      OSSemAccept(OS_EVENT *pevent);
+void        OSSemPend(OS_EVENT *pevent, INT32U timeout, INT8U *perr);
+INT8U       OSSemPost(OS_EVENT *pevent);
+INT8U       OSSemQuery(OS_EVENT *pevent, OS_SEM_DATA *p_sem_data);
+void        OSSemSet(OS_EVENT *pevent, INT16U cnt, INT8U *perr);
+
+OS_EVENT   *OSMutexCreate(INT8U prio, INT8U *perr);
+OS_EVENT   *OSMutexDel(OS_EVENT *pevent, INT8U opt, INT8U *perr);
+BOOLEAN     OSMutexAccept(OS_EVENT *pevent, INT8U *perr);
+void        OSMutexPend(OS_EVENT *pevent, INT32U timeout, INT8U *perr);
+INT8U       OSMutexPost(OS_EVENT *pevent);
+
+OS_EVENT   *OSQCreate(void **start, INT16U size);
+OS_EVENT   *OSQDel(OS_EVENT *pevent, INT8U opt, INT8U *perr);
+void       *OSQAccept(OS_EVENT *pevent, INT8U *perr);
+INT8U       OSQFlush(OS_EVENT *pevent);
+void       *OSQPend(OS_EVENT *pevent, INT32U timeout, INT8U *perr);
+INT8U       OSQPost(OS_EVENT *pevent, void *pmsg);
+INT8U       OSQQuery(OS_EVENT *pevent, OS_Q_DATA *p_q_data);
+
+OS_FLAG_GRP *OSFlagCreate(OS_FLAGS flags, INT8U *perr);
+OS_FLAG_GRP *OSFlagDel(OS_FLAG_GRP *pgrp, INT8U opt, INT8U *perr);
+OS_FLAGS    OSFlagAccept(OS_FLAG_GRP *pgrp, OS_FLAGS flags, INT8U wait_type, INT8U *perr);
+OS_FLAGS    OSFlagPend(OS_FLAG_GRP *pgrp, OS_FLAGS flags, INT8U wait_type, INT32U timeout, INT8U *perr);
+OS_FLAGS    OSFlagPendGetFlagsRdy(void);
+OS_FLAGS    OSFlagPost(OS_FLAG_GRP *pgrp, OS_FLAGS flags, INT8U opt, INT8U *perr);
+OS_FLAGS    OSFlagQuery(OS_FLAG_GRP *pgrp, INT8U *perr);
+
+OS_MEM     *OSMemCreate(void *addr, INT32U nblks, INT32U blksize, INT8U *perr);
+void       *OSMemGet(OS_MEM *pmem, INT8U *perr);
+INT8U       OSMemPut(OS_MEM *pmem, void *pblk);
+INT8U       OSMemQuery(OS_MEM *pmem, OS_MEM_DATA *p_mem_data);
+
+OS_TMR     *OSTmrCreate(INT32U dly, INT32U period, INT8U opt, OS_TMR_CALLBACK callback,
+                        void *callback_arg, INT8U *pname, INT8U *perr);
+BOOLEAN     OSTmrDel(OS_TMR *ptmr, INT8U *perr);
+INT32U      OSTmrRemainGet(OS_TMR *ptmr, INT8U *perr);
+BOOLEAN     OSTmrStart(OS_TMR *ptmr, INT8U *perr);
+INT8U       OSTmrStateGet(OS_TMR *ptmr, INT8U *perr);
+BOOLEAN     OSTmrStop(OS_TMR *ptmr, INT8U opt, void *callback_arg, INT8U *perr);
+
+/* ==== Port hooks (os_cpu_c.c) ==== */
+void        OSTaskCreateHook(OS_TCB *ptcb);
+void        OSTaskDelHook(OS_TCB *ptcb);
+void        OSTaskIdleHook(void);
+void        OSTaskReturnHook(OS_TCB *ptcb);
+void        OSTaskSwHook(void);
+void        OSTimeTickHook(void);
+
+/* ==== Application hooks (app_hooks.c) ==== */
+#if OS_APP_HOOKS_EN > 0u
+void        App_TaskCreateHook(OS_TCB *ptcb);
+void        App_TaskDelHook(OS_TCB *ptcb);
+void        App_TaskIdleHook(void);
+void        App_TaskReturnHook(OS_TCB *ptcb);
+void        App_TaskSwHook(void);
+void        App_TimeTickHook(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OS_uCOS_II_H */
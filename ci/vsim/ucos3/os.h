@@ -0,0 +1,523 @@
+#ifndef OS_H
+#define OS_H
+
+/*
+ * uC/OS-III API surface implemented by the virtual-time simulator.
+ *
+ * Only the services, types and kernel variables used by the CMSIS-RTOS2
+ * wrapper are provided. Names, signatures, option values and the public
+ * control-block fields follow uC/OS-III v3.08.02 so the wrapper builds
+ * unchanged; internal fields are reduced to what the simulator needs.
+ */
+
+#define OS_VERSION  30802u
+
+#include "os_cfg.h"
+#include "os_cfg_app.h"
+#include <cpu_core.h>
+#include <os_cpu.h>
+#include "os_trace.h"
+
+#ifndef OS_CFG_TLS_TBL_SIZE
+#define OS_CFG_TLS_TBL_SIZE  0u
+#endif
+
+#ifndef OS_CFG_STAT_TASK_STK_CHK_EN
+#define OS_CFG_STAT_TASK_STK_CHK_EN  0u
+#endif
+
+/* ==== Types ==== */
+
+typedef CPU_INT16U  OS_CPU_USAGE;
+typedef CPU_INT32U  OS_CTR;
+typedef CPU_INT32U  OS_CTX_SW_CTR;
+typedef CPU_INT32U  OS_CYCLES;
+typedef CPU_INT32U  OS_FLAGS;
+typedef CPU_INT32U  OS_IDLE_CTR;
+typedef CPU_INT16U  OS_MEM_QTY;
+typedef CPU_INT32U  OS_MEM_SIZE;
+typedef CPU_INT16U  OS_MSG_QTY;
+typedef CPU_INT16U  OS_MSG_SIZE;
+typedef CPU_INT08U  OS_NESTING_CTR;
+typedef CPU_INT16U  OS_OBJ_QTY;
+typedef CPU_INT32U  OS_OBJ_TYPE;
+typedef CPU_INT16U  OS_OPT;
+typedef CPU_INT08U  OS_PRIO;
+typedef CPU_INT16U  OS_QTY;
+typedef CPU_INT32U  OS_RATE_HZ;
+typedef CPU_INT32U  OS_REG;
+typedef CPU_INT08U  OS_REG_ID;
+typedef CPU_INT32U  OS_SEM_CTR;
+typedef CPU_INT08U  OS_STATE;
+typedef CPU_INT08U  OS_STATUS;
+typedef CPU_INT32U  OS_TICK;
+typedef void       *OS_TLS;
+typedef CPU_DATA    OS_TLS_ID;
+
+typedef enum os_err {
+  OS_ERR_NONE                 =     0u,
+  OS_ERR_A                    = 10000u,
+  OS_ERR_ACCEPT_ISR           = 10001u,
+  OS_ERR_CREATE_ISR           = 12001u,
+  OS_ERR_DEL_ISR              = 13001u,
+  OS_ERR_FLUSH_ISR            = 15001u,
+  OS_ERR_FLAG_GRP_DEPLETED    = 15101u,
+  OS_ERR_FLAG_NOT_RDY         = 15102u,
+  OS_ERR_FLAG_PEND_OPT        = 15103u,
+  OS_ERR_ILLEGAL_CREATE_RUN_TIME = 16001u,
+  OS_ERR_ILLEGAL_DEL_RUN_TIME = 16002u,
+  OS_ERR_LOCK_NESTING_OVF     = 20001u,
+  OS_ERR_MEM_CREATE_ISR       = 22201u,
+  OS_ERR_MEM_FULL             = 22202u,
+  OS_ERR_MEM_INVALID_BLKS     = 22204u,
+  OS_ERR_MEM_INVALID_P_ADDR   = 22206u,
+  OS_ERR_MEM_INVALID_P_BLK    = 22208u,
+  OS_ERR_MEM_INVALID_SIZE     = 22212u,
+  OS_ERR_MEM_NO_FREE_BLKS     = 22213u,
+  OS_ERR_MSG_POOL_EMPTY       = 22301u,
+  OS_ERR_MUTEX_NOT_OWNER      = 22401u,
+  OS_ERR_MUTEX_OWNER          = 22402u,
+  OS_ERR_MUTEX_NESTING        = 22403u,
+  OS_ERR_MUTEX_OVF            = 22404u,
+  OS_ERR_OBJ_CREATED          = 24001u,
+  OS_ERR_OBJ_DEL              = 24002u,
+  OS_ERR_OBJ_PTR_NULL         = 24003u,
+  OS_ERR_OBJ_TYPE             = 24004u,
+  OS_ERR_OPT_INVALID          = 24101u,
+  OS_ERR_OS_NOT_RUNNING       = 24201u,
+  OS_ERR_OS_RUNNING           = 24202u,
+  OS_ERR_PEND_ABORT           = 25001u,
+  OS_ERR_PEND_ABORT_ISR       = 25002u,
+  OS_ERR_PEND_ABORT_NONE      = 25004u,
+  OS_ERR_PEND_ISR             = 25005u,
+  OS_ERR_PEND_LOCKED          = 25006u,
+  OS_ERR_PEND_WOULD_BLOCK     = 25007u,
+  OS_ERR_POST_NULL_PTR        = 25101u,
+  OS_ERR_POST_ISR             = 25102u,
+  OS_ERR_PRIO_EXIST           = 25201u,
+  OS_ERR_PRIO_INVALID         = 25203u,
+  OS_ERR_PTR_INVALID          = 25301u,
+  OS_ERR_Q_EMPTY              = 26001u,
+  OS_ERR_Q_FULL               = 26002u,
+  OS_ERR_Q_MAX                = 26003u,
+  OS_ERR_Q_SIZE               = 26004u,
+  OS_ERR_SCHED_INVALID_TIME_SLICE = 28001u,
+  OS_ERR_SCHED_LOCK_ISR       = 28002u,
+  OS_ERR_SCHED_LOCKED         = 28003u,
+  OS_ERR_SCHED_NOT_LOCKED     = 28004u,
+  OS_ERR_SCHED_UNLOCK_ISR     = 28005u,
+  OS_ERR_SEM_OVF              = 28101u,
+  OS_ERR_SET_ISR              = 28102u,
+  OS_ERR_STAT_STK_INVALID     = 28209u,
+  OS_ERR_STK_INVALID          = 28301u,
+  OS_ERR_STK_SIZE_INVALID     = 28302u,
+  OS_ERR_STK_LIMIT_INVALID    = 28303u,
+  OS_ERR_TASK_CHANGE_PRIO_ISR = 29001u,
+  OS_ERR_TASK_CREATE_ISR      = 29002u,
+  OS_ERR_TASK_DEL             = 29003u,
+  OS_ERR_TASK_DEL_IDLE        = 29004u,
+  OS_ERR_TASK_DEL_INVALID     = 29005u,
+  OS_ERR_TASK_DEL_ISR         = 29006u,
+  OS_ERR_TASK_INVALID         = 29007u,
+  OS_ERR_TASK_NO_MORE_TCB     = 29008u,
+  OS_ERR_TASK_NOT_DLY         = 29009u,
+  OS_ERR_TASK_NOT_EXIST       = 29010u,
+  OS_ERR_TASK_NOT_SUSPENDED   = 29011u,
+  OS_ERR_TASK_OPT             = 29012u,
+  OS_ERR_TASK_RESUME_ISR      = 29013u,
+  OS_ERR_TASK_RESUME_PRIO     = 29014u,
+  OS_ERR_TASK_RESUME_SELF     = 29015u,
+  OS_ERR_TASK_RUNNING         = 29016u,
+  OS_ERR_TASK_STK_CHK_ISR     = 29017u,
+  OS_ERR_TASK_SUSPENDED       = 29018u,
+  OS_ERR_TASK_SUSPEND_IDLE    = 29019u,
+  OS_ERR_TASK_SUSPEND_INT_HANDLER = 29020u,
+  OS_ERR_TASK_SUSPEND_ISR     = 29021u,
+  OS_ERR_TASK_SUSPEND_PRIO    = 29022u,
+  OS_ERR_TASK_WAITING         = 29023u,
+  OS_ERR_TASK_SUSPEND_CTR_OVF = 29024u,
+  OS_ERR_TCB_INVALID          = 29100u,
+  OS_ERR_TIME_DLY_ISR         = 29101u,
+  OS_ERR_TIME_INVALID_HOURS   = 29102u,
+  OS_ERR_TIME_NOT_DLY         = 29106u,
+  OS_ERR_TIME_ZERO_DLY        = 29108u,
+  OS_ERR_TIMEOUT              = 29401u,
+  OS_ERR_TLS_ID_INVALID       = 29501u,
+  OS_ERR_TLS_NO_MORE_AVAIL    = 29502u,
+  OS_ERR_TMR_INACTIVE         = 29601u,
+  OS_ERR_TMR_INVALID_DEST     = 29602u,
+  OS_ERR_TMR_INVALID_DLY      = 29603u,
+  OS_ERR_TMR_INVALID_PERIOD   = 29604u,
+  OS_ERR_TMR_INVALID_STATE    = 29605u,
+  OS_ERR_TMR_INVALID          = 29606u,
+  OS_ERR_TMR_ISR              = 29607u,
+  OS_ERR_TMR_NO_CALLBACK      = 29608u,
+  OS_ERR_TMR_NON_AVAIL        = 29609u,
+  OS_ERR_TMR_STOPPED          = 29611u,
+  OS_ERR_X                    = 33000u
+} OS_ERR;
+
+/* ==== Options ==== */
+
+#define OS_OPT_NONE                 (OS_OPT)(0x0000u)
+
+#define OS_OPT_DEL_NO_PEND          (OS_OPT)(0x0000u)
+#define OS_OPT_DEL_ALWAYS           (OS_OPT)(0x0001u)
+
+#define OS_OPT_PEND_FLAG_MASK       (OS_OPT)(0x000Fu)
+#define OS_OPT_PEND_FLAG_CLR_ALL    (OS_OPT)(0x0001u)
+#define OS_OPT_PEND_FLAG_CLR_AND    (OS_OPT)(0x0001u)
+#define OS_OPT_PEND_FLAG_CLR_ANY    (OS_OPT)(0x0002u)
+#define OS_OPT_PEND_FLAG_CLR_OR     (OS_OPT)(0x0002u)
+#define OS_OPT_PEND_FLAG_SET_ALL    (OS_OPT)(0x0004u)
+#define OS_OPT_PEND_FLAG_SET_AND    (OS_OPT)(0x0004u)
+#define OS_OPT_PEND_FLAG_SET_ANY    (OS_OPT)(0x0008u)
+#define OS_OPT_PEND_FLAG_SET_OR     (OS_OPT)(0x0008u)
+#define OS_OPT_PEND_FLAG_CONSUME    (OS_OPT)(0x0100u)
+#define OS_OPT_PEND_BLOCKING        (OS_OPT)(0x0000u)
+#define OS_OPT_PEND_NON_BLOCKING    (OS_OPT)(0x8000u)
+
+#define OS_OPT_PEND_ABORT_1         (OS_OPT)(0x0000u)
+#define OS_OPT_PEND_ABORT_ALL       (OS_OPT)(0x0100u)
+
+#define OS_OPT_POST_NONE            (OS_OPT)(0x0000u)
+#define OS_OPT_POST_FLAG_SET        (OS_OPT)(0x0000u)
+#define OS_OPT_POST_FLAG_CLR        (OS_OPT)(0x0001u)
+#define OS_OPT_POST_FIFO            (OS_OPT)(0x0000u)
+#define OS_OPT_POST_LIFO            (OS_OPT)(0x0010u)
+#define OS_OPT_POST_1               (OS_OPT)(0x0000u)
+#define OS_OPT_POST_ALL             (OS_OPT)(0x0200u)
+#define OS_OPT_POST_NO_SCHED        (OS_OPT)(0x8000u)
+
+#define OS_OPT_TASK_NONE            (OS_OPT)(0x0000u)
+#define OS_OPT_TASK_STK_CHK         (OS_OPT)(0x0001u)
+#define OS_OPT_TASK_STK_CLR         (OS_OPT)(0x0002u)
+#define OS_OPT_TASK_SAVE_FP         (OS_OPT)(0x0004u)
+#define OS_OPT_TASK_NO_TLS          (OS_OPT)(0x0008u)
+
+#define OS_OPT_TIME_DLY             (OS_OPT)(0x0000u)
+#define OS_OPT_TIME_TIMEOUT         (OS_OPT)(0x0002u)
+#define OS_OPT_TIME_MATCH           (OS_OPT)(0x0004u)
+#define OS_OPT_TIME_PERIODIC        (OS_OPT)(0x0008u)
+
+#define OS_OPT_TMR_NONE             (OS_OPT)(0u)
+#define OS_OPT_TMR_ONE_SHOT         (OS_OPT)(1u)
+#define OS_OPT_TMR_PERIODIC         (OS_OPT)(2u)
+#define OS_OPT_TMR_CALLBACK         (OS_OPT)(3u)
+#define OS_OPT_TMR_CALLBACK_ARG     (OS_OPT)(4u)
+
+/* ==== States ==== */
+
+#define OS_STATE_OS_STOPPED         (OS_STATE)(0u)
+#define OS_STATE_OS_RUNNING         (OS_STATE)(1u)
+
+#define OS_TASK_STATE_RDY                     (OS_STATE)(0u)
+#define OS_TASK_STATE_DLY                     (OS_STATE)(1u)
+#define OS_TASK_STATE_PEND                    (OS_STATE)(2u)
+#define OS_TASK_STATE_PEND_TIMEOUT            (OS_STATE)(3u)
+#define OS_TASK_STATE_SUSPENDED               (OS_STATE)(4u)
+#define OS_TASK_STATE_DLY_SUSPENDED           (OS_STATE)(5u)
+#define OS_TASK_STATE_PEND_SUSPENDED          (OS_STATE)(6u)
+#define OS_TASK_STATE_PEND_TIMEOUT_SUSPENDED  (OS_STATE)(7u)
+#define OS_TASK_STATE_DEL                     (OS_STATE)(255u)
+
+#define OS_TASK_PEND_ON_NOTHING     (OS_STATE)(0u)
+#define OS_TASK_PEND_ON_FLAG        (OS_STATE)(1u)
+#define OS_TASK_PEND_ON_TASK_Q      (OS_STATE)(2u)
+#define OS_TASK_PEND_ON_COND        (OS_STATE)(3u)
+#define OS_TASK_PEND_ON_MUTEX       (OS_STATE)(4u)
+#define OS_TASK_PEND_ON_Q           (OS_STATE)(5u)
+#define OS_TASK_PEND_ON_SEM         (OS_STATE)(6u)
+#define OS_TASK_PEND_ON_TASK_SEM    (OS_STATE)(7u)
+
+#define OS_STATUS_PEND_OK           (OS_STATUS)(0u)
+#define OS_STATUS_PEND_ABORT        (OS_STATUS)(1u)
+#define OS_STATUS_PEND_DEL          (OS_STATUS)(2u)
+#define OS_STATUS_PEND_TIMEOUT      (OS_STATUS)(3u)
+
+#define OS_TMR_STATE_UNUSED         (OS_STATE)(0u)
+#define OS_TMR_STATE_STOPPED        (OS_STATE)(1u)
+#define OS_TMR_STATE_RUNNING        (OS_STATE)(2u)
+#define OS_TMR_STATE_COMPLETED      (OS_STATE)(3u)
+#define OS_TMR_STATE_TIMEOUT        (OS_STATE)(4u)
+
+#define OS_OBJ_TYPE_NONE            (OS_OBJ_TYPE)0x454E4F4Eu
+#define OS_OBJ_TYPE_FLAG            (OS_OBJ_TYPE)0x47414C46u
+#define OS_OBJ_TYPE_MEM             (OS_OBJ_TYPE)0x204D454Du
+#define OS_OBJ_TYPE_MUTEX           (OS_OBJ_TYPE)0x5854554Du
+#define OS_OBJ_TYPE_Q               (OS_OBJ_TYPE)0x55455551u
+#define OS_OBJ_TYPE_SEM             (OS_OBJ_TYPE)0x204D4553u
+#define OS_OBJ_TYPE_TMR             (OS_OBJ_TYPE)0x20524D54u
+
+/* ==== Control blocks ==== */
+
+typedef struct os_flag_grp   OS_FLAG_GRP;
+typedef struct os_mem        OS_MEM;
+typedef struct os_msg        OS_MSG;
+typedef struct os_msg_pool   OS_MSG_POOL;
+typedef struct os_msg_q      OS_MSG_Q;
+typedef struct os_mutex      OS_MUTEX;
+typedef struct os_pend_list  OS_PEND_LIST;
+typedef struct os_q          OS_Q;
+typedef struct os_sem        OS_SEM;
+typedef struct os_tcb        OS_TCB;
+typedef struct os_tmr        OS_TMR;
+
+typedef void (*OS_TASK_PTR)(void *p_arg);
+typedef void (*OS_TMR_CALLBACK_PTR)(void *p_tmr, void *p_arg);
+typedef void (*OS_APP_HOOK_VOID)(void);
+typedef void (*OS_APP_HOOK_TCB)(OS_TCB *p_tcb);
+
+struct os_pend_list {
+  OS_TCB      *HeadPtr;
+  OS_TCB      *TailPtr;
+  OS_OBJ_QTY   NbrEntries;
+};
+
+struct os_msg {
+  OS_MSG      *NextPtr;
+  void        *MsgPtr;
+  OS_MSG_SIZE  MsgSize;
+  CPU_TS       MsgTS;
+};
+
+struct os_msg_pool {
+  OS_MSG      *NextPtr;
+  OS_MSG_QTY   NbrFree;
+  OS_MSG_QTY   NbrUsed;
+  OS_MSG_QTY   NbrUsedMax;
+};
+
+struct os_msg_q {
+  OS_MSG      *InPtr;
+  OS_MSG      *OutPtr;
+  OS_MSG_QTY   NbrEntriesSize;
+  OS_MSG_QTY   NbrEntries;
+  OS_MSG_QTY   NbrEntriesMax;
+};
+
+struct os_tcb {
+  CPU_STK       *StkPtr;
+  void          *ExtPtr;
+  CPU_STK       *StkLimitPtr;
+  CPU_CHAR      *NamePtr;
+  OS_TCB        *NextPtr;
+  OS_TCB        *PrevPtr;
+  CPU_STK       *StkBasePtr;
+  OS_TASK_PTR    TaskEntryAddr;
+  void          *TaskEntryArg;
+  OS_TCB        *PendNextPtr;
+  OS_TCB        *PendPrevPtr;
+  OS_PEND_LIST  *PendListPtr;
+  void          *PendObjPtr;
+  OS_STATE       PendOn;
+  OS_STATUS      PendStatus;
+  OS_STATE       TaskState;
+  OS_PRIO        Prio;
+  OS_PRIO        BasePrio;
+  OS_MUTEX      *MutexGrpHeadPtr;
+  CPU_STK_SIZE   StkSize;
+  OS_OPT         Opt;
+  CPU_TS         TS;
+  OS_SEM_CTR     SemCtr;
+  OS_TICK        TickRemain;
+  void          *MsgPtr;
+  OS_MSG_SIZE    MsgSize;
+  OS_MSG_Q       MsgQ;
+  OS_FLAGS       FlagsPend;
+  OS_FLAGS       FlagsRdy;
+  OS_OPT         FlagsOpt;
+  OS_NESTING_CTR SuspendCtr;
+  OS_CPU_USAGE   CPUUsage;
+  OS_CPU_USAGE   CPUUsageMax;
+  OS_CTX_SW_CTR  CtxSwCtr;
+  CPU_TS         CyclesDelta;
+  CPU_TS         CyclesStart;
+  OS_CYCLES      CyclesTotal;
+  OS_CYCLES      CyclesTotalPrev;
+  CPU_STK_SIZE   StkUsed;
+  CPU_STK_SIZE   StkFree;
+#if (OS_CFG_TLS_TBL_SIZE > 0u)
+  OS_TLS         TLS_Tbl[OS_CFG_TLS_TBL_SIZE];
+#endif
+  /* Simulator-private state. */
+  void          *SimCtxPtr;
+  CPU_INT64U     SimReadySeq;
+  OS_TCB        *SimNextPtr;
+};
+
+struct os_sem {
+  OS_OBJ_TYPE    Type;
+  CPU_CHAR      *NamePtr;
+  OS_PEND_LIST   PendList;
+  OS_SEM_CTR     Ctr;
+  CPU_TS         TS;
+};
+
+struct os_mutex {
+  OS_OBJ_TYPE    Type;
+  CPU_CHAR      *NamePtr;
+  OS_PEND_LIST   PendList;
+  OS_MUTEX      *MutexGrpNextPtr;
+  OS_TCB        *OwnerTCBPtr;
+  OS_NESTING_CTR OwnerNestingCtr;
+  CPU_TS         TS;
+};
+
+struct os_q {
+  OS_OBJ_TYPE    Type;
+  CPU_CHAR      *NamePtr;
+  OS_PEND_LIST   PendList;
+  OS_MSG_Q       MsgQ;
+};
+
+struct os_flag_grp {
+  OS_OBJ_TYPE    Type;
+  CPU_CHAR      *NamePtr;
+  OS_PEND_LIST   PendList;
+  OS_FLAGS       Flags;
+  CPU_TS         TS;
+};
+
+struct os_mem {
+  OS_OBJ_TYPE    Type;
+  void          *AddrPtr;
+  CPU_CHAR      *NamePtr;
+  void          *FreeListPtr;
+  OS_MEM_SIZE    BlkSize;
+  OS_MEM_QTY     NbrMax;
+  OS_MEM_QTY     NbrFree;
+};
+
+struct os_tmr {
+  OS_OBJ_TYPE          Type;
+  CPU_CHAR            *NamePtr;
+  OS_TMR_CALLBACK_PTR  CallbackPtr;
+  void                *CallbackPtrArg;
+  OS_TMR              *NextPtr;
+  OS_TMR              *PrevPtr;
+  OS_TICK              Remain;
+  OS_TICK              Dly;
+  OS_TICK              Period;
+  OS_OPT               Opt;
+  OS_STATE             State;
+  /* Simulator-private state. */
+  OS_TICK              SimExpired;
+};
+
+/* ==== Kernel variables ==== */
+
+extern OS_NESTING_CTR    OSIntNestingCtr;
+extern OS_STATE          OSRunning;
+extern OS_NESTING_CTR    OSSchedLockNestingCtr;
+extern OS_TCB           *OSTCBCurPtr;
+extern OS_TCB           *OSTCBHighRdyPtr;
+extern OS_PRIO           OSPrioCur;
+extern OS_PRIO           OSPrioHighRdy;
+extern OS_CTX_SW_CTR     OSTaskCtxSwCtr;
+extern OS_TICK           OSTickCtr;
+extern OS_IDLE_CTR       OSIdleTaskCtr;
+extern OS_TCB            OSIdleTaskTCB;
+
+#if (OS_CFG_APP_HOOKS_EN > 0u)
+extern OS_APP_HOOK_TCB   OS_AppTaskCreateHookPtr;
+extern OS_APP_HOOK_TCB   OS_AppTaskDelHookPtr;
+extern OS_APP_HOOK_TCB   OS_AppTaskReturnHookPtr;
+extern OS_APP_HOOK_VOID  OS_AppIdleTaskHookPtr;
+extern OS_APP_HOOK_VOID  OS_AppStatTaskHookPtr;
+extern OS_APP_HOOK_VOID  OS_AppTaskSwHookPtr;
+extern OS_APP_HOOK_VOID  OS_AppTimeTickHookPtr;
+#endif
+
+/* Timestamp source: the simulator's virtual cycle counter. */
+#define OS_TS_GET()   ((CPU_TS)vsim_now())
+
+/* ==== Services ==== */
+
+void        OSInit(OS_ERR *p_err);
+void        OSStart(OS_ERR *p_err);
+void        OSSched(void);
+void        OSSchedLock(OS_ERR *p_err);
+void        OSSchedUnlock(OS_ERR *p_err);
+void        OSIntEnter(void);
+void        OSIntExit(void);
+CPU_INT16U  OSVersion(OS_ERR *p_err);
+
+void        OSTimeTick(void);
+void        OSTimeDly(OS_TICK dly, OS_OPT opt, OS_ERR *p_err);
+void        OSTimeDlyResume(OS_TCB *p_tcb, OS_ERR *p_err);
+OS_TICK     OSTimeGet(OS_ERR *p_err);
+
+void        OSTaskCreate(OS_TCB        *p_tcb,
+                         CPU_CHAR      *p_name,
+                         OS_TASK_PTR    p_task,
+                         void          *p_arg,
+                         OS_PRIO        prio,
+                         CPU_STK       *p_stk_base,
+                         CPU_STK_SIZE   stk_limit,
+                         CPU_STK_SIZE   stk_size,
+                         OS_MSG_QTY     q_size,
+                         OS_TICK        time_quanta,
+                         void          *p_ext,
+                         OS_OPT         opt,
+                         OS_ERR        *p_err);
+void        OSTaskDel(OS_TCB *p_tcb, OS_ERR *p_err);
+void        OSTaskSuspend(OS_TCB *p_tcb, OS_ERR *p_err);
+void        OSTaskResume(OS_TCB *p_tcb, OS_ERR *p_err);
+void        OSTaskChangePrio(OS_TCB *p_tcb, OS_PRIO prio_new, OS_ERR *p_err);
+void        OSTaskStkChk(OS_TCB *p_tcb, CPU_STK_SIZE *p_free, CPU_STK_SIZE *p_used, OS_ERR *p_err);
+void       *OSTaskQPend(OS_TICK timeout, OS_OPT opt, OS_MSG_SIZE *p_msg_size, CPU_TS *p_ts, OS_ERR *p_err);
+void        OSTaskQPost(OS_TCB *p_tcb, void *p_void, OS_MSG_SIZE msg_size, OS_OPT opt, OS_ERR *p_err);
+OS_MSG_QTY  OSTaskQFlush(OS_TCB *p_tcb, OS_ERR *p_err);
+OS_SEM_CTR  OSTaskSemPend(OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err);
+OS_SEM_CTR  OSTaskSemPost(OS_TCB *p_tcb, OS_OPT opt, OS_ERR *p_err);
+
+void        OSSemCreate(OS_SEM *p_sem, CPU_CHAR *p_name, OS_SEM_CTR cnt, OS_ERR *p_err);
+OS_OBJ_QTY  OSSemDel(OS_SEM *p_sem, OS_OPT opt, OS_ERR *p_err);
+OS_SEM_CTR  OSSemPend(OS_SEM *p_sem, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err);
+OS_OBJ_QTY  OSSemPendAbort(OS_SEM *p_sem, OS_OPT opt, OS_ERR *p_err);
+OS_SEM_CTR  OSSemPost(OS_SEM *p_sem, OS_OPT opt, OS_ERR *p_err);
+void        OSSemSet(OS_SEM *p_sem, OS_SEM_CTR cnt, OS_ERR *p_err);
+
+void        OSMutexCreate(OS_MUTEX *p_mutex, CPU_CHAR *p_name, OS_ERR *p_err);
+OS_OBJ_QTY  OSMutexDel(OS_MUTEX *p_mutex, OS_OPT opt, OS_ERR *p_err);
+void        OSMutexPend(OS_MUTEX *p_mutex, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err);
+void        OSMutexPost(OS_MUTEX *p_mutex, OS_OPT opt, OS_ERR *p_err);
+
+void        OSQCreate(OS_Q *p_q, CPU_CHAR *p_name, OS_MSG_QTY max_qty, OS_ERR *p_err);
+OS_OBJ_QTY  OSQDel(OS_Q *p_q, OS_OPT opt, OS_ERR *p_err);
+OS_MSG_QTY  OSQFlush(OS_Q *p_q, OS_ERR *p_err);
+void       *OSQPend(OS_Q *p_q, OS_TICK timeout, OS_OPT opt, OS_MSG_SIZE *p_msg_size, CPU_TS *p_ts, OS_ERR *p_err);
+void        OSQPost(OS_Q *p_q, void *p_void, OS_MSG_SIZE msg_size, OS_OPT opt, OS_ERR *p_err);
+
+void        OSFlagCreate(OS_FLAG_GRP *p_grp, CPU_CHAR *p_name, OS_FLAGS flags, OS_ERR *p_err);
+OS_OBJ_QTY  OSFlagDel(OS_FLAG_GRP *p_grp, OS_OPT opt, OS_ERR *p_err);
+OS_FLAGS    OSFlagPend(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err);
+OS_FLAGS    OSFlagPendGetFlagsRdy(OS_ERR *p_err);
+OS_FLAGS    OSFlagPost(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_OPT opt, OS_ERR *p_err);
+
+void        OSMemCreate(OS_MEM *p_mem, CPU_CHAR *p_name, void *p_addr, OS_MEM_QTY n_blks, OS_MEM_SIZE blk_size, OS_ERR *p_err);
+void       *OSMemGet(OS_MEM *p_mem, OS_ERR *p_err);
+void        OSMemPut(OS_MEM *p_mem, void *p_blk, OS_ERR *p_err);
+
+void        OSTmrCreate(OS_TMR *p_tmr, CPU_CHAR *p_name, OS_TICK dly, OS_TICK period, OS_OPT opt,
+                        OS_TMR_CALLBACK_PTR p_callback, void *p_callback_arg, OS_ERR *p_err);
+CPU_BOOLEAN OSTmrDel(OS_TMR *p_tmr, OS_ERR *p_err);
+void        OSTmrSet(OS_TMR *p_tmr, OS_TICK dly, OS_TICK period,
+                     OS_TMR_CALLBACK_PTR p_callback, void *p_callback_arg, OS_ERR *p_err);
+OS_TICK     OSTmrRemainGet(OS_TMR *p_tmr, OS_ERR *p_err);
+CPU_BOOLEAN OSTmrStart(OS_TMR *p_tmr, OS_ERR *p_err);
+OS_STATE    OSTmrStateGet(OS_TMR *p_tmr, OS_ERR *p_err);
+CPU_BOOLEAN OSTmrStop(OS_TMR *p_tmr, OS_OPT opt, void *p_callback_arg, OS_ERR *p_err);
+
+#if (OS_CFG_TLS_TBL_SIZE > 0u)
+OS_TLS_ID   OS_TLS_GetID(OS_ERR *p_err);
+OS_TLS      OS_TLS_GetValue(OS_TCB *p_tcb, OS_TLS_ID id, OS_ERR *p_err);
+void        OS_TLS_SetValue(OS_TCB *p_tcb, OS_TLS_ID id, OS_TLS value, OS_ERR *p_err);
+#endif
+
+/* Port hooks (os_cpu_c.c in a real port). */
+void        OSTaskSwHook(void);
+void        OSTimeTickHook(void);
+
+#endif /* OS_H */
@@ -0,0 +1,19 @@
+#ifndef OS_CFG_APP_H
+#define OS_CFG_APP_H
+
+/* uC/OS-III application configuration used by the virtual-time simulator. */
+
+#define OS_CFG_MSG_POOL_SIZE             256u
+#define OS_CFG_ISR_STK_SIZE              128u
+#define OS_CFG_TASK_STK_LIMIT_PCT_EMPTY  10u
+
+#define OS_CFG_IDLE_TASK_STK_SIZE        64u
+
+#define OS_CFG_TICK_RATE_HZ              1000u
+
+/* Timer task runs above the CMSIS priority band so callbacks are timely. */
+#define OS_CFG_TMR_TASK_PRIO             2u
+#define OS_CFG_TMR_TASK_RATE_HZ          OS_CFG_TICK_RATE_HZ
+#define OS_CFG_TMR_TASK_STK_SIZE         128u
+
+#endif /* OS_CFG_APP_H */
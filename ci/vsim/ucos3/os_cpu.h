@@ -0,0 +1,26 @@
+#ifndef OS_CPU_H
+#define OS_CPU_H
+
+/*
+ * Virtual-time simulator port: critical sections mask simulated interrupts so
+ * injected ISRs and ticks are deferred until the matching CPU_CRITICAL_EXIT().
+ */
+
+#include "vsim.h"
+
+typedef uint32_t CPU_SR;
+
+#define CPU_SR_ALLOC()       CPU_SR cpu_sr = 0u
+#define CPU_CRITICAL_ENTER() do { cpu_sr = vsim_irq_disable(); } while (0)
+#define CPU_CRITICAL_EXIT()  do { vsim_irq_restore(cpu_sr); } while (0)
+
+/* VSIM_ATOMIC_POINTS: every compare-and-swap of the wrapper's lock-free paths
+ * is an interrupt point, so a scenario can land an ISR between a load and the
+ * CAS that depends on it. */
+#ifdef VSIM_ATOMIC_POINTS
+#define UCOS3_ATOMIC_CAS(p, expected, desired) \
+  (vsim_atomic_point(),                        \
+   __atomic_compare_exchange_n((p), (expected), (desired), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+#endif
+
+#endif /* OS_CPU_H */
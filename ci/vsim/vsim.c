@@ -0,0 +1,345 @@
+#define _XOPEN_SOURCE 700
+
+#include "vsim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+struct vsim_ctx {
+  ucontext_t    uc;
+  vsim_entry_t  entry;
+  void         *arg;
+  void         *stack;
+  vsim_ctx_t   *next_free;
+};
+
+typedef struct vsim_isr_slot {
+  uint64_t   at;
+  uint64_t   seq;
+  vsim_isr_t isr;
+  void      *arg;
+} vsim_isr_slot_t;
+
+vsim_cost_t vsim_cost = {
+  .service    = 120u,
+  .ctx_switch = 250u,
+  .isr_entry  = 60u,
+  .tick       = 400u,
+  .fp_ctx     = 70u,
+  .stk_word   = 1u,
+  .atomic     = 20u,
+};
+
+static struct {
+  uint64_t                 now;
+  uint64_t                 ticks;
+  uint64_t                 horizon;
+  uint64_t                 isr_seq;
+  uint32_t                 isr_depth;
+  uint32_t                 isr_count;
+  uint32_t                 irq_masked;
+  bool                     stopped;
+  ucontext_t               main_uc;
+  vsim_ctx_t              *current;
+  vsim_ctx_t              *zombie;
+  vsim_ctx_t              *free_ctx;
+  const vsim_kernel_ops_t *ops;
+  vsim_trace_fn_t          trace;
+  vsim_isr_slot_t          isrs[VSIM_MAX_PENDING_ISRS];
+} vsim;
+
+void vsim_kernel_register(const vsim_kernel_ops_t *ops) {
+  vsim.ops = ops;
+}
+
+/* ==== Execution contexts ==== */
+
+static void vsim_reap(void) {
+  if ((vsim.zombie != NULL) && (vsim.zombie != vsim.current)) {
+    vsim.zombie->next_free = vsim.free_ctx;
+    vsim.free_ctx = vsim.zombie;
+    vsim.zombie = NULL;
+  }
+}
+
+static void vsim_ctx_trampoline(void) {
+  vsim_reap();
+  vsim_ctx_t *self = vsim.current;
+  self->entry(self->arg);
+
+  /* A task body must never return into the simulator. */
+  fprintf(stderr, "vsim: task entry returned\n");
+  abort();
+}
+
+vsim_ctx_t *vsim_ctx_new(vsim_entry_t entry, void *arg) {
+  vsim_reap();
+
+  vsim_ctx_t *ctx = vsim.free_ctx;
+  if (ctx != NULL) {
+    vsim.free_ctx = ctx->next_free;
+  } else {
+    ctx = (vsim_ctx_t *)calloc(1u, sizeof(*ctx));
+    if (ctx == NULL) {
+      return NULL;
+    }
+    ctx->stack = malloc(VSIM_HOST_STACK_SIZE);
+    if (ctx->stack == NULL) {
+      free(ctx);
+      return NULL;
+    }
+  }
+
+  ctx->entry = entry;
+  ctx->arg = arg;
+  ctx->next_free = NULL;
+  getcontext(&ctx->uc);
+  ctx->uc.uc_stack.ss_sp = ctx->stack;
+  ctx->uc.uc_stack.ss_size = VSIM_HOST_STACK_SIZE;
+  ctx->uc.uc_link = NULL;
+  makecontext(&ctx->uc, vsim_ctx_trampoline, 0);
+  return ctx;
+}
+
+void vsim_ctx_free(vsim_ctx_t *ctx) {
+  if ((ctx == NULL) || (ctx == vsim.current)) {
+    return;
+  }
+  ctx->next_free = vsim.free_ctx;
+  vsim.free_ctx = ctx;
+}
+
+void vsim_ctx_release(vsim_ctx_t *ctx) {
+  if (ctx == vsim.current) {
+    vsim.zombie = ctx;
+  } else {
+    vsim_ctx_free(ctx);
+  }
+}
+
+void vsim_ctx_switch(vsim_ctx_t *from, vsim_ctx_t *to) {
+  if ((from == to) || (to == NULL)) {
+    return;
+  }
+
+  vsim_charge(vsim_cost.ctx_switch);
+  vsim.current = to;
+  if (from == NULL) {
+    setcontext(&to->uc);
+    return;
+  }
+  swapcontext(&from->uc, &to->uc);
+  vsim_reap();
+}
+
+void vsim_ctx_start(vsim_ctx_t *to) {
+  vsim.current = to;
+  vsim.stopped = false;
+  swapcontext(&vsim.main_uc, &to->uc);
+  vsim_reap();
+}
+
+void vsim_stop(void) {
+  vsim.stopped = true;
+  if (vsim.current == NULL) {
+    return;
+  }
+  swapcontext(&vsim.current->uc, &vsim.main_uc);
+}
+
+/* ==== Virtual clock and event dispatch ==== */
+
+uint64_t vsim_now(void) {
+  return vsim.now;
+}
+
+uint64_t vsim_ticks(void) {
+  return vsim.ticks;
+}
+
+void vsim_charge(uint32_t cycles) {
+  vsim.now += cycles;
+}
+
+bool vsim_in_isr(void) {
+  return vsim.isr_depth > 0u;
+}
+
+static void vsim_dispatch(void);
+
+uint32_t vsim_irq_disable(void) {
+  return vsim.irq_masked++;
+}
+
+void vsim_irq_restore(uint32_t prev) {
+  vsim.irq_masked = prev;
+  if (prev == 0u) {
+    vsim_dispatch();
+  }
+}
+
+void vsim_service(void) {
+  vsim_charge(vsim_cost.service);
+  vsim_dispatch();
+}
+
+void vsim_atomic_point(void) {
+  vsim_charge(vsim_cost.atomic);
+  vsim_dispatch();
+}
+
+static uint64_t vsim_next_tick_at(void) {
+  return (vsim.ticks + 1u) * (uint64_t)VSIM_CYCLES_PER_TICK;
+}
+
+static int vsim_next_isr(void) {
+  int best = -1;
+  for (uint32_t i = 0u; i < vsim.isr_count; ++i) {
+    if ((best < 0) ||
+        (vsim.isrs[i].at < vsim.isrs[best].at) ||
+        ((vsim.isrs[i].at == vsim.isrs[best].at) && (vsim.isrs[i].seq < vsim.isrs[best].seq))) {
+      best = (int)i;
+    }
+  }
+  return best;
+}
+
+static uint64_t vsim_next_event_at(void) {
+  uint64_t next = vsim_next_tick_at();
+  int isr = vsim_next_isr();
+  if ((isr >= 0) && (vsim.isrs[isr].at < next)) {
+    next = vsim.isrs[isr].at;
+  }
+  return next;
+}
+
+static void vsim_run_isr(vsim_isr_t isr, void *arg, bool is_tick) {
+  vsim.isr_depth++;
+  if (vsim.ops != NULL) {
+    vsim.ops->int_enter();
+  }
+  vsim_charge(vsim_cost.isr_entry);
+  if (is_tick) {
+    vsim.ticks++;
+    vsim_charge(vsim_cost.tick);
+    if (vsim.ops != NULL) {
+      vsim.ops->tick();
+    }
+  } else {
+    isr(arg);
+  }
+  vsim.isr_depth--;
+  if (vsim.ops != NULL) {
+    vsim.ops->int_exit();
+  }
+}
+
+/* Deliver every event that is due at the current virtual time. */
+static void vsim_dispatch(void) {
+  if ((vsim.isr_depth > 0u) || (vsim.irq_masked > 0u) || vsim.stopped) {
+    return;
+  }
+
+  for (;;) {
+    uint64_t tick_at = vsim_next_tick_at();
+    int isr = vsim_next_isr();
+    bool isr_due = (isr >= 0) && (vsim.isrs[isr].at <= vsim.now) && (vsim.isrs[isr].at <= tick_at);
+    bool tick_due = (tick_at <= vsim.now);
+
+    if (isr_due) {
+      vsim_isr_slot_t slot = vsim.isrs[isr];
+      vsim.isrs[isr] = vsim.isrs[vsim.isr_count - 1u];
+      vsim.isr_count--;
+      vsim_run_isr(slot.isr, slot.arg, false);
+      continue;
+    }
+
+    if (tick_due) {
+      vsim_run_isr(NULL, NULL, true);
+      if ((vsim.horizon != 0u) && (vsim.ticks >= vsim.horizon)) {
+        vsim_stop();
+        return;
+      }
+      continue;
+    }
+
+    break;
+  }
+}
+
+void vsim_consume(uint64_t cycles) {
+  while (cycles > 0u) {
+    uint64_t next = vsim_next_event_at();
+    uint64_t room = (next > vsim.now) ? (next - vsim.now) : 0u;
+    uint64_t step = (cycles < room) ? cycles : room;
+    vsim.now += step;
+    cycles -= step;
+    vsim_dispatch();
+    if (vsim.stopped) {
+      return;
+    }
+  }
+  vsim_dispatch();
+}
+
+void vsim_idle(void) {
+  uint64_t next = vsim_next_event_at();
+  if (next > vsim.now) {
+    vsim.now = next;
+  }
+  vsim_dispatch();
+}
+
+/* ==== Interrupt injection ==== */
+
+bool vsim_isr_at(uint64_t cycle, vsim_isr_t isr, void *arg) {
+  if ((isr == NULL) || (vsim.isr_count >= VSIM_MAX_PENDING_ISRS)) {
+    return false;
+  }
+
+  vsim_isr_slot_t *slot = &vsim.isrs[vsim.isr_count++];
+  slot->at = (cycle < vsim.now) ? vsim.now : cycle;
+  slot->seq = vsim.isr_seq++;
+  slot->isr = isr;
+  slot->arg = arg;
+  return true;
+}
+
+bool vsim_isr_after(uint64_t delay_cycles, vsim_isr_t isr, void *arg) {
+  return vsim_isr_at(vsim.now + delay_cycles, isr, arg);
+}
+
+/* ==== Run control ==== */
+
+void vsim_set_horizon(uint64_t ticks) {
+  vsim.horizon = ticks;
+}
+
+bool vsim_horizon_reached(void) {
+  return (vsim.horizon != 0u) && (vsim.ticks >= vsim.horizon);
+}
+
+void vsim_reset(void) {
+  vsim_trace_fn_t trace = vsim.trace;
+  const vsim_kernel_ops_t *ops = vsim.ops;
+  vsim_ctx_t *free_ctx = vsim.free_ctx;
+
+  memset(&vsim, 0, sizeof(vsim));
+  vsim.trace = trace;
+  vsim.ops = ops;
+  vsim.free_ctx = free_ctx;
+}
+
+/* ==== Trace ==== */
+
+void vsim_trace_set(vsim_trace_fn_t fn) {
+  vsim.trace = fn;
+}
+
+void vsim_trace(const char *event, const char *from, const char *to) {
+  if (vsim.trace != NULL) {
+    vsim.trace(vsim.now, event, from, to);
+  }
+}
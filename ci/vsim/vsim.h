@@ -0,0 +1,106 @@
+#ifndef VSIM_H_
+#define VSIM_H_
+
+/*
+ * Deterministic virtual-time simulator core.
+ *
+ * The simulator runs every kernel task on its own ucontext inside a single
+ * host thread, so exactly one task executes at a time and the interleaving is
+ * decided by the simulated kernel only. Time is a virtual cycle counter that
+ * advances through:
+ *   - vsim_consume(): workload code declaring how many cycles it "spends";
+ *   - the cost model: every simulated kernel service charges a fixed cost;
+ *   - idle skipping: when no task is ready the clock jumps to the next event.
+ * Kernel ticks are injected whenever the cycle counter crosses a tick
+ * boundary, and user ISRs can be scheduled at exact cycle timestamps. Two runs
+ * of the same program therefore produce identical traces and latency figures.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef VSIM_CYCLES_PER_TICK
+#define VSIM_CYCLES_PER_TICK     100000u   /* 100 MHz virtual core, 1 kHz tick */
+#endif
+
+#ifndef VSIM_HOST_STACK_SIZE
+#define VSIM_HOST_STACK_SIZE     (256u * 1024u)
+#endif
+
+#ifndef VSIM_MAX_PENDING_ISRS
+#define VSIM_MAX_PENDING_ISRS    256u
+#endif
+
+/* Fixed virtual costs charged by the simulated kernel. */
+typedef struct vsim_cost {
+  uint32_t service;      /* any kernel service call */
+  uint32_t ctx_switch;   /* one context switch */
+  uint32_t isr_entry;    /* ISR prologue + epilogue */
+  uint32_t tick;         /* tick ISR body */
+  uint32_t fp_ctx;       /* extra save/restore when a task owns FP context */
+  uint32_t stk_word;     /* per-word cost of clearing a task stack */
+  uint32_t atomic;       /* compare-and-swap at an atomic point (VSIM_ATOMIC_POINTS) */
+} vsim_cost_t;
+
+extern vsim_cost_t vsim_cost;
+
+typedef void (*vsim_isr_t)(void *arg);
+typedef void (*vsim_entry_t)(void *arg);
+
+/* Opaque execution context owned by a simulated task. */
+typedef struct vsim_ctx vsim_ctx_t;
+
+/* Kernel back-end callbacks supplied by the API façade (uC/OS-II or -III). */
+typedef struct vsim_kernel_ops {
+  void (*int_enter)(void);
+  void (*int_exit)(void);
+  void (*tick)(void);
+} vsim_kernel_ops_t;
+
+void      vsim_kernel_register(const vsim_kernel_ops_t *ops);
+
+/* ==== Execution contexts ==== */
+vsim_ctx_t *vsim_ctx_new(vsim_entry_t entry, void *arg);
+void        vsim_ctx_free(vsim_ctx_t *ctx);
+void        vsim_ctx_switch(vsim_ctx_t *from, vsim_ctx_t *to);
+void        vsim_ctx_start(vsim_ctx_t *to);   /* leave main, run first task */
+void        vsim_ctx_release(vsim_ctx_t *ctx); /* free once no longer running */
+
+/* ==== Virtual clock ==== */
+uint64_t vsim_now(void);                 /* cycles since reset */
+uint64_t vsim_ticks(void);               /* ticks injected so far */
+void     vsim_charge(uint32_t cycles);   /* advance clock, no event dispatch */
+void     vsim_consume(uint64_t cycles);  /* advance clock and dispatch events */
+void     vsim_idle(void);                /* jump to the next event */
+void     vsim_service(void);             /* kernel service entry: charge + dispatch */
+void     vsim_atomic_point(void);        /* before a wrapper CAS: charge + dispatch */
+
+/* ==== Interrupt injection ==== */
+bool     vsim_isr_at(uint64_t cycle, vsim_isr_t isr, void *arg);
+bool     vsim_isr_after(uint64_t delay_cycles, vsim_isr_t isr, void *arg);
+bool     vsim_in_isr(void);
+uint32_t vsim_irq_disable(void);             /* returns the previous mask depth */
+void     vsim_irq_restore(uint32_t prev);
+
+/* ==== Run control ==== */
+void     vsim_set_horizon(uint64_t ticks);   /* 0 = run forever */
+bool     vsim_horizon_reached(void);
+void     vsim_stop(void);                    /* return to the OSStart caller */
+void     vsim_reset(void);
+
+/* ==== Trace ==== */
+typedef void (*vsim_trace_fn_t)(uint64_t cycle, const char *event,
+                                const char *from, const char *to);
+void     vsim_trace_set(vsim_trace_fn_t fn);
+void     vsim_trace(const char *event, const char *from, const char *to);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VSIM_H_ */
@@ -0,0 +1,1784 @@
+/*
+ * Simulated uC/OS-II kernel for the virtual-time simulator.
+ *
+ * Implements the subset of the uC/OS-II v2.93 API used by the CMSIS-RTOS2
+ * wrapper with the same scheduling rules: one task per priority, strict
+ * fixed-priority preemption, highest-priority waiter first on every event,
+ * tick-driven delays/timeouts and a timer task signalled from the tick. Error
+ * codes follow the real kernel so wrapper error mapping is exercised as on
+ * target. Application hooks are forwarded to App_*Hook(); weak empty defaults
+ * let applications that do not provide app_hooks.c link unchanged.
+ *
+ * Every service charges vsim_cost.service and may deliver due interrupts on
+ * entry; the kernel body itself runs atomically, as it would inside a
+ * critical section on target.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucos_ii.h"
+
+#define OS2_FRAME_WORDS        16u   /* Cortex-M exception frame + R4-R11 */
+#define OS2_FP_FRAME_WORDS     18u   /* S16-S31, FPSCR, reserved */
+#define OS2_MUTEX_AVAILABLE    0x00FFu
+#define OS2_SEM_MAX            65535u
+
+/* ==== Kernel variables ==== */
+
+INT32U           OSCtxSwCtr;
+INT32U           OSIdleCtr;
+INT8U            OSIntNesting;
+INT8U            OSLockNesting;
+INT8U            OSPrioCur;
+INT8U            OSPrioHighRdy;
+BOOLEAN          OSRunning = OS_FALSE;
+INT8U            OSTaskCtr;
+OS_TCB          *OSTCBCur;
+OS_TCB          *OSTCBHighRdy;
+OS_TCB          *OSTCBList;
+OS_TCB          *OSTCBPrioTbl[OS_LOWEST_PRIO + 1u];
+volatile INT32U  OSTime;
+
+static struct {
+  OS_TCB      *tcb_free;
+  OS_EVENT    *event_free;
+  OS_Q        *q_free;
+  OS_FLAG_GRP *flag_free;
+  OS_MEM      *mem_free;
+  OS_TMR      *tmr_free;
+  OS_TMR      *tmr_active[OS_TMR_CFG_MAX];
+  bool         exit_at_horizon;
+  bool         trace;
+} os2;
+
+static OS_TCB      os2_tcb_tbl[OS_MAX_TASKS + 2u];
+static OS_EVENT    os2_event_tbl[OS_MAX_EVENTS];
+static OS_Q        os2_q_tbl[OS_MAX_QS];
+static OS_FLAG_GRP os2_flag_tbl[OS_MAX_FLAGS];
+static OS_MEM      os2_mem_tbl[OS_MAX_MEM_PART];
+static OS_TMR      os2_tmr_tbl[OS_TMR_CFG_MAX];
+static OS_STK      os2_idle_stk[OS_TASK_IDLE_STK_SIZE];
+static OS_STK      os2_tmr_stk[OS_TASK_TMR_STK_SIZE];
+static OS_EVENT   *os2_tmr_sem;
+
+/* ==== Default application hooks ==== */
+
+#if OS_APP_HOOKS_EN > 0u
+__attribute__((weak)) void App_TaskCreateHook(OS_TCB *ptcb) { (void)ptcb; }
+__attribute__((weak)) void App_TaskDelHook(OS_TCB *ptcb) { (void)ptcb; }
+__attribute__((weak)) void App_TaskIdleHook(void) {}
+__attribute__((weak)) void App_TaskReturnHook(OS_TCB *ptcb) { (void)ptcb; }
+__attribute__((weak)) void App_TaskSwHook(void) {}
+__attribute__((weak)) void App_TimeTickHook(void) {}
+#endif
+
+/* ==== Port hooks ==== */
+
+void OSTaskCreateHook(OS_TCB *ptcb) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskCreateHook(ptcb);
+#else
+  (void)ptcb;
+#endif
+}
+
+void OSTaskDelHook(OS_TCB *ptcb) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskDelHook(ptcb);
+#else
+  (void)ptcb;
+#endif
+}
+
+void OSTaskIdleHook(void) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskIdleHook();
+#endif
+}
+
+void OSTaskReturnHook(OS_TCB *ptcb) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskReturnHook(ptcb);
+#else
+  (void)ptcb;
+#endif
+}
+
+void OSTaskSwHook(void) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TaskSwHook();
+#endif
+}
+
+void OSTimeTickHook(void) {
+#if OS_APP_HOOKS_EN > 0u
+  App_TimeTickHook();
+#endif
+}
+
+/* ==== Helpers ==== */
+
+static bool os2_in_isr(void) {
+  return OSIntNesting > 0u;
+}
+
+static void os2_no_block_in_isr(const char *service) {
+  if (os2_in_isr()) {
+    fprintf(stderr, "vsim: blocking %s() called from ISR\n", service);
+    abort();
+  }
+}
+
+static const char *os2_name(const OS_TCB *ptcb) {
+#if OS_TASK_NAME_EN > 0u
+  if ((ptcb != NULL) && (ptcb->OSTCBTaskName != NULL)) {
+    return (const char *)ptcb->OSTCBTaskName;
+  }
+#endif
+  static char buf[8];
+  snprintf(buf, sizeof(buf), "P%u", (ptcb != NULL) ? (unsigned)ptcb->OSTCBPrio : 0u);
+  return buf;
+}
+
+static bool os2_is_ready(const OS_TCB *ptcb) {
+  return (ptcb->OSTCBStat == OS_STAT_RDY) && (ptcb->OSTCBDly == 0u);
+}
+
+static OS_TCB *os2_highest_ready(void) {
+  for (INT32U prio = 0u; prio <= OS_LOWEST_PRIO; ++prio) {
+    OS_TCB *ptcb = OSTCBPrioTbl[prio];
+    if ((ptcb != NULL) && (ptcb != OS_TCB_RESERVED) && os2_is_ready(ptcb)) {
+      return ptcb;
+    }
+  }
+  return NULL;
+}
+
+static OS_TCB *os2_tcb_of(INT8U prio) {
+  if (prio == OS_PRIO_SELF) {
+    return OSTCBCur;
+  }
+  if (prio > OS_LOWEST_PRIO) {
+    return NULL;
+  }
+  OS_TCB *ptcb = OSTCBPrioTbl[prio];
+  return (ptcb == OS_TCB_RESERVED) ? NULL : ptcb;
+}
+
+static INT8U os2_pend_status_err(INT8U stat_pend) {
+  switch (stat_pend) {
+    case OS_STAT_PEND_OK:
+      return OS_ERR_NONE;
+    case OS_STAT_PEND_ABORT:
+      return OS_ERR_PEND_ABORT;
+    default:
+      return OS_ERR_TIMEOUT;
+  }
+}
+
+/* ==== Scheduler ==== */
+
+static void os2_ctx_sw(OS_TCB *to) {
+  OS_TCB *from = OSTCBCur;
+
+  OSTCBHighRdy = to;
+  OSPrioHighRdy = to->OSTCBPrio;
+#if OS_TASK_PROFILE_EN > 0u
+  to->OSTCBCtxSwCtr++;
+#endif
+  OSCtxSwCtr++;
+
+  /* OSCtxSw()/OSIntCtxSw() call the hook with OSTCBCur still pointing at the
+   * outgoing task and OSTCBHighRdy at the incoming one. */
+  OSTaskSwHook();
+
+  if (((from->OSTCBOpt | to->OSTCBOpt) & OS_TASK_OPT_SAVE_FP) != 0u) {
+    vsim_charge(vsim_cost.fp_ctx);
+  }
+  if (os2.trace) {
+    char from_name[32];
+    snprintf(from_name, sizeof(from_name), "%s", os2_name(from));
+    printf("%10llu switch %s -> %s\n",
+           (unsigned long long)vsim_now(), from_name, os2_name(to));
+  }
+  vsim_trace("switch", os2_name(from), os2_name(to));
+
+  OSTCBCur = to;
+  OSPrioCur = to->OSTCBPrio;
+  vsim_ctx_switch((vsim_ctx_t *)from->SimCtxPtr, (vsim_ctx_t *)to->SimCtxPtr);
+}
+
+void OS_Sched(void) {
+  if ((OSRunning != OS_TRUE) || (OSIntNesting > 0u) || (OSLockNesting > 0u)) {
+    return;
+  }
+
+  OS_TCB *high = os2_highest_ready();
+  if ((high == NULL) || (high == OSTCBCur)) {
+    return;
+  }
+  os2_ctx_sw(high);
+}
+
+void OSIntEnter(void) {
+  if (OSRunning != OS_TRUE) {
+    return;
+  }
+  if (OSIntNesting < 255u) {
+    OSIntNesting++;
+  }
+}
+
+void OSIntExit(void) {
+  if (OSRunning != OS_TRUE) {
+    return;
+  }
+  if (OSIntNesting > 0u) {
+    OSIntNesting--;
+  }
+  OS_Sched();
+}
+
+void OSSchedLock(void) {
+  vsim_service();
+  if ((OSRunning == OS_TRUE) && (OSIntNesting == 0u) && (OSLockNesting < 255u)) {
+    OSLockNesting++;
+  }
+}
+
+void OSSchedUnlock(void) {
+  vsim_service();
+  if ((OSRunning != OS_TRUE) || (OSIntNesting > 0u) || (OSLockNesting == 0u)) {
+    return;
+  }
+  OSLockNesting--;
+  if (OSLockNesting == 0u) {
+    OS_Sched();
+  }
+}
+
+INT16U OSVersion(void) {
+  return (INT16U)OS_VERSION;
+}
+
+/* ==== Event wait lists ==== */
+
+static bool os2_event_has_waiters(const OS_EVENT *pevent) {
+  for (OS_TCB *p = OSTCBList; p != NULL; p = p->OSTCBNext) {
+    if (p->OSTCBEventPtr == pevent) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static OS_TCB *os2_event_highest_waiter(const OS_EVENT *pevent) {
+  OS_TCB *best = NULL;
+  for (OS_TCB *p = OSTCBList; p != NULL; p = p->OSTCBNext) {
+    if ((p->OSTCBEventPtr == pevent) && ((best == NULL) || (p->OSTCBPrio < best->OSTCBPrio))) {
+      best = p;
+    }
+  }
+  return best;
+}
+
+/* OS_EventTaskRdy() equivalent: clear the wait and make the task ready. */
+static void os2_task_rdy(OS_TCB *ptcb, void *pmsg, INT8U msk, INT8U pend_stat) {
+  ptcb->OSTCBDly = 0u;
+  ptcb->OSTCBEventPtr = NULL;
+  ptcb->OSTCBFlagGrp = NULL;
+  ptcb->OSTCBMsg = pmsg;
+  ptcb->OSTCBStat &= (INT8U)~msk;
+  ptcb->OSTCBStatPend = pend_stat;
+}
+
+static void os2_event_wait(OS_EVENT *pevent, INT8U msk, INT32U timeout) {
+  OS_TCB *cur = OSTCBCur;
+  cur->OSTCBStat |= msk;
+  cur->OSTCBStatPend = OS_STAT_PEND_OK;
+  cur->OSTCBDly = timeout;
+  cur->OSTCBEventPtr = pevent;
+  OS_Sched();
+}
+
+static INT8U os2_event_flush(OS_EVENT *pevent, INT8U msk, INT8U pend_stat) {
+  INT8U n = 0u;
+  OS_TCB *p;
+  while ((p = os2_event_highest_waiter(pevent)) != NULL) {
+    os2_task_rdy(p, NULL, msk, pend_stat);
+    n++;
+  }
+  return n;
+}
+
+static OS_EVENT *os2_event_alloc(INT8U type) {
+  OS_EVENT *pevent = os2.event_free;
+  if (pevent != NULL) {
+    os2.event_free = (OS_EVENT *)pevent->OSEventPtr;
+    memset(pevent, 0, sizeof(*pevent));
+    pevent->OSEventType = type;
+  }
+  return pevent;
+}
+
+static void os2_event_free(OS_EVENT *pevent) {
+  pevent->OSEventType = OS_EVENT_TYPE_UNUSED;
+  pevent->OSEventCnt = 0u;
+  pevent->OSEventPtr = os2.event_free;
+  os2.event_free = pevent;
+}
+
+/* ==== Tick ==== */
+
+void OSTimeTick(void) {
+  OSTimeTickHook();
+  OSTime++;
+
+  for (OS_TCB *p = OSTCBList; p != NULL; p = p->OSTCBNext) {
+    if ((p->OSTCBDly == 0u) || (--p->OSTCBDly > 0u)) {
+      continue;
+    }
+    if ((p->OSTCBStat & OS_STAT_PEND_ANY) != 0u) {
+      p->OSTCBStat &= (INT8U)~OS_STAT_PEND_ANY;
+      p->OSTCBStatPend = OS_STAT_PEND_TO;
+      p->OSTCBEventPtr = NULL;
+      p->OSTCBFlagGrp = NULL;
+    } else {
+      p->OSTCBStatPend = OS_STAT_PEND_OK;
+    }
+  }
+
+#if OS_TMR_EN > 0u
+  /* Timers are counted down here; the timer task only wakes on expiry. */
+  bool expired = false;
+  for (INT32U i = 0u; i < OS_TMR_CFG_MAX; ++i) {
+    OS_TMR *t = os2.tmr_active[i];
+    if ((t == NULL) || (t->OSTmrState != OS_TMR_STATE_RUNNING) ||
+        (t->SimRemain == 0u) || (--t->SimRemain > 0u)) {
+      continue;
+    }
+    t->SimExpired++;
+    t->SimRemain = (t->OSTmrOpt == OS_TMR_OPT_PERIODIC) ? t->OSTmrPeriod : 0u;
+    t->OSTmrMatch = OSTime + t->SimRemain;
+    expired = true;
+  }
+  if (expired && (os2_tmr_sem != NULL)) {
+    OS_TCB *waiter = os2_event_highest_waiter(os2_tmr_sem);
+    if (waiter != NULL) {
+      os2_task_rdy(waiter, NULL, OS_STAT_SEM, OS_STAT_PEND_OK);
+    } else if (os2_tmr_sem->OSEventCnt < OS2_SEM_MAX) {
+      os2_tmr_sem->OSEventCnt++;
+    }
+  }
+#endif
+}
+
+static void os2_tick_isr(void) {
+  OSTimeTick();
+}
+
+static const vsim_kernel_ops_t os2_ops = {
+  .int_enter = OSIntEnter,
+  .int_exit  = OSIntExit,
+  .tick      = os2_tick_isr,
+};
+
+void OSTimeDly(INT32U ticks) {
+  vsim_service();
+  if (os2_in_isr() || (OSLockNesting > 0u) || (ticks == 0u)) {
+    return;
+  }
+  OSTCBCur->OSTCBDly = ticks;
+  OS_Sched();
+}
+
+INT8U OSTimeDlyResume(INT8U prio) {
+  vsim_service();
+  if (prio >= OS_LOWEST_PRIO) {
+    return OS_ERR_PRIO_INVALID;
+  }
+  OS_TCB *ptcb = os2_tcb_of(prio);
+  if (ptcb == NULL) {
+    return OS_ERR_TASK_NOT_EXIST;
+  }
+  if (ptcb->OSTCBDly == 0u) {
+    return OS_ERR_TIME_NOT_DLY;
+  }
+  ptcb->OSTCBDly = 0u;
+  if ((ptcb->OSTCBStat & OS_STAT_PEND_ANY) != 0u) {
+    ptcb->OSTCBStat &= (INT8U)~OS_STAT_PEND_ANY;
+    ptcb->OSTCBStatPend = OS_STAT_PEND_TO;
+    ptcb->OSTCBEventPtr = NULL;
+    ptcb->OSTCBFlagGrp = NULL;
+  } else {
+    ptcb->OSTCBStatPend = OS_STAT_PEND_OK;
+  }
+  OS_Sched();
+  return OS_ERR_NONE;
+}
+
+INT32U OSTimeGet(void) {
+  return OSTime;
+}
+
+/* ==== Tasks ==== */
+
+static void os2_task_entry(void *arg) {
+  OS_TCB *ptcb = (OS_TCB *)arg;
+  ptcb->SimEntry(ptcb->SimArg);
+
+  OSTaskReturnHook(ptcb);
+  (void)OSTaskDel(OS_PRIO_SELF);
+}
+
+/* Lay out a Cortex-M style initial frame so stack checks see real usage. */
+static OS_STK *os2_task_stk_init(OS_STK *ptos, OS_STK *pbos, INT16U opt) {
+  INT32U frame = OS2_FRAME_WORDS;
+  if ((opt & OS_TASK_OPT_SAVE_FP) != 0u) {
+    frame += OS2_FP_FRAME_WORDS;
+  }
+  INT32U avail = (INT32U)(ptos - pbos) + 1u;
+  if (frame > avail) {
+    frame = avail;
+  }
+
+  OS_STK *stk = ptos - (frame - 1u);
+  for (INT32U i = 0u; i < frame; ++i) {
+    stk[i] = (OS_STK)(0x01000000u | (OS_STK)i);
+  }
+  return stk;
+}
+
+static void os2_task_list_remove(OS_TCB *ptcb) {
+  if (ptcb->OSTCBPrev != NULL) {
+    ptcb->OSTCBPrev->OSTCBNext = ptcb->OSTCBNext;
+  } else {
+    OSTCBList = ptcb->OSTCBNext;
+  }
+  if (ptcb->OSTCBNext != NULL) {
+    ptcb->OSTCBNext->OSTCBPrev = ptcb->OSTCBPrev;
+  }
+  ptcb->OSTCBNext = NULL;
+  ptcb->OSTCBPrev = NULL;
+}
+
+INT8U OSTaskCreateExt(void   (*task)(void *p_arg),
+                      void    *p_arg,
+                      OS_STK  *ptos,
+                      INT8U    prio,
+                      INT16U   id,
+                      OS_STK  *pbos,
+                      INT32U   stk_size,
+                      void    *pext,
+                      INT16U   opt) {
+  vsim_service();
+  if (prio > OS_LOWEST_PRIO) {
+    return OS_ERR_PRIO_INVALID;
+  }
+  if (os2_in_isr()) {
+    return OS_ERR_TASK_CREATE_ISR;
+  }
+  if (OSTCBPrioTbl[prio] != NULL) {
+    return OS_ERR_PRIO_EXIST;
+  }
+  OS_TCB *ptcb = os2.tcb_free;
+  if (ptcb == NULL) {
+    return OS_ERR_TASK_NO_MORE_TCB;
+  }
+
+  if (((opt & OS_TASK_OPT_STK_CHK) != 0u) && ((opt & OS_TASK_OPT_STK_CLR) != 0u)) {
+    memset(pbos, 0, (size_t)stk_size * sizeof(OS_STK));
+    vsim_charge(stk_size * vsim_cost.stk_word);
+  }
+
+  os2.tcb_free = ptcb->OSTCBNext;
+  memset(ptcb, 0, sizeof(*ptcb));
+  ptcb->OSTCBStkPtr = os2_task_stk_init(ptos, pbos, opt);
+  ptcb->OSTCBExtPtr = pext;
+  ptcb->OSTCBStkBottom = pbos;
+  ptcb->OSTCBStkSize = stk_size;
+  ptcb->OSTCBOpt = opt;
+  ptcb->OSTCBId = id;
+  ptcb->OSTCBPrio = prio;
+  ptcb->OSTCBStat = OS_STAT_RDY;
+  ptcb->OSTCBStatPend = OS_STAT_PEND_OK;
+#if OS_TASK_PROFILE_EN > 0u
+  ptcb->OSTCBStkBase = pbos;
+#endif
+  ptcb->SimEntry = task;
+  ptcb->SimArg = p_arg;
+  ptcb->SimCtxPtr = vsim_ctx_new(os2_task_entry, ptcb);
+  if (ptcb->SimCtxPtr == NULL) {
+    ptcb->OSTCBNext = os2.tcb_free;
+    os2.tcb_free = ptcb;
+    return OS_ERR_TASK_NO_MORE_TCB;
+  }
+
+  ptcb->OSTCBNext = OSTCBList;
+  if (OSTCBList != NULL) {
+    OSTCBList->OSTCBPrev = ptcb;
+  }
+  OSTCBList = ptcb;
+  OSTCBPrioTbl[prio] = ptcb;
+  OSTaskCtr++;
+
+  OSTaskCreateHook(ptcb);
+  OS_Sched();
+  return OS_ERR_NONE;
+}
+
+INT8U OSTaskCreate(void (*task)(void *p_arg), void *p_arg, OS_STK *ptos, INT8U prio) {
+  return OSTaskCreateExt(task, p_arg, ptos, prio, prio, ptos, 1u, NULL, OS_TASK_OPT_NONE);
+}
+
+INT8U OSTaskDel(INT8U prio) {
+  vsim_service();
+  if (os2_in_isr()) {
+    return OS_ERR_TASK_DEL_ISR;
+  }
+  if (prio == OS_TASK_IDLE_PRIO) {
+    return OS_ERR_TASK_DEL_IDLE;
+  }
+  if ((prio > OS_LOWEST_PRIO) && (prio != OS_PRIO_SELF)) {
+    return OS_ERR_PRIO_INVALID;
+  }
+  OS_TCB *ptcb = os2_tcb_of(prio);
+  if (ptcb == NULL) {
+    return OS_ERR_TASK_NOT_EXIST;
+  }
+
+  ptcb->OSTCBEventPtr = NULL;
+  ptcb->OSTCBFlagGrp = NULL;
+  ptcb->OSTCBDly = 0u;
+  ptcb->OSTCBStat = OS_STAT_RDY;
+  OSTaskDelHook(ptcb);
+
+  OSTCBPrioTbl[ptcb->OSTCBPrio] = NULL;
+  os2_task_list_remove(ptcb);
+  OSTaskCtr--;
+  vsim_ctx_release((vsim_ctx_t *)ptcb->SimCtxPtr);
+  ptcb->OSTCBNext = os2.tcb_free;
+  os2.tcb_free = ptcb;
+
+  if (ptcb == OSTCBCur) {
+    OSLockNesting = 0u;
+    os2_ctx_sw(os2_highest_ready());
+    /* Never resumed. */
+    abort();
+  }
+  OS_Sched();
+  return OS_ERR_NONE;
+}
+
+INT8U OSTaskSuspend(INT8U prio) {
+  vsim_service();
+  if (prio == OS_TASK_IDLE_PRIO) {
+    return OS_ERR_TASK_SUSPEND_IDLE;
+  }
+  if ((prio > OS_LOWEST_PRIO) && (prio != OS_PRIO_SELF)) {
+    return OS_ERR_PRIO_INVALID;
+  }
+  OS_TCB *ptcb = os2_tcb_of(prio);
+  if (ptcb == NULL) {
+    return OS_ERR_TASK_SUSPEND_PRIO;
+  }
+  ptcb->OSTCBStat |= OS_STAT_SUSPEND;
+  if (ptcb == OSTCBCur) {
+    OS_Sched();
+  }
+  return OS_ERR_NONE;
+}
+
+INT8U OSTaskResume(INT8U prio) {
+  vsim_service();
+  if (prio >= OS_LOWEST_PRIO) {
+    return OS_ERR_PRIO_INVALID;
+  }
+  OS_TCB *ptcb = os2_tcb_of(prio);
+  if (ptcb == NULL) {
+    return OS_ERR_TASK_RESUME_PRIO;
+  }
+  if ((ptcb->OSTCBStat & OS_STAT_SUSPEND) == 0u) {
+    return OS_ERR_TASK_NOT_SUSPENDED;
+  }
+  ptcb->OSTCBStat &= (INT8U)~OS_STAT_SUSPEND;
+  OS_Sched();
+  return OS_ERR_NONE;
+}
+
+INT8U OSTaskChangePrio(INT8U oldprio, INT8U newprio) {
+  vsim_service();
+  if ((newprio >= OS_LOWEST_PRIO) ||
+      ((oldprio >= OS_LOWEST_PRIO) && (oldprio != OS_PRIO_SELF))) {
+    return OS_ERR_PRIO_INVALID;
+  }
+  if (OSTCBPrioTbl[newprio] != NULL) {
+    return OS_ERR_PRIO_EXIST;
+  }
+  OS_TCB *ptcb = os2_tcb_of(oldprio);
+  if (ptcb == NULL) {
+    return OS_ERR_PRIO;
+  }
+
+  OSTCBPrioTbl[ptcb->OSTCBPrio] = NULL;
+  OSTCBPrioTbl[newprio] = ptcb;
+  ptcb->OSTCBPrio = newprio;
+  if (ptcb == OSTCBCur) {
+    OSPrioCur = newprio;
+  }
+  OS_Sched();
+  return OS_ERR_NONE;
+}
+
+INT8U OSTaskStkChk(INT8U prio, OS_STK_DATA *p_stk_data) {
+  vsim_service();
+  if ((prio > OS_LOWEST_PRIO) && (prio != OS_PRIO_SELF)) {
+    return OS_ERR_PRIO_INVALID;
+  }
+  if (p_stk_data == NULL) {
+    return OS_ERR_PDATA_NULL;
+  }
+  p_stk_data->OSFree = 0u;
+  p_stk_data->OSUsed = 0u;
+  OS_TCB *ptcb = os2_tcb_of(prio);
+  if (ptcb == NULL) {
+    return OS_ERR_TASK_NOT_EXIST;
+  }
+  if ((ptcb->OSTCBOpt & OS_TASK_OPT_STK_CHK) == 0u) {
+    return OS_ERR_TASK_OPT;
+  }
+
+  INT32U nfree = 0u;
+  while ((nfree < ptcb->OSTCBStkSize) && (ptcb->OSTCBStkBottom[nfree] == 0u)) {
+    nfree++;
+  }
+  vsim_charge(nfree * vsim_cost.stk_word);
+  p_stk_data->OSFree = nfree * (INT32U)sizeof(OS_STK);
+  p_stk_data->OSUsed = (ptcb->OSTCBStkSize - nfree) * (INT32U)sizeof(OS_STK);
+  return OS_ERR_NONE;
+}
+
+void OSTaskNameSet(INT8U prio, INT8U *pname, INT8U *perr) {
+  OS_TCB *ptcb = os2_tcb_of(prio);
+  if (ptcb == NULL) {
+    *perr = OS_ERR_TASK_NOT_EXIST;
+    return;
+  }
+#if OS_TASK_NAME_EN > 0u
+  ptcb->OSTCBTaskName = pname;
+#else
+  (void)pname;
+#endif
+  *perr = OS_ERR_NONE;
+}
+
+/* ==== Semaphores ==== */
+
+OS_EVENT *OSSemCreate(INT16U cnt) {
+  vsim_service();
+  if (os2_in_isr()) {
+    return NULL;
+  }
+  OS_EVENT *pevent = os2_event_alloc(OS_EVENT_TYPE_SEM);
+  if (pevent != NULL) {
+    pevent->OSEventCnt = cnt;
+  }
+  return pevent;
+}
+
+OS_EVENT *OSSemDel(OS_EVENT *pevent, INT8U opt, INT8U *perr) {
+  vsim_service();
+  if (pevent == NULL) {
+    *perr = OS_ERR_PEVENT_NULL;
+    return pevent;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_SEM) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return pevent;
+  }
+  if (os2_in_isr()) {
+    *perr = OS_ERR_DEL_ISR;
+    return pevent;
+  }
+
+  bool waiting = os2_event_has_waiters(pevent);
+  switch (opt) {
+    case OS_DEL_NO_PEND:
+      if (waiting) {
+        *perr = OS_ERR_TASK_WAITING;
+        return pevent;
+      }
+      break;
+    case OS_DEL_ALWAYS:
+      (void)os2_event_flush(pevent, OS_STAT_SEM, OS_STAT_PEND_ABORT);
+      break;
+    default:
+      *perr = OS_ERR_INVALID_OPT;
+      return pevent;
+  }
+  os2_event_free(pevent);
+  *perr = OS_ERR_NONE;
+  if (waiting) {
+    OS_Sched();
+  }
+  return NULL;
+}
+
+INT16U OSSemAccept(OS_EVENT *pevent) {
+  vsim_service();
+  if ((pevent == NULL) || (pevent->OSEventType != OS_EVENT_TYPE_SEM)) {
+    return 0u;
+  }
+  INT16U cnt = pevent->OSEventCnt;
+  if (cnt > 0u) {
+    pevent->OSEventCnt--;
+  }
+  return cnt;
+}
+
+void OSSemPend(OS_EVENT *pevent, INT32U timeout, INT8U *perr) {
+  vsim_service();
+  if (pevent == NULL) {
+    *perr = OS_ERR_PEVENT_NULL;
+    return;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_SEM) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return;
+  }
+  if (os2_in_isr()) {
+    *perr = OS_ERR_PEND_ISR;
+    return;
+  }
+  if (OSLockNesting > 0u) {
+    *perr = OS_ERR_PEND_LOCKED;
+    return;
+  }
+  if (pevent->OSEventCnt > 0u) {
+    pevent->OSEventCnt--;
+    *perr = OS_ERR_NONE;
+    return;
+  }
+
+  os2_event_wait(pevent, OS_STAT_SEM, timeout);
+  *perr = os2_pend_status_err(OSTCBCur->OSTCBStatPend);
+}
+
+INT8U OSSemPost(OS_EVENT *pevent) {
+  vsim_service();
+  if (pevent == NULL) {
+    return OS_ERR_PEVENT_NULL;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_SEM) {
+    return OS_ERR_EVENT_TYPE;
+  }
+
+  OS_TCB *waiter = os2_event_highest_waiter(pevent);
+  if (waiter != NULL) {
+    os2_task_rdy(waiter, NULL, OS_STAT_SEM, OS_STAT_PEND_OK);
+    OS_Sched();
+    return OS_ERR_NONE;
+  }
+  if (pevent->OSEventCnt >= OS2_SEM_MAX) {
+    return OS_ERR_SEM_OVF;
+  }
+  pevent->OSEventCnt++;
+  return OS_ERR_NONE;
+}
+
+INT8U OSSemQuery(OS_EVENT *pevent, OS_SEM_DATA *p_sem_data) {
+  if (pevent == NULL) {
+    return OS_ERR_PEVENT_NULL;
+  }
+  if (p_sem_data == NULL) {
+    return OS_ERR_PDATA_NULL;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_SEM) {
+    return OS_ERR_EVENT_TYPE;
+  }
+  memset(p_sem_data, 0, sizeof(*p_sem_data));
+  p_sem_data->OSCnt = pevent->OSEventCnt;
+  p_sem_data->OSEventGrp = os2_event_has_waiters(pevent) ? 1u : 0u;
+  return OS_ERR_NONE;
+}
+
+void OSSemSet(OS_EVENT *pevent, INT16U cnt, INT8U *perr) {
+  vsim_service();
+  if (pevent == NULL) {
+    *perr = OS_ERR_PEVENT_NULL;
+    return;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_SEM) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return;
+  }
+  *perr = OS_ERR_NONE;
+  if (pevent->OSEventCnt > 0u) {
+    pevent->OSEventCnt = cnt;
+  } else if (!os2_event_has_waiters(pevent)) {
+    pevent->OSEventCnt = cnt;
+  } else {
+    *perr = OS_ERR_TASK_WAITING;
+  }
+}
+
+/* ==== Mutexes (priority ceiling disabled) ==== */
+
+OS_EVENT *OSMutexCreate(INT8U prio, INT8U *perr) {
+  vsim_service();
+  if (os2_in_isr()) {
+    *perr = OS_ERR_CREATE_ISR;
+    return NULL;
+  }
+  if ((prio != OS_PRIO_MUTEX_CEIL_DIS) && (prio >= OS_LOWEST_PRIO)) {
+    *perr = OS_ERR_PRIO_INVALID;
+    return NULL;
+  }
+  OS_EVENT *pevent = os2_event_alloc(OS_EVENT_TYPE_MUTEX);
+  if (pevent == NULL) {
+    *perr = OS_ERR_PEVENT_NULL;
+    return NULL;
+  }
+  pevent->OSEventCnt = (INT16U)(((INT16U)prio << 8u) | OS2_MUTEX_AVAILABLE);
+  pevent->OSEventPtr = NULL;
+  *perr = OS_ERR_NONE;
+  return pevent;
+}
+
+OS_EVENT *OSMutexDel(OS_EVENT *pevent, INT8U opt, INT8U *perr) {
+  vsim_service();
+  if (pevent == NULL) {
+    *perr = OS_ERR_PEVENT_NULL;
+    return pevent;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_MUTEX) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return pevent;
+  }
+  if (os2_in_isr()) {
+    *perr = OS_ERR_DEL_ISR;
+    return pevent;
+  }
+
+  bool waiting = os2_event_has_waiters(pevent);
+  switch (opt) {
+    case OS_DEL_NO_PEND:
+      if (waiting) {
+        *perr = OS_ERR_TASK_WAITING;
+        return pevent;
+      }
+      break;
+    case OS_DEL_ALWAYS:
+      (void)os2_event_flush(pevent, OS_STAT_MUTEX, OS_STAT_PEND_ABORT);
+      break;
+    default:
+      *perr = OS_ERR_INVALID_OPT;
+      return pevent;
+  }
+  os2_event_free(pevent);
+  *perr = OS_ERR_NONE;
+  if (waiting) {
+    OS_Sched();
+  }
+  return NULL;
+}
+
+static bool os2_mutex_available(const OS_EVENT *pevent) {
+  return (pevent->OSEventCnt & 0x00FFu) == OS2_MUTEX_AVAILABLE;
+}
+
+static void os2_mutex_take(OS_EVENT *pevent, OS_TCB *owner) {
+  pevent->OSEventCnt = (INT16U)((pevent->OSEventCnt & 0xFF00u) | owner->OSTCBPrio);
+  pevent->OSEventPtr = owner;
+}
+
+BOOLEAN OSMutexAccept(OS_EVENT *pevent, INT8U *perr) {
+  vsim_service();
+  if (pevent == NULL) {
+    *perr = OS_ERR_PEVENT_NULL;
+    return OS_FALSE;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_MUTEX) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return OS_FALSE;
+  }
+  if (os2_in_isr()) {
+    *perr = OS_ERR_PEND_ISR;
+    return OS_FALSE;
+  }
+  *perr = OS_ERR_NONE;
+  if (!os2_mutex_available(pevent)) {
+    return OS_FALSE;
+  }
+  os2_mutex_take(pevent, OSTCBCur);
+  return OS_TRUE;
+}
+
+void OSMutexPend(OS_EVENT *pevent, INT32U timeout, INT8U *perr) {
+  vsim_service();
+  if (pevent == NULL) {
+    *perr = OS_ERR_PEVENT_NULL;
+    return;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_MUTEX) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return;
+  }
+  if (os2_in_isr()) {
+    *perr = OS_ERR_PEND_ISR;
+    return;
+  }
+  if (OSLockNesting > 0u) {
+    *perr = OS_ERR_PEND_LOCKED;
+    return;
+  }
+  if (os2_mutex_available(pevent)) {
+    os2_mutex_take(pevent, OSTCBCur);
+    *perr = OS_ERR_NONE;
+    return;
+  }
+
+  /* Ceiling disabled: no priority change, the waiter simply blocks. */
+  os2_event_wait(pevent, OS_STAT_MUTEX, timeout);
+  *perr = os2_pend_status_err(OSTCBCur->OSTCBStatPend);
+}
+
+INT8U OSMutexPost(OS_EVENT *pevent) {
+  vsim_service();
+  if (os2_in_isr()) {
+    return OS_ERR_POST_ISR;
+  }
+  if (pevent == NULL) {
+    return OS_ERR_PEVENT_NULL;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_MUTEX) {
+    return OS_ERR_EVENT_TYPE;
+  }
+  if (pevent->OSEventPtr != OSTCBCur) {
+    return OS_ERR_NOT_MUTEX_OWNER;
+  }
+
+  OS_TCB *next = os2_event_highest_waiter(pevent);
+  if (next == NULL) {
+    pevent->OSEventCnt |= OS2_MUTEX_AVAILABLE;
+    pevent->OSEventPtr = NULL;
+    return OS_ERR_NONE;
+  }
+  os2_task_rdy(next, NULL, OS_STAT_MUTEX, OS_STAT_PEND_OK);
+  os2_mutex_take(pevent, next);
+  OS_Sched();
+  return OS_ERR_NONE;
+}
+
+/* ==== Message queues ==== */
+
+static void os2_q_put(OS_Q *pq, void *pmsg) {
+  *pq->OSQIn++ = pmsg;
+  if (pq->OSQIn == pq->OSQEnd) {
+    pq->OSQIn = pq->OSQStart;
+  }
+  pq->OSQEntries++;
+}
+
+static void *os2_q_get(OS_Q *pq) {
+  void *pmsg = *pq->OSQOut++;
+  if (pq->OSQOut == pq->OSQEnd) {
+    pq->OSQOut = pq->OSQStart;
+  }
+  pq->OSQEntries--;
+  return pmsg;
+}
+
+OS_EVENT *OSQCreate(void **start, INT16U size) {
+  vsim_service();
+  if (os2_in_isr() || (start == NULL) || (size == 0u)) {
+    return NULL;
+  }
+  OS_Q *pq = os2.q_free;
+  if (pq == NULL) {
+    return NULL;
+  }
+  OS_EVENT *pevent = os2_event_alloc(OS_EVENT_TYPE_Q);
+  if (pevent == NULL) {
+    return NULL;
+  }
+  os2.q_free = pq->OSQPtr;
+  pq->OSQPtr = NULL;
+  pq->OSQStart = start;
+  pq->OSQEnd = &start[size];
+  pq->OSQIn = start;
+  pq->OSQOut = start;
+  pq->OSQSize = size;
+  pq->OSQEntries = 0u;
+  pevent->OSEventPtr = pq;
+  return pevent;
+}
+
+OS_EVENT *OSQDel(OS_EVENT *pevent, INT8U opt, INT8U *perr) {
+  vsim_service();
+  if (pevent == NULL) {
+    *perr = OS_ERR_PEVENT_NULL;
+    return pevent;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_Q) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return pevent;
+  }
+  if (os2_in_isr()) {
+    *perr = OS_ERR_DEL_ISR;
+    return pevent;
+  }
+
+  bool waiting = os2_event_has_waiters(pevent);
+  switch (opt) {
+    case OS_DEL_NO_PEND:
+      if (waiting) {
+        *perr = OS_ERR_TASK_WAITING;
+        return pevent;
+      }
+      break;
+    case OS_DEL_ALWAYS:
+      (void)os2_event_flush(pevent, OS_STAT_Q, OS_STAT_PEND_ABORT);
+      break;
+    default:
+      *perr = OS_ERR_INVALID_OPT;
+      return pevent;
+  }
+  OS_Q *pq = (OS_Q *)pevent->OSEventPtr;
+  pq->OSQPtr = os2.q_free;
+  os2.q_free = pq;
+  os2_event_free(pevent);
+  *perr = OS_ERR_NONE;
+  if (waiting) {
+    OS_Sched();
+  }
+  return NULL;
+}
+
+void *OSQAccept(OS_EVENT *pevent, INT8U *perr) {
+  vsim_service();
+  if (pevent == NULL) {
+    *perr = OS_ERR_PEVENT_NULL;
+    return NULL;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_Q) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return NULL;
+  }
+  OS_Q *pq = (OS_Q *)pevent->OSEventPtr;
+  if (pq->OSQEntries == 0u) {
+    *perr = OS_ERR_Q_EMPTY;
+    return NULL;
+  }
+  *perr = OS_ERR_NONE;
+  return os2_q_get(pq);
+}
+
+INT8U OSQFlush(OS_EVENT *pevent) {
+  vsim_service();
+  if (pevent == NULL) {
+    return OS_ERR_PEVENT_NULL;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_Q) {
+    return OS_ERR_EVENT_TYPE;
+  }
+  OS_Q *pq = (OS_Q *)pevent->OSEventPtr;
+  pq->OSQIn = pq->OSQStart;
+  pq->OSQOut = pq->OSQStart;
+  pq->OSQEntries = 0u;
+  return OS_ERR_NONE;
+}
+
+void *OSQPend(OS_EVENT *pevent, INT32U timeout, INT8U *perr) {
+  vsim_service();
+  if (pevent == NULL) {
+    *perr = OS_ERR_PEVENT_NULL;
+    return NULL;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_Q) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return NULL;
+  }
+  if (os2_in_isr()) {
+    *perr = OS_ERR_PEND_ISR;
+    return NULL;
+  }
+  if (OSLockNesting > 0u) {
+    *perr = OS_ERR_PEND_LOCKED;
+    return NULL;
+  }
+  OS_Q *pq = (OS_Q *)pevent->OSEventPtr;
+  if (pq->OSQEntries > 0u) {
+    *perr = OS_ERR_NONE;
+    return os2_q_get(pq);
+  }
+
+  os2_no_block_in_isr("OSQPend");
+  os2_event_wait(pevent, OS_STAT_Q, timeout);
+  OS_TCB *cur = OSTCBCur;
+  *perr = os2_pend_status_err(cur->OSTCBStatPend);
+  void *pmsg = (*perr == OS_ERR_NONE) ? cur->OSTCBMsg : NULL;
+  cur->OSTCBMsg = NULL;
+  return pmsg;
+}
+
+INT8U OSQPost(OS_EVENT *pevent, void *pmsg) {
+  vsim_service();
+  if (pevent == NULL) {
+    return OS_ERR_PEVENT_NULL;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_Q) {
+    return OS_ERR_EVENT_TYPE;
+  }
+
+  OS_TCB *waiter = os2_event_highest_waiter(pevent);
+  if (waiter != NULL) {
+    os2_task_rdy(waiter, pmsg, OS_STAT_Q, OS_STAT_PEND_OK);
+    OS_Sched();
+    return OS_ERR_NONE;
+  }
+  OS_Q *pq = (OS_Q *)pevent->OSEventPtr;
+  if (pq->OSQEntries >= pq->OSQSize) {
+    return OS_ERR_Q_FULL;
+  }
+  os2_q_put(pq, pmsg);
+  return OS_ERR_NONE;
+}
+
+INT8U OSQQuery(OS_EVENT *pevent, OS_Q_DATA *p_q_data) {
+  if (pevent == NULL) {
+    return OS_ERR_PEVENT_NULL;
+  }
+  if (p_q_data == NULL) {
+    return OS_ERR_PDATA_NULL;
+  }
+  if (pevent->OSEventType != OS_EVENT_TYPE_Q) {
+    return OS_ERR_EVENT_TYPE;
+  }
+  OS_Q *pq = (OS_Q *)pevent->OSEventPtr;
+  memset(p_q_data, 0, sizeof(*p_q_data));
+  p_q_data->OSMsg = (pq->OSQEntries > 0u) ? *pq->OSQOut : NULL;
+  p_q_data->OSNMsgs = pq->OSQEntries;
+  p_q_data->OSQSize = pq->OSQSize;
+  p_q_data->OSEventGrp = os2_event_has_waiters(pevent) ? 1u : 0u;
+  return OS_ERR_NONE;
+}
+
+/* ==== Event flags ==== */
+
+static OS_FLAGS os2_flags_ready(OS_FLAGS cur, OS_FLAGS want, INT8U wait_type) {
+  OS_FLAGS rdy;
+  switch (wait_type) {
+    case OS_FLAG_WAIT_SET_ALL:
+      rdy = cur & want;
+      return (rdy == want) ? rdy : 0u;
+    case OS_FLAG_WAIT_SET_ANY:
+      return cur & want;
+    case OS_FLAG_WAIT_CLR_ALL:
+      rdy = (OS_FLAGS)~cur & want;
+      return (rdy == want) ? rdy : 0u;
+    case OS_FLAG_WAIT_CLR_ANY:
+      return (OS_FLAGS)~cur & want;
+    default:
+      return 0u;
+  }
+}
+
+static void os2_flags_consume(OS_FLAG_GRP *pgrp, OS_FLAGS rdy, INT8U wait_type) {
+  if ((wait_type == OS_FLAG_WAIT_SET_ALL) || (wait_type == OS_FLAG_WAIT_SET_ANY)) {
+    pgrp->OSFlagFlags &= (OS_FLAGS)~rdy;
+  } else {
+    pgrp->OSFlagFlags |= rdy;
+  }
+}
+
+OS_FLAG_GRP *OSFlagCreate(OS_FLAGS flags, INT8U *perr) {
+  vsim_service();
+  if (os2_in_isr()) {
+    *perr = OS_ERR_CREATE_ISR;
+    return NULL;
+  }
+  OS_FLAG_GRP *pgrp = os2.flag_free;
+  if (pgrp == NULL) {
+    *perr = OS_ERR_FLAG_GRP_DEPLETED;
+    return NULL;
+  }
+  os2.flag_free = (OS_FLAG_GRP *)pgrp->OSFlagWaitList;
+  pgrp->OSFlagType = OS_EVENT_TYPE_FLAG;
+  pgrp->OSFlagWaitList = NULL;
+  pgrp->OSFlagFlags = flags;
+  *perr = OS_ERR_NONE;
+  return pgrp;
+}
+
+static bool os2_flag_has_waiters(const OS_FLAG_GRP *pgrp) {
+  for (OS_TCB *p = OSTCBList; p != NULL; p = p->OSTCBNext) {
+    if (p->OSTCBFlagGrp == pgrp) {
+      return true;
+    }
+  }
+  return false;
+}
+
+OS_FLAG_GRP *OSFlagDel(OS_FLAG_GRP *pgrp, INT8U opt, INT8U *perr) {
+  vsim_service();
+  if (pgrp == NULL) {
+    *perr = OS_ERR_FLAG_INVALID_PGRP;
+    return pgrp;
+  }
+  if (pgrp->OSFlagType != OS_EVENT_TYPE_FLAG) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return pgrp;
+  }
+  if (os2_in_isr()) {
+    *perr = OS_ERR_DEL_ISR;
+    return pgrp;
+  }
+
+  bool waiting = os2_flag_has_waiters(pgrp);
+  switch (opt) {
+    case OS_DEL_NO_PEND:
+      if (waiting) {
+        *perr = OS_ERR_TASK_WAITING;
+        return pgrp;
+      }
+      break;
+    case OS_DEL_ALWAYS:
+      for (OS_TCB *p = OSTCBList; p != NULL; p = p->OSTCBNext) {
+        if (p->OSTCBFlagGrp == pgrp) {
+          os2_task_rdy(p, NULL, OS_STAT_FLAG, OS_STAT_PEND_ABORT);
+          p->OSTCBFlagsRdy = 0u;
+        }
+      }
+      break;
+    default:
+      *perr = OS_ERR_INVALID_OPT;
+      return pgrp;
+  }
+  pgrp->OSFlagType = OS_EVENT_TYPE_UNUSED;
+  pgrp->OSFlagFlags = 0u;
+  pgrp->OSFlagWaitList = os2.flag_free;
+  os2.flag_free = pgrp;
+  *perr = OS_ERR_NONE;
+  if (waiting) {
+    OS_Sched();
+  }
+  return NULL;
+}
+
+OS_FLAGS OSFlagAccept(OS_FLAG_GRP *pgrp, OS_FLAGS flags, INT8U wait_type, INT8U *perr) {
+  vsim_service();
+  if (pgrp == NULL) {
+    *perr = OS_ERR_FLAG_INVALID_PGRP;
+    return 0u;
+  }
+  if (pgrp->OSFlagType != OS_EVENT_TYPE_FLAG) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return 0u;
+  }
+  bool consume = (wait_type & OS_FLAG_CONSUME) != 0u;
+  wait_type &= (INT8U)~OS_FLAG_CONSUME;
+  if (wait_type > OS_FLAG_WAIT_SET_ANY) {
+    *perr = OS_ERR_FLAG_WAIT_TYPE;
+    return 0u;
+  }
+
+  OS_FLAGS rdy = os2_flags_ready(pgrp->OSFlagFlags, flags, wait_type);
+  if (rdy == 0u) {
+    *perr = OS_ERR_FLAG_NOT_RDY;
+    return 0u;
+  }
+  if (consume) {
+    os2_flags_consume(pgrp, rdy, wait_type);
+  }
+  *perr = OS_ERR_NONE;
+  return rdy;
+}
+
+OS_FLAGS OSFlagPend(OS_FLAG_GRP *pgrp, OS_FLAGS flags, INT8U wait_type, INT32U timeout, INT8U *perr) {
+  vsim_service();
+  if (os2_in_isr()) {
+    *perr = OS_ERR_PEND_ISR;
+    return 0u;
+  }
+  if (OSLockNesting > 0u) {
+    *perr = OS_ERR_PEND_LOCKED;
+    return 0u;
+  }
+  if (pgrp == NULL) {
+    *perr = OS_ERR_FLAG_INVALID_PGRP;
+    return 0u;
+  }
+  if (pgrp->OSFlagType != OS_EVENT_TYPE_FLAG) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return 0u;
+  }
+  bool consume = (wait_type & OS_FLAG_CONSUME) != 0u;
+  INT8U type = wait_type & (INT8U)~OS_FLAG_CONSUME;
+  if (type > OS_FLAG_WAIT_SET_ANY) {
+    *perr = OS_ERR_FLAG_WAIT_TYPE;
+    return 0u;
+  }
+
+  OS_TCB *cur = OSTCBCur;
+  OS_FLAGS rdy = os2_flags_ready(pgrp->OSFlagFlags, flags, type);
+  if (rdy != 0u) {
+    if (consume) {
+      os2_flags_consume(pgrp, rdy, type);
+    }
+    cur->OSTCBFlagsRdy = rdy;
+    *perr = OS_ERR_NONE;
+    return rdy;
+  }
+
+  cur->OSTCBFlagGrp = pgrp;
+  cur->OSTCBFlagsPend = flags;
+  cur->OSTCBFlagWaitType = wait_type;
+  cur->OSTCBFlagsRdy = 0u;
+  cur->OSTCBStat |= OS_STAT_FLAG;
+  cur->OSTCBStatPend = OS_STAT_PEND_OK;
+  cur->OSTCBDly = timeout;
+  OS_Sched();
+
+  *perr = os2_pend_status_err(cur->OSTCBStatPend);
+  return (*perr == OS_ERR_NONE) ? cur->OSTCBFlagsRdy : 0u;
+}
+
+OS_FLAGS OSFlagPendGetFlagsRdy(void) {
+  return OSTCBCur->OSTCBFlagsRdy;
+}
+
+OS_FLAGS OSFlagPost(OS_FLAG_GRP *pgrp, OS_FLAGS flags, INT8U opt, INT8U *perr) {
+  vsim_service();
+  if (pgrp == NULL) {
+    *perr = OS_ERR_FLAG_INVALID_PGRP;
+    return 0u;
+  }
+  if (pgrp->OSFlagType != OS_EVENT_TYPE_FLAG) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return 0u;
+  }
+  switch (opt) {
+    case OS_FLAG_SET:
+      pgrp->OSFlagFlags |= flags;
+      break;
+    case OS_FLAG_CLR:
+      pgrp->OSFlagFlags &= (OS_FLAGS)~flags;
+      break;
+    default:
+      *perr = OS_ERR_FLAG_INVALID_OPT;
+      return 0u;
+  }
+
+  /* Waiters are served in priority order, as the wait list is on target. */
+  bool readied = false;
+  for (INT32U prio = 0u; prio <= OS_LOWEST_PRIO; ++prio) {
+    OS_TCB *p = OSTCBPrioTbl[prio];
+    if ((p == NULL) || (p == OS_TCB_RESERVED) || (p->OSTCBFlagGrp != pgrp)) {
+      continue;
+    }
+    INT8U type = p->OSTCBFlagWaitType & (INT8U)~OS_FLAG_CONSUME;
+    OS_FLAGS rdy = os2_flags_ready(pgrp->OSFlagFlags, p->OSTCBFlagsPend, type);
+    if (rdy == 0u) {
+      continue;
+    }
+    if ((p->OSTCBFlagWaitType & OS_FLAG_CONSUME) != 0u) {
+      os2_flags_consume(pgrp, rdy, type);
+    }
+    os2_task_rdy(p, NULL, OS_STAT_FLAG, OS_STAT_PEND_OK);
+    p->OSTCBFlagsRdy = rdy;
+    readied = true;
+  }
+
+  *perr = OS_ERR_NONE;
+  OS_FLAGS result = pgrp->OSFlagFlags;
+  if (readied) {
+    OS_Sched();
+  }
+  return result;
+}
+
+OS_FLAGS OSFlagQuery(OS_FLAG_GRP *pgrp, INT8U *perr) {
+  if (pgrp == NULL) {
+    *perr = OS_ERR_FLAG_INVALID_PGRP;
+    return 0u;
+  }
+  if (pgrp->OSFlagType != OS_EVENT_TYPE_FLAG) {
+    *perr = OS_ERR_EVENT_TYPE;
+    return 0u;
+  }
+  *perr = OS_ERR_NONE;
+  return pgrp->OSFlagFlags;
+}
+
+/* ==== Memory partitions ==== */
+
+OS_MEM *OSMemCreate(void *addr, INT32U nblks, INT32U blksize, INT8U *perr) {
+  vsim_service();
+  if (addr == NULL) {
+    *perr = OS_ERR_MEM_INVALID_ADDR;
+    return NULL;
+  }
+  if (((uintptr_t)addr & (sizeof(void *) - 1u)) != 0u) {
+    *perr = OS_ERR_MEM_INVALID_ADDR;
+    return NULL;
+  }
+  if (nblks < 2u) {
+    *perr = OS_ERR_MEM_INVALID_BLKS;
+    return NULL;
+  }
+  if (blksize < sizeof(void *)) {
+    *perr = OS_ERR_MEM_INVALID_SIZE;
+    return NULL;
+  }
+  OS_MEM *pmem = os2.mem_free;
+  if (pmem == NULL) {
+    *perr = OS_ERR_MEM_INVALID_PART;
+    return NULL;
+  }
+  os2.mem_free = (OS_MEM *)pmem->OSMemFreeList;
+
+  INT8U *blk = (INT8U *)addr;
+  for (INT32U i = 0u; i < (nblks - 1u); ++i) {
+    *(void **)blk = blk + blksize;
+    blk += blksize;
+  }
+  *(void **)blk = NULL;
+
+  pmem->OSMemAddr = addr;
+  pmem->OSMemFreeList = addr;
+  pmem->OSMemNFree = nblks;
+  pmem->OSMemNBlks = nblks;
+  pmem->OSMemBlkSize = blksize;
+  *perr = OS_ERR_NONE;
+  return pmem;
+}
+
+void *OSMemGet(OS_MEM *pmem, INT8U *perr) {
+  vsim_service();
+  if (pmem == NULL) {
+    *perr = OS_ERR_MEM_INVALID_PMEM;
+    return NULL;
+  }
+  if (pmem->OSMemNFree == 0u) {
+    *perr = OS_ERR_MEM_NO_FREE_BLKS;
+    return NULL;
+  }
+  void *blk = pmem->OSMemFreeList;
+  pmem->OSMemFreeList = *(void **)blk;
+  pmem->OSMemNFree--;
+  *perr = OS_ERR_NONE;
+  return blk;
+}
+
+INT8U OSMemPut(OS_MEM *pmem, void *pblk) {
+  vsim_service();
+  if (pmem == NULL) {
+    return OS_ERR_MEM_INVALID_PMEM;
+  }
+  if (pblk == NULL) {
+    return OS_ERR_MEM_INVALID_PBLK;
+  }
+  if (pmem->OSMemNFree >= pmem->OSMemNBlks) {
+    return OS_ERR_MEM_FULL;
+  }
+  *(void **)pblk = pmem->OSMemFreeList;
+  pmem->OSMemFreeList = pblk;
+  pmem->OSMemNFree++;
+  return OS_ERR_NONE;
+}
+
+INT8U OSMemQuery(OS_MEM *pmem, OS_MEM_DATA *p_mem_data) {
+  if (pmem == NULL) {
+    return OS_ERR_MEM_INVALID_PMEM;
+  }
+  if (p_mem_data == NULL) {
+    return OS_ERR_MEM_INVALID_PDATA;
+  }
+  p_mem_data->OSAddr = pmem->OSMemAddr;
+  p_mem_data->OSFreeList = pmem->OSMemFreeList;
+  p_mem_data->OSBlkSize = pmem->OSMemBlkSize;
+  p_mem_data->OSNBlks = pmem->OSMemNBlks;
+  p_mem_data->OSNFree = pmem->OSMemNFree;
+  p_mem_data->OSNUsed = pmem->OSMemNBlks - pmem->OSMemNFree;
+  return OS_ERR_NONE;
+}
+
+/* ==== Timers ==== */
+
+static void os2_tmr_task(void *p_arg) {
+  (void)p_arg;
+  for (;;) {
+    INT8U err;
+    OSSemPend(os2_tmr_sem, 0u, &err);
+
+    for (INT32U i = 0u; i < OS_TMR_CFG_MAX; ++i) {
+      OS_TMR *t = os2.tmr_active[i];
+      if ((t == NULL) || (t->SimExpired == 0u) || (t->OSTmrState != OS_TMR_STATE_RUNNING)) {
+        continue;
+      }
+      t->SimExpired--;
+      if (t->OSTmrOpt != OS_TMR_OPT_PERIODIC) {
+        t->OSTmrState = OS_TMR_STATE_COMPLETED;
+      }
+      if (t->OSTmrCallback != NULL) {
+        t->OSTmrCallback(t, t->OSTmrCallbackArg);
+      }
+    }
+  }
+}
+
+static INT8U os2_tmr_check(const OS_TMR *ptmr) {
+  if (ptmr == NULL) {
+    return OS_ERR_TMR_INVALID;
+  }
+  if (ptmr->OSTmrType != OS_TMR_TYPE) {
+    return OS_ERR_TMR_INVALID_TYPE;
+  }
+  if (os2_in_isr()) {
+    return OS_ERR_TMR_ISR;
+  }
+  if (ptmr->OSTmrState == OS_TMR_STATE_UNUSED) {
+    return OS_ERR_TMR_INACTIVE;
+  }
+  return OS_ERR_NONE;
+}
+
+OS_TMR *OSTmrCreate(INT32U dly, INT32U period, INT8U opt, OS_TMR_CALLBACK callback,
+                    void *callback_arg, INT8U *pname, INT8U *perr) {
+  vsim_service();
+  switch (opt) {
+    case OS_TMR_OPT_PERIODIC:
+      if (period == 0u) {
+        *perr = OS_ERR_TMR_INVALID_PERIOD;
+        return NULL;
+      }
+      break;
+    case OS_TMR_OPT_ONE_SHOT:
+      if (dly == 0u) {
+        *perr = OS_ERR_TMR_INVALID_DLY;
+        return NULL;
+      }
+      break;
+    default:
+      *perr = OS_ERR_TMR_INVALID_OPT;
+      return NULL;
+  }
+  if (os2_in_isr()) {
+    *perr = OS_ERR_TMR_ISR;
+    return NULL;
+  }
+  OS_TMR *ptmr = os2.tmr_free;
+  if (ptmr == NULL) {
+    *perr = OS_ERR_TMR_NON_AVAIL;
+    return NULL;
+  }
+  os2.tmr_free = (OS_TMR *)ptmr->OSTmrNext;
+
+  memset(ptmr, 0, sizeof(*ptmr));
+  ptmr->OSTmrType = OS_TMR_TYPE;
+  ptmr->OSTmrState = OS_TMR_STATE_STOPPED;
+  ptmr->OSTmrDly = dly;
+  ptmr->OSTmrPeriod = period;
+  ptmr->OSTmrOpt = opt;
+  ptmr->OSTmrCallback = callback;
+  ptmr->OSTmrCallbackArg = callback_arg;
+  ptmr->OSTmrName = pname;
+  for (INT32U i = 0u; i < OS_TMR_CFG_MAX; ++i) {
+    if (os2.tmr_active[i] == NULL) {
+      os2.tmr_active[i] = ptmr;
+      break;
+    }
+  }
+  *perr = OS_ERR_NONE;
+  return ptmr;
+}
+
+BOOLEAN OSTmrDel(OS_TMR *ptmr, INT8U *perr) {
+  vsim_service();
+  *perr = os2_tmr_check(ptmr);
+  if (*perr != OS_ERR_NONE) {
+    return OS_FALSE;
+  }
+  for (INT32U i = 0u; i < OS_TMR_CFG_MAX; ++i) {
+    if (os2.tmr_active[i] == ptmr) {
+      os2.tmr_active[i] = NULL;
+    }
+  }
+  ptmr->OSTmrState = OS_TMR_STATE_UNUSED;
+  ptmr->OSTmrType = OS_EVENT_TYPE_UNUSED;
+  ptmr->OSTmrNext = os2.tmr_free;
+  os2.tmr_free = ptmr;
+  return OS_TRUE;
+}
+
+INT32U OSTmrRemainGet(OS_TMR *ptmr, INT8U *perr) {
+  *perr = os2_tmr_check(ptmr);
+  if (*perr != OS_ERR_NONE) {
+    return 0u;
+  }
+  return (ptmr->OSTmrState == OS_TMR_STATE_RUNNING) ? ptmr->SimRemain : 0u;
+}
+
+BOOLEAN OSTmrStart(OS_TMR *ptmr, INT8U *perr) {
+  vsim_service();
+  *perr = os2_tmr_check(ptmr);
+  if (*perr != OS_ERR_NONE) {
+    return OS_FALSE;
+  }
+  ptmr->SimRemain = (ptmr->OSTmrDly != 0u) ? ptmr->OSTmrDly : ptmr->OSTmrPeriod;
+  ptmr->OSTmrMatch = OSTime + ptmr->SimRemain;
+  ptmr->SimExpired = 0u;
+  ptmr->OSTmrState = OS_TMR_STATE_RUNNING;
+  return OS_TRUE;
+}
+
+INT8U OSTmrStateGet(OS_TMR *ptmr, INT8U *perr) {
+  *perr = os2_tmr_check(ptmr);
+  if (*perr != OS_ERR_NONE) {
+    return OS_TMR_STATE_UNUSED;
+  }
+  return ptmr->OSTmrState;
+}
+
+BOOLEAN OSTmrStop(OS_TMR *ptmr, INT8U opt, void *callback_arg, INT8U *perr) {
+  vsim_service();
+  *perr = os2_tmr_check(ptmr);
+  if (*perr != OS_ERR_NONE) {
+    return OS_FALSE;
+  }
+  if (ptmr->OSTmrState != OS_TMR_STATE_RUNNING) {
+    *perr = OS_ERR_TMR_STOPPED;
+    return OS_TRUE;
+  }
+  ptmr->OSTmrState = OS_TMR_STATE_STOPPED;
+  ptmr->SimExpired = 0u;
+  switch (opt) {
+    case OS_TMR_OPT_CALLBACK:
+    case OS_TMR_OPT_CALLBACK_ARG:
+      if (ptmr->OSTmrCallback == NULL) {
+        *perr = OS_ERR_TMR_NO_CALLBACK;
+        return OS_TRUE;
+      }
+      ptmr->OSTmrCallback(ptmr, (opt == OS_TMR_OPT_CALLBACK) ? ptmr->OSTmrCallbackArg : callback_arg);
+      break;
+    case OS_TMR_OPT_NONE:
+      break;
+    default:
+      *perr = OS_ERR_TMR_INVALID_OPT;
+      return OS_FALSE;
+  }
+  return OS_TRUE;
+}
+
+/* ==== Start-up ==== */
+
+static void os2_idle_task(void *p_arg) {
+  (void)p_arg;
+  for (;;) {
+    OSIdleCtr++;
+    OSTaskIdleHook();
+    vsim_idle();
+  }
+}
+
+void OSInit(void) {
+  vsim_reset();
+  memset(&os2, 0, sizeof(os2));
+
+  OSCtxSwCtr = 0u;
+  OSIdleCtr = 0u;
+  OSIntNesting = 0u;
+  OSLockNesting = 0u;
+  OSPrioCur = 0u;
+  OSPrioHighRdy = 0u;
+  OSRunning = OS_FALSE;
+  OSTaskCtr = 0u;
+  OSTCBCur = NULL;
+  OSTCBHighRdy = NULL;
+  OSTCBList = NULL;
+  OSTime = 0u;
+  memset(OSTCBPrioTbl, 0, sizeof(OSTCBPrioTbl));
+
+  for (INT32U i = 0u; i < (OS_MAX_TASKS + 2u); ++i) {
+    os2_tcb_tbl[i].OSTCBNext = (i + 1u < OS_MAX_TASKS + 2u) ? &os2_tcb_tbl[i + 1u] : NULL;
+  }
+  os2.tcb_free = &os2_tcb_tbl[0];
+  for (INT32U i = 0u; i < OS_MAX_EVENTS; ++i) {
+    os2_event_tbl[i].OSEventType = OS_EVENT_TYPE_UNUSED;
+    os2_event_tbl[i].OSEventPtr = (i + 1u < OS_MAX_EVENTS) ? &os2_event_tbl[i + 1u] : NULL;
+  }
+  os2.event_free = &os2_event_tbl[0];
+  for (INT32U i = 0u; i < OS_MAX_QS; ++i) {
+    os2_q_tbl[i].OSQPtr = (i + 1u < OS_MAX_QS) ? &os2_q_tbl[i + 1u] : NULL;
+  }
+  os2.q_free = &os2_q_tbl[0];
+  for (INT32U i = 0u; i < OS_MAX_FLAGS; ++i) {
+    os2_flag_tbl[i].OSFlagType = OS_EVENT_TYPE_UNUSED;
+    os2_flag_tbl[i].OSFlagWaitList = (i + 1u < OS_MAX_FLAGS) ? &os2_flag_tbl[i + 1u] : NULL;
+  }
+  os2.flag_free = &os2_flag_tbl[0];
+  for (INT32U i = 0u; i < OS_MAX_MEM_PART; ++i) {
+    os2_mem_tbl[i].OSMemFreeList = (i + 1u < OS_MAX_MEM_PART) ? &os2_mem_tbl[i + 1u] : NULL;
+  }
+  os2.mem_free = &os2_mem_tbl[0];
+  for (INT32U i = 0u; i < OS_TMR_CFG_MAX; ++i) {
+    os2_tmr_tbl[i].OSTmrNext = (i + 1u < OS_TMR_CFG_MAX) ? &os2_tmr_tbl[i + 1u] : NULL;
+  }
+  os2.tmr_free = &os2_tmr_tbl[0];
+
+  const char *horizon = getenv("VSIM_HORIZON");
+  if (horizon != NULL) {
+    vsim_set_horizon(strtoull(horizon, NULL, 0));
+    os2.exit_at_horizon = true;
+  }
+  os2.trace = (getenv("VSIM_TRACE") != NULL);
+
+  vsim_kernel_register(&os2_ops);
+
+  INT8U err;
+  (void)OSTaskCreateExt(os2_idle_task, NULL, &os2_idle_stk[OS_TASK_IDLE_STK_SIZE - 1u],
+                        OS_TASK_IDLE_PRIO, OS_TASK_IDLE_ID, os2_idle_stk, OS_TASK_IDLE_STK_SIZE,
+                        NULL, OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);
+  OSTaskNameSet(OS_TASK_IDLE_PRIO, (INT8U *)(void *)"uC/OS-II Idle", &err);
+
+#if OS_TMR_EN > 0u
+  os2_tmr_sem = OSSemCreate(0u);
+  (void)OSTaskCreateExt(os2_tmr_task, NULL, &os2_tmr_stk[OS_TASK_TMR_STK_SIZE - 1u],
+                        OS_TASK_TMR_PRIO, OS_TASK_TMR_ID, os2_tmr_stk, OS_TASK_TMR_STK_SIZE,
+                        NULL, OS_TASK_OPT_STK_CHK | OS_TASK_OPT_STK_CLR);
+  OSTaskNameSet(OS_TASK_TMR_PRIO, (INT8U *)(void *)"uC/OS-II Tmr", &err);
+#endif
+}
+
+void OSStart(void) {
+  if (OSRunning == OS_TRUE) {
+    return;
+  }
+
+  OSTCBHighRdy = os2_highest_ready();
+  OSPrioHighRdy = OSTCBHighRdy->OSTCBPrio;
+  OSTCBCur = OSTCBHighRdy;
+  OSPrioCur = OSPrioHighRdy;
+  OSRunning = OS_TRUE;
+#if OS_TASK_PROFILE_EN > 0u
+  OSTCBCur->OSTCBCtxSwCtr++;
+#endif
+
+  vsim_ctx_start((vsim_ctx_t *)OSTCBCur->SimCtxPtr);
+
+  /* The simulation horizon was reached. */
+  if (os2.exit_at_horizon) {
+    if (os2.trace) {
+      printf("%10llu horizon ticks=%llu ctxsw=%lu\n",
+             (unsigned long long)vsim_now(),
+             (unsigned long long)vsim_ticks(),
+             (unsigned long)OSCtxSwCtr);
+    }
+    fflush(stdout);
+    exit(0);
+  }
+}
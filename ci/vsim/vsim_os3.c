@@ -0,0 +1,1990 @@
+/*
+ * Simulated uC/OS-III kernel for the virtual-time simulator.
+ *
+ * Implements the subset of the uC/OS-III v3.08.02 API used by the CMSIS-RTOS2
+ * wrapper with the same scheduling rules: strict fixed-priority preemption,
+ * FIFO among equal priorities, priority-ordered pend lists, priority
+ * inheritance on mutexes, tick-driven delays/timeouts and a timer task driven
+ * from the tick. Error codes follow the real kernel so wrapper error mapping is
+ * exercised as on target.
+ *
+ * Every service charges vsim_cost.service and may deliver due interrupts on
+ * entry; the kernel body itself runs atomically, as it would inside a
+ * critical section on target.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os.h"
+
+#define OS3_IDLE_PRIO          ((OS_PRIO)(OS_CFG_PRIO_MAX - 1u))
+#define OS3_FRAME_WORDS        16u   /* Cortex-M exception frame + R4-R11 */
+#define OS3_FP_FRAME_WORDS     18u   /* S16-S31, FPSCR, reserved */
+#define OS3_SCHED_LOCK_MAX     250u
+
+/* ==== Kernel variables ==== */
+
+OS_NESTING_CTR    OSIntNestingCtr;
+OS_STATE          OSRunning = OS_STATE_OS_STOPPED;
+OS_NESTING_CTR    OSSchedLockNestingCtr;
+OS_TCB           *OSTCBCurPtr;
+OS_TCB           *OSTCBHighRdyPtr;
+OS_PRIO           OSPrioCur;
+OS_PRIO           OSPrioHighRdy;
+OS_CTX_SW_CTR     OSTaskCtxSwCtr;
+OS_TICK           OSTickCtr;
+OS_IDLE_CTR       OSIdleTaskCtr;
+OS_TCB            OSIdleTaskTCB;
+
+#if (OS_CFG_APP_HOOKS_EN > 0u)
+OS_APP_HOOK_TCB   OS_AppTaskCreateHookPtr;
+OS_APP_HOOK_TCB   OS_AppTaskDelHookPtr;
+OS_APP_HOOK_TCB   OS_AppTaskReturnHookPtr;
+OS_APP_HOOK_VOID  OS_AppIdleTaskHookPtr;
+OS_APP_HOOK_VOID  OS_AppStatTaskHookPtr;
+OS_APP_HOOK_VOID  OS_AppTaskSwHookPtr;
+OS_APP_HOOK_VOID  OS_AppTimeTickHookPtr;
+#endif
+
+static struct {
+  OS_TCB     *tasks;
+  OS_TMR     *tmrs;
+  OS_MSG     *msg_free;
+  CPU_INT64U  ready_seq;
+  bool        exit_at_horizon;
+  bool        trace;
+#if (OS_CFG_TLS_TBL_SIZE > 0u)
+  OS_TLS_ID   tls_next;
+#endif
+} os3;
+
+static OS_MSG  os3_msg_pool[OS_CFG_MSG_POOL_SIZE];
+static CPU_STK os3_idle_stk[OS_CFG_IDLE_TASK_STK_SIZE];
+static OS_TCB  os3_tmr_tcb;
+static CPU_STK os3_tmr_stk[OS_CFG_TMR_TASK_STK_SIZE];
+
+static void os3_sched(void);
+
+/* ==== Helpers ==== */
+
+static bool os3_in_isr(void) {
+  return OSIntNestingCtr > 0u;
+}
+
+static void os3_no_block_in_isr(const char *service) {
+  if (os3_in_isr()) {
+    fprintf(stderr, "vsim: blocking %s() called from ISR\n", service);
+    abort();
+  }
+}
+
+static const char *os3_name(const OS_TCB *p_tcb) {
+  return ((p_tcb != NULL) && (p_tcb->NamePtr != NULL)) ? (const char *)p_tcb->NamePtr : "?";
+}
+
+static void os3_make_ready(OS_TCB *p_tcb) {
+  p_tcb->TaskState = OS_TASK_STATE_RDY;
+  p_tcb->SimReadySeq = ++os3.ready_seq;
+}
+
+static OS_TCB *os3_highest_ready(void) {
+  OS_TCB *best = NULL;
+  for (OS_TCB *p = os3.tasks; p != NULL; p = p->SimNextPtr) {
+    if (p->TaskState != OS_TASK_STATE_RDY) {
+      continue;
+    }
+    if ((best == NULL) ||
+        (p->Prio < best->Prio) ||
+        ((p->Prio == best->Prio) && (p->SimReadySeq < best->SimReadySeq))) {
+      best = p;
+    }
+  }
+  return best;
+}
+
+static OS_ERR os3_pend_status_err(OS_STATUS status) {
+  switch (status) {
+    case OS_STATUS_PEND_OK:
+      return OS_ERR_NONE;
+    case OS_STATUS_PEND_ABORT:
+      return OS_ERR_PEND_ABORT;
+    case OS_STATUS_PEND_DEL:
+      return OS_ERR_OBJ_DEL;
+    default:
+      return OS_ERR_TIMEOUT;
+  }
+}
+
+/* ==== Pend lists ==== */
+
+static void os3_pend_list_init(OS_PEND_LIST *list) {
+  list->HeadPtr = NULL;
+  list->TailPtr = NULL;
+  list->NbrEntries = 0u;
+}
+
+static void os3_pend_list_insert(OS_PEND_LIST *list, OS_TCB *p_tcb) {
+  OS_TCB *pos = list->HeadPtr;
+  while ((pos != NULL) && (pos->Prio <= p_tcb->Prio)) {
+    pos = pos->PendNextPtr;
+  }
+
+  p_tcb->PendNextPtr = pos;
+  if (pos == NULL) {
+    p_tcb->PendPrevPtr = list->TailPtr;
+    if (list->TailPtr != NULL) {
+      list->TailPtr->PendNextPtr = p_tcb;
+    } else {
+      list->HeadPtr = p_tcb;
+    }
+    list->TailPtr = p_tcb;
+  } else {
+    p_tcb->PendPrevPtr = pos->PendPrevPtr;
+    if (pos->PendPrevPtr != NULL) {
+      pos->PendPrevPtr->PendNextPtr = p_tcb;
+    } else {
+      list->HeadPtr = p_tcb;
+    }
+    pos->PendPrevPtr = p_tcb;
+  }
+  list->NbrEntries++;
+}
+
+static void os3_pend_list_remove(OS_TCB *p_tcb) {
+  OS_PEND_LIST *list = p_tcb->PendListPtr;
+  if (list == NULL) {
+    return;
+  }
+
+  if (p_tcb->PendPrevPtr != NULL) {
+    p_tcb->PendPrevPtr->PendNextPtr = p_tcb->PendNextPtr;
+  } else {
+    list->HeadPtr = p_tcb->PendNextPtr;
+  }
+  if (p_tcb->PendNextPtr != NULL) {
+    p_tcb->PendNextPtr->PendPrevPtr = p_tcb->PendPrevPtr;
+  } else {
+    list->TailPtr = p_tcb->PendPrevPtr;
+  }
+  list->NbrEntries--;
+  p_tcb->PendNextPtr = NULL;
+  p_tcb->PendPrevPtr = NULL;
+  p_tcb->PendListPtr = NULL;
+}
+
+static void os3_pend_list_resort(OS_TCB *p_tcb) {
+  OS_PEND_LIST *list = p_tcb->PendListPtr;
+  if (list == NULL) {
+    return;
+  }
+  os3_pend_list_remove(p_tcb);
+  p_tcb->PendListPtr = list;
+  os3_pend_list_insert(list, p_tcb);
+}
+
+static void os3_mutex_owner_reprio(OS_TCB *owner);
+
+/* Block the running task; returns once it has been made ready again. */
+static void os3_pend(void *obj, OS_PEND_LIST *list, OS_STATE pend_on, OS_TICK timeout) {
+  OS_TCB *cur = OSTCBCurPtr;
+  cur->PendOn = pend_on;
+  cur->PendObjPtr = obj;
+  cur->PendStatus = OS_STATUS_PEND_OK;
+  cur->PendListPtr = list;
+  if (list != NULL) {
+    os3_pend_list_insert(list, cur);
+  }
+  cur->TickRemain = timeout;
+  cur->TaskState = (timeout > 0u) ? OS_TASK_STATE_PEND_TIMEOUT : OS_TASK_STATE_PEND;
+  os3_sched();
+}
+
+/* Make a pending task ready with the given completion status. */
+static void os3_pend_end(OS_TCB *p_tcb, void *msg, OS_MSG_SIZE size, OS_STATUS status) {
+  void *obj = p_tcb->PendObjPtr;
+  OS_STATE pend_on = p_tcb->PendOn;
+
+  os3_pend_list_remove(p_tcb);
+  p_tcb->PendOn = OS_TASK_PEND_ON_NOTHING;
+  p_tcb->PendObjPtr = NULL;
+  p_tcb->PendStatus = status;
+  p_tcb->MsgPtr = msg;
+  p_tcb->MsgSize = size;
+  p_tcb->TickRemain = 0u;
+
+  switch (p_tcb->TaskState) {
+    case OS_TASK_STATE_PEND:
+    case OS_TASK_STATE_PEND_TIMEOUT:
+      os3_make_ready(p_tcb);
+      break;
+    case OS_TASK_STATE_PEND_SUSPENDED:
+    case OS_TASK_STATE_PEND_TIMEOUT_SUSPENDED:
+      p_tcb->TaskState = OS_TASK_STATE_SUSPENDED;
+      break;
+    default:
+      break;
+  }
+
+  if ((pend_on == OS_TASK_PEND_ON_MUTEX) && (status != OS_STATUS_PEND_OK) && (obj != NULL)) {
+    OS_MUTEX *p_mutex = (OS_MUTEX *)obj;
+    if (p_mutex->OwnerTCBPtr != NULL) {
+      os3_mutex_owner_reprio(p_mutex->OwnerTCBPtr);
+    }
+  }
+}
+
+static OS_OBJ_QTY os3_pend_list_flush(OS_PEND_LIST *list, OS_STATUS status) {
+  OS_OBJ_QTY n = 0u;
+  while (list->HeadPtr != NULL) {
+    os3_pend_end(list->HeadPtr, NULL, 0u, status);
+    n++;
+  }
+  return n;
+}
+
+/* ==== Scheduler ==== */
+
+void OSTaskSwHook(void) {
+#if (OS_CFG_APP_HOOKS_EN > 0u)
+  if (OS_AppTaskSwHookPtr != NULL) {
+    OS_AppTaskSwHookPtr();
+  }
+#endif
+
+#if (OS_CFG_TASK_PROFILE_EN > 0u)
+  CPU_TS ts = OS_TS_GET();
+  if (OSTCBCurPtr != OSTCBHighRdyPtr) {
+    OSTCBCurPtr->CyclesDelta = ts - OSTCBCurPtr->CyclesStart;
+    OSTCBCurPtr->CyclesTotal += (OS_CYCLES)OSTCBCurPtr->CyclesDelta;
+  }
+  OSTCBHighRdyPtr->CyclesStart = ts;
+#endif
+}
+
+void OSTimeTickHook(void) {
+#if (OS_CFG_APP_HOOKS_EN > 0u)
+  if (OS_AppTimeTickHookPtr != NULL) {
+    OS_AppTimeTickHookPtr();
+  }
+#endif
+}
+
+static void os3_ctx_sw(void) {
+  OS_TCB *from = OSTCBCurPtr;
+  OS_TCB *to = OSTCBHighRdyPtr;
+
+  OSTaskSwHook();
+#if (OS_CFG_TASK_PROFILE_EN > 0u)
+  to->CtxSwCtr++;
+#endif
+  OSTaskCtxSwCtr++;
+
+  if (((from->Opt | to->Opt) & OS_OPT_TASK_SAVE_FP) != 0u) {
+    vsim_charge(vsim_cost.fp_ctx);
+  }
+  if (os3.trace) {
+    printf("%10llu switch %s -> %s\n",
+           (unsigned long long)vsim_now(), os3_name(from), os3_name(to));
+  }
+  vsim_trace("switch", os3_name(from), os3_name(to));
+
+  OSTCBCurPtr = to;
+  OSPrioCur = to->Prio;
+  vsim_ctx_switch((vsim_ctx_t *)from->SimCtxPtr, (vsim_ctx_t *)to->SimCtxPtr);
+}
+
+static void os3_sched(void) {
+  if ((OSRunning != OS_STATE_OS_RUNNING) ||
+      (OSIntNestingCtr > 0u) ||
+      (OSSchedLockNestingCtr > 0u)) {
+    return;
+  }
+
+  OS_TCB *high = os3_highest_ready();
+  if ((high == NULL) || (high == OSTCBCurPtr)) {
+    return;
+  }
+
+  OSTCBHighRdyPtr = high;
+  OSPrioHighRdy = high->Prio;
+  os3_ctx_sw();
+}
+
+void OSSched(void) {
+  os3_sched();
+}
+
+void OSIntEnter(void) {
+  if (OSRunning != OS_STATE_OS_RUNNING) {
+    return;
+  }
+  if (OSIntNestingCtr < 250u) {
+    OSIntNestingCtr++;
+  }
+}
+
+void OSIntExit(void) {
+  if (OSRunning != OS_STATE_OS_RUNNING) {
+    return;
+  }
+  if (OSIntNestingCtr == 0u) {
+    return;
+  }
+  OSIntNestingCtr--;
+  os3_sched();
+}
+
+void OSSchedLock(OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_SCHED_LOCK_ISR;
+    return;
+  }
+  if (OSRunning != OS_STATE_OS_RUNNING) {
+    *p_err = OS_ERR_OS_NOT_RUNNING;
+    return;
+  }
+  if (OSSchedLockNestingCtr >= OS3_SCHED_LOCK_MAX) {
+    *p_err = OS_ERR_LOCK_NESTING_OVF;
+    return;
+  }
+  OSSchedLockNestingCtr++;
+  *p_err = OS_ERR_NONE;
+}
+
+void OSSchedUnlock(OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_SCHED_UNLOCK_ISR;
+    return;
+  }
+  if (OSRunning != OS_STATE_OS_RUNNING) {
+    *p_err = OS_ERR_OS_NOT_RUNNING;
+    return;
+  }
+  if (OSSchedLockNestingCtr == 0u) {
+    *p_err = OS_ERR_SCHED_NOT_LOCKED;
+    return;
+  }
+  OSSchedLockNestingCtr--;
+  if (OSSchedLockNestingCtr > 0u) {
+    *p_err = OS_ERR_SCHED_LOCKED;
+    return;
+  }
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+}
+
+CPU_INT16U OSVersion(OS_ERR *p_err) {
+  *p_err = OS_ERR_NONE;
+  return (CPU_INT16U)OS_VERSION;
+}
+
+/* ==== Tick ==== */
+
+static OS_SEM_CTR os3_task_sem_signal(OS_TCB *p_tcb);
+
+void OSTimeTick(void) {
+  OSTimeTickHook();
+  OSTickCtr++;
+
+  for (OS_TCB *p = os3.tasks; p != NULL; p = p->SimNextPtr) {
+    switch (p->TaskState) {
+      case OS_TASK_STATE_DLY:
+      case OS_TASK_STATE_DLY_SUSPENDED:
+      case OS_TASK_STATE_PEND_TIMEOUT:
+      case OS_TASK_STATE_PEND_TIMEOUT_SUSPENDED:
+        break;
+      default:
+        continue;
+    }
+
+    if ((p->TickRemain > 0u) && (--p->TickRemain > 0u)) {
+      continue;
+    }
+
+    switch (p->TaskState) {
+      case OS_TASK_STATE_DLY:
+        os3_make_ready(p);
+        break;
+      case OS_TASK_STATE_DLY_SUSPENDED:
+        p->TaskState = OS_TASK_STATE_SUSPENDED;
+        break;
+      default:
+        os3_pend_end(p, NULL, 0u, OS_STATUS_PEND_TIMEOUT);
+        break;
+    }
+  }
+
+#if (OS_CFG_TMR_EN > 0u)
+  /* Timers are counted down here; the timer task only wakes on expiry. */
+  bool expired = false;
+  for (OS_TMR *t = os3.tmrs; t != NULL; t = t->NextPtr) {
+    if ((t->State != OS_TMR_STATE_RUNNING) || (t->Remain == 0u) || (--t->Remain > 0u)) {
+      continue;
+    }
+    t->SimExpired++;
+    t->Remain = (t->Opt == OS_OPT_TMR_PERIODIC) ? t->Period : 0u;
+    expired = true;
+  }
+  if (expired) {
+    (void)os3_task_sem_signal(&os3_tmr_tcb);
+  }
+#endif
+}
+
+static void os3_tick_isr(void) {
+  OSTimeTick();
+}
+
+static const vsim_kernel_ops_t os3_ops = {
+  .int_enter = OSIntEnter,
+  .int_exit  = OSIntExit,
+  .tick      = os3_tick_isr,
+};
+
+void OSTimeDly(OS_TICK dly, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TIME_DLY_ISR;
+    return;
+  }
+  if (OSSchedLockNestingCtr > 0u) {
+    *p_err = OS_ERR_SCHED_LOCKED;
+    return;
+  }
+
+  OS_TICK ticks = dly;
+  switch (opt) {
+    case OS_OPT_TIME_DLY:
+    case OS_OPT_TIME_TIMEOUT:
+    case OS_OPT_TIME_PERIODIC:
+      break;
+    case OS_OPT_TIME_MATCH:
+      ticks = (dly > OSTickCtr) ? (dly - OSTickCtr) : 0u;
+      break;
+    default:
+      *p_err = OS_ERR_OPT_INVALID;
+      return;
+  }
+
+  if (ticks == 0u) {
+    *p_err = OS_ERR_TIME_ZERO_DLY;
+    return;
+  }
+
+  OSTCBCurPtr->TickRemain = ticks;
+  OSTCBCurPtr->TaskState = OS_TASK_STATE_DLY;
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+}
+
+void OSTimeDlyResume(OS_TCB *p_tcb, OS_ERR *p_err) {
+  vsim_service();
+  if ((p_tcb == NULL) || (p_tcb == OSTCBCurPtr)) {
+    *p_err = OS_ERR_TASK_NOT_DLY;
+    return;
+  }
+
+  switch (p_tcb->TaskState) {
+    case OS_TASK_STATE_DLY:
+      p_tcb->TickRemain = 0u;
+      os3_make_ready(p_tcb);
+      break;
+    case OS_TASK_STATE_DLY_SUSPENDED:
+      p_tcb->TickRemain = 0u;
+      p_tcb->TaskState = OS_TASK_STATE_SUSPENDED;
+      break;
+    default:
+      *p_err = OS_ERR_TASK_NOT_DLY;
+      return;
+  }
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+}
+
+OS_TICK OSTimeGet(OS_ERR *p_err) {
+  *p_err = OS_ERR_NONE;
+  return OSTickCtr;
+}
+
+/* ==== Tasks ==== */
+
+static void os3_task_entry(void *arg) {
+  OS_TCB *p_tcb = (OS_TCB *)arg;
+  p_tcb->TaskEntryAddr(p_tcb->TaskEntryArg);
+
+#if (OS_CFG_APP_HOOKS_EN > 0u)
+  if (OS_AppTaskReturnHookPtr != NULL) {
+    OS_AppTaskReturnHookPtr(p_tcb);
+  }
+#endif
+  OS_ERR err;
+  OSTaskDel(NULL, &err);
+}
+
+/* Lay out a Cortex-M style initial frame so stack checks see real usage. */
+static CPU_STK *os3_task_stk_init(CPU_STK *p_stk_base, CPU_STK_SIZE stk_size, OS_OPT opt) {
+  CPU_STK_SIZE frame = OS3_FRAME_WORDS;
+  if ((opt & OS_OPT_TASK_SAVE_FP) != 0u) {
+    frame += OS3_FP_FRAME_WORDS;
+  }
+  if (frame > stk_size) {
+    frame = stk_size;
+  }
+
+  CPU_STK *p_stk = &p_stk_base[stk_size - frame];
+  for (CPU_STK_SIZE i = 0u; i < frame; ++i) {
+    p_stk[i] = (CPU_STK)(0x01000000u | (CPU_STK)i);
+  }
+  return p_stk;
+}
+
+static void os3_task_list_remove(OS_TCB *p_tcb) {
+  OS_TCB **link = &os3.tasks;
+  while (*link != NULL) {
+    if (*link == p_tcb) {
+      *link = p_tcb->SimNextPtr;
+      p_tcb->SimNextPtr = NULL;
+      return;
+    }
+    link = &(*link)->SimNextPtr;
+  }
+}
+
+void OSTaskCreate(OS_TCB        *p_tcb,
+                  CPU_CHAR      *p_name,
+                  OS_TASK_PTR    p_task,
+                  void          *p_arg,
+                  OS_PRIO        prio,
+                  CPU_STK       *p_stk_base,
+                  CPU_STK_SIZE   stk_limit,
+                  CPU_STK_SIZE   stk_size,
+                  OS_MSG_QTY     q_size,
+                  OS_TICK        time_quanta,
+                  void          *p_ext,
+                  OS_OPT         opt,
+                  OS_ERR        *p_err) {
+  (void)time_quanta;
+
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TASK_CREATE_ISR;
+    return;
+  }
+  if (p_tcb == NULL) {
+    *p_err = OS_ERR_TCB_INVALID;
+    return;
+  }
+  if (p_task == NULL) {
+    *p_err = OS_ERR_TASK_INVALID;
+    return;
+  }
+  if (p_stk_base == NULL) {
+    *p_err = OS_ERR_STK_INVALID;
+    return;
+  }
+  if (stk_size < OS_CFG_STK_SIZE_MIN) {
+    *p_err = OS_ERR_STK_SIZE_INVALID;
+    return;
+  }
+  if (stk_limit >= stk_size) {
+    *p_err = OS_ERR_STK_LIMIT_INVALID;
+    return;
+  }
+  if ((prio >= OS_CFG_PRIO_MAX) || ((prio == OS3_IDLE_PRIO) && (p_tcb != &OSIdleTaskTCB))) {
+    *p_err = OS_ERR_PRIO_INVALID;
+    return;
+  }
+
+  memset(p_tcb, 0, sizeof(*p_tcb));
+  p_tcb->NamePtr = p_name;
+  p_tcb->TaskEntryAddr = p_task;
+  p_tcb->TaskEntryArg = p_arg;
+  p_tcb->Prio = prio;
+  p_tcb->BasePrio = prio;
+  p_tcb->StkBasePtr = p_stk_base;
+  p_tcb->StkLimitPtr = &p_stk_base[stk_limit];
+  p_tcb->StkSize = stk_size;
+  p_tcb->ExtPtr = p_ext;
+  p_tcb->Opt = opt;
+  p_tcb->MsgQ.NbrEntriesSize = q_size;
+
+  if (((opt & OS_OPT_TASK_STK_CHK) != 0u) && ((opt & OS_OPT_TASK_STK_CLR) != 0u)) {
+    memset(p_stk_base, 0, (size_t)stk_size * sizeof(CPU_STK));
+    vsim_charge(stk_size * vsim_cost.stk_word);
+  }
+  p_tcb->StkPtr = os3_task_stk_init(p_stk_base, stk_size, opt);
+
+  p_tcb->SimCtxPtr = vsim_ctx_new(os3_task_entry, p_tcb);
+  if (p_tcb->SimCtxPtr == NULL) {
+    *p_err = OS_ERR_TASK_NO_MORE_TCB;
+    return;
+  }
+
+  p_tcb->SimNextPtr = os3.tasks;
+  os3.tasks = p_tcb;
+  os3_make_ready(p_tcb);
+
+#if (OS_CFG_APP_HOOKS_EN > 0u)
+  if (OS_AppTaskCreateHookPtr != NULL) {
+    OS_AppTaskCreateHookPtr(p_tcb);
+  }
+#endif
+
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+}
+
+static void os3_mutex_release_all(OS_TCB *p_tcb);
+
+void OSTaskDel(OS_TCB *p_tcb, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TASK_DEL_ISR;
+    return;
+  }
+  if (p_tcb == NULL) {
+    p_tcb = OSTCBCurPtr;
+  }
+  if (p_tcb == &OSIdleTaskTCB) {
+    *p_err = OS_ERR_TASK_DEL_IDLE;
+    return;
+  }
+  if (p_tcb->TaskState == OS_TASK_STATE_DEL) {
+    *p_err = OS_ERR_TASK_NOT_EXIST;
+    return;
+  }
+
+  os3_pend_list_remove(p_tcb);
+  os3_mutex_release_all(p_tcb);
+
+#if (OS_CFG_APP_HOOKS_EN > 0u)
+  if (OS_AppTaskDelHookPtr != NULL) {
+    OS_AppTaskDelHookPtr(p_tcb);
+  }
+#endif
+
+  os3_task_list_remove(p_tcb);
+  p_tcb->TaskState = OS_TASK_STATE_DEL;
+  p_tcb->PendOn = OS_TASK_PEND_ON_NOTHING;
+  vsim_ctx_release((vsim_ctx_t *)p_tcb->SimCtxPtr);
+  *p_err = OS_ERR_NONE;
+
+  if (p_tcb == OSTCBCurPtr) {
+    OSSchedLockNestingCtr = 0u;
+    OSTCBHighRdyPtr = os3_highest_ready();
+    OSPrioHighRdy = OSTCBHighRdyPtr->Prio;
+    os3_ctx_sw();
+    /* Never resumed. */
+    abort();
+  }
+  os3_sched();
+}
+
+void OSTaskSuspend(OS_TCB *p_tcb, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TASK_SUSPEND_ISR;
+    return;
+  }
+  if (p_tcb == NULL) {
+    p_tcb = OSTCBCurPtr;
+  }
+  if (p_tcb == &OSIdleTaskTCB) {
+    *p_err = OS_ERR_TASK_SUSPEND_IDLE;
+    return;
+  }
+  if ((p_tcb == OSTCBCurPtr) && (OSSchedLockNestingCtr > 0u)) {
+    *p_err = OS_ERR_SCHED_LOCKED;
+    return;
+  }
+  if (p_tcb->SuspendCtr == 250u) {
+    *p_err = OS_ERR_TASK_SUSPEND_CTR_OVF;
+    return;
+  }
+
+  p_tcb->SuspendCtr++;
+  switch (p_tcb->TaskState) {
+    case OS_TASK_STATE_RDY:
+      p_tcb->TaskState = OS_TASK_STATE_SUSPENDED;
+      break;
+    case OS_TASK_STATE_DLY:
+      p_tcb->TaskState = OS_TASK_STATE_DLY_SUSPENDED;
+      break;
+    case OS_TASK_STATE_PEND:
+      p_tcb->TaskState = OS_TASK_STATE_PEND_SUSPENDED;
+      break;
+    case OS_TASK_STATE_PEND_TIMEOUT:
+      p_tcb->TaskState = OS_TASK_STATE_PEND_TIMEOUT_SUSPENDED;
+      break;
+    default:
+      break;
+  }
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+}
+
+void OSTaskResume(OS_TCB *p_tcb, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TASK_RESUME_ISR;
+    return;
+  }
+  if ((p_tcb == NULL) || (p_tcb == OSTCBCurPtr)) {
+    *p_err = OS_ERR_TASK_RESUME_SELF;
+    return;
+  }
+  if (p_tcb->SuspendCtr == 0u) {
+    *p_err = OS_ERR_TASK_NOT_SUSPENDED;
+    return;
+  }
+
+  p_tcb->SuspendCtr--;
+  if (p_tcb->SuspendCtr == 0u) {
+    switch (p_tcb->TaskState) {
+      case OS_TASK_STATE_SUSPENDED:
+        os3_make_ready(p_tcb);
+        break;
+      case OS_TASK_STATE_DLY_SUSPENDED:
+        p_tcb->TaskState = OS_TASK_STATE_DLY;
+        break;
+      case OS_TASK_STATE_PEND_SUSPENDED:
+        p_tcb->TaskState = OS_TASK_STATE_PEND;
+        break;
+      case OS_TASK_STATE_PEND_TIMEOUT_SUSPENDED:
+        p_tcb->TaskState = OS_TASK_STATE_PEND_TIMEOUT;
+        break;
+      default:
+        break;
+    }
+  }
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+}
+
+static void os3_set_prio(OS_TCB *p_tcb, OS_PRIO prio) {
+  if (p_tcb->Prio == prio) {
+    return;
+  }
+  p_tcb->Prio = prio;
+  if (p_tcb->TaskState == OS_TASK_STATE_RDY) {
+    p_tcb->SimReadySeq = ++os3.ready_seq;
+  }
+  os3_pend_list_resort(p_tcb);
+}
+
+void OSTaskChangePrio(OS_TCB *p_tcb, OS_PRIO prio_new, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TASK_CHANGE_PRIO_ISR;
+    return;
+  }
+  if (p_tcb == NULL) {
+    p_tcb = OSTCBCurPtr;
+  }
+  if ((prio_new >= OS3_IDLE_PRIO) || (p_tcb == &OSIdleTaskTCB)) {
+    *p_err = OS_ERR_PRIO_INVALID;
+    return;
+  }
+
+  p_tcb->BasePrio = prio_new;
+  if (p_tcb->MutexGrpHeadPtr != NULL) {
+    os3_mutex_owner_reprio(p_tcb);
+  } else {
+    os3_set_prio(p_tcb, prio_new);
+  }
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+}
+
+void OSTaskStkChk(OS_TCB *p_tcb, CPU_STK_SIZE *p_free, CPU_STK_SIZE *p_used, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TASK_STK_CHK_ISR;
+    return;
+  }
+  if ((p_free == NULL) || (p_used == NULL)) {
+    *p_err = OS_ERR_PTR_INVALID;
+    return;
+  }
+  if (p_tcb == NULL) {
+    p_tcb = OSTCBCurPtr;
+  }
+  *p_free = 0u;
+  *p_used = 0u;
+  if ((p_tcb->StkBasePtr == NULL) || (p_tcb->TaskState == OS_TASK_STATE_DEL)) {
+    *p_err = OS_ERR_TASK_NOT_EXIST;
+    return;
+  }
+  if ((p_tcb->Opt & OS_OPT_TASK_STK_CHK) == 0u) {
+    *p_err = OS_ERR_TASK_OPT;
+    return;
+  }
+
+  CPU_STK_SIZE free_words = 0u;
+  while ((free_words < p_tcb->StkSize) && (p_tcb->StkBasePtr[free_words] == 0u)) {
+    free_words++;
+  }
+  vsim_charge(free_words * vsim_cost.stk_word);
+  *p_free = free_words;
+  *p_used = p_tcb->StkSize - free_words;
+  *p_err = OS_ERR_NONE;
+}
+
+/* ==== Task semaphore / task message queue ==== */
+
+static OS_SEM_CTR os3_task_sem_signal(OS_TCB *p_tcb) {
+  if (p_tcb->PendOn == OS_TASK_PEND_ON_TASK_SEM) {
+    os3_pend_end(p_tcb, NULL, 0u, OS_STATUS_PEND_OK);
+    return p_tcb->SemCtr;
+  }
+  if (p_tcb->SemCtr != (OS_SEM_CTR)-1) {
+    p_tcb->SemCtr++;
+  }
+  return p_tcb->SemCtr;
+}
+
+OS_SEM_CTR OSTaskSemPend(OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err) {
+  vsim_service();
+  if (p_ts != NULL) {
+    *p_ts = 0u;
+  }
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_PEND_ISR;
+    return 0u;
+  }
+
+  OS_TCB *cur = OSTCBCurPtr;
+  if (cur->SemCtr > 0u) {
+    cur->SemCtr--;
+    *p_err = OS_ERR_NONE;
+    return cur->SemCtr;
+  }
+  if ((opt & OS_OPT_PEND_NON_BLOCKING) != 0u) {
+    *p_err = OS_ERR_PEND_WOULD_BLOCK;
+    return 0u;
+  }
+  if (OSSchedLockNestingCtr > 0u) {
+    *p_err = OS_ERR_SCHED_LOCKED;
+    return 0u;
+  }
+
+  os3_pend(NULL, NULL, OS_TASK_PEND_ON_TASK_SEM, timeout);
+  *p_err = os3_pend_status_err(cur->PendStatus);
+  return cur->SemCtr;
+}
+
+OS_SEM_CTR OSTaskSemPost(OS_TCB *p_tcb, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  if (p_tcb == NULL) {
+    p_tcb = OSTCBCurPtr;
+  }
+  OS_SEM_CTR ctr = os3_task_sem_signal(p_tcb);
+  *p_err = OS_ERR_NONE;
+  if ((opt & OS_OPT_POST_NO_SCHED) == 0u) {
+    os3_sched();
+  }
+  return ctr;
+}
+
+static OS_MSG *os3_msg_get(void) {
+  OS_MSG *msg = os3.msg_free;
+  if (msg != NULL) {
+    os3.msg_free = msg->NextPtr;
+    msg->NextPtr = NULL;
+  }
+  return msg;
+}
+
+static void os3_msg_put(OS_MSG *msg) {
+  msg->NextPtr = os3.msg_free;
+  os3.msg_free = msg;
+}
+
+static OS_ERR os3_msg_q_put(OS_MSG_Q *q, void *p_void, OS_MSG_SIZE size, OS_OPT opt) {
+  if (q->NbrEntries >= q->NbrEntriesSize) {
+    return OS_ERR_Q_MAX;
+  }
+  OS_MSG *msg = os3_msg_get();
+  if (msg == NULL) {
+    return OS_ERR_MSG_POOL_EMPTY;
+  }
+
+  msg->MsgPtr = p_void;
+  msg->MsgSize = size;
+  msg->MsgTS = OS_TS_GET();
+  if ((opt & OS_OPT_POST_LIFO) != 0u) {
+    msg->NextPtr = q->OutPtr;
+    q->OutPtr = msg;
+    if (q->InPtr == NULL) {
+      q->InPtr = msg;
+    }
+  } else {
+    if (q->InPtr != NULL) {
+      q->InPtr->NextPtr = msg;
+    } else {
+      q->OutPtr = msg;
+    }
+    q->InPtr = msg;
+  }
+  q->NbrEntries++;
+  if (q->NbrEntries > q->NbrEntriesMax) {
+    q->NbrEntriesMax = q->NbrEntries;
+  }
+  return OS_ERR_NONE;
+}
+
+static void *os3_msg_q_get(OS_MSG_Q *q, OS_MSG_SIZE *p_size) {
+  OS_MSG *msg = q->OutPtr;
+  q->OutPtr = msg->NextPtr;
+  if (q->OutPtr == NULL) {
+    q->InPtr = NULL;
+  }
+  q->NbrEntries--;
+
+  void *p_void = msg->MsgPtr;
+  *p_size = msg->MsgSize;
+  os3_msg_put(msg);
+  return p_void;
+}
+
+static OS_MSG_QTY os3_msg_q_flush(OS_MSG_Q *q) {
+  OS_MSG_QTY n = 0u;
+  OS_MSG_SIZE size;
+  while (q->NbrEntries > 0u) {
+    (void)os3_msg_q_get(q, &size);
+    n++;
+  }
+  return n;
+}
+
+void *OSTaskQPend(OS_TICK timeout, OS_OPT opt, OS_MSG_SIZE *p_msg_size, CPU_TS *p_ts, OS_ERR *p_err) {
+  vsim_service();
+  if (p_ts != NULL) {
+    *p_ts = 0u;
+  }
+  if (p_msg_size == NULL) {
+    *p_err = OS_ERR_PTR_INVALID;
+    return NULL;
+  }
+  *p_msg_size = 0u;
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_PEND_ISR;
+    return NULL;
+  }
+
+  OS_TCB *cur = OSTCBCurPtr;
+  if (cur->MsgQ.NbrEntries > 0u) {
+    *p_err = OS_ERR_NONE;
+    return os3_msg_q_get(&cur->MsgQ, p_msg_size);
+  }
+  if ((opt & OS_OPT_PEND_NON_BLOCKING) != 0u) {
+    *p_err = OS_ERR_PEND_WOULD_BLOCK;
+    return NULL;
+  }
+  if (OSSchedLockNestingCtr > 0u) {
+    *p_err = OS_ERR_SCHED_LOCKED;
+    return NULL;
+  }
+
+  os3_pend(NULL, NULL, OS_TASK_PEND_ON_TASK_Q, timeout);
+  *p_err = os3_pend_status_err(cur->PendStatus);
+  if (*p_err != OS_ERR_NONE) {
+    return NULL;
+  }
+  *p_msg_size = cur->MsgSize;
+  return cur->MsgPtr;
+}
+
+void OSTaskQPost(OS_TCB *p_tcb, void *p_void, OS_MSG_SIZE msg_size, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  if (p_tcb == NULL) {
+    p_tcb = OSTCBCurPtr;
+  }
+
+  if (p_tcb->PendOn == OS_TASK_PEND_ON_TASK_Q) {
+    os3_pend_end(p_tcb, p_void, msg_size, OS_STATUS_PEND_OK);
+    *p_err = OS_ERR_NONE;
+  } else {
+    *p_err = os3_msg_q_put(&p_tcb->MsgQ, p_void, msg_size, opt);
+    return;
+  }
+
+  if ((opt & OS_OPT_POST_NO_SCHED) == 0u) {
+    os3_sched();
+  }
+}
+
+OS_MSG_QTY OSTaskQFlush(OS_TCB *p_tcb, OS_ERR *p_err) {
+  vsim_service();
+  if (p_tcb == NULL) {
+    p_tcb = OSTCBCurPtr;
+  }
+  *p_err = OS_ERR_NONE;
+  return os3_msg_q_flush(&p_tcb->MsgQ);
+}
+
+/* ==== Semaphores ==== */
+
+#define OS3_OBJ_CHECK(p_obj, type, err_ret, ...)            \
+  do {                                                      \
+    if ((p_obj) == NULL) {                                  \
+      *p_err = OS_ERR_OBJ_PTR_NULL;                         \
+      return __VA_ARGS__;                                   \
+    }                                                       \
+    if ((p_obj)->Type != (type)) {                          \
+      *p_err = (err_ret);                                   \
+      return __VA_ARGS__;                                   \
+    }                                                       \
+  } while (0)
+
+void OSSemCreate(OS_SEM *p_sem, CPU_CHAR *p_name, OS_SEM_CTR cnt, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_CREATE_ISR;
+    return;
+  }
+  if (p_sem == NULL) {
+    *p_err = OS_ERR_OBJ_PTR_NULL;
+    return;
+  }
+  p_sem->Type = OS_OBJ_TYPE_SEM;
+  p_sem->NamePtr = p_name;
+  p_sem->Ctr = cnt;
+  p_sem->TS = 0u;
+  os3_pend_list_init(&p_sem->PendList);
+  *p_err = OS_ERR_NONE;
+}
+
+OS_OBJ_QTY OSSemDel(OS_SEM *p_sem, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_DEL_ISR;
+    return 0u;
+  }
+  OS3_OBJ_CHECK(p_sem, OS_OBJ_TYPE_SEM, OS_ERR_OBJ_TYPE, 0u);
+
+  if ((opt == OS_OPT_DEL_NO_PEND) && (p_sem->PendList.NbrEntries > 0u)) {
+    *p_err = OS_ERR_TASK_WAITING;
+    return p_sem->PendList.NbrEntries;
+  }
+  OS_OBJ_QTY n = os3_pend_list_flush(&p_sem->PendList, OS_STATUS_PEND_DEL);
+  p_sem->Type = OS_OBJ_TYPE_NONE;
+  p_sem->Ctr = 0u;
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+  return n;
+}
+
+OS_SEM_CTR OSSemPend(OS_SEM *p_sem, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err) {
+  vsim_service();
+  if (p_ts != NULL) {
+    *p_ts = 0u;
+  }
+  OS3_OBJ_CHECK(p_sem, OS_OBJ_TYPE_SEM, OS_ERR_OBJ_TYPE, 0u);
+
+  if (p_sem->Ctr > 0u) {
+    p_sem->Ctr--;
+    *p_err = OS_ERR_NONE;
+    return p_sem->Ctr;
+  }
+  if ((opt & OS_OPT_PEND_NON_BLOCKING) != 0u) {
+    *p_err = OS_ERR_PEND_WOULD_BLOCK;
+    return 0u;
+  }
+  os3_no_block_in_isr("OSSemPend");
+  if (OSSchedLockNestingCtr > 0u) {
+    *p_err = OS_ERR_SCHED_LOCKED;
+    return 0u;
+  }
+
+  OS_TCB *cur = OSTCBCurPtr;
+  os3_pend(p_sem, &p_sem->PendList, OS_TASK_PEND_ON_SEM, timeout);
+  *p_err = os3_pend_status_err(cur->PendStatus);
+  return p_sem->Ctr;
+}
+
+OS_OBJ_QTY OSSemPendAbort(OS_SEM *p_sem, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  OS3_OBJ_CHECK(p_sem, OS_OBJ_TYPE_SEM, OS_ERR_OBJ_TYPE, 0u);
+
+  if (p_sem->PendList.NbrEntries == 0u) {
+    *p_err = OS_ERR_PEND_ABORT_NONE;
+    return 0u;
+  }
+
+  OS_OBJ_QTY n = 0u;
+  if ((opt & OS_OPT_PEND_ABORT_ALL) != 0u) {
+    n = os3_pend_list_flush(&p_sem->PendList, OS_STATUS_PEND_ABORT);
+  } else {
+    os3_pend_end(p_sem->PendList.HeadPtr, NULL, 0u, OS_STATUS_PEND_ABORT);
+    n = 1u;
+  }
+  *p_err = OS_ERR_NONE;
+  if ((opt & OS_OPT_POST_NO_SCHED) == 0u) {
+    os3_sched();
+  }
+  return n;
+}
+
+OS_SEM_CTR OSSemPost(OS_SEM *p_sem, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  OS3_OBJ_CHECK(p_sem, OS_OBJ_TYPE_SEM, OS_ERR_OBJ_TYPE, 0u);
+
+  if (p_sem->PendList.HeadPtr == NULL) {
+    if (p_sem->Ctr == (OS_SEM_CTR)-1) {
+      *p_err = OS_ERR_SEM_OVF;
+      return 0u;
+    }
+    p_sem->Ctr++;
+    *p_err = OS_ERR_NONE;
+    return p_sem->Ctr;
+  }
+
+  if ((opt & OS_OPT_POST_ALL) != 0u) {
+    (void)os3_pend_list_flush(&p_sem->PendList, OS_STATUS_PEND_OK);
+  } else {
+    os3_pend_end(p_sem->PendList.HeadPtr, NULL, 0u, OS_STATUS_PEND_OK);
+  }
+  *p_err = OS_ERR_NONE;
+  if ((opt & OS_OPT_POST_NO_SCHED) == 0u) {
+    os3_sched();
+  }
+  return 0u;
+}
+
+void OSSemSet(OS_SEM *p_sem, OS_SEM_CTR cnt, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_SET_ISR;
+    return;
+  }
+  OS3_OBJ_CHECK(p_sem, OS_OBJ_TYPE_SEM, OS_ERR_OBJ_TYPE);
+
+  if ((p_sem->Ctr == 0u) && (p_sem->PendList.NbrEntries > 0u)) {
+    *p_err = OS_ERR_TASK_WAITING;
+    return;
+  }
+  p_sem->Ctr = cnt;
+  *p_err = OS_ERR_NONE;
+}
+
+/* ==== Mutexes ==== */
+
+static void os3_mutex_grp_add(OS_TCB *p_tcb, OS_MUTEX *p_mutex) {
+  p_mutex->MutexGrpNextPtr = p_tcb->MutexGrpHeadPtr;
+  p_tcb->MutexGrpHeadPtr = p_mutex;
+}
+
+static void os3_mutex_grp_remove(OS_TCB *p_tcb, OS_MUTEX *p_mutex) {
+  OS_MUTEX **link = &p_tcb->MutexGrpHeadPtr;
+  while (*link != NULL) {
+    if (*link == p_mutex) {
+      *link = p_mutex->MutexGrpNextPtr;
+      p_mutex->MutexGrpNextPtr = NULL;
+      return;
+    }
+    link = &(*link)->MutexGrpNextPtr;
+  }
+}
+
+/* Owner priority = max(base priority, highest waiter on any owned mutex). */
+static void os3_mutex_owner_reprio(OS_TCB *owner) {
+  OS_PRIO prio = owner->BasePrio;
+  for (OS_MUTEX *m = owner->MutexGrpHeadPtr; m != NULL; m = m->MutexGrpNextPtr) {
+    OS_TCB *head = m->PendList.HeadPtr;
+    if ((head != NULL) && (head->Prio < prio)) {
+      prio = head->Prio;
+    }
+  }
+  os3_set_prio(owner, prio);
+
+  if (owner->PendOn == OS_TASK_PEND_ON_MUTEX) {
+    OS_MUTEX *blocked_on = (OS_MUTEX *)owner->PendObjPtr;
+    if ((blocked_on != NULL) && (blocked_on->OwnerTCBPtr != NULL)) {
+      os3_mutex_owner_reprio(blocked_on->OwnerTCBPtr);
+    }
+  }
+}
+
+static void os3_mutex_hand_over(OS_MUTEX *p_mutex) {
+  OS_TCB *next = p_mutex->PendList.HeadPtr;
+  if (next == NULL) {
+    p_mutex->OwnerTCBPtr = NULL;
+    p_mutex->OwnerNestingCtr = 0u;
+    return;
+  }
+  p_mutex->OwnerTCBPtr = next;
+  p_mutex->OwnerNestingCtr = 1u;
+  os3_mutex_grp_add(next, p_mutex);
+  os3_pend_end(next, NULL, 0u, OS_STATUS_PEND_OK);
+  os3_mutex_owner_reprio(next);
+}
+
+static void os3_mutex_release_all(OS_TCB *p_tcb) {
+  while (p_tcb->MutexGrpHeadPtr != NULL) {
+    OS_MUTEX *m = p_tcb->MutexGrpHeadPtr;
+    os3_mutex_grp_remove(p_tcb, m);
+    os3_mutex_hand_over(m);
+  }
+}
+
+void OSMutexCreate(OS_MUTEX *p_mutex, CPU_CHAR *p_name, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_CREATE_ISR;
+    return;
+  }
+  if (p_mutex == NULL) {
+    *p_err = OS_ERR_OBJ_PTR_NULL;
+    return;
+  }
+  p_mutex->Type = OS_OBJ_TYPE_MUTEX;
+  p_mutex->NamePtr = p_name;
+  p_mutex->MutexGrpNextPtr = NULL;
+  p_mutex->OwnerTCBPtr = NULL;
+  p_mutex->OwnerNestingCtr = 0u;
+  p_mutex->TS = 0u;
+  os3_pend_list_init(&p_mutex->PendList);
+  *p_err = OS_ERR_NONE;
+}
+
+OS_OBJ_QTY OSMutexDel(OS_MUTEX *p_mutex, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_DEL_ISR;
+    return 0u;
+  }
+  OS3_OBJ_CHECK(p_mutex, OS_OBJ_TYPE_MUTEX, OS_ERR_OBJ_TYPE, 0u);
+
+  if ((opt == OS_OPT_DEL_NO_PEND) && (p_mutex->PendList.NbrEntries > 0u)) {
+    *p_err = OS_ERR_TASK_WAITING;
+    return p_mutex->PendList.NbrEntries;
+  }
+
+  OS_TCB *owner = p_mutex->OwnerTCBPtr;
+  OS_OBJ_QTY n = os3_pend_list_flush(&p_mutex->PendList, OS_STATUS_PEND_DEL);
+  if (owner != NULL) {
+    os3_mutex_grp_remove(owner, p_mutex);
+    os3_mutex_owner_reprio(owner);
+  }
+  p_mutex->Type = OS_OBJ_TYPE_NONE;
+  p_mutex->OwnerTCBPtr = NULL;
+  p_mutex->OwnerNestingCtr = 0u;
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+  return n;
+}
+
+void OSMutexPend(OS_MUTEX *p_mutex, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err) {
+  vsim_service();
+  if (p_ts != NULL) {
+    *p_ts = 0u;
+  }
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_PEND_ISR;
+    return;
+  }
+  OS3_OBJ_CHECK(p_mutex, OS_OBJ_TYPE_MUTEX, OS_ERR_OBJ_TYPE);
+
+  OS_TCB *cur = OSTCBCurPtr;
+  if (p_mutex->OwnerTCBPtr == NULL) {
+    p_mutex->OwnerTCBPtr = cur;
+    p_mutex->OwnerNestingCtr = 1u;
+    os3_mutex_grp_add(cur, p_mutex);
+    *p_err = OS_ERR_NONE;
+    return;
+  }
+  if (p_mutex->OwnerTCBPtr == cur) {
+    if (p_mutex->OwnerNestingCtr == (OS_NESTING_CTR)-1) {
+      *p_err = OS_ERR_MUTEX_OVF;
+      return;
+    }
+    p_mutex->OwnerNestingCtr++;
+    *p_err = OS_ERR_MUTEX_OWNER;
+    return;
+  }
+  if ((opt & OS_OPT_PEND_NON_BLOCKING) != 0u) {
+    *p_err = OS_ERR_PEND_WOULD_BLOCK;
+    return;
+  }
+  if (OSSchedLockNestingCtr > 0u) {
+    *p_err = OS_ERR_SCHED_LOCKED;
+    return;
+  }
+
+  /* Priority inheritance, propagated along a chain of blocked owners. */
+  OS_TCB *owner = p_mutex->OwnerTCBPtr;
+  while ((owner != NULL) && (owner->Prio > cur->Prio)) {
+    os3_set_prio(owner, cur->Prio);
+    if (owner->PendOn != OS_TASK_PEND_ON_MUTEX) {
+      break;
+    }
+    owner = ((OS_MUTEX *)owner->PendObjPtr)->OwnerTCBPtr;
+  }
+
+  os3_pend(p_mutex, &p_mutex->PendList, OS_TASK_PEND_ON_MUTEX, timeout);
+  *p_err = os3_pend_status_err(cur->PendStatus);
+}
+
+void OSMutexPost(OS_MUTEX *p_mutex, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_POST_ISR;
+    return;
+  }
+  OS3_OBJ_CHECK(p_mutex, OS_OBJ_TYPE_MUTEX, OS_ERR_OBJ_TYPE);
+
+  OS_TCB *cur = OSTCBCurPtr;
+  if (p_mutex->OwnerTCBPtr != cur) {
+    *p_err = OS_ERR_MUTEX_NOT_OWNER;
+    return;
+  }
+  if (p_mutex->OwnerNestingCtr > 1u) {
+    p_mutex->OwnerNestingCtr--;
+    *p_err = OS_ERR_MUTEX_NESTING;
+    return;
+  }
+
+  os3_mutex_grp_remove(cur, p_mutex);
+  os3_mutex_owner_reprio(cur);
+  os3_mutex_hand_over(p_mutex);
+  *p_err = OS_ERR_NONE;
+  if ((opt & OS_OPT_POST_NO_SCHED) == 0u) {
+    os3_sched();
+  }
+}
+
+/* ==== Message queues ==== */
+
+void OSQCreate(OS_Q *p_q, CPU_CHAR *p_name, OS_MSG_QTY max_qty, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_CREATE_ISR;
+    return;
+  }
+  if (p_q == NULL) {
+    *p_err = OS_ERR_OBJ_PTR_NULL;
+    return;
+  }
+  if (max_qty == 0u) {
+    *p_err = OS_ERR_Q_SIZE;
+    return;
+  }
+  memset(&p_q->MsgQ, 0, sizeof(p_q->MsgQ));
+  p_q->Type = OS_OBJ_TYPE_Q;
+  p_q->NamePtr = p_name;
+  p_q->MsgQ.NbrEntriesSize = max_qty;
+  os3_pend_list_init(&p_q->PendList);
+  *p_err = OS_ERR_NONE;
+}
+
+OS_OBJ_QTY OSQDel(OS_Q *p_q, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_DEL_ISR;
+    return 0u;
+  }
+  OS3_OBJ_CHECK(p_q, OS_OBJ_TYPE_Q, OS_ERR_OBJ_TYPE, 0u);
+
+  if ((opt == OS_OPT_DEL_NO_PEND) && (p_q->PendList.NbrEntries > 0u)) {
+    *p_err = OS_ERR_TASK_WAITING;
+    return p_q->PendList.NbrEntries;
+  }
+  OS_OBJ_QTY n = os3_pend_list_flush(&p_q->PendList, OS_STATUS_PEND_DEL);
+  (void)os3_msg_q_flush(&p_q->MsgQ);
+  p_q->Type = OS_OBJ_TYPE_NONE;
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+  return n;
+}
+
+OS_MSG_QTY OSQFlush(OS_Q *p_q, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_FLUSH_ISR;
+    return 0u;
+  }
+  OS3_OBJ_CHECK(p_q, OS_OBJ_TYPE_Q, OS_ERR_OBJ_TYPE, 0u);
+  *p_err = OS_ERR_NONE;
+  return os3_msg_q_flush(&p_q->MsgQ);
+}
+
+void *OSQPend(OS_Q *p_q, OS_TICK timeout, OS_OPT opt, OS_MSG_SIZE *p_msg_size, CPU_TS *p_ts, OS_ERR *p_err) {
+  vsim_service();
+  if (p_ts != NULL) {
+    *p_ts = 0u;
+  }
+  if (p_msg_size == NULL) {
+    *p_err = OS_ERR_PTR_INVALID;
+    return NULL;
+  }
+  *p_msg_size = 0u;
+  OS3_OBJ_CHECK(p_q, OS_OBJ_TYPE_Q, OS_ERR_OBJ_TYPE, NULL);
+
+  if (p_q->MsgQ.NbrEntries > 0u) {
+    *p_err = OS_ERR_NONE;
+    return os3_msg_q_get(&p_q->MsgQ, p_msg_size);
+  }
+  if ((opt & OS_OPT_PEND_NON_BLOCKING) != 0u) {
+    *p_err = OS_ERR_PEND_WOULD_BLOCK;
+    return NULL;
+  }
+  os3_no_block_in_isr("OSQPend");
+  if (OSSchedLockNestingCtr > 0u) {
+    *p_err = OS_ERR_SCHED_LOCKED;
+    return NULL;
+  }
+
+  OS_TCB *cur = OSTCBCurPtr;
+  os3_pend(p_q, &p_q->PendList, OS_TASK_PEND_ON_Q, timeout);
+  *p_err = os3_pend_status_err(cur->PendStatus);
+  if (*p_err != OS_ERR_NONE) {
+    return NULL;
+  }
+  *p_msg_size = cur->MsgSize;
+  return cur->MsgPtr;
+}
+
+void OSQPost(OS_Q *p_q, void *p_void, OS_MSG_SIZE msg_size, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  OS3_OBJ_CHECK(p_q, OS_OBJ_TYPE_Q, OS_ERR_OBJ_TYPE);
+
+  if (p_q->PendList.HeadPtr == NULL) {
+    *p_err = os3_msg_q_put(&p_q->MsgQ, p_void, msg_size, opt);
+    return;
+  }
+
+  if ((opt & OS_OPT_POST_ALL) != 0u) {
+    while (p_q->PendList.HeadPtr != NULL) {
+      os3_pend_end(p_q->PendList.HeadPtr, p_void, msg_size, OS_STATUS_PEND_OK);
+    }
+  } else {
+    os3_pend_end(p_q->PendList.HeadPtr, p_void, msg_size, OS_STATUS_PEND_OK);
+  }
+  *p_err = OS_ERR_NONE;
+  if ((opt & OS_OPT_POST_NO_SCHED) == 0u) {
+    os3_sched();
+  }
+}
+
+/* ==== Event flags ==== */
+
+static OS_FLAGS os3_flags_ready(OS_FLAGS cur, OS_FLAGS want, OS_OPT opt) {
+  OS_FLAGS rdy = cur & want;
+  switch (opt & OS_OPT_PEND_FLAG_MASK) {
+    case OS_OPT_PEND_FLAG_SET_ALL:
+      return (rdy == want) ? rdy : 0u;
+    case OS_OPT_PEND_FLAG_SET_ANY:
+      return rdy;
+    default:
+      return 0u;
+  }
+}
+
+void OSFlagCreate(OS_FLAG_GRP *p_grp, CPU_CHAR *p_name, OS_FLAGS flags, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_CREATE_ISR;
+    return;
+  }
+  if (p_grp == NULL) {
+    *p_err = OS_ERR_OBJ_PTR_NULL;
+    return;
+  }
+  p_grp->Type = OS_OBJ_TYPE_FLAG;
+  p_grp->NamePtr = p_name;
+  p_grp->Flags = flags;
+  p_grp->TS = 0u;
+  os3_pend_list_init(&p_grp->PendList);
+  *p_err = OS_ERR_NONE;
+}
+
+OS_OBJ_QTY OSFlagDel(OS_FLAG_GRP *p_grp, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_DEL_ISR;
+    return 0u;
+  }
+  OS3_OBJ_CHECK(p_grp, OS_OBJ_TYPE_FLAG, OS_ERR_OBJ_TYPE, 0u);
+
+  if ((opt == OS_OPT_DEL_NO_PEND) && (p_grp->PendList.NbrEntries > 0u)) {
+    *p_err = OS_ERR_TASK_WAITING;
+    return p_grp->PendList.NbrEntries;
+  }
+  OS_OBJ_QTY n = os3_pend_list_flush(&p_grp->PendList, OS_STATUS_PEND_DEL);
+  p_grp->Type = OS_OBJ_TYPE_NONE;
+  p_grp->Flags = 0u;
+  *p_err = OS_ERR_NONE;
+  os3_sched();
+  return n;
+}
+
+OS_FLAGS OSFlagPend(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err) {
+  vsim_service();
+  if (p_ts != NULL) {
+    *p_ts = 0u;
+  }
+  OS3_OBJ_CHECK(p_grp, OS_OBJ_TYPE_FLAG, OS_ERR_OBJ_TYPE, 0u);
+
+  OS_OPT mode = opt & OS_OPT_PEND_FLAG_MASK;
+  if ((mode != OS_OPT_PEND_FLAG_SET_ALL) && (mode != OS_OPT_PEND_FLAG_SET_ANY)) {
+    *p_err = OS_ERR_OPT_INVALID;
+    return 0u;
+  }
+
+  OS_FLAGS rdy = os3_flags_ready(p_grp->Flags, flags, opt);
+  if (rdy != 0u) {
+    if ((opt & OS_OPT_PEND_FLAG_CONSUME) != 0u) {
+      p_grp->Flags &= ~rdy;
+    }
+    if (!os3_in_isr()) {
+      OSTCBCurPtr->FlagsRdy = rdy;
+    }
+    *p_err = OS_ERR_NONE;
+    return rdy;
+  }
+  if ((opt & OS_OPT_PEND_NON_BLOCKING) != 0u) {
+    *p_err = OS_ERR_PEND_WOULD_BLOCK;
+    return 0u;
+  }
+  os3_no_block_in_isr("OSFlagPend");
+  if (OSSchedLockNestingCtr > 0u) {
+    *p_err = OS_ERR_SCHED_LOCKED;
+    return 0u;
+  }
+
+  OS_TCB *cur = OSTCBCurPtr;
+  cur->FlagsPend = flags;
+  cur->FlagsOpt = opt;
+  cur->FlagsRdy = 0u;
+  os3_pend(p_grp, &p_grp->PendList, OS_TASK_PEND_ON_FLAG, timeout);
+  *p_err = os3_pend_status_err(cur->PendStatus);
+  return (*p_err == OS_ERR_NONE) ? cur->FlagsRdy : 0u;
+}
+
+OS_FLAGS OSFlagPendGetFlagsRdy(OS_ERR *p_err) {
+  *p_err = OS_ERR_NONE;
+  return OSTCBCurPtr->FlagsRdy;
+}
+
+OS_FLAGS OSFlagPost(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_OPT opt, OS_ERR *p_err) {
+  vsim_service();
+  OS3_OBJ_CHECK(p_grp, OS_OBJ_TYPE_FLAG, OS_ERR_OBJ_TYPE, 0u);
+
+  switch (opt & (OS_OPT)~OS_OPT_POST_NO_SCHED) {
+    case OS_OPT_POST_FLAG_SET:
+      p_grp->Flags |= flags;
+      break;
+    case OS_OPT_POST_FLAG_CLR:
+      p_grp->Flags &= ~flags;
+      break;
+    default:
+      *p_err = OS_ERR_OPT_INVALID;
+      return 0u;
+  }
+
+  bool readied = false;
+  OS_TCB *p = p_grp->PendList.HeadPtr;
+  while (p != NULL) {
+    OS_TCB *next = p->PendNextPtr;
+    OS_FLAGS rdy = os3_flags_ready(p_grp->Flags, p->FlagsPend, p->FlagsOpt);
+    if (rdy != 0u) {
+      p->FlagsRdy = rdy;
+      if ((p->FlagsOpt & OS_OPT_PEND_FLAG_CONSUME) != 0u) {
+        p_grp->Flags &= ~rdy;
+      }
+      os3_pend_end(p, NULL, 0u, OS_STATUS_PEND_OK);
+      readied = true;
+    }
+    p = next;
+  }
+
+  *p_err = OS_ERR_NONE;
+  OS_FLAGS result = p_grp->Flags;
+  if (readied && ((opt & OS_OPT_POST_NO_SCHED) == 0u)) {
+    os3_sched();
+  }
+  return result;
+}
+
+/* ==== Memory partitions ==== */
+
+void OSMemCreate(OS_MEM *p_mem, CPU_CHAR *p_name, void *p_addr, OS_MEM_QTY n_blks, OS_MEM_SIZE blk_size, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_MEM_CREATE_ISR;
+    return;
+  }
+  if (p_addr == NULL) {
+    *p_err = OS_ERR_MEM_INVALID_P_ADDR;
+    return;
+  }
+  if (((uintptr_t)p_addr & (sizeof(void *) - 1u)) != 0u) {
+    *p_err = OS_ERR_MEM_INVALID_P_ADDR;
+    return;
+  }
+  if (n_blks < 2u) {
+    *p_err = OS_ERR_MEM_INVALID_BLKS;
+    return;
+  }
+  if ((blk_size < sizeof(void *)) || ((blk_size & (sizeof(void *) - 1u)) != 0u)) {
+    *p_err = OS_ERR_MEM_INVALID_SIZE;
+    return;
+  }
+
+  uint8_t *blk = (uint8_t *)p_addr;
+  for (OS_MEM_QTY i = 0u; i < (OS_MEM_QTY)(n_blks - 1u); ++i) {
+    *(void **)blk = blk + blk_size;
+    blk += blk_size;
+  }
+  *(void **)blk = NULL;
+
+  p_mem->Type = OS_OBJ_TYPE_MEM;
+  p_mem->NamePtr = p_name;
+  p_mem->AddrPtr = p_addr;
+  p_mem->FreeListPtr = p_addr;
+  p_mem->NbrFree = n_blks;
+  p_mem->NbrMax = n_blks;
+  p_mem->BlkSize = blk_size;
+  *p_err = OS_ERR_NONE;
+}
+
+void *OSMemGet(OS_MEM *p_mem, OS_ERR *p_err) {
+  vsim_service();
+  OS3_OBJ_CHECK(p_mem, OS_OBJ_TYPE_MEM, OS_ERR_OBJ_TYPE, NULL);
+  if (p_mem->NbrFree == 0u) {
+    *p_err = OS_ERR_MEM_NO_FREE_BLKS;
+    return NULL;
+  }
+  void *blk = p_mem->FreeListPtr;
+  p_mem->FreeListPtr = *(void **)blk;
+  p_mem->NbrFree--;
+  *p_err = OS_ERR_NONE;
+  return blk;
+}
+
+void OSMemPut(OS_MEM *p_mem, void *p_blk, OS_ERR *p_err) {
+  vsim_service();
+  OS3_OBJ_CHECK(p_mem, OS_OBJ_TYPE_MEM, OS_ERR_OBJ_TYPE);
+  if (p_blk == NULL) {
+    *p_err = OS_ERR_MEM_INVALID_P_BLK;
+    return;
+  }
+  if (p_mem->NbrFree >= p_mem->NbrMax) {
+    *p_err = OS_ERR_MEM_FULL;
+    return;
+  }
+  *(void **)p_blk = p_mem->FreeListPtr;
+  p_mem->FreeListPtr = p_blk;
+  p_mem->NbrFree++;
+  *p_err = OS_ERR_NONE;
+}
+
+/* ==== Timers ==== */
+
+static void os3_tmr_task(void *p_arg) {
+  (void)p_arg;
+  for (;;) {
+    OS_ERR err;
+    (void)OSTaskSemPend(0u, OS_OPT_PEND_BLOCKING, NULL, &err);
+
+    OS_TMR *p = os3.tmrs;
+    while (p != NULL) {
+      OS_TMR *next = p->NextPtr;
+      if ((p->SimExpired > 0u) && (p->State == OS_TMR_STATE_RUNNING)) {
+        p->SimExpired--;
+        if (p->Opt != OS_OPT_TMR_PERIODIC) {
+          p->State = OS_TMR_STATE_COMPLETED;
+        }
+        if (p->CallbackPtr != NULL) {
+          p->CallbackPtr(p, p->CallbackPtrArg);
+        }
+      }
+      p = next;
+    }
+  }
+}
+
+static void os3_tmr_unlink(OS_TMR *p_tmr) {
+  OS_TMR **link = &os3.tmrs;
+  while (*link != NULL) {
+    if (*link == p_tmr) {
+      *link = p_tmr->NextPtr;
+      p_tmr->NextPtr = NULL;
+      return;
+    }
+    link = &(*link)->NextPtr;
+  }
+}
+
+void OSTmrCreate(OS_TMR *p_tmr, CPU_CHAR *p_name, OS_TICK dly, OS_TICK period, OS_OPT opt,
+                 OS_TMR_CALLBACK_PTR p_callback, void *p_callback_arg, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TMR_ISR;
+    return;
+  }
+  if (p_tmr == NULL) {
+    *p_err = OS_ERR_OBJ_PTR_NULL;
+    return;
+  }
+  switch (opt) {
+    case OS_OPT_TMR_PERIODIC:
+      if (period == 0u) {
+        *p_err = OS_ERR_TMR_INVALID_PERIOD;
+        return;
+      }
+      break;
+    case OS_OPT_TMR_ONE_SHOT:
+      if (dly == 0u) {
+        *p_err = OS_ERR_TMR_INVALID_DLY;
+        return;
+      }
+      break;
+    default:
+      *p_err = OS_ERR_OPT_INVALID;
+      return;
+  }
+
+  memset(p_tmr, 0, sizeof(*p_tmr));
+  p_tmr->Type = OS_OBJ_TYPE_TMR;
+  p_tmr->NamePtr = p_name;
+  p_tmr->Dly = dly;
+  p_tmr->Period = period;
+  p_tmr->Opt = opt;
+  p_tmr->CallbackPtr = p_callback;
+  p_tmr->CallbackPtrArg = p_callback_arg;
+  p_tmr->State = OS_TMR_STATE_STOPPED;
+  p_tmr->NextPtr = os3.tmrs;
+  os3.tmrs = p_tmr;
+  *p_err = OS_ERR_NONE;
+}
+
+CPU_BOOLEAN OSTmrDel(OS_TMR *p_tmr, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_DEL_ISR;
+    return DEF_FALSE;
+  }
+  OS3_OBJ_CHECK(p_tmr, OS_OBJ_TYPE_TMR, OS_ERR_OBJ_TYPE, DEF_FALSE);
+  os3_tmr_unlink(p_tmr);
+  p_tmr->Type = OS_OBJ_TYPE_NONE;
+  p_tmr->State = OS_TMR_STATE_UNUSED;
+  *p_err = OS_ERR_NONE;
+  return DEF_TRUE;
+}
+
+void OSTmrSet(OS_TMR *p_tmr, OS_TICK dly, OS_TICK period,
+              OS_TMR_CALLBACK_PTR p_callback, void *p_callback_arg, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TMR_ISR;
+    return;
+  }
+  OS3_OBJ_CHECK(p_tmr, OS_OBJ_TYPE_TMR, OS_ERR_OBJ_TYPE);
+  if ((p_tmr->Opt == OS_OPT_TMR_PERIODIC) && (period == 0u)) {
+    *p_err = OS_ERR_TMR_INVALID_PERIOD;
+    return;
+  }
+  if ((p_tmr->Opt == OS_OPT_TMR_ONE_SHOT) && (dly == 0u)) {
+    *p_err = OS_ERR_TMR_INVALID_DLY;
+    return;
+  }
+  p_tmr->Dly = dly;
+  p_tmr->Period = period;
+  p_tmr->CallbackPtr = p_callback;
+  p_tmr->CallbackPtrArg = p_callback_arg;
+  *p_err = OS_ERR_NONE;
+}
+
+OS_TICK OSTmrRemainGet(OS_TMR *p_tmr, OS_ERR *p_err) {
+  OS3_OBJ_CHECK(p_tmr, OS_OBJ_TYPE_TMR, OS_ERR_OBJ_TYPE, 0u);
+  *p_err = OS_ERR_NONE;
+  return (p_tmr->State == OS_TMR_STATE_RUNNING) ? p_tmr->Remain : 0u;
+}
+
+CPU_BOOLEAN OSTmrStart(OS_TMR *p_tmr, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TMR_ISR;
+    return DEF_FALSE;
+  }
+  OS3_OBJ_CHECK(p_tmr, OS_OBJ_TYPE_TMR, OS_ERR_OBJ_TYPE, DEF_FALSE);
+  p_tmr->Remain = (p_tmr->Dly != 0u) ? p_tmr->Dly : p_tmr->Period;
+  p_tmr->SimExpired = 0u;
+  p_tmr->State = OS_TMR_STATE_RUNNING;
+  *p_err = OS_ERR_NONE;
+  return DEF_TRUE;
+}
+
+OS_STATE OSTmrStateGet(OS_TMR *p_tmr, OS_ERR *p_err) {
+  OS3_OBJ_CHECK(p_tmr, OS_OBJ_TYPE_TMR, OS_ERR_OBJ_TYPE, OS_TMR_STATE_UNUSED);
+  *p_err = OS_ERR_NONE;
+  return p_tmr->State;
+}
+
+CPU_BOOLEAN OSTmrStop(OS_TMR *p_tmr, OS_OPT opt, void *p_callback_arg, OS_ERR *p_err) {
+  vsim_service();
+  if (os3_in_isr()) {
+    *p_err = OS_ERR_TMR_ISR;
+    return DEF_FALSE;
+  }
+  OS3_OBJ_CHECK(p_tmr, OS_OBJ_TYPE_TMR, OS_ERR_OBJ_TYPE, DEF_FALSE);
+
+  if (p_tmr->State != OS_TMR_STATE_RUNNING) {
+    *p_err = OS_ERR_TMR_STOPPED;
+    return DEF_TRUE;
+  }
+  p_tmr->State = OS_TMR_STATE_STOPPED;
+  p_tmr->SimExpired = 0u;
+  *p_err = OS_ERR_NONE;
+  if (p_tmr->CallbackPtr != NULL) {
+    if (opt == OS_OPT_TMR_CALLBACK) {
+      p_tmr->CallbackPtr(p_tmr, p_tmr->CallbackPtrArg);
+    } else if (opt == OS_OPT_TMR_CALLBACK_ARG) {
+      p_tmr->CallbackPtr(p_tmr, p_callback_arg);
+    }
+  }
+  return DEF_TRUE;
+}
+
+/* ==== Thread-local storage ==== */
+
+#if (OS_CFG_TLS_TBL_SIZE > 0u)
+OS_TLS_ID OS_TLS_GetID(OS_ERR *p_err) {
+  if (os3.tls_next >= OS_CFG_TLS_TBL_SIZE) {
+    *p_err = OS_ERR_TLS_NO_MORE_AVAIL;
+    return (OS_TLS_ID)OS_CFG_TLS_TBL_SIZE;
+  }
+  *p_err = OS_ERR_NONE;
+  return os3.tls_next++;
+}
+
+OS_TLS OS_TLS_GetValue(OS_TCB *p_tcb, OS_TLS_ID id, OS_ERR *p_err) {
+  if (id >= os3.tls_next) {
+    *p_err = OS_ERR_TLS_ID_INVALID;
+    return NULL;
+  }
+  if (p_tcb == NULL) {
+    p_tcb = OSTCBCurPtr;
+  }
+  *p_err = OS_ERR_NONE;
+  return p_tcb->TLS_Tbl[id];
+}
+
+void OS_TLS_SetValue(OS_TCB *p_tcb, OS_TLS_ID id, OS_TLS value, OS_ERR *p_err) {
+  if (id >= os3.tls_next) {
+    *p_err = OS_ERR_TLS_ID_INVALID;
+    return;
+  }
+  if (p_tcb == NULL) {
+    p_tcb = OSTCBCurPtr;
+  }
+  p_tcb->TLS_Tbl[id] = value;
+  *p_err = OS_ERR_NONE;
+}
+#endif
+
+/* ==== Start-up ==== */
+
+static void os3_idle_task(void *p_arg) {
+  (void)p_arg;
+  for (;;) {
+    OSIdleTaskCtr++;
+#if (OS_CFG_APP_HOOKS_EN > 0u)
+    if (OS_AppIdleTaskHookPtr != NULL) {
+      OS_AppIdleTaskHookPtr();
+    }
+#endif
+    vsim_idle();
+  }
+}
+
+void OSInit(OS_ERR *p_err) {
+  vsim_reset();
+  memset(&os3, 0, sizeof(os3));
+
+  OSIntNestingCtr = 0u;
+  OSRunning = OS_STATE_OS_STOPPED;
+  OSSchedLockNestingCtr = 0u;
+  OSTCBCurPtr = NULL;
+  OSTCBHighRdyPtr = NULL;
+  OSPrioCur = 0u;
+  OSPrioHighRdy = 0u;
+  OSTaskCtxSwCtr = 0u;
+  OSTickCtr = 0u;
+  OSIdleTaskCtr = 0u;
+
+#if (OS_CFG_APP_HOOKS_EN > 0u)
+  OS_AppTaskCreateHookPtr = NULL;
+  OS_AppTaskDelHookPtr = NULL;
+  OS_AppTaskReturnHookPtr = NULL;
+  OS_AppIdleTaskHookPtr = NULL;
+  OS_AppStatTaskHookPtr = NULL;
+  OS_AppTaskSwHookPtr = NULL;
+  OS_AppTimeTickHookPtr = NULL;
+#endif
+
+  for (uint32_t i = 0u; i < OS_CFG_MSG_POOL_SIZE; ++i) {
+    os3_msg_pool[i].NextPtr = (i + 1u < OS_CFG_MSG_POOL_SIZE) ? &os3_msg_pool[i + 1u] : NULL;
+  }
+  os3.msg_free = &os3_msg_pool[0];
+
+  const char *horizon = getenv("VSIM_HORIZON");
+  if (horizon != NULL) {
+    vsim_set_horizon(strtoull(horizon, NULL, 0));
+    os3.exit_at_horizon = true;
+  }
+  os3.trace = (getenv("VSIM_TRACE") != NULL);
+
+  vsim_kernel_register(&os3_ops);
+
+  OSTaskCreate(&OSIdleTaskTCB, (CPU_CHAR *)"uC/OS-III Idle Task", os3_idle_task, NULL,
+               OS3_IDLE_PRIO, os3_idle_stk, 0u, OS_CFG_IDLE_TASK_STK_SIZE, 0u, 0u, NULL,
+               (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), p_err);
+  if (*p_err != OS_ERR_NONE) {
+    return;
+  }
+
+#if (OS_CFG_TMR_EN > 0u)
+  OSTaskCreate(&os3_tmr_tcb, (CPU_CHAR *)"uC/OS-III Timer Task", os3_tmr_task, NULL,
+               OS_CFG_TMR_TASK_PRIO, os3_tmr_stk, 0u, OS_CFG_TMR_TASK_STK_SIZE, 0u, 0u, NULL,
+               (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), p_err);
+#endif
+}
+
+void OSStart(OS_ERR *p_err) {
+  if (OSRunning == OS_STATE_OS_RUNNING) {
+    *p_err = OS_ERR_OS_RUNNING;
+    return;
+  }
+
+  OSTCBHighRdyPtr = os3_highest_ready();
+  OSPrioHighRdy = OSTCBHighRdyPtr->Prio;
+  OSTCBCurPtr = OSTCBHighRdyPtr;
+  OSPrioCur = OSPrioHighRdy;
+  OSRunning = OS_STATE_OS_RUNNING;
+#if (OS_CFG_TASK_PROFILE_EN > 0u)
+  OSTCBCurPtr->CyclesStart = OS_TS_GET();
+  OSTCBCurPtr->CtxSwCtr++;
+#endif
+  *p_err = OS_ERR_NONE;
+
+  vsim_ctx_start((vsim_ctx_t *)OSTCBCurPtr->SimCtxPtr);
+
+  /* The simulation horizon was reached. */
+  if (os3.exit_at_horizon) {
+    if (os3.trace) {
+      printf("%10llu horizon ticks=%llu ctxsw=%lu\n",
+             (unsigned long long)vsim_now(),
+             (unsigned long long)vsim_ticks(),
+             (unsigned long)OSTaskCtxSwCtr);
+    }
+    fflush(stdout);
+    exit(0);
+  }
+}